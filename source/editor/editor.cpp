@@ -182,6 +182,21 @@ int Editor::run(int argc, char** argv)
 	config.windowInfo.initHeight = 450;
 	config.windowInfo.windowShowMode = Config::InitWindowInfo::EWindowMode::Free;
 
+	// Command line: --profile-frames N [--profile-output path], capture start up frames then quit.
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view arg = argv[i];
+		if (arg == "--profile-frames" && i + 1 < argc)
+		{
+			config.profileCaptureFrames = (uint32_t)std::max(0, std::atoi(argv[++i]));
+			config.bExitAfterProfileCapture = config.profileCaptureFrames > 0;
+		}
+		else if (arg == "--profile-output" && i + 1 < argc)
+		{
+			config.profileCapturePath = argv[++i];
+		}
+	}
+
 	// Framework init and register module.
 	Framework* app = Framework::get();
 	app->initFramework(config);
@@ -20,8 +20,8 @@ void drawPMXSelect(
 		const auto& map = assetSystem->getAssetMap(EAssetType::PMX);
 		for (const auto& id : map)
 		{
-			const auto& asset = assetSystem->getAsset(id);
-			if (ImGui::MenuItem((std::string("  ") + ICON_FA_CHESS_QUEEN"   " + asset->getRelativePathUtf8()).c_str()))
+			const auto* path = assetSystem->getAssetRelativePath(id);
+			if (path && ImGui::MenuItem((std::string("  ") + ICON_FA_CHESS_QUEEN"   " + *path).c_str()))
 			{
 				comp->setPMX(id);
 			}
@@ -43,9 +43,10 @@ void drawVMDSelect(
 		const auto& map = assetSystem->getAssetMap(EAssetType::VMD);
 		for (const auto& id : map)
 		{
-			const auto& asset =std::dynamic_pointer_cast<AssetVMD>(assetSystem->getAsset(id));
+			// Camera flag only in vmd meta, so still need load asset.
+			const auto& asset = std::dynamic_pointer_cast<AssetVMD>(assetSystem->getAsset(id));
 
-			if (!asset->m_bCamera && ImGui::MenuItem((std::string("  ") + ICON_FA_PERSON_WALKING"   " + asset->getRelativePathUtf8()).c_str()))
+			if (asset && !asset->m_bCamera && ImGui::MenuItem((std::string("  ") + ICON_FA_PERSON_WALKING"   " + asset->getRelativePathUtf8()).c_str()))
 			{
 				// TODO: multi vmd file.
 				comp->clearVmd();
@@ -86,7 +87,7 @@ void ComponentDrawer::drawMMDCamera(std::shared_ptr<engine::SceneNode> node)
 					{
 						const auto& asset = std::dynamic_pointer_cast<AssetVMD>(assetSystem->getAsset(id));
 
-						if (asset->m_bCamera && ImGui::MenuItem((std::string("  ") + ICON_FA_CAMERA"   " + asset->getRelativePathUtf8()).c_str()))
+						if (asset && asset->m_bCamera && ImGui::MenuItem((std::string("  ") + ICON_FA_CAMERA"   " + asset->getRelativePathUtf8()).c_str()))
 						{
 							comp->setVmd(id);
 						}
@@ -113,9 +114,8 @@ void drawWaveSelect(
 		const auto& map = assetSystem->getAssetMap(EAssetType::Wave);
 		for (const auto& id : map)
 		{
-			const auto& asset = std::dynamic_pointer_cast<AssetWave>(assetSystem->getAsset(id));
-
-			if (ImGui::MenuItem((std::string("  ") + ICON_FA_MUSIC"   " + asset->getRelativePathUtf8()).c_str()))
+			const auto* path = assetSystem->getAssetRelativePath(id);
+			if (path && ImGui::MenuItem((std::string("  ") + ICON_FA_MUSIC"   " + *path).c_str()))
 			{
 				comp->setSong(id);
 			}
@@ -170,6 +170,13 @@ void ComponentDrawer::drawPMX(std::shared_ptr<engine::SceneNode> node)
 			drawWaveSelect(node, comp);
 			ImGui::EndPopup();
 		}
+
+		// Gpu skinning path only keep cpu positions valid when request.
+		bool bCPUPositions = comp->isCPUPositionsRequested();
+		if (ImGui::Checkbox("CPU Skinned Positions", &bCPUPositions))
+		{
+			comp->setCPUPositionsRequested(bCPUPositions);
+		}
 	}
 	ui::endGroupPanel();
 	ImGui::Indent();
@@ -35,10 +35,10 @@ void drawStaticMeshSelect(std::shared_ptr<SceneNode> node, std::shared_ptr<Stati
 		const auto& map = assetSystem->getAssetMap(EAssetType::StaticMesh);
 		for (const auto& meshId : map)
 		{
-			const auto& asset = assetSystem->getAsset(meshId);
-			if (ImGui::MenuItem((std::string("  ") + ICON_FA_CHESS_PAWN"   " + asset->getRelativePathUtf8()).c_str()))
+			const auto* path = assetSystem->getAssetRelativePath(meshId);
+			if (path && ImGui::MenuItem((std::string("  ") + ICON_FA_CHESS_PAWN"   " + *path).c_str()))
 			{
-				comp->setMesh(meshId, asset->getRelativePathUtf8(), false);
+				comp->setMesh(meshId, *path, false);
 			}
 		}
 		ImGui::EndMenu();
@@ -64,7 +64,7 @@ void ComponentDrawer::drawStaticMesh(std::shared_ptr<SceneNode> node)
 	else
 	{
 		ImGui::TextDisabled("Mesh asset: %s.", comp->getMeshAssetRelativeRoot().c_str());
-		ImGui::TextDisabled("Asset uuid: %s.", comp->getMeshUUID().c_str());
+		ImGui::TextDisabled("Asset uuid: %s.", comp->getMeshUUID().toString().c_str());
 	}
 
 	ImGui::Spacing();
@@ -18,8 +18,8 @@ void drawHeightFieldSelect(std::shared_ptr<SceneNode> node, std::shared_ptr<Terr
 		const auto& map = assetSystem->getAssetMap(EAssetType::Texture);
 		for (const auto& texd : map)
 		{
-			const auto& asset = assetSystem->getAsset(texd);
-			if (ImGui::MenuItem((std::string("  ") + ICON_FA_IMAGE"   " + asset->getRelativePathUtf8()).c_str()))
+			const auto* path = assetSystem->getAssetRelativePath(texd);
+			if (path && ImGui::MenuItem((std::string("  ") + ICON_FA_IMAGE"   " + *path).c_str()))
 			{
 				func(texd);
 				comp->loadTexturesByUUID(bSync);
@@ -89,44 +89,40 @@ VkDescriptorSet ProjectAssetTreeEntry::getSet(Editor* editor, ImVec2& uv0, ImVec
 			if (isEngineMetaAsset(extension))
 			{
 				const auto relativePath = buildRelativePathUtf8(editor->getProjectRootPathUtf16(), path.replace_extension());
-				if (auto asset = editor->getAssetSystem()->getAssetByRelativeMap(relativePath))
+				if (editor->getAssetSystem()->isAssetExist(relativePath))
 				{
-					if (asset->existSnapshot())
+					// Snapshot decode from registry cache when asset still no load.
+					uint32_t w = 0;
+					uint32_t h = 0;
+					if (auto image = editor->getAssetSystem()->getOrCreateSnapshot(relativePath, w, h))
 					{
-						if (auto image = asset->getOrCreateLRUSnapShot(editor->getContext()))
+						if (image->isAssetReady())
 						{
-							if (image->isAssetReady())
-							{
-								m_drawDetail.set = editor->getClampToTransparentBorderSet(&image->getImage());
-
-
-								const auto w = asset->getSnapshotWidth();
-								const auto h = asset->getSnapshotHeight();
-
-								if (w < h)
-								{
-									m_drawDetail.uv0.x = 0.0f - (1.0f - float(w) / float(h)) * 0.5f;
-									m_drawDetail.uv1.x = 1.0f + (1.0f - float(w) / float(h)) * 0.5f;
+							m_drawDetail.set = editor->getClampToTransparentBorderSet(&image->getImage());
 
-									m_drawDetail.uv0.y = -kUvScale;
-									m_drawDetail.uv1.y = 1.0f + kUvScale;
+							if (w < h)
+							{
+								m_drawDetail.uv0.x = 0.0f - (1.0f - float(w) / float(h)) * 0.5f;
+								m_drawDetail.uv1.x = 1.0f + (1.0f - float(w) / float(h)) * 0.5f;
 
-								}
-								else if (w > h)
-								{
-									m_drawDetail.uv0.y = 0.0f - (1.0f - float(h) / float(w)) * 0.5f;
-									m_drawDetail.uv1.y = 1.0f + (1.0f - float(h) / float(w)) * 0.5f;
+								m_drawDetail.uv0.y = -kUvScale;
+								m_drawDetail.uv1.y = 1.0f + kUvScale;
 
-									m_drawDetail.uv0.x = -kUvScale;
-									m_drawDetail.uv1.x = 1.0f + kUvScale;
-								}
 							}
-							else
+							else if (w > h)
 							{
-								m_drawDetail.set = VK_NULL_HANDLE;
-								result = editor->getClampToTransparentBorderSet(editor->getFileImage());
+								m_drawDetail.uv0.y = 0.0f - (1.0f - float(h) / float(w)) * 0.5f;
+								m_drawDetail.uv1.y = 1.0f + (1.0f - float(h) / float(w)) * 0.5f;
+
+								m_drawDetail.uv0.x = -kUvScale;
+								m_drawDetail.uv1.x = 1.0f + kUvScale;
 							}
 						}
+						else
+						{
+							m_drawDetail.set = VK_NULL_HANDLE;
+							result = editor->getClampToTransparentBorderSet(editor->getFileImage());
+						}
 					}
 					else
 					{
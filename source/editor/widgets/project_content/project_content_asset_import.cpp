@@ -90,15 +90,22 @@ void ProjectContentWidget::drawImageImportModalContent()
 					Mode_B,
 					Mode_A,
 					Mode_RGB,
+					Mode_RG,
 				};
 				int mode = (int)config.channel;
 				if (ImGui::RadioButton("RGBA", mode == Mode_RGBA)) { mode = (int)Mode_RGBA; } ImGui::SameLine();
 				if (ImGui::RadioButton("RGB", mode == Mode_RGB))   { mode = (int)Mode_RGB;  } ImGui::SameLine();
+				if (ImGui::RadioButton("RG", mode == Mode_RG))     { mode = (int)Mode_RG;   } ImGui::SameLine();
 				if (ImGui::RadioButton("R", mode == Mode_R))       { mode = (int)Mode_R;    } ImGui::SameLine();
 				if (ImGui::RadioButton("G", mode == Mode_G))       { mode = (int)Mode_G;    } ImGui::SameLine();
 				if (ImGui::RadioButton("B", mode == Mode_B))       { mode = (int)Mode_B;    } ImGui::SameLine();
 				if (ImGui::RadioButton("A", mode == Mode_A))       { mode = (int)Mode_A;    } ImGui::SameLine();
 				config.channel = (engine::AssetTexture::ImportConfig::EChannel)mode;
+
+				using EMipmapFilter = engine::AssetTexture::ImportConfig::EMipmapFilter;
+				ImGui::TableNextRow(); ImGui::TableNextColumn(); ImGui::Text("Mipmap Filter"); ImGui::TableNextColumn();
+				if (ImGui::RadioButton("Box", config.mipmapFilter == EMipmapFilter::Box)) { config.mipmapFilter = EMipmapFilter::Box; } ImGui::SameLine();
+				if (ImGui::RadioButton("Kaiser", config.mipmapFilter == EMipmapFilter::Kaiser)) { config.mipmapFilter = EMipmapFilter::Kaiser; }
 				ImGui::EndTable();
 			}
 		}
@@ -149,6 +149,18 @@ void ViewportWidget::onVisibleTick(const engine::RuntimeModuleTickData& tickData
 					const char* pStrUnit = m_profileViewer.bShowMilliseconds ? "ms" : "us";
 					ImGui::Text(textFormat, timeStamps[i].label.c_str(), value, pStrUnit);
 				}
+
+				// Main thread cpu scopes of last frame.
+				const uint32_t mainThreadIndex = Profiler::get()->getCurrentThreadIndex();
+				for (const auto& stat : Profiler::get()->getLastFrameStats())
+				{
+					if (stat.threadIndex == mainThreadIndex)
+					{
+						float value = m_profileViewer.bShowMilliseconds ? float(stat.totalMs) : float(stat.totalMs * 1000.0);
+						const char* pStrUnit = m_profileViewer.bShowMilliseconds ? "ms" : "us";
+						ImGui::Text(textFormat, stat.name, value, pStrUnit);
+					}
+				}
 			}
 			ImGui::Spacing();
 			ui::endGroupPanel();
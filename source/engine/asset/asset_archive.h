@@ -1,6 +1,6 @@
 #pragma once
 
-#define kAssetVersion 3 
+#define kAssetVersion 5 
 
 // Archive macro for convince.
 
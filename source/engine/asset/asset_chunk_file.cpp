@@ -0,0 +1,388 @@
+#include "asset_chunk_file.h"
+
+#include <lz4.h>
+
+namespace engine
+{
+	using namespace chunk_file;
+
+	static inline uint64_t alignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	static inline void writePadding(std::ofstream& os, uint64_t alignment)
+	{
+		static const char kZeros[kDataAlignment] = { };
+
+		const uint64_t pos = (uint64_t)os.tellp();
+		const uint64_t padding = alignUp(pos, alignment) - pos;
+		os.write(kZeros, padding);
+	}
+
+	void AssetChunkFileWriter::addChunk(uint32_t id, const void* data, uint64_t size, bool bCompress)
+	{
+		for (const auto& chunk : m_chunks)
+		{
+			CHECK(chunk.id != id);
+		}
+
+		m_chunks.push_back({ .id = id, .data = (const uint8_t*)data, .size = size, .bCompress = bCompress });
+	}
+
+	bool AssetChunkFileWriter::save(const std::filesystem::path& savePath, const char* suffix, bool bRequireNoExist) const
+	{
+		std::filesystem::path rawSavePath = savePath;
+		rawSavePath += suffix;
+
+		if (bRequireNoExist && std::filesystem::exists(rawSavePath))
+		{
+			LOG_ERROR("Binary data {} already exist, make sure never import save resource at same folder!", utf8::utf16to8(rawSavePath.u16string()));
+			return false;
+		}
+
+		// Flatten all compressed chunk blocks, then compress them in parallel.
+		struct CompressBlock
+		{
+			const uint8_t* src;
+			uint32_t rawSize;
+			std::vector<char> compressed;
+		};
+		std::vector<CompressBlock> blocks;
+
+		std::vector<ChunkEntry> entries(m_chunks.size());
+		for (size_t i = 0; i < m_chunks.size(); i++)
+		{
+			const auto& chunk = m_chunks[i];
+
+			entries[i] = { };
+			entries[i].id = chunk.id;
+			entries[i].rawSize = chunk.size;
+
+			if (chunk.bCompress)
+			{
+				entries[i].flags = EChunkFlags::Compressed;
+				entries[i].dataOffset = blocks.size();
+
+				for (uint64_t offset = 0; offset < chunk.size; offset += kBlockSize)
+				{
+					blocks.push_back({ .src = chunk.data + offset, .rawSize = (uint32_t)std::min<uint64_t>(kBlockSize, chunk.size - offset) });
+				}
+				entries[i].blockCount = blocks.size() - entries[i].dataOffset;
+			}
+		}
+
+		ThreadPool::getDefault()->parallelFor(size_t(0), blocks.size(), [&](const size_t start, const size_t end)
+		{
+			for (size_t i = start; i < end; i++)
+			{
+				auto& block = blocks[i];
+				block.compressed.resize(LZ4_compressBound((int)block.rawSize));
+
+				const int compressedSize = LZ4_compress_default((const char*)block.src, block.compressed.data(), (int)block.rawSize, (int)block.compressed.size());
+
+				// Incompressible block store raw, reader detect it by equal size.
+				if (compressedSize <= 0 || uint32_t(compressedSize) >= block.rawSize)
+				{
+					block.compressed.clear();
+				}
+				else
+				{
+					block.compressed.resize(compressedSize);
+				}
+			}
+		});
+
+		std::ofstream os(rawSavePath, std::ios::binary | std::ios::trunc);
+		if (!os.is_open())
+		{
+			LOG_ERROR("Open binary data {} for write failed.", utf8::utf16to8(rawSavePath.u16string()));
+			return false;
+		}
+
+		FileHeader header { };
+		header.magic = kMagic;
+		header.version = kVersion;
+		header.blockSize = kBlockSize;
+		header.chunkCount = (uint32_t)entries.size();
+		header.blockCount = blocks.size();
+
+		// Header write again when all offset ready.
+		os.write((const char*)&header, sizeof(header));
+
+		std::vector<BlockEntry> blockEntries(blocks.size());
+		for (size_t i = 0; i < m_chunks.size(); i++)
+		{
+			const auto& chunk = m_chunks[i];
+			auto& entry = entries[i];
+
+			if (entry.flags & EChunkFlags::Compressed)
+			{
+				for (uint64_t j = entry.dataOffset; j < entry.dataOffset + entry.blockCount; j++)
+				{
+					const auto& block = blocks[j];
+					const bool bStoreRaw = block.compressed.empty();
+
+					writePadding(os, kDataAlignment);
+
+					blockEntries[j].offset = (uint64_t)os.tellp();
+					blockEntries[j].rawSize = block.rawSize;
+					blockEntries[j].compressedSize = bStoreRaw ? block.rawSize : (uint32_t)block.compressed.size();
+
+					if (bStoreRaw)
+					{
+						os.write((const char*)block.src, block.rawSize);
+					}
+					else
+					{
+						os.write(block.compressed.data(), block.compressed.size());
+					}
+				}
+			}
+			else
+			{
+				writePadding(os, kDataAlignment);
+
+				entry.dataOffset = (uint64_t)os.tellp();
+				os.write((const char*)chunk.data, chunk.size);
+			}
+		}
+
+		writePadding(os, kDataAlignment);
+		header.chunkTableOffset = (uint64_t)os.tellp();
+		os.write((const char*)entries.data(), entries.size() * sizeof(ChunkEntry));
+
+		writePadding(os, kDataAlignment);
+		header.blockTableOffset = (uint64_t)os.tellp();
+		os.write((const char*)blockEntries.data(), blockEntries.size() * sizeof(BlockEntry));
+
+		os.seekp(0);
+		os.write((const char*)&header, sizeof(header));
+
+		if (!os)
+		{
+			LOG_ERROR("Write binary data {} failed.", utf8::utf16to8(rawSavePath.u16string()));
+			return false;
+		}
+		return true;
+	}
+
+	bool AssetChunkFileReader::isChunkFile(const std::filesystem::path& path)
+	{
+		std::ifstream is(path, std::ios::binary);
+		if (!is.is_open())
+		{
+			return false;
+		}
+
+		uint32_t magic = 0;
+		is.read((char*)&magic, sizeof(magic));
+		return is && magic == kMagic;
+	}
+
+	bool AssetChunkFileReader::open(const std::filesystem::path& path)
+	{
+		close();
+
+		if (!isChunkFile(path) || !m_file.open(path))
+		{
+			return false;
+		}
+		m_path = path;
+
+		const uint8_t* data = m_file.getData();
+		const uint64_t fileSize = m_file.getSize();
+
+		auto broken = [&](const char* reason)
+		{
+			LOG_ERROR("Chunk file {} broken: {}.", utf8::utf16to8(m_path.u16string()), reason);
+			close();
+			return false;
+		};
+
+		if (fileSize < sizeof(FileHeader))
+		{
+			return broken("file too small");
+		}
+
+		FileHeader header;
+		memcpy(&header, data, sizeof(header));
+		if (header.version != kVersion || header.blockSize == 0)
+		{
+			return broken("version mismatch");
+		}
+
+		if (header.chunkTableOffset + uint64_t(header.chunkCount) * sizeof(ChunkEntry) > fileSize)
+		{
+			return broken("chunk table out of range");
+		}
+
+		if (header.blockTableOffset % alignof(BlockEntry) != 0 ||
+			header.blockCount > fileSize / sizeof(BlockEntry) ||
+			header.blockTableOffset + header.blockCount * sizeof(BlockEntry) > fileSize)
+		{
+			return broken("block table out of range");
+		}
+
+		m_chunks.resize(header.chunkCount);
+		memcpy(m_chunks.data(), data + header.chunkTableOffset, m_chunks.size() * sizeof(ChunkEntry));
+
+		m_blocks = (const BlockEntry*)(data + header.blockTableOffset);
+		m_blockCount = header.blockCount;
+
+		for (uint64_t i = 0; i < m_blockCount; i++)
+		{
+			const auto& block = m_blocks[i];
+			if (block.rawSize > header.blockSize || block.offset + block.compressedSize > fileSize)
+			{
+				return broken("block out of range");
+			}
+		}
+
+		for (const auto& chunk : m_chunks)
+		{
+			if (chunk.flags & EChunkFlags::Compressed)
+			{
+				if (chunk.dataOffset + chunk.blockCount > m_blockCount)
+				{
+					return broken("chunk block range out of range");
+				}
+
+				uint64_t rawSize = 0;
+				for (uint64_t i = chunk.dataOffset; i < chunk.dataOffset + chunk.blockCount; i++)
+				{
+					rawSize += m_blocks[i].rawSize;
+				}
+
+				if (rawSize != chunk.rawSize)
+				{
+					return broken("chunk size mismatch with blocks");
+				}
+			}
+			else if (chunk.dataOffset + chunk.rawSize > fileSize)
+			{
+				return broken("raw chunk out of range");
+			}
+		}
+
+		return true;
+	}
+
+	void AssetChunkFileReader::close()
+	{
+		m_file.close();
+		m_chunks.clear();
+		m_blocks = nullptr;
+		m_blockCount = 0;
+	}
+
+	const ChunkEntry* AssetChunkFileReader::findChunk(uint32_t id) const
+	{
+		for (const auto& chunk : m_chunks)
+		{
+			if (chunk.id == id)
+			{
+				return &chunk;
+			}
+		}
+		return nullptr;
+	}
+
+	uint64_t AssetChunkFileReader::getChunkSize(uint32_t id) const
+	{
+		const auto* chunk = findChunk(id);
+		return chunk ? chunk->rawSize : 0;
+	}
+
+	const void* AssetChunkFileReader::getRawChunkData(uint32_t id) const
+	{
+		const auto* chunk = findChunk(id);
+		if (chunk == nullptr || (chunk->flags & EChunkFlags::Compressed))
+		{
+			return nullptr;
+		}
+		return m_file.getData() + chunk->dataOffset;
+	}
+
+	bool AssetChunkFileReader::readChunks(const std::vector<ReadRequest>& requests) const
+	{
+		// Raw chunk also split as block size, so big raw section copy parallel too.
+		struct ReadJob
+		{
+			const uint8_t* src;
+			uint8_t* dest;
+			uint32_t srcSize;
+			uint32_t rawSize;
+		};
+		std::vector<ReadJob> jobs;
+
+		const uint8_t* fileData = m_file.getData();
+		for (const auto& request : requests)
+		{
+			const auto* chunk = findChunk(request.id);
+			if (chunk == nullptr)
+			{
+				LOG_ERROR("Chunk {} miss in file {}.", request.id, utf8::utf16to8(m_path.u16string()));
+				return false;
+			}
+
+			if (request.destSize < chunk->rawSize)
+			{
+				LOG_ERROR("Chunk {} size {} bigger than dest size {}.", request.id, chunk->rawSize, request.destSize);
+				return false;
+			}
+
+			uint8_t* dest = (uint8_t*)request.dest;
+			if (chunk->flags & EChunkFlags::Compressed)
+			{
+				for (uint64_t i = chunk->dataOffset; i < chunk->dataOffset + chunk->blockCount; i++)
+				{
+					const auto& block = m_blocks[i];
+					jobs.push_back({ .src = fileData + block.offset, .dest = dest, .srcSize = block.compressedSize, .rawSize = block.rawSize });
+					dest += block.rawSize;
+				}
+			}
+			else
+			{
+				for (uint64_t offset = 0; offset < chunk->rawSize; offset += kBlockSize)
+				{
+					const uint32_t size = (uint32_t)std::min<uint64_t>(kBlockSize, chunk->rawSize - offset);
+					jobs.push_back({ .src = fileData + chunk->dataOffset + offset, .dest = dest + offset, .srcSize = size, .rawSize = size });
+				}
+			}
+		}
+
+		std::atomic<bool> bSuccess = true;
+		ThreadPool::getDefault()->parallelFor(size_t(0), jobs.size(), [&](const size_t start, const size_t end)
+		{
+			// Lz4 read back its own output when copy match, never decompress into write-combined memory directly.
+			// Decompress into cache hot scratch and then copy out sequential.
+			static thread_local std::vector<char> scratch;
+
+			for (size_t i = start; i < end; i++)
+			{
+				const auto& job = jobs[i];
+				if (job.srcSize == job.rawSize)
+				{
+					memcpy(job.dest, job.src, job.rawSize);
+					continue;
+				}
+
+				scratch.resize(std::max<size_t>(scratch.size(), job.rawSize));
+				const int decompressSize = LZ4_decompress_safe((const char*)job.src, scratch.data(), (int)job.srcSize, (int)job.rawSize);
+				if (decompressSize != (int)job.rawSize)
+				{
+					bSuccess = false;
+					continue;
+				}
+				memcpy(job.dest, scratch.data(), job.rawSize);
+			}
+		});
+
+		if (!bSuccess)
+		{
+			LOG_ERROR("Decompress chunk file {} failed, data corrupted.", utf8::utf16to8(m_path.u16string()));
+		}
+		return bSuccess;
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <util/util.h>
+#include <util/mapped_file.h>
+
+namespace engine
+{
+	// Chunked binary container for large asset payload (mesh vertices, texture mips).
+	//
+	// File layout:
+	//   FileHeader | chunk datas ... | ChunkEntry table | BlockEntry table
+	//
+	// Each chunk store as independent 64 KiB lz4 blocks, or as raw aligned section when no compression,
+	// so reader can decompress all blocks in parallel from mapped file directly into final destination.
+	namespace chunk_file
+	{
+		constexpr uint32_t kMagic = 0x4B434C46; // 'FLCK'
+		constexpr uint32_t kVersion = 1;
+		constexpr uint32_t kBlockSize = 64 * 1024;
+
+		// Raw section and block start alignment in file.
+		constexpr uint64_t kDataAlignment = 64;
+
+		enum EChunkFlags : uint32_t
+		{
+			None = 0,
+			Compressed = 1 << 0,
+		};
+
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t blockSize;
+			uint32_t chunkCount;
+			uint64_t chunkTableOffset;
+			uint64_t blockTableOffset;
+			uint64_t blockCount;
+		};
+
+		struct ChunkEntry
+		{
+			uint32_t id;
+			uint32_t flags;
+
+			// Decompressed size.
+			uint64_t rawSize;
+
+			// Raw chunk: data offset in file. Compressed chunk: first block index in block table.
+			uint64_t dataOffset;
+			uint64_t blockCount;
+		};
+
+		struct BlockEntry
+		{
+			uint64_t offset;
+
+			// Equal to block raw size when block store without compression.
+			uint32_t compressedSize;
+			uint32_t rawSize;
+		};
+	}
+
+	class AssetChunkFileWriter : NonCopyable
+	{
+	public:
+		// Data must keep alive until save finish.
+		void addChunk(uint32_t id, const void* data, uint64_t size, bool bCompress = true);
+
+		template<typename T>
+		void addChunk(uint32_t id, const std::vector<T>& data, bool bCompress = true)
+		{
+			addChunk(id, data.data(), data.size() * sizeof(T), bCompress);
+		}
+
+		// Compress all chunks in parallel and save to savePath + suffix.
+		bool save(const std::filesystem::path& savePath, const char* suffix, bool bRequireNoExist = true) const;
+
+	private:
+		struct PendingChunk
+		{
+			uint32_t id;
+			const uint8_t* data;
+			uint64_t size;
+			bool bCompress;
+		};
+		std::vector<PendingChunk> m_chunks;
+	};
+
+	class AssetChunkFileReader : NonCopyable
+	{
+	public:
+		struct ReadRequest
+		{
+			uint32_t id;
+			void* dest;
+			uint64_t destSize;
+		};
+
+		// Return false when file miss, not a chunk file or broken.
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		bool isOpen() const { return m_file.isOpen(); }
+
+		// Return nullptr if no exist.
+		const chunk_file::ChunkEntry* findChunk(uint32_t id) const;
+
+		uint32_t getChunkCount() const { return (uint32_t)m_chunks.size(); }
+		uint64_t getChunkSize(uint32_t id) const;
+
+		// Raw section can read zero copy from mapped file, return nullptr when chunk compressed.
+		const void* getRawChunkData(uint32_t id) const;
+
+		// Read and decompress chunks, all blocks of all requests process in parallel.
+		// Dest can be write-combined memory (mapped stage buffer), it is only write sequential once.
+		bool readChunks(const std::vector<ReadRequest>& requests) const;
+
+		bool readChunk(uint32_t id, void* dest, uint64_t destSize) const
+		{
+			return readChunks({ ReadRequest{ .id = id, .dest = dest, .destSize = destSize } });
+		}
+
+		// Check file magic only, used to fallback legacy archive format.
+		static bool isChunkFile(const std::filesystem::path& path);
+
+	private:
+		MappedFile m_file;
+		std::filesystem::path m_path;
+
+		// Chunk table and block table point to mapped memory.
+		std::vector<chunk_file::ChunkEntry> m_chunks;
+		const chunk_file::BlockEntry* m_blocks = nullptr;
+		uint64_t m_blockCount = 0;
+	};
+}
@@ -121,8 +121,8 @@ namespace engine
 		RHICommandBufferBase& commandBuffer,
 		VulkanBuffer& stageBuffer)
 	{
-		CHECK(cacheAsset->existSnapshot());
-		memcpy(bufferPtrStart, cacheAsset->getSnapshotData().data(), uploadSize());
+		CHECK(snapshotData.size() == uploadSize());
+		memcpy(bufferPtrStart, snapshotData.data(), uploadSize());
 
 		imageAssetGPU->prepareToUpload(commandBuffer, buildBasicImageSubresource());
 
@@ -143,6 +143,20 @@ namespace engine
 
 	std::shared_ptr<SnapshotAssetTextureLoadTask> SnapshotAssetTextureLoadTask::build(
 		VulkanContext* context, std::shared_ptr<AssetInterface> inAsset)
+	{
+		CHECK(inAsset->existSnapshot());
+
+		std::vector<uint8_t> pixels = inAsset->getSnapshotData();
+		return build(context, inAsset->getNameUtf8(), inAsset->getSnapshotUUID(), inAsset->getSnapshotWidth(), inAsset->getSnapshotHeight(), std::move(pixels));
+	}
+
+	std::shared_ptr<SnapshotAssetTextureLoadTask> SnapshotAssetTextureLoadTask::build(
+		VulkanContext* context,
+		const std::string& name,
+		const UUID& snapshotUUID,
+		uint32_t width,
+		uint32_t height,
+		std::vector<uint8_t>&& pixels)
 	{
 		auto* fallbackWhite = context->getEngineTextureWhite().get();
 		ASSERT(fallbackWhite, "Fallback texture must be valid, you forget init engine texture before init.");
@@ -151,16 +165,16 @@ namespace engine
 			context,
 			fallbackWhite,
 			VK_FORMAT_R8G8B8A8_UNORM, // All snapshot is unorm.
-			inAsset->getNameUtf8(),
+			name,
 			1,
-			inAsset->getSnapshotWidth(),
-			inAsset->getSnapshotHeight(),
+			width,
+			height,
 			1
 		);
 
-		context->insertGPUAsset(inAsset->getSnapshotUUID(), newAsset);
+		context->insertGPUAsset(snapshotUUID, newAsset);
 
-		auto newTask = std::make_shared<SnapshotAssetTextureLoadTask>(inAsset);
+		auto newTask = std::make_shared<SnapshotAssetTextureLoadTask>(std::move(pixels));
 		newTask->imageAssetGPU = newAsset;
 
 		return newTask;
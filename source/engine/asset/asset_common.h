@@ -31,6 +31,29 @@ namespace engine
 		Max,
 	};
 
+	// Raw source file identity store in cooked file, size alone miss in place edit which keep size.
+	struct AssetSourceStamp
+	{
+		uint64_t fileSize = 0;
+		int64_t lastWriteTime = 0; // Tick count of file last write time.
+
+		bool operator==(const AssetSourceStamp&) const = default;
+
+		// Return false when source file miss.
+		static bool get(const std::filesystem::path& path, AssetSourceStamp& out)
+		{
+			std::error_code ec;
+			out.fileSize = (uint64_t)std::filesystem::file_size(path, ec);
+			if (ec)
+			{
+				return false;
+			}
+
+			out.lastWriteTime = (int64_t)std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+			return !ec;
+		}
+	};
+
 	inline static std::string buildRelativePathUtf8(
 		const std::filesystem::path& projectRootPath, 
 		const std::filesystem::path& savePath)
@@ -170,13 +193,14 @@ namespace engine
 	// Load from asset header snapshot data, no compress, cache in lru map.
 	struct SnapshotAssetTextureLoadTask : public AssetTextureLoadTask
 	{
-		explicit SnapshotAssetTextureLoadTask(std::shared_ptr<AssetInterface> inAsset)
-			: cacheAsset(inAsset)
+		explicit SnapshotAssetTextureLoadTask(std::vector<uint8_t>&& inData)
+			: snapshotData(std::move(inData))
 		{
 
 		}
 
-		std::shared_ptr<AssetInterface> cacheAsset;
+		// RGBA8 pixels of snapshot.
+		std::vector<uint8_t> snapshotData;
 
 		virtual void uploadFunction(
 			uint32_t stageBufferOffset,
@@ -185,6 +209,15 @@ namespace engine
 			VulkanBuffer& stageBuffer) override;
 
 		static std::shared_ptr<SnapshotAssetTextureLoadTask> build(VulkanContext* context, std::shared_ptr<AssetInterface> asset);
+
+		// Build from snapshot pixels without asset, used by asset registry cache.
+		static std::shared_ptr<SnapshotAssetTextureLoadTask> build(
+			VulkanContext* context,
+			const std::string& name,
+			const UUID& snapshotUUID,
+			uint32_t width,
+			uint32_t height,
+			std::vector<uint8_t>&& pixels);
 	};
 
 	struct AssetCompressionHelper
@@ -262,6 +295,15 @@ namespace engine
 
 
 
+	// Read only stream buffer view of memory.
+	struct AssetMemoryStreamBuf : public std::streambuf
+	{
+		AssetMemoryStreamBuf(char* data, size_t size)
+		{
+			setg(data, data, data + size);
+		}
+	};
+
 	template<typename T>
 	inline bool loadAsset(T& out, const std::filesystem::path& savePath)
 	{
@@ -284,12 +326,11 @@ namespace engine
 		int decompressSize = LZ4_decompress_safe(compressionData.data(), decompressionData.data(), sizeHelper.compressionSize, sizeHelper.originalSize);
 		CHECK(decompressSize == sizeHelper.originalSize);
 
-		// Exist copy-construct.
+		// Deserialize from decompressed data in place, no string stream copy.
 		{
-			std::string str(decompressionData.data(), decompressionData.size());
-			std::stringstream ss;
-			ss << std::move(str);
-			cereal::BinaryInputArchive archive(ss);
+			AssetMemoryStreamBuf buf(decompressionData.data(), decompressionData.size());
+			std::istream is(&buf);
+			cereal::BinaryInputArchive archive(is);
 			archive(out);
 		}
 		
@@ -2,10 +2,137 @@
 #include "asset_material.h"
 #include "asset_texture.h"
 #include "asset_system.h"
+#include "asset_chunk_file.h"
 #include "../../editor/editor.h"
 
 namespace engine
 {
+    // Bump when cooked layout change, old .pmxbin will re-cook when load.
+    constexpr uint32_t kPMXBinVersion = 2;
+
+    static_assert(std::is_trivially_copyable_v<saba::PMXModel::VertexBoneInfo>);
+
+    bool PMXBin::save(
+        const saba::PMXFile& pmx,
+        const saba::PMXModel::CookedVertices& vertices,
+        const AssetSourceStamp& source,
+        const std::filesystem::path& savePath,
+        const char* suffix)
+    {
+        Header header{};
+        header.version = kPMXBinVersion;
+        header.vertexCount = (uint32_t)vertices.m_positions.size();
+        header.indexCount = vertices.m_indices.size();
+        header.source = source;
+        header.bboxMin = vertices.m_bboxMin;
+        header.bboxMax = vertices.m_bboxMax;
+
+        // Pmx strings already convert to utf8 when parse, blob store them resolved.
+        std::string modelBlob;
+        {
+            std::ostringstream os(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive archive(os);
+                archive(pmx.m_textures, pmx.m_materials, pmx.m_bones, pmx.m_morphs, pmx.m_rigidbodies, pmx.m_joints);
+            }
+            modelBlob = os.str();
+        }
+
+        // Vertex streams keep raw, so load just parallel copy from mapped file.
+        AssetChunkFileWriter writer;
+        writer.addChunk((uint32_t)EChunk::Header, &header, sizeof(header), false);
+        writer.addChunk((uint32_t)EChunk::Positions, vertices.m_positions, false);
+        writer.addChunk((uint32_t)EChunk::Normals, vertices.m_normals, false);
+        writer.addChunk((uint32_t)EChunk::SmoothNormals, vertices.m_smoothNormals, false);
+        writer.addChunk((uint32_t)EChunk::Uvs, vertices.m_uvs, false);
+        writer.addChunk((uint32_t)EChunk::BoneInfos, vertices.m_vertexBoneInfos, false);
+        writer.addChunk((uint32_t)EChunk::Indices, vertices.m_indices, false);
+        writer.addChunk((uint32_t)EChunk::Model, modelBlob.data(), modelBlob.size());
+
+        return writer.save(savePath, suffix, false);
+    }
+
+    bool PMXBin::load(
+        const std::filesystem::path& path,
+        const AssetSourceStamp& source,
+        saba::PMXFile& pmx,
+        saba::PMXModel::CookedVertices& vertices)
+    {
+        AssetChunkFileReader reader;
+        if (!reader.open(path))
+        {
+            return false;
+        }
+
+        Header header{};
+        if (reader.getChunkSize((uint32_t)EChunk::Header) != sizeof(Header) ||
+            !reader.readChunk((uint32_t)EChunk::Header, &header, sizeof(Header)))
+        {
+            return false;
+        }
+
+        if (header.version != kPMXBinVersion || header.source != source)
+        {
+            LOG_INFO("Cooked pmx {} out of date, re-cook.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        vertices.m_positions.resize(header.vertexCount);
+        vertices.m_normals.resize(header.vertexCount);
+        vertices.m_smoothNormals.resize(header.vertexCount);
+        vertices.m_uvs.resize(header.vertexCount);
+        vertices.m_vertexBoneInfos.resize(header.vertexCount);
+        vertices.m_indices.resize(header.indexCount);
+        vertices.m_bboxMin = header.bboxMin;
+        vertices.m_bboxMax = header.bboxMax;
+
+        std::string modelBlob(reader.getChunkSize((uint32_t)EChunk::Model), '\0');
+
+        auto makeRequest = [&](EChunk id, auto& data) -> AssetChunkFileReader::ReadRequest
+        {
+            return { .id = (uint32_t)id, .dest = data.data(), .destSize = data.size() * sizeof(data[0]) };
+        };
+
+        const std::vector<AssetChunkFileReader::ReadRequest> requests =
+        {
+            makeRequest(EChunk::Positions, vertices.m_positions),
+            makeRequest(EChunk::Normals, vertices.m_normals),
+            makeRequest(EChunk::SmoothNormals, vertices.m_smoothNormals),
+            makeRequest(EChunk::Uvs, vertices.m_uvs),
+            makeRequest(EChunk::BoneInfos, vertices.m_vertexBoneInfos),
+            makeRequest(EChunk::Indices, vertices.m_indices),
+            makeRequest(EChunk::Model, modelBlob),
+        };
+
+        for (const auto& request : requests)
+        {
+            if (reader.getChunkSize(request.id) != request.destSize)
+            {
+                LOG_ERROR("Cooked pmx {} chunk {} size un-match.", utf8::utf16to8(path.u16string()), request.id);
+                return false;
+            }
+        }
+
+        if (!reader.readChunks(requests))
+        {
+            return false;
+        }
+
+        try
+        {
+            std::istringstream is(modelBlob, std::ios::binary);
+            cereal::BinaryInputArchive archive(is);
+            archive(pmx.m_textures, pmx.m_materials, pmx.m_bones, pmx.m_morphs, pmx.m_rigidbodies, pmx.m_joints);
+        }
+        catch (...)
+        {
+            LOG_ERROR("Cooked pmx {} model blob broken.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        return true;
+    }
+
     AssetPMX::AssetPMX(const std::string& assetNameUtf8, const std::string& assetRelativeRootProjectPathUtf8)
         : AssetInterface(assetNameUtf8, assetRelativeRootProjectPathUtf8)
     {
@@ -50,15 +177,12 @@ namespace engine
         {
 			AssetPMX meta(assetNameUtf8, buildRelativePathUtf8(projectRootPath, pmxFileSavePath));
 
+			// Load also cook .pmxbin beside meta, so first attach no need parse raw pmx.
 			auto pmxModel = std::make_unique<saba::PMXModel>();
+			if (!meta.loadModel(*pmxModel))
 			{
-				auto path = meta.getPMXFilePath();
-				std::string pmxPath = path.string();
-				if (!pmxModel->Load(pmxPath, "image/mmd"))
-				{
-					LOG_ERROR("Failed to load pmx file {0}.", pmxPath);
-					return false;
-				}
+				LOG_ERROR("Failed to load pmx file {0}.", utf8::utf16to8(meta.getPMXFilePath().u16string()));
+				return false;
 			}
 
             {
@@ -93,6 +217,50 @@ namespace engine
         return pmxFolder;
     }
 
+    std::filesystem::path AssetPMX::getPMXBinPath() const
+    {
+        auto path = getSavePath();
+        path += ".pmxbin";
+
+        return path;
+    }
+
+    bool AssetPMX::loadModel(saba::PMXModel& model) const
+    {
+        CPU_PROFILER_SCOPE("AssetPMX::loadModel");
+
+        const auto pmxPath = getPMXFilePath();
+        const std::string pmxPathString = pmxPath.string();
+
+        AssetSourceStamp source;
+        if (!AssetSourceStamp::get(pmxPath, source))
+        {
+            LOG_ERROR("Pmx file {} miss.", pmxPathString);
+            return false;
+        }
+
+        saba::PMXFile pmx;
+        saba::PMXModel::CookedVertices vertices;
+        if (!PMXBin::load(getPMXBinPath(), source, pmx, vertices))
+        {
+            // Cooked file miss (old project) or out of date, parse raw pmx and cook again.
+            pmx = {};
+            vertices = {};
+            if (!saba::ReadPMXFile(&pmx, pmxPathString.c_str()) || !saba::PMXModel::CookVertices(pmx, vertices))
+            {
+                return false;
+            }
+
+            auto savePath = getSavePath();
+            if (!PMXBin::save(pmx, vertices, source, savePath, ".pmxbin"))
+            {
+                LOG_WARN("Fail to save cooked pmx for {}.", pmxPathString);
+            }
+        }
+
+        return model.Load(pmx, std::move(vertices), pmxPathString, "image/mmd");
+    }
+
 	// NOTE: Current only reuse texture in single pmx file.
     void AssetPMX::tryLoadAllTextures(const saba::PMXModel& pmx)
     {
@@ -111,13 +279,13 @@ namespace engine
 
 			// texture.
 			if (!matMMD.m_texture.empty() && std::filesystem::exists(matMMD.m_texture)
-				&& !texLoaded.contains(matMMD.m_texture) && !getContext()->isLRUAssetExist(matMMD.m_texture))
+				&& !texLoaded.contains(matMMD.m_texture) && !getContext()->isLRUAssetExist(UUID::fromName(matMMD.m_texture)))
 			{
 				getContext()->getAsyncUploader().addTask(RawAssetTextureLoadTask::buildTexture(
 					false,
 					getContext(),
 					matMMD.m_texture, // 
-					matMMD.m_texture, // UUID use path here.
+					UUID::fromName(matMMD.m_texture), // UUID hash from path here.
 					VK_FORMAT_R8G8B8A8_SRGB,
 					true,
 					true));
@@ -126,13 +294,13 @@ namespace engine
 
 			// Sp texture.
 			if (!matMMD.m_spTexture.empty() && std::filesystem::exists(matMMD.m_spTexture)
-				&& !texLoaded.contains(matMMD.m_spTexture) && !getContext()->isLRUAssetExist(matMMD.m_spTexture))
+				&& !texLoaded.contains(matMMD.m_spTexture) && !getContext()->isLRUAssetExist(UUID::fromName(matMMD.m_spTexture)))
 			{
 				getContext()->getAsyncUploader().addTask(RawAssetTextureLoadTask::buildTexture(
 					false,
 					getContext(),
 					matMMD.m_spTexture,
-					matMMD.m_spTexture, // UUID use path here.
+					UUID::fromName(matMMD.m_spTexture), // UUID hash from path here.
 					VK_FORMAT_R8G8B8A8_SRGB,
 					true,
 					false));
@@ -141,13 +309,13 @@ namespace engine
 
 			// toon texture.
 			if (!matMMD.m_toonTexture.empty() && std::filesystem::exists(matMMD.m_toonTexture)
-				&& !texLoaded.contains(matMMD.m_toonTexture) && !getContext()->isLRUAssetExist(matMMD.m_toonTexture))
+				&& !texLoaded.contains(matMMD.m_toonTexture) && !getContext()->isLRUAssetExist(UUID::fromName(matMMD.m_toonTexture)))
 			{
 				getContext()->getAsyncUploader().addTask(RawAssetTextureLoadTask::buildTexture(
 					false,
 					getContext(),
 					matMMD.m_toonTexture,
-					matMMD.m_toonTexture, // UUID use path here.
+					UUID::fromName(matMMD.m_toonTexture), // UUID hash from path here.
 					VK_FORMAT_R8G8B8A8_SRGB,
 					true,
 					false));
@@ -170,7 +338,7 @@ namespace engine
 			// texture.
 			if (!matMMD.m_texture.empty() && std::filesystem::exists(matMMD.m_texture))
 			{
-				workingMat.mmdTex = getContext()->getOrCreateTextureAsset(matMMD.m_texture)->getBindlessIndex();
+				workingMat.mmdTex = getContext()->getOrCreateTextureAsset(UUID::fromName(matMMD.m_texture))->getBindlessIndex();
 			}
 			else
 			{
@@ -181,7 +349,7 @@ namespace engine
 			// Sp texture.
 			if (!matMMD.m_spTexture.empty() && std::filesystem::exists(matMMD.m_spTexture))
 			{
-				workingMat.mmdSphereTex = getContext()->getOrCreateTextureAsset(matMMD.m_spTexture)->getBindlessIndex();
+				workingMat.mmdSphereTex = getContext()->getOrCreateTextureAsset(UUID::fromName(matMMD.m_spTexture))->getBindlessIndex();
 			}
 			else
 			{
@@ -192,7 +360,7 @@ namespace engine
 			// toon texture.
 			if (!matMMD.m_toonTexture.empty() && std::filesystem::exists(matMMD.m_toonTexture))
 			{
-				workingMat.mmdToonTex = getContext()->getOrCreateTextureAsset(matMMD.m_toonTexture)->getBindlessIndex();
+				workingMat.mmdToonTex = getContext()->getOrCreateTextureAsset(UUID::fromName(matMMD.m_toonTexture))->getBindlessIndex();
 			}
 			else
 			{
@@ -51,6 +51,52 @@ namespace engine
 
 
 
+	// Cooked pmx store in .pmxbin chunk file beside meta, vertex streams already SoA and names already utf8.
+	struct PMXBin
+	{
+		// Chunk id in .pmxbin chunk file.
+		enum class EChunk : uint32_t
+		{
+			Header = 0,
+			Positions,
+			Normals,
+			SmoothNormals,
+			Uvs,
+			BoneInfos,
+			Indices,
+			Model, // Cereal blob of textures, materials, bones, morphs, rigidbodies and joints.
+
+			Max,
+		};
+
+		struct Header
+		{
+			uint32_t version;
+			uint32_t vertexCount;
+			uint64_t indexCount;
+
+			// Raw pmx file size and write time when cook, cooked file rebuild when un-match.
+			AssetSourceStamp source;
+
+			glm::vec3 bboxMin;
+			glm::vec3 bboxMax;
+		};
+
+		static bool save(
+			const saba::PMXFile& pmx, 
+			const saba::PMXModel::CookedVertices& vertices, 
+			const AssetSourceStamp& source,
+			const std::filesystem::path& savePath, 
+			const char* suffix);
+
+		// Return false when file miss, broken or out of date.
+		static bool load(
+			const std::filesystem::path& path, 
+			const AssetSourceStamp& source,
+			saba::PMXFile& pmx, 
+			saba::PMXModel::CookedVertices& vertices);
+	};
+
 	// WARN: PMX mesh produced by MMD artist may **Not-Under** MIT license.
 	//       So we don't change the resource of pmx raw file.
 	//       We just add one additional meta data for it.
@@ -77,6 +123,10 @@ namespace engine
 
 		std::filesystem::path getPMXFilePath() const;
 		std::filesystem::path getPMXFolderPath() const { return getPMXFilePath().parent_path(); }
+		std::filesystem::path getPMXBinPath() const;
+
+		// Load model from cooked .pmxbin, cook it from raw pmx when miss or out of date.
+		bool loadModel(saba::PMXModel& model) const;
 
 		void tryLoadAllTextures(const saba::PMXModel& pmx);
 
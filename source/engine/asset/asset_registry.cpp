@@ -1 +1,308 @@
 #include "asset_registry.h"
+
+namespace engine
+{
+	// Bump when entry layout change, old registry cache will rebuild.
+	constexpr uint32_t kAssetRegistryVersion = 1;
+
+	// Compact snapshot blob when dead bytes more than live bytes and this size.
+	constexpr uint64_t kSnapshotBlobCompactThreshold = 4 * 1024 * 1024;
+
+	std::filesystem::path AssetRegistry::getRegistryPath() const
+	{
+		return m_projectRootPath / "cache" / "asset.registry";
+	}
+
+	std::filesystem::path AssetRegistry::getSnapshotBlobPath() const
+	{
+		return m_projectRootPath / "cache" / "asset.snapshot";
+	}
+
+	void AssetRegistry::clear()
+	{
+		m_entries.clear();
+		m_metaPathLookup.clear();
+		m_uuidLookup.clear();
+		m_snapshotBlobSize = 0;
+		m_bDirty = false;
+	}
+
+	void AssetRegistry::rebuildLookup()
+	{
+		m_metaPathLookup.clear();
+		m_uuidLookup.clear();
+
+		for (size_t i = 0; i < m_entries.size(); i++)
+		{
+			m_metaPathLookup[m_entries[i].metaPathUtf8] = i;
+			m_uuidLookup[m_entries[i].uuid] = i;
+		}
+	}
+
+	bool AssetRegistry::load(const std::filesystem::path& projectRootPath)
+	{
+		clear();
+		m_projectRootPath = projectRootPath;
+
+		const auto registryPath = getRegistryPath();
+		const auto blobPath = getSnapshotBlobPath();
+		if (!std::filesystem::exists(registryPath))
+		{
+			return false;
+		}
+
+		try
+		{
+			uint32_t version = 0;
+			uint64_t blobSize = 0;
+			std::vector<AssetRegistryEntry> entries;
+			{
+				std::ifstream is(registryPath, std::ios::binary);
+				cereal::BinaryInputArchive archive(is);
+
+				archive(version);
+				if (version != kAssetRegistryVersion)
+				{
+					LOG_INFO("Asset registry version change, rebuild.");
+					return false;
+				}
+				archive(blobSize, entries);
+			}
+
+			// Blob only create when some asset has snapshot, miss is valid when registry record empty blob.
+			std::error_code ec;
+			const uint64_t fileSize = std::filesystem::exists(blobPath) ? (uint64_t)std::filesystem::file_size(blobPath, ec) : 0;
+
+			// Blob write interrupt, snapshot offset no trust.
+			if (ec || fileSize != blobSize)
+			{
+				LOG_WARN("Asset registry snapshot blob size mismatch, rebuild.");
+				return false;
+			}
+
+			m_entries = std::move(entries);
+			m_snapshotBlobSize = blobSize;
+		}
+		catch (...)
+		{
+			LOG_WARN("Asset registry cache broken, rebuild.");
+			clear();
+			m_projectRootPath = projectRootPath;
+			return false;
+		}
+
+		rebuildLookup();
+		return true;
+	}
+
+	const AssetRegistryEntry* AssetRegistry::findByMetaPath(const std::string& metaPathUtf8) const
+	{
+		auto iter = m_metaPathLookup.find(metaPathUtf8);
+		return iter == m_metaPathLookup.end() ? nullptr : &m_entries[iter->second];
+	}
+
+	const AssetRegistryEntry* AssetRegistry::findByUUID(const UUID& uuid) const
+	{
+		auto iter = m_uuidLookup.find(uuid);
+		return iter == m_uuidLookup.end() ? nullptr : &m_entries[iter->second];
+	}
+
+	void AssetRegistry::getMetaFileState(const std::filesystem::path& path, int64_t& outWriteTime, uint64_t& outFileSize)
+	{
+		std::error_code ec;
+		outWriteTime = (int64_t)std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+		outFileSize = (uint64_t)std::filesystem::file_size(path, ec);
+	}
+
+	std::vector<char> AssetRegistry::compressSnapshot(const AssetInterface& asset)
+	{
+		std::vector<char> result;
+		if (!asset.existSnapshot())
+		{
+			return result;
+		}
+
+		const auto& data = asset.getSnapshotData();
+		result.resize(LZ4_compressBound((int)data.size()));
+
+		const int compressedSize = LZ4_compress_default((const char*)data.data(), result.data(), (int)data.size(), (int)result.size());
+		result.resize(compressedSize > 0 ? compressedSize : 0);
+
+		return result;
+	}
+
+	void AssetRegistry::resetEntries(std::vector<AssetRegistryEntry>&& entries, const std::vector<std::vector<char>>& newSnapshots)
+	{
+		CHECK(entries.size() == newSnapshots.size());
+
+		bool bChanged = (entries.size() != m_entries.size());
+		for (const auto& entry : entries)
+		{
+			const auto* old = findByMetaPath(entry.metaPathUtf8);
+			bChanged |= !old || old->writeTime != entry.writeTime || old->fileSize != entry.fileSize || old->uuid != entry.uuid;
+		}
+
+		// New snapshots append to blob end.
+		const auto blobPath = getSnapshotBlobPath();
+		std::filesystem::create_directories(blobPath.parent_path());
+		if (m_snapshotBlobSize == 0)
+		{
+			// No valid registry load, drop stale blob.
+			std::error_code ec;
+			std::filesystem::remove(blobPath, ec);
+		}
+		{
+			std::ofstream os;
+			for (size_t i = 0; i < entries.size(); i++)
+			{
+				const auto& snapshot = newSnapshots[i];
+				if (snapshot.empty())
+				{
+					continue;
+				}
+
+				if (!os.is_open())
+				{
+					os.open(blobPath, std::ios::binary | std::ios::app);
+				}
+
+				entries[i].snapshotOffset = m_snapshotBlobSize;
+				entries[i].snapshotCompressedSize = (uint32_t)snapshot.size();
+
+				os.write(snapshot.data(), snapshot.size());
+				m_snapshotBlobSize += snapshot.size();
+			}
+		}
+
+		m_entries = std::move(entries);
+		rebuildLookup();
+
+		m_bDirty |= bChanged;
+	}
+
+	bool AssetRegistry::loadSnapshot(const AssetRegistryEntry& entry, std::vector<uint8_t>& out) const
+	{
+		if (!entry.existSnapshot())
+		{
+			return false;
+		}
+
+		std::vector<char> compressed(entry.snapshotCompressedSize);
+		{
+			std::ifstream is(getSnapshotBlobPath(), std::ios::binary);
+			is.seekg(entry.snapshotOffset);
+			is.read(compressed.data(), compressed.size());
+			if (!is)
+			{
+				LOG_ERROR("Fail to read snapshot of asset {} from registry.", entry.relativePathUtf8);
+				return false;
+			}
+		}
+
+		out.resize(size_t(entry.snapshotWidth) * entry.snapshotHeight * 4);
+		const int decompressSize = LZ4_decompress_safe(compressed.data(), (char*)out.data(), (int)compressed.size(), (int)out.size());
+
+		return decompressSize == (int)out.size();
+	}
+
+	bool AssetRegistry::compactSnapshotBlob()
+	{
+		const auto blobPath = getSnapshotBlobPath();
+		auto tempPath = blobPath;
+		tempPath += ".tmp";
+
+		// Offsets apply only after new blob replace old one, else registry save wrong offsets.
+		std::vector<uint64_t> newOffsets(m_entries.size(), 0);
+		uint64_t newSize = 0;
+		bool bCopySucceed = true;
+		{
+			std::ifstream is(blobPath, std::ios::binary);
+			std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+
+			std::vector<char> buffer;
+			for (size_t i = 0; i < m_entries.size(); i++)
+			{
+				const auto& entry = m_entries[i];
+				if (!entry.existSnapshot())
+				{
+					continue;
+				}
+
+				buffer.resize(entry.snapshotCompressedSize);
+				is.seekg(entry.snapshotOffset);
+				is.read(buffer.data(), buffer.size());
+				if (!is)
+				{
+					bCopySucceed = false;
+					break;
+				}
+
+				os.write(buffer.data(), buffer.size());
+				newOffsets[i] = newSize;
+				newSize += buffer.size();
+			}
+
+			os.flush();
+			bCopySucceed &= bool(os);
+		}
+
+		std::error_code ec;
+		if (!bCopySucceed)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		std::filesystem::rename(tempPath, blobPath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		for (size_t i = 0; i < m_entries.size(); i++)
+		{
+			if (m_entries[i].existSnapshot())
+			{
+				m_entries[i].snapshotOffset = newOffsets[i];
+			}
+		}
+		m_snapshotBlobSize = newSize;
+		return true;
+	}
+
+	bool AssetRegistry::save()
+	{
+		if (!m_bDirty)
+		{
+			return true;
+		}
+
+		uint64_t liveSize = 0;
+		for (const auto& entry : m_entries)
+		{
+			liveSize += entry.existSnapshot() ? entry.snapshotCompressedSize : 0;
+		}
+
+		const uint64_t deadSize = m_snapshotBlobSize - liveSize;
+		if (deadSize > liveSize && deadSize > kSnapshotBlobCompactThreshold)
+		{
+			if (!compactSnapshotBlob())
+			{
+				LOG_WARN("Fail to compact asset registry snapshot blob.");
+			}
+		}
+
+		const auto registryPath = getRegistryPath();
+		std::filesystem::create_directories(registryPath.parent_path());
+		{
+			std::ofstream os(registryPath, std::ios::binary | std::ios::trunc);
+			cereal::BinaryOutputArchive archive(os);
+
+			archive(kAssetRegistryVersion, m_snapshotBlobSize, m_entries);
+		}
+
+		m_bDirty = false;
+		return true;
+	}
+}
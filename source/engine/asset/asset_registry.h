@@ -1,8 +1,87 @@
 #pragma once
 
-#include <util/util.h>
+#include "asset_common.h"
 
 namespace engine
 {
+	// One asset meta file record of project.
+	struct AssetRegistryEntry
+	{
+		UUID uuid = {};
+		EAssetType type = EAssetType::Max;
 
-}
\ No newline at end of file
+		// Meta file path relative to project root, utf8 encode.
+		std::string metaPathUtf8;
+
+		// Same as AssetInterface::getRelativePathUtf8.
+		std::string relativePathUtf8;
+
+		// Meta file state when record, used to revalidate.
+		int64_t writeTime = 0;
+		uint64_t fileSize = 0;
+
+		// Snapshot pixels store lz4 compressed in registry snapshot blob.
+		UUID snapshotUUID = {};
+		uint32_t snapshotWidth = 0;
+		uint32_t snapshotHeight = 0;
+		uint64_t snapshotOffset = 0;
+		uint32_t snapshotCompressedSize = 0;
+
+		bool existSnapshot() const { return snapshotCompressedSize > 0 && snapshotWidth > 0 && snapshotHeight > 0; }
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(uuid, type, metaPathUtf8, relativePathUtf8, writeTime, fileSize);
+			archive(snapshotUUID, snapshotWidth, snapshotHeight, snapshotOffset, snapshotCompressedSize);
+		}
+	};
+
+	// Persistent asset index of project, so open project no need decompress every meta file.
+	// Entry revalidate by meta file write time and size, only changed meta load again.
+	class AssetRegistry : NonCopyable
+	{
+	public:
+		// Load registry cache of project, return false when no cache or version mismatch.
+		bool load(const std::filesystem::path& projectRootPath);
+
+		// Save registry cache, compact snapshot blob when garbage too much.
+		bool save();
+
+		void clear();
+
+		const AssetRegistryEntry* findByMetaPath(const std::string& metaPathUtf8) const;
+		const AssetRegistryEntry* findByUUID(const UUID& uuid) const;
+
+		// Replace all entries, entries without snapshot offset but with snapshot data append to blob.
+		void resetEntries(std::vector<AssetRegistryEntry>&& entries, const std::vector<std::vector<char>>& newSnapshots);
+
+		// Decode snapshot pixels from blob.
+		bool loadSnapshot(const AssetRegistryEntry& entry, std::vector<uint8_t>& out) const;
+
+		const auto& getEntries() const { return m_entries; }
+
+		// Meta file state for revalidate.
+		static void getMetaFileState(const std::filesystem::path& path, int64_t& outWriteTime, uint64_t& outFileSize);
+
+		// Compress snapshot of asset, empty when no snapshot.
+		static std::vector<char> compressSnapshot(const AssetInterface& asset);
+
+	private:
+		std::filesystem::path getRegistryPath() const;
+		std::filesystem::path getSnapshotBlobPath() const;
+
+		void rebuildLookup();
+		bool compactSnapshotBlob();
+
+	private:
+		std::filesystem::path m_projectRootPath;
+
+		std::vector<AssetRegistryEntry> m_entries;
+		std::unordered_map<std::string, size_t> m_metaPathLookup;
+		std::unordered_map<UUID, size_t> m_uuidLookup;
+
+		// Snapshot blob size in bytes, include dead snapshots.
+		uint64_t m_snapshotBlobSize = 0;
+		bool m_bDirty = false;
+	};
+}
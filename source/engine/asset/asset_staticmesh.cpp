@@ -3,12 +3,343 @@
 #include "asset_texture.h"
 
 #include <util/assimp_helper.h>
+#include <util/mesh_simplify.h>
 #include "asset_system.h"
 
 
 
 namespace engine
 {
+	// Meshlet limits, same as common mesh shader limits so cluster also fit mesh shader path later.
+	constexpr uint32_t kMeshletMaxVertices = 64;
+	constexpr uint32_t kMeshletMaxTriangles = 124;
+
+	// Bounding sphere and normal cone of triangles [indicesStart, indicesStart + indicesCount).
+	static void computeMeshletBounds(
+		const std::vector<VertexPosition>& positions,
+		const std::vector<VertexIndexType>& indices,
+		StaticMeshMeshlet& meshlet)
+	{
+		const uint32_t indicesEnd = meshlet.indicesStart + meshlet.indicesCount;
+
+		math::vec3 minPos = math::vec3(std::numeric_limits<float>::max());
+		math::vec3 maxPos = math::vec3(std::numeric_limits<float>::lowest());
+		for (uint32_t i = meshlet.indicesStart; i < indicesEnd; i++)
+		{
+			minPos = math::min(minPos, positions[indices[i]]);
+			maxPos = math::max(maxPos, positions[indices[i]]);
+		}
+
+		const math::vec3 center = (minPos + maxPos) * 0.5f;
+		float radius = 0.0f;
+		for (uint32_t i = meshlet.indicesStart; i < indicesEnd; i++)
+		{
+			radius = math::max(radius, math::length(positions[indices[i]] - center));
+		}
+		meshlet.sphereBounds = math::vec4(center, radius);
+
+		// Cone axis is average of triangle normals, cutoff from the widest normal.
+		std::vector<math::vec3> normals;
+		normals.reserve(meshlet.indicesCount / 3);
+
+		math::vec3 axis = math::vec3(0.0f);
+		for (uint32_t i = meshlet.indicesStart; i + 2 < indicesEnd; i += 3)
+		{
+			const auto& p0 = positions[indices[i + 0]];
+			const auto& p1 = positions[indices[i + 1]];
+			const auto& p2 = positions[indices[i + 2]];
+
+			const math::vec3 n = math::cross(p1 - p0, p2 - p0);
+			const float len = math::length(n);
+			if (len > 1e-12f)
+			{
+				normals.push_back(n / len);
+				axis += normals.back();
+			}
+		}
+
+		const float axisLen = math::length(axis);
+		if (normals.empty() || axisLen < 1e-6f)
+		{
+			meshlet.cone = math::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+			return;
+		}
+		axis /= axisLen;
+
+		float minDot = 1.0f;
+		for (const auto& n : normals)
+		{
+			minDot = math::min(minDot, math::dot(axis, n));
+		}
+
+		// Normals spread over hemisphere, never all backface.
+		const float cutoff = minDot <= 0.0f ? 1.0f : math::sqrt(1.0f - minDot * minDot);
+		meshlet.cone = math::vec4(axis, cutoff);
+	}
+
+	// Greedy cluster triangles of one submesh, grow current meshlet by adjacent triangle which add least new vertices.
+	// Indices of submesh reorder in place so each meshlet is continuous.
+	static void buildSubmeshMeshlets(
+		const std::vector<VertexPosition>& positions,
+		std::vector<VertexIndexType>& indices,
+		const StaticMeshSubMesh& submesh,
+		std::vector<StaticMeshMeshlet>& outMeshlets)
+	{
+		const uint32_t triangleCount = submesh.indicesCount / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		const VertexIndexType* triIndices = indices.data() + submesh.indicesStart;
+
+		// Local vertex remap, submesh only touch part of vertices.
+		std::unordered_map<VertexIndexType, uint32_t> vertexRemap;
+		std::vector<uint32_t> localTriVertices(triangleCount * 3);
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+		{
+			auto [iter, bInsert] = vertexRemap.try_emplace(triIndices[i], uint32_t(vertexRemap.size()));
+			localTriVertices[i] = iter->second;
+		}
+		const uint32_t vertexCount = uint32_t(vertexRemap.size());
+
+		// Vertex to triangle adjacency.
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t v : localTriVertices)
+		{
+			adjacencyOffsets[v + 1]++;
+		}
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+		std::vector<uint32_t> adjacencyTriangles(triangleCount * 3);
+		{
+			std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < triangleCount * 3; i++)
+			{
+				adjacencyTriangles[fillOffsets[localTriVertices[i]]++] = i / 3;
+			}
+		}
+
+		std::vector<bool> triangleEmitted(triangleCount, false);
+
+		// Stamp of meshlet which vertex / candidate triangle belong, avoid clear per meshlet.
+		std::vector<uint32_t> vertexStamp(vertexCount, ~0u);
+		std::vector<uint32_t> candidateStamp(triangleCount, ~0u);
+
+		std::vector<VertexIndexType> reorderIndices;
+		reorderIndices.reserve(submesh.indicesCount);
+
+		std::vector<uint32_t> candidates;
+		uint32_t scanTriangle = 0;
+		uint32_t meshletId = 0;
+
+		while (true)
+		{
+			// Seed with first no emitted triangle, source order usually already has some locality.
+			while (scanTriangle < triangleCount && triangleEmitted[scanTriangle])
+			{
+				scanTriangle++;
+			}
+			if (scanTriangle >= triangleCount)
+			{
+				break;
+			}
+
+			StaticMeshMeshlet meshlet{};
+			meshlet.indicesStart = submesh.indicesStart + uint32_t(reorderIndices.size());
+
+			uint32_t meshletVertexCount = 0;
+			uint32_t meshletTriangleCount = 0;
+
+			candidates.clear();
+			uint32_t nextTriangle = scanTriangle;
+
+			while (nextTriangle != ~0u)
+			{
+				// Emit triangle.
+				triangleEmitted[nextTriangle] = true;
+				meshletTriangleCount++;
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t v = localTriVertices[nextTriangle * 3 + k];
+					reorderIndices.push_back(triIndices[nextTriangle * 3 + k]);
+
+					if (vertexStamp[v] != meshletId)
+					{
+						vertexStamp[v] = meshletId;
+						meshletVertexCount++;
+
+						// New vertex, neighbor triangles become candidates.
+						for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++)
+						{
+							const uint32_t t = adjacencyTriangles[a];
+							if (!triangleEmitted[t] && candidateStamp[t] != meshletId)
+							{
+								candidateStamp[t] = meshletId;
+								candidates.push_back(t);
+							}
+						}
+					}
+				}
+
+				if (meshletTriangleCount >= kMeshletMaxTriangles)
+				{
+					break;
+				}
+
+				// Pick candidate add least new vertices.
+				nextTriangle = ~0u;
+				uint32_t bestNewVertices = 4;
+				for (size_t c = 0; c < candidates.size();)
+				{
+					const uint32_t t = candidates[c];
+					if (triangleEmitted[t])
+					{
+						candidates[c] = candidates.back();
+						candidates.pop_back();
+						continue;
+					}
+
+					uint32_t newVertices = 0;
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						newVertices += (vertexStamp[localTriVertices[t * 3 + k]] != meshletId) ? 1 : 0;
+					}
+
+					if (newVertices < bestNewVertices && meshletVertexCount + newVertices <= kMeshletMaxVertices)
+					{
+						bestNewVertices = newVertices;
+						nextTriangle = t;
+						if (newVertices == 0)
+						{
+							break;
+						}
+					}
+					c++;
+				}
+			}
+
+			meshlet.indicesCount = meshletTriangleCount * 3;
+			outMeshlets.push_back(meshlet);
+			meshletId++;
+		}
+
+		// Remainder indices no full triangle keep at tail, no belong to any meshlet.
+		for (uint32_t i = triangleCount * 3; i < submesh.indicesCount; i++)
+		{
+			reorderIndices.push_back(triIndices[i]);
+		}
+
+		std::copy(reorderIndices.begin(), reorderIndices.end(), indices.begin() + submesh.indicesStart);
+	}
+
+	// Build meshlets of all submeshes in parallel, submesh index ranges no overlap.
+	static void buildMeshlets(
+		const std::vector<VertexPosition>& positions,
+		std::vector<VertexIndexType>& indices,
+		const std::vector<StaticMeshSubMesh>& submeshes,
+		std::vector<StaticMeshMeshletRange>& outRanges,
+		std::vector<StaticMeshMeshlet>& outMeshlets)
+	{
+		std::vector<std::vector<StaticMeshMeshlet>> submeshMeshlets(submeshes.size());
+
+		ThreadPool::getDefault()->parallelFor(size_t(0), submeshes.size(), [&](const size_t start, const size_t end)
+		{
+			for (size_t i = start; i < end; i++)
+			{
+				buildSubmeshMeshlets(positions, indices, submeshes[i], submeshMeshlets[i]);
+				for (auto& meshlet : submeshMeshlets[i])
+				{
+					computeMeshletBounds(positions, indices, meshlet);
+				}
+			}
+		});
+
+		outRanges.resize(submeshes.size());
+		outMeshlets.clear();
+		for (size_t i = 0; i < submeshes.size(); i++)
+		{
+			outRanges[i].meshletStart = uint32_t(outMeshlets.size());
+			outRanges[i].meshletCount = uint32_t(submeshMeshlets[i].size());
+			outMeshlets.insert(outMeshlets.end(), submeshMeshlets[i].begin(), submeshMeshlets[i].end());
+		}
+	}
+
+	// Each LOD target half triangles of previous LOD.
+	constexpr float kLODIndexRatio = 0.5f;
+
+	// Max simplify error relative to submesh bounds size of each LOD.
+	constexpr float kLODTargetErrors[kStaticMeshMaxLODCount - 1] = { 0.01f, 0.02f, 0.04f };
+
+	// Stop build coarser LOD when simplify can't reduce enough, or mesh already small.
+	constexpr float kLODMinReduceRatio = 0.85f;
+	constexpr uint32_t kLODMinTriangles = 64;
+
+	// Build LOD chain of one submesh, simplify from previous LOD.
+	static void buildSubmeshLODs(
+		const std::vector<VertexPosition>& positions,
+		const std::vector<VertexIndexType>& indices,
+		const StaticMeshSubMesh& submesh,
+		std::vector<std::vector<VertexIndexType>>& outLODIndices)
+	{
+		std::vector<VertexIndexType> srcIndices(
+			indices.begin() + submesh.indicesStart, 
+			indices.begin() + submesh.indicesStart + submesh.indicesCount);
+
+		for (uint32_t lod = 1; lod < kStaticMeshMaxLODCount; lod++)
+		{
+			if (srcIndices.size() / 3 < kLODMinTriangles)
+			{
+				break;
+			}
+
+			std::vector<VertexIndexType> lodIndices;
+			const size_t targetIndexCount = size_t(srcIndices.size() * kLODIndexRatio) / 3 * 3;
+			simplifyMesh(lodIndices, srcIndices.data(), srcIndices.size(), positions, targetIndexCount, kLODTargetErrors[lod - 1]);
+
+			if (lodIndices.empty() || lodIndices.size() > size_t(srcIndices.size() * kLODMinReduceRatio))
+			{
+				break;
+			}
+
+			outLODIndices.push_back(lodIndices);
+			srcIndices = std::move(lodIndices);
+		}
+	}
+
+	// Build LODs of all submeshes in parallel, LOD indices append after all LOD0 indices so meshlets no change.
+	static void buildLODs(
+		const std::vector<VertexPosition>& positions,
+		std::vector<VertexIndexType>& indices,
+		std::vector<StaticMeshSubMesh>& submeshes)
+	{
+		std::vector<std::vector<std::vector<VertexIndexType>>> submeshLODs(submeshes.size());
+
+		ThreadPool::getDefault()->parallelFor(size_t(0), submeshes.size(), [&](const size_t start, const size_t end)
+		{
+			for (size_t i = start; i < end; i++)
+			{
+				buildSubmeshLODs(positions, indices, submeshes[i], submeshLODs[i]);
+			}
+		});
+
+		for (size_t i = 0; i < submeshes.size(); i++)
+		{
+			submeshes[i].lods.clear();
+			for (const auto& lodIndices : submeshLODs[i])
+			{
+				StaticMeshLOD lod{};
+				lod.indicesStart = uint32_t(indices.size());
+				lod.indicesCount = uint32_t(lodIndices.size());
+
+				indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+				submeshes[i].lods.push_back(lod);
+			}
+		}
+	}
+
 	AssetStaticMesh::AssetStaticMesh(const std::string& assetNameUtf8, const std::string& assetRelativeRootProjectPathUtf8)
 		: AssetInterface(assetNameUtf8, assetRelativeRootProjectPathUtf8)
 	{
@@ -56,31 +387,54 @@ namespace engine
 
 		const auto meshFileSavePath = savePath / assetNameUtf8;
 
+		StaticMeshBin meshBin{};
+		meshBin.indices = processor.moveIndices();
+		meshBin.tangents = processor.moveTangents();
+		meshBin.normals = processor.moveNormals();
+		meshBin.uv0s = processor.moveUv0s();
+		meshBin.positions = processor.movePositions();
 
+		std::vector<StaticMeshSubMesh> subMeshes = processor.getSubmeshInfo();
+
+		// Cluster triangles for gpu cluster culling, indices reorder inside each submesh.
+		std::vector<StaticMeshMeshletRange> meshletRanges;
+		buildMeshlets(meshBin.positions, meshBin.indices, subMeshes, meshletRanges, meshBin.meshlets);
+
+		// Simplified LODs append to index buffer tail.
+		buildLODs(meshBin.positions, meshBin.indices, subMeshes);
 
 		// Save asset meta.
 		{
 			AssetStaticMesh meta(assetNameUtf8, buildRelativePathUtf8(projectRootPath, meshFileSavePath));
-			meta.m_subMeshes = processor.getSubmeshInfo();
-			meta.m_indicesCount = processor.getIndicesCount();
-			meta.m_verticesCount = processor.getVerticesCount();
+			meta.m_subMeshes = std::move(subMeshes);
+			meta.m_indicesCount = meshBin.indices.size();
+			meta.m_verticesCount = meshBin.positions.size();
+			meta.m_meshletRanges = std::move(meshletRanges);
+			meta.m_meshletCount = meshBin.meshlets.size();
 
 			saveAssetMeta<AssetStaticMesh>(meta, meshFileSavePath, ".staticmesh");
 		}
 
 		// Save static mesh binary file.
-		{
-			StaticMeshBin meshBin{};
-			meshBin.indices = processor.moveIndices();
-			meshBin.tangents = processor.moveTangents();
-			meshBin.normals = processor.moveNormals();
-			meshBin.uv0s = processor.moveUv0s();
-			meshBin.positions = processor.movePositions();
+		meshBin.save(meshFileSavePath, ".staticmeshbin");
+
+		return true;
+	}
 
-			saveAsset(meshBin, meshFileSavePath, ".staticmeshbin");
+	bool StaticMeshBin::save(const std::filesystem::path& savePath, const char* suffix) const
+	{
+		AssetChunkFileWriter writer;
+		writer.addChunk((uint32_t)EChunk::Indices, indices);
+		writer.addChunk((uint32_t)EChunk::Tangents, tangents);
+		writer.addChunk((uint32_t)EChunk::Normals, normals);
+		writer.addChunk((uint32_t)EChunk::Uv0s, uv0s);
+		writer.addChunk((uint32_t)EChunk::Positions, positions);
+		if (!meshlets.empty())
+		{
+			writer.addChunk((uint32_t)EChunk::Meshlets, meshlets);
 		}
 
-		return true;
+		return writer.save(savePath, suffix);
 	}
 
 	void AssetStaticMeshLoadFromCacheTask::uploadFunction(
@@ -93,90 +447,103 @@ namespace engine
 		auto filePath = "\\." + cachePtr->getRelativePathUtf8() + ".staticmeshbin";
 		savePath += filePath;
 
-		StaticMeshBin meshBin{};
-		loadAsset(meshBin, savePath);
-
-		const auto tangentSize = meshBin.tangents.size() * sizeof(meshBin.tangents[0]);
-		const auto normalSize = meshBin.normals.size() * sizeof(meshBin.normals[0]);
-		const auto uv0Size = meshBin.uv0s.size() * sizeof(meshBin.uv0s[0]);
-		const auto indicesSize  = meshBin.indices.size() * sizeof(meshBin.indices[0]);
-		const auto positionsSize = meshBin.positions.size() * sizeof(meshBin.positions[0]);
-
-		ASSERT(uploadSize() == uint32_t(indicesSize + tangentSize + normalSize + uv0Size + positionsSize), "Static mesh size un-match!");
-
-		uint32_t indicesOffsetInSrcBuffer = 0;
-		uint32_t tangentOffsetInSrcBuffer = (uint32_t)(indicesOffsetInSrcBuffer + indicesSize);
-		uint32_t normalOffsetInSrcBuffer = (uint32_t)(tangentOffsetInSrcBuffer + tangentSize);
-		uint32_t uv0OffsetInSrcBuffer = (uint32_t)(normalOffsetInSrcBuffer + normalSize);
-		uint32_t positionsOffsetInSrcBuffer = (uint32_t)(uv0OffsetInSrcBuffer + uv0Size);
-
-		memcpy((void*)((char*)bufferPtrStart + indicesOffsetInSrcBuffer), (const void*)meshBin.indices.data(), indicesSize);
-		memcpy((void*)((char*)bufferPtrStart + tangentOffsetInSrcBuffer), (const void*)meshBin.tangents.data(), tangentSize);
-		memcpy((void*)((char*)bufferPtrStart + normalOffsetInSrcBuffer), (const void*)meshBin.normals.data(), normalSize);
-		memcpy((void*)((char*)bufferPtrStart + uv0OffsetInSrcBuffer), (const void*)meshBin.uv0s.data(), uv0Size);
-		memcpy((void*)((char*)bufferPtrStart + positionsOffsetInSrcBuffer), (const void*)meshBin.positions.data(), positionsSize);
+		using EChunk = StaticMeshBin::EChunk;
+		constexpr uint32_t kChunkCount = (uint32_t)EChunk::Max;
 
+		const uint64_t chunkSizes[kChunkCount] =
 		{
-			VkBufferCopy regionIndex{};
-			regionIndex.size = indicesSize;
-			regionIndex.srcOffset = stageBufferOffset + indicesOffsetInSrcBuffer;
-			regionIndex.dstOffset = 0;
-			vkCmdCopyBuffer(
-				commandBuffer.cmd,
-				stageBuffer,
-				meshAssetGPU->getIndices()->getVkBuffer(),
-				1,
-				&regionIndex);
-		}
-
+			cachePtr->getIndicesCount()  * sizeof(VertexIndexType),
+			cachePtr->getVerticesCount() * sizeof(VertexTangent),
+			cachePtr->getVerticesCount() * sizeof(VertexNormal),
+			cachePtr->getVerticesCount() * sizeof(VertexUv0),
+			cachePtr->getVerticesCount() * sizeof(VertexPosition),
+			cachePtr->getMeshletCount()  * sizeof(StaticMeshMeshlet),
+		};
+
+		uint64_t chunkOffsets[kChunkCount];
+		uint64_t totalSize = 0;
+		for (uint32_t i = 0; i < kChunkCount; i++)
 		{
-			VkBufferCopy regionVertex{};
-			regionVertex.size = tangentSize;
-			regionVertex.srcOffset = stageBufferOffset + tangentOffsetInSrcBuffer;
-			regionVertex.dstOffset = 0;
-			vkCmdCopyBuffer(
-				commandBuffer.cmd,
-				stageBuffer,
-				meshAssetGPU->getTangents()->getVkBuffer(),
-				1,
-				&regionVertex);
+			chunkOffsets[i] = totalSize;
+			totalSize += chunkSizes[i];
 		}
+		ASSERT(uploadSize() == uint32_t(totalSize), "Static mesh size un-match!");
+
+		AssetChunkFileReader reader;
+		if (reader.open(savePath))
 		{
-			VkBufferCopy regionVertex{};
-			regionVertex.size = normalSize;
-			regionVertex.srcOffset = stageBufferOffset + normalOffsetInSrcBuffer;
-			regionVertex.dstOffset = 0;
-			vkCmdCopyBuffer(
-				commandBuffer.cmd,
-				stageBuffer,
-				meshAssetGPU->getNormals()->getVkBuffer(),
-				1,
-				&regionVertex);
+			// Decompress all chunks directly into stage buffer, old file no meshlets chunk.
+			std::vector<AssetChunkFileReader::ReadRequest> requests;
+			for (uint32_t i = 0; i < kChunkCount; i++)
+			{
+				if (chunkSizes[i] == 0)
+				{
+					continue;
+				}
+
+				ASSERT(reader.getChunkSize(i) == chunkSizes[i], "Static mesh size un-match!");
+				requests.push_back({ .id = i, .dest = (char*)bufferPtrStart + chunkOffsets[i], .destSize = chunkSizes[i] });
+			}
+			if (!reader.readChunks(requests))
+			{
+				// Buffers content undefined, skip copy and keep loading state so draw still use fallback.
+				LOG_ERROR("Cooked static mesh {} chunks broken.", utf8::utf16to8(savePath.u16string()));
+				bUploadFailed = true;
+				return;
+			}
 		}
+		else
 		{
-			VkBufferCopy regionVertex{};
-			regionVertex.size = uv0Size;
-			regionVertex.srcOffset = stageBufferOffset + uv0OffsetInSrcBuffer;
-			regionVertex.dstOffset = 0;
-			vkCmdCopyBuffer(
-				commandBuffer.cmd,
-				stageBuffer,
-				meshAssetGPU->getUv0s()->getVkBuffer(),
-				1,
-				&regionVertex);
+			// Legacy cereal archive.
+			StaticMeshBin meshBin{};
+			loadAsset(meshBin, savePath);
+
+			const void* chunkDatas[kChunkCount] =
+			{
+				meshBin.indices.data(),
+				meshBin.tangents.data(),
+				meshBin.normals.data(),
+				meshBin.uv0s.data(),
+				meshBin.positions.data(),
+				nullptr,
+			};
+
+			// Legacy archive never has meshlets.
+			ASSERT(meshBin.indices.size() == cachePtr->getIndicesCount() && meshBin.positions.size() == cachePtr->getVerticesCount(), "Static mesh size un-match!");
+			ASSERT(chunkSizes[(uint32_t)EChunk::Meshlets] == 0, "Static mesh size un-match!");
+			for (uint32_t i = 0; i < (uint32_t)EChunk::Meshlets; i++)
+			{
+				memcpy((void*)((char*)bufferPtrStart + chunkOffsets[i]), chunkDatas[i], chunkSizes[i]);
+			}
 		}
 
+		const VkBuffer dstBuffers[kChunkCount] =
+		{
+			meshAssetGPU->getIndices()->getVkBuffer(),
+			meshAssetGPU->getTangents()->getVkBuffer(),
+			meshAssetGPU->getNormals()->getVkBuffer(),
+			meshAssetGPU->getUv0s()->getVkBuffer(),
+			meshAssetGPU->getPosition()->getVkBuffer(),
+			meshAssetGPU->getMeshlets() ? meshAssetGPU->getMeshlets()->getVkBuffer() : VK_NULL_HANDLE,
+		};
+
+		for (uint32_t i = 0; i < kChunkCount; i++)
 		{
-			VkBufferCopy regionVertex{};
-			regionVertex.size = positionsSize;
-			regionVertex.srcOffset = stageBufferOffset + positionsOffsetInSrcBuffer;
-			regionVertex.dstOffset = 0;
+			if (chunkSizes[i] == 0)
+			{
+				continue;
+			}
+
+			VkBufferCopy region{};
+			region.size = chunkSizes[i];
+			region.srcOffset = stageBufferOffset + chunkOffsets[i];
+			region.dstOffset = 0;
 			vkCmdCopyBuffer(
 				commandBuffer.cmd,
 				stageBuffer,
-				meshAssetGPU->getPosition()->getVkBuffer(),
+				dstBuffers[i],
 				1,
-				&regionVertex);
+				&region);
 		}
 	}
 
@@ -190,6 +557,7 @@ namespace engine
 		const VkDeviceSize uv0Size = meta->getVerticesCount() * sizeof(VertexUv0);
 		const VkDeviceSize positionsSize = meta->getVerticesCount() * sizeof(VertexPosition);
 		const VkDeviceSize indicesSize   = meta->getIndicesCount() * sizeof(VertexIndexType);
+		const VkDeviceSize meshletsSize  = meta->getMeshletCount() * sizeof(StaticMeshMeshlet);
 
 		auto newAsset = std::make_shared<GPUStaticMeshAsset>(
 			context,
@@ -205,7 +573,8 @@ namespace engine
 			positionsSize,
 			sizeof(VertexPosition),
 			indicesSize,
-			sizeof(VertexIndexType)
+			sizeof(VertexIndexType),
+			meshletsSize
 		);
 
 		context->insertLRUAsset(meta->getUUID(), newAsset);
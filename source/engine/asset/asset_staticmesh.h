@@ -2,6 +2,7 @@
 
 #include "asset_common.h"
 #include "asset_archive.h"
+#include "asset_chunk_file.h"
 #include <util/shader_struct.h>
 
 namespace engine
@@ -15,10 +16,28 @@ namespace engine
 		std::vector<VertexUv0> uv0s;
 		std::vector<VertexIndexType> indices;
 
+		// Meshlets of all submeshes, new chunk file only.
+		std::vector<StaticMeshMeshlet> meshlets;
+
 		template<class Archive> void serialize(Archive& archive)
 		{
 			archive(normals, tangents, uv0s, positions, indices);
 		}
+
+		// Chunk id in .staticmeshbin chunk file, order also is the stage buffer layout when upload.
+		enum class EChunk : uint32_t
+		{
+			Indices = 0,
+			Tangents,
+			Normals,
+			Uv0s,
+			Positions,
+			Meshlets,
+
+			Max,
+		};
+
+		bool save(const std::filesystem::path& savePath, const char* suffix) const;
 	};
 
 	class AssetStaticMesh : public AssetInterface
@@ -37,6 +56,10 @@ namespace engine
 
 
 		const auto& getSubMeshes() const { return m_subMeshes; }
+
+		// Empty if asset import before meshlet build, render as whole submesh.
+		const auto& getMeshletRanges() const { return m_meshletRanges; }
+		size_t getMeshletCount() const { return m_meshletCount; }
 		size_t getVerticesCount() const { return m_verticesCount; }
 		size_t getIndicesCount() const { return m_indicesCount; }
 
@@ -54,6 +77,8 @@ namespace engine
 		size_t m_indicesCount;
 		size_t m_verticesCount;
 
+		std::vector<StaticMeshMeshletRange> m_meshletRanges = {};
+		size_t m_meshletCount = 0;
 	};
 
 	struct AssetStaticMeshLoadFromCacheTask : public AssetStaticMeshLoadTask
@@ -71,5 +96,19 @@ ASSET_ARCHIVE_IMPL_INHERIT(AssetStaticMesh, AssetInterface)
 	ARCHIVE_NVP_DEFAULT(m_subMeshes);
 	ARCHIVE_NVP_DEFAULT(m_indicesCount);
 	ARCHIVE_NVP_DEFAULT(m_verticesCount);
+
+	if (version > 3)
+	{
+		ARCHIVE_NVP_DEFAULT(m_meshletRanges);
+		ARCHIVE_NVP_DEFAULT(m_meshletCount);
+	}
+
+	if (version > 4)
+	{
+		for (auto& subMesh : m_subMeshes)
+		{
+			archive(subMesh.lods);
+		}
+	}
 }
 ASSET_ARCHIVE_END
\ No newline at end of file
@@ -34,31 +34,224 @@ namespace engine
 
     void AssetSystem::setupProject(const std::filesystem::path& projectFilePath)
     {
+        CPU_PROFILER_SCOPE("AssetSystem::setupProject");
+
         clearCache();
 
         m_projectRootPath = projectFilePath.parent_path();
         m_assetRootPath = projectFilePath.parent_path() / "asset";
-        setupProjectRecursive(m_assetRootPath);
+
+        std::vector<std::filesystem::path> metaFiles;
+        collectMetaFiles(m_assetRootPath, metaFiles);
+
+        m_registry.load(m_projectRootPath);
+
+        // Revalidate registry entries by meta file state.
+        const size_t metaCount = metaFiles.size();
+        std::vector<AssetRegistryEntry> entries(metaCount);
+        std::vector<size_t> parallelMisses;
+        std::vector<size_t> serialMisses;
+        for (size_t i = 0; i < metaCount; i++)
+        {
+            auto& entry = entries[i];
+            entry.metaPathUtf8 = buildRelativePathUtf8(m_projectRootPath, metaFiles[i]);
+            AssetRegistry::getMetaFileState(metaFiles[i], entry.writeTime, entry.fileSize);
+
+            const auto* cached = m_registry.findByMetaPath(entry.metaPathUtf8);
+            if (cached && cached->writeTime == entry.writeTime && cached->fileSize == entry.fileSize)
+            {
+                entry = *cached;
+            }
+            else if (isAssetSceneMeta(metaFiles[i].extension().string()))
+            {
+                // Scene deserialize touch scene manager state, keep on main thread.
+                serialMisses.push_back(i);
+            }
+            else
+            {
+                parallelMisses.push_back(i);
+            }
+        }
+
+        // Load miss meta and rebuild its entry.
+        std::vector<std::shared_ptr<AssetInterface>> assets(metaCount);
+        std::vector<std::vector<char>> newSnapshots(metaCount);
+        std::vector<uint8_t> bLoadFailed(metaCount, 0);
+        auto loadMiss = [&](size_t i)
+        {
+            if (!loadAsset(assets[i], metaFiles[i]))
+            {
+                LOG_ERROR("Fail to load asset in path {}.", utf8::utf16to8(metaFiles[i].u16string()));
+                bLoadFailed[i] = 1;
+                return;
+            }
+
+            const auto& asset = assets[i];
+            auto& entry = entries[i];
+
+            entry.uuid = asset->getUUID();
+            entry.type = asset->getType();
+            entry.relativePathUtf8 = asset->getRelativePathUtf8();
+            entry.snapshotUUID = asset->getSnapshotUUID();
+            entry.snapshotWidth = asset->getSnapshotWidth();
+            entry.snapshotHeight = asset->getSnapshotHeight();
+
+            newSnapshots[i] = AssetRegistry::compressSnapshot(*asset);
+        };
+
+        ThreadPool::getDefault()->parallelFor(size_t(0), parallelMisses.size(), [&](const size_t start, const size_t end)
+        {
+            for (size_t i = start; i < end; i++)
+            {
+                loadMiss(parallelMisses[i]);
+            }
+        });
+
+        for (const size_t i : serialMisses)
+        {
+            loadMiss(i);
+        }
+
+        // Drop failed entries, keep assets align with entries.
+        std::vector<AssetRegistryEntry> validEntries;
+        std::vector<std::vector<char>> validSnapshots;
+        std::vector<std::shared_ptr<AssetInterface>> validAssets;
+        validEntries.reserve(metaCount);
+        validSnapshots.reserve(metaCount);
+        validAssets.reserve(metaCount);
+        for (size_t i = 0; i < metaCount; i++)
+        {
+            if (!bLoadFailed[i])
+            {
+                validEntries.push_back(std::move(entries[i]));
+                validSnapshots.push_back(std::move(newSnapshots[i]));
+                validAssets.push_back(std::move(assets[i]));
+            }
+        }
+
+        m_registry.resetEntries(std::move(validEntries), validSnapshots);
+        if (!m_registry.save())
+        {
+            LOG_WARN("Fail to save asset registry of project.");
+        }
+
+        const auto& registryEntries = m_registry.getEntries();
+        for (size_t i = 0; i < registryEntries.size(); i++)
+        {
+            registerAsset(registryEntries[i], validAssets[i]);
+        }
+
+        LOG_INFO("Setup project with {0} assets, {1} meta load and {2} lazy load from registry.",
+            registryEntries.size(), parallelMisses.size() + serialMisses.size(), registryEntries.size() - (parallelMisses.size() + serialMisses.size()));
+    }
+
+    void AssetSystem::registerAsset(const AssetRegistryEntry& entry, std::shared_ptr<AssetInterface> asset)
+    {
+        ASSERT(!m_assetMap.contains(entry.uuid), "Insert asset repeat!");
+        ASSERT(!m_relativeAssetPathUtf8Map.contains(entry.relativePathUtf8), "Insert asset repeat!");
+
+        if (!asset)
+        {
+            auto metaPath = m_projectRootPath;
+            metaPath += utf8::utf8to16(entry.metaPathUtf8);
+            m_lazyAssetPaths[entry.uuid] = metaPath;
+        }
+
+        m_assetMap[entry.uuid] = asset;
+        m_relativeAssetPathUtf8Map[entry.relativePathUtf8] = entry.uuid;
+        m_typeMap[entry.type].insert(entry.uuid);
     }
 
     std::shared_ptr<AssetInterface> AssetSystem::getAssetByRelativeMap(const std::string& path) const
     {
-        return m_assetMap.at(m_relativeAssetPathUtf8Map.at(path));
+        return getAsset(m_relativeAssetPathUtf8Map.at(path));
+    }
+
+    const std::string* AssetSystem::getAssetRelativePath(const UUID& uuid) const
+    {
+        const auto* entry = m_registry.findByUUID(uuid);
+        return entry ? &entry->relativePathUtf8 : nullptr;
     }
 
     std::shared_ptr<AssetInterface> AssetSystem::getAsset(const UUID& uuid) const
     {
-        return m_assetMap.at(uuid);
+        std::lock_guard lock(m_assetLoadMutex);
+
+        auto& asset = m_assetMap.at(uuid);
+        if (!asset)
+        {
+            // Only know from registry, load meta when first get.
+            const auto& path = m_lazyAssetPaths.at(uuid);
+            if (!loadAsset(asset, path))
+            {
+                LOG_ERROR("Fail to load asset in path {}.", utf8::utf16to8(path.u16string()));
+            }
+        }
+        return asset;
+    }
+
+    std::shared_ptr<GPUImageAsset> AssetSystem::getOrCreateSnapshot(const std::string& relativePath, uint32_t& outWidth, uint32_t& outHeight)
+    {
+        auto iter = m_relativeAssetPathUtf8Map.find(relativePath);
+        if (iter == m_relativeAssetPathUtf8Map.end())
+        {
+            return nullptr;
+        }
+        const UUID uuid = iter->second;
+
+        std::shared_ptr<AssetInterface> asset;
+        {
+            std::lock_guard lock(m_assetLoadMutex);
+            asset = m_assetMap.at(uuid);
+        }
+
+        // Loaded asset hold newest snapshot.
+        if (asset)
+        {
+            if (!asset->existSnapshot())
+            {
+                return nullptr;
+            }
+
+            outWidth = asset->getSnapshotWidth();
+            outHeight = asset->getSnapshotHeight();
+            return asset->getOrCreateLRUSnapShot(m_context);
+        }
+
+        const auto* entry = m_registry.findByUUID(uuid);
+        if (!entry || !entry->existSnapshot())
+        {
+            return nullptr;
+        }
+
+        outWidth = entry->snapshotWidth;
+        outHeight = entry->snapshotHeight;
+        if (!m_context->getLRU()->contain(entry->snapshotUUID))
+        {
+            std::vector<uint8_t> pixels;
+            if (!m_registry.loadSnapshot(*entry, pixels))
+            {
+                return nullptr;
+            }
+
+            m_context->getAsyncUploader().addTask(SnapshotAssetTextureLoadTask::build(
+                m_context, entry->relativePathUtf8, entry->snapshotUUID, entry->snapshotWidth, entry->snapshotHeight, std::move(pixels)));
+        }
+
+        return std::dynamic_pointer_cast<GPUImageAsset>(m_context->getLRU()->tryGet(entry->snapshotUUID));
     }
 
     void AssetSystem::clearCache()
     {
+        std::lock_guard lock(m_assetLoadMutex);
+
         m_assetMap.clear();
+        m_lazyAssetPaths.clear();
         m_relativeAssetPathUtf8Map.clear();
         m_typeMap.clear();
     }
 
-    void AssetSystem::setupProjectRecursive(const std::filesystem::path& path)
+    void AssetSystem::collectMetaFiles(const std::filesystem::path& path, std::vector<std::filesystem::path>& out) const
     {
         const bool bFolder = std::filesystem::is_directory(path);
 
@@ -66,26 +259,12 @@ namespace engine
         {
             for (const auto& entry : std::filesystem::directory_iterator(path))
             {
-                setupProjectRecursive(entry);
+                collectMetaFiles(entry, out);
             }
         }
-        else
+        else if (isEngineMetaAsset(path.extension().string()))
         {
-            const auto extension = path.extension().string();
-            if (isEngineMetaAsset(extension))
-            {
-                if (isAssetTextureMeta(extension))         { insertAsset<AssetTexture>(path); }
-                else if (isAssetStaticMeshMeta(extension)) { insertAsset<AssetStaticMesh>(path); }
-                else if (isAssetMaterialMeta(extension))   { insertAsset<AssetMaterial>(path); }
-                else if (isAssetPMXMeta(extension))        { insertAsset<AssetPMX>(path); }
-                else if (isAssetVMDMeta(extension))        { insertAsset<AssetVMD>(path); }
-                else if (isAssetSceneMeta(extension))      { insertAsset<Scene>(path);  }
-                else if (isAssetWaveMeta(extension))       { insertAsset<AssetWave>(path); }
-                else
-                {
-                    UN_IMPLEMENT();
-                }
-            }
+            out.push_back(path);
         }
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "asset_common.h"
+#include "asset_registry.h"
 
 namespace engine
 {
@@ -23,6 +24,14 @@ namespace engine
 
 		std::shared_ptr<AssetInterface> getAssetByRelativeMap(const std::string& path) const;
 		std::shared_ptr<AssetInterface> getAsset(const UUID& uuid) const;
+		bool isAssetExist(const std::string& relativePath) const { return m_relativeAssetPathUtf8Map.contains(relativePath); }
+
+		// Relative path from registry entry, no need load asset meta. Return nullptr if asset not exist.
+		const std::string* getAssetRelativePath(const UUID& uuid) const;
+
+		// Snapshot of asset, decode from registry cache when asset still no load. Return nullptr if no snapshot.
+		std::shared_ptr<GPUImageAsset> getOrCreateSnapshot(const std::string& relativePath, uint32_t& outWidth, uint32_t& outHeight);
+
 		const auto& getProjectAssetRootPath() const { return m_assetRootPath; }
 		const auto& getProjectRootPath() const { return m_projectRootPath; }
 		const auto& getAssetTypeMap() const { return m_typeMap; }
@@ -34,36 +43,11 @@ namespace engine
 	private:
 		void clearCache();
 
-		void setupProjectRecursive(const std::filesystem::path& path);
-
-		template<typename T>
-		bool insertAsset(const std::filesystem::path& path)
-		{
-			static_assert(std::is_base_of_v<AssetInterface, T>, "T must derived from AssetInterface.");
-
-			std::shared_ptr<AssetInterface> asset;
-
-			if (loadAsset(asset, path))
-			{
-				const UUID uuid = asset->getUUID();
-				const auto relativePath = asset->getRelativePathUtf8();
-
-				ASSERT(m_assetMap[uuid] == nullptr, "Insert asset repeat!");
-				ASSERT(m_relativeAssetPathUtf8Map[relativePath].empty(), "Insert asset repeat!");
-
-				m_assetMap[uuid] = asset;
-				m_relativeAssetPathUtf8Map[relativePath] = uuid;
+		// Collect all engine meta files under path.
+		void collectMetaFiles(const std::filesystem::path& path, std::vector<std::filesystem::path>& out) const;
 
-				m_typeMap[asset->getType()].insert(uuid);
-
-				return true;
-			}
-			else
-			{
-				LOG_ERROR("Fail to load asset in path {}.", utf8::utf16to8(path.u16string()));
-				return false;
-			}
-		};
+		// Asset can be null when only know from registry, it will load when first get.
+		void registerAsset(const AssetRegistryEntry& entry, std::shared_ptr<AssetInterface> asset);
 
 	public:
 		template<typename T>
@@ -76,6 +60,8 @@ namespace engine
 			if (loadAsset(asset, path))
 			{
 				const UUID uuid = asset->getUUID();
+
+				std::lock_guard lock(m_assetLoadMutex);
 				m_assetMap[uuid] = asset;
 				return true;
 			}
@@ -94,8 +80,13 @@ namespace engine
 		std::filesystem::path m_assetRootPath;
 		std::filesystem::path m_projectRootPath;
 
-		// Cache asset map.
-		std::unordered_map<UUID, std::shared_ptr<AssetInterface>> m_assetMap;
+		// Persistent asset index of project.
+		AssetRegistry m_registry;
+
+		// Cache asset map, value is null when asset only know from registry, fill when first get.
+		mutable std::mutex m_assetLoadMutex;
+		mutable std::unordered_map<UUID, std::shared_ptr<AssetInterface>> m_assetMap;
+		std::unordered_map<UUID, std::filesystem::path> m_lazyAssetPaths;
 		std::unordered_map<std::string, UUID> m_relativeAssetPathUtf8Map;
 
 		std::unordered_map<EAssetType, std::unordered_set<UUID>, EnumClassHash> m_typeMap;
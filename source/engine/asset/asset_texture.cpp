@@ -1,8 +1,14 @@
 ﻿#include "asset_texture.h"
 #include "asset_system.h"
 
-#include <execution>
-#include <stb/stb_dxt.h>
+#include <util/texture_compress.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+	#define TEXTURE_MIPMAP_SSE 1
+	#include <immintrin.h>
+#else
+	#define TEXTURE_MIPMAP_SSE 0
+#endif
 
 #define TINYEXR_IMPLEMENTATION
 #include <tinyexr/tinyexr.h>
@@ -15,50 +21,92 @@ namespace engine
 
 	}
 
-	float getAlphaCoverageRGBA8(const unsigned char* data, uint32_t width, uint32_t height, float scale, int cutoff)
+	// Alpha histogram of one mip level, coverage search only loop 256 bins instead of all pixels.
+	struct AlphaHistogram
 	{
-		// float value may no enough for multi add.
-		double value = 0.0;
+		std::array<uint64_t, 256> bins { };
+		uint64_t pixelCount = 0;
+	};
 
-		// 4 char to 1 uint32_t
-		uint32_t* pImg = (uint32_t*)data;
+	static AlphaHistogram buildAlphaHistogramRGBA8(const uint8_t* data, size_t pixelCount)
+	{
+		AlphaHistogram result { };
+		result.pixelCount = pixelCount;
 
-		// Loop all texture to get coverage alpha data.
-		for (uint32_t y = 0; y < height; y++)
+		std::mutex mergeMutex;
+		ThreadPool::getDefault()->parallelFor(size_t(0), pixelCount, [&](size_t start, size_t end)
 		{
-			for (uint32_t x = 0; x < width; x++)
+			std::array<uint64_t, 256> localBins { };
+			for (size_t i = start; i < end; i++)
 			{
-				// pImg++ to next pixel 4 char = 1 uint32_t
-				uint8_t* pPixel = (uint8_t*)pImg++;
+				localBins[data[i * 4 + 3]]++;
+			}
 
-				// alpha in pixel[3]
-				int alpha = (int)(scale * (float)pPixel[3]);
+			std::lock_guard lock(mergeMutex);
+			for (size_t i = 0; i < localBins.size(); i++)
+			{
+				result.bins[i] += localBins[i];
+			}
+		}, 64 * 1024);
 
-				if (alpha > 255) { alpha = 255; }
-				if (alpha <= cutoff) { continue; }
+		return result;
+	}
 
-				value += alpha;
+	// Same coverage define as before: sum of scaled alpha which bigger than cutoff.
+	static float getAlphaCoverage(const AlphaHistogram& histogram, float scale, int cutoff)
+	{
+		// float value may no enough for multi add.
+		double value = 0.0;
+		for (int i = 0; i < 256; i++)
+		{
+			if (histogram.bins[i] == 0)
+			{
+				continue;
 			}
+
+			int alpha = (int)(scale * (float)i);
+			if (alpha > 255) { alpha = 255; }
+			if (alpha <= cutoff) { continue; }
+
+			value += double(alpha) * double(histogram.bins[i]);
 		}
-		return (float)(value / (height * width * 255));
+		return (float)(value / (double(histogram.pixelCount) * 255.0));
 	}
 
-	void scaleAlpha(unsigned char* data, uint32_t width, uint32_t height, float scale)
+	// Binary search alpha scale which keep mip coverage same with mip 0.
+	static float findAlphaCoverageScale(const AlphaHistogram& histogram, float targetCoverage, int cutoff)
 	{
-		uint32_t* pImg = (uint32_t*)data;
+		float ini = 0;
+		float fin = 10;
 
-		for (uint32_t y = 0; y < height; y++)
+		float mid = 1.0f;
+		for (int iter = 0; iter < 50; iter++)
 		{
-			for (uint32_t x = 0; x < width; x++)
-			{
-				uint8_t* pPixel = (uint8_t*)pImg++;
+			mid = (ini + fin) / 2;
+			const float alphaPercentage = getAlphaCoverage(histogram, mid, cutoff);
 
-				int alpha = (int)(scale * (float)pPixel[3]);
-				if (alpha > 255) { alpha = 255; }
+			if (glm::abs(alphaPercentage - targetCoverage) < .001) { break; }
+			if (alphaPercentage > targetCoverage) { fin = mid; }
+			if (alphaPercentage < targetCoverage) { ini = mid; }
+		}
+		return mid;
+	}
 
-				pPixel[3] = alpha;
-			}
+	static void scaleAlphaRGBA8(uint8_t* data, size_t pixelCount, float scale)
+	{
+		std::array<uint8_t, 256> scaleLut;
+		for (int i = 0; i < 256; i++)
+		{
+			scaleLut[i] = uint8_t(std::min((int)(scale * (float)i), 255));
 		}
+
+		ThreadPool::getDefault()->parallelFor(size_t(0), pixelCount, [&](size_t start, size_t end)
+		{
+			for (size_t i = start; i < end; i++)
+			{
+				data[i * 4 + 3] = scaleLut[data[i * 4 + 3]];
+			}
+		}, 64 * 1024);
 	}
 
 	template<typename T> inline float getQuantifySize() { CHECK(false); return 0.0f; }
@@ -66,8 +114,194 @@ namespace engine
 	template<> inline float getQuantifySize<uint16_t>() { return float(1 << 16) - 1.0f; }
 	template<> inline float getQuantifySize<float>() { return 1.0f; }
 
+	template<typename T> inline T quantifyValue(float v) { return T(math::clamp(v, 0.0f, 1.0f) * getQuantifySize<T>() + 0.5f); }
+	template<> inline float quantifyValue<float>(float v) { return math::max(v, 0.0f); }
+
+	// Float4 helpers for mip filters, each pixel is one rgba float4.
+#if TEXTURE_MIPMAP_SSE
+	using MipFloat4 = __m128;
+	static inline MipFloat4 mipLoad(const float* p) { return _mm_loadu_ps(p); }
+	static inline void mipStore(float* p, MipFloat4 v) { _mm_storeu_ps(p, v); }
+	static inline MipFloat4 mipZero() { return _mm_setzero_ps(); }
+	static inline MipFloat4 mipAdd(MipFloat4 a, MipFloat4 b) { return _mm_add_ps(a, b); }
+	static inline MipFloat4 mipMul(MipFloat4 a, float s) { return _mm_mul_ps(a, _mm_set1_ps(s)); }
+	static inline MipFloat4 mipMulAdd(MipFloat4 acc, MipFloat4 a, float s) { return _mm_add_ps(acc, _mm_mul_ps(a, _mm_set1_ps(s))); }
+#else
+	struct MipFloat4 { float v[4]; };
+	static inline MipFloat4 mipLoad(const float* p) { return { p[0], p[1], p[2], p[3] }; }
+	static inline void mipStore(float* p, MipFloat4 v) { memcpy(p, v.v, sizeof(v.v)); }
+	static inline MipFloat4 mipZero() { return { 0.0f, 0.0f, 0.0f, 0.0f }; }
+	static inline MipFloat4 mipAdd(MipFloat4 a, MipFloat4 b) { return { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] }; }
+	static inline MipFloat4 mipMul(MipFloat4 a, float s) { return { a.v[0] * s, a.v[1] * s, a.v[2] * s, a.v[3] * s }; }
+	static inline MipFloat4 mipMulAdd(MipFloat4 acc, MipFloat4 a, float s) { return mipAdd(acc, mipMul(a, s)); }
+#endif
+
+	// Linear space rgba float working image, next mip level always downsample from it.
+	struct MipmapLinearImage
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<float> pixels;
+
+		float* row(uint32_t y) { return pixels.data() + size_t(y) * width * 4; }
+		const float* row(uint32_t y) const { return pixels.data() + size_t(y) * width * 4; }
+	};
+
+	// Row source of linear image, decode nothing.
+	struct MipmapLinearImageSource
+	{
+		const MipmapLinearImage& image;
+
+		uint32_t width() const { return image.width; }
+		uint32_t height() const { return image.height; }
+		const float* loadRow(uint32_t y, float* /*scratch*/) const { return image.row(y); }
+	};
+
+	// Kaiser windowed sinc with 8 taps for 2x downsample, width 2 and alpha 4 in dest pixel unit.
+	static const std::array<float, 8>& getKaiserWeights()
+	{
+		static const std::array<float, 8> weights = []()
+		{
+			constexpr float kPi = 3.14159265358979f;
+			constexpr float kWidth = 2.0f;
+			constexpr float kAlpha = 4.0f;
+
+			auto bessel0 = [](float x)
+			{
+				float sum = 1.0f;
+				float term = 1.0f;
+				for (int k = 1; k < 16; k++)
+				{
+					const float t = x / (2.0f * float(k));
+					term *= t * t;
+					sum += term;
+				}
+				return sum;
+			};
+
+			std::array<float, 8> result;
+			float sum = 0.0f;
+			for (int k = 0; k < 8; k++)
+			{
+				// Tap center distance to dest pixel center.
+				const float d = std::abs((float(k) - 3.5f) * 0.5f);
+				const float sinc = std::sin(kPi * d) / (kPi * d);
+				const float window = bessel0(kAlpha * std::sqrt(1.0f - (d / kWidth) * (d / kWidth))) / bessel0(kAlpha);
+
+				result[k] = sinc * window;
+				sum += result[k];
+			}
+
+			for (auto& w : result)
+			{
+				w /= sum;
+			}
+			return result;
+		}();
+
+		return weights;
+	}
+
+	// Dest rows per task, src rows of one band keep in cache when filter.
+	constexpr uint32_t kMipmapBandRows = 16;
+
+	// Downsample one level into dest, emitRows(begin, end) call inside band task after band rows finish,
+	// so quantify work while rows still in cache.
+	template<typename Source, typename EmitRows>
+	static void downsampleMipmap(const Source& source, AssetTexture::ImportConfig::EMipmapFilter filter, MipmapLinearImage& dest, const EmitRows& emitRows)
+	{
+		const uint32_t srcWidth  = source.width();
+		const uint32_t srcHeight = source.height();
+
+		dest.width  = math::max<uint32_t>(srcWidth  >> 1, 1);
+		dest.height = math::max<uint32_t>(srcHeight >> 1, 1);
+		dest.pixels.resize(size_t(dest.width) * dest.height * 4);
+
+		const uint32_t bandCount = divideRoundingUp(dest.height, kMipmapBandRows);
+		const bool bKaiser = (filter == AssetTexture::ImportConfig::EMipmapFilter::Kaiser);
+
+		ThreadPool::getDefault()->parallelFor(0U, bandCount, [&](uint32_t bandStart, uint32_t bandEnd)
+		{
+			std::vector<float> scratch(size_t(srcWidth) * 4);
+			std::vector<float> scratch1(size_t(srcWidth) * 4);
+
+			for (uint32_t band = bandStart; band < bandEnd; band++)
+			{
+				const uint32_t yBegin = band * kMipmapBandRows;
+				const uint32_t yEnd = math::min(yBegin + kMipmapBandRows, dest.height);
+
+				if (!bKaiser)
+				{
+					// 2x2 box.
+					for (uint32_t y = yBegin; y < yEnd; y++)
+					{
+						const float* row0 = source.loadRow(math::min(y * 2 + 0, srcHeight - 1), scratch.data());
+						const float* row1 = source.loadRow(math::min(y * 2 + 1, srcHeight - 1), scratch1.data());
+
+						float* destRow = dest.row(y);
+						for (uint32_t x = 0; x < dest.width; x++)
+						{
+							const size_t x0 = size_t(math::min(x * 2 + 0, srcWidth - 1)) * 4;
+							const size_t x1 = size_t(math::min(x * 2 + 1, srcWidth - 1)) * 4;
+
+							MipFloat4 sum = mipAdd(mipLoad(row0 + x0), mipLoad(row0 + x1));
+							sum = mipAdd(sum, mipAdd(mipLoad(row1 + x0), mipLoad(row1 + x1)));
+							mipStore(destRow + size_t(x) * 4, mipMul(sum, 0.25f));
+						}
+					}
+				}
+				else
+				{
+					// Separable kaiser, horizontal filter all src rows of band first, then vertical.
+					const auto& weights = getKaiserWeights();
+
+					const int32_t srcRowBegin = int32_t(yBegin * 2) - 3;
+					const int32_t srcRowEnd = int32_t((yEnd - 1) * 2) + 5;
+
+					std::vector<float> horizontalRows(size_t(srcRowEnd - srcRowBegin) * dest.width * 4);
+					for (int32_t srcY = srcRowBegin; srcY < srcRowEnd; srcY++)
+					{
+						const uint32_t clampY = uint32_t(math::clamp(srcY, 0, int32_t(srcHeight) - 1));
+						const float* srcRow = source.loadRow(clampY, scratch.data());
+
+						float* hRow = horizontalRows.data() + size_t(srcY - srcRowBegin) * dest.width * 4;
+						for (uint32_t x = 0; x < dest.width; x++)
+						{
+							MipFloat4 sum = mipZero();
+							for (int32_t k = 0; k < 8; k++)
+							{
+								const int32_t srcX = math::clamp(int32_t(x * 2) - 3 + k, 0, int32_t(srcWidth) - 1);
+								sum = mipMulAdd(sum, mipLoad(srcRow + size_t(srcX) * 4), weights[k]);
+							}
+							mipStore(hRow + size_t(x) * 4, sum);
+						}
+					}
+
+					for (uint32_t y = yBegin; y < yEnd; y++)
+					{
+						const int32_t firstRow = int32_t(y * 2) - 3 - srcRowBegin;
+
+						float* destRow = dest.row(y);
+						for (uint32_t x = 0; x < dest.width; x++)
+						{
+							MipFloat4 sum = mipZero();
+							for (int32_t k = 0; k < 8; k++)
+							{
+								const float* hRow = horizontalRows.data() + size_t(firstRow + k) * dest.width * 4;
+								sum = mipMulAdd(sum, mipLoad(hRow + size_t(x) * 4), weights[k]);
+							}
+							mipStore(destRow + size_t(x) * 4, sum);
+						}
+					}
+				}
+
+				emitRows(yBegin, yEnd);
+			}
+		}, 1);
+	}
+
 	template<typename T>
-	void buildMipmapData(T* srcPixels, const AssetTexture& meta, AssetTextureBin& outBinData, uint32_t channelCount, uint32_t channelOffset)
+	void buildMipmapData(T* srcPixels, const AssetTexture& meta, AssetTextureBin& outBinData, uint32_t channelCount, uint32_t channelOffset, AssetTexture::ImportConfig::EMipmapFilter filter)
 	{
 		const float kQuantitySize = getQuantifySize<T>();
 
@@ -76,185 +310,227 @@ namespace engine
 
 		outBinData.mipmapDatas.resize(meta.getMipmapCount());
 		const auto kStripSize = sizeof(T) * channelCount;
-		for (size_t mip = 0; mip < outBinData.mipmapDatas.size(); mip++)
+
+		// Mip 0 just pick channels.
 		{
-			auto& destMipData = outBinData.mipmapDatas[mip];
-			uint32_t destWidth = math::max<uint32_t>(meta.getWidth() >> mip, 1);
-			uint32_t destHeight = math::max<uint32_t>(meta.getHeight() >> mip, 1);
-			destMipData.resize(destWidth * destHeight * kStripSize);
+			auto& destMipData = outBinData.mipmapDatas[0];
+			const size_t pixelCount = size_t(meta.getWidth()) * meta.getHeight();
+			destMipData.resize(pixelCount * kStripSize);
 
 			T* pDestData = (T*)destMipData.data();
-
-			if (mip == 0)
+			ThreadPool::getDefault()->parallelFor(size_t(0), pixelCount, [&](size_t start, size_t end)
 			{
-				for (size_t i = 0; i < destWidth * destHeight; i++)
+				for (size_t i = start; i < end; i++)
 				{
 					for (size_t j = 0; j < channelCount; j++)
 					{
 						pDestData[i * channelCount + j] = srcPixels[i * 4 + j + channelOffset];
 					}
 				}
-			}
-			else
+			}, 64 * 1024);
+		}
+
+		// Mip 1 decode from source pixels directly, avoid full size float copy of mip 0.
+		struct SourcePixels
+		{
+			const T* pixels;
+			uint32_t srcWidth;
+			uint32_t srcHeight;
+			uint32_t channelCount;
+			uint32_t channelOffset;
+			float invQuantitySize;
+
+			uint32_t width() const { return srcWidth; }
+			uint32_t height() const { return srcHeight; }
+			const float* loadRow(uint32_t y, float* scratch) const
 			{
-				const size_t srcMip = mip - 1;
-				const auto& srcMipData = outBinData.mipmapDatas[srcMip];
-				for (size_t y = 0; y < destHeight; y++)
+				const T* srcRow = pixels + size_t(y) * srcWidth * 4;
+				for (uint32_t x = 0; x < srcWidth; x++)
 				{
-					for (size_t x = 0; x < destWidth; x++)
+					for (uint32_t c = 0; c < 4; c++)
 					{
-						// Get src data.
-						uint32_t srcWidth = std::max<uint32_t>(meta.getWidth() >> srcMip, 1);
-						uint32_t srcHeight = std::max<uint32_t>(meta.getHeight() >> srcMip, 1);
-
-						// Clamp src data fetech edge.
-						size_t srcX0 = (size_t)std::min<uint32_t>(uint32_t(x * 2 + 0), srcWidth - 1);
-						size_t srcX1 = (size_t)std::min<uint32_t>(uint32_t(x * 2 + 1), srcWidth - 1);
-						size_t srcY0 = (size_t)std::min<uint32_t>(uint32_t(y * 2 + 0), srcHeight - 1);
-						size_t srcY1 = (size_t)std::min<uint32_t>(uint32_t(y * 2 + 1), srcHeight - 1);
-						size_t srcPixelStart[] =
-						{
-							(srcY0 * srcWidth + srcX0) * channelCount, // X0Y0
-							(srcY0 * srcWidth + srcX1) * channelCount, // X1Y0
-							(srcY1 * srcWidth + srcX0) * channelCount, // X0Y1
-							(srcY1 * srcWidth + srcX1) * channelCount, // X1Y1
-						};
+						scratch[x * 4 + c] = c < channelCount ? float(srcRow[x * 4 + c + channelOffset]) * invQuantitySize : 0.0f;
+					}
+				}
+				return scratch;
+			}
+		};
 
-						const T* pSrcData = (const T*)srcMipData.data();
-						size_t destPixelPosStart = (y * destWidth + x) * channelCount;
+		MipmapLinearImage prevLevel;
+		MipmapLinearImage currentLevel;
+		for (size_t mip = 1; mip < outBinData.mipmapDatas.size(); mip++)
+		{
+			auto& destMipData = outBinData.mipmapDatas[mip];
+			const uint32_t destWidth = math::max<uint32_t>(meta.getWidth() >> mip, 1);
+			const uint32_t destHeight = math::max<uint32_t>(meta.getHeight() >> mip, 1);
+			destMipData.resize(size_t(destWidth) * destHeight * kStripSize);
 
-						for (size_t channelId = 0; channelId < channelCount; channelId++)
+			T* pDestData = (T*)destMipData.data();
+			auto emitRows = [&](uint32_t yBegin, uint32_t yEnd)
+			{
+				for (uint32_t y = yBegin; y < yEnd; y++)
+				{
+					const float* row = currentLevel.row(y);
+					for (uint32_t x = 0; x < destWidth; x++)
+					{
+						for (uint32_t c = 0; c < channelCount; c++)
 						{
-							float sumValue = 0.0f;
-							for (size_t srcPixelId = 0; srcPixelId < 4; srcPixelId++)
-							{
-								const T& valueLoad = pSrcData[srcPixelStart[srcPixelId] + channelId];
-								const float v = float(valueLoad) / kQuantitySize;
-
-								sumValue += v;
-							}
-							sumValue *= 0.25f;
-
-							pDestData[destPixelPosStart + channelId] = T(sumValue * kQuantitySize);
+							pDestData[(size_t(y) * destWidth + x) * channelCount + c] = quantifyValue<T>(row[x * 4 + c]);
 						}
 					}
 				}
+			};
+
+			if (mip == 1)
+			{
+				SourcePixels source { srcPixels, meta.getWidth(), meta.getHeight(), channelCount, channelOffset, 1.0f / kQuantitySize };
+				downsampleMipmap(source, filter, currentLevel, emitRows);
 			}
+			else
+			{
+				downsampleMipmap(MipmapLinearImageSource{ prevLevel }, filter, currentLevel, emitRows);
+			}
+			std::swap(prevLevel, currentLevel);
+
 			CHECK(destHeight * destWidth * kStripSize == destMipData.size());
 		}
 	}
 
+	// sRGB decode table and encode table, all mipmap filter done in linear space.
+	// https://paroj.github.io/gltut/Texturing/Tut16%20Mipmaps%20and%20Linearity.html
+	struct SRGBTables
+	{
+		static constexpr uint32_t kEncodeSize = 1 << 14;
+
+		std::array<float, 256> decode;
+		std::vector<uint8_t> encode;
+
+		SRGBTables()
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const float srgb = float(i) / 255.0f;
+				decode[i] = srgb > 0.04045f ? std::pow((srgb + 0.055f) / 1.055f, 2.4f) : srgb / 12.92f;
+			}
+
+			encode.resize(kEncodeSize);
+			for (uint32_t i = 0; i < kEncodeSize; i++)
+			{
+				const float lin = float(i) / float(kEncodeSize - 1);
+				const float srgb = lin > 0.0031308f ? 1.055f * std::pow(lin, 1.0f / 2.4f) - 0.055f : lin * 12.92f;
+				encode[i] = uint8_t(math::clamp(srgb, 0.0f, 1.0f) * 255.0f + 0.5f);
+			}
+		}
+
+		uint8_t toSrgb(float lin) const
+		{
+			return encode[uint32_t(math::clamp(lin, 0.0f, 1.0f) * float(kEncodeSize - 1) + 0.5f)];
+		}
+
+		static const SRGBTables& get()
+		{
+			static const SRGBTables tables;
+			return tables;
+		}
+	};
+
 	void buildMipmapDataRGBA8(
-		stbi_uc* srcPixels, 
+		stbi_uc* srcPixels,
 		AssetTextureBin& outBinData,
 		float alphaCutOff,
-		uint32_t mipmapCount, 
+		uint32_t mipmapCount,
 		bool bSRGB,
 		uint32_t inWidth,
-		uint32_t inHeight)
+		uint32_t inHeight,
+		AssetTexture::ImportConfig::EMipmapFilter filter)
 	{
 		const float cutOff = alphaCutOff;
+		const int cutOffAlpha = (int)(cutOff * 255);
 		float alphaCoverageMip0 = 1.0f;
 		outBinData.mipmapDatas.resize(mipmapCount);
 
-		// Look no good when convert to linear space do mipmap.
-		const bool bSrgb = bSRGB;
+		const auto& srgbTables = SRGBTables::get();
 
-		for (size_t mip = 0; mip < outBinData.mipmapDatas.size(); mip++)
+		// Copy raw data to mip 0.
 		{
-			auto& destMipData = outBinData.mipmapDatas[mip];
-			uint32_t destWidth  = math::max<uint32_t>(inWidth >> mip, 1);
-			uint32_t destHeight = math::max<uint32_t>(inHeight >> mip, 1);
+			auto& destMipData = outBinData.mipmapDatas[0];
+			destMipData.resize(size_t(inWidth) * inHeight * 4);
+			memcpy(destMipData.data(), srcPixels, destMipData.size());
 
-			if (mip == 0)
-			{
-				// Copy raw data to mip 0.
-				destMipData.resize(inWidth * inHeight * 4);
-				memcpy(destMipData.data(), srcPixels, destMipData.size());
+			alphaCoverageMip0 = cutOff < 0.9999f
+				? getAlphaCoverage(buildAlphaHistogramRGBA8(destMipData.data(), size_t(inWidth) * inHeight), 1.0f, cutOffAlpha)
+				: 1.0f;
+		}
 
-				alphaCoverageMip0 = cutOff < 0.9999f
-					? getAlphaCoverageRGBA8(destMipData.data(), destWidth, destHeight, 1.0f, (int)(cutOff * 255))
-					: 1.0f;
-			}
-			else // Other mip process.
+		// Mip 1 decode from mip 0 bytes directly.
+		struct SourcePixels
+		{
+			const uint8_t* pixels;
+			uint32_t srcWidth;
+			uint32_t srcHeight;
+			bool bSrgb;
+			const SRGBTables& tables;
+
+			uint32_t width() const { return srcWidth; }
+			uint32_t height() const { return srcHeight; }
+			const float* loadRow(uint32_t y, float* scratch) const
 			{
-				const size_t srcMip = mip - 1;
-				const auto& srcMipData = outBinData.mipmapDatas[srcMip];
+				const uint8_t* srcRow = pixels + size_t(y) * srcWidth * 4;
+				for (uint32_t x = 0; x < srcWidth * 4; x += 4)
+				{
+					scratch[x + 0] = bSrgb ? tables.decode[srcRow[x + 0]] : float(srcRow[x + 0]) / 255.0f;
+					scratch[x + 1] = bSrgb ? tables.decode[srcRow[x + 1]] : float(srcRow[x + 1]) / 255.0f;
+					scratch[x + 2] = bSrgb ? tables.decode[srcRow[x + 2]] : float(srcRow[x + 2]) / 255.0f;
+					scratch[x + 3] = float(srcRow[x + 3]) / 255.0f;
+				}
+				return scratch;
+			}
+		};
+
+		MipmapLinearImage prevLevel;
+		MipmapLinearImage currentLevel;
+		for (size_t mip = 1; mip < outBinData.mipmapDatas.size(); mip++)
+		{
+			auto& destMipData = outBinData.mipmapDatas[mip];
+			const uint32_t destWidth  = math::max<uint32_t>(inWidth >> mip, 1);
+			const uint32_t destHeight = math::max<uint32_t>(inHeight >> mip, 1);
+			destMipData.resize(size_t(destWidth) * destHeight * 4);
 
-				destMipData.resize(destWidth * destHeight * 4);
-				for (size_t y = 0; y < destHeight; y++)
+			auto emitRows = [&](uint32_t yBegin, uint32_t yEnd)
+			{
+				for (uint32_t y = yBegin; y < yEnd; y++)
 				{
-					for (size_t x = 0; x < destWidth; x++)
+					const float* row = currentLevel.row(y);
+					uint8_t* destRow = destMipData.data() + size_t(y) * destWidth * 4;
+					for (uint32_t x = 0; x < destWidth * 4; x += 4)
 					{
-						// Get src data.
-						uint32_t srcWidth  = std::max<uint32_t>(inWidth >> srcMip,  1);
-						uint32_t srcHeight = std::max<uint32_t>(inHeight >> srcMip, 1);
-
-						// Clamp src data fetech edge.
-						size_t srcX0 = (size_t)std::min<uint32_t>(uint32_t(x * 2 + 0), srcWidth  - 1);
-						size_t srcX1 = (size_t)std::min<uint32_t>(uint32_t(x * 2 + 1), srcWidth  - 1);
-						size_t srcY0 = (size_t)std::min<uint32_t>(uint32_t(y * 2 + 0), srcHeight - 1);
-						size_t srcY1 = (size_t)std::min<uint32_t>(uint32_t(y * 2 + 1), srcHeight - 1);
-
-						// Prepare src pixel start pos. * 4 is because per pixel has RGBA four components.
-						size_t srcPixelStart[] =
-						{
-							(srcY0 * srcWidth + srcX0) * 4, // X0Y0
-							(srcY0 * srcWidth + srcX1) * 4, // X1Y0
-							(srcY1 * srcWidth + srcX0) * 4, // X0Y1
-							(srcY1 * srcWidth + srcX1) * 4, // X1Y1
-						};
-
-						// Perpixel own 4 uint8_t pack to one uint32_t value.
-						const uint32_t* pSrcData = (const uint32_t*)srcMipData.data();
-
-						// All color operation must done in linear space.
-						// https://paroj.github.io/gltut/Texturing/Tut16%20Mipmaps%20and%20Linearity.html
-						uint32_t R = 0, G = 0, B = 0, A = 0;
-						for (size_t i = 0; i < 4; i++)
-						{
-							R += bSrgb ? srgbToLinear(srcMipData[srcPixelStart[i] + 0]) : srcMipData[srcPixelStart[i] + 0];
-							G += bSrgb ? srgbToLinear(srcMipData[srcPixelStart[i] + 1]) : srcMipData[srcPixelStart[i] + 1];
-							B += bSrgb ? srgbToLinear(srcMipData[srcPixelStart[i] + 2]) : srcMipData[srcPixelStart[i] + 2];
-
-							A += srcMipData[srcPixelStart[i] + 3];
-						}
-						R /= 4; R = bSrgb ? linearToSrgb(R) : R;
-						G /= 4; G = bSrgb ? linearToSrgb(G) : G;
-						B /= 4; B = bSrgb ? linearToSrgb(B) : B;
-						A /= 4;
-
-						// Store to dest.
-						size_t destPixelPosStart = (y * destWidth + x) * 4;
-						destMipData[destPixelPosStart + 0] = R;
-						destMipData[destPixelPosStart + 1] = G;
-						destMipData[destPixelPosStart + 2] = B;
-						destMipData[destPixelPosStart + 3] = A;
+						destRow[x + 0] = bSRGB ? srgbTables.toSrgb(row[x + 0]) : quantifyValue<uint8_t>(row[x + 0]);
+						destRow[x + 1] = bSRGB ? srgbTables.toSrgb(row[x + 1]) : quantifyValue<uint8_t>(row[x + 1]);
+						destRow[x + 2] = bSRGB ? srgbTables.toSrgb(row[x + 2]) : quantifyValue<uint8_t>(row[x + 2]);
+						destRow[x + 3] = quantifyValue<uint8_t>(row[x + 3]);
 					}
 				}
+			};
 
-				if (alphaCoverageMip0 < 1.0f)
-				{
-					float ini = 0;
-					float fin = 10;
-
-					float mid;
-					float alphaPercentage;
-
-					// find best alpha coverage for mip-map.
-					int iter = 0;
-					for (; iter < 50; iter++)
-					{
-						mid = (ini + fin) / 2;
-						alphaPercentage = getAlphaCoverageRGBA8(destMipData.data(), destWidth, destHeight, mid, (int)(cutOff * 255));
+			if (mip == 1)
+			{
+				SourcePixels source { outBinData.mipmapDatas[0].data(), inWidth, inHeight, bSRGB, srgbTables };
+				downsampleMipmap(source, filter, currentLevel, emitRows);
+			}
+			else
+			{
+				downsampleMipmap(MipmapLinearImageSource{ prevLevel }, filter, currentLevel, emitRows);
+			}
+			std::swap(prevLevel, currentLevel);
 
-						if (glm::abs(alphaPercentage - alphaCoverageMip0) < .001) { break; }
-						if (alphaPercentage > alphaCoverageMip0) { fin = mid; }
-						if (alphaPercentage < alphaCoverageMip0) { ini = mid; }
-					}
+			// Only output mip scale alpha, float chain keep unscaled so next mip no accumulate error.
+			if (alphaCoverageMip0 < 1.0f)
+			{
+				const size_t pixelCount = size_t(destWidth) * destHeight;
+				const auto histogram = buildAlphaHistogramRGBA8(destMipData.data(), pixelCount);
+				const float scale = findAlphaCoverageScale(histogram, alphaCoverageMip0, cutOffAlpha);
 
-					scaleAlpha(destMipData.data(), destWidth, destHeight, mid);
-				}
+				scaleAlphaRGBA8(destMipData.data(), pixelCount, scale);
 			}
 
 			CHECK(destWidth * destHeight * 4 == destMipData.size());
@@ -265,6 +541,7 @@ namespace engine
 	{
 		     if (config.channel == AssetTexture::ImportConfig::EChannel::RGBA) { channelCount = 4; pixelSampleOffset = 0; }
 		else if (config.channel == AssetTexture::ImportConfig::EChannel::RGB)  { channelCount = 3; pixelSampleOffset = 0; }
+		else if (config.channel == AssetTexture::ImportConfig::EChannel::RG)   { channelCount = 2; pixelSampleOffset = 0; }
 		else if (config.channel == AssetTexture::ImportConfig::EChannel::R)    { channelCount = 1; pixelSampleOffset = 0; }
 		else if (config.channel == AssetTexture::ImportConfig::EChannel::G)    { channelCount = 1; pixelSampleOffset = 1; }
 		else if (config.channel == AssetTexture::ImportConfig::EChannel::B)    { channelCount = 1; pixelSampleOffset = 2; }
@@ -272,110 +549,144 @@ namespace engine
 		else { CHECK_ENTRY(); }
 	}
 
-	static inline void mipmapCompressBC3(AssetTextureBin& inOutBin, const AssetTexture& meta)
+	// Single channel texture always sample in .r, same as hdr and half fixed path which only store selected channel.
+	// LDR keep four channel layout, so move selected channel to r after mipmap build (alpha cutoff still use source alpha).
+	static inline void mipmapSwizzleChannelToR(AssetTextureBin& inOutBin, uint32_t channelOffset)
+	{
+		if (channelOffset == 0)
+		{
+			return;
+		}
+
+		for (auto& mipData : inOutBin.mipmapDatas)
+		{
+			for (size_t i = 0; i < mipData.size(); i += 4)
+			{
+				mipData[i] = mipData[i + channelOffset];
+			}
+		}
+	}
+
+	enum class ETextureBlockCompression
 	{
+		BC1, // RGB.
+		BC4, // Single channel, store in r.
+		BC5, // RG.
+		BC7, // RGBA.
+	};
+
+	// BC4/BC5 no srgb variant, srgb texture keep four channel layout and use BC7, single channel still in r.
+	static inline ETextureBlockCompression getBlockCompression(const AssetTexture::ImportConfig& config, bool bSRGB)
+	{
+		switch (config.channel)
+		{
+		case AssetTexture::ImportConfig::EChannel::RGB:
+			return ETextureBlockCompression::BC1;
+		case AssetTexture::ImportConfig::EChannel::RG:
+			return bSRGB ? ETextureBlockCompression::BC7 : ETextureBlockCompression::BC5;
+		case AssetTexture::ImportConfig::EChannel::R:
+		case AssetTexture::ImportConfig::EChannel::G:
+		case AssetTexture::ImportConfig::EChannel::B:
+		case AssetTexture::ImportConfig::EChannel::A:
+			return bSRGB ? ETextureBlockCompression::BC7 : ETextureBlockCompression::BC4;
+		default:
+			return ETextureBlockCompression::BC7;
+		}
+	}
+
+	static inline VkFormat getBlockCompressionFormat(ETextureBlockCompression compression, bool bSRGB)
+	{
+		switch (compression)
+		{
+		case ETextureBlockCompression::BC1: return bSRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case ETextureBlockCompression::BC4: return VK_FORMAT_BC4_UNORM_BLOCK;
+		case ETextureBlockCompression::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case ETextureBlockCompression::BC7: return bSRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+		default: CHECK_ENTRY(); return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	// Compress rgba8 mipmaps, blocks of each mip compress in parallel.
+	static inline void mipmapCompress(AssetTextureBin& inOutBin, const AssetTexture& meta, ETextureBlockCompression compression)
+	{
+		const uint32_t blockBytes = (compression == ETextureBlockCompression::BC1 || compression == ETextureBlockCompression::BC4) ? 8 : 16;
+
 		std::vector<std::vector<uint8_t>> compressedMipdatas;
 		compressedMipdatas.resize(inOutBin.mipmapDatas.size());
 
 		for(size_t mipIndex = 0; mipIndex < compressedMipdatas.size(); mipIndex ++)
 		{
 			auto& compressMipData = compressedMipdatas[mipIndex];
-			auto& srcMipData = inOutBin.mipmapDatas[mipIndex];
+			const auto& srcMipData = inOutBin.mipmapDatas[mipIndex];
 
-			uint32_t mipWidth = math::max<uint32_t>(meta.getWidth() >> mipIndex, 1);
-			uint32_t mipHeight = math::max<uint32_t>(meta.getHeight() >> mipIndex, 1);
+			const uint32_t mipWidth = math::max<uint32_t>(meta.getWidth() >> mipIndex, 1);
+			const uint32_t mipHeight = math::max<uint32_t>(meta.getHeight() >> mipIndex, 1);
 
-			if (mipWidth >= 4 && mipHeight >= 4)
-			{
-				uint32_t compressSize = mipWidth * mipHeight;
-				compressMipData.resize(compressSize);
-				uint8_t* outBuffer = compressMipData.data();
-
-				struct BlockTask
-				{
-					uint32_t pixelPosX;
-					uint32_t pixelPosY;
-					uint32_t bufferOffset;
-				};
-
-				std::vector<BlockTask> compressTasks(mipWidth * mipHeight / 16);
-				for (uint32_t i = 0; i < compressTasks.size(); i++)
-				{
-					compressTasks[i].pixelPosX = (i * 4) % mipWidth;
-					compressTasks[i].pixelPosY = 4 * ((i * 4) / mipWidth);
+			const uint32_t blockCountX = divideRoundingUp(mipWidth, 4U);
+			const uint32_t blockCountY = divideRoundingUp(mipHeight, 4U);
+			compressMipData.resize(size_t(blockCountX) * blockCountY * blockBytes);
 
-					compressTasks[i].bufferOffset = i * 16;
-				}
+			ThreadPool::getDefault()->parallelFor(0U, blockCountY, [&](uint32_t blockYStart, uint32_t blockYEnd)
+			{
+				std::array<uint8_t, 64> block { };
+				std::array<uint8_t, 32> channelBlock { };
 
-				std::for_each(std::execution::par, compressTasks.begin(), compressTasks.end(), [&](const BlockTask& item)
+				for (uint32_t blockY = blockYStart; blockY < blockYEnd; blockY++)
 				{
-					std::array<uint8_t, 64> block{ };
-					uint32_t blockLocation = 0;
-
-					for (uint32_t j = 0; j < 4; j++)
+					for (uint32_t blockX = 0; blockX < blockCountX; blockX++)
 					{
-						for (uint32_t i = 0; i < 4; i++)
+						// Mip smaller than 4x4 clamp fetch edge pixels, gpu only sample the valid part.
+						for (uint32_t j = 0; j < 4; j++)
 						{
-							const uint32_t dimX = item.pixelPosX + i;
-							const uint32_t dimY = item.pixelPosY + j;
-							const uint32_t pixelLocation = (dimX + dimY * mipWidth) * 4;
-
-							const uint8_t* dataStart = srcMipData.data() + pixelLocation;
-							for (uint32_t k = 0; k < 4; k++)
+							const uint32_t posY = math::min(blockY * 4 + j, mipHeight - 1);
+							for (uint32_t i = 0; i < 4; i++)
 							{
-								block[blockLocation] = *dataStart;
-								blockLocation++;
-								dataStart++;
+								const uint32_t posX = math::min(blockX * 4 + i, mipWidth - 1);
+								memcpy(&block[(j * 4 + i) * 4], srcMipData.data() + (size_t(posY) * mipWidth + posX) * 4, 4);
 							}
 						}
-					}
-
-					stb_compress_dxt_block(&compressMipData[item.bufferOffset], block.data(), 1, STB_DXT_HIGHQUAL);
-				});
-			}
-			else
-			{
-				uint32_t bufferOffset = 0;
-				compressMipData.resize(16 * math::max<uint32_t>(1, mipWidth / 4) * math::max<uint32_t>(1, mipHeight / 4));
 
-				std::array<uint8_t, 64> block{ };
-				for (uint32_t blockX = 0; blockX < mipWidth; blockX += 4)
-				{
-					for (uint32_t blockY = 0; blockY < mipHeight; blockY += 4)
-					{
-						// Idea: We can't just use 4x4 level result, which make alpha value error. we upscale mipmap data to 4x4 and do one compression.
-						// Eg: 1x1 -> copy upscale to 4x4, then compress to one block.
-						//     2x2 -> copy upscale to 4x4, then compress to one block.
-						//   a    a a a a  -> compress a`  a b   a a b b   -> compress a`
-						//        a a a a                  c d   a a b b 
-						//		  a a a a                        c c d d 
-						//		  a a a a                        c c d d
-						const uint32_t kScaleX = math::max<uint32_t>(1, 4 / mipWidth);
-						const uint32_t kScaleY = math::max<uint32_t>(1, 4 / mipHeight);
-
-						uint32_t blockLocation = 0;
-						for (uint32_t dimX = 0; dimX < 4; dimX++)
+						uint8_t* dest = compressMipData.data() + (size_t(blockY) * blockCountX + blockX) * blockBytes;
+						switch (compression)
+						{
+						case ETextureBlockCompression::BC1:
+						{
+							compressBlockBC1(dest, block.data());
+						}
+						break;
+						case ETextureBlockCompression::BC4:
 						{
-							for (uint32_t dimY = 0; dimY < 4; dimY++)
+							for (uint32_t i = 0; i < 16; i++)
 							{
-								uint32_t posX = blockX + dimX / kScaleX;
-								uint32_t posY = blockY + dimY / kScaleY;
-
-								const uint32_t pixelLocation = (posX + posY * mipWidth) * 4;
-								const uint8_t* dataStart = srcMipData.data() + pixelLocation;
-								for (uint32_t k = 0; k < 4; k++)
-								{
-									block[blockLocation] = *dataStart;
-									blockLocation++;
-									dataStart++;
-								}
+								channelBlock[i] = block[i * 4];
 							}
+							compressBlockBC4(dest, channelBlock.data());
+						}
+						break;
+						case ETextureBlockCompression::BC5:
+						{
+							for (uint32_t i = 0; i < 16; i++)
+							{
+								channelBlock[i * 2 + 0] = block[i * 4 + 0];
+								channelBlock[i * 2 + 1] = block[i * 4 + 1];
+							}
+							compressBlockBC5(dest, channelBlock.data());
+						}
+						break;
+						case ETextureBlockCompression::BC7:
+						{
+							compressBlockBC7(dest, block.data());
+						}
+						break;
+						default:
+						{
+							CHECK_ENTRY();
+						}
+						break;
 						}
-						stb_compress_dxt_block(&compressMipData[bufferOffset], block.data(), 1, STB_DXT_HIGHQUAL);
-						bufferOffset += 16;
 					}
 				}
-			}
+			}, 1);
 		}
 
 		inOutBin.mipmapDatas = std::move(compressedMipdatas);
@@ -409,6 +720,10 @@ namespace engine
 				{
 					return VK_FORMAT_R32G32B32_SFLOAT;
 				}
+				else if (config.channel == ImportConfig::EChannel::RG)
+				{
+					return VK_FORMAT_R32G32_SFLOAT;
+				}
 				else if (
 					config.channel == ImportConfig::EChannel::R ||
 					config.channel == ImportConfig::EChannel::G || 
@@ -430,6 +745,10 @@ namespace engine
 					{
 						return VK_FORMAT_R16G16B16_UNORM;
 					}
+					else if (config.channel == ImportConfig::EChannel::RG)
+					{
+						return VK_FORMAT_R16G16_UNORM;
+					}
 					else if (
 						config.channel == ImportConfig::EChannel::R ||
 						config.channel == ImportConfig::EChannel::G ||
@@ -442,13 +761,18 @@ namespace engine
 				else
 				{
 					// LDR.
-					if (meta.m_bSRGB)
+					if (meta.m_bCompressed)
+					{
+						// Block format select by channel.
+						return getBlockCompressionFormat(getBlockCompression(config, meta.m_bSRGB), meta.m_bSRGB);
+					}
+					else if (meta.m_bSRGB)
 					{
-						return meta.m_bCompressed ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_R8G8B8A8_SRGB;  // SRGB 4 Channel.
+						return VK_FORMAT_R8G8B8A8_SRGB;  // SRGB 4 Channel.
 					}
 					else
 					{
-						return meta.m_bCompressed ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_R8G8B8A8_UNORM; // UNORM 4 Channel.
+						return VK_FORMAT_R8G8B8A8_UNORM; // UNORM 4 Channel.
 					}
 				}
 
@@ -513,9 +837,9 @@ namespace engine
 				getChannelCountOffset(channelCount, pixelSampleOffset, config);
 
 				AssetTextureBin bin{};
-				buildMipmapData<float>(out, meta, bin, channelCount, pixelSampleOffset);
+				buildMipmapData<float>(out, meta, bin, channelCount, pixelSampleOffset, config.mipmapFilter);
 
-				saveAsset<AssetTextureBin>(bin, savePath, ".imagebin");
+				bin.save(savePath, ".imagebin");
 
 				// Build snapshot.
 				{
@@ -592,8 +916,8 @@ namespace engine
 				getChannelCountOffset(channelCount, pixelSampleOffset, config);
 
 				AssetTextureBin bin{};
-				buildMipmapData<uint16_t>(pixels, meta, bin, channelCount, pixelSampleOffset);
-				saveAsset<AssetTextureBin>(bin, savePath, ".imagebin");
+				buildMipmapData<uint16_t>(pixels, meta, bin, channelCount, pixelSampleOffset, config.mipmapFilter);
+				bin.save(savePath, ".imagebin");
 			}
 			// Build snapshot.
 			{
@@ -693,14 +1017,23 @@ namespace engine
 						meta.getMipmapCount(),
 						meta.isSrgb(), 
 						meta.getWidth(), 
-						meta.getHeight());
+						meta.getHeight(),
+						config.mipmapFilter);
+
+					uint32_t channelCount;
+					uint32_t pixelSampleOffset;
+					getChannelCountOffset(channelCount, pixelSampleOffset, config);
+					if (channelCount == 1)
+					{
+						mipmapSwizzleChannelToR(bin, pixelSampleOffset);
+					}
 
 					if (meta.m_bCompressed)
 					{
-						mipmapCompressBC3(bin, meta);
+						mipmapCompress(bin, meta, getBlockCompression(config, meta.m_bSRGB));
 					}
 
-					saveAsset<AssetTextureBin>(bin, savePath, ".imagebin");
+					bin.save(savePath, ".imagebin");
 				}
 
 				// Build snapshot.
@@ -769,23 +1102,74 @@ namespace engine
 		return (VkFormat)m_format;
 	}
 
-	void AssetTextureCacheLoadTask::uploadFunction(
-		uint32_t stageBufferOffset, void* bufferPtrStart, RHICommandBufferBase& commandBuffer, VulkanBuffer& stageBuffer)
+	bool AssetTextureBin::save(const std::filesystem::path& savePath, const char* suffix) const
+	{
+		AssetChunkFileWriter writer;
+		for (uint32_t level = 0; level < (uint32_t)mipmapDatas.size(); level++)
+		{
+			writer.addChunk(level, mipmapDatas[level]);
+		}
+
+		return writer.save(savePath, suffix);
+	}
+
+	static std::filesystem::path getTextureBinPath(const AssetTexture& asset)
 	{
 		auto savePath = getAssetSystem()->getProjectRootPath();
-		auto filePath = "\\." + cacheAsset->getRelativePathUtf8() + ".imagebin";
+		auto filePath = "\\." + asset.getRelativePathUtf8() + ".imagebin";
 		savePath += filePath;
 
-		AssetTextureBin textureBin{};
-		loadAsset(textureBin, savePath);
+		return savePath;
+	}
 
-		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
-		rangeAllMips.levelCount = cacheAsset->getMipmapCount();
+	enum class EMipChunkUpload
+	{
+		NoChunkFile,
+		ReadFail,
+		Success,
+	};
+
+	// Read mips [firstMip, mipCount) from chunk file into stage buffer, and record copy to image level (level - firstMip).
+	static EMipChunkUpload recordMipChunksUpload(
+		const std::filesystem::path& path,
+		uint32_t firstMip,
+		uint32_t mipmapCount,
+		uint32_t width,
+		uint32_t height,
+		uint32_t uploadSize,
+		VulkanImage& image,
+		uint32_t stageBufferOffset,
+		void* bufferPtrStart,
+		RHICommandBufferBase& commandBuffer,
+		VulkanBuffer& stageBuffer)
+	{
+		AssetChunkFileReader reader;
+		if (!reader.open(path))
+		{
+			return EMipChunkUpload::NoChunkFile;
+		}
 
-		imageAssetGPU->prepareToUpload(commandBuffer, rangeAllMips);
+		// Mip data pack tightly in stage buffer.
+		std::vector<uint32_t> mipOffsets(mipmapCount);
+		std::vector<AssetChunkFileReader::ReadRequest> requests;
 
-		uint32_t bufferOffset = 0;
 		uint32_t bufferSize = 0;
+		for (uint32_t level = firstMip; level < mipmapCount; level++)
+		{
+			const uint32_t mipSize = (uint32_t)reader.getChunkSize(level);
+			mipOffsets[level] = bufferSize;
+			bufferSize += mipSize;
+
+			requests.push_back({ .id = level, .dest = (char*)bufferPtrStart + mipOffsets[level], .destSize = mipSize });
+		}
+		ASSERT(uploadSize >= bufferSize, "Upload size must bigger than buffer size!");
+
+		// All mips decompress in parallel directly into stage buffer.
+		if (!reader.readChunks(requests))
+		{
+			LOG_ERROR("Cooked texture {} mip chunks broken.", utf8::utf16to8(path.u16string()));
+			return EMipChunkUpload::ReadFail;
+		}
 
 		VkBufferImageCopy region{};
 		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -796,30 +1180,89 @@ namespace engine
 		region.bufferImageHeight = 0;
 
 		std::vector<VkBufferImageCopy> copyRegions{};
-
-		const auto& mipmapDatas = textureBin.mipmapDatas;
-		for (uint32_t level = 0; level < cacheAsset->getMipmapCount(); level++)
+		for (uint32_t level = firstMip; level < mipmapCount; level++)
 		{
-			const auto& currentMip = mipmapDatas.at(level);
-			const uint32_t currentMipSize = (uint32_t)currentMip.size();
-
-			uint32_t mipWidth  = std::max<uint32_t>(cacheAsset->getWidth()  >> level, 1);
-			uint32_t mipHeight = std::max<uint32_t>(cacheAsset->getHeight() >> level, 1);
+			uint32_t mipWidth  = std::max<uint32_t>(width  >> level, 1);
+			uint32_t mipHeight = std::max<uint32_t>(height >> level, 1);
 
-			memcpy((void*)((char*)bufferPtrStart + bufferOffset), currentMip.data(), currentMipSize);
-
-			region.bufferOffset = stageBufferOffset + bufferOffset;
-			region.imageSubresource.mipLevel = level;
+			region.bufferOffset = stageBufferOffset + mipOffsets[level];
+			region.imageSubresource.mipLevel = level - firstMip;
 			region.imageExtent = { mipWidth, mipHeight, 1 };
 
 			copyRegions.push_back(region);
+		}
 
-			bufferOffset += currentMipSize;
-			bufferSize += currentMipSize;
+		vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, image.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)copyRegions.size(), copyRegions.data());
+		return EMipChunkUpload::Success;
+	}
+
+	void AssetTextureCacheLoadTask::uploadFunction(
+		uint32_t stageBufferOffset, void* bufferPtrStart, RHICommandBufferBase& commandBuffer, VulkanBuffer& stageBuffer)
+	{
+		const auto savePath = getTextureBinPath(*cacheAsset);
+		const uint32_t mipmapCount = cacheAsset->getMipmapCount();
+
+		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
+		rangeAllMips.levelCount = mipmapCount - firstMip;
+
+		imageAssetGPU->prepareToUpload(commandBuffer, rangeAllMips);
+
+		const auto result = recordMipChunksUpload(savePath, firstMip, mipmapCount, cacheAsset->getWidth(), cacheAsset->getHeight(), 
+			uploadSize(), imageAssetGPU->getImage(), stageBufferOffset, bufferPtrStart, commandBuffer, stageBuffer);
+
+		if (result == EMipChunkUpload::ReadFail)
+		{
+			// Image content undefined, keep loading state so material still sample fallback.
+			bUploadFailed = true;
 		}
-		ASSERT(uploadSize() >= bufferSize, "Upload size must bigger than buffer size!");
+		else if (result == EMipChunkUpload::NoChunkFile)
+		{
+			// Legacy cereal archive, never streaming.
+			CHECK(firstMip == 0);
 
-		vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, imageAssetGPU->getImage().getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)copyRegions.size(), copyRegions.data());
+			AssetTextureBin textureBin{};
+			loadAsset(textureBin, savePath);
+
+			std::vector<uint32_t> mipSizes(mipmapCount);
+			std::vector<uint32_t> mipOffsets(mipmapCount);
+
+			uint32_t bufferSize = 0;
+			for (uint32_t level = 0; level < mipmapCount; level++)
+			{
+				mipSizes[level] = (uint32_t)textureBin.mipmapDatas.at(level).size();
+				mipOffsets[level] = bufferSize;
+				bufferSize += mipSizes[level];
+			}
+			ASSERT(uploadSize() >= bufferSize, "Upload size must bigger than buffer size!");
+
+			for (uint32_t level = 0; level < mipmapCount; level++)
+			{
+				memcpy((void*)((char*)bufferPtrStart + mipOffsets[level]), textureBin.mipmapDatas[level].data(), mipSizes[level]);
+			}
+
+			VkBufferImageCopy region{};
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { 0, 0, 0 };
+			region.bufferRowLength = 0;
+			region.bufferImageHeight = 0;
+
+			std::vector<VkBufferImageCopy> copyRegions{};
+			for (uint32_t level = 0; level < mipmapCount; level++)
+			{
+				uint32_t mipWidth  = std::max<uint32_t>(cacheAsset->getWidth()  >> level, 1);
+				uint32_t mipHeight = std::max<uint32_t>(cacheAsset->getHeight() >> level, 1);
+
+				region.bufferOffset = stageBufferOffset + mipOffsets[level];
+				region.imageSubresource.mipLevel = level;
+				region.imageExtent = { mipWidth, mipHeight, 1 };
+
+				copyRegions.push_back(region);
+			}
+
+			vkCmdCopyBufferToImage(commandBuffer.cmd, stageBuffer, imageAssetGPU->getImage().getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)copyRegions.size(), copyRegions.data());
+		}
 
 		imageAssetGPU->finishUpload(commandBuffer, rangeAllMips);
 	}
@@ -829,23 +1272,100 @@ namespace engine
 	{
 		auto* fallbackWhite = context->getEngineTextureWhite().get();
 
-		auto newAsset = std::make_shared<GPUImageAsset>(
-			context,
-			fallbackWhite,
-			asset->getFormat(),
-			asset->getNameUtf8(),
-			asset->getMipmapCount(),
-			asset->getWidth(),
-			asset->getHeight(),
-			asset->getDepth()
-		);
+		// Large 2d texture only load mip tail here, other mips stream in by sampled feedback.
+		uint32_t tailMip = 0;
+		std::vector<uint32_t> mipSizes;
+		const auto binPath = getTextureBinPath(*asset);
+		if (asset->getDepth() == 1)
+		{
+			tailMip = context->getTextureStreaming().getTailMip(asset->getWidth(), asset->getHeight(), asset->getMipmapCount());
+		}
+
+		AssetChunkFileReader reader;
+		if (tailMip > 0 && reader.open(binPath))
+		{
+			mipSizes.resize(asset->getMipmapCount());
+			for (uint32_t level = 0; level < asset->getMipmapCount(); level++)
+			{
+				mipSizes[level] = (uint32_t)reader.getChunkSize(level);
+			}
+		}
+		else
+		{
+			tailMip = 0;
+		}
+
+		std::shared_ptr<GPUImageAsset> newAsset;
+		if (tailMip > 0)
+		{
+			auto streamingAsset = std::make_shared<GPUStreamingImageAsset>(
+				context,
+				fallbackWhite,
+				asset->getFormat(),
+				asset->getNameUtf8(),
+				asset->getUUID(),
+				binPath,
+				std::move(mipSizes),
+				asset->getWidth(),
+				asset->getHeight(),
+				tailMip
+			);
+
+			context->getTextureStreaming().registerTexture(streamingAsset);
+			newAsset = streamingAsset;
+		}
+		else
+		{
+			newAsset = std::make_shared<GPUImageAsset>(
+				context,
+				fallbackWhite,
+				asset->getFormat(),
+				asset->getNameUtf8(),
+				asset->getMipmapCount(),
+				asset->getWidth(),
+				asset->getHeight(),
+				asset->getDepth()
+			);
+		}
 
 		context->insertGPUAsset(asset->getUUID(), newAsset);
 
 		auto newTask = std::make_shared<AssetTextureCacheLoadTask>(asset);
 		newTask->imageAssetGPU = newAsset;
+		newTask->firstMip = tailMip;
 
 		return newTask;
 	}
 
+	void AssetTextureStreamTask::uploadFunction(
+		uint32_t stageBufferOffset, void* bufferPtrStart, RHICommandBufferBase& commandBuffer, VulkanBuffer& stageBuffer)
+	{
+		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
+		rangeAllMips.levelCount = imageAssetGPU->getMipCount() - firstMip;
+
+		image->transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, rangeAllMips);
+
+		const auto result = recordMipChunksUpload(imageAssetGPU->getBinPath(), firstMip, imageAssetGPU->getMipCount(), 
+			imageAssetGPU->getWidth(), imageAssetGPU->getHeight(), uploadSize(), *image, stageBufferOffset, bufferPtrStart, commandBuffer, stageBuffer);
+
+		if (result != EMipChunkUpload::Success)
+		{
+			LOG_ERROR("Fail to stream texture mips from {}, cooked file may be removed.", utf8::utf16to8(imageAssetGPU->getBinPath().u16string()));
+			bUploadFailed = true;
+		}
+
+		image->transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, rangeAllMips);
+	}
+
+	std::shared_ptr<AssetTextureStreamTask> AssetTextureStreamTask::build(std::shared_ptr<GPUStreamingImageAsset> asset, uint32_t firstMip)
+	{
+		auto newTask = std::make_shared<AssetTextureStreamTask>();
+
+		newTask->imageAssetGPU = asset;
+		newTask->image = asset->createMipImage(firstMip);
+		newTask->firstMip = firstMip;
+
+		asset->beginStreaming();
+		return newTask;
+	}
 }
\ No newline at end of file
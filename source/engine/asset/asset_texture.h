@@ -2,6 +2,7 @@
 
 #include "asset_common.h"
 #include "asset_archive.h"
+#include "asset_chunk_file.h"
 
 namespace engine
 {
@@ -27,8 +28,17 @@ namespace engine
 				B,
 				A,
 				RGB,
+				RG,
 			};
 			EChannel channel = EChannel::RGBA;
+
+			// Mipmap downsample filter, all filter work in linear space.
+			enum class EMipmapFilter
+			{
+				Box,
+				Kaiser,
+			};
+			EMipmapFilter mipmapFilter = EMipmapFilter::Box;
 		};
 
 
@@ -85,6 +95,9 @@ namespace engine
 		{
 			archive(mipmapDatas);
 		}
+
+		// Save as chunk file, chunk id is mip level.
+		bool save(const std::filesystem::path& savePath, const char* suffix) const;
 	};
 
 	struct AssetTextureCacheLoadTask : public AssetTextureLoadTask
@@ -97,6 +110,9 @@ namespace engine
 
 		std::shared_ptr<AssetTexture> cacheAsset;
 
+		// Mips before first mip no resident, streaming texture load mip tail first.
+		uint32_t firstMip = 0;
+
 		virtual void uploadFunction(
 			uint32_t stageBufferOffset,
 			void* bufferPtrStart,
@@ -105,6 +121,36 @@ namespace engine
 
 		static std::shared_ptr<AssetTextureCacheLoadTask> build(VulkanContext* context, std::shared_ptr<AssetTexture> asset);
 	};
+
+	// Upload mips [firstMip, mipCount) of streaming texture into a new image, main thread swap it when finish.
+	struct AssetTextureStreamTask : public AssetLoadTask
+	{
+		std::shared_ptr<GPUStreamingImageAsset> imageAssetGPU;
+		std::unique_ptr<VulkanImage> image;
+		uint32_t firstMip = 0;
+
+		// Keep current resident image when mips read fail.
+		bool bUploadFailed = false;
+
+		virtual void finishCallback() override
+		{
+			if (bUploadFailed)
+			{
+				imageAssetGPU->cancelStreaming();
+				return;
+			}
+			imageAssetGPU->finishStreaming(std::move(image), firstMip);
+		}
+		virtual uint32_t uploadSize() const override { return uint32_t(imageAssetGPU->getResidentSize(firstMip)); }
+
+		virtual void uploadFunction(
+			uint32_t stageBufferOffset,
+			void* bufferPtrStart,
+			RHICommandBufferBase& commandBuffer,
+			VulkanBuffer& stageBuffer) override;
+
+		static std::shared_ptr<AssetTextureStreamTask> build(std::shared_ptr<GPUStreamingImageAsset> asset, uint32_t firstMip);
+	};
 }
 
 ASSET_ARCHIVE_IMPL_INHERIT(AssetTexture, AssetInterface)
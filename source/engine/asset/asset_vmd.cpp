@@ -2,9 +2,288 @@
 #include "asset_material.h"
 #include "asset_texture.h"
 #include "asset_system.h"
+#include "asset_chunk_file.h"
 
 namespace engine
 {
+    // Bump when cooked layout change, old .vmdbin will re-cook when load.
+    constexpr uint32_t kVMDBinVersion = 2;
+
+    // Bump when bake layout or sample method change, old .vmdbake will re-bake when load.
+    constexpr uint32_t kVMDBakeBinVersion = 2;
+
+    static_assert(std::is_trivially_copyable_v<saba::VMDCookedMotion>);
+    static_assert(std::is_trivially_copyable_v<saba::VMDCookedMorph>);
+    static_assert(std::is_trivially_copyable_v<saba::VMDCookedIk>);
+    static_assert(std::is_trivially_copyable_v<saba::VMDCamera>);
+
+    bool VMDBin::save(const saba::VMDCookedFile& vmd, const AssetSourceStamp& source, const std::filesystem::path& savePath, const char* suffix)
+    {
+        Header header{};
+        header.version = kVMDBinVersion;
+        header.nameCount = (uint32_t)vmd.m_names.size();
+        header.motionCount = vmd.m_motions.size();
+        header.morphCount = vmd.m_morphs.size();
+        header.ikCount = vmd.m_iks.size();
+        header.cameraCount = vmd.m_cameras.size();
+        header.source = source;
+
+        std::string namesBlob;
+        {
+            std::ostringstream os(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive archive(os);
+                archive(vmd.m_names);
+            }
+            namesBlob = os.str();
+        }
+
+        AssetChunkFileWriter writer;
+        writer.addChunk((uint32_t)EChunk::Header, &header, sizeof(header), false);
+        writer.addChunk((uint32_t)EChunk::Names, namesBlob.data(), namesBlob.size());
+        writer.addChunk((uint32_t)EChunk::Motions, vmd.m_motions);
+        writer.addChunk((uint32_t)EChunk::Morphs, vmd.m_morphs);
+        writer.addChunk((uint32_t)EChunk::Iks, vmd.m_iks);
+        writer.addChunk((uint32_t)EChunk::Cameras, vmd.m_cameras);
+
+        return writer.save(savePath, suffix, false);
+    }
+
+    bool VMDBin::load(const std::filesystem::path& path, const AssetSourceStamp& source, saba::VMDCookedFile& vmd)
+    {
+        AssetChunkFileReader reader;
+        if (!reader.open(path))
+        {
+            return false;
+        }
+
+        Header header{};
+        if (reader.getChunkSize((uint32_t)EChunk::Header) != sizeof(Header) ||
+            !reader.readChunk((uint32_t)EChunk::Header, &header, sizeof(Header)))
+        {
+            return false;
+        }
+
+        if (header.version != kVMDBinVersion || header.source != source)
+        {
+            LOG_INFO("Cooked vmd {} out of date, re-cook.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        vmd.m_motions.resize(header.motionCount);
+        vmd.m_morphs.resize(header.morphCount);
+        vmd.m_iks.resize(header.ikCount);
+        vmd.m_cameras.resize(header.cameraCount);
+
+        std::string namesBlob(reader.getChunkSize((uint32_t)EChunk::Names), '\0');
+
+        auto makeRequest = [&](EChunk id, auto& data) -> AssetChunkFileReader::ReadRequest
+        {
+            return { .id = (uint32_t)id, .dest = data.data(), .destSize = data.size() * sizeof(data[0]) };
+        };
+
+        const std::vector<AssetChunkFileReader::ReadRequest> requests =
+        {
+            makeRequest(EChunk::Names, namesBlob),
+            makeRequest(EChunk::Motions, vmd.m_motions),
+            makeRequest(EChunk::Morphs, vmd.m_morphs),
+            makeRequest(EChunk::Iks, vmd.m_iks),
+            makeRequest(EChunk::Cameras, vmd.m_cameras),
+        };
+
+        for (const auto& request : requests)
+        {
+            if (reader.getChunkSize(request.id) != request.destSize)
+            {
+                LOG_ERROR("Cooked vmd {} chunk {} size un-match.", utf8::utf16to8(path.u16string()), request.id);
+                return false;
+            }
+        }
+
+        if (!reader.readChunks(requests))
+        {
+            return false;
+        }
+
+        try
+        {
+            std::istringstream is(namesBlob, std::ios::binary);
+            cereal::BinaryInputArchive archive(is);
+            archive(vmd.m_names);
+        }
+        catch (...)
+        {
+            LOG_ERROR("Cooked vmd {} name table broken.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        // Keys index name table, never trust file.
+        const size_t nameCount = vmd.m_names.size();
+        bool bNameIndexValid = (nameCount == header.nameCount);
+        for (const auto& motion : vmd.m_motions) { bNameIndexValid &= motion.m_nameIndex < nameCount; }
+        for (const auto& morph : vmd.m_morphs) { bNameIndexValid &= morph.m_nameIndex < nameCount; }
+        for (const auto& ik : vmd.m_iks) { bNameIndexValid &= ik.m_nameIndex < nameCount; }
+        if (!bNameIndexValid)
+        {
+            LOG_ERROR("Cooked vmd {} name index out of range.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        return true;
+    }
+
+    bool VMDBakeBin::save(const saba::VMDBakedTracks& tracks, const AssetSourceStamp& source, const std::filesystem::path& savePath, const char* suffix)
+    {
+        Header header{};
+        header.version = kVMDBakeBinVersion;
+        header.samplesPerFrame = tracks.m_samplesPerFrame;
+        header.sampleCount = tracks.m_sampleCount;
+        header.maxKeyTime = tracks.m_maxKeyTime;
+        header.nodeCount = (uint32_t)tracks.m_nodeNames.size();
+        header.animatedNodeCount = tracks.m_animatedNodeCount;
+        header.morphCount = (uint32_t)tracks.m_morphNames.size();
+        header.animatedMorphCount = tracks.m_animatedMorphCount;
+        header.ikCount = (uint32_t)tracks.m_ikNames.size();
+        header.source = source;
+
+        std::string namesBlob;
+        {
+            std::ostringstream os(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive archive(os);
+                archive(tracks.m_nodeNames, tracks.m_morphNames, tracks.m_ikNames);
+            }
+            namesBlob = os.str();
+        }
+
+        // Quantized sample rows repeat a lot, lz4 compress all tracks.
+        AssetChunkFileWriter writer;
+        writer.addChunk((uint32_t)EChunk::Header, &header, sizeof(header), false);
+        writer.addChunk((uint32_t)EChunk::Names, namesBlob.data(), namesBlob.size());
+        writer.addChunk((uint32_t)EChunk::TranslateMin, tracks.m_translateMin);
+        writer.addChunk((uint32_t)EChunk::TranslateExtent, tracks.m_translateExtent);
+        writer.addChunk((uint32_t)EChunk::Translates, tracks.m_translates);
+        writer.addChunk((uint32_t)EChunk::Rotates, tracks.m_rotates);
+        writer.addChunk((uint32_t)EChunk::ConstTranslates, tracks.m_constTranslates);
+        writer.addChunk((uint32_t)EChunk::ConstRotates, tracks.m_constRotates);
+        writer.addChunk((uint32_t)EChunk::MorphMin, tracks.m_morphMin);
+        writer.addChunk((uint32_t)EChunk::MorphExtent, tracks.m_morphExtent);
+        writer.addChunk((uint32_t)EChunk::MorphWeights, tracks.m_morphWeights);
+        writer.addChunk((uint32_t)EChunk::ConstMorphWeights, tracks.m_constMorphWeights);
+        writer.addChunk((uint32_t)EChunk::IkEnables, tracks.m_ikEnables);
+
+        return writer.save(savePath, suffix, false);
+    }
+
+    bool VMDBakeBin::load(const std::filesystem::path& path, const AssetSourceStamp& source, uint32_t samplesPerFrame, saba::VMDBakedTracks& tracks)
+    {
+        AssetChunkFileReader reader;
+        if (!reader.open(path))
+        {
+            return false;
+        }
+
+        Header header{};
+        if (reader.getChunkSize((uint32_t)EChunk::Header) != sizeof(Header) ||
+            !reader.readChunk((uint32_t)EChunk::Header, &header, sizeof(Header)))
+        {
+            return false;
+        }
+
+        if (header.version != kVMDBakeBinVersion || header.source != source || header.samplesPerFrame != samplesPerFrame)
+        {
+            LOG_INFO("Baked vmd {} out of date, re-bake.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        if (header.animatedNodeCount > header.nodeCount || header.animatedMorphCount > header.morphCount)
+        {
+            return false;
+        }
+
+        const size_t samples = header.sampleCount;
+        const size_t animNodes = header.animatedNodeCount;
+        const size_t constNodes = header.nodeCount - header.animatedNodeCount;
+        const size_t animMorphs = header.animatedMorphCount;
+        const size_t constMorphs = header.morphCount - header.animatedMorphCount;
+
+        tracks = saba::VMDBakedTracks();
+        tracks.m_samplesPerFrame = header.samplesPerFrame;
+        tracks.m_sampleCount = header.sampleCount;
+        tracks.m_maxKeyTime = header.maxKeyTime;
+        tracks.m_animatedNodeCount = header.animatedNodeCount;
+        tracks.m_animatedMorphCount = header.animatedMorphCount;
+
+        tracks.m_translateMin.resize(animNodes * 3);
+        tracks.m_translateExtent.resize(animNodes * 3);
+        tracks.m_translates.resize(samples * animNodes * 3);
+        tracks.m_rotates.resize(samples * animNodes * 4);
+        tracks.m_constTranslates.resize(constNodes * 3);
+        tracks.m_constRotates.resize(constNodes * 4);
+        tracks.m_morphMin.resize(animMorphs);
+        tracks.m_morphExtent.resize(animMorphs);
+        tracks.m_morphWeights.resize(samples * animMorphs);
+        tracks.m_constMorphWeights.resize(constMorphs);
+        tracks.m_ikEnables.resize(samples * header.ikCount);
+
+        std::string namesBlob(reader.getChunkSize((uint32_t)EChunk::Names), '\0');
+
+        auto makeRequest = [&](EChunk id, auto& data) -> AssetChunkFileReader::ReadRequest
+        {
+            return { .id = (uint32_t)id, .dest = data.data(), .destSize = data.size() * sizeof(data[0]) };
+        };
+
+        const std::vector<AssetChunkFileReader::ReadRequest> requests =
+        {
+            makeRequest(EChunk::Names, namesBlob),
+            makeRequest(EChunk::TranslateMin, tracks.m_translateMin),
+            makeRequest(EChunk::TranslateExtent, tracks.m_translateExtent),
+            makeRequest(EChunk::Translates, tracks.m_translates),
+            makeRequest(EChunk::Rotates, tracks.m_rotates),
+            makeRequest(EChunk::ConstTranslates, tracks.m_constTranslates),
+            makeRequest(EChunk::ConstRotates, tracks.m_constRotates),
+            makeRequest(EChunk::MorphMin, tracks.m_morphMin),
+            makeRequest(EChunk::MorphExtent, tracks.m_morphExtent),
+            makeRequest(EChunk::MorphWeights, tracks.m_morphWeights),
+            makeRequest(EChunk::ConstMorphWeights, tracks.m_constMorphWeights),
+            makeRequest(EChunk::IkEnables, tracks.m_ikEnables),
+        };
+
+        for (const auto& request : requests)
+        {
+            if (reader.getChunkSize(request.id) != request.destSize)
+            {
+                LOG_ERROR("Baked vmd {} chunk {} size un-match.", utf8::utf16to8(path.u16string()), request.id);
+                return false;
+            }
+        }
+
+        if (!reader.readChunks(requests))
+        {
+            return false;
+        }
+
+        try
+        {
+            std::istringstream is(namesBlob, std::ios::binary);
+            cereal::BinaryInputArchive archive(is);
+            archive(tracks.m_nodeNames, tracks.m_morphNames, tracks.m_ikNames);
+        }
+        catch (...)
+        {
+            LOG_ERROR("Baked vmd {} name table broken.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        if (!tracks.IsValid())
+        {
+            LOG_ERROR("Baked vmd {} track count un-match.", utf8::utf16to8(path.u16string()));
+            return false;
+        }
+
+        return true;
+    }
+
     AssetVMD::AssetVMD(const std::string& assetNameUtf8, const std::string& assetRelativeRootProjectPathUtf8)
         : AssetInterface(assetNameUtf8, assetRelativeRootProjectPathUtf8)
     {
@@ -45,6 +324,13 @@ namespace engine
 
             meta.m_bCamera = config.bCamera;
             saveAssetMeta<AssetVMD>(meta, vmdFileSavePath, meta.getSuffix());
+
+            // Cook .vmdbin when import, so bind animation no need parse and convert sjis names again.
+            saba::VMDCookedFile cooked;
+            if (!meta.loadVMD(cooked))
+            {
+                LOG_WARN("Fail to cook vmd {0}.", assetNameUtf8);
+            }
         }
 
 
@@ -62,4 +348,87 @@ namespace engine
         return projectPath;
     }
 
-}
\ No newline at end of file
+    std::filesystem::path AssetVMD::getVMDBinPath() const
+    {
+        auto path = getSavePath();
+        path += ".vmdbin";
+
+        return path;
+    }
+
+    std::filesystem::path AssetVMD::getVMDBakePath() const
+    {
+        auto path = getSavePath();
+        path += ".vmdbake";
+
+        return path;
+    }
+
+    bool AssetVMD::loadVMD(saba::VMDCookedFile& vmd) const
+    {
+        CPU_PROFILER_SCOPE("AssetVMD::loadVMD");
+
+        const auto vmdPath = getVMDFilePath();
+        const std::string vmdPathString = vmdPath.string();
+
+        AssetSourceStamp source;
+        if (!AssetSourceStamp::get(vmdPath, source))
+        {
+            LOG_ERROR("Vmd file {} miss.", vmdPathString);
+            return false;
+        }
+
+        if (VMDBin::load(getVMDBinPath(), source, vmd))
+        {
+            return true;
+        }
+
+        // Cooked file miss (old project) or out of date, parse raw vmd and cook again.
+        saba::VMDFile vmdFile;
+        if (!saba::ReadVMDFile(&vmdFile, vmdPathString.c_str()))
+        {
+            return false;
+        }
+        saba::CookVMDFile(vmdFile, &vmd);
+
+        if (!VMDBin::save(vmd, source, getSavePath(), ".vmdbin"))
+        {
+            LOG_WARN("Fail to save cooked vmd for {}.", vmdPathString);
+        }
+
+        return true;
+    }
+
+    bool AssetVMD::loadBakedVMD(uint32_t samplesPerFrame, saba::VMDBakedTracks& tracks) const
+    {
+        CPU_PROFILER_SCOPE("AssetVMD::loadBakedVMD");
+
+        const auto vmdPath = getVMDFilePath();
+
+        AssetSourceStamp source;
+        if (!AssetSourceStamp::get(vmdPath, source))
+        {
+            LOG_ERROR("Vmd file {} miss.", vmdPath.string());
+            return false;
+        }
+
+        if (VMDBakeBin::load(getVMDBakePath(), source, samplesPerFrame, tracks))
+        {
+            return true;
+        }
+
+        saba::VMDCookedFile vmd;
+        if (!loadVMD(vmd))
+        {
+            return false;
+        }
+        saba::BakeVMDTracks(vmd, samplesPerFrame, &tracks);
+
+        if (!VMDBakeBin::save(tracks, source, getSavePath(), ".vmdbake"))
+        {
+            LOG_WARN("Fail to save baked vmd for {}.", vmdPath.string());
+        }
+
+        return true;
+    }
+}
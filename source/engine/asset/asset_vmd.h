@@ -11,6 +11,87 @@
 
 namespace engine
 {
+	// Cooked vmd store in .vmdbin chunk file, key arrays raw and sjis names resolved to utf8 name table.
+	struct VMDBin
+	{
+		// Chunk id in .vmdbin chunk file.
+		enum class EChunk : uint32_t
+		{
+			Header = 0,
+			Names,
+			Motions,
+			Morphs,
+			Iks,
+			Cameras,
+
+			Max,
+		};
+
+		struct Header
+		{
+			uint32_t version;
+			uint32_t nameCount;
+			uint64_t motionCount;
+			uint64_t morphCount;
+			uint64_t ikCount;
+			uint64_t cameraCount;
+
+			// Raw vmd file size and write time when cook, cooked file rebuild when un-match.
+			AssetSourceStamp source;
+		};
+
+		static bool save(const saba::VMDCookedFile& vmd, const AssetSourceStamp& source, const std::filesystem::path& savePath, const char* suffix);
+
+		// Return false when file miss, broken or out of date.
+		static bool load(const std::filesystem::path& path, const AssetSourceStamp& source, saba::VMDCookedFile& vmd);
+	};
+
+	// Baked vmd store in .vmdbake chunk file, fixed rate quantized tracks, rebuild when sample rate change.
+	struct VMDBakeBin
+	{
+		// Chunk id in .vmdbake chunk file.
+		enum class EChunk : uint32_t
+		{
+			Header = 0,
+			Names,
+			TranslateMin,
+			TranslateExtent,
+			Translates,
+			Rotates,
+			ConstTranslates,
+			ConstRotates,
+			MorphMin,
+			MorphExtent,
+			MorphWeights,
+			ConstMorphWeights,
+			IkEnables,
+
+			Max,
+		};
+
+		struct Header
+		{
+			uint32_t version;
+			uint32_t samplesPerFrame;
+			uint32_t sampleCount;
+			int32_t  maxKeyTime;
+
+			uint32_t nodeCount;
+			uint32_t animatedNodeCount;
+			uint32_t morphCount;
+			uint32_t animatedMorphCount;
+			uint32_t ikCount;
+
+			// Raw vmd file size and write time when bake, baked file rebuild when un-match.
+			AssetSourceStamp source;
+		};
+
+		static bool save(const saba::VMDBakedTracks& tracks, const AssetSourceStamp& source, const std::filesystem::path& savePath, const char* suffix);
+
+		// Return false when file miss, broken, out of date or sample rate un-match.
+		static bool load(const std::filesystem::path& path, const AssetSourceStamp& source, uint32_t samplesPerFrame, saba::VMDBakedTracks& tracks);
+	};
+
 	class AssetVMD : public AssetInterface
 	{
 	public:
@@ -33,6 +114,14 @@ namespace engine
 		);
 
 		std::filesystem::path getVMDFilePath() const;
+		std::filesystem::path getVMDBinPath() const;
+		std::filesystem::path getVMDBakePath() const;
+
+		// Load cooked .vmdbin, cook it from raw vmd when miss or out of date.
+		bool loadVMD(saba::VMDCookedFile& vmd) const;
+
+		// Load baked .vmdbake, bake it from cooked vmd when miss, out of date or sample rate change.
+		bool loadBakedVMD(uint32_t samplesPerFrame, saba::VMDBakedTracks& tracks) const;
 
 	protected:
 
@@ -2,8 +2,65 @@
 #include "scene_textures.h"
 #include "renderer.h"
 #include "render_scene.h"
+#include "render_graph.h"
 namespace engine
 {
+	static AutoCVarInt32 cVarAsyncComputeSSGI(
+		"r.AsyncCompute.SSGI",
+		"Run SSGI (ambient occlusion and bent normal) on async compute queue.",
+		"AsyncCompute",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarGTAO(
+		"r.GTAO",
+		"Enable GTAO, lighting use min of GTAO and SSGI ambient occlusion.",
+		"AO",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarAsyncComputeGTAO(
+		"r.AsyncCompute.GTAO",
+		"Run GTAO on async compute queue.",
+		"AsyncCompute",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarAsyncComputeSDSM(
+		"r.AsyncCompute.SDSM",
+		"Run SDSM depth range and cascade fit on async compute queue.",
+		"AsyncCompute",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarAsyncComputeCloud(
+		"r.AsyncCompute.Cloud",
+		"Run volumetric cloud on async compute queue.",
+		"AsyncCompute",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarAsyncComputeExposure(
+		"r.AsyncCompute.Exposure",
+		"Run adaptive exposure on async compute queue.",
+		"AsyncCompute",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarAsyncComputeBloom(
+		"r.AsyncCompute.Bloom",
+		"Run bloom on async compute queue.",
+		"AsyncCompute",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
     DeferredRenderer::DeferredRenderer(const char* name, VulkanContext* context, CameraInterface* inCam)
         : RendererInterface(name, context, inCam)
     {
@@ -50,85 +107,516 @@ namespace engine
 		}
 
 
-		GBufferTextures gbuffers = GBufferTextures::build(this, m_context);
+		RenderGraph graph(m_context);
+		RenderScene* scene = m_renderer->getScene();
+
+		GBufferTextures gbuffers = GBufferTextures::build(this, m_context, graph);
+		const auto& rg = gbuffers.rg;
+
+		const RGImage displayOutput = graph.importImage("DisplayOutput", m_displayOutput);
+		const RGImage skylightRadiance = graph.importImage("SkyIBLIrradiance", m_skylightRadiance);
+		const RGImage skylightReflection = graph.importImage("SkyIBLPrefilter", m_skylightReflection);
+
+		// History read by async compute pass, need declare for queue transfer.
+		const RGImage prevHDR = m_prevHDR ? graph.importImage("PrevHDR", m_prevHDR) : rg.hdrSceneColor;
+		const RGImage averageLumRG = m_averageLum ? graph.importImage("AverageLum", m_averageLum) : graph.declareImage("AverageLum");
+
+		// GTAO history only import when GTAO enable.
+		const bool bGTAO = cVarGTAO.get() != 0;
+		const RGImage prevDepth = (bGTAO && m_prevDepth) ? graph.importImage("PrevDepth", m_prevDepth) : rg.depthTexture;
+		const RGImage gtaoHistoryRG = (bGTAO && m_gtaoHistory) ? graph.importImage("GTAOHistory", m_gtaoHistory) : RGImage{ };
+
+		// Produce inside pass execute.
+		const RGImage hzbClosestRG = graph.declareImage("HzbClosest");
+		const RGImage hzbFurthestRG = graph.declareImage("HzbFurthest");
+		const RGImage ssaoBentNormalRG = graph.declareImage("SSAOBentNormal");
+		const RGImage gtaoRG = graph.declareImage("GTAO");
+		const RGImage sdsmShadowDepthRG = graph.declareImage("SDSMShadowDepth");
+		const RGImage sdsmMaskRG = graph.declareImage("SDSMMainViewMask");
+		const RGBuffer sdsmCascadeRG = graph.declareBuffer("SDSMCascadeInfo");
+		const RGBuffer sdsmRangeRG = graph.declareBuffer("SDSMRange");
+		const RGImage transmittanceRG = graph.declareImage("AtmosphereTransmittance");
+		const RGImage skyViewRG = graph.declareImage("AtmosphereSkyView");
+		const RGImage multiScatterRG = graph.declareImage("AtmosphereMultiScatter");
+		const RGImage froxelScatterRG = graph.declareImage("AtmosphereFroxelScatter");
+		const RGImage envCaptureRG = graph.declareImage("AtmosphereEnvCapture");
+		const RGBuffer lensBufferRG = graph.declareBuffer("LensBuffer");
+		const RGImage bloomTexRG = graph.declareImage("BloomTexture");
+		const RGBuffer pmxBoundsRG = graph.declareBuffer("PMXSubmeshBounds");
 
-		// GBuffer clear.
-		gbuffers.clearValue(graphicsCmd);
+		PoolImageSharedRef hzbClosest;
+		PoolImageSharedRef hzbFurthest;
+		PoolImageSharedRef ssaoBentNormal;
+		PoolImageSharedRef gtao;
+		SDSMInfos sdsmInfos{};
+		AtmosphereTextures atmosphereTextures{};
+		BufferParameterHandle lensBuffer;
+		PoolImageSharedRef bloomTex;
+		BufferParameterHandle pmxBounds;
 
+		auto readAtmosphere = [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(transmittanceRG)
+				.read(skyViewRG)
+				.read(multiScatterRG)
+				.read(froxelScatterRG)
+				.read(envCaptureRG);
+		};
 
+		// GBuffer clear.
+		gbuffers.addClearPass(graph);
 
-		renderStaticMeshPrepass(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU);
+		graph.addPass("StaticMeshPrepass", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.write(rg.depthTexture, ERGImageAccess::DepthAttachment)
+				.write(rg.selectionOutlineMask, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderStaticMeshPrepass(cmd, &gbuffers, scene, perFrameGPU);
+		});
 
-		renderTerrainGBuffer(graphicsCmd, &gbuffers, perFrameGPU, m_renderer->getScene());
+		graph.addPass("TerrainGBuffer", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.write(rg.hdrSceneColor, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferA, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferB, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferS, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferV, ERGImageAccess::ColorAttachment)
+				.write(rg.idTexture, ERGImageAccess::ColorAttachment)
+				.write(rg.depthTexture, ERGImageAccess::DepthAttachment)
+				.write(rg.selectionOutlineMask, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderTerrainGBuffer(cmd, &gbuffers, perFrameGPU, scene);
+		});
 
-		renderPMXGbuffer(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU);
+		graph.addPass("PMXSubmeshBounds", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.write(pmxBoundsRG, ERGBufferAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			pmxBounds = renderPMXSubmeshBounds(cmd, scene);
+			graph.setBuffer(pmxBoundsRG, pmxBounds);
+		});
 
-		//
-		PoolImageSharedRef hzbClosest;
-		PoolImageSharedRef hzbFurthest;
-		renderHzb(hzbClosest, hzbFurthest, graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU);
+		graph.addPass("PMXGBuffer", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(pmxBoundsRG)
+				.write(rg.hdrSceneColor, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferA, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferB, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferS, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferV, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferUpscaleTranslucencyAndComposition, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferUpscaleReactive, ERGImageAccess::ColorAttachment)
+				.write(rg.idTexture, ERGImageAccess::ColorAttachment)
+				.write(rg.depthTexture, ERGImageAccess::DepthAttachment)
+				.write(rg.selectionOutlineMask, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderPMXGbuffer(cmd, &gbuffers, scene, perFrameGPU, pmxBounds);
+		});
 
-		// Render static mesh Gbuffer.
-		renderStaticMeshGBuffer(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, hzbFurthest);
+		graph.addPass("Hzb", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.depthTexture)
+				.write(hzbClosestRG, ERGImageAccess::StorageWrite)
+				.write(hzbFurthestRG, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderHzb(hzbClosest, hzbFurthest, cmd, &gbuffers, scene, perFrameGPU);
+			graph.setImage(hzbClosestRG, hzbClosest);
+			graph.setImage(hzbFurthestRG, hzbFurthest);
+		});
 
+		// Render static mesh Gbuffer.
+		graph.addPass("StaticMeshGBuffer", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(hzbFurthestRG)
+				.write(rg.hdrSceneColor, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferA, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferB, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferS, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferV, ERGImageAccess::ColorAttachment)
+				.write(rg.idTexture, ERGImageAccess::ColorAttachment)
+				.write(rg.depthTexture, ERGImageAccess::DepthAttachment);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderStaticMeshGBuffer(cmd, &gbuffers, scene, perFrameGPU, hzbFurthest);
+		});
 
+		// Temporal history inside, never cull.
+		graph.addPass("SSGI", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.read(rg.gbufferB)
+				.read(rg.gbufferS)
+				.read(rg.gbufferV)
+				.read(rg.hdrSceneColor)
+				.read(prevHDR)
+				.read(hzbFurthestRG)
+				.write(ssaoBentNormalRG, ERGImageAccess::StorageWrite)
+				.asyncCompute(cVarAsyncComputeSSGI.get() != 0)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			ssaoBentNormal = renderSSGI(cmd, &gbuffers, scene, perFrameGPU, hzbFurthest);
+			graph.setImage(ssaoBentNormalRG, ssaoBentNormal);
+		});
 
-		auto ssaoBentNormal = renderSSGI(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, hzbFurthest);
+		// Temporal history inside, never cull.
+		if (bGTAO)
+		{
+			graph.addPass("GTAO", [&](RenderGraph::PassBuilder& builder)
+			{
+				builder
+					.read(rg.depthTexture)
+					.read(rg.gbufferA)
+					.read(rg.gbufferB)
+					.read(rg.gbufferS)
+					.read(rg.gbufferV)
+					.read(prevDepth)
+					.read(hzbFurthestRG)
+					.write(gtaoRG, ERGImageAccess::StorageWrite)
+					.asyncCompute(cVarAsyncComputeGTAO.get() != 0)
+					.sideEffect();
+
+				if (gtaoHistoryRG.isValid())
+				{
+					builder.read(gtaoHistoryRG);
+				}
+			},
+			[&](VkCommandBuffer cmd)
+			{
+				gtao = renderGTAO(cmd, &gbuffers, scene, perFrameGPU, hzbFurthest);
+				graph.setImage(gtaoRG, gtao);
+			});
+		}
 
-		SDSMInfos sdsmInfos{};
-		renderSDSM(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, sdsmInfos);
+		// Cascade fit only depend on depth, overlap with graphics work.
+		graph.addPass("SDSMCascade", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.read(rg.gbufferB)
+				.read(rg.gbufferS)
+				.write(sdsmCascadeRG, ERGBufferAccess::StorageWrite)
+				.write(sdsmRangeRG, ERGBufferAccess::StorageWrite)
+				.asyncCompute(cVarAsyncComputeSDSM.get() != 0);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderSDSMCascade(cmd, &gbuffers, scene, perFrameGPU, sdsmInfos);
+			graph.setBuffer(sdsmCascadeRG, sdsmInfos.cascadeInfoBuffer);
+			graph.setBuffer(sdsmRangeRG, sdsmInfos.rangeBuffer);
+		});
 
-		AtmosphereTextures atmosphereTextures{};
+		graph.addPass("SDSM", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.read(rg.gbufferB)
+				.read(rg.gbufferS)
+				.read(sdsmRangeRG)
+				.write(sdsmShadowDepthRG, ERGImageAccess::DepthAttachment)
+				.write(sdsmMaskRG, ERGImageAccess::StorageWrite)
+				.write(sdsmCascadeRG, ERGBufferAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderSDSM(cmd, &gbuffers, scene, perFrameGPU, sdsmInfos);
+			graph.setImage(sdsmShadowDepthRG, sdsmInfos.shadowDepths);
+			graph.setImage(sdsmMaskRG, sdsmInfos.mainViewMask);
+		});
 
-		if (m_renderer->getScene()->getSky() != nullptr)
+		if (scene->getSky() != nullptr)
 		{
-			renderAtmosphere(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, atmosphereTextures, &sdsmInfos, false);
-			renderSkylight(graphicsCmd, atmosphereTextures);
+			graph.addPass("AtmosphereLut", [&](RenderGraph::PassBuilder& builder)
+			{
+				builder
+					.read(rg.depthTexture)
+					.read(sdsmShadowDepthRG)
+					.read(sdsmCascadeRG)
+					.write(transmittanceRG, ERGImageAccess::StorageWrite)
+					.write(skyViewRG, ERGImageAccess::StorageWrite)
+					.write(multiScatterRG, ERGImageAccess::StorageWrite)
+					.write(froxelScatterRG, ERGImageAccess::StorageWrite)
+					.write(envCaptureRG, ERGImageAccess::StorageWrite);
+			},
+			[&](VkCommandBuffer cmd)
+			{
+				renderAtmosphere(cmd, &gbuffers, scene, perFrameGPU, atmosphereTextures, &sdsmInfos, false);
+				graph.setImage(transmittanceRG, atmosphereTextures.transmittance);
+				graph.setImage(skyViewRG, atmosphereTextures.skyView);
+				graph.setImage(multiScatterRG, atmosphereTextures.multiScatter);
+				graph.setImage(froxelScatterRG, atmosphereTextures.froxelScatter);
+				graph.setImage(envCaptureRG, atmosphereTextures.envCapture);
+			});
+
+			graph.addPass("Skylight", [&](RenderGraph::PassBuilder& builder)
+			{
+				readAtmosphere(builder);
+				builder
+					.write(skylightRadiance, ERGImageAccess::StorageWrite)
+					.write(skylightReflection, ERGImageAccess::StorageWrite)
+					.sideEffect();
+			},
+			[&](VkCommandBuffer cmd)
+			{
+				renderSkylight(cmd, atmosphereTextures);
+			});
 		}
 
-		
-
-		deferredLighting(
-			graphicsCmd, 
-			&gbuffers, 
-			m_renderer->getScene(), 
-			perFrameGPU, 
-			sdsmInfos.mainViewMask, 
-			atmosphereTextures, 
-			ssaoBentNormal,
-			sdsmInfos);
-
+		graph.addPass("DeferredLighting", [&](RenderGraph::PassBuilder& builder)
+		{
+			readAtmosphere(builder);
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.read(rg.gbufferB)
+				.read(rg.gbufferS)
+				.read(sdsmShadowDepthRG)
+				.read(sdsmMaskRG)
+				.read(sdsmCascadeRG)
+				.read(ssaoBentNormalRG)
+				.read(skylightRadiance)
+				.read(skylightReflection)
+				.write(rg.hdrSceneColor, ERGImageAccess::StorageWrite);
+
+			if (bGTAO)
+			{
+				builder.read(gtaoRG);
+			}
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			deferredLighting(cmd, &gbuffers, scene, perFrameGPU, sdsmInfos.mainViewMask, atmosphereTextures, ssaoBentNormal, gtao, sdsmInfos);
+		});
 
+		graph.addPass("AtmosphereComposite", [&](RenderGraph::PassBuilder& builder)
+		{
+			readAtmosphere(builder);
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.write(rg.hdrSceneColor, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderAtmosphere(cmd, &gbuffers, scene, perFrameGPU, atmosphereTextures, &sdsmInfos, true);
+		});
 
-		renderAtmosphere(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, atmosphereTextures, &sdsmInfos, true);
-		auto lensBuffer = renderVolumetricCloud(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, atmosphereTextures, sdsmInfos, hzbClosest);
+		// Cloud reconstruction history inside, never cull.
+		graph.addPass("VolumetricCloud", [&](RenderGraph::PassBuilder& builder)
+		{
+			readAtmosphere(builder);
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.read(hzbClosestRG)
+				.read(sdsmShadowDepthRG)
+				.read(sdsmCascadeRG)
+				.write(rg.hdrSceneColor, ERGImageAccess::StorageWrite)
+				.write(lensBufferRG, ERGBufferAccess::StorageWrite)
+				.asyncCompute(cVarAsyncComputeCloud.get() != 0)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			lensBuffer = renderVolumetricCloud(cmd, &gbuffers, scene, perFrameGPU, atmosphereTextures, sdsmInfos, hzbClosest);
+			graph.setBuffer(lensBufferRG, lensBuffer);
+		});
 
+		// Reflection history inside, never cull.
+		graph.addPass("SSSR", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.depthTexture)
+				.read(rg.gbufferA)
+				.read(rg.gbufferB)
+				.read(rg.gbufferS)
+				.read(rg.gbufferV)
+				.read(hzbClosestRG)
+				.read(ssaoBentNormalRG)
+				.read(skylightReflection)
+				.write(rg.hdrSceneColor, ERGImageAccess::StorageWrite)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderSSSR(cmd, &gbuffers, scene, perFrameGPU, hzbClosest, ssaoBentNormal);
+		});
 
+		graph.addPass("PMXOutline", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(averageLumRG)
+				.read(hzbFurthestRG)
+				.read(pmxBoundsRG)
+				.write(rg.hdrSceneColor, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferV, ERGImageAccess::ColorAttachment)
+				.write(rg.depthTexture, ERGImageAccess::DepthAttachment)
+				.write(rg.selectionOutlineMask, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderPMXOutline(cmd, &gbuffers, scene, perFrameGPU, pmxBounds, hzbFurthest);
+		});
 
-		renderSSSR(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, hzbClosest, ssaoBentNormal);
+		graph.addPass("PMXTranslucent", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(averageLumRG)
+				.read(hzbFurthestRG)
+				.read(pmxBoundsRG)
+				.write(rg.hdrSceneColor, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferV, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferUpscaleTranslucencyAndComposition, ERGImageAccess::ColorAttachment)
+				.write(rg.gbufferUpscaleReactive, ERGImageAccess::ColorAttachment)
+				.write(rg.idTexture, ERGImageAccess::ColorAttachment)
+				.write(rg.depthTexture, ERGImageAccess::DepthAttachment)
+				.write(rg.selectionOutlineMask, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderPMXTranslucent(cmd, &gbuffers, scene, perFrameGPU, pmxBounds, hzbFurthest);
+		});
 
-		renderPMXOutline(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU);
+		// Average luminance history inside, never cull.
+		graph.addPass("AdaptiveExposure", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.hdrSceneColorUpscale)
+				.write(averageLumRG, ERGImageAccess::StorageWrite)
+				.asyncCompute(cVarAsyncComputeExposure.get() != 0)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			adaptiveExposure(cmd, &gbuffers, scene, perFrameGPU, tickData);
+			graph.setImage(averageLumRG, m_averageLum);
+		});
 
+		graph.addPass("SelectionOutline", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.selectionOutlineMask)
+				.read(rg.idTexture)
+				.read(rg.hdrSceneColorUpscale)
+				.read(averageLumRG)
+				.write(rg.hdrSceneColor, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderSelectionOutline(cmd, &gbuffers, perFrameGPU);
+		});
 
-		renderPMXTranslucent(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU);
+		// FSR2 history inside, never cull.
+		graph.addPass("FSR2", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.hdrSceneColor)
+				.read(rg.gbufferV)
+				.read(rg.depthTexture)
+				.read(rg.gbufferUpscaleReactive)
+				.read(rg.gbufferUpscaleTranslucencyAndComposition)
+				.write(rg.hdrSceneColorUpscale, ERGImageAccess::StorageWrite)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderFSR2(cmd, &gbuffers, scene, perFrameGPU, tickData);
+		});
 
-		adaptiveExposure(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, tickData);
-		renderSelectionOutline(graphicsCmd, &gbuffers, perFrameGPU);
-		renderFSR2(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU, tickData);
-		auto bloomTex = renderBloom(graphicsCmd, &gbuffers, m_renderer->getScene(), perFrameGPU);
+		graph.addPass("Bloom", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.hdrSceneColorUpscale)
+				.read(averageLumRG)
+				.write(bloomTexRG, ERGImageAccess::StorageWrite)
+				.asyncCompute(cVarAsyncComputeBloom.get() != 0);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			bloomTex = renderBloom(cmd, &gbuffers, scene, perFrameGPU);
+			graph.setImage(bloomTexRG, bloomTex);
+		});
 
-		renderTonemapper(graphicsCmd, &gbuffers, perFrameGPU, m_renderer->getScene(), bloomTex, lensBuffer);
+		graph.addPass("Tonemapper", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.hdrSceneColorUpscale)
+				.read(bloomTexRG)
+				.read(lensBufferRG)
+				.write(displayOutput, ERGImageAccess::StorageWrite);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderTonemapper(cmd, &gbuffers, perFrameGPU, scene, bloomTex, lensBuffer);
+		});
 
-		renderGrid(graphicsCmd, &gbuffers, perFrameGPU);
+		graph.addPass("Grid", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.depthTexture)
+				.write(displayOutput, ERGImageAccess::ColorAttachment);
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			renderGrid(cmd, &gbuffers, perFrameGPU);
+		});
 
-		getPickPixelObject(graphicsCmd, &gbuffers);
+		// Pick readback to cpu.
+		graph.addPass("PickPixelObject", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder
+				.read(rg.idTexture)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			getPickPixelObject(cmd, &gbuffers);
+		});
 
 		// Final output layout transition.
-		getDisplayOutput().transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		if (m_displayDebug)
+		graph.addPass("DisplayOutput", [&](RenderGraph::PassBuilder& builder)
 		{
-			m_displayDebug->getImage().transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		}
+			builder
+				.read(displayOutput)
+				.sideEffect();
+		},
+		[&](VkCommandBuffer cmd)
+		{
+			if (m_displayDebug)
+			{
+				m_displayDebug->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+			}
+		});
+
+		// History for next frame.
+		graph.markOutput(rg.depthTexture);
+		graph.markOutput(rg.gbufferB);
+		graph.markOutput(rg.hdrSceneColor);
+
+		graph.execute(graphicsCmd);
 
 		// Update prev frame data.
 		m_prevDepth = gbuffers.depthTexture;
@@ -2,9 +2,43 @@
 #include "../render_scene.h"
 #include "../renderer.h"
 #include "../scene_textures.h"
+#include <util/cityhash/city.h>
 
 namespace engine
 {
+	static AutoCVarInt32 cVarAtmosphereLutRefreshRate(
+		"r.Atmosphere.LutRefreshRate",
+		"Frame interval of sky view and froxel lut refresh when sun or camera change, two luts refresh in staggered frames. 0 disable lut cache and update all luts every frame.",
+		"Atmosphere",
+		4,
+		CVarFlags::ReadAndWrite
+	);
+
+	// Transmittance and multi scatter lut only depend on atmosphere parameters, cloud and camera infos no include.
+	static uint64_t hashAtmosphereLutConfig(const AtmosphereConfig& config)
+	{
+		const size_t begin = offsetof(AtmosphereConfig, absorptionColor);
+		const size_t end = offsetof(AtmosphereConfig, cloudAreaStartHeight);
+		return CityHash64((const char*)&config + begin, end - begin);
+	}
+
+	// Sky view lut and env capture also depend on sun and camera position.
+	static uint64_t hashAtmosphereSkyInputs(const GPUPerFrameData& frameData, uint64_t lutHash)
+	{
+		struct
+		{
+			math::vec4 sunColor;
+			math::vec4 sunDirection;
+			math::vec4 camWorldPos;
+		} inputs;
+
+		inputs.sunColor = math::vec4(frameData.sky.color, frameData.sky.intensity);
+		inputs.sunDirection = math::vec4(frameData.sky.direction, frameData.sky.atmosphereConfig.atmospherePreExposure);
+		inputs.camWorldPos = frameData.camWorldPos;
+
+		return CityHash64WithSeed((const char*)&inputs, sizeof(inputs), lutHash);
+	}
+
 	class AtmospherePass : public PassInterface
 	{
 	public:
@@ -62,6 +96,8 @@ namespace engine
 		}
 	};
 
+	REGISTER_PASS(AtmospherePass)
+
 	FSR2Context* RendererInterface::getFSR2()
 	{
 		if (m_fsr2 == nullptr)
@@ -86,9 +122,13 @@ namespace engine
 			return;
 		}
 
-		if (!inout.isValid())
+		// Luts create once and keep across frames.
+		bool bNewLuts = false;
+		if (m_atmosphereTransmittance == nullptr)
 		{
-			inout.transmittance = getContext()->getRenderTargetPools().createPoolImage(
+			bNewLuts = true;
+
+			m_atmosphereTransmittance = getContext()->getRenderTargetPools().createPoolImage(
 				"AtmosphereTransmittance",
 				256, // Must can divide by 8.
 				64,  // Must can divide by 8.
@@ -96,7 +136,7 @@ namespace engine
 				VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
 			);
 
-			inout.skyView = getContext()->getRenderTargetPools().createPoolImage(
+			m_atmosphereSkyView = getContext()->getRenderTargetPools().createPoolImage(
 				"AtmosphereSkyView",
 				256,
 				256,
@@ -104,7 +144,7 @@ namespace engine
 				VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
 			);
 
-			inout.multiScatter = getContext()->getRenderTargetPools().createPoolImage(
+			m_atmosphereMultiScatter = getContext()->getRenderTargetPools().createPoolImage(
 				"AtmosphereMultiScatter",
 				32,  // Must can divide by 8.
 				32,  // Must can divide by 8.
@@ -112,7 +152,7 @@ namespace engine
 				VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
 			);
 
-			inout.froxelScatter = getContext()->getRenderTargetPools().createPoolImage(
+			m_atmosphereFroxelScatter = getContext()->getRenderTargetPools().createPoolImage(
 				"AtmosphereFroxelScatter",
 				32,  // Must can divide by 8.
 				32,  // Must can divide by 8.
@@ -122,7 +162,7 @@ namespace engine
 				32 // Depth
 			);
 
-			inout.envCapture = getContext()->getRenderTargetPools().createPoolCubeImage(
+			m_atmosphereEnvCapture = getContext()->getRenderTargetPools().createPoolCubeImage(
 				"AtmosphereEnvCapture",
 				128,  // Must can divide by 8.
 				128,  // Must can divide by 8.
@@ -132,6 +172,15 @@ namespace engine
 			);
 		}
 
+		if (!inout.isValid())
+		{
+			inout.transmittance = m_atmosphereTransmittance;
+			inout.skyView = m_atmosphereSkyView;
+			inout.multiScatter = m_atmosphereMultiScatter;
+			inout.froxelScatter = m_atmosphereFroxelScatter;
+			inout.envCapture = m_atmosphereEnvCapture;
+		}
+
 		auto& tansmittanceLut = inout.transmittance->getImage();
 		auto& skyViewLut = inout.skyView->getImage();
 		auto& multiScatterLut = inout.multiScatter->getImage();
@@ -194,11 +243,30 @@ namespace engine
 		{
 			ScopePerframeMarker marker(cmd, "Atmosphere Luts", { 1.0f, 1.0f, 0.0f, 1.0f });
 
+			const GPUPerFrameData& frameData = m_cacheGPUPerFrameData;
+			const uint64_t lutHash = hashAtmosphereLutConfig(frameData.sky.atmosphereConfig);
+			const uint64_t skyHash = hashAtmosphereSkyInputs(frameData, lutHash);
+			const uint64_t viewHash = CityHash64((const char*)&frameData.camViewProjNoJitter, sizeof(frameData.camViewProjNoJitter));
+
+			// Sky view and froxel lut refresh in different frames of one period, amortize cost when sun or camera keep moving.
+			const int32_t refreshRate = cVarAtmosphereLutRefreshRate.get();
+			const uint32_t refreshPeriod = uint32_t(std::max(refreshRate, 1));
+			const bool bSkyViewSlot = (m_tickCount % refreshPeriod) == 0;
+			const bool bFroxelSlot = (m_tickCount % refreshPeriod) == (refreshPeriod / 2);
+
+			const bool bUpdateAll = bNewLuts || (refreshRate <= 0) || (frameData.bCameraCut != 0);
+			const bool bUpdateTransmittance = bUpdateAll || (lutHash != m_atmosphereLutHash);
+			const bool bUpdateSkyView = bUpdateTransmittance || (bSkyViewSlot && (skyHash != m_atmosphereSkyViewHash));
+
+			// Froxel lut store in view space, stale one mismatch with current view, so refresh immediately when view change.
+			const bool bUpdateFroxel = bUpdateTransmittance || (viewHash != m_atmosphereFroxelViewHash) || (bFroxelSlot && (skyHash != m_atmosphereFroxelSkyHash));
+
+			sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
 
 			// Pass #0. tansmittance lut.
+			if (bUpdateTransmittance)
 			{
 				tansmittanceLut.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-				sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
 
 				pass->transmittanceLutPipe->bind(cmd);
 				setBuilder.push(pass->transmittanceLutPipe.get());
@@ -208,6 +276,7 @@ namespace engine
 			}
 
 			// Pass #1. multi scatter lut.
+			if (bUpdateTransmittance)
 			{
 				multiScatterLut.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
 
@@ -219,6 +288,7 @@ namespace engine
 			}
 
 			// Pass #2. sky view lut.
+			if (bUpdateSkyView)
 			{
 				skyViewLut.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
 
@@ -230,6 +300,7 @@ namespace engine
 			}
 
 			// Pass #3. froxel lut.
+			if (bUpdateFroxel)
 			{
 				froxelScatterLut.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
 
@@ -241,9 +312,9 @@ namespace engine
 				froxelScatterLut.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
 			}
 
-			// Capture pass.
+			// Capture pass, input same as sky view lut.
+			if (bUpdateSkyView)
 			{
-
 				envCapture.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, captureViewRange);
 
 				pass->capturePipe->bind(cmd);
@@ -254,6 +325,23 @@ namespace engine
 					getGroupCount(envCapture.getExtent().width, 8),
 					getGroupCount(envCapture.getExtent().height, 8), 6);
 				envCapture.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, captureViewRange);
+
+				// Skylight filter one face per frame, all faces need refilter.
+				m_skylightPendingFaces = 6;
+			}
+
+			if (bUpdateTransmittance)
+			{
+				m_atmosphereLutHash = lutHash;
+			}
+			if (bUpdateSkyView)
+			{
+				m_atmosphereSkyViewHash = skyHash;
+			}
+			if (bUpdateFroxel)
+			{
+				m_atmosphereFroxelSkyHash = skyHash;
+				m_atmosphereFroxelViewHash = viewHash;
 			}
 
 			m_gpuTimer.getTimeStamp(cmd, "SkyPrepare");
@@ -304,8 +392,17 @@ namespace engine
 		}
 	};
 
+	REGISTER_PASS(SkylightPass)
+
 	void RendererInterface::renderSkylight(VkCommandBuffer cmd, const AtmosphereTextures& inAtmosphere)
 	{
+		// Env capture no change since all faces filtered, keep skylight result.
+		if (m_skylightPendingFaces == 0)
+		{
+			return;
+		}
+		m_skylightPendingFaces --;
+
 		// Update index of face id.
 		m_skylightUpdateFaceIndex ++;
 		m_skylightUpdateFaceIndex = m_skylightUpdateFaceIndex % 6;
@@ -62,6 +62,8 @@ namespace engine
 		}
 	};
 
+	REGISTER_PASS(BloomPass)
+
     PoolImageSharedRef RendererInterface::renderBloom(
 		VkCommandBuffer cmd,
 		GBufferTextures* inGBuffers,
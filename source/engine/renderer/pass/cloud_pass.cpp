@@ -102,6 +102,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(CloudPass)
+
     BufferParameterHandle RendererInterface::renderVolumetricCloud(VkCommandBuffer cmd, GBufferTextures* inGBuffers, RenderScene* scene, BufferParameterHandle perFrameGPU, AtmosphereTextures& inAtmosphere, SDSMInfos& sdsmInfo, PoolImageSharedRef hiz)
     {
         auto& sdsmDepth = sdsmInfo.shadowDepths;
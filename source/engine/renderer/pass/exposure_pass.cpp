@@ -55,6 +55,8 @@ namespace engine
 		}
 	};
 
+	REGISTER_PASS(ExposurePass)
+
 	void RendererInterface::adaptiveExposure(
 		VkCommandBuffer cmd,
 		GBufferTextures* inGBuffers,
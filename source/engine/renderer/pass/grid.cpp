@@ -56,6 +56,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(GridPass)
+
 	void RendererInterface::renderGrid(
         VkCommandBuffer cmd, 
         GBufferTextures* inGBuffers, 
@@ -62,6 +62,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(GtaoPass)
+
     PoolImageSharedRef RendererInterface::renderGTAO(
         VkCommandBuffer cmd,
         GBufferTextures* inGBuffers,
@@ -37,6 +37,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(HzbPass)
+
 
 	void RendererInterface::renderHzb(
         PoolImageSharedRef& outClosed,
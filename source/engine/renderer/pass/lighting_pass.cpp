@@ -50,12 +50,13 @@ namespace engine
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 6) // inFrameData
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 7) // inBRDFLut
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 8) // inTransmittanceLut
-                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 9) // inGTAO
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 9) // inSSAO
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 10) // inSkylight
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 11) // inSDSMShadowMask
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 12) // Hdr
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 13) // inSDSMShadowMask
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 14) // inSDSMShadowMask
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 15) // inGTAO
                 .buildNoInfoPush(setLayout);
 
             pipe = std::make_unique<ComputePipeResources>("shader/deferred_lighting.comp.spv", 0, 
@@ -121,6 +122,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(LightingPass)
+
     void engine::RendererInterface::deferredLighting(
         VkCommandBuffer cmd, 
         GBufferTextures* inGBuffers, 
@@ -129,6 +132,7 @@ namespace engine
         PoolImageSharedRef inSDSMMask,
         AtmosphereTextures& atmosphere,
         PoolImageSharedRef inBentNormalSSAO,
+        PoolImageSharedRef inGTAO,
         SDSMInfos& sdsmInfo)
     {
         auto& hdrSceneColor = inGBuffers->hdrSceneColor->getImage();
@@ -227,6 +231,7 @@ namespace engine
                 .addUAV(hdrDiffuseSSSS)
                 .addSRV(getContext()->getEngineTextureSkinLut()->getImage())
                 .addSRV(getContext()->getEngineTextureSkinLutShadow()->getImage())
+                .addSRV(inGTAO ? inGTAO->getImage() : m_context->getEngineTextureWhite()->getImage())
                 .push(pass->pipe.get());
 
             pass->pipe->bindSet(cmd, std::vector<VkDescriptorSet>{
@@ -34,6 +34,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(PickPass)
+
 
     void RendererInterface::getPickPixelObject(VkCommandBuffer cmd, GBufferTextures* inGBuffers)
     {
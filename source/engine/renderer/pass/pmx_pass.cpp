@@ -3,8 +3,14 @@
 #include "../renderer.h"
 #include "../scene_textures.h"
 
+#include <glm/gtx/dual_quaternion.hpp>
+
 namespace engine
 {
+	struct PMXSkinningPushConsts
+	{
+		uint32_t vertexCount;
+	};
 
 	struct PMXSDSMPushConsts
 	{
@@ -13,6 +19,21 @@ namespace engine
 		uint32_t   cascadeId;
 	};
 
+	struct PMXCullPushConsts
+	{
+		uint32_t cullCount;
+		uint32_t bTranslucent;
+		uint32_t bHzbCull;
+		uint32_t hzbMipCount;
+		math::vec2 hzbSrcSize;
+	};
+
+	// Submesh local bounds, min and inverted max encode as ordered uint, see shader/pmx/pmx_common.glsl.
+	constexpr size_t kPMXSubmeshBoundsSize = sizeof(uint32_t) * 8;
+
+	// Max workgroup count of one submesh in bounds pass, workgroups loop whole index range.
+	constexpr uint32_t kPMXBoundsMaxGroupCountX = 16;
+
 
 	class PMXPass : public PassInterface
 	{
@@ -22,14 +43,52 @@ namespace engine
 		std::unique_ptr<GraphicPipeResources> pmxOutlinePass;
 		std::unique_ptr<GraphicPipeResources> pmxTranslucencyPass;
 
+		VkDescriptorSetLayout boundsSetLayout = VK_NULL_HANDLE;
+		std::unique_ptr<ComputePipeResources> boundsPipe;
+
+		VkDescriptorSetLayout cullSetLayout = VK_NULL_HANDLE;
+		std::unique_ptr<ComputePipeResources> cullPipe;
+
 	protected:
 		virtual void onInit() override
 		{
+			{
+				getContext()->descriptorFactoryBegin()
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 0) // pmxSubmeshes
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // submeshBounds
+					.buildNoInfoPush(boundsSetLayout);
+
+				boundsPipe = std::make_unique<ComputePipeResources>("shader/pmx_bounds.comp.spv", 0,
+					std::vector<VkDescriptorSetLayout>
+					{
+						  boundsSetLayout
+						, getContext()->getBindlessSSBOSetLayout()
+						, getContext()->getBindlessSSBOSetLayout()
+					});
+
+				getContext()->descriptorFactoryBegin()
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kCommonShaderStage, 0) // frameData
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // pmxSubmeshes
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 2) // submeshBounds
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // indirectCommands
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 4) // drawCount
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  kCommonShaderStage, 5) // inHzb
+					.buildNoInfoPush(cullSetLayout);
+
+				cullPipe = std::make_unique<ComputePipeResources>("shader/pmx_cull.comp.spv", (uint32_t)sizeof(PMXCullPushConsts),
+					std::vector<VkDescriptorSetLayout>
+					{
+						cullSetLayout
+					});
+			}
+
 			{
 				getContext()->descriptorFactoryBegin()
 					.bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kCommonShaderStage, 0) // frameData
-					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kCommonShaderStage, 1) // frameData
-					.bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, kCommonShaderStage, 2) // frameData
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kCommonShaderStage, 1) // selectionMask
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, kCommonShaderStage, 2) // adaptedLum
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // pmxSubmeshes
+					.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 4) // indirectCommands
 					.buildNoInfoPush(frameDataSetLayout);
 
 				std::vector<VkDescriptorSetLayout> commonLayouts =
@@ -38,10 +97,8 @@ namespace engine
 					getContext()->getSamplerCache().getCommonDescriptorSetLayout(),
 					getRenderer()->getBlueNoise().spp_1_buffer.setLayouts,
 					getContext()->getBindlessTextureSetLayout(),
-										getContext()->getBindlessSSBOSetLayout()
-					, getContext()->getBindlessSSBOSetLayout(),
-					getContext()->getDynamicUniformBuffers().getSetlayout(),
-
+					getContext()->getBindlessSSBOSetLayout(),
+					getContext()->getBindlessSSBOSetLayout(),
 				};
 
 				pmxPass = std::make_unique<GraphicPipeResources>(
@@ -140,20 +197,236 @@ namespace engine
 			pmxPass.reset();
 			pmxTranslucencyPass.reset();
 			pmxOutlinePass.reset();
+
+			boundsPipe.reset();
+			cullPipe.reset();
+		}
+	};
+
+	REGISTER_PASS(PMXPass)
+
+	class PMXSkinningPass : public PassInterface
+	{
+	public:
+		VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+		std::unique_ptr<ComputePipeResources> skinningPipe;
+
+	protected:
+		virtual void onInit() override
+		{
+			getContext()->descriptorFactoryBegin()
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 0) // vertices
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // bones
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 2) // morphPositions
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // morphUVs
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 4) // outPositions
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 5) // outNormals
+				.bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 6) // outUVs
+				.buildNoInfoPush(setLayout);
+
+			skinningPipe = std::make_unique<ComputePipeResources>("shader/pmx_skinning.comp.spv", (uint32_t)sizeof(PMXSkinningPushConsts),
+				std::vector<VkDescriptorSetLayout>
+				{
+					setLayout
+				});
+		}
+
+		virtual void release() override
+		{
+			skinningPipe.reset();
 		}
 	};
 
+	REGISTER_PASS(PMXSkinningPass)
+
+	BufferParameterHandle RendererInterface::renderPMXSubmeshBounds(VkCommandBuffer cmd, RenderScene* scene)
+	{
+		const auto& submeshes = scene->getPMXSubmeshes();
+		const uint32_t submeshCount = (uint32_t)submeshes.size();
+		if (!scene->isPMXExist() || submeshCount == 0)
+		{
+			return nullptr;
+		}
+
+		auto* pass = m_context->getPasses().get<PMXPass>();
+		auto boundsBuffer = m_context->getBufferParameters().getIndirectStorage("PMXSubmeshBounds", kPMXSubmeshBoundsSize * submeshCount);
+
+		uint32_t maxIndexCount = 0;
+		for (const auto& submesh : submeshes)
+		{
+			maxIndexCount = std::max(maxIndexCount, submesh.indexCount);
+		}
+
+		{
+			ScopePerframeMarker marker(cmd, "PMXSubmeshBounds", { 1.0f, 0.0f, 0.0f, 1.0f });
+
+			// All bounds component atomic min, clear to max.
+			vkCmdFillBuffer(cmd, *boundsBuffer->getBuffer(), 0, boundsBuffer->getBuffer()->getSize(), ~0U);
+
+			auto fillBarrier = RHIBufferBarrier(boundsBuffer->getBuffer()->getVkBuffer(),
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+			RHIPipelineBarrier(cmd, 0, 1, &fillBarrier, 0, nullptr);
+
+			pass->boundsPipe->bind(cmd);
+			PushSetBuilder(cmd)
+				.addBuffer(scene->getPMXSubmeshesGPU())
+				.addBuffer(boundsBuffer)
+				.push(pass->boundsPipe.get());
+			pass->boundsPipe->bindSet(cmd, std::vector<VkDescriptorSet>
+			{
+				m_context->getBindlessSSBOSet(),
+				m_context->getBindlessSSBOSet()
+			}, 1);
+
+			const uint32_t groupCountX = std::clamp(getGroupCount(maxIndexCount, 64), 1U, kPMXBoundsMaxGroupCountX);
+			vkCmdDispatch(cmd, groupCountX, submeshCount, 1);
+		}
+
+		m_gpuTimer.getTimeStamp(cmd, "pmx bounds");
+		return boundsBuffer;
+	}
+
+	// Cull pmx submeshes of one pass, output indirect draw commands and draw count.
+	// Hzb culling skip when hzbFurthest is null.
+	static void cullPMXSubmeshes(
+		VkCommandBuffer cmd,
+		const char* name,
+		RenderScene* scene,
+		BufferParameterHandle perFrameGPU,
+		BufferParameterHandle submeshBounds,
+		PoolImageSharedRef hzbFurthest,
+		bool bTranslucent,
+		BufferParameterHandle& outDrawCommands,
+		BufferParameterHandle& outDrawCount)
+	{
+		auto* pass = getContext()->getPasses().get<PMXPass>();
+		const uint32_t submeshCount = (uint32_t)scene->getPMXSubmeshes().size();
+
+		outDrawCommands = getContext()->getBufferParameters().getIndirectStorage("PMXIndirectCommand", sizeof(GPUStaticMeshDrawCommand) * submeshCount);
+		outDrawCount = getContext()->getBufferParameters().getIndirectStorage("PMXIndirectCount", sizeof(uint32_t));
+
+		ScopePerframeMarker marker(cmd, name, { 1.0f, 0.0f, 0.0f, 1.0f });
+
+		vkCmdFillBuffer(cmd, *outDrawCount->getBuffer(), 0, outDrawCount->getBuffer()->getSize(), 0u);
+
+		std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+		{
+			RHIBufferBarrier(outDrawCommands->getBuffer()->getVkBuffer(),
+				VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT),
+			RHIBufferBarrier(outDrawCount->getBuffer()->getVkBuffer(),
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+		};
+		RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
+
+		PMXCullPushConsts pushConst
+		{
+			.cullCount = submeshCount,
+			.bTranslucent = bTranslucent ? 1U : 0U,
+			.bHzbCull = hzbFurthest ? 1U : 0U,
+		};
+
+		// Hzb unused when no hzb, still bind some valid image.
+		auto& hzbImage = hzbFurthest ? hzbFurthest->getImage() : getContext()->getEngineTextureWhite()->getImage();
+		if (hzbFurthest)
+		{
+			pushConst.hzbMipCount = hzbImage.getInfo().mipLevels;
+			pushConst.hzbSrcSize = math::vec2(hzbImage.getExtent().width, hzbImage.getExtent().height);
+			hzbImage.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+		}
+
+		pass->cullPipe->bindAndPushConst(cmd, &pushConst);
+		PushSetBuilder(cmd)
+			.addBuffer(perFrameGPU)
+			.addBuffer(scene->getPMXSubmeshesGPU())
+			.addBuffer(submeshBounds)
+			.addBuffer(outDrawCommands)
+			.addBuffer(outDrawCount)
+			.addSRV(hzbImage)
+			.push(pass->cullPipe.get());
+
+		vkCmdDispatch(cmd, getGroupCount(submeshCount, 64), 1, 1);
+
+		std::array<VkBufferMemoryBarrier2, 2> endBarriers
+		{
+			RHIBufferBarrier(outDrawCommands->getBuffer()->getVkBuffer(),
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT),
+			RHIBufferBarrier(outDrawCount->getBuffer()->getVkBuffer(),
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+		};
+		RHIPipelineBarrier(cmd, 0, (uint32_t)endBarriers.size(), endBarriers.data(), 0, nullptr);
+	}
+
+	// Draw culled pmx submeshes of one pipeline with single indirect draw.
+	static void drawPMXIndirect(
+		VkCommandBuffer cmd,
+		const char* name,
+		RenderScene* scene,
+		BufferParameterHandle perFrameGPU,
+		GraphicPipeResources* pipe,
+		VulkanImage& selectionMask,
+		VulkanImage& averageLum,
+		VulkanImage& sceneDepthZ,
+		const std::vector<VulkanImage*>& colorImages,
+		BufferParameterHandle drawCommands,
+		BufferParameterHandle drawCount)
+	{
+		ColorAttachmentsBuilder colorBuilder;
+		for (auto* image : colorImages)
+		{
+			colorBuilder.add(*image, VK_ATTACHMENT_LOAD_OP_LOAD);
+		}
+		VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE);
+
+		ScopeRenderCmdObject renderCmdScope(cmd, name, sceneDepthZ, colorBuilder.result, depthAttachment);
+
+		pipe->bind(cmd);
+		PushSetBuilder(cmd)
+			.addBuffer(perFrameGPU)
+			.addUAV(selectionMask)
+			.addSRV(averageLum)
+			.addBuffer(scene->getPMXSubmeshesGPU())
+			.addBuffer(drawCommands)
+			.push(pipe);
+
+		pipe->bindSet(cmd, std::vector<VkDescriptorSet>
+		{
+			getContext()->getSamplerCache().getCommonDescriptorSet(),
+			getRenderer()->getBlueNoise().spp_1_buffer.set,
+			getContext()->getBindlessTextureSet(),
+			getContext()->getBindlessSSBOSet(),
+			getContext()->getBindlessSSBOSet()
+		}, 1);
+
+		vkCmdDrawIndirectCount(cmd,
+			drawCommands->getBuffer()->getVkBuffer(), 0,
+			drawCount->getBuffer()->getVkBuffer(), 0,
+			(uint32_t)scene->getPMXSubmeshes().size(),
+			sizeof(GPUStaticMeshDrawCommand));
+	}
+
 	void RendererInterface::renderPMXTranslucent(
 		VkCommandBuffer cmd, 
 		GBufferTextures* inGBuffers, 
 		RenderScene* scene, 
-		BufferParameterHandle perFrameGPU)
+		BufferParameterHandle perFrameGPU,
+		BufferParameterHandle submeshBounds,
+		PoolImageSharedRef hzbFurthest)
 	{
-		if (!scene->isPMXExist())
+		if (!scene->isPMXExist() || !submeshBounds)
 		{
 			return;
 		}
 		auto* pass = m_context->getPasses().get<PMXPass>();
+
+		BufferParameterHandle drawCommands;
+		BufferParameterHandle drawCount;
+		cullPMXSubmeshes(cmd, "PMXTranslucentCulling", scene, perFrameGPU, submeshBounds, hzbFurthest, true, drawCommands, drawCount);
+
 		auto& hdrSceneColor = inGBuffers->hdrSceneColor->getImage();
 		auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
 		auto& gbufferComposition = inGBuffers->gbufferUpscaleTranslucencyAndComposition->getImage();
@@ -170,41 +443,12 @@ namespace engine
 		idTexture.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 		gbufferV.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 
-		std::vector<VkRenderingAttachmentInfo> colorAttachments = ColorAttachmentsBuilder()
-			.add(hdrSceneColor, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferUpscaleMask, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferComposition, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(idTexture, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferV, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.result;
-
-		VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE);
-		{
-			ScopeRenderCmdObject renderCmdScope(cmd, "PMX translucent", sceneDepthZ, colorAttachments, depthAttachment);
-			pass->pmxTranslucencyPass->bind(cmd);
-
-			PushSetBuilder(cmd)
-				.addBuffer(perFrameGPU)
-				.addUAV(selectionMask)
-				.addSRV(m_averageLum ? m_averageLum->getImage() : getContext()->getEngineTextureWhite()->getImage())
-				.push(pass->pmxTranslucencyPass.get());
-
-			pass->pmxTranslucencyPass->bindSet(cmd, std::vector<VkDescriptorSet>
-			{
-				getContext()->getSamplerCache().getCommonDescriptorSet(),
-				getRenderer()->getBlueNoise().spp_1_buffer.set,
-				getContext()->getBindlessTextureSet(),
-					m_context->getBindlessSSBOSet()
-					, m_context->getBindlessSSBOSet()
-			}, 1);
-
-			const auto& pmxes = scene->getPMXes();
-			for (const auto& pmx : pmxes)
-			{
-				pmx.lock()->onRenderCollect(this, cmd, pass->pmxTranslucencyPass->pipelineLayout, true);
-			}
-
-		}
+		drawPMXIndirect(cmd, "PMX translucent", scene, perFrameGPU, pass->pmxTranslucencyPass.get(),
+			selectionMask,
+			m_averageLum ? m_averageLum->getImage() : getContext()->getEngineTextureWhite()->getImage(),
+			sceneDepthZ,
+			{ &hdrSceneColor, &gbufferUpscaleMask, &gbufferComposition, &idTexture, &gbufferV },
+			drawCommands, drawCount);
 
 		selectionMask.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 		hdrSceneColor.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
@@ -221,15 +465,21 @@ namespace engine
 		VkCommandBuffer cmd, 
 		GBufferTextures* inGBuffers, 
 		RenderScene* scene, 
-		BufferParameterHandle perFrameGPU)
+		BufferParameterHandle perFrameGPU,
+		BufferParameterHandle submeshBounds)
 	{
-		if (!scene->isPMXExist())
+		if (!scene->isPMXExist() || !submeshBounds)
 		{
 			return;
 		}
 
 		auto* pass = m_context->getPasses().get<PMXPass>();
 
+		// Hzb build after pmx gbuffer, only frustum culling.
+		BufferParameterHandle drawCommands;
+		BufferParameterHandle drawCount;
+		cullPMXSubmeshes(cmd, "PMXGBufferCulling", scene, perFrameGPU, submeshBounds, nullptr, false, drawCommands, drawCount);
+
 		auto& hdrSceneColor = inGBuffers->hdrSceneColor->getImage();
 		auto& gbufferA = inGBuffers->gbufferA->getImage();
 		auto& gbufferB = inGBuffers->gbufferB->getImage();
@@ -252,44 +502,12 @@ namespace engine
 		gbufferUpscaleMask.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 		idTexture.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 
-		std::vector<VkRenderingAttachmentInfo> colorAttachments = ColorAttachmentsBuilder()
-			.add(hdrSceneColor, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferA, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferB, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferS, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferV, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(idTexture, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferUpscaleMask, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferComposition, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.result;
-		VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE);
-
-		{
-			ScopeRenderCmdObject renderCmdScope(cmd, "PMXGBuffer", sceneDepthZ, colorAttachments, depthAttachment);
-			pass->pmxPass->bind(cmd);
-
-			PushSetBuilder(cmd)
-				.addBuffer(perFrameGPU)
-				.addUAV(selectionMask)
-				.addSRV(m_averageLum ? m_averageLum->getImage() : getContext()->getEngineTextureWhite()->getImage())
-				.push(pass->pmxPass.get());
-
-			pass->pmxPass->bindSet(cmd, std::vector<VkDescriptorSet>
-			{
-				getContext()->getSamplerCache().getCommonDescriptorSet(),
-				getRenderer()->getBlueNoise().spp_1_buffer.set,
-				getContext()->getBindlessTextureSet(),
-					m_context->getBindlessSSBOSet()
-					, m_context->getBindlessSSBOSet()
-			}, 1);
-
-			const auto& pmxes = scene->getPMXes();
-			for (const auto& pmx : pmxes)
-			{
-				pmx.lock()->onRenderCollect(this, cmd, pass->pmxPass->pipelineLayout, false);
-			}
-
-		}
+		drawPMXIndirect(cmd, "PMXGBuffer", scene, perFrameGPU, pass->pmxPass.get(),
+			selectionMask,
+			m_averageLum ? m_averageLum->getImage() : getContext()->getEngineTextureWhite()->getImage(),
+			sceneDepthZ,
+			{ &hdrSceneColor, &gbufferA, &gbufferB, &gbufferS, &gbufferV, &idTexture, &gbufferUpscaleMask, &gbufferComposition },
+			drawCommands, drawCount);
 
 		selectionMask.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 		hdrSceneColor.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
@@ -305,15 +523,26 @@ namespace engine
 		m_gpuTimer.getTimeStamp(cmd, "pmx gbuffer");
 	}
 
-	void RendererInterface::renderPMXOutline(VkCommandBuffer cmd, GBufferTextures* inGBuffers, RenderScene* scene, BufferParameterHandle perFrameGPU)
+	void RendererInterface::renderPMXOutline(
+		VkCommandBuffer cmd, 
+		GBufferTextures* inGBuffers, 
+		RenderScene* scene, 
+		BufferParameterHandle perFrameGPU,
+		BufferParameterHandle submeshBounds,
+		PoolImageSharedRef hzbFurthest)
 	{
-		if (!scene->isPMXExist())
+		if (!scene->isPMXExist() || !submeshBounds)
 		{
 			return;
 		}
 
 		auto* pass = m_context->getPasses().get<PMXPass>();
 
+		// Submesh self depth inside hzb no occlude its outline, hzb culling safe.
+		BufferParameterHandle drawCommands;
+		BufferParameterHandle drawCount;
+		cullPMXSubmeshes(cmd, "PMXOutlineCulling", scene, perFrameGPU, submeshBounds, hzbFurthest, false, drawCommands, drawCount);
+
 		auto& hdrSceneColor = inGBuffers->hdrSceneColor->getImage();
 		auto& gbufferV = inGBuffers->gbufferV->getImage();
 		auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
@@ -324,40 +553,12 @@ namespace engine
 		gbufferV.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 		sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
 
-		std::vector<VkRenderingAttachmentInfo> colorAttachments = ColorAttachmentsBuilder()
-			.add(hdrSceneColor, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.add(gbufferV, VK_ATTACHMENT_LOAD_OP_LOAD)
-			.result;
-		VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE);
-
-
-
-		{
-			ScopeRenderCmdObject renderCmdScope(cmd, "PMXOutline", sceneDepthZ, colorAttachments, depthAttachment);
-			pass->pmxOutlinePass->bind(cmd);
-
-			PushSetBuilder(cmd)
-				.addBuffer(perFrameGPU)
-				.addUAV(selectionMask)
-				.addSRV(m_averageLum ? m_averageLum->getImage() : getContext()->getEngineTextureWhite()->getImage())
-				.push(pass->pmxOutlinePass.get());
-
-			pass->pmxOutlinePass->bindSet(cmd, std::vector<VkDescriptorSet>
-			{
-				getContext()->getSamplerCache().getCommonDescriptorSet(),
-					getRenderer()->getBlueNoise().spp_1_buffer.set,
-					getContext()->getBindlessTextureSet(),
-					m_context->getBindlessSSBOSet()
-					, m_context->getBindlessSSBOSet()
-			}, 1);
-
-			const auto& pmxes = scene->getPMXes();
-			for (const auto& pmx : pmxes)
-			{
-				pmx.lock()->onRenderCollect(this, cmd, pass->pmxOutlinePass->pipelineLayout, false);
-			}
-
-		}
+		drawPMXIndirect(cmd, "PMXOutline", scene, perFrameGPU, pass->pmxOutlinePass.get(),
+			selectionMask,
+			m_averageLum ? m_averageLum->getImage() : getContext()->getEngineTextureWhite()->getImage(),
+			sceneDepthZ,
+			{ &hdrSceneColor, &gbufferV },
+			drawCommands, drawCount);
 
 		selectionMask.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 		hdrSceneColor.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
@@ -368,31 +569,8 @@ namespace engine
 	}
 
 
-	void PMXComponent::onRenderCollect(
-		RendererInterface* renderer, 
-		VkCommandBuffer cmd, 
-		VkPipelineLayout pipelinelayout, 
-		bool bTranslucentPass)
-	{
-		if (!m_proxy || !m_proxy->isInit())
-		{
-			return;
-		}
-
-		if (auto node = m_node.lock())
-		{
-			const auto& modelMatrix = node->getTransform()->getWorldMatrix();
-			const auto& modelMatrixPrev = node->getTransform()->getPrevWorldMatrix();
-
-			m_proxy->onRenderCollect(
-				renderer, cmd, pipelinelayout, modelMatrix, modelMatrixPrev, bTranslucentPass, node->getId(),
-				Editor::get()->getSceneNodeSelections().isSelected(SceneNodeSelctor(getNode())));
-		}
-	}
-
-
 	void PMXComponent::onRenderTick(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd, 
-		std::vector<GPUStaticMeshPerObjectData>& collector, std::vector<VkAccelerationStructureInstanceKHR>& asInstances)
+		std::vector<GPUStaticMeshPerObjectData>& collector, std::vector<PMXGpuSubmesh>& pmxCollector, std::vector<VkAccelerationStructureInstanceKHR>& asInstances)
 	{
 		m_dtSum += tickData.deltaTime;
 
@@ -406,7 +584,11 @@ namespace engine
 
 			// if (m_dtSum > kDt)
 			{
-				m_proxy->updateAnimation(tickData.gameTime, tickData.deltaTime);
+				m_proxy->setCPUPositionsRequested(m_bCPUPositionsRequested);
+				if (!m_proxy->waitAnimationJob())
+				{
+					m_proxy->updateAnimation(tickData.gameTime, tickData.deltaTime);
+				}
 
 				m_proxy->updateVertex(cmd);
 
@@ -418,51 +600,39 @@ namespace engine
 				m_dtSum = 0.0f;
 			}
 
-			m_proxy->collectObjectInfos(collector, asInstances, node->getId(), Editor::get()->getSceneNodeSelections().isSelected(SceneNodeSelctor(getNode())),
-				modelMatrix, modelMatrixPrev);
+			const bool bSelected = Editor::get()->getSceneNodeSelections().isSelected(SceneNodeSelctor(getNode()));
+
+			m_proxy->collectObjectInfos(collector, asInstances, node->getId(), bSelected, modelMatrix, modelMatrixPrev);
+			m_proxy->collectSubmeshes(pmxCollector, node->getId(), bSelected, modelMatrix, modelMatrixPrev);
 		}
 	}
 
 
 
-	void PMXMeshProxy::onRenderCollect(
-		RendererInterface* renderer, 
-		VkCommandBuffer cmd, 
-		VkPipelineLayout pipelinelayout, 
-		const glm::mat4& modelMatrix, 
-		const glm::mat4& modelMatrixPrev, 
-		bool bTranslucentPass,
+	void PMXMeshProxy::collectSubmeshes(
+		std::vector<PMXGpuSubmesh>& collector,
 		uint32_t sceneNodeId,
-		bool bSelected)
+		bool bSelected,
+		const glm::mat4& modelMatrix,
+		const glm::mat4& modelMatrixPrev)
 	{
-		// then draw every submesh.
 		size_t subMeshCount = m_mmdModel->GetSubMeshCount();
 		for (uint32_t i = 0; i < subMeshCount; i++)
 		{
 			const auto& subMesh = m_mmdModel->GetSubMeshes()[i];
 			const auto& material = m_pmxAsset->getMaterials().at(subMesh.m_materialID);
 
-			if (material.bHide)
+			if (material.bHide || subMesh.m_vertexCount == 0)
 			{
 				continue;
 			}
 
-			bool bShouldDraw = true;
-			if (bTranslucentPass)
-			{
-				bShouldDraw = material.bTranslucent;
-			}
-			else
-			{
-				bShouldDraw = !material.bTranslucent;
-			}
+			PMXGpuSubmesh submesh{};
+			submesh.indexStart = subMesh.m_beginIndex;
+			submesh.indexCount = subMesh.m_vertexCount;
+			submesh.bTranslucent = material.bTranslucent ? 1 : 0;
 
-			if (!bShouldDraw)
-			{
-				continue;
-			}
-
-			PMXGpuParams params{};
+			auto& params = submesh.params;
 			params.modelMatrix = modelMatrix;
 			params.modelMatrixPrev = modelMatrixPrev;
 			params.texId = material.mmdTex;
@@ -485,14 +655,7 @@ namespace engine
 			params.translucentUnlitScale = material.translucentUnlitScale;
 			params.eyeHighlightScale = material.eyeHighlightScale;
 
-			{
-				uint32_t dynamicOffset = getContext()->getDynamicUniformBuffers().alloc(sizeof(params));
-				memcpy((char*)(getContext()->getDynamicUniformBuffers().getBuffer()->getMapped()) + dynamicOffset, &params, sizeof(params));
-				auto set = getContext()->getDynamicUniformBuffers().getSet();
-				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelinelayout, 6, 1, &set, 1, &dynamicOffset);
-			}
-
-			vkCmdDraw(cmd, subMesh.m_vertexCount, 1, subMesh.m_beginIndex, 0);
+			collector.push_back(submesh);
 		}
 	}
 
@@ -567,6 +730,8 @@ namespace engine
 
 	void PMXMeshProxy::updateAnimation(float vmdFrameTime, float physicElapsed)
 	{
+		CPU_PROFILER_SCOPE("PMXMeshProxy::updateAnimation");
+
 		if (m_vmd)
 		{
 			m_mmdModel->BeginAnimation();
@@ -575,8 +740,42 @@ namespace engine
 		}
 	}
 
+	void PMXMeshProxy::kickAnimationJob(float vmdFrameTime, float physicElapsed)
+	{
+		CHECK(!m_animationJob.isValid());
+
+		// Every model own its bullet world and nodes, so models simulate parallel without lock.
+		auto* threadPool = ThreadPool::getDefault();
+		m_animationJob = threadPool->createTask([this, vmdFrameTime, physicElapsed]()
+		{
+			updateAnimation(vmdFrameTime, physicElapsed);
+		});
+		threadPool->run(m_animationJob);
+	}
+
+	bool PMXMeshProxy::waitAnimationJob()
+	{
+		if (!m_animationJob.isValid())
+		{
+			return false;
+		}
+
+		CPU_PROFILER_SCOPE("PMXMeshProxy::waitAnimationJob");
+		ThreadPool::getDefault()->wait(m_animationJob);
+		m_animationJob = {};
+
+		return true;
+	}
+
 	void PMXMeshProxy::updateVertex(VkCommandBuffer cmd)
 	{
+		m_bComputeSkinning = shouldComputeSkinning();
+		if (m_bComputeSkinning)
+		{
+			updateVertexGPU(cmd);
+			return;
+		}
+
 		// Copy last positions, todo: can optimize.
 		std::vector<glm::vec3> positionLast = m_mmdModel->getUpdatePositions();
 		std::vector<glm::vec3> smoothNormalPrev = m_mmdModel->getUpdateSmoothNormals();
@@ -593,6 +792,170 @@ namespace engine
 		m_stageBufferUv->copyAndUpload(cmd, uv, m_uvBuffer.get());
 		m_stageBufferPositionPrevFrame->copyAndUpload(cmd, positionLastPtr, m_positionPrevFrameBuffer.get());
 		m_stageSmoothNormal->copyAndUpload(cmd, &smoothNormalPrev[0], m_smoothNormalBuffer.get());
+
+		m_bSkinningHistoryValid = true;
+	}
+
+	void PMXMeshProxy::updateVertexGPU(VkCommandBuffer cmd)
+	{
+		prepareComputeSkinning(cmd);
+
+		auto pmxModel = std::static_pointer_cast<saba::PMXModel>(m_mmdModel);
+		const uint32_t vertexCount = uint32_t(pmxModel->GetVertexCount());
+
+		// Still skinning on cpu when someone need skinned positions, else only update bone transforms.
+		if (m_bCPUPositionsRequested)
+		{
+			pmxModel->Update();
+		}
+		else
+		{
+			pmxModel->UpdateBoneTransforms();
+		}
+
+		// Bone matrices is the only data upload every frame.
+		{
+			const auto* transforms = pmxModel->GetBoneTransforms();
+			const auto* rotations = pmxModel->GetBoneRotations();
+			for (size_t i = 0; i < m_skinningBones.size(); i++)
+			{
+				auto& bone = m_skinningBones[i];
+				bone.transform = transforms[i];
+
+				if (m_bSkinningSDEF && rotations)
+				{
+					bone.rotation = math::vec4(rotations[i].x, rotations[i].y, rotations[i].z, rotations[i].w);
+				}
+
+				if (m_bSkinningQDEF)
+				{
+					auto dq = math::normalize(math::dualquat_cast(math::mat3x4(math::transpose(transforms[i]))));
+					bone.dqReal = math::vec4(dq.real.x, dq.real.y, dq.real.z, dq.real.w);
+					bone.dqDual = math::vec4(dq.dual.x, dq.dual.y, dq.dual.z, dq.dual.w);
+				}
+			}
+
+			if (!m_skinningBones.empty())
+			{
+				m_stageSkinningBone->copyAndUpload(cmd, m_skinningBones.data(), m_skinningBoneBuffer.get());
+			}
+		}
+
+		// Morph deltas only upload when morph weights changed.
+		if (m_uploadedMorphVersion != pmxModel->GetMorphVersion())
+		{
+			m_stageMorphPosition->copyAndUpload(cmd, pmxModel->GetMorphPositions(), m_morphPositionBuffer.get());
+			m_stageMorphUV->copyAndUpload(cmd, pmxModel->GetMorphUVs(), m_morphUVBuffer.get());
+
+			m_uploadedMorphVersion = pmxModel->GetMorphVersion();
+		}
+
+		// Last frame skinned positions copy on gpu.
+		auto copyPrevPositions = [&]()
+		{
+			VkBufferCopy copyRegion{};
+			copyRegion.size = m_positionBuffer->getSize();
+			vkCmdCopyBuffer(cmd, m_positionBuffer->getVkBuffer(), m_positionPrevFrameBuffer->getVkBuffer(), 1, &copyRegion);
+		};
+
+		{
+			std::array<VkBufferMemoryBarrier2, 2> prevBarriers
+			{
+				RHIBufferBarrier(m_positionBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT,
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT),
+				RHIBufferBarrier(m_positionPrevFrameBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT,
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT),
+			};
+			RHIPipelineBarrier(cmd, 0, (uint32_t)prevBarriers.size(), prevBarriers.data(), 0, nullptr);
+
+			if (m_bSkinningHistoryValid)
+			{
+				copyPrevPositions();
+			}
+		}
+
+		auto* pass = getContext()->getPasses().get<PMXSkinningPass>();
+		{
+			ScopePerframeMarker marker(cmd, "PMXComputeSkinning", { 1.0f, 0.0f, 0.0f, 1.0f });
+
+			std::array<VkBufferMemoryBarrier2, 6> beginBarriers
+			{
+				RHIBufferBarrier(m_skinningBoneBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_morphPositionBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_morphUVBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_positionBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT),
+				RHIBufferBarrier(m_normalBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT),
+				RHIBufferBarrier(m_uvBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT),
+			};
+			RHIPipelineBarrier(cmd, 0, (uint32_t)beginBarriers.size(), beginBarriers.data(), 0, nullptr);
+
+			PMXSkinningPushConsts pushConst{ .vertexCount = vertexCount };
+			pass->skinningPipe->bindAndPushConst(cmd, &pushConst);
+
+			PushSetBuilder(cmd)
+				.addBuffer(*m_skinningVertexBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.addBuffer(*m_skinningBoneBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.addBuffer(*m_morphPositionBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.addBuffer(*m_morphUVBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.addBuffer(*m_positionBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.addBuffer(*m_normalBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.addBuffer(*m_uvBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.push(pass->skinningPipe.get());
+
+			vkCmdDispatch(cmd, getGroupCount(vertexCount, 64), 1, 1);
+		}
+
+		// First compute skinning frame no history, use current positions as prev.
+		if (!m_bSkinningHistoryValid)
+		{
+			VkBufferMemoryBarrier2 copyBarrier = RHIBufferBarrier(m_positionBuffer->getVkBuffer(),
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+			RHIPipelineBarrier(cmd, 0, 1, &copyBarrier, 0, nullptr);
+
+			copyPrevPositions();
+			m_bSkinningHistoryValid = true;
+		}
+
+		// Skinned buffers read by pmx draw, static mesh shadow and blas build.
+		{
+			VkPipelineStageFlags2 dstStages = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+			if (getContext()->getGraphicsCardState().bSupportRaytrace)
+			{
+				dstStages |= VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR | VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR;
+			}
+
+			std::array<VkBufferMemoryBarrier2, 4> endBarriers
+			{
+				RHIBufferBarrier(m_positionBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+					dstStages, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_normalBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+					dstStages, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_uvBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+					dstStages, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_positionPrevFrameBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					dstStages, VK_ACCESS_2_SHADER_READ_BIT),
+			};
+			RHIPipelineBarrier(cmd, 0, (uint32_t)endBarriers.size(), endBarriers.data(), 0, nullptr);
+		}
 	}
 
 	void PMXMeshProxy::updateBLAS(VkCommandBuffer cmd)
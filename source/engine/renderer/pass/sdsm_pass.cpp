@@ -104,6 +104,8 @@ namespace engine
 		}
 	};
 
+	REGISTER_PASS(SDSMPass)
+
 	void SDSMInfos::build(const CascadeShadowConfig* config, RendererInterface* renderer)
 	{
 		const bool bFallback = (config == nullptr) || (renderer == nullptr);
@@ -132,61 +134,41 @@ namespace engine
 		rangeBuffer = getContext()->getBufferParameters().getStaticStorageGPUOnly("SDSMRangeBuffer", sizeof(GPUDepthRange));
 	}
 
-	void RendererInterface::renderSDSM(
-		VkCommandBuffer cmd, 
+	// Cascade fit and shadow depth may record in different queue, both share same set and push const.
+	static PushSetBuilder buildSDSMSetBuilder(
+		VkCommandBuffer cmd,
 		GBufferTextures* inGBuffers,
-		RenderScene* scene, 
+		RenderScene* scene,
 		BufferParameterHandle perFrameGPU,
-		SDSMInfos& sdsmInfos)
+		const SDSMInfos& sdsmInfos)
 	{
-		sdsmInfos.build(nullptr, nullptr);
-		if (!scene->shouldRenderSDSM())
-		{
-			return;
-		}
-
-
-
-		const auto& gpuInfo = scene->getSkyGPU();
-		const bool bStaticMeshRenderSDSM = gpuInfo.rayTraceShadow == 0;
-
-		auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
-		sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
-
-		const uint32_t staticMeshCount = bStaticMeshRenderSDSM ?(uint32_t)scene->getStaticMeshObjects().size() : 0;
-
-		auto& gBufferA = inGBuffers->gbufferA->getImage();
-		auto& gBufferB = inGBuffers->gbufferB->getImage();
-		auto& gBufferS = inGBuffers->gbufferS->getImage();
-		gBufferA.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-		gBufferB.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-		gBufferS.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-
-		auto* pass = m_context->getPasses().get<SDSMPass>();
-		auto rangeBuffer = sdsmInfos.rangeBuffer;
-
-		sdsmInfos.build(&gpuInfo.cacsadeConfig, this);
-		auto& cascadeBuffer = sdsmInfos.cascadeInfoBuffer;
-		auto& sdsmDepth = sdsmInfos.shadowDepths;
-		auto& sdsmMask = sdsmInfos.mainViewMask;
-
-		// Basic setBuilder.
 		auto& terrains = scene->getTerrains();
-		auto& pmxes = scene->getPMXes();
+		auto& gBufferA = inGBuffers->gbufferA->getImage();
 
 		PushSetBuilder setBuilder(cmd);
 		setBuilder
-			.addSRV(sceneDepthZ, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT))
-			.addBuffer(rangeBuffer)
-			.addBuffer(cascadeBuffer)
+			.addSRV(inGBuffers->depthTexture->getImage(), RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT))
+			.addBuffer(sdsmInfos.rangeBuffer)
+			.addBuffer(sdsmInfos.cascadeInfoBuffer)
 			.addSRV(gBufferA)
-			.addSRV(sdsmDepth, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT))
-			.addSRV(gBufferB)
-			.addSRV(gBufferS)
-			.addUAV(sdsmMask)
+			.addSRV(sdsmInfos.shadowDepths, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT))
+			.addSRV(inGBuffers->gbufferB->getImage())
+			.addSRV(inGBuffers->gbufferS->getImage())
+			.addUAV(sdsmInfos.mainViewMask)
 			.addSRV(terrains.empty() ? gBufferA : terrains[0].lock()->getHeightfiledImage())
 			.addBuffer(perFrameGPU)
-			.addBuffer(scene->getStaticMeshObjectsGPU() ? scene->getStaticMeshObjectsGPU() : cascadeBuffer);
+			.addBuffer(scene->getStaticMeshObjectsGPU() ? scene->getStaticMeshObjectsGPU() : sdsmInfos.cascadeInfoBuffer);
+
+		return setBuilder;
+	}
+
+	static GPUSDSMPushConst buildSDSMPushConst(RenderScene* scene)
+	{
+		const auto& gpuInfo = scene->getSkyGPU();
+		const bool bStaticMeshRenderSDSM = gpuInfo.rayTraceShadow == 0;
+		const uint32_t staticMeshCount = bStaticMeshRenderSDSM ? (uint32_t)scene->getStaticMeshObjects().size() : 0;
+
+		auto& terrains = scene->getTerrains();
 
 		GPUSDSMPushConst pushConst
 		{
@@ -200,6 +182,40 @@ namespace engine
 			.heightfiledDump = terrains.empty() ? 1.0f : terrains[0].lock()->getSetting().dumpFactor,
 		};
 
+		return pushConst;
+	}
+
+	void RendererInterface::renderSDSMCascade(
+		VkCommandBuffer cmd,
+		GBufferTextures* inGBuffers,
+		RenderScene* scene,
+		BufferParameterHandle perFrameGPU,
+		SDSMInfos& sdsmInfos)
+	{
+		sdsmInfos.build(nullptr, nullptr);
+		if (!scene->shouldRenderSDSM())
+		{
+			return;
+		}
+
+		const auto& gpuInfo = scene->getSkyGPU();
+
+		auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
+		sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
+
+		inGBuffers->gbufferA->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+		inGBuffers->gbufferB->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+		inGBuffers->gbufferS->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+
+		auto* pass = m_context->getPasses().get<SDSMPass>();
+
+		sdsmInfos.build(&gpuInfo.cacsadeConfig, this);
+		auto rangeBuffer = sdsmInfos.rangeBuffer;
+		auto& cascadeBuffer = sdsmInfos.cascadeInfoBuffer;
+
+		PushSetBuilder setBuilder = buildSDSMSetBuilder(cmd, inGBuffers, scene, perFrameGPU, sdsmInfos);
+		GPUSDSMPushConst pushConst = buildSDSMPushConst(scene);
+
 		{
 			ScopePerframeMarker marker(cmd, "DepthRangeCompute", { 1.0f, 0.0f, 0.0f, 1.0f });
 
@@ -241,7 +257,33 @@ namespace engine
 			RHIPipelineBarrier(cmd, 0, 1, &endBufferBarrier, 0, nullptr);
 		}
 
-		
+		m_gpuTimer.getTimeStamp(cmd, "SDSMCascade");
+	}
+
+	void RendererInterface::renderSDSM(
+		VkCommandBuffer cmd, 
+		GBufferTextures* inGBuffers,
+		RenderScene* scene, 
+		BufferParameterHandle perFrameGPU,
+		SDSMInfos& sdsmInfos)
+	{
+		// Infos build by cascade pass.
+		if (!scene->shouldRenderSDSM())
+		{
+			return;
+		}
+
+		const auto& gpuInfo = scene->getSkyGPU();
+		const bool bStaticMeshRenderSDSM = gpuInfo.rayTraceShadow == 0;
+		const uint32_t staticMeshCount = bStaticMeshRenderSDSM ? (uint32_t)scene->getStaticMeshObjects().size() : 0;
+
+		auto* pass = m_context->getPasses().get<SDSMPass>();
+		auto& sdsmDepth = sdsmInfos.shadowDepths;
+		auto& sdsmMask = sdsmInfos.mainViewMask;
+		auto& terrains = scene->getTerrains();
+
+		PushSetBuilder setBuilder = buildSDSMSetBuilder(cmd, inGBuffers, scene, perFrameGPU, sdsmInfos);
+		GPUSDSMPushConst pushConst = buildSDSMPushConst(scene);
 
 		{
 			const auto cullingCount = math::max(1U, gpuInfo.cacsadeConfig.cascadeCount * staticMeshCount);
@@ -298,13 +340,24 @@ namespace engine
 			sdsmDepth->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
 			VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sdsmDepth);
 			{
+				const uint32_t cascadeCount = gpuInfo.cacsadeConfig.cascadeCount;
 
-				ScopeRenderCmdObject renderCmdScope(cmd, "SDSMShadowDepth", sdsmDepth->getImage(), {}, depthAttachment);
+				// Every cascade draw all static mesh and terrain, heavy enough to be one chunk.
+				auto& recorder = m_context->getParallelCommandRecorder();
+				const bool bParallel = recorder.shouldRecordParallel(cascadeCount, 1);
 
-				vkCmdSetDepthBias(cmd, gpuInfo.cacsadeConfig.shadowBiasConst, 0, gpuInfo.cacsadeConfig.shadowBiasSlope);
+				auto recordCascades = [&](VkCommandBuffer drawCmd, size_t start, size_t end)
 				{
 					// Set depth bias for shadow depth rendering to avoid shadow artifact.
-					for (uint32_t cascadeIndex = 0; cascadeIndex < gpuInfo.cacsadeConfig.cascadeCount; cascadeIndex++)
+					vkCmdSetDepthBias(drawCmd, gpuInfo.cacsadeConfig.shadowBiasConst, 0, gpuInfo.cacsadeConfig.shadowBiasSlope);
+
+					// Push set builder bind to command buffer, build again for secondary.
+					PushSetBuilder drawSetBuilder = buildSDSMSetBuilder(drawCmd, inGBuffers, scene, perFrameGPU, sdsmInfos);
+					drawSetBuilder
+						.addBuffer(indirectDrawCommandBuffer)
+						.addBuffer(indirectDrawCountBuffer);
+
+					for (uint32_t cascadeIndex = uint32_t(start); cascadeIndex < uint32_t(end); cascadeIndex++)
 					{
 						VkRect2D scissor{};
 						scissor.extent = { (uint32_t)gpuInfo.cacsadeConfig.percascadeDimXY, (uint32_t)gpuInfo.cacsadeConfig.percascadeDimXY };
@@ -318,25 +371,26 @@ namespace engine
 						viewport.x = (float)gpuInfo.cacsadeConfig.percascadeDimXY * (float)cascadeIndex;
 						viewport.width = (float)gpuInfo.cacsadeConfig.percascadeDimXY;
 
-						vkCmdSetScissor(cmd, 0, 1, &scissor);
-						vkCmdSetViewport(cmd, 0, 1, &viewport);
+						vkCmdSetScissor(drawCmd, 0, 1, &scissor);
+						vkCmdSetViewport(drawCmd, 0, 1, &viewport);
 
 						if(bStaticMeshRenderSDSM)
 						{
-							pass->depthPipe->bind(cmd);
-							staticMeshSetBuilder.push(pass->depthPipe.get());
+							pass->depthPipe->bind(drawCmd);
+							drawSetBuilder.push(pass->depthPipe.get());
 
-							pass->depthPipe->bindSet(cmd, std::vector<VkDescriptorSet>{
+							pass->depthPipe->bindSet(drawCmd, std::vector<VkDescriptorSet>{
 								m_context->getBindlessSSBOSet()
 									, m_context->getBindlessSSBOSet()
 									, m_context->getBindlessTextureSet()
 									, m_context->getBindlessSamplerSet()
 							}, 1);
 
-							pushConst.cascadeId = cascadeIndex;
-							pass->depthPipe->pushConst(cmd, &pushConst);
+							GPUSDSMPushConst cascadePushConst = pushConst;
+							cascadePushConst.cascadeId = cascadeIndex;
+							pass->depthPipe->pushConst(drawCmd, &cascadePushConst);
 
-							vkCmdDrawIndirectCount(cmd,
+							vkCmdDrawIndirectCount(drawCmd,
 								indirectDrawCommandBuffer->getBuffer()->getVkBuffer(),
 								cascadeIndex * sizeof(GPUStaticMeshDrawCommand) * staticMeshCount,
 								indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
@@ -351,10 +405,26 @@ namespace engine
 						{
 							if (auto comp = terrain.lock())
 							{
-								comp->renderSDSMDepth(cmd, perFrameGPU, inGBuffers, scene, this, sdsmInfos, cascadeIndex);
+								comp->renderSDSMDepth(drawCmd, perFrameGPU, inGBuffers, scene, this, sdsmInfos, cascadeIndex);
 							}
 						}
 					}
+				};
+
+				ScopeRenderCmdObject renderCmdScope(cmd, "SDSMShadowDepth", sdsmDepth->getImage(), {}, depthAttachment,
+					bParallel ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0);
+				if (bParallel)
+				{
+					SecondaryRenderingInfo info{ };
+					info.depthFormat = sdsmDepth->getImage().getFormat();
+					info.viewport = renderCmdScope.viewport;
+					info.scissor = renderCmdScope.scissor;
+
+					recorder.record(cmd, info, cascadeCount, recordCascades, 1);
+				}
+				else
+				{
+					recordCascades(cmd, 0, cascadeCount);
 				}
 			}
 		}
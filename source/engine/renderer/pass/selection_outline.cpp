@@ -35,6 +35,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(SelectionOutlinePass)
+
 
     void RendererInterface::renderSelectionOutline(VkCommandBuffer cmd, GBufferTextures* inGBuffers, BufferParameterHandle perFrameGPU)
     {
@@ -36,6 +36,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(SharedTextureComputePasses)
+
     void SharedTextures::compute(VkCommandBuffer cmd)
     {
         auto* pass = getContext()->getPasses().get<SharedTextureComputePasses>();
@@ -53,6 +53,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(SSGIPass)
+
 
     PoolImageSharedRef RendererInterface::renderSSGI(
         VkCommandBuffer cmd,
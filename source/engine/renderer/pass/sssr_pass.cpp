@@ -112,6 +112,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(SSSRPass)
+
     void RendererInterface::renderSSSR(
         VkCommandBuffer cmd,
         GBufferTextures* inGBuffers,
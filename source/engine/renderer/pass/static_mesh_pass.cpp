@@ -5,6 +5,14 @@
 
 namespace engine
 {
+    static AutoCVarBool cVarStaticMeshClusterConeCull(
+        "r.StaticMesh.ClusterConeCull",
+        "Enable static mesh meshlet normal cone culling, assume static mesh is closed surface.",
+        "StaticMesh",
+        true,
+        CVarFlags::ReadAndWrite
+    );
+
 	struct GPUCullingPrepassPushConstants
 	{
 		uint32_t cullCount;
@@ -17,6 +25,13 @@ namespace engine
         glm::vec2 hzbSrcSize;
     };
 
+    struct GPUClusterCullingPushConstants
+    {
+        uint32_t bConeCull;
+        uint32_t hzbMipCount;
+        glm::vec2 hzbSrcSize;
+    };
+
     class StaticMeshPass : public PassInterface
     {
     public:
@@ -30,6 +45,12 @@ namespace engine
         VkDescriptorSetLayout gbufferCullSetLayout = VK_NULL_HANDLE;
         VkDescriptorSetLayout gbufferSetLayout = VK_NULL_HANDLE;
 
+        // Meshlet culling of objects with meshlets.
+        std::unique_ptr<ComputePipeResources> prepass_cluster_cull;
+        std::unique_ptr<ComputePipeResources> gbuffer_cluster_cull;
+        VkDescriptorSetLayout prepassClusterCullSetLayout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout gbufferClusterCullSetLayout = VK_NULL_HANDLE;
+
     protected:
         virtual void onInit() override
         {
@@ -38,6 +59,8 @@ namespace engine
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // objectDatas
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 2) // indirectCommands
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // drawCount
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 4) // clusterCullObjects
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 5) // clusterCullArgs
                 .buildNoInfoPush(prepassCullSetLayout);
             prepass_cull = std::make_unique<ComputePipeResources>("shader/staticmesh_prepass_cull.comp.spv", (uint32_t)sizeof(GPUCullingPrepassPushConstants),
                 std::vector<VkDescriptorSetLayout>
@@ -74,6 +97,8 @@ namespace engine
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 2) // indirectCommands
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // drawCount
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  kCommonShaderStage, 4) // inHzb
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 5) // clusterCullObjects
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 6) // clusterCullArgs
                 .buildNoInfoPush(gbufferCullSetLayout);
             gbuffer_cull = std::make_unique<ComputePipeResources>("shader/staticmesh_cull.comp.spv", (uint32_t)sizeof(GPUCullingGbufferPushConstants),
                 std::vector<VkDescriptorSetLayout>
@@ -81,6 +106,37 @@ namespace engine
                     gbufferCullSetLayout
                 });
 
+            getContext()->descriptorFactoryBegin()
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kCommonShaderStage, 0) // frameData
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // objectDatas
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 2) // indirectCommands
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // drawCount
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 4) // clusterCullObjects
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 5) // clusterCullArgs
+                .buildNoInfoPush(prepassClusterCullSetLayout);
+            prepass_cluster_cull = std::make_unique<ComputePipeResources>("shader/staticmesh_prepass_cluster_cull.comp.spv", (uint32_t)sizeof(GPUClusterCullingPushConstants),
+                std::vector<VkDescriptorSetLayout>
+                {
+                      prepassClusterCullSetLayout
+                    , m_context->getBindlessSSBOSetLayout()
+                });
+
+            getContext()->descriptorFactoryBegin()
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kCommonShaderStage, 0) // frameData
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // objectDatas
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 2) // indirectCommands
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 3) // drawCount
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 4) // clusterCullObjects
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 5) // clusterCullArgs
+                .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  kCommonShaderStage, 6) // inHzb
+                .buildNoInfoPush(gbufferClusterCullSetLayout);
+            gbuffer_cluster_cull = std::make_unique<ComputePipeResources>("shader/staticmesh_cluster_cull.comp.spv", (uint32_t)sizeof(GPUClusterCullingPushConstants),
+                std::vector<VkDescriptorSetLayout>
+                {
+                      gbufferClusterCullSetLayout
+                    , m_context->getBindlessSSBOSetLayout()
+                });
+
             getContext()->descriptorFactoryBegin()
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kCommonShaderStage, 0) // frameData
                 .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kCommonShaderStage, 1) // objectDatas
@@ -128,9 +184,60 @@ namespace engine
 
             gbuffer_cull.reset();
             gbuffer.reset();
+
+            prepass_cluster_cull.reset();
+            gbuffer_cluster_cull.reset();
         }
     };
 
+    REGISTER_PASS(StaticMeshPass)
+
+    // Object without meshlets draw once, object with meshlets draw at most meshlet count.
+    static uint32_t getStaticMeshMaxDrawCount(const RenderScene* scene)
+    {
+        uint32_t count = 0;
+        for (const auto& object : scene->getStaticMeshObjects())
+        {
+            count += std::max(object.meshletCount, 1u);
+        }
+        return count;
+    }
+
+    // Reset draw count and cluster cull args before object culling.
+    static void clearCullingCounters(VkCommandBuffer cmd, BufferParameterHandle drawCount, BufferParameterHandle clusterCullArgs)
+    {
+        // Cluster cull args is dispatch indirect command, .xyz = (0, 1, 1), .w is object count.
+        vkCmdFillBuffer(cmd, *drawCount->getBuffer(), 0, drawCount->getBuffer()->getSize(), 0u);
+        vkCmdFillBuffer(cmd, *clusterCullArgs->getBuffer(), 0, sizeof(GPUDispatchIndirectCommand), 0u);
+        vkCmdFillBuffer(cmd, *clusterCullArgs->getBuffer(), sizeof(uint32_t), sizeof(uint32_t) * 2, 1u);
+    }
+
+    // Object culling output as cluster culling input.
+    static void clusterCullingBarrier(
+        VkCommandBuffer cmd,
+        BufferParameterHandle drawCommands,
+        BufferParameterHandle drawCount,
+        BufferParameterHandle clusterCullObjects,
+        BufferParameterHandle clusterCullArgs)
+    {
+        std::array<VkBufferMemoryBarrier2, 4> objectCullBarriers
+        {
+            RHIBufferBarrier(drawCommands->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+            RHIBufferBarrier(drawCount->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+            RHIBufferBarrier(clusterCullObjects->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT),
+            RHIBufferBarrier(clusterCullArgs->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT),
+        };
+        RHIPipelineBarrier(cmd, 0, (uint32_t)objectCullBarriers.size(), objectCullBarriers.data(), 0, nullptr);
+    }
+
     void RendererInterface::renderStaticMeshPrepass(VkCommandBuffer cmd, GBufferTextures* inGBuffers, RenderScene* scene, BufferParameterHandle perFrameGPU)
     {
         const uint32_t staticMeshCount = (uint32_t)scene->getStaticMeshObjects().size();
@@ -142,8 +249,12 @@ namespace engine
         auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
         VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ);
 
-        auto indirectDrawCommandBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshIndirectCommand_Prepass", sizeof(GPUStaticMeshDrawCommand) * staticMeshCount);
+        const uint32_t maxDrawCount = getStaticMeshMaxDrawCount(scene);
+
+        auto indirectDrawCommandBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshIndirectCommand_Prepass", sizeof(GPUStaticMeshDrawCommand) * maxDrawCount);
         auto indirectDrawCountBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshIndirectCount_Prepass", sizeof(uint32_t));
+        auto clusterCullObjectsBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshClusterCullObjects_Prepass", sizeof(uint32_t) * staticMeshCount);
+        auto clusterCullArgsBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshClusterCullArgs_Prepass", sizeof(GPUDispatchIndirectCommand));
 
         auto* pass = m_context->getPasses().get<StaticMeshPass>();
 
@@ -151,12 +262,18 @@ namespace engine
         {
             ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "StaticMeshCulling_prepass", { 1.0f, 0.0f, 0.0f, 1.0f });
 
-            vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->getBuffer(), 0, indirectDrawCountBuffer->getBuffer()->getSize(), 0u);
+            clearCullingCounters(cmd, indirectDrawCountBuffer, clusterCullArgsBuffer);
 
-            auto fillBarriers = RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-            RHIPipelineBarrier(cmd, 0, 1, &fillBarriers, 0, nullptr);
+            std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+            {
+                RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+                RHIBufferBarrier(clusterCullArgsBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+            };
+            RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
 
 
             GPUCullingPrepassPushConstants gpuPushConstant =
@@ -171,10 +288,34 @@ namespace engine
                 .addBuffer(scene->getStaticMeshObjectsGPU())
                 .addBuffer(indirectDrawCommandBuffer)
                 .addBuffer(indirectDrawCountBuffer)
+                .addBuffer(clusterCullObjectsBuffer)
+                .addBuffer(clusterCullArgsBuffer)
                 .push(pass->prepass_cull.get());
 
             vkCmdDispatch(cmd, getGroupCount(staticMeshCount, 64), 1, 1);
 
+            // Meshlet culling of objects with meshlets, no hzb in prepass.
+            clusterCullingBarrier(cmd, indirectDrawCommandBuffer, indirectDrawCountBuffer, clusterCullObjectsBuffer, clusterCullArgsBuffer);
+            {
+                GPUClusterCullingPushConstants clusterPushConstant =
+                {
+                    .bConeCull = cVarStaticMeshClusterConeCull.get() ? 1U : 0U,
+                };
+
+                pass->prepass_cluster_cull->bindAndPushConst(cmd, &clusterPushConstant);
+                PushSetBuilder(cmd)
+                    .addBuffer(perFrameGPU)
+                    .addBuffer(scene->getStaticMeshObjectsGPU())
+                    .addBuffer(indirectDrawCommandBuffer)
+                    .addBuffer(indirectDrawCountBuffer)
+                    .addBuffer(clusterCullObjectsBuffer)
+                    .addBuffer(clusterCullArgsBuffer)
+                    .push(pass->prepass_cluster_cull.get());
+                pass->prepass_cluster_cull->bindSet(cmd, std::vector<VkDescriptorSet>{ m_context->getBindlessSSBOSet() }, 1);
+
+                vkCmdDispatchIndirect(cmd, clusterCullArgsBuffer->getBuffer()->getVkBuffer(), 0);
+            }
+
             // End buffer barrier.
             std::array<VkBufferMemoryBarrier2, 2> endBufferBarriers
             {
@@ -214,7 +355,7 @@ namespace engine
                 indirectDrawCommandBuffer->getBuffer()->getVkBuffer(), 0,
                 indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
                 0,
-                staticMeshCount,
+                maxDrawCount,
                 sizeof(GPUStaticMeshDrawCommand)
             );
         }
@@ -269,8 +410,12 @@ namespace engine
             return;
         }
 
-        auto indirectDrawCommandBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshIndirectCommand", sizeof(GPUStaticMeshDrawCommand) * staticMeshCount);
+        const uint32_t maxDrawCount = getStaticMeshMaxDrawCount(scene);
+
+        auto indirectDrawCommandBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshIndirectCommand", sizeof(GPUStaticMeshDrawCommand) * maxDrawCount);
         auto indirectDrawCountBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshIndirectCount", sizeof(uint32_t));
+        auto clusterCullObjectsBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshClusterCullObjects", sizeof(uint32_t) * staticMeshCount);
+        auto clusterCullArgsBuffer = m_context->getBufferParameters().getIndirectStorage("StaticMeshClusterCullArgs", sizeof(GPUDispatchIndirectCommand));
 
         auto* pass = m_context->getPasses().get<StaticMeshPass>();
 
@@ -278,15 +423,20 @@ namespace engine
         {
             ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "StaticMeshGBufferCulling", { 1.0f, 0.0f, 0.0f, 1.0f });
 
-            auto beginBarriers = RHIBufferBarrier(
-                indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
-                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
-            RHIPipelineBarrier(cmd, 0, 1, &beginBarriers, 0, nullptr);
+            std::array<VkBufferMemoryBarrier2, 2> beginBarriers
+            {
+                RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT),
+                RHIBufferBarrier(clusterCullArgsBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT),
+            };
+            RHIPipelineBarrier(cmd, 0, (uint32_t)beginBarriers.size(), beginBarriers.data(), 0, nullptr);
 
-            vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->getBuffer(), 0, indirectDrawCountBuffer->getBuffer()->getSize(), 0u);
+            clearCullingCounters(cmd, indirectDrawCountBuffer, clusterCullArgsBuffer);
 
-            std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+            std::array<VkBufferMemoryBarrier2, 3> fillBarriers
             {
                 RHIBufferBarrier(indirectDrawCommandBuffer->getBuffer()->getVkBuffer(),
                     VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
@@ -295,6 +445,10 @@ namespace engine
                 RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+
+                RHIBufferBarrier(clusterCullArgsBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
             };
             RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
 
@@ -314,10 +468,37 @@ namespace engine
                 .addBuffer(indirectDrawCommandBuffer)
                 .addBuffer(indirectDrawCountBuffer)
                 .addSRV(hzbFurthest)
+                .addBuffer(clusterCullObjectsBuffer)
+                .addBuffer(clusterCullArgsBuffer)
                 .push(pass->gbuffer_cull.get());
 
             vkCmdDispatch(cmd, getGroupCount(staticMeshCount, 64), 1, 1);
 
+            // Meshlet culling of objects with meshlets, reuse same hzb.
+            clusterCullingBarrier(cmd, indirectDrawCommandBuffer, indirectDrawCountBuffer, clusterCullObjectsBuffer, clusterCullArgsBuffer);
+            {
+                GPUClusterCullingPushConstants clusterPushConstant =
+                {
+                    .bConeCull = cVarStaticMeshClusterConeCull.get() ? 1U : 0U,
+                    .hzbMipCount = gpuPushConstant.hzbMipCount,
+                    .hzbSrcSize = gpuPushConstant.hzbSrcSize,
+                };
+
+                pass->gbuffer_cluster_cull->bindAndPushConst(cmd, &clusterPushConstant);
+                PushSetBuilder(cmd)
+                    .addBuffer(perFrameGPU)
+                    .addBuffer(scene->getStaticMeshObjectsGPU())
+                    .addBuffer(indirectDrawCommandBuffer)
+                    .addBuffer(indirectDrawCountBuffer)
+                    .addBuffer(clusterCullObjectsBuffer)
+                    .addBuffer(clusterCullArgsBuffer)
+                    .addSRV(hzbFurthest)
+                    .push(pass->gbuffer_cluster_cull.get());
+                pass->gbuffer_cluster_cull->bindSet(cmd, std::vector<VkDescriptorSet>{ m_context->getBindlessSSBOSet() }, 1);
+
+                vkCmdDispatchIndirect(cmd, clusterCullArgsBuffer->getBuffer()->getVkBuffer(), 0);
+            }
+
             m_gpuTimer.getTimeStamp(cmd, "StaticMesh Culling");
 
             // End buffer barrier.
@@ -357,7 +538,7 @@ namespace engine
                 indirectDrawCommandBuffer->getBuffer()->getVkBuffer(), 0,
                 indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
                 0,
-                staticMeshCount,
+                maxDrawCount,
                 sizeof(GPUStaticMeshDrawCommand)
             );
 
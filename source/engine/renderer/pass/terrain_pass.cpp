@@ -64,6 +64,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(CbtPass)
+
     class TerrainPass : public PassInterface
     {
     public:
@@ -107,10 +109,14 @@ namespace engine
             splitPipe = std::make_unique<ComputePipeResources>("shader/terrain_split.comp.spv", (uint32_t)sizeof(TerrainCommonPassPush), commonLayouts);
             mergePipe = std::make_unique<ComputePipeResources>("shader/terrain_merge.comp.spv", (uint32_t)sizeof(TerrainCommonPassPush), commonLayouts);
 
+            // Render pipe also write texture streaming feedback of mask texture.
+            std::vector<VkDescriptorSetLayout> renderLayouts = commonLayouts;
+            renderLayouts.push_back(getContext()->getBindlessSSBOSetLayout());
+
             renderPipe = std::make_unique<GraphicPipeResources>(
                 "shader/terrain_render.vert.spv", 
                 "shader/terrain_render.frag.spv",
-                commonLayouts,
+                renderLayouts,
                 (uint32_t)sizeof(TerrainCommonPassPush), 
                 std::vector<VkFormat>
                 {
@@ -166,6 +172,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(TerrainPass)
+
 
 
     void TerrainComponent::reductionLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, GBufferTextures* inGBuffers, RenderScene* scene, class RendererInterface* renderer)
@@ -245,8 +253,10 @@ namespace engine
         vkCmdBindVertexBuffers(cmd, 0, 1, &vB, &vBOffset);
         vkCmdBindIndexBuffer(cmd, m_indicesBuffer->getBuffer()->getVkBuffer(), 0, VK_INDEX_TYPE_UINT16);
 
-        m_renderContext.commonPushConst.cascadeId = cascadeId;
-        pass->renderSDSMDepthPipe->pushConst(cmd, &m_renderContext.commonPushConst);
+        // Cascades may record parallel, no write shared push const.
+        TerrainCommonPassPush pushConst = m_renderContext.commonPushConst;
+        pushConst.cascadeId = cascadeId;
+        pass->renderSDSMDepthPipe->pushConst(cmd, &pushConst);
 
         vkCmdDrawIndexedIndirect(cmd,
             m_terrainDrawCmdBuffer->getBuffer()->getVkBuffer(),
@@ -298,12 +308,79 @@ namespace engine
         }
         auto& terrains = scene->getTerrains();
 
+        // Leb update is compute, must finish all terrains before gbuffer render scope.
+        std::vector<std::shared_ptr<TerrainComponent>> drawTerrains;
         for (auto& terrain : terrains)
         {
             if (auto comp = terrain.lock())
             {
-                comp->render(cmd, perFrameGPU, inGBuffers, scene, this);
+                if (comp->prepareRender(cmd, perFrameGPU, inGBuffers, scene, this))
+                {
+                    drawTerrains.push_back(comp);
+                }
+            }
+        }
+
+        if (drawTerrains.empty())
+        {
+            return;
+        }
+
+        auto& hdrSceneColor = inGBuffers->hdrSceneColor->getImage();
+        auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
+        auto& gbufferA = inGBuffers->gbufferA->getImage();
+        auto& gbufferB = inGBuffers->gbufferB->getImage();
+        auto& gbufferS = inGBuffers->gbufferS->getImage();
+        auto& gbufferV = inGBuffers->gbufferV->getImage();
+        auto& idTexture = inGBuffers->idTexture->getImage();
+        auto& selectionMask = inGBuffers->selectionOutlineMask->getImage();
+
+        hdrSceneColor.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferA.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferB.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferS.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        gbufferV.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        idTexture.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+        sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
+        selectionMask.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
+
+        const std::vector<VulkanImage*> colorImages = { &hdrSceneColor, &gbufferA, &gbufferB, &gbufferS, &gbufferV, &idTexture };
+
+        ColorAttachmentsBuilder colorBuilder;
+        std::vector<VkFormat> colorFormats;
+        for (auto* image : colorImages)
+        {
+            colorBuilder.add(*image, VK_ATTACHMENT_LOAD_OP_LOAD);
+            colorFormats.push_back(image->getFormat());
+        }
+        VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE);
+
+        auto& recorder = m_context->getParallelCommandRecorder();
+        const bool bParallel = recorder.shouldRecordParallel(drawTerrains.size());
+
+        auto recordDraws = [&](VkCommandBuffer drawCmd, size_t start, size_t end)
+        {
+            for (size_t i = start; i < end; i++)
+            {
+                drawTerrains[i]->renderLeb(drawCmd, perFrameGPU, inGBuffers);
             }
+        };
+
+        ScopeRenderCmdObject renderCmdScope(cmd, "TerrainGBuffer", sceneDepthZ, colorBuilder.result, depthAttachment,
+            bParallel ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0);
+        if (bParallel)
+        {
+            SecondaryRenderingInfo info{ };
+            info.colorFormats = colorFormats;
+            info.depthFormat = sceneDepthZ.getFormat();
+            info.viewport = renderCmdScope.viewport;
+            info.scissor = renderCmdScope.scissor;
+
+            recorder.record(cmd, info, drawTerrains.size(), recordDraws);
+        }
+        else
+        {
+            recordDraws(cmd, 0, drawTerrains.size());
         }
     }
 
@@ -339,80 +416,50 @@ namespace engine
         RHIPipelineBarrier(cmd, 0, (uint32_t)endBufferBarriers.size(), endBufferBarriers.data(), 0, nullptr);
     }
 
-    void TerrainComponent::renderLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, GBufferTextures* inGBuffers, RenderScene* scene, class RendererInterface* renderer)
+    void TerrainComponent::renderLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, GBufferTextures* inGBuffers)
     {
         auto* pass = getContext()->getPasses().get<TerrainPass>();
-
-        auto& hdrSceneColor = inGBuffers->hdrSceneColor->getImage();
-        auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
-        auto& gbufferA = inGBuffers->gbufferA->getImage();
-        auto& gbufferB = inGBuffers->gbufferB->getImage();
-        auto& gbufferS = inGBuffers->gbufferS->getImage();
-        auto& gbufferV = inGBuffers->gbufferV->getImage();
-        auto& idTexture = inGBuffers->idTexture->getImage();
-
-        hdrSceneColor.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-        gbufferA.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-        gbufferB.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-        gbufferS.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-        gbufferV.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-        idTexture.transitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
-        sceneDepthZ.transitionLayout(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
-
-        std::vector<VkRenderingAttachmentInfo> colorAttachments = ColorAttachmentsBuilder()
-            .add(hdrSceneColor, VK_ATTACHMENT_LOAD_OP_LOAD)
-            .add(gbufferA, VK_ATTACHMENT_LOAD_OP_LOAD)
-            .add(gbufferB, VK_ATTACHMENT_LOAD_OP_LOAD)
-            .add(gbufferS, VK_ATTACHMENT_LOAD_OP_LOAD)
-            .add(gbufferV, VK_ATTACHMENT_LOAD_OP_LOAD)
-            .add(idTexture, VK_ATTACHMENT_LOAD_OP_LOAD)
-            .result;
-        VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE);
-
         auto& selectionMask = inGBuffers->selectionOutlineMask->getImage();
-        selectionMask.transitionLayout(cmd, VK_IMAGE_LAYOUT_GENERAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT));
 
-        {
-            ScopeRenderCmdObject renderCmdScope(cmd, "TerrainGBuffer", sceneDepthZ, colorAttachments, depthAttachment);
+        // Secondary command buffer no inherit bind state, bind all again.
+        pass->renderPipe->bindAndPushConst(cmd, &m_renderContext.commonPushConst);
+        TerrainRenderUniform params{};
 
-            pass->renderPipe->bindAndPushConst(cmd, &m_renderContext.commonPushConst);
-            TerrainRenderUniform params{};
+        // params.prevModel = getNode()->getTransform()->getPrevWorldMatrix() * m_localMatrixPrev;
+        params.prevModel = m_localMatrixPrev;
+        auto fallbackId = getContext()->getEngineTextureWhite()->getBindlessIndex();
 
-            // params.prevModel = getNode()->getTransform()->getPrevWorldMatrix() * m_localMatrixPrev;
-            params.prevModel = m_localMatrixPrev;
-            auto fallbackId = getContext()->getEngineTextureWhite()->getBindlessIndex();
-
-            params.maskTexId = isMaskSet() ? m_renderContext.grassSandMudMaskImage->getBindlessIndex() : fallbackId;
-            {
-                uint32_t dynamicOffset = getContext()->getDynamicUniformBuffers().alloc(sizeof(TerrainRenderUniform));
-                memcpy((char*)(getContext()->getDynamicUniformBuffers().getBuffer()->getMapped()) + dynamicOffset, &params, sizeof(params));
-                auto set = getContext()->getDynamicUniformBuffers().getSet();
-                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->renderPipe->pipelineLayout, 3, 1, &set, 1, &dynamicOffset);
-            }
+        params.maskTexId = isMaskSet() ? m_renderContext.grassSandMudMaskImage->getBindlessIndex() : fallbackId;
+        {
+            uint32_t dynamicOffset = getContext()->getDynamicUniformBuffers().alloc(sizeof(TerrainRenderUniform));
+            memcpy((char*)(getContext()->getDynamicUniformBuffers().getBuffer()->getMapped()) + dynamicOffset, &params, sizeof(params));
+            auto set = getContext()->getDynamicUniformBuffers().getSet();
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pass->renderPipe->pipelineLayout, 3, 1, &set, 1, &dynamicOffset);
+        }
 
-            PushSetBuilder(cmd)
-                .addBuffer(m_lebBuffer)
-                .addBuffer(perFrameGPU)
-                .addSRV(m_renderContext.heightFieldImage->getImage())
-                .addUAV(selectionMask)
-                .push(pass->renderPipe.get());
+        PushSetBuilder(cmd)
+            .addBuffer(m_lebBuffer)
+            .addBuffer(perFrameGPU)
+            .addSRV(m_renderContext.heightFieldImage->getImage())
+            .addUAV(selectionMask)
+            .push(pass->renderPipe.get());
 
-            pass->renderPipe->bindSet(cmd, std::vector<VkDescriptorSet>{
-                getContext()->getSamplerCache().getCommonDescriptorSet(),
-                getContext()->getBindlessTextureSet(),
-            }, 1);
+        pass->renderPipe->bindSet(cmd, std::vector<VkDescriptorSet>{
+            getContext()->getSamplerCache().getCommonDescriptorSet(),
+            getContext()->getBindlessTextureSet(),
+        }, 1);
+        pass->renderPipe->bindSet(cmd, std::vector<VkDescriptorSet>{ getContext()->getBindlessSSBOSet() }, 4);
 
-            auto vB = m_verticesBuffer->getBuffer()->getVkBuffer();
-            const VkDeviceSize vBOffset = 0;
-            vkCmdBindVertexBuffers(cmd, 0, 1, &vB, &vBOffset);
-            vkCmdBindIndexBuffer(cmd, m_indicesBuffer->getBuffer()->getVkBuffer(), 0, VK_INDEX_TYPE_UINT16);
+        auto vB = m_verticesBuffer->getBuffer()->getVkBuffer();
+        const VkDeviceSize vBOffset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &vB, &vBOffset);
+        vkCmdBindIndexBuffer(cmd, m_indicesBuffer->getBuffer()->getVkBuffer(), 0, VK_INDEX_TYPE_UINT16);
 
-            vkCmdDrawIndexedIndirect(cmd,
-                m_terrainDrawCmdBuffer->getBuffer()->getVkBuffer(),
-                0,
-                1,
-                sizeof(float) * 8);
-        }
+        vkCmdDrawIndexedIndirect(cmd,
+            m_terrainDrawCmdBuffer->getBuffer()->getVkBuffer(),
+            0,
+            1,
+            sizeof(float) * 8);
     }
 
     void TerrainComponent::loadTexturesByUUID(bool bSync)
@@ -433,7 +480,7 @@ namespace engine
         }
     }
 
-    void TerrainComponent::render(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, GBufferTextures* inGBuffers, RenderScene* scene, class RendererInterface* renderer)
+    bool TerrainComponent::prepareRender(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, GBufferTextures* inGBuffers, RenderScene* scene, class RendererInterface* renderer)
     {
         if (isHeightfieldSet())
         {
@@ -444,7 +491,7 @@ namespace engine
         }
         else
         {
-            return;
+            return false;
         }
 
         if (!m_lebBuffer) loadLebBuffer();
@@ -480,7 +527,8 @@ namespace engine
         updateLeb(cmd, perFrameGPU, inGBuffers, scene, renderer);
         reductionLeb(cmd, perFrameGPU, inGBuffers, scene, renderer);
         batchLeb(cmd, perFrameGPU, inGBuffers, scene, renderer);
-        renderLeb(cmd, perFrameGPU, inGBuffers, scene, renderer);
+
+        return true;
     }
 
     void TerrainComponent::setHeightField(const UUID& in)
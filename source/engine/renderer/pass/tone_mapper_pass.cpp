@@ -274,6 +274,8 @@ namespace engine
         }
     };
 
+    REGISTER_PASS(TonemapperPass)
+
 
     void RendererInterface::renderTonemapper(VkCommandBuffer cmd, GBufferTextures* inGBuffers, BufferParameterHandle perFrameGPU, RenderScene* scene, PoolImageSharedRef bloomTex,
         BufferParameterHandle lensBuffer)
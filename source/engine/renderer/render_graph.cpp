@@ -0,0 +1,1009 @@
+#include "render_graph.h"
+
+namespace engine
+{
+	constexpr VkPipelineStageFlags2 kRGShaderStages =
+		VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+		VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT |
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+	constexpr VkAccessFlags2 kRGWriteAccesses =
+		VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+		VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_TRANSFER_WRITE_BIT |
+		VK_ACCESS_2_HOST_WRITE_BIT |
+		VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+	// Stages compute queue support, graph only use these in compute pass.
+	constexpr VkPipelineStageFlags2 kRGComputeQueueStages =
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+		VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT |
+		VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+		VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+	constexpr VkAccessFlags2 kRGAttachmentAccesses =
+		VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT |
+		VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+		VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+	struct RGAccessInfo
+	{
+		VkImageLayout layout;
+		VkPipelineStageFlags2 stages;
+		VkAccessFlags2 accesses;
+	};
+
+	static RGAccessInfo getImageAccessInfo(ERGImageAccess access)
+	{
+		switch (access)
+		{
+		case ERGImageAccess::SampledRead:
+			return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, kRGShaderStages, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+		case ERGImageAccess::StorageRead:
+			return { VK_IMAGE_LAYOUT_GENERAL, kRGShaderStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
+		case ERGImageAccess::StorageWrite:
+			return { VK_IMAGE_LAYOUT_GENERAL, kRGShaderStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+		case ERGImageAccess::ColorAttachment:
+			return
+			{
+				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+				VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+			};
+		case ERGImageAccess::DepthAttachment:
+			return
+			{
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+			};
+		case ERGImageAccess::TransferSrc:
+			return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT };
+		case ERGImageAccess::TransferDst:
+			return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+		}
+
+		CHECK_ENTRY();
+		return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT };
+	}
+
+	// Stage and write access may happen in old layout, pass inner code can transition without declare.
+	static RGAccessInfo getLayoutSrcScope(VkImageLayout layout)
+	{
+		switch (layout)
+		{
+		case VK_IMAGE_LAYOUT_UNDEFINED:
+			return { layout, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+		case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+			return { layout, kRGShaderStages, VK_ACCESS_2_NONE };
+		case VK_IMAGE_LAYOUT_GENERAL:
+			return { layout, kRGShaderStages | VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT };
+		case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+			return { layout, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+			return
+			{
+				layout,
+				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+			};
+		case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+			return { layout, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_NONE };
+		case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+			return { layout, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+		default:
+			return { layout, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT };
+		}
+	}
+
+	static RGAccessInfo getBufferAccessInfo(ERGBufferAccess access)
+	{
+		switch (access)
+		{
+		case ERGBufferAccess::UniformRead:
+			return { VK_IMAGE_LAYOUT_UNDEFINED, kRGShaderStages, VK_ACCESS_2_UNIFORM_READ_BIT };
+		case ERGBufferAccess::StorageRead:
+			return { VK_IMAGE_LAYOUT_UNDEFINED, kRGShaderStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
+		case ERGBufferAccess::StorageWrite:
+			return { VK_IMAGE_LAYOUT_UNDEFINED, kRGShaderStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+		case ERGBufferAccess::IndirectRead:
+			return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT };
+		case ERGBufferAccess::TransferSrc:
+			return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT };
+		case ERGBufferAccess::TransferDst:
+			return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+		}
+
+		CHECK_ENTRY();
+		return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT };
+	}
+
+	static VkImageAspectFlags getFormatAspect(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		case VK_FORMAT_S8_UINT:
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+	}
+
+	// Barrier record on compute queue can't use graphics stage, attachment work already visible by queue transfer.
+	static void maskComputeQueueScope(VkPipelineStageFlags2& stages, VkAccessFlags2& accesses)
+	{
+		stages &= kRGComputeQueueStages;
+		accesses &= ~kRGAttachmentAccesses;
+		if (stages == VK_PIPELINE_STAGE_2_NONE && accesses != VK_ACCESS_2_NONE)
+		{
+			stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+		}
+	}
+
+	static VkImageSubresourceRange resolveImageRange(const VulkanImage& image, const VkImageSubresourceRange& inRange)
+	{
+		VkImageSubresourceRange range = inRange;
+
+		const uint32_t layerEnd = (range.layerCount == VK_REMAINING_ARRAY_LAYERS)
+			? image.getInfo().arrayLayers
+			: std::min(range.baseArrayLayer + range.layerCount, image.getInfo().arrayLayers);
+		const uint32_t mipEnd = (range.levelCount == VK_REMAINING_MIP_LEVELS)
+			? image.getInfo().mipLevels
+			: std::min(range.baseMipLevel + range.levelCount, image.getInfo().mipLevels);
+
+		range.layerCount = layerEnd - range.baseArrayLayer;
+		range.levelCount = mipEnd - range.baseMipLevel;
+		return range;
+	}
+
+	// Call func for each sub range with same layout, most time whole range same layout so merge as one.
+	template<typename Func>
+	static void forEachLayoutRange(const VulkanImage& image, const VkImageSubresourceRange& range, Func&& func)
+	{
+		const uint32_t layerEnd = range.baseArrayLayer + range.layerCount;
+		const uint32_t mipEnd = range.baseMipLevel + range.levelCount;
+
+		const VkImageLayout firstLayout = image.getCurrentLayout(range.baseArrayLayer, range.baseMipLevel);
+		bool bUniformLayout = true;
+		for (uint32_t layer = range.baseArrayLayer; layer < layerEnd && bUniformLayout; layer++)
+		{
+			for (uint32_t mip = range.baseMipLevel; mip < mipEnd; mip++)
+			{
+				if (image.getCurrentLayout(layer, mip) != firstLayout)
+				{
+					bUniformLayout = false;
+					break;
+				}
+			}
+		}
+
+		if (bUniformLayout)
+		{
+			func(firstLayout, range);
+			return;
+		}
+
+		for (uint32_t layer = range.baseArrayLayer; layer < layerEnd; layer++)
+		{
+			for (uint32_t mip = range.baseMipLevel; mip < mipEnd; mip++)
+			{
+				VkImageSubresourceRange subRange = range;
+				subRange.baseArrayLayer = layer;
+				subRange.layerCount = 1;
+				subRange.baseMipLevel = mip;
+				subRange.levelCount = 1;
+
+				func(image.getCurrentLayout(layer, mip), subRange);
+			}
+		}
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::imageAccess(RGImage image, ERGImageAccess access, bool bWrite, const VkImageSubresourceRange* range)
+	{
+		CHECK(image.isValid() && image.id < m_graph->m_images.size());
+
+		ImageAccess result{ };
+		result.resource = image.id;
+		result.access = access;
+		result.bWrite = bWrite;
+		result.bWholeImage = (range == nullptr);
+		if (range)
+		{
+			result.range = *range;
+		}
+
+		m_graph->m_passes[m_passId].imageAccesses.push_back(result);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::bufferAccess(RGBuffer buffer, ERGBufferAccess access, bool bWrite)
+	{
+		CHECK(buffer.isValid() && buffer.id < m_graph->m_buffers.size());
+
+		m_graph->m_passes[m_passId].bufferAccesses.push_back({ buffer.id, access, bWrite });
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(RGImage image, ERGImageAccess access)
+	{
+		return imageAccess(image, access, false, nullptr);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(RGImage image, ERGImageAccess access, const VkImageSubresourceRange& range)
+	{
+		return imageAccess(image, access, false, &range);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(RGImage image, ERGImageAccess access)
+	{
+		return imageAccess(image, access, true, nullptr);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(RGImage image, ERGImageAccess access, const VkImageSubresourceRange& range)
+	{
+		return imageAccess(image, access, true, &range);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(RGBuffer buffer, ERGBufferAccess access)
+	{
+		return bufferAccess(buffer, access, false);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(RGBuffer buffer, ERGBufferAccess access)
+	{
+		return bufferAccess(buffer, access, true);
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::sideEffect()
+	{
+		m_graph->m_passes[m_passId].bSideEffect = true;
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::asyncCompute(bool bEnable)
+	{
+		m_graph->m_passes[m_passId].bAsyncCompute = bEnable;
+		return *this;
+	}
+
+	RGImage RenderGraph::importImage(const char* name, PoolImageSharedRef image)
+	{
+		CHECK(image != nullptr);
+
+		ImageResource resource{ };
+		resource.name = name;
+		resource.ref = image;
+
+		m_images.push_back(resource);
+		return RGImage{ uint32_t(m_images.size() - 1) };
+	}
+
+	RGImage RenderGraph::createImage(const char* name, const VkImageCreateInfo& createInfo)
+	{
+		ImageResource resource{ };
+		resource.name = name;
+		resource.ref = m_context->getRenderTargetPools().createTransientImage();
+		resource.bTransient = true;
+		resource.createInfo = createInfo;
+
+		m_images.push_back(resource);
+		return RGImage{ uint32_t(m_images.size() - 1) };
+	}
+
+	RGImage RenderGraph::createImage(const char* name, uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage)
+	{
+		return createImage(name, RenderTexturePool::buildImageCreateInfo(width, height, format, usage));
+	}
+
+	RGImage RenderGraph::declareImage(const char* name)
+	{
+		ImageResource resource{ };
+		resource.name = name;
+
+		m_images.push_back(resource);
+		return RGImage{ uint32_t(m_images.size() - 1) };
+	}
+
+	void RenderGraph::setImage(RGImage image, PoolImageSharedRef ref)
+	{
+		CHECK(image.isValid() && image.id < m_images.size());
+		CHECK(!m_images[image.id].bTransient);
+
+		m_images[image.id].ref = ref;
+	}
+
+	RGBuffer RenderGraph::importBuffer(const char* name, BufferParameterHandle buffer)
+	{
+		CHECK(buffer != nullptr);
+
+		BufferResource resource{ };
+		resource.name = name;
+		resource.ref = buffer;
+
+		m_buffers.push_back(resource);
+		return RGBuffer{ uint32_t(m_buffers.size() - 1) };
+	}
+
+	RGBuffer RenderGraph::declareBuffer(const char* name)
+	{
+		BufferResource resource{ };
+		resource.name = name;
+
+		m_buffers.push_back(resource);
+		return RGBuffer{ uint32_t(m_buffers.size() - 1) };
+	}
+
+	void RenderGraph::setBuffer(RGBuffer buffer, BufferParameterHandle ref)
+	{
+		CHECK(buffer.isValid() && buffer.id < m_buffers.size());
+		m_buffers[buffer.id].ref = ref;
+	}
+
+	PoolImageSharedRef RenderGraph::getImage(RGImage image) const
+	{
+		CHECK(image.isValid() && image.id < m_images.size());
+		return m_images[image.id].ref;
+	}
+
+	BufferParameterHandle RenderGraph::getBuffer(RGBuffer buffer) const
+	{
+		CHECK(buffer.isValid() && buffer.id < m_buffers.size());
+		return m_buffers[buffer.id].ref;
+	}
+
+	void RenderGraph::markOutput(RGImage image)
+	{
+		CHECK(image.isValid() && image.id < m_images.size());
+		m_images[image.id].bOutput = true;
+	}
+
+	void RenderGraph::markOutput(RGBuffer buffer)
+	{
+		CHECK(buffer.isValid() && buffer.id < m_buffers.size());
+		m_buffers[buffer.id].bOutput = true;
+	}
+
+	void RenderGraph::addPass(const char* name, std::function<void(PassBuilder&)>&& setup, std::function<void(VkCommandBuffer)>&& execute)
+	{
+		CHECK(!m_bExecuted);
+
+		Pass pass{ };
+		pass.name = name;
+		pass.execute = std::move(execute);
+		m_passes.push_back(std::move(pass));
+
+		PassBuilder builder(this, uint32_t(m_passes.size() - 1));
+		setup(builder);
+	}
+
+	void RenderGraph::cullPasses()
+	{
+		std::vector<bool> imageNeeded(m_images.size(), false);
+		std::vector<bool> bufferNeeded(m_buffers.size(), false);
+		for (size_t i = 0; i < m_images.size(); i++)
+		{
+			imageNeeded[i] = m_images[i].bOutput;
+		}
+		for (size_t i = 0; i < m_buffers.size(); i++)
+		{
+			bufferNeeded[i] = m_buffers[i].bOutput;
+		}
+
+		// Reverse walk, pass keep when side effect or write resource needed by later kept pass.
+		for (int32_t passId = int32_t(m_passes.size()) - 1; passId >= 0; passId--)
+		{
+			auto& pass = m_passes[passId];
+
+			bool bKeep = pass.bSideEffect;
+			for (const auto& access : pass.imageAccesses)
+			{
+				bKeep |= access.bWrite && imageNeeded[access.resource];
+			}
+			for (const auto& access : pass.bufferAccesses)
+			{
+				bKeep |= access.bWrite && bufferNeeded[access.resource];
+			}
+
+			pass.bCulled = !bKeep;
+			if (pass.bCulled)
+			{
+				continue;
+			}
+
+			// Write may partial or blend, so also depend on previous content.
+			for (const auto& access : pass.imageAccesses)
+			{
+				imageNeeded[access.resource] = true;
+			}
+			for (const auto& access : pass.bufferAccesses)
+			{
+				bufferNeeded[access.resource] = true;
+			}
+		}
+	}
+
+	void RenderGraph::allocateTransientImages()
+	{
+		constexpr uint32_t kInvalidPass = ~0;
+
+		std::vector<uint32_t> firstUse(m_images.size(), kInvalidPass);
+		std::vector<uint32_t> lastUse(m_images.size(), 0);
+		std::vector<bool> computeUse(m_images.size(), false);
+		for (uint32_t passId = 0; passId < m_passes.size(); passId++)
+		{
+			if (m_passes[passId].bCulled)
+			{
+				continue;
+			}
+
+			for (const auto& access : m_passes[passId].imageAccesses)
+			{
+				firstUse[access.resource] = std::min(firstUse[access.resource], passId);
+				lastUse[access.resource] = std::max(lastUse[access.resource], passId);
+				computeUse[access.resource] = computeUse[access.resource] || m_passes[passId].bCompute;
+			}
+		}
+
+		std::vector<RenderTexturePool::TransientImageRequest> requests;
+		for (size_t i = 0; i < m_images.size(); i++)
+		{
+			const auto& image = m_images[i];
+
+			// Transient no used by any kept pass no need memory.
+			if (!image.bTransient || firstUse[i] == kInvalidPass)
+			{
+				continue;
+			}
+
+			// Output still used after graph, extend lifetime to graph end.
+			uint32_t firstPass = firstUse[i];
+			uint32_t lastPass = image.bOutput ? uint32_t(m_passes.size()) : lastUse[i];
+
+			// Compute queue pass overlap with graphics passes out of pass order, never alias.
+			if (computeUse[i])
+			{
+				firstPass = 0;
+				lastPass = uint32_t(m_passes.size());
+			}
+
+			requests.push_back({ image.ref, image.name, image.createInfo, firstPass, lastPass });
+		}
+
+		if (!requests.empty())
+		{
+			m_context->getRenderTargetPools().bindTransientImages(requests);
+		}
+	}
+
+	void RenderGraph::recordPassBarriers(VkCommandBuffer cmd, Pass& pass)
+	{
+		std::vector<VkImageMemoryBarrier2> imageBarriers;
+		std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+
+		const uint32_t queueFamily = pass.bCompute ? m_context->getComputeFamily() : m_context->getGraphiscFamily();
+
+		for (const auto& access : pass.imageAccesses)
+		{
+			auto& resource = m_images[access.resource];
+			RGAccessInfo dst = getImageAccessInfo(access.access);
+			if (pass.bCompute)
+			{
+				maskComputeQueueScope(dst.stages, dst.accesses);
+			}
+
+			// Image create inside this pass, or optional output no produced and consumer handle null itself.
+			if (resource.ref != nullptr)
+			{
+				VulkanImage& image = resource.ref->getImage();
+				const VkImageSubresourceRange range = resolveImageRange(image,
+					access.bWholeImage ? RHIDefaultImageSubresourceRange(getFormatAspect(image.getFormat())) : access.range);
+
+				// Transient memory may alias, first use discard old content.
+				const bool bTransientFirstUse = resource.bTransient && !resource.bUsed;
+
+				auto buildBarrier = [&](VkImageLayout oldLayout, const VkImageSubresourceRange& subRange)
+				{
+					VkPipelineStageFlags2 srcStages;
+					VkAccessFlags2 srcAccesses;
+					if (bTransientFirstUse)
+					{
+						oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+						srcStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+						srcAccesses = VK_ACCESS_2_MEMORY_WRITE_BIT;
+					}
+					else
+					{
+						const RGAccessInfo layoutScope = getLayoutSrcScope(oldLayout);
+						srcStages = layoutScope.stages;
+						srcAccesses = layoutScope.accesses;
+						if (resource.bUsed)
+						{
+							srcStages |= resource.lastStages;
+							srcAccesses |= resource.bLastWrite ? (resource.lastAccesses & kRGWriteAccesses) : VK_ACCESS_2_NONE;
+						}
+
+						// Read after read in same layout no hazard.
+						const bool bHazard =
+							(oldLayout != dst.layout) ||
+							access.bWrite ||
+							(resource.bUsed ? resource.bLastWrite : (srcAccesses != VK_ACCESS_2_NONE));
+						if (!bHazard)
+						{
+							return;
+						}
+					}
+
+					if (pass.bCompute)
+					{
+						maskComputeQueueScope(srcStages, srcAccesses);
+					}
+
+					VkImageMemoryBarrier2 barrier = RHIImageBarrier(
+						image.getImage(), srcStages, srcAccesses, oldLayout, dst.stages, dst.accesses, dst.layout, range.aspectMask, subRange.baseMipLevel, subRange.levelCount);
+					barrier.subresourceRange.baseArrayLayer = subRange.baseArrayLayer;
+					barrier.subresourceRange.layerCount = subRange.layerCount;
+					imageBarriers.push_back(barrier);
+				};
+
+				if (bTransientFirstUse)
+				{
+					buildBarrier(VK_IMAGE_LAYOUT_UNDEFINED, range);
+				}
+				else
+				{
+					forEachLayoutRange(image, range, buildBarrier);
+				}
+
+				image.setCurrentLayout(dst.layout, range, queueFamily);
+			}
+
+			resource.bUsed = true;
+			resource.bLastWrite = access.bWrite;
+			resource.lastStages = dst.stages;
+			resource.lastAccesses = dst.accesses;
+		}
+
+		for (const auto& access : pass.bufferAccesses)
+		{
+			auto& resource = m_buffers[access.resource];
+			RGAccessInfo dst = getBufferAccessInfo(access.access);
+			if (pass.bCompute)
+			{
+				maskComputeQueueScope(dst.stages, dst.accesses);
+			}
+
+			// Same as image, skip when buffer no set.
+			if (resource.ref != nullptr)
+			{
+				const VkBuffer buffer = resource.ref->getBuffer()->getVkBuffer();
+
+				VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+				VkAccessFlags2 srcAccesses = VK_ACCESS_2_NONE;
+				bool bBarrier = false;
+				if (!resource.bUsed)
+				{
+					// Imported buffer may write by outside graph.
+					srcStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+					srcAccesses = VK_ACCESS_2_MEMORY_WRITE_BIT;
+					bBarrier = true;
+				}
+				else if (resource.bLastWrite || access.bWrite)
+				{
+					srcStages = resource.lastStages;
+					srcAccesses = resource.bLastWrite ? (resource.lastAccesses & kRGWriteAccesses) : VK_ACCESS_2_NONE;
+					bBarrier = true;
+				}
+
+				if (bBarrier)
+				{
+					if (pass.bCompute)
+					{
+						maskComputeQueueScope(srcStages, srcAccesses);
+					}
+					bufferBarriers.push_back(RHIBufferBarrier(buffer, srcStages, srcAccesses, dst.stages, dst.accesses));
+				}
+			}
+
+			resource.bUsed = true;
+			resource.bLastWrite = access.bWrite;
+			resource.lastStages = dst.stages;
+			resource.lastAccesses = dst.accesses;
+		}
+
+		// One barrier call for whole pass.
+		if (!imageBarriers.empty() || !bufferBarriers.empty())
+		{
+			RHIPipelineBarrier(cmd, 0, bufferBarriers.size(), bufferBarriers.data(), imageBarriers.size(), imageBarriers.data());
+		}
+	}
+
+	bool RenderGraph::scheduleQueues()
+	{
+		auto& scheduler = m_context->getAsyncCompute();
+		if (!scheduler.isEnable())
+		{
+			return false;
+		}
+
+		bool bAnyCompute = false;
+		for (auto& pass : m_passes)
+		{
+			pass.bCompute = !pass.bCulled && pass.bAsyncCompute;
+			for (const auto& access : pass.imageAccesses)
+			{
+				if (access.access == ERGImageAccess::ColorAttachment || access.access == ERGImageAccess::DepthAttachment)
+				{
+					pass.bCompute = false;
+				}
+			}
+			bAnyCompute |= pass.bCompute;
+		}
+
+		if (!bAnyCompute)
+		{
+			return false;
+		}
+
+		// Pass which last access resource before other queue access it, segment must signal after it.
+		{
+			constexpr uint32_t kInvalidPass = ~0;
+
+			std::vector<uint32_t> imageLastPass(m_images.size(), kInvalidPass);
+			std::vector<uint32_t> bufferLastPass(m_buffers.size(), kInvalidPass);
+			for (uint32_t passId = 0; passId < m_passes.size(); passId++)
+			{
+				auto& pass = m_passes[passId];
+				if (pass.bCulled)
+				{
+					continue;
+				}
+
+				auto markSignal = [&](uint32_t& lastPass)
+				{
+					if (lastPass != kInvalidPass && m_passes[lastPass].bCompute != pass.bCompute)
+					{
+						m_passes[lastPass].bSignalAfter = true;
+					}
+					lastPass = passId;
+				};
+
+				for (const auto& access : pass.imageAccesses)
+				{
+					markSignal(imageLastPass[access.resource]);
+				}
+				for (const auto& access : pass.bufferAccesses)
+				{
+					markSignal(bufferLastPass[access.resource]);
+				}
+			}
+		}
+
+		// Segment zero is work record before graph, closed and only append queue release.
+		const auto tail = scheduler.getGraphicsTail();
+		m_segments.clear();
+		m_segments.push_back({ false, tail.cmd, tail.signalValue, 0 });
+
+		m_imageSegments.assign(m_images.size(), 0);
+		m_bufferSegments.assign(m_buffers.size(), 0);
+
+		constexpr uint32_t kInvalidSegment = ~0;
+		uint32_t openGraphicsSegment = kInvalidSegment;
+		uint32_t openComputeSegment = kInvalidSegment;
+
+		for (auto& pass : m_passes)
+		{
+			if (pass.bCulled)
+			{
+				continue;
+			}
+
+			// Compute queue no implicit order with graphics, at least wait work before graph.
+			uint64_t waitValue = pass.bCompute ? m_segments[0].signalValue : 0;
+
+			pass.acquires.clear();
+			auto collectTransfer = [&](bool bBuffer, uint32_t resource, uint32_t srcSegment)
+			{
+				if (m_segments[srcSegment].bCompute == pass.bCompute)
+				{
+					return;
+				}
+
+				waitValue = std::max(waitValue, m_segments[srcSegment].signalValue);
+				for (const auto& transfer : pass.acquires)
+				{
+					if (transfer.bBuffer == bBuffer && transfer.resource == resource)
+					{
+						return;
+					}
+				}
+				pass.acquires.push_back({ bBuffer, resource, srcSegment });
+			};
+
+			for (const auto& access : pass.imageAccesses)
+			{
+				collectTransfer(false, access.resource, m_imageSegments[access.resource]);
+			}
+			for (const auto& access : pass.bufferAccesses)
+			{
+				collectTransfer(true, access.resource, m_bufferSegments[access.resource]);
+			}
+
+			// New segment when no open one or need wait more work of other queue.
+			uint32_t& openSegment = pass.bCompute ? openComputeSegment : openGraphicsSegment;
+			if (openSegment == kInvalidSegment || waitValue > m_segments[openSegment].waitValue)
+			{
+				const auto segment = pass.bCompute ? scheduler.addComputeSegment(waitValue) : scheduler.addGraphicsSegment(waitValue);
+				m_segments.push_back({ pass.bCompute, segment.cmd, segment.signalValue, waitValue });
+				openSegment = uint32_t(m_segments.size() - 1);
+			}
+
+			pass.segment = openSegment;
+			for (const auto& access : pass.imageAccesses)
+			{
+				m_imageSegments[access.resource] = openSegment;
+			}
+			for (const auto& access : pass.bufferAccesses)
+			{
+				m_bufferSegments[access.resource] = openSegment;
+			}
+
+			if (pass.bSignalAfter)
+			{
+				openSegment = kInvalidSegment;
+			}
+		}
+
+		return true;
+	}
+
+	void RenderGraph::recordQueueTransfers(const std::vector<QueueTransfer>& transfers, uint32_t dstSegment)
+	{
+		if (transfers.empty())
+		{
+			return;
+		}
+
+		const auto getFamily = [&](uint32_t segment)
+		{
+			return m_segments[segment].bCompute ? m_context->getComputeFamily() : m_context->getGraphiscFamily();
+		};
+		const uint32_t dstFamily = getFamily(dstSegment);
+
+		std::vector<VkImageMemoryBarrier2> acquireImageBarriers;
+		std::vector<VkBufferMemoryBarrier2> acquireBufferBarriers;
+
+		// Release record at end of source segment, which already closed when schedule.
+		std::vector<uint32_t> srcSegments;
+		for (const auto& transfer : transfers)
+		{
+			if (std::find(srcSegments.begin(), srcSegments.end(), transfer.srcSegment) == srcSegments.end())
+			{
+				srcSegments.push_back(transfer.srcSegment);
+			}
+		}
+
+		for (const uint32_t srcSegment : srcSegments)
+		{
+			const bool bSrcCompute = m_segments[srcSegment].bCompute;
+			const uint32_t srcFamily = getFamily(srcSegment);
+
+			std::vector<VkImageMemoryBarrier2> releaseImageBarriers;
+			std::vector<VkBufferMemoryBarrier2> releaseBufferBarriers;
+			for (const auto& transfer : transfers)
+			{
+				if (transfer.srcSegment != srcSegment)
+				{
+					continue;
+				}
+
+				if (transfer.bBuffer)
+				{
+					auto& resource = m_buffers[transfer.resource];
+					if (resource.ref != nullptr)
+					{
+						VkPipelineStageFlags2 srcStages = resource.bUsed ? resource.lastStages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+						VkAccessFlags2 srcAccesses = resource.bUsed
+							? (resource.bLastWrite ? (resource.lastAccesses & kRGWriteAccesses) : VK_ACCESS_2_NONE)
+							: VK_ACCESS_2_MEMORY_WRITE_BIT;
+						if (bSrcCompute)
+						{
+							maskComputeQueueScope(srcStages, srcAccesses);
+						}
+
+						VkBufferMemoryBarrier2 release = RHIBufferBarrier(resource.ref->getBuffer()->getVkBuffer(),
+							srcStages, srcAccesses, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+						release.srcQueueFamilyIndex = srcFamily;
+						release.dstQueueFamilyIndex = dstFamily;
+						releaseBufferBarriers.push_back(release);
+
+						VkBufferMemoryBarrier2 acquire = release;
+						acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+						acquire.srcAccessMask = VK_ACCESS_2_NONE;
+						acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+						acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+						acquireBufferBarriers.push_back(acquire);
+					}
+
+					resource.bUsed = true;
+					resource.bLastWrite = false;
+					resource.lastStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+					resource.lastAccesses = VK_ACCESS_2_NONE;
+				}
+				else
+				{
+					auto& resource = m_images[transfer.resource];
+
+					// Transient content discard when first use, no need transfer.
+					if (resource.ref == nullptr || (resource.bTransient && !resource.bUsed))
+					{
+						continue;
+					}
+
+					VulkanImage& image = resource.ref->getImage();
+					const VkImageSubresourceRange range = resolveImageRange(image, RHIDefaultImageSubresourceRange(getFormatAspect(image.getFormat())));
+
+					forEachLayoutRange(image, range, [&](VkImageLayout layout, const VkImageSubresourceRange& subRange)
+					{
+						// Undefined content no need keep.
+						if (layout == VK_IMAGE_LAYOUT_UNDEFINED)
+						{
+							return;
+						}
+
+						const RGAccessInfo layoutScope = getLayoutSrcScope(layout);
+						VkPipelineStageFlags2 srcStages = layoutScope.stages;
+						VkAccessFlags2 srcAccesses = layoutScope.accesses;
+						if (resource.bUsed)
+						{
+							srcStages |= resource.lastStages;
+							srcAccesses |= resource.bLastWrite ? (resource.lastAccesses & kRGWriteAccesses) : VK_ACCESS_2_NONE;
+						}
+						if (bSrcCompute)
+						{
+							maskComputeQueueScope(srcStages, srcAccesses);
+						}
+
+						// Keep layout, consumer pass barrier do transition on own queue.
+						VkImageMemoryBarrier2 release = RHIImageBarrier(image.getImage(),
+							srcStages, srcAccesses, layout, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, layout, range.aspectMask, subRange.baseMipLevel, subRange.levelCount);
+						release.subresourceRange.baseArrayLayer = subRange.baseArrayLayer;
+						release.subresourceRange.layerCount = subRange.layerCount;
+						release.srcQueueFamilyIndex = srcFamily;
+						release.dstQueueFamilyIndex = dstFamily;
+						releaseImageBarriers.push_back(release);
+
+						VkImageMemoryBarrier2 acquire = release;
+						acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+						acquire.srcAccessMask = VK_ACCESS_2_NONE;
+						acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+						acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+						acquireImageBarriers.push_back(acquire);
+
+						image.setCurrentLayout(layout, subRange, dstFamily);
+					});
+
+					resource.bUsed = true;
+					resource.bLastWrite = false;
+					resource.lastStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+					resource.lastAccesses = VK_ACCESS_2_NONE;
+				}
+			}
+
+			if (!releaseImageBarriers.empty() || !releaseBufferBarriers.empty())
+			{
+				RHIPipelineBarrier(m_segments[srcSegment].cmd, 0,
+					releaseBufferBarriers.size(), releaseBufferBarriers.data(), releaseImageBarriers.size(), releaseImageBarriers.data());
+			}
+		}
+
+		if (!acquireImageBarriers.empty() || !acquireBufferBarriers.empty())
+		{
+			RHIPipelineBarrier(m_segments[dstSegment].cmd, 0,
+				acquireBufferBarriers.size(), acquireBufferBarriers.data(), acquireImageBarriers.size(), acquireImageBarriers.data());
+		}
+	}
+
+	void RenderGraph::joinAsyncCompute()
+	{
+		uint64_t lastComputeValue = 0;
+		uint32_t lastGraphicsSegment = 0;
+		for (uint32_t i = 0; i < m_segments.size(); i++)
+		{
+			if (m_segments[i].bCompute)
+			{
+				lastComputeValue = std::max(lastComputeValue, m_segments[i].signalValue);
+			}
+			else
+			{
+				lastGraphicsSegment = i;
+			}
+		}
+
+		// Work record after graph must see all compute result, reuse last graphics segment if it already wait.
+		if (lastGraphicsSegment == 0 || m_segments[lastGraphicsSegment].waitValue < lastComputeValue)
+		{
+			const auto segment = m_context->getAsyncCompute().addGraphicsSegment(lastComputeValue);
+			m_segments.push_back({ false, segment.cmd, segment.signalValue, lastComputeValue });
+			lastGraphicsSegment = uint32_t(m_segments.size() - 1);
+		}
+
+		// Resource still live after graph return to graphics queue, transient no output just drop.
+		std::vector<QueueTransfer> transfers;
+		for (uint32_t i = 0; i < m_images.size(); i++)
+		{
+			const uint32_t segment = m_imageSegments[i];
+			if (m_segments[segment].bCompute && !(m_images[i].bTransient && !m_images[i].bOutput))
+			{
+				transfers.push_back({ false, i, segment });
+			}
+		}
+		for (uint32_t i = 0; i < m_buffers.size(); i++)
+		{
+			const uint32_t segment = m_bufferSegments[i];
+			if (m_segments[segment].bCompute)
+			{
+				transfers.push_back({ true, i, segment });
+			}
+		}
+
+		recordQueueTransfers(transfers, lastGraphicsSegment);
+	}
+
+	void RenderGraph::execute(VkCommandBuffer cmd)
+	{
+		CHECK(!m_bExecuted);
+		m_bExecuted = true;
+
+		cullPasses();
+
+		// Graph append after work already split by previous graph.
+		auto& pool = m_context->getRenderTargetPools();
+		cmd = m_context->getAsyncCompute().getGraphicsCmd(cmd);
+		const bool bAsyncCompute = scheduleQueues();
+
+		allocateTransientImages();
+
+		// Pool image release inside pass may still used by other queue.
+		if (bAsyncCompute)
+		{
+			pool.beginDeferRelease();
+		}
+
+		for (auto& pass : m_passes)
+		{
+			if (pass.bCulled)
+			{
+				continue;
+			}
+
+			VkCommandBuffer passCmd = cmd;
+			if (bAsyncCompute)
+			{
+				passCmd = m_segments[pass.segment].cmd;
+				recordQueueTransfers(pass.acquires, pass.segment);
+			}
+
+			recordPassBarriers(passCmd, pass);
+			pass.execute(passCmd);
+		}
+
+		if (bAsyncCompute)
+		{
+			joinAsyncCompute();
+			pool.endDeferRelease();
+		}
+
+		// Release pass closures, resource reference may capture inside.
+		m_passes.clear();
+	}
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <rhi/rhi.h>
+#include <util/util.h>
+
+namespace engine
+{
+	// How pass use image, decide image layout and barrier scope.
+	enum class ERGImageAccess
+	{
+		SampledRead,     // SHADER_READ_ONLY, texture sample or fetch.
+		StorageRead,     // GENERAL, imageLoad only.
+		StorageWrite,    // GENERAL, imageStore.
+		ColorAttachment, // COLOR_ATTACHMENT, raster output.
+		DepthAttachment, // DEPTH_STENCIL_ATTACHMENT, depth test and write.
+		TransferSrc,
+		TransferDst,
+	};
+
+	enum class ERGBufferAccess
+	{
+		UniformRead,
+		StorageRead,
+		StorageWrite,
+		IndirectRead,
+		TransferSrc,
+		TransferDst,
+	};
+
+	struct RGImage
+	{
+		uint32_t id = ~0;
+		bool isValid() const { return id != ~0; }
+	};
+
+	struct RGBuffer
+	{
+		uint32_t id = ~0;
+		bool isValid() const { return id != ~0; }
+	};
+
+	// Frame render graph, passes declare resource usage in setup and record commands in execute.
+	// When execute graph:
+	//   1. Cull passes which output never used, pass with side effect or write marked output always keep.
+	//   2. Transient images which lifetime no overlap share memory in render texture pool alias heap.
+	//   3. Batch all barriers of one pass into single vkCmdPipelineBarrier2 before pass execute.
+	// Layout after barrier store back to image, so pass inner transition with same layout no emit barrier again.
+	//   4. When async compute enable, compute pass run on compute queue, graph split into queue segments:
+	//      segment signal after pass which other queue depend on, and consumer segment wait timeline value,
+	//      resource cross queue do queue family release in producer segment and acquire in consumer segment.
+	//      Graph end with graphics segment wait all compute work, resources owned by compute transfer back.
+	class RenderGraph : NonCopyable
+	{
+	public:
+		class PassBuilder
+		{
+		public:
+			PassBuilder& read(RGImage image, ERGImageAccess access = ERGImageAccess::SampledRead);
+			PassBuilder& read(RGImage image, ERGImageAccess access, const VkImageSubresourceRange& range);
+
+			PassBuilder& write(RGImage image, ERGImageAccess access);
+			PassBuilder& write(RGImage image, ERGImageAccess access, const VkImageSubresourceRange& range);
+
+			PassBuilder& read(RGBuffer buffer, ERGBufferAccess access = ERGBufferAccess::StorageRead);
+			PassBuilder& write(RGBuffer buffer, ERGBufferAccess access = ERGBufferAccess::StorageWrite);
+
+			// Pass write something out of graph (history, readback, cpu callback), never cull.
+			PassBuilder& sideEffect();
+
+			// Pass only dispatch compute or transfer can run on async compute queue.
+			// Pass declare attachment access always keep on graphics queue.
+			PassBuilder& asyncCompute(bool bEnable = true);
+
+		private:
+			friend RenderGraph;
+			explicit PassBuilder(RenderGraph* graph, uint32_t passId) : m_graph(graph), m_passId(passId) { }
+
+			PassBuilder& imageAccess(RGImage image, ERGImageAccess access, bool bWrite, const VkImageSubresourceRange* range);
+			PassBuilder& bufferAccess(RGBuffer buffer, ERGBufferAccess access, bool bWrite);
+
+			RenderGraph* m_graph;
+			uint32_t m_passId;
+		};
+
+		explicit RenderGraph(VulkanContext* context) : m_context(context) { }
+
+		// Image create and own outside graph, e.g. history or display output.
+		RGImage importImage(const char* name, PoolImageSharedRef image);
+
+		// Transient image only live inside graph, memory alias with other transient images.
+		// Reference valid after setup but image bind until graph execute.
+		RGImage createImage(const char* name, const VkImageCreateInfo& createInfo);
+		RGImage createImage(const char* name, uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage);
+
+		// Image produce inside some pass execute, producer must call setImage before consumer execute.
+		RGImage declareImage(const char* name);
+		void setImage(RGImage image, PoolImageSharedRef ref);
+
+		RGBuffer importBuffer(const char* name, BufferParameterHandle buffer);
+		RGBuffer declareBuffer(const char* name);
+		void setBuffer(RGBuffer buffer, BufferParameterHandle ref);
+
+		PoolImageSharedRef getImage(RGImage image) const;
+		BufferParameterHandle getBuffer(RGBuffer buffer) const;
+
+		// Resource still used after graph execute, writer pass of it never cull.
+		void markOutput(RGImage image);
+		void markOutput(RGBuffer buffer);
+
+		void addPass(const char* name, std::function<void(PassBuilder&)>&& setup, std::function<void(VkCommandBuffer)>&& execute);
+
+		// Compile and record all passes, graph can't reuse after execute.
+		void execute(VkCommandBuffer cmd);
+
+	private:
+		struct ImageAccess
+		{
+			uint32_t resource;
+			ERGImageAccess access;
+			bool bWrite;
+
+			// Whole image when no range, aspect decide by format.
+			bool bWholeImage;
+			VkImageSubresourceRange range;
+		};
+
+		struct BufferAccess
+		{
+			uint32_t resource;
+			ERGBufferAccess access;
+			bool bWrite;
+		};
+
+		// Resource last access on other queue segment, need queue family ownership transfer.
+		struct QueueTransfer
+		{
+			bool bBuffer;
+			uint32_t resource;
+			uint32_t srcSegment;
+		};
+
+		struct Pass
+		{
+			std::string name;
+			std::function<void(VkCommandBuffer)> execute;
+
+			std::vector<ImageAccess> imageAccesses;
+			std::vector<BufferAccess> bufferAccesses;
+
+			bool bSideEffect = false;
+			bool bCulled = false;
+
+			// Async compute schedule state.
+			bool bAsyncCompute = false;
+			bool bCompute = false;
+			bool bSignalAfter = false;
+			uint32_t segment = 0;
+			std::vector<QueueTransfer> acquires;
+		};
+
+		struct Segment
+		{
+			bool bCompute;
+			VkCommandBuffer cmd;
+
+			// Timeline value of own queue signal when finish, and other queue value wait before start.
+			uint64_t signalValue;
+			uint64_t waitValue;
+		};
+
+		struct ImageResource
+		{
+			std::string name;
+			PoolImageSharedRef ref = nullptr;
+
+			bool bTransient = false;
+			VkImageCreateInfo createInfo { };
+
+			bool bOutput = false;
+
+			// Runtime state when execute, last declared usage of this image.
+			bool bUsed = false;
+			bool bLastWrite = false;
+			VkPipelineStageFlags2 lastStages = VK_PIPELINE_STAGE_2_NONE;
+			VkAccessFlags2 lastAccesses = VK_ACCESS_2_NONE;
+		};
+
+		struct BufferResource
+		{
+			std::string name;
+			BufferParameterHandle ref = nullptr;
+
+			bool bOutput = false;
+
+			bool bUsed = false;
+			bool bLastWrite = false;
+			VkPipelineStageFlags2 lastStages = VK_PIPELINE_STAGE_2_NONE;
+			VkAccessFlags2 lastAccesses = VK_ACCESS_2_NONE;
+		};
+
+		void cullPasses();
+		void allocateTransientImages();
+		void recordPassBarriers(VkCommandBuffer cmd, Pass& pass);
+
+		// Assign pass queue and segment, return false if no pass run on compute queue.
+		bool scheduleQueues();
+		void recordQueueTransfers(const std::vector<QueueTransfer>& transfers, uint32_t dstSegment);
+		void joinAsyncCompute();
+
+	private:
+		VulkanContext* m_context;
+
+		std::vector<Pass> m_passes;
+		std::vector<ImageResource> m_images;
+		std::vector<BufferResource> m_buffers;
+
+		// Queue segments of async compute, first one is frame graphics tail before graph.
+		std::vector<Segment> m_segments;
+
+		// Segment of last access, used when schedule.
+		std::vector<uint32_t> m_imageSegments;
+		std::vector<uint32_t> m_bufferSegments;
+
+		bool m_bExecuted = false;
+	};
+}
@@ -1,9 +1,25 @@
 #include "render_scene.h"
 #include <scene/component/static_mesh.h>
 #include <scene/scene.h>
+#include "../../editor/editor.h"
+
+#include <bit>
+#include <numeric>
 
 namespace engine
 {
+	// Dirty node count to start parallel object fill.
+	constexpr size_t kMinDirtyNodeNumStartParallel = 64;
+
+	// Persistent object buffer min capacity, avoid grow often when scene small.
+	constexpr uint32_t kMinStaticMeshObjectsCapacity = 1024;
+
+	// Min stage size, stage size round up to power of two so buffer pool can reuse it.
+	constexpr VkDeviceSize kMinStaticMeshObjectsStageSize = 64 * 1024;
+
+	// Persistent pmx submesh buffer min capacity, one model usually own tens of submeshes.
+	constexpr uint32_t kMinPMXSubmeshesCapacity = 256;
+
 	RenderScene::RenderScene(VulkanContext* context, SceneManager* sceneManager)
 		: m_context(context), m_sceneManager(sceneManager)
 	{
@@ -17,26 +33,32 @@ namespace engine
 
 	void RenderScene::tick(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd)
 	{
+		CPU_PROFILER_SCOPE("RenderScene::tick");
+
 		m_postprocessVolumeInfo = {};
 		m_mmdCamera = {};
 
 		auto activeScene = m_sceneManager->getActiveScene();
 
-		renderObjectCollect(tickData, activeScene.get(), cmd);
+		// Active scene switch, persistent objects need rebuild.
+		const bool bSceneSwitch = m_staticMeshScene.lock() != activeScene;
+		m_staticMeshScene = activeScene;
+
+		renderObjectCollect(tickData, activeScene.get(), cmd, bSceneSwitch);
 
 		tlasPrepare(tickData, activeScene.get(), cmd);
 
 		lightCollect(activeScene.get(), cmd);
 
 
-		activeScene->loopComponents<PostprocessVolumeComponent>([&](std::shared_ptr<PostprocessVolumeComponent> comp) -> bool
+		activeScene->loopComponents<PostprocessVolumeComponent>([&](const std::shared_ptr<PostprocessVolumeComponent>& comp) -> bool
 		{
 			m_postprocessVolumeInfo = comp->getSetting();
 			return true;
 		});
 
 		activeScene->loopComponents<MMDCameraComponent>(
-			[&](std::shared_ptr<MMDCameraComponent> comp) -> bool
+			[&](const std::shared_ptr<MMDCameraComponent>& comp) -> bool
 		{
 			m_mmdCamera = comp;
 			return true;
@@ -78,51 +100,410 @@ namespace engine
 		view.frustumPlanes[5] = frustum.planes[5];
 	}
 
-	// All dynamic, no cache yet, I don't want to make the logic too complex, keep simple make life easy.
-	void RenderScene::renderObjectCollect(const RuntimeModuleTickData& tickData, Scene* scene, VkCommandBuffer cmd)
+	// Static mesh objects keep in persistent slots, only dirty nodes update and upload.
+	// Pmx objects skinning every frame, still collect all after static objects.
+	void RenderScene::renderObjectCollect(const RuntimeModuleTickData& tickData, Scene* scene, VkCommandBuffer cmd, bool bSceneSwitch)
 	{
-		// Clear AS instance.
-		m_cacheASInstances.clear();
-		m_staticmeshObjects.clear();
 		m_collectPMXes.clear();
+		m_pmxSubmeshes.clear();
 
 		// Collect all terrain object.
 		m_terrainComponents.clear();
-		scene->loopComponents<TerrainComponent>([&](std::shared_ptr<TerrainComponent> comp) -> bool
+		scene->loopComponents<TerrainComponent>([&](const std::shared_ptr<TerrainComponent>& comp) -> bool
 		{
 			m_terrainComponents.push_back(comp);
 			return false;
 		});
 
-		// Collect all pmx mesh object.
-		scene->loopComponents<PMXComponent>([&](std::shared_ptr<PMXComponent> comp) -> bool
+		// Collect all pmx mesh object, kick animation and physics first so they simulate when update static mesh.
+		scene->loopComponents<PMXComponent>([&](const std::shared_ptr<PMXComponent>& comp) -> bool
 		{
-			comp->onRenderTick(tickData, cmd, m_staticmeshObjects, m_cacheASInstances);
+			comp->kickAnimationJob(tickData);
 			m_collectPMXes.push_back(comp);
 			return false;
 		});
 
-		// Static mesh.
-		scene->loopComponents<StaticMeshComponent>([&](std::shared_ptr<StaticMeshComponent> comp) -> bool
+		// Static mesh, also drop last frame dynamic objects.
+		staticMeshObjectsUpdate(scene, bSceneSwitch);
+
+		// Pmx record in collect order, each one only wait its own job.
+		for (const auto& pmx : m_collectPMXes)
 		{
-			comp->renderObjectCollect(m_staticmeshObjects, m_cacheASInstances);
+			if (auto comp = pmx.lock())
+			{
+				comp->onRenderTick(tickData, cmd, m_staticmeshObjects, m_pmxSubmeshes, m_cacheASInstances);
+			}
+		}
 
-			// We need to loop all static mesh component.
-			return false;
+		// Now upload changed object info.
+		staticMeshObjectsUpload(tickData, cmd);
+		pmxSubmeshesUpload(tickData, cmd);
+	}
+
+	void RenderScene::staticMeshObjectsUpdate(Scene* scene, bool bSceneSwitch)
+	{
+		const bool bRaytrace = getContext()->getGraphicsCardState().bSupportRaytrace;
+
+		const size_t staticObjectCount = m_staticMeshSlotOwners.size();
+		m_staticmeshObjects.resize(staticObjectCount);
+		m_cacheASInstances.resize(bRaytrace ? staticObjectCount : 0);
+
+		auto& dirtyNodes = m_staticMeshDirtyNodes;
+		if (scene->consumeRenderDirty(dirtyNodes) || bSceneSwitch)
+		{
+			m_staticmeshObjects.clear();
+			m_cacheASInstances.clear();
+			m_staticMeshSlotOwners.clear();
+			m_staticMeshNodeSlots.clear();
+			m_staticMeshCarryNodes.clear();
+			m_staticMeshDirtySlots.clear();
+
+			dirtyNodes.clear();
+			scene->loopComponents<StaticMeshComponent>([&](const std::shared_ptr<StaticMeshComponent>& comp) -> bool
+			{
+				if (auto node = comp->getNode())
+				{
+					dirtyNodes.push_back(node->getId());
+				}
+				return false;
+			});
+		}
+
+		// Selection change no touch transform, diff selected nodes to find dirty objects.
+		{
+			std::vector<size_t> selectedNodes;
+			for (const auto& selected : Editor::get()->getSceneNodeSelected())
+			{
+				selectedNodes.push_back(selected.nodeId);
+			}
+			std::sort(selectedNodes.begin(), selectedNodes.end());
+
+			if (selectedNodes != m_cacheSelectedNodes)
+			{
+				std::set_symmetric_difference(
+					selectedNodes.begin(), selectedNodes.end(), 
+					m_cacheSelectedNodes.begin(), m_cacheSelectedNodes.end(), 
+					std::back_inserter(dirtyNodes));
+
+				m_cacheSelectedNodes = std::move(selectedNodes);
+			}
+		}
+
+		// Prev-frame model matrix change one frame late, so dirty nodes also update next frame.
+		const size_t currentDirtyCount = dirtyNodes.size();
+		dirtyNodes.insert(dirtyNodes.end(), m_staticMeshCarryNodes.begin(), m_staticMeshCarryNodes.end());
+		m_staticMeshCarryNodes.assign(dirtyNodes.begin(), dirtyNodes.begin() + currentDirtyCount);
+
+		std::sort(dirtyNodes.begin(), dirtyNodes.end());
+		dirtyNodes.erase(std::unique(dirtyNodes.begin(), dirtyNodes.end()), dirtyNodes.end());
+
+		if (dirtyNodes.empty())
+		{
+			return;
+		}
+
+		// Slot allocate and release serial, release may move other node's slot.
+		std::vector<std::shared_ptr<StaticMeshComponent>> dirtyComponents(dirtyNodes.size());
+		for (size_t i = 0; i < dirtyNodes.size(); i++)
+		{
+			dirtyComponents[i] = scene->getComponent<StaticMeshComponent>(dirtyNodes[i]);
+			staticMeshNodeSlotsResize(dirtyNodes[i], dirtyComponents[i] ? dirtyComponents[i]->getSubmeshCount() : 0);
+		}
+
+		struct UpdateObject
+		{
+			StaticMeshComponent* component;
+			const std::vector<uint32_t>* slots;
+		};
+		std::vector<UpdateObject> updateObjects;
+		updateObjects.reserve(dirtyNodes.size());
+
+		for (size_t i = 0; i < dirtyNodes.size(); i++)
+		{
+			auto iter = m_staticMeshNodeSlots.find(dirtyNodes[i]);
+			if (iter != m_staticMeshNodeSlots.end())
+			{
+				updateObjects.push_back({ dirtyComponents[i].get(), &iter->second });
+				m_staticMeshDirtySlots.insert(m_staticMeshDirtySlots.end(), iter->second.begin(), iter->second.end());
+			}
+		}
+
+		// Each node own its slots, fill parallel safe.
+		GPUStaticMeshPerObjectData* objects = m_staticmeshObjects.data();
+		VkAccelerationStructureInstanceKHR* asInstances = bRaytrace ? m_cacheASInstances.data() : nullptr;
+		auto fillObject = [&](size_t i)
+		{
+			updateObjects[i].component->renderObjectCollect(updateObjects[i].slots->data(), objects, asInstances);
+		};
+
+		if (updateObjects.size() > kMinDirtyNodeNumStartParallel)
+		{
+			ThreadPool::getDefault()->parallelFor(size_t(0), updateObjects.size(), [&](const size_t start, const size_t end)
+			{
+				for (size_t i = start; i < end; i++)
+				{
+					fillObject(i);
+				}
+			});
+		}
+		else
+		{
+			for (size_t i = 0; i < updateObjects.size(); i++)
+			{
+				fillObject(i);
+			}
+		}
+	}
+
+	void RenderScene::staticMeshNodeSlotsResize(size_t nodeId, uint32_t count)
+	{
+		const bool bRaytrace = getContext()->getGraphicsCardState().bSupportRaytrace;
+
+		auto iter = m_staticMeshNodeSlots.find(nodeId);
+		if (iter != m_staticMeshNodeSlots.end())
+		{
+			if (iter->second.size() == count)
+			{
+				return;
+			}
+
+			auto slots = std::move(iter->second);
+			m_staticMeshNodeSlots.erase(iter);
+
+			// Release big slot first, so last slot never belong to self node.
+			std::sort(slots.begin(), slots.end(), std::greater<uint32_t>());
+			for (const uint32_t slot : slots)
+			{
+				const uint32_t lastSlot = uint32_t(m_staticMeshSlotOwners.size() - 1);
+				if (slot != lastSlot)
+				{
+					const auto owner = m_staticMeshSlotOwners[lastSlot];
+
+					m_staticMeshSlotOwners[slot] = owner;
+					m_staticmeshObjects[slot] = m_staticmeshObjects[lastSlot];
+					if (bRaytrace)
+					{
+						m_cacheASInstances[slot] = m_cacheASInstances[lastSlot];
+						m_cacheASInstances[slot].instanceCustomIndex = slot;
+					}
+
+					m_staticMeshNodeSlots.at(owner.nodeId)[owner.objectIndex] = slot;
+					m_staticMeshDirtySlots.push_back(slot);
+				}
+
+				m_staticMeshSlotOwners.pop_back();
+				m_staticmeshObjects.pop_back();
+				if (bRaytrace)
+				{
+					m_cacheASInstances.pop_back();
+				}
+			}
+		}
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		auto& slots = m_staticMeshNodeSlots[nodeId];
+		slots.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			slots[i] = uint32_t(m_staticMeshSlotOwners.size());
+
+			m_staticMeshSlotOwners.push_back({ .nodeId = nodeId, .objectIndex = i });
+			m_staticmeshObjects.emplace_back();
+			if (bRaytrace)
+			{
+				m_cacheASInstances.emplace_back();
+			}
+		}
+	}
+
+	void RenderScene::staticMeshObjectsUpload(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd)
+	{
+		constexpr VkDeviceSize kObjectSize = sizeof(GPUStaticMeshPerObjectData);
+
+		// Release retired buffer when no frame in flight use it.
+		const uint64_t safeFrameCount = getContext()->getBackBufferCount() + 1;
+		std::erase_if(m_retiredStaticMeshObjectsGPU, [&](const auto& retired)
+		{
+			return tickData.tickCount >= retired.first + safeFrameCount;
+		});
+
+		const uint32_t staticObjectCount = uint32_t(m_staticMeshSlotOwners.size());
+		const uint32_t objectCount = uint32_t(m_staticmeshObjects.size());
+		if (objectCount == 0)
+		{
+			m_staticMeshDirtySlots.clear();
+			return;
+		}
+
+		// Grow gpu buffer, all static objects upload again.
+		if (objectCount > m_staticmeshObjectsCapacity)
+		{
+			if (m_staticmeshObjectsGPU)
+			{
+				m_retiredStaticMeshObjectsGPU.push_back({ tickData.tickCount, m_staticmeshObjectsGPU });
+			}
+
+			m_staticmeshObjectsCapacity = std::max(objectCount, m_staticmeshObjectsCapacity + m_staticmeshObjectsCapacity / 2);
+			m_staticmeshObjectsCapacity = std::max(m_staticmeshObjectsCapacity, kMinStaticMeshObjectsCapacity);
+
+			m_staticmeshObjectsGPU = std::make_shared<BufferParameterPool::BufferParameter>(
+				"StaticMeshObjects",
+				kObjectSize * m_staticmeshObjectsCapacity,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				VmaAllocationCreateFlags{},
+				nullptr);
+
+			m_staticMeshDirtySlots.resize(staticObjectCount);
+			std::iota(m_staticMeshDirtySlots.begin(), m_staticMeshDirtySlots.end(), 0U);
+		}
+
+		auto& dirtySlots = m_staticMeshDirtySlots;
+		std::sort(dirtySlots.begin(), dirtySlots.end());
+		dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+
+		// Merge continuous slots as one copy region.
+		std::vector<VkBufferCopy> regions;
+		VkDeviceSize stageSize = 0;
+		auto addRegion = [&](uint32_t start, uint32_t count)
+		{
+			regions.push_back({ .srcOffset = stageSize, .dstOffset = kObjectSize * start, .size = kObjectSize * count });
+			stageSize += kObjectSize * count;
+		};
+
+		for (size_t i = 0; i < dirtySlots.size() && dirtySlots[i] < staticObjectCount;)
+		{
+			const uint32_t start = dirtySlots[i];
+
+			uint32_t count = 1;
+			while (i + count < dirtySlots.size() && dirtySlots[i + count] == start + count && start + count < staticObjectCount)
+			{
+				count++;
+			}
+
+			addRegion(start, count);
+			i += count;
+		}
+		dirtySlots.clear();
+
+		// Dynamic objects upload every frame.
+		if (objectCount > staticObjectCount)
+		{
+			addRegion(staticObjectCount, objectCount - staticObjectCount);
+		}
+
+		if (regions.empty())
+		{
+			return;
+		}
+
+		auto stage = getContext()->getBufferParameters().getStageUpload("StaticMeshObjectsStage", std::bit_ceil(std::max(stageSize, kMinStaticMeshObjectsStageSize)));
+		{
+			auto* stageBuffer = stage->getBuffer();
+			stageBuffer->map();
+			for (const auto& region : regions)
+			{
+				memcpy((uint8_t*)stageBuffer->getMapped() + region.srcOffset, (const uint8_t*)m_staticmeshObjects.data() + region.dstOffset, region.size);
+			}
+			stageBuffer->unmap();
+		}
+
+		VkBuffer objectBuffer = m_staticmeshObjectsGPU->getBuffer()->getVkBuffer();
+
+		// Frames before may still read object buffer.
+		auto beginBarrier = RHIBufferBarrier(objectBuffer,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &beginBarrier, 0, nullptr);
+
+		vkCmdCopyBuffer(cmd, stage->getBuffer()->getVkBuffer(), objectBuffer, uint32_t(regions.size()), regions.data());
+
+		auto endBarrier = RHIBufferBarrier(objectBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &endBarrier, 0, nullptr);
+	}
+
+	void RenderScene::pmxSubmeshesUpload(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd)
+	{
+		constexpr VkDeviceSize kSubmeshSize = sizeof(PMXGpuSubmesh);
+
+		const uint64_t safeFrameCount = getContext()->getBackBufferCount() + 1;
+		std::erase_if(m_retiredPMXSubmeshesGPU, [&](const auto& retired)
+		{
+			return tickData.tickCount >= retired.first + safeFrameCount;
 		});
 
-		// Now update all static mesh info.
-		if (!m_staticmeshObjects.empty())
+		const uint32_t submeshCount = uint32_t(m_pmxSubmeshes.size());
+		if (submeshCount == 0)
 		{
-			m_staticmeshObjectsGPU = getContext()->getBufferParameters().getStaticStorage("StaticMeshObjects", sizeof(m_staticmeshObjects[0]) * m_staticmeshObjects.size());
-			m_staticmeshObjectsGPU->updateDataPtr((void*)m_staticmeshObjects.data());
+			m_uploadedPMXSubmeshes.clear();
+			return;
 		}
+
+		if (submeshCount > m_pmxSubmeshesCapacity)
+		{
+			if (m_pmxSubmeshesGPU)
+			{
+				m_retiredPMXSubmeshesGPU.push_back({ tickData.tickCount, m_pmxSubmeshesGPU });
+			}
+
+			m_pmxSubmeshesCapacity = std::max(submeshCount, m_pmxSubmeshesCapacity + m_pmxSubmeshesCapacity / 2);
+			m_pmxSubmeshesCapacity = std::max(m_pmxSubmeshesCapacity, kMinPMXSubmeshesCapacity);
+
+			m_pmxSubmeshesGPU = std::make_shared<BufferParameterPool::BufferParameter>(
+				"PMXSubmeshes",
+				kSubmeshSize * m_pmxSubmeshesCapacity,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				VmaAllocationCreateFlags{},
+				nullptr);
+
+			m_uploadedPMXSubmeshes.clear();
+		}
+
+		// Model pose in vertex buffer, submesh data only change when transform, material or selection change.
+		const bool bSame = (m_uploadedPMXSubmeshes.size() == m_pmxSubmeshes.size())
+			&& (memcmp(m_uploadedPMXSubmeshes.data(), m_pmxSubmeshes.data(), kSubmeshSize * submeshCount) == 0);
+		if (bSame)
+		{
+			return;
+		}
+		m_uploadedPMXSubmeshes = m_pmxSubmeshes;
+
+		const VkDeviceSize uploadSize = kSubmeshSize * submeshCount;
+		auto stage = getContext()->getBufferParameters().getStageUpload("PMXSubmeshesStage", std::bit_ceil(std::max(uploadSize, kMinStaticMeshObjectsStageSize)));
+		{
+			auto* stageBuffer = stage->getBuffer();
+			stageBuffer->map();
+			memcpy(stageBuffer->getMapped(), m_pmxSubmeshes.data(), uploadSize);
+			stageBuffer->unmap();
+		}
+
+		VkBuffer submeshBuffer = m_pmxSubmeshesGPU->getBuffer()->getVkBuffer();
+
+		auto beginBarrier = RHIBufferBarrier(submeshBuffer,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &beginBarrier, 0, nullptr);
+
+		VkBufferCopy region{ .srcOffset = 0, .dstOffset = 0, .size = uploadSize };
+		vkCmdCopyBuffer(cmd, stage->getBuffer()->getVkBuffer(), submeshBuffer, 1, &region);
+
+		auto endBarrier = RHIBufferBarrier(submeshBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &endBarrier, 0, nullptr);
 	}
 
 	void RenderScene::lightCollect(Scene* scene, VkCommandBuffer cmd)
 	{
 		// Sky component.
-		scene->loopComponents<SkyComponent>([&](std::shared_ptr<SkyComponent> comp) -> bool
+		scene->loopComponents<SkyComponent>([&](const std::shared_ptr<SkyComponent>& comp) -> bool
 		{
 			// Cache weak pointer. when move to multi-thread rendering, will require cache owner pointer or copy resource. but current just use weak ptr is enough.
 			m_sky = comp;
@@ -40,6 +40,10 @@ namespace engine
         bool isPMXExist() const { return !m_collectPMXes.empty(); }
         auto& getPMXes() { return m_collectPMXes; }
 
+        // PMX submeshes collect every frame, used by gpu culling and indirect draw.
+        const auto& getPMXSubmeshes() const { return m_pmxSubmeshes; }
+        const BufferParameterHandle& getPMXSubmeshesGPU() const { return m_pmxSubmeshesGPU; }
+
         bool isASValid() const;
         TLASBuilder* getAS() { return &m_tlas; }
         void unvalidAS() { m_tlas.destroy(); }
@@ -48,7 +52,19 @@ namespace engine
         void fillMMDCameraInfo(GPUPerFrameData& data, float width, float height);
 
     private:
-        void renderObjectCollect(const RuntimeModuleTickData& tickData, class Scene* scene, VkCommandBuffer cmd);
+        void renderObjectCollect(const RuntimeModuleTickData& tickData, class Scene* scene, VkCommandBuffer cmd, bool bSceneSwitch);
+
+        // Incremental update persistent static mesh object slots by scene dirty nodes.
+        void staticMeshObjectsUpdate(class Scene* scene, bool bSceneSwitch);
+
+        // Allocate or release slots of node to match object count.
+        void staticMeshNodeSlotsResize(size_t nodeId, uint32_t count);
+
+        // Scatter upload dirty static objects and per-frame dynamic objects.
+        void staticMeshObjectsUpload(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd);
+
+        // Upload pmx submeshes when changed, gpu buffer keep last frame content.
+        void pmxSubmeshesUpload(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd);
 
         void lightCollect(class Scene* scene, VkCommandBuffer cmd);
 
@@ -58,9 +74,37 @@ namespace engine
         VulkanContext* m_context;
         SceneManager* m_sceneManager;
 
-        // Static mesh object info in scene.
+        // Static mesh object info in scene, persistent static objects first then per-frame dynamic objects (pmx).
         std::vector<GPUStaticMeshPerObjectData> m_staticmeshObjects;
+
+        // Persistent gpu object buffer, only dirty slots upload each frame.
         BufferParameterHandle m_staticmeshObjectsGPU;
+        uint32_t m_staticmeshObjectsCapacity = 0;
+
+        // Old gpu buffer release after frames in flight finish.
+        std::vector<std::pair<uint64_t, BufferParameterHandle>> m_retiredStaticMeshObjectsGPU;
+
+        // Slot owner of static object, slot dense packed, move last slot to hole when release.
+        struct StaticMeshSlotOwner
+        {
+            size_t nodeId;
+            uint32_t objectIndex;
+        };
+        std::vector<StaticMeshSlotOwner> m_staticMeshSlotOwners;
+        std::unordered_map<size_t, std::vector<uint32_t>> m_staticMeshNodeSlots;
+
+        // Slots need upload this frame.
+        std::vector<uint32_t> m_staticMeshDirtySlots;
+
+        // Node dirty last frame, update again this frame to refresh prev-frame model matrix.
+        std::vector<size_t> m_staticMeshCarryNodes;
+        std::vector<size_t> m_staticMeshDirtyNodes;
+
+        // Scene which persistent objects build from, rebuild when active scene switch.
+        std::weak_ptr<class Scene> m_staticMeshScene;
+
+        // Selected node ids of last frame, diff to find selection change nodes.
+        std::vector<size_t> m_cacheSelectedNodes;
 
         // Sky object info in scene. current only support one sky.
         GPUSkyInfo m_skyGPU;
@@ -77,6 +121,15 @@ namespace engine
         // PMX collect components.
         std::vector<std::weak_ptr<PMXComponent>> m_collectPMXes;
 
+        // PMX submeshes of this frame, and last uploaded copy to skip upload when no change.
+        std::vector<PMXGpuSubmesh> m_pmxSubmeshes;
+        std::vector<PMXGpuSubmesh> m_uploadedPMXSubmeshes;
+
+        // Persistent pmx submesh buffer, grow same as static mesh object buffer.
+        BufferParameterHandle m_pmxSubmeshesGPU;
+        uint32_t m_pmxSubmeshesCapacity = 0;
+        std::vector<std::pair<uint64_t, BufferParameterHandle>> m_retiredPMXSubmeshesGPU;
+
         TLASBuilder m_tlas;
         std::vector<VkAccelerationStructureInstanceKHR> m_cacheASInstances;
 
@@ -36,6 +36,9 @@ namespace engine
             initWindowCommandContext();
 
             m_imguiManager.init(m_context);
+
+            // Create all registered passes pipelines up front, parallel on worker threads when enable.
+            m_context->getPasses().initAllRegisteredPasses();
         }
 
         return true;
@@ -82,6 +85,10 @@ namespace engine
                 // Prepare current
                 VkCommandBuffer graphicsCmd = m_windowCmdContext.mainCmdRing.at(backBufferIndex);
 
+                // Frame fence already wait, main command buffer become first graphics segment of async compute.
+                m_context->getAsyncCompute().beginFrame(graphicsCmd);
+                m_context->getParallelCommandRecorder().beginFrame();
+
                 // Record.
                 rendererTick(graphicsCmd);
 
@@ -93,12 +100,9 @@ namespace engine
                 auto graphicsCmdEndSemaphore = m_windowCmdContext.mainSemaphoreRing[backBufferIndex];
                 auto frameEndSemaphore       = m_context->getCurrentFrameFinishSemaphore();
 
-                // Submit with semaphore.
-                RHISubmitInfo graphicsCmdSubmitInfo{};
-                graphicsCmdSubmitInfo.setWaitStage(&waitFlags)
-                    .setWaitSemaphore(&frameStartSemaphore, 1)
-                    .setSignalSemaphore(&graphicsCmdEndSemaphore, 1)
-                    .setCommandBuffer(&graphicsCmd, 1);
+                // Submit compute segments, graphics segments submit with ui in order.
+                std::vector<VkSubmitInfo> infosRawSubmit{ };
+                m_context->getAsyncCompute().endFrame(frameStartSemaphore, waitFlags, graphicsCmdEndSemaphore, infosRawSubmit);
 
                 RHISubmitInfo uiCmdSubmitInfo{};
                 VkCommandBuffer uiCmdBuffer = m_imguiManager.getCommandBuffer(backBufferIndex);
@@ -107,7 +111,7 @@ namespace engine
                     .setSignalSemaphore(&frameEndSemaphore, 1)
                     .setCommandBuffer(&uiCmdBuffer, 1);
 
-                std::vector<VkSubmitInfo> infosRawSubmit{ graphicsCmdSubmitInfo, uiCmdSubmitInfo };
+                infosRawSubmit.push_back(uiCmdSubmitInfo);
 
                 m_context->resetFence();
                 m_context->submit((uint32_t)infosRawSubmit.size(), infosRawSubmit.data());
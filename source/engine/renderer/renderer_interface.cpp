@@ -8,6 +8,22 @@ namespace engine
 {
 
 	AutoCVarInt32 cVarTAAEnable("r.taa.enable", "enable taa or not.", "engne", 1);
+
+	static AutoCVarFloat cVarStaticMeshLODScale(
+		"r.StaticMesh.LODScale",
+		"Static mesh LOD switch screen size scale, bigger keep LOD0 farther.",
+		"StaticMesh",
+		0.5f,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarStaticMeshForceLOD(
+		"r.StaticMesh.ForceLOD",
+		"Force static mesh LOD when >= 0, -1 is auto select by screen size.",
+		"StaticMesh",
+		-1,
+		CVarFlags::ReadAndWrite
+	);
 	RendererInterface::RendererInterface(const char* name, VulkanContext* context, CameraInterface* inCam)
 		: m_name(name), m_context(context), m_camera(inCam)
 	{
@@ -86,6 +102,9 @@ namespace engine
 		perframe.displayWidth = m_displayWidth;
 		perframe.displayHeight = m_displayHeight;
 
+		perframe.textureStreaming = { m_context->getTextureStreaming().getFeedbackBindlessIndex(), 0, 0, 0 };
+		perframe.staticMeshLOD = { math::max(cVarStaticMeshLODScale.get(), 0.0f), (float)cVarStaticMeshForceLOD.get(), 0.0f, 0.0f };
+
 		perframe.camInvertView = math::inverse(perframe.camView);
 		perframe.camViewProjNoJitter = perframe.camProjNoJitter * perframe.camView;
 		perframe.camInvertProjNoJitter = math::inverse(perframe.camProjNoJitter);
@@ -118,8 +137,13 @@ namespace engine
 
 	void RendererInterface::tick(const RuntimeModuleTickData& tickData, VkCommandBuffer graphicsCmd)
 	{
+		CPU_PROFILER_SCOPE("RendererInterface::tick");
+
 		m_gpuTimer.onBeginFrame(graphicsCmd, &m_timeStamps);
 		{
+			// Read back last texture streaming feedback and clear for this frame.
+			m_context->getTextureStreaming().recordFeedback(graphicsCmd);
+
 			// Collect per frame data.
 			updatePerframeData(tickData);
 
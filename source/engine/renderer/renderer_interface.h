@@ -111,6 +111,20 @@ namespace engine
 		PoolImageSharedRef m_skylightReflection = nullptr;
 		uint32_t m_skylightUpdateFaceIndex = 0;
 
+		// Skylight faces still need filter after env capture update, zero skip skylight.
+		uint32_t m_skylightPendingFaces = 0;
+
+		// Atmosphere luts keep across frames, only refresh when input hash change.
+		PoolImageSharedRef m_atmosphereTransmittance = nullptr;
+		PoolImageSharedRef m_atmosphereSkyView = nullptr;
+		PoolImageSharedRef m_atmosphereMultiScatter = nullptr;
+		PoolImageSharedRef m_atmosphereFroxelScatter = nullptr;
+		PoolImageSharedRef m_atmosphereEnvCapture = nullptr;
+		uint64_t m_atmosphereLutHash = 0;        // Atmosphere config of transmittance and multi scatter lut.
+		uint64_t m_atmosphereSkyViewHash = 0;    // Sky inputs of sky view lut and env capture.
+		uint64_t m_atmosphereFroxelSkyHash = 0;  // Sky inputs of froxel lut.
+		uint64_t m_atmosphereFroxelViewHash = 0; // Camera view of froxel lut.
+
 
 		PoolImageSharedRef m_gtaoHistory = nullptr;
 		PoolImageSharedRef m_prevHDR = nullptr;
@@ -157,25 +171,36 @@ namespace engine
 			BufferParameterHandle perFrameGPU
 		);
 
+		// PMX submesh local bounds from skinned positions, input of pmx gpu culling, return nullptr when no pmx.
+		BufferParameterHandle renderPMXSubmeshBounds(
+			VkCommandBuffer cmd,
+			class RenderScene* scene
+		);
+
 		void renderPMXGbuffer(
 			VkCommandBuffer cmd,
 			class GBufferTextures* inGBuffers,
 			class RenderScene* scene,
-			BufferParameterHandle perFrameGPU
+			BufferParameterHandle perFrameGPU,
+			BufferParameterHandle submeshBounds
 		);
 
 		void renderPMXOutline(
 			VkCommandBuffer cmd,
 			class GBufferTextures* inGBuffers,
 			class RenderScene* scene,
-			BufferParameterHandle perFrameGPU
+			BufferParameterHandle perFrameGPU,
+			BufferParameterHandle submeshBounds,
+			PoolImageSharedRef hzbFurthest
 		);
 
 		void renderPMXTranslucent(
 			VkCommandBuffer cmd,
 			class GBufferTextures* inGBuffers,
 			class RenderScene* scene,
-			BufferParameterHandle perFrameGPU);
+			BufferParameterHandle perFrameGPU,
+			BufferParameterHandle submeshBounds,
+			PoolImageSharedRef hzbFurthest);
 
 		// Hzb - after prepass.
 		void renderHzb(
@@ -237,6 +262,14 @@ namespace engine
 			BufferParameterHandle perFrameGPU,
 			class RenderScene* scene);
 
+		// Depth range and cascade fit only use compute, can run on async compute queue.
+		void renderSDSMCascade(
+			VkCommandBuffer cmd,
+			class GBufferTextures* inGBuffers,
+			class RenderScene* scene,
+			BufferParameterHandle perFrameGPU,
+			SDSMInfos& inout);
+
 		void renderSDSM(
 			VkCommandBuffer cmd,
 			class GBufferTextures* inGBuffers,
@@ -252,6 +285,7 @@ namespace engine
 			PoolImageSharedRef inSDSMMask,
 			AtmosphereTextures& atmosphere,
 			PoolImageSharedRef inSSAO,
+			PoolImageSharedRef inGTAO, // Null when GTAO disable.
 			SDSMInfos& sdsmInfo);
 
 		void adaptiveExposure(
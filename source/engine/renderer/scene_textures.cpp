@@ -1,10 +1,9 @@
 #include "scene_textures.h"
 #include "renderer_interface.h"
-#include "../../editor/editor.h"
 
 namespace engine
 {
-	GBufferTextures GBufferTextures::build(RendererInterface* renderer, VulkanContext* context)
+	GBufferTextures GBufferTextures::build(RendererInterface* renderer, VulkanContext* context, RenderGraph& graph)
 	{
 		auto& pool = context->getRenderTargetPools();
 
@@ -23,87 +22,72 @@ namespace engine
 
 		GBufferTextures result { };
 
+		// Used as history next frame, keep in pool.
 		result.hdrSceneColor = pool.createPoolImage("HdrSceneColor", renderWidth, renderHeight, hdrSceneColorFormat(), kGBufferUsage);
-		result.hdrSceneColorUpscale = pool.createPoolImage("HdrSceneColorUpscale", renderer->getDisplayWidth(), renderer->getDisplayHeight(), hdrSceneColorFormat(), kGBufferUsage);
 		result.depthTexture = pool.createPoolImage("DepthTexture", renderWidth, renderHeight, depthTextureFormat(), kDepthUsage);
-
-		result.gbufferA = pool.createPoolImage("GBufferA", renderWidth, renderHeight, gbufferAFormat(), kGBufferUsage);
 		result.gbufferB = pool.createPoolImage("GBufferB", renderWidth, renderHeight, gbufferBFormat(), kGBufferUsage);
-		result.gbufferS = pool.createPoolImage("GBufferS", renderWidth, renderHeight, gbufferSFormat(), kGBufferUsage);
-		result.gbufferV = pool.createPoolImage("GBufferV", renderWidth, renderHeight, gbufferVFormat(), kGBufferUsage);
-		result.gbufferUpscaleTranslucencyAndComposition = pool.createPoolImage("gbufferUpscaleTranslucencyAndComposition", renderWidth, renderHeight, gbufferUpscaleTranslucencyAndCompositionFormat(), kGBufferUsage);
-		result.gbufferUpscaleReactive = pool.createPoolImage("gbufferUpscaleReactive", renderWidth, renderHeight, gbufferUpscaleReactiveFormat(), kGBufferUsage);
-		result.idTexture = pool.createPoolImage("IdTexture", renderWidth, renderHeight, getIdTextureFormat(), kGBufferUsage);
-
-		uint32_t selectMaskWidth = renderWidth;
-		uint32_t selectMaskHeight = renderHeight;
-		if (Editor::get()->getSceneNodeSelected().empty())
+
+		// Exposure read upscale color before fsr2 write, so it need keep content of pool reuse.
+		result.hdrSceneColorUpscale = pool.createPoolImage("HdrSceneColorUpscale", renderer->getDisplayWidth(), renderer->getDisplayHeight(), hdrSceneColorFormat(), kGBufferUsage);
+
+		result.rg.hdrSceneColor = graph.importImage("HdrSceneColor", result.hdrSceneColor);
+		result.rg.depthTexture = graph.importImage("DepthTexture", result.depthTexture);
+		result.rg.gbufferB = graph.importImage("GBufferB", result.gbufferB);
+		result.rg.hdrSceneColorUpscale = graph.importImage("HdrSceneColorUpscale", result.hdrSceneColorUpscale);
+
+		// Only live in current frame, memory alias by graph.
+		auto createTransient = [&](PoolImageSharedRef& ref, RGImage& handle, const char* name, VkFormat format)
 		{
-			selectMaskWidth = 1;
-			selectMaskHeight = 1;
-		}
-		result.selectionOutlineMask = pool.createPoolImage("SelectionOutlineMask", renderWidth, renderHeight, gbufferSelectionOutlineMaskFormat(), kGBufferUsage);
+			handle = graph.createImage(name, renderWidth, renderHeight, format, kGBufferUsage);
+			ref = graph.getImage(handle);
+		};
+
+		createTransient(result.gbufferA, result.rg.gbufferA, "GBufferA", gbufferAFormat());
+		createTransient(result.gbufferS, result.rg.gbufferS, "GBufferS", gbufferSFormat());
+		createTransient(result.gbufferV, result.rg.gbufferV, "GBufferV", gbufferVFormat());
+		createTransient(result.gbufferUpscaleTranslucencyAndComposition, result.rg.gbufferUpscaleTranslucencyAndComposition, "gbufferUpscaleTranslucencyAndComposition", gbufferUpscaleTranslucencyAndCompositionFormat());
+		createTransient(result.gbufferUpscaleReactive, result.rg.gbufferUpscaleReactive, "gbufferUpscaleReactive", gbufferUpscaleReactiveFormat());
+		createTransient(result.idTexture, result.rg.idTexture, "IdTexture", getIdTextureFormat());
+		createTransient(result.selectionOutlineMask, result.rg.selectionOutlineMask, "SelectionOutlineMask", gbufferSelectionOutlineMaskFormat());
 
 		return result;
 	}
 
-	void GBufferTextures::clearValue(VkCommandBuffer graphicsCmd)
+	void GBufferTextures::addClearPass(RenderGraph& graph)
 	{
-		auto& hdrSceneColor = this->hdrSceneColor->getImage();
-		auto& gbufferA = this->gbufferA->getImage();
-		auto& gbufferB = this->gbufferB->getImage();
-		auto& gbufferS = this->gbufferS->getImage();
-		auto& gbufferV = this->gbufferV->getImage();
-		auto& gbufferComposition = this->gbufferUpscaleTranslucencyAndComposition->getImage();
-		auto& gbufferUpscaleMask = this->gbufferUpscaleReactive->getImage();
-		auto& idTexture = this->idTexture->getImage();
-		auto& selectMask = this->selectionOutlineMask->getImage();
-
-		// Depth clear in mesh draw pass.
-		auto& depthZ = this->depthTexture->getImage();
-
-		ScopePerframeMarker marker(graphicsCmd, "GBuffer Clear", { 1.0f, 1.0f, 0.0f, 1.0f });
-		VkClearColorValue zeroClear =
+		graph.addPass("GBufferClear", [this](RenderGraph::PassBuilder& builder)
 		{
-			.uint32 = {0,0,0,0}
-		};
-
-		hdrSceneColor.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		gbufferA.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		gbufferB.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		gbufferS.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		gbufferV.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		gbufferComposition.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		gbufferUpscaleMask.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		idTexture.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		selectMask.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, buildBasicImageSubresource());
-		depthZ.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_GENERAL, RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT));
-
-		auto rangeClear = buildBasicImageSubresource();
-		vkCmdClearColorImage(graphicsCmd, hdrSceneColor.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, gbufferA.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, gbufferB.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, gbufferS.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, gbufferV.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, gbufferComposition.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, gbufferUpscaleMask.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, idTexture.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-		vkCmdClearColorImage(graphicsCmd, selectMask.getImage(), VK_IMAGE_LAYOUT_GENERAL, &zeroClear, 1, &rangeClear);
-
-		auto depthClear = VkClearDepthStencilValue{ 0.0f, 1 };
-		auto rangeClearDepth = RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT);
-		vkCmdClearDepthStencilImage(graphicsCmd, depthZ.getImage(), VK_IMAGE_LAYOUT_GENERAL, &depthClear, 1, &rangeClearDepth);
-
-		hdrSceneColor.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		gbufferA.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		gbufferB.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		gbufferS.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		gbufferV.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		gbufferComposition.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		gbufferUpscaleMask.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		depthZ.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, rangeClearDepth);
-		idTexture.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
-		selectMask.transitionLayout(graphicsCmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
+			builder
+				.write(rg.hdrSceneColor, ERGImageAccess::TransferDst)
+				.write(rg.gbufferA, ERGImageAccess::TransferDst)
+				.write(rg.gbufferB, ERGImageAccess::TransferDst)
+				.write(rg.gbufferS, ERGImageAccess::TransferDst)
+				.write(rg.gbufferV, ERGImageAccess::TransferDst)
+				.write(rg.gbufferUpscaleTranslucencyAndComposition, ERGImageAccess::TransferDst)
+				.write(rg.gbufferUpscaleReactive, ERGImageAccess::TransferDst)
+				.write(rg.idTexture, ERGImageAccess::TransferDst)
+				.write(rg.selectionOutlineMask, ERGImageAccess::TransferDst)
+				.write(rg.depthTexture, ERGImageAccess::TransferDst);
+		},
+		[this](VkCommandBuffer graphicsCmd)
+		{
+			ScopePerframeMarker marker(graphicsCmd, "GBuffer Clear", { 1.0f, 1.0f, 0.0f, 1.0f });
+			VkClearColorValue zeroClear =
+			{
+				.uint32 = {0,0,0,0}
+			};
+
+			// Graph already transition all to transfer dst.
+			auto rangeClear = buildBasicImageSubresource();
+			for (auto* image : { &hdrSceneColor, &gbufferA, &gbufferB, &gbufferS, &gbufferV, &gbufferUpscaleTranslucencyAndComposition, &gbufferUpscaleReactive, &idTexture, &selectionOutlineMask })
+			{
+				vkCmdClearColorImage(graphicsCmd, (*image)->getImage().getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &zeroClear, 1, &rangeClear);
+			}
+
+			auto depthClear = VkClearDepthStencilValue{ 0.0f, 1 };
+			auto rangeClearDepth = RHIDefaultImageSubresourceRange(VK_IMAGE_ASPECT_DEPTH_BIT);
+			vkCmdClearDepthStencilImage(graphicsCmd, depthTexture->getImage().getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &depthClear, 1, &rangeClearDepth);
+		});
 	}
 
 	SharedTextures::SharedTextures()
@@ -1,6 +1,7 @@
 #pragma once
 #include <rhi/rhi.h>
 #include <util/util.h>
+#include "render_graph.h"
 
 namespace engine
 {
@@ -72,8 +73,25 @@ namespace engine
 	class GBufferTextures
 	{
 	public:
-		static GBufferTextures build(class RendererInterface* renderer, VulkanContext* context);
-		void clearValue(VkCommandBuffer graphicsCmd);
+		// History textures create from pool and import, others are transient of graph.
+		static GBufferTextures build(class RendererInterface* renderer, VulkanContext* context, RenderGraph& graph);
+		void addClearPass(RenderGraph& graph);
+
+		// Render graph handles of all textures.
+		struct GraphHandles
+		{
+			RGImage idTexture;
+			RGImage selectionOutlineMask;
+			RGImage hdrSceneColor;
+			RGImage hdrSceneColorUpscale;
+			RGImage depthTexture;
+			RGImage gbufferA;
+			RGImage gbufferB;
+			RGImage gbufferS;
+			RGImage gbufferV;
+			RGImage gbufferUpscaleReactive;
+			RGImage gbufferUpscaleTranslucencyAndComposition;
+		} rg;
 
 		// Id of submesh, used for editor pick select or temporal reproject.
 		PoolImageSharedRef idTexture = nullptr;
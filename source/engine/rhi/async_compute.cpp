@@ -0,0 +1,262 @@
+#include "async_compute.h"
+#include "rhi.h"
+
+namespace engine
+{
+	static AutoCVarBool cVarAsyncComputeEnable(
+		"r.AsyncCompute.Enable",
+		"Render graph schedule async compute pass on dedicated compute queue when device support.",
+		"AsyncCompute",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
+	static VkSemaphore createTimelineSemaphore(VkDevice device)
+	{
+		VkSemaphoreTypeCreateInfo timelineCreateInfo{};
+		timelineCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		timelineCreateInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &timelineCreateInfo;
+
+		VkSemaphore semaphore;
+		RHICheck(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore));
+		return semaphore;
+	}
+
+	AsyncComputeScheduler::AsyncComputeScheduler(VulkanContext* context, uint32_t frameCount)
+		: m_context(context)
+	{
+		CHECK(frameCount > 0);
+		m_frameCmds.resize(frameCount);
+
+		m_graphicsTimeline = createTimelineSemaphore(m_context->getDevice());
+		m_computeTimeline = createTimelineSemaphore(m_context->getDevice());
+	}
+
+	AsyncComputeScheduler::~AsyncComputeScheduler()
+	{
+		for (auto& frame : m_frameCmds)
+		{
+			if (!frame.graphicsCmds.empty())
+			{
+				vkFreeCommandBuffers(m_context->getDevice(), m_context->getMajorGraphicsCommandPool(), (uint32_t)frame.graphicsCmds.size(), frame.graphicsCmds.data());
+			}
+			if (!frame.computeCmds.empty())
+			{
+				vkFreeCommandBuffers(m_context->getDevice(), m_context->getMajorComputeCommandPool(), (uint32_t)frame.computeCmds.size(), frame.computeCmds.data());
+			}
+		}
+
+		vkDestroySemaphore(m_context->getDevice(), m_graphicsTimeline, nullptr);
+		vkDestroySemaphore(m_context->getDevice(), m_computeTimeline, nullptr);
+	}
+
+	bool AsyncComputeScheduler::isEnable() const
+	{
+		return m_bFrameBegin
+			&& cVarAsyncComputeEnable.get()
+			&& (m_context->getComputeFamily() != m_context->getGraphiscFamily());
+	}
+
+	void AsyncComputeScheduler::beginFrame(VkCommandBuffer mainCmd)
+	{
+		CHECK(!m_bFrameBegin);
+		m_bFrameBegin = true;
+
+		// Frame fence already wait, all command buffers of this frame slot finish.
+		m_frameIndex = m_context->getCurrentFrameIndex() % (uint32_t)m_frameCmds.size();
+		m_usedGraphicsCmds = 0;
+		m_usedComputeCmds = 0;
+
+		m_graphicsSegments.clear();
+		m_computeSegments.clear();
+
+		QueueSegment mainSegment{ };
+		mainSegment.cmd = mainCmd;
+		mainSegment.signalValue = ++m_graphicsValue;
+		m_graphicsSegments.push_back(mainSegment);
+	}
+
+	VkCommandBuffer AsyncComputeScheduler::acquireCommandBuffer(bool bCompute)
+	{
+		auto& frame = m_frameCmds[m_frameIndex];
+		auto& cmds = bCompute ? frame.computeCmds : frame.graphicsCmds;
+		uint32_t& usedCount = bCompute ? m_usedComputeCmds : m_usedGraphicsCmds;
+
+		if (usedCount >= cmds.size())
+		{
+			VkCommandBufferAllocateInfo info{};
+			info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			info.commandBufferCount = 1;
+			info.commandPool = bCompute ? m_context->getMajorComputeCommandPool() : m_context->getMajorGraphicsCommandPool();
+			info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+			VkCommandBuffer newBuffer;
+			RHICheck(vkAllocateCommandBuffers(m_context->getDevice(), &info, &newBuffer));
+			cmds.push_back(newBuffer);
+		}
+
+		VkCommandBuffer cmd = cmds[usedCount];
+		usedCount++;
+
+		RHICheck(vkResetCommandBuffer(cmd, 0));
+		VkCommandBufferBeginInfo cmdBeginInfo = RHICommandbufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		RHICheck(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
+
+		return cmd;
+	}
+
+	AsyncComputeScheduler::Segment AsyncComputeScheduler::addGraphicsSegment(uint64_t waitComputeValue)
+	{
+		CHECK(m_bFrameBegin);
+		CHECK(waitComputeValue <= m_computeValue);
+
+		QueueSegment segment{ };
+		segment.cmd = acquireCommandBuffer(false);
+		segment.waitValue = waitComputeValue;
+		segment.signalValue = ++m_graphicsValue;
+		m_graphicsSegments.push_back(segment);
+
+		return { segment.cmd, segment.signalValue };
+	}
+
+	AsyncComputeScheduler::Segment AsyncComputeScheduler::addComputeSegment(uint64_t waitGraphicsValue)
+	{
+		CHECK(m_bFrameBegin);
+		CHECK(waitGraphicsValue <= m_graphicsValue);
+
+		QueueSegment segment{ };
+		segment.cmd = acquireCommandBuffer(true);
+		segment.waitValue = waitGraphicsValue;
+		segment.signalValue = ++m_computeValue;
+		m_computeSegments.push_back(segment);
+
+		return { segment.cmd, segment.signalValue };
+	}
+
+	AsyncComputeScheduler::Segment AsyncComputeScheduler::getGraphicsTail() const
+	{
+		CHECK(m_bFrameBegin);
+		return { m_graphicsSegments.back().cmd, m_graphicsSegments.back().signalValue };
+	}
+
+	VkCommandBuffer AsyncComputeScheduler::getGraphicsCmd(VkCommandBuffer mainCmd) const
+	{
+		return m_bFrameBegin ? m_graphicsSegments.back().cmd : mainCmd;
+	}
+
+	uint32_t AsyncComputeScheduler::getQueueFamily(VkCommandBuffer cmd) const
+	{
+		if (m_bFrameBegin)
+		{
+			for (const auto& segment : m_computeSegments)
+			{
+				if (segment.cmd == cmd)
+				{
+					return m_context->getComputeFamily();
+				}
+			}
+		}
+
+		return m_context->getGraphiscFamily();
+	}
+
+	VkSubmitInfo AsyncComputeScheduler::buildSubmitInfo(SubmitStorage& storage, uint32_t signalCount) const
+	{
+		const uint32_t waitCount = (storage.waitSemaphore != VK_NULL_HANDLE) ? 1 : 0;
+
+		// Binary semaphore value ignore.
+		storage.timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		storage.timelineInfo.waitSemaphoreValueCount = waitCount;
+		storage.timelineInfo.pWaitSemaphoreValues = &storage.waitValue;
+		storage.timelineInfo.signalSemaphoreValueCount = signalCount;
+		storage.timelineInfo.pSignalSemaphoreValues = storage.signalValues.data();
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &storage.timelineInfo;
+		submitInfo.waitSemaphoreCount = waitCount;
+		submitInfo.pWaitSemaphores = &storage.waitSemaphore;
+		submitInfo.pWaitDstStageMask = &storage.waitStage;
+		submitInfo.signalSemaphoreCount = signalCount;
+		submitInfo.pSignalSemaphores = storage.signalSemaphores.data();
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &storage.cmd;
+
+		return submitInfo;
+	}
+
+	void AsyncComputeScheduler::endFrame(VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage, VkSemaphore signalSemaphore, std::vector<VkSubmitInfo>& outGraphicsInfos)
+	{
+		CHECK(m_bFrameBegin);
+		m_bFrameBegin = false;
+
+		// Main command buffer end by caller.
+		for (size_t i = 1; i < m_graphicsSegments.size(); i++)
+		{
+			RHICheck(vkEndCommandBuffer(m_graphicsSegments[i].cmd));
+		}
+		for (const auto& segment : m_computeSegments)
+		{
+			RHICheck(vkEndCommandBuffer(segment.cmd));
+		}
+
+		// Reserve before fill, submit info point to storage.
+		m_submitStorages.clear();
+		m_submitStorages.reserve(m_graphicsSegments.size() + m_computeSegments.size());
+
+		// Compute segment wait graphics timeline value which may submit later, timeline semaphore allow wait before signal.
+		if (!m_computeSegments.empty())
+		{
+			std::vector<VkSubmitInfo> computeInfos;
+			for (const auto& segment : m_computeSegments)
+			{
+				auto& storage = m_submitStorages.emplace_back();
+				storage.cmd = segment.cmd;
+				storage.waitSemaphore = (segment.waitValue > 0) ? m_graphicsTimeline : VK_NULL_HANDLE;
+				storage.waitValue = segment.waitValue;
+				storage.waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+				storage.signalSemaphores[0] = m_computeTimeline;
+				storage.signalValues[0] = segment.signalValue;
+
+				computeInfos.push_back(buildSubmitInfo(storage, 1));
+			}
+
+			RHICheck(vkQueueSubmit(m_context->getMajorComputeQueue(), (uint32_t)computeInfos.size(), computeInfos.data(), VK_NULL_HANDLE));
+		}
+
+		for (size_t i = 0; i < m_graphicsSegments.size(); i++)
+		{
+			const auto& segment = m_graphicsSegments[i];
+			const bool bFirst = (i == 0);
+			const bool bLast = (i == m_graphicsSegments.size() - 1);
+
+			auto& storage = m_submitStorages.emplace_back();
+			storage.cmd = segment.cmd;
+			if (bFirst)
+			{
+				storage.waitSemaphore = waitSemaphore;
+				storage.waitStage = waitStage;
+			}
+			else if (segment.waitValue > 0)
+			{
+				storage.waitSemaphore = m_computeTimeline;
+				storage.waitValue = segment.waitValue;
+				storage.waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			}
+
+			storage.signalSemaphores[0] = m_graphicsTimeline;
+			storage.signalValues[0] = segment.signalValue;
+			if (bLast)
+			{
+				storage.signalSemaphores[1] = signalSemaphore;
+			}
+
+			outGraphicsInfos.push_back(buildSubmitInfo(storage, bLast ? 2 : 1));
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "rhi_misc.h"
+
+namespace engine
+{
+	class VulkanContext;
+
+	// Async compute scheduler, split frame work into ordered graphics and compute queue segments.
+	// Each queue own one timeline semaphore, every segment signal its queue timeline when finish,
+	// segment can wait other queue timeline value before start, so compute overlap graphics between sync points.
+	// Main graphics command buffer of frame is first graphics segment, submit order same as segment create order.
+	class AsyncComputeScheduler : NonCopyable
+	{
+	public:
+		struct Segment
+		{
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+
+			// Timeline value of segment queue signal when segment finish.
+			uint64_t signalValue = 0;
+		};
+
+		explicit AsyncComputeScheduler(VulkanContext* context, uint32_t frameCount);
+		~AsyncComputeScheduler();
+
+		// Device exist compute family no same with graphics family, and cvar enable, only valid between frame begin and end.
+		bool isEnable() const;
+
+		// Call after frame fence wait, main command buffer become first graphics segment.
+		void beginFrame(VkCommandBuffer mainCmd);
+
+		// Append segment at queue end, wait other queue timeline value before start, zero means no wait.
+		Segment addGraphicsSegment(uint64_t waitComputeValue);
+		Segment addComputeSegment(uint64_t waitGraphicsValue);
+
+		// Last graphics segment, command record after frame split should record here keep order.
+		Segment getGraphicsTail() const;
+
+		// Main command buffer when frame no begin.
+		VkCommandBuffer getGraphicsCmd(VkCommandBuffer mainCmd) const;
+
+		// Command buffer record queue family, compute segment return compute family.
+		uint32_t getQueueFamily(VkCommandBuffer cmd) const;
+
+		// Submit compute segments, and output graphics segments submit infos in order.
+		// First graphics segment wait waitSemaphore, last one signal signalSemaphore.
+		// Infos valid until next frame end.
+		void endFrame(VkSemaphore waitSemaphore, VkPipelineStageFlags waitStage, VkSemaphore signalSemaphore, std::vector<VkSubmitInfo>& outGraphicsInfos);
+
+	private:
+		struct QueueSegment
+		{
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+			uint64_t waitValue = 0;
+			uint64_t signalValue = 0;
+		};
+
+		struct FrameCommandBuffers
+		{
+			std::vector<VkCommandBuffer> graphicsCmds;
+			std::vector<VkCommandBuffer> computeCmds;
+		};
+
+		struct SubmitStorage
+		{
+			VkTimelineSemaphoreSubmitInfo timelineInfo{ };
+
+			VkSemaphore waitSemaphore = VK_NULL_HANDLE;
+			uint64_t waitValue = 0;
+			VkPipelineStageFlags waitStage = 0;
+
+			std::array<VkSemaphore, 2> signalSemaphores{ };
+			std::array<uint64_t, 2> signalValues{ };
+
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
+		};
+
+		VkCommandBuffer acquireCommandBuffer(bool bCompute);
+		VkSubmitInfo buildSubmitInfo(SubmitStorage& storage, uint32_t signalCount) const;
+
+	private:
+		VulkanContext* m_context;
+
+		// Per queue timeline, value increase one per segment.
+		VkSemaphore m_graphicsTimeline = VK_NULL_HANDLE;
+		VkSemaphore m_computeTimeline = VK_NULL_HANDLE;
+		uint64_t m_graphicsValue = 0;
+		uint64_t m_computeValue = 0;
+
+		// Command buffers reuse after frame fence, index by frame in flight.
+		std::vector<FrameCommandBuffers> m_frameCmds;
+		uint32_t m_frameIndex = 0;
+		uint32_t m_usedGraphicsCmds = 0;
+		uint32_t m_usedComputeCmds = 0;
+
+		bool m_bFrameBegin = false;
+
+		std::vector<QueueSegment> m_graphicsSegments;
+		std::vector<QueueSegment> m_computeSegments;
+
+		std::vector<SubmitStorage> m_submitStorages;
+	};
+}
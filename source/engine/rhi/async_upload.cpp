@@ -3,48 +3,98 @@
 
 namespace engine
 {
+	static AutoCVarInt32 cVarAsyncUploadFrameBudgetMB(
+		"r.RHI.AsyncUpload.FrameBudgetMB",
+		"Max async upload bytes (MB) submit per frame, zero means no limit.",
+		"RHI",
+		0,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarDumpAsyncUploadStatistics("cmd.dumpAsyncUploadStatistics", "Print async uploader statistics.");
+
 	static std::string getTransferBufferUniqueId()
 	{
 		static std::atomic<size_t> counter = 0;
 		return "M_AsyncUpload_" + std::to_string(counter.fetch_add(1));
 	}
 
-	void AsyncUploaderBase::resetProcessState()
+	static inline uint64_t alignUp(uint64_t value, uint64_t alignment)
 	{
-		CHECK(m_bProcessing);
-
-		vkResetFences(m_context->getDevice(), 1, &m_fence);
-		vkResetCommandBuffer(m_commandBuffer, 0);
+		return (value + alignment - 1) / alignment * alignment;
 	}
 
-	void AsyncUploaderBase::startRecord()
+	void AsyncUploaderBase::startRecord(VkCommandBuffer cmd)
 	{
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-		vkBeginCommandBuffer(m_commandBuffer, &beginInfo);
+		vkBeginCommandBuffer(cmd, &beginInfo);
 	}
 
-	void AsyncUploaderBase::endRecordAndSubmit()
+	uint64_t AsyncUploaderBase::endRecordAndSubmit(VkCommandBuffer cmd)
 	{
-		vkEndCommandBuffer(m_commandBuffer);
+		vkEndCommandBuffer(cmd);
+
+		const uint64_t signalValue = ++m_timelineValue;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &signalValue;
+
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
 		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &m_commandBuffer;
+		submitInfo.pCommandBuffers = &cmd;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &m_timeline;
 
-		vkQueueSubmit(m_queue, 1, &submitInfo, m_fence);
+		{
+			std::lock_guard lock(m_queueMutex);
+			RHICheck(vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE));
+		}
+
+		return signalValue;
+	}
+
+	uint64_t AsyncUploaderBase::getCompletedValue() const
+	{
+		uint64_t value = 0;
+		RHICheck(vkGetSemaphoreCounterValue(m_context->getDevice(), m_timeline, &value));
+		return value;
 	}
 
-	AsyncUploaderBase::AsyncUploaderBase(VulkanContext* ct, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, uint32_t inFamily)
-		: m_context(ct), m_name(name), m_manager(in), m_queue(inQueue), m_queueFamily(inFamily)
+	void AsyncUploaderBase::waitValue(uint64_t value) const
+	{
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &m_timeline;
+		waitInfo.pValues = &value;
+		RHICheck(vkWaitSemaphores(m_context->getDevice(), &waitInfo, UINT64_MAX));
+	}
+
+	AsyncUploaderBase::AsyncUploaderBase(VulkanContext* ct, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, std::mutex& inQueueMutex, uint32_t inFamily)
+		: m_context(ct), m_name(name), m_manager(in), m_queue(inQueue), m_queueMutex(inQueueMutex), m_queueFamily(inFamily)
+	{
+
+	}
+
+	void AsyncUploaderBase::start()
 	{
 		m_future = std::async(std::launch::async, [this]()
 		{
-			VkFenceCreateInfo fenceInfo{};
-			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			VkSemaphoreTypeCreateInfo timelineCreateInfo{};
+			timelineCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+			timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+			timelineCreateInfo.initialValue = 0;
 
-			vkCreateFence(m_context->getDevice(), &fenceInfo, nullptr, &m_fence);
+			VkSemaphoreCreateInfo semaphoreInfo{};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreInfo.pNext = &timelineCreateInfo;
+			RHICheck(vkCreateSemaphore(m_context->getDevice(), &semaphoreInfo, nullptr, &m_timeline));
 
 			VkCommandPoolCreateInfo poolInfo{};
 			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -52,18 +102,20 @@ namespace engine
 			poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 			RHICheck(vkCreateCommandPool(m_context->getDevice(), &poolInfo, nullptr, &m_pool));
 
+			m_commandBuffers.resize(getCommandBufferCount());
+
 			VkCommandBufferAllocateInfo allocInfo{};
 			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 			allocInfo.commandPool = m_pool;
-			allocInfo.commandBufferCount = 1;
-			RHICheck(vkAllocateCommandBuffers(m_context->getDevice(), &allocInfo, &m_commandBuffer));
+			allocInfo.commandBufferCount = (uint32_t)m_commandBuffers.size();
+			RHICheck(vkAllocateCommandBuffers(m_context->getDevice(), &allocInfo, m_commandBuffers.data()));
 
 			threadFunction();
 
-			vkFreeCommandBuffers(m_context->getDevice(), m_pool, 1, &m_commandBuffer);
+			vkFreeCommandBuffers(m_context->getDevice(), m_pool, (uint32_t)m_commandBuffers.size(), m_commandBuffers.data());
 			vkDestroyCommandPool(m_context->getDevice(), m_pool, nullptr);
-			vkDestroyFence(m_context->getDevice(), m_fence, nullptr);
+			vkDestroySemaphore(m_context->getDevice(), m_timeline, nullptr);
 
 			LOG_INFO("Async upload thread {0} exit.", m_name);
 		});
@@ -71,19 +123,20 @@ namespace engine
 
 	void DynamicAsyncUploader::loadTick()
 	{
+		CPU_PROFILER_SCOPE("DynamicAsyncUploader::loadTick");
+
+		VkCommandBuffer cmd = m_commandBuffers[0];
+
 		// Handle still processing state.
 		if (m_bProcessing)
 		{
-			while (vkGetFenceStatus(m_context->getDevice(), m_fence) != VK_SUCCESS)
-			{
-				std::this_thread::yield();
-			}
-
-			resetProcessState();
+			waitValue(m_processingValue);
+			vkResetCommandBuffer(cmd, 0);
 
-			CHECK(m_processingTask != nullptr);
-			m_processingTask->finishCallback();
-			m_processingTask = nullptr;
+			CHECK(m_processingTask.task != nullptr);
+			m_processingTask.task->finishCallback();
+			m_manager.onTaskFinished(m_processingTask, m_processingTask.task->uploadSize());
+			m_processingTask = { };
 
 			m_bProcessing = false;
 		}
@@ -95,10 +148,12 @@ namespace engine
 			return;
 		}
 
-		CHECK(!m_processingTask);
+		CHECK(!m_processingTask.task);
 
-		// Get static task from manager.
-		m_manager.dynamicTasksAction([&, this](std::queue<std::shared_ptr<AssetLoadTask>>& srcQueue)
+		bool bBudgetLimited = false;
+
+		// Get dynamic task from manager.
+		m_manager.dynamicTasksAction([&, this](std::queue<AsyncUploadRequest>& srcQueue)
 		{
 			// Empty already.
 			if (srcQueue.size() == 0)
@@ -106,25 +161,32 @@ namespace engine
 				return;
 			}
 
-			if (srcQueue.size() > 0)
-			{
-				std::shared_ptr<AssetLoadTask> processTask = srcQueue.front();
-				uint32_t requireSize = processTask->uploadSize();
-				CHECK(requireSize >= m_manager.getDynamicUploadMinSize());
+			const AsyncUploadRequest& request = srcQueue.front();
+			uint32_t requireSize = request.task->uploadSize();
+			CHECK(requireSize >= m_manager.getDynamicUploadMinSize());
 
-				m_processingTask = processTask;
-				m_bProcessing = true;
-				srcQueue.pop();
+			if (!m_manager.tryConsumeBudget(requireSize))
+			{
+				bBudgetLimited = true;
+				return;
 			}
+
+			m_processingTask = request;
+			m_bProcessing = true;
+			srcQueue.pop();
 		});
 
-		if (!m_processingTask)
+		if (!m_processingTask.task)
 		{
-			tryReleaseStageBuffer();
+			if (bBudgetLimited)
+			{
+				m_manager.waitBudget();
+			}
 			return;
 		}
 
-		uint32_t requireSize = m_processingTask->uploadSize();
+		uint32_t requireSize = m_processingTask.task->uploadSize();
+		m_manager.onTasksPopped(requireSize, 1);
 
 		const bool bShouldRecreate =
 			   (m_stageBuffer == nullptr)                    // No create yet.
@@ -144,27 +206,32 @@ namespace engine
 
 		}
 
-		startRecord();
+		startRecord(cmd);
 		m_stageBuffer->map();
 		{
 			void* mapped = m_stageBuffer->getMapped();
 
-			RHICommandBufferBase commandBase{ .cmd = m_commandBuffer, .pool = m_pool, .queueFamily = m_queueFamily };
-			m_processingTask->uploadFunction(0, mapped, commandBase, *m_stageBuffer);
+			RHICommandBufferBase commandBase{ .cmd = cmd, .pool = m_pool, .queueFamily = m_queueFamily };
+			m_processingTask.task->uploadFunction(0, mapped, commandBase, *m_stageBuffer);
 
 		}
+		m_stageBuffer->flush(requireSize, 0);
 		m_stageBuffer->unmap();
-		endRecordAndSubmit();
+
+		m_processingValue = endRecordAndSubmit(cmd);
+		m_manager.onTasksSubmitted(requireSize, 1);
 	}
 
 	void DynamicAsyncUploader::tryReleaseStageBuffer()
 	{
-		CHECK(!m_processingTask && !m_bProcessing);
+		CHECK(!m_processingTask.task && !m_bProcessing);
 		m_stageBuffer = nullptr;
 	}
 
 	void DynamicAsyncUploader::threadFunction()
 	{
+		Profiler::get()->setThreadName(m_name);
+
 		while (m_bRun.load())
 		{
 			if (!m_manager.dynamicLoadAssetTaskEmpty() || m_bProcessing.load())
@@ -173,144 +240,266 @@ namespace engine
 			}
 			else
 			{
-				std::unique_lock<std::mutex> lock(m_manager.getDynamicMutex());
-				m_manager.getDynamicCondition().wait(lock);
+				m_manager.waitDynamicTasks(m_bRun);
 			}
 		}
 	}
 
-	void StaticAsyncUploader::loadTick()
+	bool BatchAsyncUploader::ringAllocate(uint64_t size, uint64_t& outOffset, uint64_t& outConsumed)
 	{
-		// Handle still processing state.
-		if (m_bProcessing)
+		const uint64_t capacity = m_stageBuffer->getSize();
+		if (m_ringUsed == 0)
+		{
+			m_ringHead = 0;
+			m_ringTail = 0;
+		}
+
+		const uint64_t alignedHead = alignUp(m_ringHead, kTaskAlignment);
+		if (m_ringHead > m_ringTail || m_ringUsed == 0)
+		{
+			// Free range [head, capacity) and [0, tail).
+			if (alignedHead + size <= capacity)
+			{
+				outOffset = alignedHead;
+			}
+			else if (size <= m_ringTail)
+			{
+				// Wrap around, skip the end of ring.
+				outOffset = 0;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else
 		{
-			while (vkGetFenceStatus(m_context->getDevice(), m_fence) != VK_SUCCESS)
+			// Free range [head, tail).
+			if (alignedHead + size <= m_ringTail)
 			{
-				// Still processing, keep going.
-				std::this_thread::yield();
+				outOffset = alignedHead;
 			}
+			else
+			{
+				return false;
+			}
+		}
 
+		const uint64_t newHead = outOffset + size;
+		outConsumed = (outOffset >= m_ringHead) ? (newHead - m_ringHead) : (capacity - m_ringHead + newHead);
 
-			resetProcessState();
+		m_ringHead = newHead;
+		m_ringUsed += outConsumed;
+		return true;
+	}
 
-			CHECK(m_processingTasks.size() > 0);
-			for (auto& uploadingTask : m_processingTasks)
+	void BatchAsyncUploader::retireBatches(bool bWaitOldest)
+	{
+		if (m_inflightBatches.empty())
+		{
+			return;
+		}
+
+		if (bWaitOldest)
+		{
+			waitValue(m_inflightBatches.front().timelineValue);
+		}
+
+		const uint64_t completedValue = getCompletedValue();
+		while (!m_inflightBatches.empty() && m_inflightBatches.front().timelineValue <= completedValue)
+		{
+			Batch& batch = m_inflightBatches.front();
+			for (auto& request : batch.tasks)
 			{
-				uploadingTask->finishCallback();
+				request.task->finishCallback();
+				m_manager.onTaskFinished(request, request.task->uploadSize());
 			}
-			m_processingTasks.clear();
-			m_bProcessing = false;
+
+			// Batch finish in submit order, so tail just move to batch end.
+			m_ringUsed -= batch.ringBytes;
+			m_ringTail = batch.ringEnd;
+
+			vkResetCommandBuffer(batch.cmd, 0);
+			m_freeCommandBuffers.push_back(batch.cmd);
+
+			m_inflightBatches.pop_front();
 		}
+	}
 
-		// Task already empty, just return.
-		if (m_manager.staticLoadAssetTaskEmpty())
+	void BatchAsyncUploader::loadTick()
+	{
+		CPU_PROFILER_SCOPE("BatchAsyncUploader::loadTick");
+
+		// Finish completed batches without block.
+		retireBatches(false);
+
+		// No new task, wait oldest in flight batch so no busy spin.
+		if (m_manager.batchLoadAssetTaskEmpty())
 		{
+			retireBatches(true);
+			m_bProcessing = !m_inflightBatches.empty();
 			return;
 		}
 
-		// Get static task from manager.
-		m_manager.staticTasksAction([&, this](std::queue<std::shared_ptr<AssetLoadTask>>& srcQueue)
+		// All command buffer in flight, wait oldest one.
+		if (m_freeCommandBuffers.empty())
 		{
-			// Empty already.
-			if (srcQueue.size() == 0)
-			{
-				return;
-			}
+			retireBatches(true);
+		}
+
+		Batch batch{};
+		std::vector<uint64_t> stageOffsets{};
 
-			uint32_t availableSize = m_manager.getStaticUploadMaxSize();
+		bool bRingFull = false;
+		bool bBudgetLimited = false;
+
+		// Pack as many tasks as ring and frame budget allow into one batch.
+		m_manager.batchTasksAction([&, this](std::queue<AsyncUploadRequest>& srcQueue)
+		{
 			while (srcQueue.size() > 0)
 			{
-				std::shared_ptr<AssetLoadTask> processTask = srcQueue.front();
-				uint32_t requireSize = processTask->uploadSize();
+				const AsyncUploadRequest& request = srcQueue.front();
+				const uint32_t requireSize = request.task->uploadSize();
 				CHECK(requireSize < m_manager.getDynamicUploadMinSize());
 
-				// Small buffer use static uploader.
-				if (availableSize > requireSize)
+				const uint64_t prevHead = m_ringHead;
+				const uint64_t prevTail = m_ringTail;
+				const uint64_t prevUsed = m_ringUsed;
+
+				uint64_t offset;
+				uint64_t consumed;
+				if (!ringAllocate(requireSize, offset, consumed))
 				{
-					m_processingTasks.push_back(processTask);
-					availableSize -= requireSize;
-					m_bProcessing = true;
-					srcQueue.pop();
+					bRingFull = true;
+					break;
 				}
-				else
+
+				if (!m_manager.tryConsumeBudget(requireSize))
 				{
-					// No enough space for new task, break task push.
+					// Roll back ring allocation, task keep in queue.
+					m_ringHead = prevHead;
+					m_ringTail = prevTail;
+					m_ringUsed = prevUsed;
+
+					bBudgetLimited = true;
 					break;
 				}
+
+				stageOffsets.push_back(offset);
+				batch.ringBytes += consumed;
+				batch.uploadBytes += requireSize;
+				batch.tasks.push_back(request);
+
+				m_bProcessing = true;
+				srcQueue.pop();
 			}
 		});
 
-		// No processing task, return.
-		if (m_processingTasks.size() <= 0)
+		if (batch.tasks.empty())
 		{
+			if (bRingFull)
+			{
+				// Ring buffer used up by in flight batches.
+				retireBatches(true);
+			}
+			else if (bBudgetLimited)
+			{
+				m_manager.waitBudget();
+			}
+
+			m_bProcessing = !m_inflightBatches.empty();
 			return;
 		}
 
-		if (m_stageBuffer == nullptr)
-		{
-			VkDeviceSize baseBufferSize = static_cast<VkDeviceSize>(m_manager.getStaticUploadMaxSize());
-
-			m_stageBuffer = std::make_unique<VulkanBuffer>(
-				m_context,
-				getTransferBufferUniqueId().c_str(),
-				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-				VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
-				baseBufferSize,
-				nullptr
-			);
+		m_manager.onTasksPopped(batch.uploadBytes, (uint32_t)batch.tasks.size());
 
-			
-		}
+		batch.cmd = m_freeCommandBuffers.back();
+		m_freeCommandBuffers.pop_back();
 
-		// Do copy action here.
-		startRecord();
-		m_stageBuffer->map();
+		// Record all tasks in one command buffer.
+		startRecord(batch.cmd);
 		{
-			RHICommandBufferBase commandBase{ .cmd = m_commandBuffer, .pool = m_pool, .queueFamily = m_queueFamily };
-			void* mapped = m_stageBuffer->getMapped();
+			RHICommandBufferBase commandBase{ .cmd = batch.cmd, .pool = m_pool, .queueFamily = m_queueFamily };
+			uint8_t* mapped = (uint8_t*)m_stageBuffer->getMapped();
 
-			uint32_t offsetPos = 0;
-			for (auto& uploadingTask : m_processingTasks)
+			for (size_t i = 0; i < batch.tasks.size(); i++)
 			{
-				uploadingTask->uploadFunction(offsetPos, mapped, commandBase, *m_stageBuffer);
-				offsetPos += uploadingTask->uploadSize();
-				mapped = (void*)((char*)mapped + uploadingTask->uploadSize());
+				const uint64_t offset = stageOffsets[i];
+				const uint32_t size = batch.tasks[i].task->uploadSize();
+
+				batch.tasks[i].task->uploadFunction((uint32_t)offset, mapped + offset, commandBase, *m_stageBuffer);
+				m_stageBuffer->flush(size, offset);
 			}
 		}
-		m_stageBuffer->unmap();
 
-		endRecordAndSubmit();
+		batch.ringEnd = m_ringHead;
+		batch.timelineValue = endRecordAndSubmit(batch.cmd);
+
+		m_manager.onTasksSubmitted(batch.uploadBytes, (uint32_t)batch.tasks.size());
+		m_inflightBatches.push_back(std::move(batch));
 	}
 
-	void StaticAsyncUploader::threadFunction()
+	void BatchAsyncUploader::threadFunction()
 	{
+		Profiler::get()->setThreadName(m_name);
+
+		m_stageBuffer = std::make_unique<VulkanBuffer>(
+			m_context,
+			getTransferBufferUniqueId().c_str(),
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			m_manager.getBatchRingSize(),
+			nullptr
+		);
+
+		// Ring buffer keep mapped whole life.
+		m_stageBuffer->map();
+		m_freeCommandBuffers = m_commandBuffers;
+
 		while (m_bRun.load())
 		{
-			if (!m_manager.staticLoadAssetTaskEmpty() || m_bProcessing.load())
+			if (!m_manager.batchLoadAssetTaskEmpty() || m_bProcessing.load())
 			{
 				loadTick();
 			}
 			else
 			{
-				std::unique_lock<std::mutex> lock(m_manager.getStaticMutex());
-				m_manager.getStaticCondition().wait(lock);
+				m_manager.waitBatchTasks(m_bRun);
 			}
 		}
+
+		// Drain in flight batches before release resource.
+		while (!m_inflightBatches.empty())
+		{
+			retireBatches(true);
+		}
+
+		m_stageBuffer->unmap();
+		m_stageBuffer = nullptr;
 	}
 
-	AsyncUploaderManager::AsyncUploaderManager(VulkanContext* ct, uint32_t staticUploaderMaxSize, uint32_t dynamicUploaderMinSize)
-		: m_context(ct), m_dynamicUploaderMinSize(dynamicUploaderMinSize * 1024 * 1024), m_staticUploaderMaxSize(staticUploaderMaxSize * 1024 * 1024)
+	AsyncUploaderManager::AsyncUploaderManager(VulkanContext* ct, uint32_t batchUploaderRingSize, uint32_t dynamicUploaderMinSize)
+		: m_context(ct), m_dynamicUploaderMinSize(dynamicUploaderMinSize * 1024 * 1024), m_batchUploaderRingSize(batchUploaderRingSize * 1024 * 1024)
 	{
+		// Batch task must able to fit into ring.
+		CHECK(m_dynamicUploaderMinSize <= m_batchUploaderRingSize);
+
 		const auto& copyPools = m_context->getNormalCopyCommandPools();
 
 		const uint32_t copyFamily = m_context->getCopyFamily();
 
-		// One copy queue one static uploader.
-		m_staticUploaders.resize(copyPools.size());
-		for (size_t i = 0; i < m_staticUploaders.size(); i++)
+		m_queueMutexs.resize(copyPools.size());
+		for (auto& mutex : m_queueMutexs)
+		{
+			mutex = std::make_unique<std::mutex>();
+		}
+
+		// One copy queue one batch uploader.
+		m_batchUploaders.resize(copyPools.size());
+		for (size_t i = 0; i < m_batchUploaders.size(); i++)
 		{
-			std::string name = "StaticAsyncUpload_" + std::to_string(i);
-			m_staticUploaders[i] = std::make_unique<StaticAsyncUploader>(ct, name, *this, copyPools[i].queue, copyFamily);
+			std::string name = "BatchAsyncUpload_" + std::to_string(i);
+			m_batchUploaders[i] = std::make_unique<BatchAsyncUploader>(ct, name, *this, copyPools[i].queue, *m_queueMutexs[i], copyFamily);
 		}
 
 		// One dynamic uploader is enough.
@@ -321,37 +510,193 @@ namespace engine
 			std::string name = "DynamicAsyncUpload_" + std::to_string(i);
 
 			// Dynamic upload always use copy queue #0.
-			m_dynamicUploaders[i] = std::make_unique<DynamicAsyncUploader>(ct, name, *this, copyPools[0].queue, copyFamily);
+			m_dynamicUploaders[i] = std::make_unique<DynamicAsyncUploader>(ct, name, *this, copyPools[0].queue, *m_queueMutexs[0], copyFamily);
+		}
+
+		m_latencySamples.reserve(kLatencySampleCount);
+
+		// Start threads after all uploader construct finish.
+		for (auto& uploader : m_batchUploaders)
+		{
+			uploader->start();
+		}
+		for (auto& uploader : m_dynamicUploaders)
+		{
+			uploader->start();
 		}
 	}
 
 	void AsyncUploaderManager::addTask(std::shared_ptr<AssetLoadTask> inTask)
 	{
-		if (inTask->uploadSize() >= getDynamicUploadMinSize())
+		const uint32_t requireSize = inTask->uploadSize();
 		{
-			dynamicTasksAction([&](std::queue<std::shared_ptr<AssetLoadTask>>& queue){ queue.push(inTask); });
+			std::lock_guard lock(m_statisticsMutex);
+			m_statistics.queuedBytes += requireSize;
+			m_statistics.queuedTasks++;
+		}
+
+		AsyncUploadRequest request{ .task = inTask, .enqueueTime = std::chrono::steady_clock::now() };
+		if (requireSize >= getDynamicUploadMinSize())
+		{
+			dynamicTasksAction([&](std::queue<AsyncUploadRequest>& queue){ queue.push(request); });
 			m_dynamicContext.cv.notify_one();
 		}
 		else
 		{
-			// If size fit static uploader size, push in queue.
-			staticTasksAction([&](std::queue<std::shared_ptr<AssetLoadTask>>& queue) { queue.push(inTask); });
-			m_staticContext.cv.notify_one();
+			// If size fit batch uploader size, push in queue.
+			batchTasksAction([&](std::queue<AsyncUploadRequest>& queue) { queue.push(request); });
+			m_batchContext.cv.notify_one();
+		}
+	}
+
+	void AsyncUploaderManager::waitBatchTasks(const std::atomic<bool>& bRun)
+	{
+		std::unique_lock<std::mutex> lock(m_batchContext.mutex);
+		m_batchContext.cv.wait(lock, [&]() { return !m_batchContext.tasks.empty() || !bRun.load(); });
+	}
+
+	void AsyncUploaderManager::waitDynamicTasks(const std::atomic<bool>& bRun)
+	{
+		std::unique_lock<std::mutex> lock(m_dynamicContext.mutex);
+		m_dynamicContext.cv.wait(lock, [&]() { return !m_dynamicContext.tasks.empty() || !bRun.load(); });
+	}
+
+	bool AsyncUploaderManager::hasBudget() const
+	{
+		return m_bFlushing.load() || m_frameBudget.load() <= 0 || m_frameBudgetRemain.load() > 0;
+	}
+
+	void AsyncUploaderManager::waitBudget()
+	{
+		// Wake up by next frame start or flush, timeout in case no frame tick at all.
+		std::unique_lock<std::mutex> lock(m_budgetMutex);
+		m_budgetCondition.wait_for(lock, std::chrono::milliseconds(16), [this]() { return hasBudget(); });
+	}
+
+	bool AsyncUploaderManager::tryConsumeBudget(uint32_t size)
+	{
+		const int64_t budget = m_frameBudget.load();
+		if (m_bFlushing.load() || budget <= 0)
+		{
+			return true;
+		}
+
+		int64_t remain = m_frameBudgetRemain.load();
+		while (true)
+		{
+			// First task of frame can overdraw budget, otherwise task bigger than budget never upload.
+			if (remain <= 0 || (remain < int64_t(size) && remain != budget))
+			{
+				return false;
+			}
+
+			if (m_frameBudgetRemain.compare_exchange_weak(remain, remain - int64_t(size)))
+			{
+				return true;
+			}
+		}
+	}
+
+	void AsyncUploaderManager::onFrameStart()
+	{
+		const int64_t budget = int64_t(std::max(0, cVarAsyncUploadFrameBudgetMB.get())) * 1024 * 1024;
+		m_frameBudget = budget;
+		m_frameBudgetRemain = budget;
+
+		{
+			std::lock_guard lock(m_budgetMutex);
+		}
+		m_budgetCondition.notify_all();
+
+		CVarCmdHandle(cVarDumpAsyncUploadStatistics, [&]()
+		{
+			const auto stats = getStatistics();
+			LOG_INFO("Async upload: queued {0} tasks ({1} KB), in flight {2} tasks ({3} KB), uploaded {4} tasks ({5} MB) in {6} submits.",
+				stats.queuedTasks, stats.queuedBytes / 1024,
+				stats.inflightTasks, stats.inflightBytes / 1024,
+				stats.uploadedTasks, stats.uploadedBytes / (1024 * 1024), stats.submitCount);
+			LOG_INFO("Async upload latency: p50 {0:.2f} ms, p90 {1:.2f} ms, p99 {2:.2f} ms, max {3:.2f} ms.",
+				stats.latencyP50, stats.latencyP90, stats.latencyP99, stats.latencyMax);
+		});
+	}
+
+	void AsyncUploaderManager::onTasksPopped(uint64_t bytes, uint32_t count)
+	{
+		std::lock_guard lock(m_statisticsMutex);
+		m_statistics.queuedBytes -= bytes;
+		m_statistics.queuedTasks -= count;
+	}
+
+	void AsyncUploaderManager::onTasksSubmitted(uint64_t bytes, uint32_t count)
+	{
+		std::lock_guard lock(m_statisticsMutex);
+		m_statistics.inflightBytes += bytes;
+		m_statistics.inflightTasks += count;
+		m_statistics.submitCount++;
+	}
+
+	void AsyncUploaderManager::onTaskFinished(const AsyncUploadRequest& request, uint32_t bytes)
+	{
+		const std::chrono::duration<float, std::milli> latency = std::chrono::steady_clock::now() - request.enqueueTime;
+
+		std::lock_guard lock(m_statisticsMutex);
+		m_statistics.inflightBytes -= bytes;
+		m_statistics.inflightTasks--;
+		m_statistics.uploadedBytes += bytes;
+		m_statistics.uploadedTasks++;
+
+		// Keep recent samples in ring.
+		if (m_latencySamples.size() < kLatencySampleCount)
+		{
+			m_latencySamples.push_back(latency.count());
+		}
+		else
+		{
+			m_latencySamples[m_latencySampleIndex] = latency.count();
+			m_latencySampleIndex = (m_latencySampleIndex + 1) % kLatencySampleCount;
 		}
 	}
 
+	AsyncUploadStatistics AsyncUploaderManager::getStatistics() const
+	{
+		AsyncUploadStatistics result;
+		std::vector<float> samples;
+		{
+			std::lock_guard lock(m_statisticsMutex);
+			result = m_statistics;
+			samples = m_latencySamples;
+		}
+
+		if (!samples.empty())
+		{
+			auto percentile = [&](float p)
+			{
+				const size_t index = std::min(samples.size() - 1, size_t(p * float(samples.size())));
+				std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+				return samples[index];
+			};
+
+			result.latencyP50 = percentile(0.50f);
+			result.latencyP90 = percentile(0.90f);
+			result.latencyP99 = percentile(0.99f);
+			result.latencyMax = *std::max_element(samples.begin(), samples.end());
+		}
+
+		return result;
+	}
+
 	bool AsyncUploaderManager::busy()
 	{
 		bool bAllFree = true;
 
 		// All tasks free.
-		bAllFree &= staticLoadAssetTaskEmpty();
+		bAllFree &= batchLoadAssetTaskEmpty();
 		bAllFree &= dynamicLoadAssetTaskEmpty();
 
 		// Also handle no processing case.
-		for (size_t i = 0; i < m_staticUploaders.size(); i++)
+		for (size_t i = 0; i < m_batchUploaders.size(); i++)
 		{
-			bAllFree &= !m_staticUploaders[i]->isProcessing();
+			bAllFree &= !m_batchUploaders[i]->isProcessing();
 		}
 		for (size_t i = 0; i < m_dynamicUploaders.size(); i++)
 		{
@@ -363,12 +708,18 @@ namespace engine
 
 	void AsyncUploaderManager::flushTask()
 	{
-		getStaticCondition().notify_all();
+		// Flush ignore frame budget, otherwise it may wait forever when no frame tick.
+		m_bFlushing = true;
+		m_budgetCondition.notify_all();
+
+		getBatchCondition().notify_all();
 		getDynamicCondition().notify_all();
 		while (busy())
 		{
 			std::this_thread::yield();
 		}
+
+		m_bFlushing = false;
 	}
 
 	void AsyncUploaderManager::release()
@@ -376,22 +727,30 @@ namespace engine
 		flushTask();
 		LOG_INFO("Start release async uploader threads...");
 
-		for (size_t i = 0; i < m_staticUploaders.size(); i++)
+		// Lock before notify, avoid thread miss the stop signal between predicate check and wait.
+		for (size_t i = 0; i < m_batchUploaders.size(); i++)
+		{
+			m_batchUploaders[i]->setStop();
+		}
 		{
-			m_staticUploaders[i]->setStop();
+			std::lock_guard lock(m_batchContext.mutex);
 		}
-		m_staticContext.cv.notify_all();
+		m_batchContext.cv.notify_all();
+
 		for (size_t i = 0; i < m_dynamicUploaders.size(); i++)
 		{
 			m_dynamicUploaders[i]->setStop();
 		}
+		{
+			std::lock_guard lock(m_dynamicContext.mutex);
+		}
 		m_dynamicContext.cv.notify_all();
 
 		// Wait all futures.
-		for (size_t i = 0; i < m_staticUploaders.size(); i++)
+		for (size_t i = 0; i < m_batchUploaders.size(); i++)
 		{
-			m_staticUploaders[i]->wait();
-			m_staticUploaders[i].reset();
+			m_batchUploaders[i]->wait();
+			m_batchUploaders[i].reset();
 		}
 		for (size_t i = 0; i < m_dynamicUploaders.size(); i++)
 		{
@@ -402,4 +761,4 @@ namespace engine
 		LOG_INFO("All async uploader threads release.");
 	}
 
-}
\ No newline at end of file
+}
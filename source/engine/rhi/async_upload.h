@@ -1,11 +1,14 @@
 #pragma once
 #include "resource.h"
 
+#include <chrono>
+#include <deque>
+
 namespace engine
 {
 	class VulkanContext;
 
-	// Static uploader: allocate static stage buffer and never release.
+	// Batch uploader: pack many small tasks into one persistent ring stage buffer, one submit per batch.
 	// Dynamic uploader: Allocate dynamic stage buffer when need, and release when no task.
 
 	struct AssetLoadTask
@@ -19,11 +22,40 @@ namespace engine
 		// Upload main body function.
 		virtual void uploadFunction(
 			uint32_t stageBufferOffset,
-			void* bufferPtrStart, 
+			void* bufferPtrStart,
 			RHICommandBufferBase& commandBuffer,
 			VulkanBuffer& stageBuffer) = 0;
 	};
 
+	// Task in uploader queue, record enqueue time for latency statistics.
+	struct AsyncUploadRequest
+	{
+		std::shared_ptr<AssetLoadTask> task;
+		std::chrono::steady_clock::time_point enqueueTime;
+	};
+
+	struct AsyncUploadStatistics
+	{
+		// Tasks wait in queue, no stage buffer allocate yet.
+		uint64_t queuedBytes = 0;
+		uint32_t queuedTasks = 0;
+
+		// Tasks already submit to gpu but not finish.
+		uint64_t inflightBytes = 0;
+		uint32_t inflightTasks = 0;
+
+		// Accumulate count since uploader create.
+		uint64_t uploadedBytes = 0;
+		uint64_t uploadedTasks = 0;
+		uint64_t submitCount = 0;
+
+		// Enqueue to finish callback latency of recent tasks, in milliseconds.
+		float latencyP50 = 0.0f;
+		float latencyP90 = 0.0f;
+		float latencyP99 = 0.0f;
+		float latencyMax = 0.0f;
+	};
+
 	class AsyncUploaderManager;
 
 	class AsyncUploaderBase : NonCopyable
@@ -35,21 +67,22 @@ namespace engine
 
 		VulkanContext* m_context;
 
-		// This loader tasks finish fence.
-		VkFence m_fence = VK_NULL_HANDLE;
+		// Timeline semaphore signal when submit finish, value increase one per submit.
+		VkSemaphore m_timeline = VK_NULL_HANDLE;
+		uint64_t m_timelineValue = 0;
 
 		// Working queue.
 		VkQueue m_queue = VK_NULL_HANDLE;
 
+		// Queue may share with other uploader, guard queue submit.
+		std::mutex& m_queueMutex;
+
 		// Working queue family.
 		uint32_t m_queueFamily = VK_QUEUE_FAMILY_IGNORED;
 
 		// Working pool.
 		VkCommandPool m_pool = VK_NULL_HANDLE;
 
-		// Working commmand buffer.
-		VkCommandBuffer m_commandBuffer = VK_NULL_HANDLE;
-
 		// Uploader can still alive.
 		std::atomic<bool> m_bRun = true;
 
@@ -62,12 +95,27 @@ namespace engine
 	protected:
 		virtual void threadFunction() = 0;
 
-		void resetProcessState();
-		void startRecord();
-		void endRecordAndSubmit();
+		// How many command buffer uploader require.
+		virtual uint32_t getCommandBufferCount() const { return 1; }
+
+		std::vector<VkCommandBuffer> m_commandBuffers;
+
+		void startRecord(VkCommandBuffer cmd);
+
+		// Submit and return timeline value which signal when finish.
+		uint64_t endRecordAndSubmit(VkCommandBuffer cmd);
+
+		uint64_t getCompletedValue() const;
+
+		// Block until timeline reach value.
+		void waitValue(uint64_t value) const;
 
 	public:
-		AsyncUploaderBase(VulkanContext* context, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, uint32_t inFamily);
+		AsyncUploaderBase(VulkanContext* context, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, std::mutex& inQueueMutex, uint32_t inFamily);
+		virtual ~AsyncUploaderBase() = default;
+
+		// Start working thread, call after construct finish.
+		void start();
 
 		void setStop()
 		{
@@ -88,7 +136,10 @@ namespace engine
 	class DynamicAsyncUploader : public AsyncUploaderBase
 	{
 	private:
-		std::shared_ptr<AssetLoadTask> m_processingTask = nullptr;
+		AsyncUploadRequest m_processingTask = { };
+
+		// Timeline value of processing task.
+		uint64_t m_processingValue = 0;
 
 		// Upload stage buffer.
 		std::unique_ptr<VulkanBuffer> m_stageBuffer = nullptr;
@@ -99,28 +150,63 @@ namespace engine
 		virtual void threadFunction() override;
 
 	public:
-		DynamicAsyncUploader(VulkanContext* context, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, uint32_t inFamily)
-			: AsyncUploaderBase(context, name, in, inQueue, inFamily)
+		DynamicAsyncUploader(VulkanContext* context, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, std::mutex& inQueueMutex, uint32_t inFamily)
+			: AsyncUploaderBase(context, name, in, inQueue, inQueueMutex, inFamily)
 		{
 
 		}
 	};
 
-	class StaticAsyncUploader : public AsyncUploaderBase
+	class BatchAsyncUploader : public AsyncUploaderBase
 	{
 	private:
-		// Task upload use static stage buffer.
-		std::vector<std::shared_ptr<AssetLoadTask>> m_processingTasks;
+		// Batch count can in flight at same time, each batch own one command buffer.
+		static constexpr uint32_t kMaxInflightBatchCount = 3;
+
+		// Stage offset alignment of each task, match biggest texel block size.
+		static constexpr uint64_t kTaskAlignment = 16;
+
+		struct Batch
+		{
+			std::vector<AsyncUploadRequest> tasks;
+
+			VkCommandBuffer cmd = VK_NULL_HANDLE;
 
+			// Timeline value signal when batch finish.
+			uint64_t timelineValue = 0;
+
+			// Ring range consumed by this batch, include alignment and wrap padding.
+			uint64_t ringEnd = 0;
+			uint64_t ringBytes = 0;
+
+			// Task upload bytes.
+			uint64_t uploadBytes = 0;
+		};
+
+		// Persistent mapped ring stage buffer.
 		std::unique_ptr<VulkanBuffer> m_stageBuffer = nullptr;
+		uint64_t m_ringHead = 0;
+		uint64_t m_ringTail = 0;
+		uint64_t m_ringUsed = 0;
+
+		// Submitted batches in submit order.
+		std::deque<Batch> m_inflightBatches;
+		std::vector<VkCommandBuffer> m_freeCommandBuffers;
 
 	private:
+		// Allocate size from ring, return false if no enough space.
+		bool ringAllocate(uint64_t size, uint64_t& outOffset, uint64_t& outConsumed);
+
+		// Finish all completed batches, if bWaitOldest, block until oldest batch finish.
+		void retireBatches(bool bWaitOldest);
+
 		void loadTick();
 		virtual void threadFunction() override;
+		virtual uint32_t getCommandBufferCount() const override { return kMaxInflightBatchCount; }
 
 	public:
-		StaticAsyncUploader(VulkanContext* context, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, uint32_t inFamily)
-			: AsyncUploaderBase(context, name, in, inQueue, inFamily)
+		BatchAsyncUploader(VulkanContext* context, const std::string& name, AsyncUploaderManager& in, VkQueue inQueue, std::mutex& inQueueMutex, uint32_t inFamily)
+			: AsyncUploaderBase(context, name, in, inQueue, inQueueMutex, inFamily)
 		{
 
 		}
@@ -129,7 +215,7 @@ namespace engine
 	class AsyncUploaderManager : NonCopyable
 	{
 	private:
-		// Task need to load use static stage buffer.
+		// Task need to load use batch ring stage buffer or dynamic stage buffer.
 		struct UploaderContext
 		{
 			std::condition_variable cv;
@@ -138,50 +224,94 @@ namespace engine
 			std::mutex mutex;
 
 			// Task queue.
-			std::queue<std::shared_ptr<AssetLoadTask>> tasks;
+			std::queue<AsyncUploadRequest> tasks;
 		};
 
 		VulkanContext* m_context;
 
-		UploaderContext m_staticContext;
-		std::vector<std::unique_ptr<StaticAsyncUploader>> m_staticUploaders;
+		UploaderContext m_batchContext;
+		std::vector<std::unique_ptr<BatchAsyncUploader>> m_batchUploaders;
 
 		UploaderContext m_dynamicContext;
 		std::vector<std::unique_ptr<DynamicAsyncUploader>> m_dynamicUploaders;
 
-		uint32_t m_staticUploaderMaxSize;
+		// One mutex per copy queue, vkQueueSubmit require external sync.
+		std::vector<std::unique_ptr<std::mutex>> m_queueMutexs;
+
+		uint32_t m_batchUploaderRingSize;
 		uint32_t m_dynamicUploaderMinSize;
 
+		// Remain upload bytes of current frame, refill when frame start.
+		std::atomic<int64_t> m_frameBudgetRemain = 0;
+		std::atomic<int64_t> m_frameBudget = 0;
+
+		// Ignore frame budget when flush.
+		std::atomic<bool> m_bFlushing = false;
+
+		// Uploader wait here when frame budget used up.
+		std::mutex m_budgetMutex;
+		std::condition_variable m_budgetCondition;
+
+		bool hasBudget() const;
+
+		// Statistics.
+		static constexpr size_t kLatencySampleCount = 1024;
+
+		mutable std::mutex m_statisticsMutex;
+		AsyncUploadStatistics m_statistics;
+		std::vector<float> m_latencySamples;
+		size_t m_latencySampleIndex = 0;
+
 	public:
-		explicit AsyncUploaderManager(VulkanContext* context, uint32_t staticUploaderMaxSize, uint32_t dynamicUploaderMinSize);
+		explicit AsyncUploaderManager(VulkanContext* context, uint32_t batchUploaderRingSize, uint32_t dynamicUploaderMinSize);
 
 		void addTask(std::shared_ptr<AssetLoadTask> inTask);
 
 		void flushTask();
 
-		std::condition_variable& getStaticCondition()
+		// Call when frame start, refill upload budget.
+		void onFrameStart();
+
+		// Consume frame budget, always success for the first task of frame, so big task never starve.
+		bool tryConsumeBudget(uint32_t size);
+
+		// Block until next frame budget refill or flush.
+		void waitBudget();
+
+		// Block until task queue no empty or uploader stop.
+		void waitBatchTasks(const std::atomic<bool>& bRun);
+		void waitDynamicTasks(const std::atomic<bool>& bRun);
+
+		// Uploader report.
+		void onTasksPopped(uint64_t bytes, uint32_t count);
+		void onTasksSubmitted(uint64_t bytes, uint32_t count);
+		void onTaskFinished(const AsyncUploadRequest& request, uint32_t bytes);
+
+		AsyncUploadStatistics getStatistics() const;
+
+		std::condition_variable& getBatchCondition()
 		{
-			return m_staticContext.cv;
+			return m_batchContext.cv;
 		}
 
-		uint32_t getStaticUploadMaxSize() const { return m_staticUploaderMaxSize; }
+		uint32_t getBatchRingSize() const { return m_batchUploaderRingSize; }
 		uint32_t getDynamicUploadMinSize() const { return m_dynamicUploaderMinSize; }
 
-		std::mutex& getStaticMutex()
+		std::mutex& getBatchMutex()
 		{
-			return m_staticContext.mutex;
+			return m_batchContext.mutex;
 		}
 
-		bool staticLoadAssetTaskEmpty()
+		bool batchLoadAssetTaskEmpty()
 		{
-			std::lock_guard lock(m_staticContext.mutex);
-			return m_staticContext.tasks.size() == 0;
+			std::lock_guard lock(m_batchContext.mutex);
+			return m_batchContext.tasks.size() == 0;
 		}
 
-		void staticTasksAction(std::function<void(decltype(m_staticContext.tasks)&)>&& func)
+		void batchTasksAction(std::function<void(decltype(m_batchContext.tasks)&)>&& func)
 		{
-			std::lock_guard lock(m_staticContext.mutex);
-			func(m_staticContext.tasks);
+			std::lock_guard lock(m_batchContext.mutex);
+			func(m_batchContext.tasks);
 		}
 
 		std::condition_variable& getDynamicCondition()
@@ -210,4 +340,4 @@ namespace engine
 
 		void release();
 	};
-}
\ No newline at end of file
+}
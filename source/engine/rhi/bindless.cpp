@@ -27,6 +27,7 @@ namespace engine
 
 		// Set max descriptor sampler count to a big number.
 		CHECK(bindlessMaxCountConfig < maxDeviceLimit);
+		m_maxCount = bindlessMaxCountConfig;
 
 		binding.descriptorCount = bindlessMaxCountConfig;
 
@@ -199,6 +200,14 @@ namespace engine
 	}
 
 	uint32_t BindlessTexture::updateTextureToBindlessDescriptorSet(VkImageView view, VkImageLayout layout)
+	{
+		const uint32_t index = getCountAndAndOne();
+		updateTextureAtBindlessIndex(index, view, layout);
+
+		return index;
+	}
+
+	void BindlessTexture::updateTextureAtBindlessIndex(uint32_t index, VkImageView view, VkImageLayout layout)
 	{
 		VkDescriptorImageInfo imageInfo{};
 		imageInfo.sampler = VK_NULL_HANDLE;
@@ -213,11 +222,9 @@ namespace engine
 		write.dstBinding = 0;
 		write.pImageInfo = &imageInfo;
 		write.descriptorCount = 1;
-		write.dstArrayElement = getCountAndAndOne();
+		write.dstArrayElement = index;
 
 		vkUpdateDescriptorSets(m_context->getDevice(), 1, &write, 0, nullptr);
-
-		return write.dstArrayElement;
 	}
 
 	void BindlessTexture::freeBindlessImpl(uint32_t index, VulkanImage* fallback)
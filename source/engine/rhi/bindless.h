@@ -31,6 +31,9 @@ namespace engine
 		// Max bindless item use in this set limit by device.
 		uint32_t m_maxDeviceLimitCount;
 
+		// Max bindless item count config of this set.
+		uint32_t m_maxCount = 0;
+
 		void initTemplate(const char* name, VkDescriptorType type, const VulkanContext* inContext, uint32_t maxDeviceLimit);
 
 		// Threadsafe free function.
@@ -43,6 +46,7 @@ namespace engine
 		uint32_t getCountAndAndOne();
 
 		// Getter.
+		uint32_t getMaxCount() const { return m_maxCount; }
 		VkDescriptorSet getSet() const;
 		VkDescriptorSetLayout getSetLayout() const;
 
@@ -76,6 +80,9 @@ namespace engine
 		// return bindless index.
 		uint32_t updateTextureToBindlessDescriptorSet(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
+		// Rewrite view of exist bindless index, keep index stable when image recreate.
+		void updateTextureAtBindlessIndex(uint32_t index, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
 		void freeBindlessImpl(uint32_t index, VulkanImage* fallback = nullptr);
 	};
 
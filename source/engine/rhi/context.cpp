@@ -74,10 +74,13 @@ namespace engine
             // Init shader cache.
             m_shaderCache.init(this);
 
+            // Init pipeline cache, load from disk if exist.
+            m_pipelineCache.init(this);
+
             // Init sampler cache, must after bindless sampler.
             m_samplerCache.init(this);
             
-            // 64 MB static uploader, 32 MB dynamic uploader.
+            // 64 MB batch uploader ring, 32 MB dynamic uploader.
             m_uploader = std::make_unique<AsyncUploaderManager>(this, 64, 32); 
 
             // 1024 MB + 512 MB LRU cache.
@@ -97,6 +100,15 @@ namespace engine
             }
             m_gpuResourcePending.resize(frameNum);
 
+            // Async compute segment command buffers per frame in flight.
+            m_asyncCompute = std::make_unique<AsyncComputeScheduler>(this, frameNum);
+
+            // Secondary command pools per frame in flight and record slot.
+            m_parallelRecorder = std::make_unique<ParallelCommandRecorder>(this, frameNum);
+
+            // Texture streaming feedback readback per frame in flight.
+            m_textureStreaming = std::make_unique<TextureStreamingManager>(this, frameNum);
+
             m_dynamicUniformBuffer = std::make_unique<DynamicUniformBuffer>(this, frameNum, 16, 8); // 16 MB init dynamic uniform buffer size, 8 MB increment when overflow.
 
             m_rtPool = std::make_unique<RenderTexturePool>(this);
@@ -122,6 +134,9 @@ namespace engine
     {
         m_dynamicUniformBuffer->onFrameStart();
 
+        // Refill async upload frame budget.
+        m_uploader->onFrameStart();
+
         // Update passes if need.
         CVarCmdHandle(cVarUpdatePasses, [&]() { m_passCollector->updateAllPasses(); });
 
@@ -129,6 +144,12 @@ namespace engine
         m_rtPool->tick();
         m_bufferParameters->tick();
 
+        // Release evicted assets and kick lru eviction.
+        m_lru->tick();
+
+        // Swap streamed texture mips and issue new streaming.
+        m_textureStreaming->tick();
+
         m_gpuResourcePending[m_presentContext.currentFrame].clear();
         return true;
     }
@@ -157,6 +178,13 @@ namespace engine
 
         m_uploader->release();
 
+        // Release streaming feedback buffers before bindless release.
+        m_textureStreaming = nullptr;
+
+        // Free segment command buffers before command pools destroy.
+        m_asyncCompute = nullptr;
+        m_parallelRecorder = nullptr;
+
         if (m_engine->isWindowApp())
         {
             destroyPresentContext();
@@ -178,6 +206,9 @@ namespace engine
         // Shader cache release.
         m_shaderCache.release();
 
+        // Pipeline cache save to disk and release.
+        m_pipelineCache.release();
+
         destroyCommandPools();
 
         destroyVMA();
@@ -389,6 +420,11 @@ namespace engine
         vkFreeCommandBuffers(m_device, getMajorGraphicsCommandPool(), 1, &cmd);
     }
 
+    uint32_t VulkanContext::getCommandBufferQueueFamily(VkCommandBuffer cmd) const
+    {
+        return m_asyncCompute ? m_asyncCompute->getQueueFamily(cmd) : getGraphiscFamily();
+    }
+
     void VulkanContext::executeImmediately(VkCommandPool commandPool, VkQueue queue, std::function<void(VkCommandBuffer cb)>&& func) const
     {
         VkCommandBufferAllocateInfo allocInfo{};
@@ -428,7 +464,8 @@ namespace engine
 
     UUID VulkanContext::getBuiltEngineAssetUUID(EBuiltinEngineAsset type)
     {
-    #define CASE_STR(X) case EBuiltinEngineAsset::X: return "EBuiltinEngineAsset::"#X;
+    // Builtin name hash once, keep same uuid with old archive which store builtin name.
+    #define CASE_STR(X) case EBuiltinEngineAsset::X: { static const UUID uuid = UUID::fromName("EBuiltinEngineAsset::"#X); return uuid; }
 
         switch (type)
         {
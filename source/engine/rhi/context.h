@@ -8,14 +8,18 @@
 
 #include "sampler_cache.h"
 #include "shader_cache.h"
+#include "pipeline_cache.h"
 #include "descriptor.h"
 #include "swapchain.h"
 #include "async_upload.h"
+#include "async_compute.h"
+#include "parallel_command.h"
 #include "gpu_asset.h"
 #include "render_texture_pool.h"
 #include "pass.h"
 #include "dynamic_uniform_buffer.h"
 #include "ssbo_buffers.h"
+#include "texture_streaming.h"
 
 namespace engine
 {
@@ -68,6 +72,7 @@ namespace engine
 		const VkPhysicalDeviceMemoryProperties& getPhysicalDeviceMemoryProperties() const { return m_memoryProperties; }
 		const VkPhysicalDeviceDescriptorIndexingPropertiesEXT& getPhysicalDeviceDescriptorIndexingProperties() const { return m_descriptorIndexingProperties; }
 		const VkPhysicalDeviceProperties& getPhysicalDeviceProperties() const { return m_deviceProperties; }
+		const VkPhysicalDeviceIDProperties& getPhysicalDeviceIDProperties() const { return m_deviceIDProperties; }
 
 		VkDevice getDevice() const { return m_device; }
 		VkPhysicalDevice getGPU() const { return m_gpu; }
@@ -117,6 +122,9 @@ namespace engine
 		SamplerCache& getSamplerCache() { return m_samplerCache; }
 		ShaderCache& getShaderCache() { return m_shaderCache; }
 
+		// Engine wide pipeline cache, shared by all pipeline create.
+		VkPipelineCache getPipelineCache() const { return m_pipelineCache.get(); }
+
 		// Context owned bindless sampler.
 		BindlessSampler& getBindlessSampler() { return m_bindlessSampler; }
 		const BindlessSampler& getBindlessSampler() const { return m_bindlessSampler; }
@@ -178,11 +186,19 @@ namespace engine
 
 		VkSemaphore getCurrentFrameWaitSemaphore() const { return m_presentContext.semaphoresImageAvailable[m_presentContext.currentFrame]; }
 		VkSemaphore getCurrentFrameFinishSemaphore() const { return m_presentContext.semaphoresRenderFinished[m_presentContext.currentFrame]; }
+		uint32_t getCurrentFrameIndex() const { return m_presentContext.currentFrame; }
 
 		void waitDeviceIdle() const;
 
 		AsyncUploaderManager& getAsyncUploader() { return *m_uploader; }
 
+		AsyncComputeScheduler& getAsyncCompute() { return *m_asyncCompute; }
+
+		ParallelCommandRecorder& getParallelCommandRecorder() { return *m_parallelRecorder; }
+
+		// Queue family of command buffer record to, async compute segment return compute family.
+		uint32_t getCommandBufferQueueFamily(VkCommandBuffer cmd) const;
+
 		
 
 		static UUID getBuiltEngineAssetUUID(EBuiltinEngineAsset type);
@@ -219,6 +235,8 @@ namespace engine
 		std::shared_ptr<GPUImageAsset> getOrCreateTextureAsset(const UUID& uuid);
 		const auto& getLRU() const { return m_lru; }
 
+		TextureStreamingManager& getTextureStreaming() { return *m_textureStreaming; }
+
 		const auto& getPasses() const { return *m_passCollector; }
 		auto& getPasses() { return *m_passCollector; }
 
@@ -295,6 +313,7 @@ namespace engine
 		VkPhysicalDeviceSubgroupProperties m_subgroupProperties;
 		VkPhysicalDeviceDescriptorIndexingPropertiesEXT m_descriptorIndexingProperties;
 		VkPhysicalDeviceAccelerationStructurePropertiesKHR m_accelerationStructureProperties;
+		VkPhysicalDeviceIDProperties       m_deviceIDProperties;
 
 		struct DeviceSupportStates
 		{
@@ -317,6 +336,9 @@ namespace engine
 		// Shader cache.
 		ShaderCache m_shaderCache;
 
+		// Pipeline cache.
+		PipelineCache m_pipelineCache;
+
 		// Sampler cache.
 		SamplerCache m_samplerCache;
 
@@ -382,7 +404,12 @@ namespace engine
 
 		std::unique_ptr<AsyncUploaderManager> m_uploader;
 
+		std::unique_ptr<AsyncComputeScheduler> m_asyncCompute;
+
+		std::unique_ptr<ParallelCommandRecorder> m_parallelRecorder;
+
 		std::unique_ptr<LRUAssetCache> m_lru;
+		std::unique_ptr<TextureStreamingManager> m_textureStreaming;
 		std::unordered_map<UUID, std::shared_ptr<LRUAssetInterface>> m_engineAssets;
 		std::unordered_map<UUID, StaticMeshRenderBounds> m_engineMeshBounds;
 
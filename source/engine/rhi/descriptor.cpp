@@ -38,6 +38,8 @@ namespace engine
 
     bool DescriptorAllocator::allocate(VkDescriptorSet* set, VkDescriptorSetLayout layout)
     {
+        std::lock_guard lock(m_allocateMutex);
+
         // when current working pool is null then request new.
         if (m_currentPool == VK_NULL_HANDLE)
         {
@@ -153,6 +155,7 @@ namespace engine
         }
 
         // perpare VkDescriptorSetLayout
+        std::lock_guard lock(m_layoutCacheMutex);
         auto it = m_layoutCache.find(layoutinfo);
         if (it != m_layoutCache.end())
         {
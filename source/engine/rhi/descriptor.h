@@ -37,6 +37,9 @@ namespace engine
         std::vector<VkDescriptorPool> m_usedPools;
         std::vector<VkDescriptorPool> m_freePools;
 
+        // Pass may init on worker threads, vkAllocateDescriptorSets require pool external synchronized.
+        std::mutex m_allocateMutex;
+
         VkDescriptorPool requestPool();
     public:
         // reset all using pool to free.
@@ -73,6 +76,9 @@ namespace engine
         typedef std::unordered_map<DescriptorLayoutInfo, VkDescriptorSetLayout, DescriptorLayoutHash> LayoutCache;
         LayoutCache m_layoutCache;
 
+        // Pass may init on worker threads, guard layout cache.
+        std::mutex m_layoutCacheMutex;
+
         const VulkanContext* m_context;
 
     public:
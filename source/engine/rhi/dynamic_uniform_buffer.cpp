@@ -49,20 +49,20 @@ namespace engine
 
 	uint32_t DynamicUniformBuffer::alloc(uint32_t size)
 	{
-		uint32_t scrOffset = m_usedSize;
-
 		// Add align size.
-		m_usedSize += getAlignSize(size);
+		const uint32_t alignSize = getAlignSize(size);
+		const uint32_t scrOffset = m_usedSize.fetch_add(alignSize, std::memory_order_relaxed);
 
 		// NOTE: We use max uniform buffer range set here, so need to ensure at least it never overflow.
-		if (m_usedSize >= (m_totoalSize - m_context->getPhysicalDeviceProperties().limits.maxUniformBufferRange))
+		if (scrOffset + alignSize >= (m_totoalSize - m_context->getPhysicalDeviceProperties().limits.maxUniformBufferRange))
 		{
-			LOG_TRACE("Dynamic uniform buffer overflow, will increment next time loop.");
-			m_bShouldIncSize = true;
+			if (!m_bShouldIncSize.exchange(true))
+			{
+				LOG_TRACE("Dynamic uniform buffer overflow, will increment next time loop.");
+			}
 
 			// When overflow, this frame will render error, and will fix in next frame.
-			m_usedSize = 0;
-			scrOffset = 0;
+			return 0;
 		}
 
 		return scrOffset;
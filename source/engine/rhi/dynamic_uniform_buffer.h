@@ -2,6 +2,8 @@
 
 #include "rhi_misc.h"
 
+#include <atomic>
+
 namespace engine
 {
 	class VulkanBuffer;
@@ -12,7 +14,7 @@ namespace engine
 	{
 	private:
 		// Increment state.
-		bool m_bShouldIncSize = false;
+		std::atomic<bool> m_bShouldIncSize = false;
 
 		// Fix config.
 		VulkanContext* m_context = nullptr;
@@ -26,7 +28,9 @@ namespace engine
 		std::vector<VkDescriptorSet> m_sets;
 		std::vector<VkDescriptorSetLayout> m_layouts;
 		uint32_t m_currentFrameID = 0;
-		uint32_t m_usedSize = 0;
+
+		// Alloc from parallel recording threads, lock free bump.
+		std::atomic<uint32_t> m_usedSize = 0;
 
 	public:
 		explicit DynamicUniformBuffer(VulkanContext* context, uint32_t frameNum, uint32_t initSize, uint32_t incrementSize);
@@ -36,6 +40,8 @@ namespace engine
 		void onFrameStart();
 
 		uint32_t getAlignSize(uint32_t src) const;
+
+		// Thread safe, can call from parallel recording threads.
 		uint32_t alloc(uint32_t size);
 
 		const VulkanBuffer* getBuffer() const { return m_buffers[m_currentFrameID].get(); }
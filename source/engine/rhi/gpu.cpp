@@ -51,8 +51,12 @@ namespace engine
 
             m_accelerationStructureProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR };
 
+            // Driver uuid used to validate pipeline cache.
+            m_deviceIDProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES };
+
             deviceProperties.pNext = &m_descriptorIndexingProperties;
             m_descriptorIndexingProperties.pNext = &m_accelerationStructureProperties;
+            m_accelerationStructureProperties.pNext = &m_deviceIDProperties;
 
 
             getPhysicalDeviceProperties2(m_gpu, &deviceProperties);
@@ -21,19 +21,15 @@ namespace engine
 		return std::format("GPUAssetId: {}. {}.", GRuntimeId, in);
 	}
 
-	GPUImageAsset::GPUImageAsset(
+	static std::unique_ptr<VulkanImage> createAssetImage(
 		VulkanContext* context,
-		GPUImageAsset* fallback,
 		VkFormat format,
 		const std::string& name,
 		uint32_t mipmapCount,
 		uint32_t width,
 		uint32_t height,
 		uint32_t depth)
-		: m_context(context), LRUAssetInterface(fallback)
 	{
-		CHECK(m_image == nullptr && "You must ensure image asset only init once.");
-
 		VkImageCreateInfo info{};
 		info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		info.flags = {};
@@ -50,7 +46,23 @@ namespace engine
 		info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-		m_image = std::make_unique<VulkanImage>(m_context, getRuntimeUniqueGPUAssetName(name).c_str(), info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		return std::make_unique<VulkanImage>(context, getRuntimeUniqueGPUAssetName(name).c_str(), info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+
+	GPUImageAsset::GPUImageAsset(
+		VulkanContext* context,
+		GPUImageAsset* fallback,
+		VkFormat format,
+		const std::string& name,
+		uint32_t mipmapCount,
+		uint32_t width,
+		uint32_t height,
+		uint32_t depth)
+		: m_context(context), LRUAssetInterface(fallback)
+	{
+		CHECK(m_image == nullptr && "You must ensure image asset only init once.");
+
+		m_image = createAssetImage(m_context, format, name, mipmapCount, width, height, depth);
 	}
 
 	GPUImageAsset::~GPUImageAsset()
@@ -77,6 +89,83 @@ namespace engine
 		CHECK(m_bindlessIndex != ~0);
 	}
 
+	GPUStreamingImageAsset::GPUStreamingImageAsset(
+		VulkanContext* context,
+		GPUImageAsset* fallback,
+		VkFormat format,
+		const std::string& name,
+		const UUID& assetUUID,
+		const std::filesystem::path& binPath,
+		std::vector<uint32_t>&& mipSizes,
+		uint32_t width,
+		uint32_t height,
+		uint32_t tailMip)
+		: GPUImageAsset(context, fallback, format, name, uint32_t(mipSizes.size()) - tailMip,
+			std::max<uint32_t>(width >> tailMip, 1), std::max<uint32_t>(height >> tailMip, 1), 1)
+		, m_name(name)
+		, m_format(format)
+		, m_assetUUID(assetUUID)
+		, m_binPath(binPath)
+		, m_mipSizes(std::move(mipSizes))
+		, m_width(width)
+		, m_height(height)
+		, m_tailMip(tailMip)
+		, m_residentMip(tailMip)
+	{
+		CHECK(m_tailMip < m_mipSizes.size());
+	}
+
+	size_t GPUStreamingImageAsset::getResidentSize(uint32_t firstMip) const
+	{
+		size_t size = 0;
+		for (uint32_t level = firstMip; level < getMipCount(); level++)
+		{
+			size += m_mipSizes[level];
+		}
+		return size;
+	}
+
+	std::unique_ptr<VulkanImage> GPUStreamingImageAsset::createMipImage(uint32_t firstMip) const
+	{
+		return createAssetImage(m_context, m_format, m_name, getMipCount() - firstMip,
+			std::max<uint32_t>(m_width >> firstMip, 1), std::max<uint32_t>(m_height >> firstMip, 1), 1);
+	}
+
+	void GPUStreamingImageAsset::finishStreaming(std::unique_ptr<VulkanImage>&& image, uint32_t firstMip)
+	{
+		std::lock_guard lock(m_pendingLock);
+
+		m_pendingImage = std::move(image);
+		m_pendingMip = firstMip;
+	}
+
+	bool GPUStreamingImageAsset::applyStreaming(uint64_t tickCount)
+	{
+		std::unique_ptr<VulkanImage> image;
+		uint32_t firstMip;
+		{
+			std::lock_guard lock(m_pendingLock);
+			if (!m_pendingImage)
+			{
+				return false;
+			}
+
+			image = std::move(m_pendingImage);
+			firstMip = m_pendingMip;
+		}
+
+		// Same bindless index point to new image, frames in flight may still sample old one, so delay release.
+		m_context->getBindlessTexture().updateTextureAtBindlessIndex(m_bindlessIndex, image->getOrCreateView(buildBasicImageSubresource()));
+		pushGpuResourceAsPendingKill(std::shared_ptr<VulkanImage>(std::move(m_image)));
+
+		m_image = std::move(image);
+		m_residentMip = firstMip;
+		m_swapTick = tickCount;
+
+		m_bStreaming.store(false);
+		return true;
+	}
+
 	void RawAssetTextureLoadTask::uploadFunction(
 		uint32_t stageBufferOffset, 
 		void* bufferPtrStart, 
@@ -295,7 +384,8 @@ namespace engine
 		VkDeviceSize positionsSize, 
 		VkDeviceSize positionStripSize, 
 		VkDeviceSize indicesSize, 
-		VkDeviceSize indexStripSize)
+		VkDeviceSize indexStripSize,
+		VkDeviceSize meshletsSize)
 		: m_context(context), LRUAssetInterface(fallback)
 		, m_assetId(assetId)
 		, m_tangentsSize(tangentSize)
@@ -376,6 +466,18 @@ namespace engine
 		m_uv0sBindless = m_context->getBindlessSSBOs().updateBufferToBindlessDescriptorSet(m_uv0s->getVkBuffer(), 0, m_uv0Size);
 		m_indicesBindless = m_context->getBindlessSSBOs().updateBufferToBindlessDescriptorSet(m_indices->getVkBuffer(), 0, m_indicesSize);
 		m_positionBindless = m_context->getBindlessSSBOs().updateBufferToBindlessDescriptorSet(m_positions->getVkBuffer(), 0, m_positionsSize);
+
+		if (meshletsSize > 0)
+		{
+			m_meshlets = std::make_unique<VulkanBuffer>(
+				m_context,
+				getRuntimeUniqueGPUAssetName(name + "_meshlets"),
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VmaAllocationCreateFlags{},
+				meshletsSize
+			);
+			m_meshletsBindless = m_context->getBindlessSSBOs().updateBufferToBindlessDescriptorSet(m_meshlets->getVkBuffer(), 0, meshletsSize);
+		}
 	}
 
 	GPUStaticMeshAsset::~GPUStaticMeshAsset()
@@ -401,8 +503,15 @@ namespace engine
 			m_context->getBindlessSSBOs().freeBindlessImpl(m_positionBindless, m_context->isReleaseing() ? nullptr : m_context->getEngineStaticMeshBox()->getPosition());
 		}
 
+		if (m_meshletsBindless != ~0)
+		{
+			// Engine mesh no meshlets, just fallback to a valid buffer.
+			m_context->getBindlessSSBOs().freeBindlessImpl(m_meshletsBindless, m_context->isReleaseing() ? nullptr : m_context->getEngineStaticMeshBox()->getIndices());
+		}
+
 		m_indicesBindless = ~0;
 		m_tangentsBindless = ~0;
+		m_meshletsBindless = ~0;
 		m_uv0sBindless = ~0;
 		m_normalsBindless = ~0;
 		m_positionBindless = ~0;
@@ -412,6 +521,7 @@ namespace engine
 		m_normals.reset();
 		m_uv0s.reset();
 		m_positions.reset();
+		m_meshlets.reset();
 
 		m_blasBuilder.destroy();
 	}
@@ -26,6 +26,7 @@ namespace engine
 		virtual ~GPUImageAsset();
 
 		virtual size_t getSize() const override { return m_image->getSize(); }
+		virtual ELRUAssetType getLRUType() const override { return ELRUAssetType::Texture; }
 
 
 		// Prepare image layout when start to upload.
@@ -49,13 +50,92 @@ namespace engine
 		uint32_t m_bindlessIndex = ~0;
 	};
 
+	// Texture with per mip residency, only mips [residentMip, mipCount) own memory, mip tail always resident.
+	// Residency change upload mips into a new image on async uploader, then swap image at same bindless index,
+	// so material which cache bindless index no need rebuild.
+	class GPUStreamingImageAsset : public GPUImageAsset
+	{
+	public:
+		GPUStreamingImageAsset(
+			VulkanContext* context,
+			GPUImageAsset* fallback,
+			VkFormat format,
+			const std::string& name,
+			const UUID& assetUUID,
+			const std::filesystem::path& binPath,
+			std::vector<uint32_t>&& mipSizes,
+			uint32_t width,
+			uint32_t height,
+			uint32_t tailMip
+		);
+
+		const UUID& getAssetUUID() const { return m_assetUUID; }
+		const std::filesystem::path& getBinPath() const { return m_binPath; }
+
+		uint32_t getWidth() const { return m_width; }
+		uint32_t getHeight() const { return m_height; }
+		uint32_t getMipCount() const { return uint32_t(m_mipSizes.size()); }
+		uint32_t getMipSize(uint32_t level) const { return m_mipSizes[level]; }
+
+		// Mip tail [tailMip, mipCount) never evict.
+		uint32_t getTailMip() const { return m_tailMip; }
+		uint32_t getResidentMip() const { return m_residentMip; }
+
+		// Data size when mips [firstMip, mipCount) resident.
+		size_t getResidentSize(uint32_t firstMip) const;
+
+		// Create device image for mips [firstMip, mipCount).
+		std::unique_ptr<VulkanImage> createMipImage(uint32_t firstMip) const;
+
+		// Only one streaming task in flight per texture.
+		bool isStreaming() const { return m_bStreaming.load(); }
+		void beginStreaming() { m_bStreaming.store(true); }
+		void cancelStreaming() { m_bStreaming.store(false); }
+
+		// Call in uploader thread when streaming task finish.
+		void finishStreaming(std::unique_ptr<VulkanImage>&& image, uint32_t firstMip);
+
+		// Call in main thread, swap finished image, return true if swap happen.
+		bool applyStreaming(uint64_t tickCount);
+
+		// Tick of last swap, feedback of frames in flight still sample old image.
+		uint64_t getSwapTick() const { return m_swapTick; }
+
+	private:
+		std::string m_name;
+		VkFormat m_format;
+
+		UUID m_assetUUID;
+		std::filesystem::path m_binPath;
+
+		// Full mip chain info.
+		std::vector<uint32_t> m_mipSizes;
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_tailMip;
+
+		uint32_t m_residentMip;
+		uint64_t m_swapTick = 0;
+
+		std::atomic<bool> m_bStreaming = false;
+
+		// Finished image wait main thread swap.
+		std::mutex m_pendingLock;
+		std::unique_ptr<VulkanImage> m_pendingImage = nullptr;
+		uint32_t m_pendingMip = 0;
+	};
+
 	struct AssetTextureLoadTask : public AssetLoadTask
 	{
 		AssetTextureLoadTask() = default;
 
 		// Working image.
 		std::shared_ptr<GPUImageAsset> imageAssetGPU = nullptr;
-		virtual void finishCallback() override final { imageAssetGPU->setAsyncLoadState(false); }
+
+		// Upload fail keep async loading state, so always use fallback.
+		bool bUploadFailed = false;
+
+		virtual void finishCallback() override final { if (!bUploadFailed) { imageAssetGPU->setAsyncLoadState(false); } }
 		virtual uint32_t uploadSize() const override { return uint32_t(imageAssetGPU->getSize()); }
 	};
 
@@ -125,7 +205,8 @@ namespace engine
 			VkDeviceSize positionsSize,
 			VkDeviceSize positionStripSize,
 			VkDeviceSize indicesSize,
-			VkDeviceSize indexStripSize
+			VkDeviceSize indexStripSize,
+			VkDeviceSize meshletsSize = 0
 		);
 
 		virtual ~GPUStaticMeshAsset();
@@ -137,8 +218,10 @@ namespace engine
 				m_positions->getSize() +
 				m_tangents->getSize() +
 				m_normals->getSize() +
-				m_uv0s->getSize();
+				m_uv0s->getSize() +
+				(m_meshlets ? m_meshlets->getSize() : 0);
 		}
+		virtual ELRUAssetType getLRUType() const override { return ELRUAssetType::StaticMesh; }
 
 		const auto* getIndices()   const { return m_indices.get(); }
 		const auto* getTangents() const { return m_tangents.get(); }
@@ -151,6 +234,7 @@ namespace engine
 		auto* getNormals() { return m_normals.get(); }
 		auto* getUv0s() { return m_uv0s.get(); }
 		auto* getPosition()  { return m_positions.get(); }
+		auto* getMeshlets() { return m_meshlets.get(); }
 
 		const auto& getIndicesBindless()  const { return m_indicesBindless; }
 		const auto& getTangentsBindless() const { return m_tangentsBindless; }
@@ -158,6 +242,9 @@ namespace engine
 		const auto& getUv0sBindless() const { return m_uv0sBindless; }
 		const auto& getPositionBindless() const { return m_positionBindless; }
 
+		// ~0 when mesh no meshlets, e.g. engine mesh or asset import before meshlet build.
+		const auto& getMeshletsBindless() const { return m_meshletsBindless; }
+
 		const auto getVerticesCount() const { return m_positionsSize / m_positionStripSize; }
 		const auto getIndicesCount() const { return m_indicesSize / m_indexStripSize; }
 
@@ -184,6 +271,10 @@ namespace engine
 		std::unique_ptr<VulkanBuffer> m_positions = nullptr;
 		uint32_t m_positionBindless = ~0;
 
+		// Meshlets buffer for cluster culling.
+		std::unique_ptr<VulkanBuffer> m_meshlets = nullptr;
+		uint32_t m_meshletsBindless = ~0;
+
 		VkDeviceSize m_tangentsSize;
 		VkDeviceSize m_tangentStripSize;
 		VkDeviceSize m_normalSize;
@@ -210,8 +301,11 @@ namespace engine
 		// Working static mesh.
 		std::shared_ptr<GPUStaticMeshAsset> meshAssetGPU = nullptr;
 
+		// Upload fail keep async loading state, so always use fallback.
+		bool bUploadFailed = false;
+
 		virtual uint32_t uploadSize() const override final { return uint32_t(meshAssetGPU->getSize()); }
-		virtual void finishCallback() override final { meshAssetGPU->setAsyncLoadState(false); }
+		virtual void finishCallback() override final { if (!bUploadFailed) { meshAssetGPU->setAsyncLoadState(false); } }
 	};
 
 	struct AssetRawStaticMeshLoadTask : public AssetStaticMeshLoadTask
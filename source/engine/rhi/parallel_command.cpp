@@ -0,0 +1,173 @@
+#include "parallel_command.h"
+#include "rhi.h"
+
+namespace engine
+{
+	static AutoCVarBool cVarParallelRecordEnable(
+		"r.ParallelRecord.Enable",
+		"Record heavy draw passes into secondary command buffers on worker threads.",
+		"ParallelRecord",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarParallelRecordMinItems(
+		"r.ParallelRecord.MinItemsPerChunk",
+		"Min draw items per secondary command buffer, too small chunk cost more than it save.",
+		"ParallelRecord",
+		4,
+		CVarFlags::ReadAndWrite
+	);
+
+	static size_t getMinItemsPerChunk(uint32_t minItemsPerChunk)
+	{
+		return minItemsPerChunk > 0 ? size_t(minItemsPerChunk) : (size_t)std::max(1, cVarParallelRecordMinItems.get());
+	}
+
+	static bool isStencilFormat(VkFormat format)
+	{
+		return format == VK_FORMAT_D16_UNORM_S8_UINT
+			|| format == VK_FORMAT_D24_UNORM_S8_UINT
+			|| format == VK_FORMAT_D32_SFLOAT_S8_UINT
+			|| format == VK_FORMAT_S8_UINT;
+	}
+
+	ParallelCommandRecorder::ParallelCommandRecorder(VulkanContext* context, uint32_t frameCount)
+		: m_context(context)
+	{
+		CHECK(frameCount > 0);
+
+		// Calling thread also record chunk when wait.
+		const uint32_t slotCount = ThreadPool::getDefault()->getThreadCount() + 1;
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = m_context->getGraphiscFamily();
+
+		m_frameSlots.resize(frameCount);
+		for (auto& slots : m_frameSlots)
+		{
+			slots.resize(slotCount);
+			for (auto& slot : slots)
+			{
+				RHICheck(vkCreateCommandPool(m_context->getDevice(), &poolInfo, nullptr, &slot.pool));
+			}
+		}
+	}
+
+	ParallelCommandRecorder::~ParallelCommandRecorder()
+	{
+		// Command buffers free with pool.
+		for (auto& slots : m_frameSlots)
+		{
+			for (auto& slot : slots)
+			{
+				vkDestroyCommandPool(m_context->getDevice(), slot.pool, nullptr);
+			}
+		}
+	}
+
+	void ParallelCommandRecorder::beginFrame()
+	{
+		m_frameIndex = m_context->getCurrentFrameIndex() % (uint32_t)m_frameSlots.size();
+		m_bFrameBegin = true;
+
+		for (auto& slot : m_frameSlots[m_frameIndex])
+		{
+			if (slot.usedCount > 0)
+			{
+				RHICheck(vkResetCommandPool(m_context->getDevice(), slot.pool, 0));
+				slot.usedCount = 0;
+			}
+		}
+	}
+
+	bool ParallelCommandRecorder::shouldRecordParallel(size_t itemCount, uint32_t minItemsPerChunk) const
+	{
+		const size_t minItems = getMinItemsPerChunk(minItemsPerChunk);
+		return m_bFrameBegin && cVarParallelRecordEnable.get() && (itemCount >= minItems * 2);
+	}
+
+	VkCommandBuffer ParallelCommandRecorder::acquireCommandBuffer(uint32_t slotId)
+	{
+		auto& slot = m_frameSlots[m_frameIndex][slotId];
+		if (slot.usedCount >= slot.cmds.size())
+		{
+			VkCommandBufferAllocateInfo info{};
+			info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			info.commandBufferCount = 1;
+			info.commandPool = slot.pool;
+			info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+			VkCommandBuffer newBuffer;
+			RHICheck(vkAllocateCommandBuffers(m_context->getDevice(), &info, &newBuffer));
+			slot.cmds.push_back(newBuffer);
+		}
+
+		VkCommandBuffer cmd = slot.cmds[slot.usedCount];
+		slot.usedCount++;
+
+		return cmd;
+	}
+
+	void ParallelCommandRecorder::record(VkCommandBuffer primary, const SecondaryRenderingInfo& info, size_t itemCount, const RecordFunc& func, uint32_t minItemsPerChunk)
+	{
+		CHECK(m_bFrameBegin);
+		if (itemCount == 0)
+		{
+			return;
+		}
+
+		// Chunk count no more than slot count, one chunk one slot.
+		const size_t minItems = getMinItemsPerChunk(minItemsPerChunk);
+		const size_t slotCount = m_frameSlots[m_frameIndex].size();
+		const size_t chunkCount = std::clamp((itemCount + minItems - 1) / minItems, size_t(1), slotCount);
+		const size_t chunkSize = (itemCount + chunkCount - 1) / chunkCount;
+
+		VkCommandBufferInheritanceRenderingInfo renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+		renderingInfo.colorAttachmentCount = (uint32_t)info.colorFormats.size();
+		renderingInfo.pColorAttachmentFormats = info.colorFormats.empty() ? nullptr : info.colorFormats.data();
+		renderingInfo.depthAttachmentFormat = info.depthFormat;
+		renderingInfo.stencilAttachmentFormat = isStencilFormat(info.depthFormat) ? info.depthFormat : VK_FORMAT_UNDEFINED;
+		renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.pNext = &renderingInfo;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		std::vector<VkCommandBuffer> secondaryCmds(chunkCount, VK_NULL_HANDLE);
+		ThreadPool::getDefault()->parallelFor(size_t(0), chunkCount, [&](const size_t chunkStart, const size_t chunkEnd)
+		{
+			for (size_t chunkId = chunkStart; chunkId < chunkEnd; chunkId++)
+			{
+				const size_t start = chunkId * chunkSize;
+				const size_t end = std::min(start + chunkSize, itemCount);
+
+				VkCommandBuffer cmd = acquireCommandBuffer((uint32_t)chunkId);
+				RHICheck(vkBeginCommandBuffer(cmd, &beginInfo));
+				{
+					vkCmdSetScissor(cmd, 0, 1, &info.scissor);
+					vkCmdSetViewport(cmd, 0, 1, &info.viewport);
+					vkCmdSetDepthBias(cmd, 0, 0, 0);
+
+					if (start < end)
+					{
+						func(cmd, start, end);
+					}
+				}
+				RHICheck(vkEndCommandBuffer(cmd));
+
+				secondaryCmds[chunkId] = cmd;
+			}
+		}, 1);
+
+		vkCmdExecuteCommands(primary, (uint32_t)secondaryCmds.size(), secondaryCmds.data());
+	}
+}
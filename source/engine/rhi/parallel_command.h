@@ -0,0 +1,61 @@
+#pragma once
+#include "rhi_misc.h"
+
+#include <functional>
+
+namespace engine
+{
+	class VulkanContext;
+
+	// Render state secondary command buffer inherit from primary dynamic rendering scope.
+	struct SecondaryRenderingInfo
+	{
+		std::vector<VkFormat> colorFormats;
+		VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+		// Dynamic state no inherit, set again in each secondary command buffer.
+		VkViewport viewport;
+		VkRect2D scissor;
+	};
+
+	// Parallel record draw items into secondary command buffers on engine thread pool.
+	// Every record slot own one command pool per frame in flight, one chunk only use one slot,
+	// so worker threads never share pool. Secondary command buffers execute in chunk order by primary.
+	class ParallelCommandRecorder : NonCopyable
+	{
+	public:
+		using RecordFunc = std::function<void(VkCommandBuffer cmd, size_t start, size_t end)>;
+
+		explicit ParallelCommandRecorder(VulkanContext* context, uint32_t frameCount);
+		~ParallelCommandRecorder();
+
+		// Call after frame fence wait, reset all command pools of this frame.
+		void beginFrame();
+
+		// Cvar enable and item count enough to split at least two chunks.
+		// Min items per chunk 0 use r.ParallelRecord.MinItemsPerChunk, heavy item like whole shadow cascade can pass 1.
+		bool shouldRecordParallel(size_t itemCount, uint32_t minItemsPerChunk = 0) const;
+
+		// Primary must inside dynamic rendering begin with VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT.
+		// Func call on worker threads with item range, everything it touch must thread safe.
+		void record(VkCommandBuffer primary, const SecondaryRenderingInfo& info, size_t itemCount, const RecordFunc& func, uint32_t minItemsPerChunk = 0);
+
+	private:
+		struct SlotPool
+		{
+			VkCommandPool pool = VK_NULL_HANDLE;
+			std::vector<VkCommandBuffer> cmds;
+			uint32_t usedCount = 0;
+		};
+
+		VkCommandBuffer acquireCommandBuffer(uint32_t slot);
+
+	private:
+		VulkanContext* m_context;
+
+		// Index by frame in flight and slot.
+		std::vector<std::vector<SlotPool>> m_frameSlots;
+		uint32_t m_frameIndex = 0;
+		bool m_bFrameBegin = false;
+	};
+}
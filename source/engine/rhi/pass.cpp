@@ -3,21 +3,93 @@
 
 namespace engine
 {
+	static AutoCVarBool cVarRHIParallelPassInit(
+		"r.RHI.ParallelPassInit",
+		"Create passes pipelines in parallel on worker threads or not.",
+		"RHI",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
 	PassCollector::PassCollector(VulkanContext* context)
 		: m_context(context)
 	{
 
 	}
 
+	std::vector<PassCollector::RegisteredPass>& PassCollector::getRegisteredPasses()
+	{
+		static std::vector<RegisteredPass> passes;
+		return passes;
+	}
+
+	void PassCollector::registerPass(const char* passName, PassFactory factory)
+	{
+		getRegisteredPasses().push_back({ passName, factory });
+	}
+
+	void PassCollector::initPasses(const std::vector<PassInterface*>& passes)
+	{
+		if (cVarRHIParallelPassInit.get() && passes.size() > 1)
+		{
+			// Layout cache, shader cache and pipeline cache are all thread safe, pass init only create pipelines.
+			ThreadPool::getDefault()->parallelFor(size_t(0), passes.size(), [&](size_t start, size_t end)
+			{
+				for (size_t i = start; i < end; i++)
+				{
+					passes[i]->init(m_context);
+				}
+			}, 1);
+		}
+		else
+		{
+			for (auto* pass : passes)
+			{
+				pass->init(m_context);
+			}
+		}
+
+		onPassesInited();
+	}
+
+	void PassCollector::onPassesInited()
+	{
+		m_context->getShaderCache().releaseRetiredModules();
+	}
+
+	void PassCollector::initAllRegisteredPasses()
+	{
+		// Create on current thread, so pass map no change when init in parallel.
+		std::vector<PassInterface*> newPasses;
+		for (const auto& registered : getRegisteredPasses())
+		{
+			auto& pass = m_passMap[registered.name];
+			if (!pass)
+			{
+				pass = registered.factory();
+				newPasses.push_back(pass.get());
+			}
+		}
+
+		const auto startTime = std::chrono::steady_clock::now();
+		initPasses(newPasses);
+
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+		LOG_RHI_INFO("Init {} passes cost {} ms.", newPasses.size(), duration.count());
+	}
+
 	void PassCollector::updateAllPasses()
 	{
 		m_context->waitDeviceIdle();
 
+		std::vector<PassInterface*> passes;
 		for (auto& pair : m_passMap)
 		{
 			pair.second->release();
-			pair.second->init(m_context);
+			passes.push_back(pair.second.get());
 		}
+
+		initPasses(passes);
 	}
 
 	PassCollector::~PassCollector()
@@ -58,7 +130,7 @@ namespace engine
 		computePipelineCreateInfo.layout = pipelineLayout;
 		computePipelineCreateInfo.flags = 0;
 		computePipelineCreateInfo.stage = shaderStageCI;
-		RHICheck(vkCreateComputePipelines(getContext()->getDevice(), nullptr, 1, &computePipelineCreateInfo, nullptr, &pipeline));
+		RHICheck(vkCreateComputePipelines(getContext()->getDevice(), getContext()->getPipelineCache(), 1, &computePipelineCreateInfo, nullptr, &pipeline));
 	}
 
     GraphicPipeResources::GraphicPipeResources(
@@ -163,7 +235,7 @@ namespace engine
             .pDynamicState = &deafultDynamicState,
             .layout = pipelineLayout,
         };
-        RHICheck(vkCreateGraphicsPipelines(getContext()->getDevice(), nullptr, 1, &pipelineCreateInfo, nullptr, &pipeline));
+        RHICheck(vkCreateGraphicsPipelines(getContext()->getDevice(), getContext()->getPipelineCache(), 1, &pipelineCreateInfo, nullptr, &pipeline));
     }
 
     PipeResource::~PipeResource()
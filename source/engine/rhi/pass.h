@@ -52,6 +52,7 @@ namespace engine
 				// Create and init if no exist.
 				m_passMap[passName] = std::make_unique<PassType>();
 				m_passMap[passName]->init(m_context);
+				onPassesInited();
 			}
 
 			return dynamic_cast<PassType*>(m_passMap[passName].get());
@@ -59,8 +60,42 @@ namespace engine
 
 		// Update all pass.
 		void updateAllPasses();
+
+		// Create and init all passes registered by REGISTER_PASS which no exist yet.
+		void initAllRegisteredPasses();
+
+		// Register pass factory, usually call from REGISTER_PASS static object.
+		using PassFactory = std::unique_ptr<PassInterface>(*)();
+		static void registerPass(const char* passName, PassFactory factory);
+
+	private:
+		struct RegisteredPass
+		{
+			const char* name;
+			PassFactory factory;
+		};
+		static std::vector<RegisteredPass>& getRegisteredPasses();
+
+		// Init passes, parallel on worker threads when r.RHI.ParallelPassInit enable.
+		void initPasses(const std::vector<PassInterface*>& passes);
+
+		// Call after pass init finish, release reloaded shader modules.
+		void onPassesInited();
 	};
 
+	template<typename PassType>
+	struct PassRegister
+	{
+		PassRegister()
+		{
+			static_assert(std::is_base_of_v<PassInterface, PassType>);
+			PassCollector::registerPass(typeid(PassType).name(), []() -> std::unique_ptr<PassInterface> { return std::make_unique<PassType>(); });
+		}
+	};
+
+	// Register pass type so it can create up front, pipelines of all registered passes can build in parallel.
+	#define REGISTER_PASS(PassType) static ::engine::PassRegister<PassType> PassType##Register;
+
 	class PipeResource : NonCopyable
 	{
 	public:
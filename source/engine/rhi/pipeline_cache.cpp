@@ -0,0 +1,194 @@
+#include "pipeline_cache.h"
+#include "rhi_log.h"
+#include "rhi.h"
+
+#include <util/cityhash/city.h>
+#include <filesystem>
+#include <fstream>
+
+namespace engine
+{
+    static AutoCVarBool cVarRHIPipelineCacheEnable(
+        "r.RHI.PipelineCacheEnable",
+        "Load and save pipeline cache from disk or not.",
+        "RHI",
+        true,
+        CVarFlags::ReadOnly
+    );
+
+    void PipelineCache::fillHeader(FileHeader& header) const
+    {
+        const auto& props = m_context->getPhysicalDeviceProperties();
+        const auto& idProps = m_context->getPhysicalDeviceIDProperties();
+
+        header = { };
+        header.magic = kMagic;
+        header.version = kVersion;
+        header.vendorID = props.vendorID;
+        header.deviceID = props.deviceID;
+        header.driverVersion = props.driverVersion;
+        memcpy(header.driverUUID, idProps.driverUUID, VK_UUID_SIZE);
+        memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+    }
+
+    std::vector<uint8_t> PipelineCache::loadFromDisk() const
+    {
+        std::vector<uint8_t> data { };
+        if (!std::filesystem::exists(m_savePath))
+        {
+            return data;
+        }
+
+        std::ifstream file(m_savePath, std::ios::binary);
+        if (!file.is_open())
+        {
+            LOG_RHI_WARN("Open pipeline cache file {} failed.", m_savePath);
+            return data;
+        }
+
+        FileHeader expectHeader;
+        fillHeader(expectHeader);
+
+        FileHeader header;
+        file.read((char*)&header, sizeof(header));
+        if (!file)
+        {
+            LOG_RHI_WARN("Pipeline cache file {} broken, skip.", m_savePath);
+            return data;
+        }
+
+        // Driver update or gpu switch will change uuid, old cache invalid.
+        const bool bMatch =
+            header.magic == expectHeader.magic &&
+            header.version == expectHeader.version &&
+            header.vendorID == expectHeader.vendorID &&
+            header.deviceID == expectHeader.deviceID &&
+            header.driverVersion == expectHeader.driverVersion &&
+            memcmp(header.driverUUID, expectHeader.driverUUID, VK_UUID_SIZE) == 0 &&
+            memcmp(header.pipelineCacheUUID, expectHeader.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        if (!bMatch)
+        {
+            LOG_RHI_INFO("Pipeline cache file {} mismatch with current device or driver, rebuild.", m_savePath);
+            return data;
+        }
+
+        data.resize(header.dataSize);
+        file.read((char*)data.data(), data.size());
+        if (!file || CityHash64((const char*)data.data(), data.size()) != header.dataHash)
+        {
+            LOG_RHI_WARN("Pipeline cache file {} data corrupted, rebuild.", m_savePath);
+            data.clear();
+            return data;
+        }
+
+        // Also validate vulkan own header, driver may reject it silently.
+        VkPipelineCacheHeaderVersionOne vkHeader;
+        if (data.size() < sizeof(vkHeader))
+        {
+            data.clear();
+            return data;
+        }
+        memcpy(&vkHeader, data.data(), sizeof(vkHeader));
+
+        const auto& props = m_context->getPhysicalDeviceProperties();
+        if (vkHeader.headerSize < sizeof(vkHeader) ||
+            vkHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            vkHeader.vendorID != props.vendorID ||
+            vkHeader.deviceID != props.deviceID ||
+            memcmp(vkHeader.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            LOG_RHI_INFO("Pipeline cache file {} vulkan header mismatch, rebuild.", m_savePath);
+            data.clear();
+        }
+
+        return data;
+    }
+
+    void PipelineCache::init(const VulkanContext* context)
+    {
+        m_context = context;
+
+        const auto& config = Framework::get()->getConfig();
+        m_savePath = config.configFolder + "/" + config.appName + "-pipeline.cache";
+
+        std::vector<uint8_t> initData { };
+        if (cVarRHIPipelineCacheEnable.get())
+        {
+            initData = loadFromDisk();
+        }
+
+        VkPipelineCacheCreateInfo ci { .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+        ci.initialDataSize = initData.size();
+        ci.pInitialData = initData.empty() ? nullptr : initData.data();
+
+        if (vkCreatePipelineCache(m_context->getDevice(), &ci, nullptr, &m_cache) != VK_SUCCESS)
+        {
+            // Fallback to empty cache when driver reject the data.
+            LOG_RHI_WARN("Create pipeline cache with disk data failed, fallback to empty cache.");
+            ci.initialDataSize = 0;
+            ci.pInitialData = nullptr;
+            RHICheck(vkCreatePipelineCache(m_context->getDevice(), &ci, nullptr, &m_cache));
+        }
+
+        if (!initData.empty())
+        {
+            LOG_RHI_INFO("Load pipeline cache {} with {} bytes.", m_savePath, initData.size());
+        }
+    }
+
+    void PipelineCache::save()
+    {
+        if (m_cache == VK_NULL_HANDLE || !cVarRHIPipelineCacheEnable.get())
+        {
+            return;
+        }
+
+        size_t dataSize = 0;
+        RHICheck(vkGetPipelineCacheData(m_context->getDevice(), m_cache, &dataSize, nullptr));
+        if (dataSize == 0)
+        {
+            return;
+        }
+
+        std::vector<uint8_t> data(dataSize);
+        RHICheck(vkGetPipelineCacheData(m_context->getDevice(), m_cache, &dataSize, data.data()));
+        data.resize(dataSize);
+
+        FileHeader header;
+        fillHeader(header);
+        header.dataSize = dataSize;
+        header.dataHash = CityHash64((const char*)data.data(), data.size());
+
+        // Write to temp file first, avoid broken cache when crash in the middle.
+        const std::string tempPath = m_savePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                LOG_RHI_WARN("Save pipeline cache file {} failed.", tempPath);
+                return;
+            }
+
+            file.write((const char*)&header, sizeof(header));
+            file.write((const char*)data.data(), data.size());
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, m_savePath, ec);
+        if (ec)
+        {
+            LOG_RHI_WARN("Rename pipeline cache file {} failed: {}.", m_savePath, ec.message());
+        }
+    }
+
+    void PipelineCache::release()
+    {
+        save();
+
+        if (m_cache != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineCache(m_context->getDevice(), m_cache, nullptr);
+            m_cache = VK_NULL_HANDLE;
+        }
+    }
+}
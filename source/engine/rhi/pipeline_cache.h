@@ -0,0 +1,53 @@
+#pragma once
+
+#include <util/framework.h>
+#include <util/util.h>
+#include <vulkan/vulkan.h>
+
+namespace engine
+{
+	class VulkanContext;
+
+	// Engine wide VkPipelineCache, load from disk when init and save back when release.
+	// Vulkan pipeline cache is internal synchronized, so it can share by pipeline create on any thread.
+	class PipelineCache final : NonCopyable
+	{
+	public:
+		void init(const VulkanContext* context);
+		void release();
+
+		// Save current cache data to disk, safe to call multiple times.
+		void save();
+
+		VkPipelineCache get() const { return m_cache; }
+
+	private:
+		// Prefix header write before vulkan cache data, used to reject stale or broken cache file.
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t vendorID;
+			uint32_t deviceID;
+			uint32_t driverVersion;
+			uint8_t  driverUUID[VK_UUID_SIZE];
+			uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+			uint64_t dataSize;
+			uint64_t dataHash;
+		};
+
+		static constexpr uint32_t kMagic = 0x43504C46; // 'FLPC'
+		static constexpr uint32_t kVersion = 1;
+
+		void fillHeader(FileHeader& header) const;
+
+		// Return valid vulkan cache data load from disk, empty if no exist or mismatch.
+		std::vector<uint8_t> loadFromDisk() const;
+
+	private:
+		const VulkanContext* m_context = nullptr;
+		VkPipelineCache m_cache = VK_NULL_HANDLE;
+
+		std::string m_savePath;
+	};
+}
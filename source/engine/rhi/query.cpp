@@ -35,6 +35,11 @@ namespace engine
     void GPUTimestamps::getTimeStamp(VkCommandBuffer cmd, const char* label)
     {
         uint32_t measurements = (uint32_t)m_labels[m_frame].size();
+        if (measurements >= m_maxValuesPerFrame)
+        {
+            LOG_WARN_ONCE("GPU timestamps reach max values per frame, later timestamps skip.");
+            return;
+        }
         uint32_t offset = m_frame * m_maxValuesPerFrame + measurements;
 
         vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset);
@@ -83,8 +88,21 @@ namespace engine
 
                 if (res == VK_SUCCESS)
                 {
+                    // GPU events offset from frame anchor, record when this frame begin.
+                    const uint64_t anchorNs = m_profilerAnchorNs[m_frame];
+                    const bool bPushProfiler = (anchorNs != 0) && Profiler::get()->isEnable();
+                    const double nanosecondsPerTick = m_context->getPhysicalDeviceProperties().limits.timestampPeriod;
+
                     for (uint32_t i = 1; i < measurements; i++)
                     {
+                        if (bPushProfiler)
+                        {
+                            Profiler::get()->pushGPUEvent(
+                                m_labels[m_frame][i],
+                                anchorNs + uint64_t(nanosecondsPerTick * double(timingsInTicks[i - 1] - timingsInTicks[0])),
+                                anchorNs + uint64_t(nanosecondsPerTick * double(timingsInTicks[i] - timingsInTicks[0])));
+                        }
+
                         TimeStamp ts =
                         {
                             m_labels[m_frame][i],
@@ -117,6 +135,7 @@ namespace engine
         gpuLabels.clear();
 
         getTimeStamp(cmd, "Begin Frame");
+        m_profilerAnchorNs[m_frame] = Profiler::nowNs();
     }
 
     void GPUTimestamps::onEndFrame()
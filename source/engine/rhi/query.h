@@ -38,5 +38,8 @@ namespace engine
 
         std::vector<std::string> m_labels[5];
         std::vector<TimeStamp> m_cpuTimeStamps[5];
+
+        // Profiler time when first timestamp record, gpu ticks offset from it to join cpu timeline.
+        uint64_t m_profilerAnchorNs[5] = { };
     };
 }
\ No newline at end of file
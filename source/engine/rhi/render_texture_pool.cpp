@@ -6,6 +6,35 @@ namespace engine
 {
 	constexpr size_t kCheckMaxElementNum = 999;
 
+	// Device local memory block, transient images bind at different offset and alias each other.
+	class TransientAliasHeap : public GpuResource
+	{
+	public:
+		explicit TransientAliasHeap(const VulkanContext* context, const VkMemoryRequirements& requirements, uint64_t id)
+			: m_id(id)
+		{
+			GpuResource::init(context, "TransientAliasHeap", requirements.size);
+
+			VmaAllocationCreateInfo allocCreateInfo = {};
+			allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+			allocCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+			RHICheck(vmaAllocateMemory(m_context->getVMA(), &requirements, &allocCreateInfo, &m_allocation, nullptr));
+		}
+
+		virtual ~TransientAliasHeap()
+		{
+			vmaFreeMemory(m_context->getVMA(), m_allocation);
+		}
+
+		VmaAllocation getAllocation() const { return m_allocation; }
+		uint64_t getId() const { return m_id; }
+
+	private:
+		VmaAllocation m_allocation = nullptr;
+		uint64_t m_id;
+	};
+
 	bool RenderTexturePool::PoolImage::isValid()
 	{
 		return
@@ -28,7 +57,11 @@ namespace engine
 			return;
 		}
 
-		m_pool->releasePoolImage(*this);
+		// Transient image lifetime managed by alias cache.
+		if (!m_bTransient)
+		{
+			m_pool->releasePoolImage(*this);
+		}
 
 		// Set state to unvalid.
 		m_hashId = ~0;
@@ -45,8 +78,7 @@ namespace engine
 
 	}
 
-	PoolImageSharedRef RenderTexturePool::createPoolImage(
-		const char* name,
+	VkImageCreateInfo RenderTexturePool::buildImageCreateInfo(
 		uint32_t width,
 		uint32_t height,
 		VkFormat format,
@@ -80,6 +112,22 @@ namespace engine
 		info.pQueueFamilyIndices = nullptr;
 		info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+		return info;
+	}
+
+	PoolImageSharedRef RenderTexturePool::createPoolImage(
+		const char* name,
+		uint32_t width,
+		uint32_t height,
+		VkFormat format,
+		VkImageUsageFlags usage,
+		int32_t mipmapCount,
+		uint32_t depth,
+		uint32_t arrayLayers,
+		VkSampleCountFlagBits sampleCount,
+		VkImageCreateFlags flags)
+	{
+		VkImageCreateInfo info = buildImageCreateInfo(width, height, format, usage, mipmapCount, depth, arrayLayers, sampleCount, flags);
 		return createPoolImage(name, info);
 	}
 
@@ -146,6 +194,135 @@ namespace engine
 		return result;
 	}
 
+	PoolImageSharedRef RenderTexturePool::createTransientImage()
+	{
+		PoolImageSharedRef result = std::shared_ptr<PoolImageRef>(new PoolImageRef());
+		result->m_image.m_pool = this;
+		result->m_image.m_bTransient = true;
+
+		return result;
+	}
+
+	void RenderTexturePool::bindTransientImages(const std::vector<TransientImageRequest>& requests)
+	{
+		struct Placement
+		{
+			size_t requestId;
+			VkMemoryRequirements memReq;
+			VkDeviceSize offset = 0;
+		};
+
+		// Group by memory type bits, depth and color may require different memory type on some device.
+		std::unordered_map<uint32_t, std::vector<Placement>> groups;
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			VkDeviceImageMemoryRequirements info{ VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS };
+			info.pCreateInfo = &requests[i].createInfo;
+
+			VkMemoryRequirements2 memReq{ VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+			vkGetDeviceImageMemoryRequirements(m_context->getDevice(), &info, &memReq);
+
+			groups[memReq.memoryRequirements.memoryTypeBits].push_back({ i, memReq.memoryRequirements });
+		}
+
+		for (auto& [memoryTypeBits, placements] : groups)
+		{
+			// Big first, small images fill gaps.
+			std::stable_sort(placements.begin(), placements.end(), [](const auto& a, const auto& b)
+			{
+				return a.memReq.size > b.memReq.size;
+			});
+
+			VkDeviceSize heapSize = 0;
+			VkDeviceSize heapAlignment = 1;
+			std::vector<std::pair<VkDeviceSize, VkDeviceSize>> busyRanges;
+			for (size_t i = 0; i < placements.size(); i++)
+			{
+				auto& placement = placements[i];
+				const auto& request = requests[placement.requestId];
+
+				// Memory range of placed images which lifetime overlap.
+				busyRanges.clear();
+				for (size_t j = 0; j < i; j++)
+				{
+					const auto& placed = requests[placements[j].requestId];
+					if (placed.firstUse <= request.lastUse && request.firstUse <= placed.lastUse)
+					{
+						busyRanges.push_back({ placements[j].offset, placements[j].offset + placements[j].memReq.size });
+					}
+				}
+				std::sort(busyRanges.begin(), busyRanges.end());
+
+				// First fit.
+				const VkDeviceSize alignment = placement.memReq.alignment;
+				VkDeviceSize offset = 0;
+				for (const auto& range : busyRanges)
+				{
+					if (offset + placement.memReq.size <= range.first)
+					{
+						break;
+					}
+					offset = std::max(offset, (range.second + alignment - 1) / alignment * alignment);
+				}
+
+				placement.offset = offset;
+				heapSize = std::max(heapSize, offset + placement.memReq.size);
+				heapAlignment = std::max(heapAlignment, alignment);
+			}
+
+			// Grow heap when no enough, old heap and images delay destroy until gpu no use.
+			auto& heap = m_transientHeaps[memoryTypeBits];
+			if (heap == nullptr || heap->getSize() < heapSize)
+			{
+				if (heap != nullptr)
+				{
+					const uint64_t oldHeapId = heap->getId();
+					std::erase_if(m_transientImages, [&](const auto& pair)
+					{
+						if (pair.second.heapId == oldHeapId)
+						{
+							m_context->pushGpuResourceAsPendingKill(pair.second.image);
+							return true;
+						}
+						return false;
+					});
+					m_context->pushGpuResourceAsPendingKill(heap);
+				}
+
+				VkMemoryRequirements heapReq{ };
+				heapReq.size = heapSize;
+				heapReq.alignment = heapAlignment;
+				heapReq.memoryTypeBits = memoryTypeBits;
+
+				heap = std::make_shared<TransientAliasHeap>(m_context, heapReq, m_idAccumulator);
+				m_idAccumulator++;
+			}
+
+			for (const auto& placement : placements)
+			{
+				const auto& request = requests[placement.requestId];
+				const uint64_t createInfoHash = CityHash64((const char*)&request.createInfo, sizeof(request.createInfo));
+
+				const uint64_t key[3] = { createInfoHash, heap->getId(), placement.offset };
+				auto& cache = m_transientImages[CityHash64((const char*)key, sizeof(key))];
+				if (cache.image == nullptr)
+				{
+					cache.image = std::make_shared<VulkanImage>(m_context, request.name, request.createInfo, heap->getAllocation(), placement.offset);
+					cache.heapId = heap->getId();
+				}
+				cache.lastUsedCounter = m_innerCounter;
+
+				PoolImage& poolImage = request.ref->m_image;
+				CHECK(poolImage.m_bTransient);
+				poolImage.m_hashId = createInfoHash;
+				poolImage.m_id = m_idAccumulator;
+				poolImage.m_image = cache.image;
+
+				m_idAccumulator++;
+			}
+		}
+	}
+
 	bool RenderTexturePool::shouldRelease(uint64_t freeCounter)
 	{
 		return m_innerCounter > freeCounter + m_context->getSwapchain().getBackbufferCount();
@@ -157,6 +334,12 @@ namespace engine
 		CHECK(in.m_hashId != ~0);
 		CHECK(in.m_image.lock());
 
+		if (m_deferReleaseDepth > 0)
+		{
+			m_deferredReleases.push_back(in);
+			return;
+		}
+
 		auto& busyArray = m_busyImages[in.m_hashId];
 
 		// Safe check.
@@ -194,6 +377,40 @@ namespace engine
 		m_bRecentRelease = true;
 	}
 
+	void RenderTexturePool::beginDeferRelease()
+	{
+		m_deferReleaseDepth++;
+	}
+
+	void RenderTexturePool::endDeferRelease()
+	{
+		CHECK(m_deferReleaseDepth > 0);
+		m_deferReleaseDepth--;
+		if (m_deferReleaseDepth > 0)
+		{
+			return;
+		}
+
+		auto releases = std::move(m_deferredReleases);
+		m_deferredReleases.clear();
+
+		for (const auto& in : releases)
+		{
+			// Content no used anymore, discard state so next user no need queue family transfer.
+			const VkImageSubresourceRange wholeRange
+			{
+				.aspectMask = VK_IMAGE_ASPECT_NONE,
+				.baseMipLevel = 0,
+				.levelCount = VK_REMAINING_MIP_LEVELS,
+				.baseArrayLayer = 0,
+				.layerCount = VK_REMAINING_ARRAY_LAYERS,
+			};
+			in.m_image.lock()->setCurrentLayout(VK_IMAGE_LAYOUT_UNDEFINED, wholeRange, VK_QUEUE_FAMILY_IGNORED);
+
+			releasePoolImage(in);
+		}
+	}
+
 	void RenderTexturePool::tick()
 	{
 		// Tick find free render texture which can release, tick per five frame.
@@ -228,6 +445,12 @@ namespace engine
 			}
 		}
 
+		// Release aliased images which no used recently, heap keep.
+		if (m_innerCounter % 5 == 0)
+		{
+			std::erase_if(m_transientImages, [this](const auto& pair){ return shouldRelease(pair.second.lastUsedCounter); });
+		}
+
 		// Busy image map shrink, tick per 11 frame.
 		if (m_innerCounter % 11 == 0)
 		{
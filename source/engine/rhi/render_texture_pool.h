@@ -7,6 +7,8 @@ namespace engine
 {
 	constexpr int32_t kRenderTextureFullMip = -1;
 
+	class TransientAliasHeap;
+
 	// Render texture pool can reused texture in one frame.
 	class RenderTexturePool : NonCopyable
 	{
@@ -30,6 +32,9 @@ namespace engine
 			// Pool reference.
 			RenderTexturePool* m_pool = nullptr;
 
+			// Transient image memory alias with others, no busy or free state, bind when render graph compile.
+			bool m_bTransient = false;
+
 		public:
 			PoolImage() = default;
 			PoolImage(RenderTexturePool* inPool) : m_pool(inPool) { }
@@ -109,9 +114,38 @@ namespace engine
 		// Release pool image.
 		void releasePoolImage(const PoolImage& in);
 
+		// Alias heap of transient images, key is memory type bits, only grow.
+		std::unordered_map<uint32_t, std::shared_ptr<TransientAliasHeap>> m_transientHeaps;
+
+		struct TransientImageCache
+		{
+			std::shared_ptr<VulkanImage> image = nullptr;
+			uint64_t heapId = ~0;
+			uint64_t lastUsedCounter = 0;
+		};
+
+		// Aliased images keep cache by create info, heap and offset, avoid recreate image handle each frame.
+		std::unordered_map<uint64_t, TransientImageCache> m_transientImages;
+
+		// Release inside defer scope keep busy until scope end, image may still use by other queue.
+		uint32_t m_deferReleaseDepth = 0;
+		std::vector<PoolImage> m_deferredReleases;
+
 	public:
 		explicit RenderTexturePool(class VulkanContext* context);
 
+		static VkImageCreateInfo buildImageCreateInfo(
+			uint32_t width,
+			uint32_t height,
+			VkFormat format,
+			VkImageUsageFlags usage,
+			int32_t mipmapCount = 1,
+			uint32_t depth = 1,
+			uint32_t arrayLayers = 1,
+			VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT,
+			VkImageCreateFlags flags = 0
+		);
+
 		// 2D wrapper of pool image create.
 		std::shared_ptr<PoolImageRef> createPoolImage(
 			const char* name,
@@ -143,6 +177,28 @@ namespace engine
 			const VkImageCreateInfo& createInfo
 		);
 
+		// Transient image without memory, render graph place it in alias heap and bind before use.
+		std::shared_ptr<PoolImageRef> createTransientImage();
+
+		struct TransientImageRequest
+		{
+			std::shared_ptr<PoolImageRef> ref;
+			std::string name;
+			VkImageCreateInfo createInfo;
+
+			// Lifetime in render graph pass order, inclusive.
+			uint32_t firstUse;
+			uint32_t lastUse;
+		};
+
+		// Images which lifetime no overlap share memory, bind all transient images of this frame.
+		void bindTransientImages(const std::vector<TransientImageRequest>& requests);
+
+		// Pool image release between begin and end no reuse until end, then content discard.
+		// Used when record work of multi queues, reuse in later recorded command may run concurrently with previous user.
+		void beginDeferRelease();
+		void endDeferRelease();
+
 		// Tick update pool resource state.
 		void tick();
 	};
@@ -168,14 +168,7 @@ namespace engine
 		GpuResource::init(context, name, memRequirements.size);
 
 		// Init some subresources.
-		size_t subresourceNum = m_createInfo.arrayLayers * m_createInfo.mipLevels;
-		m_layouts.resize(subresourceNum);
-		m_ownerQueueFamilyIndices.resize(subresourceNum);
-		for (size_t i = 0; i < m_layouts.size(); i++)
-		{
-			m_layouts[i] = VK_IMAGE_LAYOUT_UNDEFINED;
-			m_ownerQueueFamilyIndices[i] = VK_QUEUE_FAMILY_IGNORED;
-		}
+		initSubresourceStates();
 
 		VmaAllocationCreateInfo imageAllocCreateInfo = {};
 		imageAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
@@ -188,11 +181,38 @@ namespace engine
 		m_context->setResourceName(VK_OBJECT_TYPE_IMAGE, (uint64_t)m_image, m_name.c_str());
 	}
 
+	VulkanImage::VulkanImage(
+		const VulkanContext* context,
+		const std::string& name,
+		const VkImageCreateInfo& createInfo,
+		VmaAllocation aliasMemory,
+		VkDeviceSize aliasOffset) : m_bMemoryAliased(true), m_createInfo(createInfo)
+	{
+		RHICheck(vkCreateImage(context->getDevice(), &m_createInfo, nullptr, &m_image));
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(context->getDevice(), m_image, &memRequirements);
+
+		GpuResource::init(context, name, memRequirements.size);
+		initSubresourceStates();
+
+		ASSERT(aliasOffset % memRequirements.alignment == 0, "Alias memory offset no match image alignment.");
+		RHICheck(vmaBindImageMemory2(m_context->getVMA(), aliasMemory, aliasOffset, m_image, nullptr));
+
+		m_context->setResourceName(VK_OBJECT_TYPE_IMAGE, (uint64_t)m_image, m_name.c_str());
+	}
+
 	VulkanImage::~VulkanImage()
 	{
 		if (m_image != VK_NULL_HANDLE)
 		{
-			vmaDestroyImage(m_context->getVMA(), m_image, m_allocation);
+			if (m_bMemoryAliased)
+			{
+				vkDestroyImage(m_context->getDevice(), m_image, nullptr);
+			}
+			else
+			{
+				vmaDestroyImage(m_context->getVMA(), m_image, m_allocation);
+			}
 			m_image = VK_NULL_HANDLE;
 		}
 
@@ -203,6 +223,18 @@ namespace engine
 		m_cacheImageViews.clear();
 	}
 
+	void VulkanImage::initSubresourceStates()
+	{
+		size_t subresourceNum = m_createInfo.arrayLayers * m_createInfo.mipLevels;
+		m_layouts.resize(subresourceNum);
+		m_ownerQueueFamilyIndices.resize(subresourceNum);
+		for (size_t i = 0; i < m_layouts.size(); i++)
+		{
+			m_layouts[i] = VK_IMAGE_LAYOUT_UNDEFINED;
+			m_ownerQueueFamilyIndices[i] = VK_QUEUE_FAMILY_IGNORED;
+		}
+	}
+
 	size_t VulkanImage::getSubresourceIndex(uint32_t layerIndex, uint32_t mipLevel) const
 	{
 		CHECK((layerIndex < m_createInfo.arrayLayers) && (mipLevel < m_createInfo.mipLevels));
@@ -224,6 +256,8 @@ namespace engine
 		info.format = m_createInfo.format;
 		info.viewType = viewType;
 		uint64_t hashVal = CityHash64((const char*)&info, sizeof(VkImageViewCreateInfo));
+
+		std::lock_guard lock(m_cacheImageViewsLock);
 		if (!m_cacheImageViews.contains(hashVal))
 		{
 			m_cacheImageViews[hashVal] = VK_NULL_HANDLE;
@@ -382,7 +416,8 @@ namespace engine
 
 	void VulkanImage::transitionLayout(VkCommandBuffer cmd, VkImageLayout newLayout, VkImageSubresourceRange range)
 	{
-		transitionLayout(cmd, m_context->getGraphiscFamily(), newLayout, range);
+		// Pass may record on async compute segment.
+		transitionLayout(cmd, m_context->getCommandBufferQueueFamily(cmd), newLayout, range);
 	}
 
 	void VulkanImage::transitionLayoutImmediately(VkImageLayout newLayout, VkImageSubresourceRange range)
@@ -392,6 +427,25 @@ namespace engine
 			transitionLayout(cb, m_context->getGraphiscFamily(), newLayout, range);
 		});
 	}
+
+	void VulkanImage::setCurrentLayout(VkImageLayout newLayout, const VkImageSubresourceRange& range, uint32_t queueFamily)
+	{
+		const uint32_t maxLayer = (range.layerCount == VK_REMAINING_ARRAY_LAYERS)
+			? m_createInfo.arrayLayers
+			: glm::min(range.baseArrayLayer + range.layerCount, m_createInfo.arrayLayers);
+		const uint32_t maxMip = (range.levelCount == VK_REMAINING_MIP_LEVELS)
+			? m_createInfo.mipLevels
+			: glm::min(range.baseMipLevel + range.levelCount, m_createInfo.mipLevels);
+		for (uint32_t layerIndex = range.baseArrayLayer; layerIndex < maxLayer; layerIndex++)
+		{
+			for (uint32_t mipIndex = range.baseMipLevel; mipIndex < maxMip; mipIndex++)
+			{
+				const size_t flatId = getSubresourceIndex(layerIndex, mipIndex);
+				m_layouts[flatId] = newLayout;
+				m_ownerQueueFamilyIndices[flatId] = queueFamily;
+			}
+		}
+	}
 	void pushGpuResourceAsPendingKill(std::shared_ptr<GpuResource> s)
 	{
 		getContext()->pushGpuResourceAsPendingKill(s);
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 #include <cstdint>
 
 #include "rhi_misc.h"
@@ -135,10 +136,20 @@ namespace engine
 			const VkImageCreateInfo& createInfo,
 			VkMemoryPropertyFlags preperty = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
+		// Image bind to exist memory at offset, memory may alias with other images, owner of memory must outlive image.
+		explicit VulkanImage(
+			const VulkanContext* context,
+			const std::string& name,
+			const VkImageCreateInfo& createInfo,
+			VmaAllocation aliasMemory,
+			VkDeviceSize aliasOffset);
+
 		virtual ~VulkanImage();
 
 		VkImage getImage() const { return m_image; }
 
+		bool isMemoryAliased() const { return m_bMemoryAliased; }
+
 		VkFormat getFormat() const { return m_createInfo.format; }
 
 		VkExtent3D getExtent() const { return m_createInfo.extent; }
@@ -147,7 +158,7 @@ namespace engine
 
 		VkImageLayout getCurrentLayout(uint32_t layerIndex, uint32_t mipLevel) const;
 
-		// Try get view and create if no exist.
+		// Try get view and create if no exist, thread safe for parallel recording.
 		VkImageView getOrCreateView(
 			VkImageSubresourceRange range, VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D);
 
@@ -156,13 +167,18 @@ namespace engine
 
 		void transitionLayout(VkCommandBuffer cb, uint32_t cmdQueueFamily, VkImageLayout newLayout, VkImageSubresourceRange range);
 
-		// Use graphics queue family.
+		// Use queue family of command buffer, graphics family unless async compute segment.
 		void transitionLayout(VkCommandBuffer cmd, VkImageLayout newLayout, VkImageSubresourceRange range);
 
 		// Transition on major graphics.
 		void transitionLayoutImmediately(VkImageLayout newLayout, VkImageSubresourceRange range);
 
+		// Only update layout state, barrier record by caller (e.g. render graph batch barriers).
+		void setCurrentLayout(VkImageLayout newLayout, const VkImageSubresourceRange& range, uint32_t queueFamily);
+
 	protected:
+		void initSubresourceStates();
+
 		size_t getSubresourceIndex(uint32_t layerIndex, uint32_t mipLevel) const;
 
 	protected:
@@ -171,6 +187,9 @@ namespace engine
 
 		VmaAllocation m_allocation = nullptr;
 
+		// Memory owned by other, only destroy image handle.
+		bool m_bMemoryAliased = false;
+
 		// Cache image create info.
 		VkImageCreateInfo m_createInfo = {};
 
@@ -181,6 +200,7 @@ namespace engine
 		std::vector<VkImageLayout> m_layouts;
 
 		// Cache created image views.
+		std::mutex m_cacheImageViewsLock;
 		std::unordered_map<uint64_t, VkImageView> m_cacheImageViews{ };
 	};
 
@@ -119,7 +119,9 @@ namespace engine
 		VkRect2D scissor;
 		VkViewport viewport;
 
-		ScopeRenderCmdObject(VkCommandBuffer inCmd, const std::string& name, VulkanImage& rt, const std::vector<VkRenderingAttachmentInfo>& colorAttachments, const VkRenderingAttachmentInfo& depthAttachment)
+		// When flags contain VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT, primary only execute secondary command buffers,
+		// dynamic state set by secondary itself.
+		ScopeRenderCmdObject(VkCommandBuffer inCmd, const std::string& name, VulkanImage& rt, const std::vector<VkRenderingAttachmentInfo>& colorAttachments, const VkRenderingAttachmentInfo& depthAttachment, VkRenderingFlags flags = 0)
 			: cmd(inCmd)
 		{
 			frameMarker = std::make_unique<ScopePerframeMarker>(inCmd, name.c_str(), math::vec4{ 0.6f, 0.2f, 0.4f, 0.8f });
@@ -132,6 +134,7 @@ namespace engine
 			const VkRenderingInfo renderInfo
 			{
 				.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+				.flags = flags,
 				.renderArea = VkRect2D{.offset {0,0}, .extent { renderWidth, renderHeight}},
 				.layerCount = 1,
 				.colorAttachmentCount = uint32_t(colorAttachments.size()),
@@ -151,9 +154,12 @@ namespace engine
 			};
 
 			vkCmdBeginRendering(cmd, &renderInfo);
-			vkCmdSetScissor(cmd, 0, 1, &scissor);
-			vkCmdSetViewport(cmd, 0, 1, &viewport);
-			vkCmdSetDepthBias(cmd, 0, 0, 0);
+			if (!(flags & VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT))
+			{
+				vkCmdSetScissor(cmd, 0, 1, &scissor);
+				vkCmdSetViewport(cmd, 0, 1, &viewport);
+				vkCmdSetDepthBias(cmd, 0, 0, 0);
+			}
 		}
 
 		~ScopeRenderCmdObject()
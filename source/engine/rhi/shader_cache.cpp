@@ -40,10 +40,12 @@ namespace engine
     {
         CHECK(std::filesystem::exists(path));
 
+        std::lock_guard lock(m_mutex);
+
         const bool bExist = m_moduleCache.contains(path);
         if (bExist && bReload)
         {
-            releaseModule(m_moduleCache[path]);
+            m_retiredModules.push_back(m_moduleCache[path]);
         }
 
         const bool bLoad = (bReload) || (!bExist);
@@ -63,6 +65,8 @@ namespace engine
 
     void ShaderCache::release()
     {
+        releaseRetiredModules();
+
         for (auto& shaders : m_moduleCache)
         {
             releaseModule(shaders.second);
@@ -70,6 +74,16 @@ namespace engine
         m_moduleCache.clear();
     }
 
+    void ShaderCache::releaseRetiredModules()
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto shader : m_retiredModules)
+        {
+            releaseModule(shader);
+        }
+        m_retiredModules.clear();
+    }
+
     void ShaderCache::releaseModule(VkShaderModule shader)
     {
         vkDestroyShaderModule(m_context->getDevice(), shader, nullptr);
@@ -16,10 +16,20 @@ namespace engine
 		VkShaderModule getShader(const std::string& path, bool reload);
 		void release();
 
+		// Reloaded old modules may still used by pipeline creating on other threads,
+		// call this when no pipeline create in flight.
+		void releaseRetiredModules();
+
 	private:
 		const VulkanContext* m_context;
 		std::unordered_map<std::string, VkShaderModule> m_moduleCache;
 
+		// Modules replaced by reload, release after pipeline create finish.
+		std::vector<VkShaderModule> m_retiredModules;
+
+		// Pass may init on worker threads, guard module cache.
+		std::mutex m_mutex;
+
 		void releaseModule(VkShaderModule shader);
 	};
 }
\ No newline at end of file
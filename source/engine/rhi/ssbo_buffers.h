@@ -105,6 +105,18 @@ namespace engine
 				data);
 		}
 
+		// Host write stage buffer, used as copy source of gpu only buffer.
+		std::shared_ptr<BufferParameter> getStageUpload(const char* name, size_t bufferSize, void* data = nullptr)
+		{
+			return getParameter(
+				name,
+				bufferSize,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				VulkanBuffer::getStageCopyForUploadBufferFlags(),
+				data);
+		}
+
 		std::shared_ptr<BufferParameter> getStaticUniform(const char* name, size_t bufferSize, void* data = nullptr)
 		{
 			return getParameter(
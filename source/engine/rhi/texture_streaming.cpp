@@ -0,0 +1,392 @@
+#include "texture_streaming.h"
+#include "rhi.h"
+
+#include <asset/asset_texture.h>
+
+namespace engine
+{
+	static AutoCVarBool cVarTextureStreamingEnable(
+		"r.TextureStreaming.Enable",
+		"Enable texture mip streaming by sampled feedback, only affect texture load after change.",
+		"TextureStreaming",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingPoolSizeMB(
+		"r.TextureStreaming.PoolSizeMB",
+		"Texture streaming pool budget (MB), mip tail no count in.",
+		"TextureStreaming",
+		512,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingTailMaxSize(
+		"r.TextureStreaming.TailMaxSize",
+		"Max dimension of mip tail which always resident, texture no bigger than it no streaming.",
+		"TextureStreaming",
+		256,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingUnusedFrames(
+		"r.TextureStreaming.UnusedFrames",
+		"Texture no sampled after these frames can drop mips when pool oversize.",
+		"TextureStreaming",
+		60,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingMaxUploadMB(
+		"r.TextureStreaming.MaxUploadMBPerUpdate",
+		"Max streaming upload size (MB) issue per frame.",
+		"TextureStreaming",
+		32,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingStatPoolMB("r.TextureStreaming.Stat.PoolMB", "Streaming texture wanted resident size (MB).", "TextureStreaming", 0, CVarFlags::ReadOnly);
+	static AutoCVarInt32 cVarTextureStreamingStatBias("r.TextureStreaming.Stat.MipBias", "Mip bias apply on sampled textures because pool oversize.", "TextureStreaming", 0, CVarFlags::ReadOnly);
+	static AutoCVarInt32 cVarTextureStreamingStatCount("r.TextureStreaming.Stat.Count", "Streaming texture count.", "TextureStreaming", 0, CVarFlags::ReadOnly);
+
+	// Keep same with shared_texture_streaming.glsl, feedback store floor(lod) + offset, negative lod still valid.
+	constexpr uint32_t kFeedbackLodOffset = 16;
+	constexpr uint32_t kFeedbackInvalid = ~0;
+
+	TextureStreamingManager::TextureStreamingManager(VulkanContext* context, uint32_t frameCount)
+		: m_context(context)
+		, m_frameCount(frameCount)
+	{
+		m_feedbackCount = context->getBindlessTexture().getMaxCount();
+		const VkDeviceSize feedbackSize = sizeof(uint32_t) * m_feedbackCount;
+
+		m_feedback = std::make_unique<VulkanBuffer>(
+			context,
+			"TextureStreamingFeedback",
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VmaAllocationCreateFlags{},
+			feedbackSize);
+		m_feedbackBindless = context->getBindlessSSBOs().updateBufferToBindlessDescriptorSet(m_feedback->getVkBuffer(), 0, feedbackSize);
+
+		m_readbacks.resize(m_frameCount);
+		m_readbackValid.resize(m_frameCount, false);
+		for (uint32_t i = 0; i < m_frameCount; i++)
+		{
+			m_readbacks[i] = std::make_unique<VulkanBuffer>(
+				context,
+				"TextureStreamingReadback" + std::to_string(i),
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VulkanBuffer::getReadBackFlags(),
+				feedbackSize);
+		}
+	}
+
+	TextureStreamingManager::~TextureStreamingManager()
+	{
+		if (m_feedbackBindless != ~0)
+		{
+			m_context->getBindlessSSBOs().freeBindlessImpl(m_feedbackBindless, nullptr);
+		}
+
+		m_readbacks.clear();
+		m_feedback.reset();
+	}
+
+	bool TextureStreamingManager::isEnable() const
+	{
+		return cVarTextureStreamingEnable.get();
+	}
+
+	uint32_t TextureStreamingManager::getTailMip(uint32_t width, uint32_t height, uint32_t mipCount) const
+	{
+		if (!isEnable())
+		{
+			return 0;
+		}
+
+		const uint32_t tailMaxSize = std::max(1, cVarTextureStreamingTailMaxSize.get());
+
+		uint32_t tailMip = 0;
+		while (tailMip + 1 < mipCount && std::max(width >> tailMip, height >> tailMip) > tailMaxSize)
+		{
+			tailMip++;
+		}
+		return tailMip;
+	}
+
+	void TextureStreamingManager::registerTexture(std::shared_ptr<GPUStreamingImageAsset> asset)
+	{
+		Record record { };
+		record.asset = asset;
+		record.sampledMip = asset->getTailMip();
+		record.lastSampledTick = m_tickCount;
+
+		m_records.push_back(std::move(record));
+	}
+
+	uint32_t TextureStreamingManager::getFeedbackBindlessIndex() const
+	{
+		return isEnable() ? m_feedbackBindless : ~0;
+	}
+
+	void TextureStreamingManager::readbackFeedback()
+	{
+		const uint32_t frameIndex = m_context->getCurrentFrameIndex();
+		if (!m_readbackValid[frameIndex])
+		{
+			return;
+		}
+
+		// Frame fence already wait when acquire image, readback of this frame slot is finished.
+		auto& readback = m_readbacks[frameIndex];
+		readback->map();
+		readback->invalidate();
+		{
+			const uint32_t* feedback = (const uint32_t*)readback->getMapped();
+			for (auto& record : m_records)
+			{
+				auto asset = record.asset.lock();
+				if (!asset || !asset->isAssetReady())
+				{
+					continue;
+				}
+
+				// Feedback lod relative to image sampled in that frame, skip if image swap after it.
+				if (asset->getSwapTick() + m_frameCount >= m_tickCount && asset->getSwapTick() != 0)
+				{
+					continue;
+				}
+
+				const uint32_t bindlessIndex = asset->getBindlessIndex();
+				if (bindlessIndex >= m_feedbackCount || feedback[bindlessIndex] == kFeedbackInvalid)
+				{
+					continue;
+				}
+
+				const int32_t lod = int32_t(feedback[bindlessIndex]) - int32_t(kFeedbackLodOffset) + int32_t(asset->getResidentMip());
+				const uint32_t sampledMip = uint32_t(std::max(lod, 0));
+
+				// Keep min mip sampled in unused window, avoid mip ping-pong when camera move.
+				const bool bExpired = m_tickCount > record.lastSampledTick + uint64_t(std::max(cVarTextureStreamingUnusedFrames.get(), 1));
+				record.sampledMip = bExpired ? sampledMip : std::min(record.sampledMip, sampledMip);
+				record.lastSampledTick = m_tickCount;
+			}
+		}
+		readback->unmap();
+
+		m_readbackValid[frameIndex] = false;
+	}
+
+	void TextureStreamingManager::recordFeedback(VkCommandBuffer cmd)
+	{
+		if (m_bFeedbackRecorded || !isEnable())
+		{
+			return;
+		}
+		m_bFeedbackRecorded = true;
+
+		CPU_PROFILER_SCOPE("TextureStreamingManager::recordFeedback");
+
+		readbackFeedback();
+
+		const uint32_t frameIndex = m_context->getCurrentFrameIndex();
+		const VkDeviceSize feedbackSize = sizeof(uint32_t) * m_feedbackCount;
+
+		// Copy last frame feedback to readback, first frame buffer content is undefined so only clear.
+		if (m_bFeedbackCleared)
+		{
+			auto copyBarrier = RHIBufferBarrier(m_feedback->getVkBuffer(),
+				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+			RHIPipelineBarrier(cmd, 0, 1, &copyBarrier, 0, nullptr);
+
+			VkBufferCopy copyRegion = {};
+			copyRegion.size = feedbackSize;
+			vkCmdCopyBuffer(cmd, m_feedback->getVkBuffer(), m_readbacks[frameIndex]->getVkBuffer(), 1, &copyRegion);
+
+			auto readbackBarrier = RHIBufferBarrier(m_readbacks[frameIndex]->getVkBuffer(),
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT);
+			RHIPipelineBarrier(cmd, 0, 1, &readbackBarrier, 0, nullptr);
+
+			m_readbackValid[frameIndex] = true;
+		}
+
+		auto fillBarrier = RHIBufferBarrier(m_feedback->getVkBuffer(),
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &fillBarrier, 0, nullptr);
+
+		vkCmdFillBuffer(cmd, m_feedback->getVkBuffer(), 0, feedbackSize, kFeedbackInvalid);
+
+		auto writeBarrier = RHIBufferBarrier(m_feedback->getVkBuffer(),
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &writeBarrier, 0, nullptr);
+
+		m_bFeedbackCleared = true;
+	}
+
+	void TextureStreamingManager::tick()
+	{
+		CPU_PROFILER_SCOPE("TextureStreamingManager::tick");
+
+		m_tickCount++;
+		m_bFeedbackRecorded = false;
+
+		// Swap finished images, resident size change so update lru accounting.
+		std::erase_if(m_records, [&](Record& record)
+		{
+			auto asset = record.asset.lock();
+			if (!asset)
+			{
+				return true;
+			}
+
+			if (asset->applyStreaming(m_tickCount))
+			{
+				m_context->getLRU()->refreshSize(asset->getAssetUUID());
+			}
+			return false;
+		});
+
+		cVarTextureStreamingStatCount.set(int32_t(m_records.size()));
+		if (isEnable())
+		{
+			updateResidency();
+		}
+	}
+
+	void TextureStreamingManager::updateResidency()
+	{
+		struct Want
+		{
+			std::shared_ptr<GPUStreamingImageAsset> asset;
+			uint32_t wantMip;
+			uint64_t lastSampledTick;
+			bool bSampled;
+		};
+
+		const uint64_t unusedFrames = uint64_t(std::max(cVarTextureStreamingUnusedFrames.get(), 1));
+		const size_t poolSize = size_t(std::max(cVarTextureStreamingPoolSizeMB.get(), 0)) * 1024 * 1024;
+
+		std::vector<Want> wants;
+		wants.reserve(m_records.size());
+
+		size_t totalSize = 0;
+		for (const auto& record : m_records)
+		{
+			auto asset = record.asset.lock();
+			if (!asset || !asset->isAssetReady())
+			{
+				continue;
+			}
+
+			Want want { };
+			want.bSampled = (record.lastSampledTick + unusedFrames >= m_tickCount);
+			want.wantMip = want.bSampled ? std::min(record.sampledMip, asset->getTailMip()) : asset->getResidentMip();
+			want.lastSampledTick = record.lastSampledTick;
+
+			totalSize += asset->getResidentSize(want.wantMip) - asset->getResidentSize(asset->getTailMip());
+			want.asset = std::move(asset);
+
+			wants.push_back(std::move(want));
+		}
+
+		// Drop one mip of one texture each step, return false if nothing can drop.
+		auto dropOneMip = [&](Want& want)
+		{
+			if (want.wantMip >= want.asset->getTailMip())
+			{
+				return false;
+			}
+
+			totalSize -= want.asset->getMipSize(want.wantMip);
+			want.wantMip++;
+			return true;
+		};
+
+		// Oversize, first evict mips of textures unsampled for longest.
+		if (totalSize > poolSize)
+		{
+			std::vector<Want*> unsampled;
+			for (auto& want : wants)
+			{
+				if (!want.bSampled)
+				{
+					unsampled.push_back(&want);
+				}
+			}
+			std::sort(unsampled.begin(), unsampled.end(), [](const Want* a, const Want* b) { return a->lastSampledTick < b->lastSampledTick; });
+
+			for (auto* want : unsampled)
+			{
+				while (totalSize > poolSize && dropOneMip(*want)) { }
+
+				if (totalSize <= poolSize)
+				{
+					break;
+				}
+			}
+		}
+
+		// Still oversize, bias all sampled textures one mip each round.
+		int32_t mipBias = 0;
+		while (totalSize > poolSize)
+		{
+			bool bDropAny = false;
+			for (auto& want : wants)
+			{
+				if (want.bSampled && dropOneMip(want))
+				{
+					bDropAny = true;
+					if (totalSize <= poolSize)
+					{
+						break;
+					}
+				}
+			}
+
+			if (!bDropAny)
+			{
+				break;
+			}
+			mipBias++;
+		}
+
+		cVarTextureStreamingStatPoolMB.set(int32_t(totalSize / 1024 / 1024));
+		cVarTextureStreamingStatBias.set(mipBias);
+
+		// Drop first to free memory, then stream in the biggest missing mips first.
+		std::erase_if(wants, [](const Want& want) { return want.wantMip == want.asset->getResidentMip() || want.asset->isStreaming(); });
+		std::sort(wants.begin(), wants.end(), [](const Want& a, const Want& b)
+		{
+			const bool bDropA = a.wantMip > a.asset->getResidentMip();
+			const bool bDropB = b.wantMip > b.asset->getResidentMip();
+			if (bDropA != bDropB)
+			{
+				return bDropA;
+			}
+
+			return int32_t(a.asset->getResidentMip() - a.wantMip) > int32_t(b.asset->getResidentMip() - b.wantMip);
+		});
+
+		const int32_t maxUploadMB = cVarTextureStreamingMaxUploadMB.get();
+		const size_t maxUploadSize = maxUploadMB > 0 ? size_t(maxUploadMB) * 1024 * 1024 : std::numeric_limits<size_t>::max();
+
+		size_t uploadSize = 0;
+		for (auto& want : wants)
+		{
+			const size_t taskSize = want.asset->getResidentSize(want.wantMip);
+
+			// Always issue at least one task, single big mip may bigger than budget.
+			if (uploadSize > 0 && uploadSize + taskSize > maxUploadSize)
+			{
+				break;
+			}
+			uploadSize += taskSize;
+
+			m_context->getAsyncUploader().addTask(AssetTextureStreamTask::build(want.asset, want.wantMip));
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "rhi_misc.h"
+#include "resource.h"
+
+namespace engine
+{
+	class GPUStreamingImageAsset;
+
+	// Texture mip streaming, shader atomic min sampled mip of each bindless texture into feedback buffer,
+	// read back after frame fence, stream in sampled mips and drop unsampled mips to fit pool budget.
+	class TextureStreamingManager : NonCopyable
+	{
+	public:
+		explicit TextureStreamingManager(VulkanContext* context, uint32_t frameCount);
+		~TextureStreamingManager();
+
+		bool isEnable() const;
+
+		// Mip tail keep resident always, return 0 if this texture no need streaming.
+		uint32_t getTailMip(uint32_t width, uint32_t height, uint32_t mipCount) const;
+
+		// Main thread only.
+		void registerTexture(std::shared_ptr<GPUStreamingImageAsset> asset);
+
+		// Bindless ssbo index of feedback buffer, ~0 when disable.
+		uint32_t getFeedbackBindlessIndex() const;
+
+		// Read back feedback of finished frame and clear feedback buffer, only first call each frame work.
+		void recordFeedback(VkCommandBuffer cmd);
+
+		// Call once per frame in main thread, swap streamed images and issue new streaming tasks.
+		void tick();
+
+	private:
+		struct Record
+		{
+			std::weak_ptr<GPUStreamingImageAsset> asset;
+
+			// Min mip sampled recently, in full mip chain level.
+			uint32_t sampledMip = ~0;
+			uint64_t lastSampledTick = 0;
+		};
+
+		void readbackFeedback();
+		void updateResidency();
+
+	private:
+		VulkanContext* m_context;
+		uint32_t m_frameCount;
+
+		std::vector<Record> m_records;
+		uint64_t m_tickCount = 0;
+
+		// Device local feedback buffer, one uint per bindless texture.
+		std::unique_ptr<VulkanBuffer> m_feedback;
+		uint32_t m_feedbackBindless = ~0;
+		uint32_t m_feedbackCount = 0;
+		bool m_bFeedbackCleared = false;
+
+		// Host readback per frame in flight.
+		std::vector<std::unique_ptr<VulkanBuffer>> m_readbacks;
+		std::vector<bool> m_readbackValid;
+
+		// Record only once per frame even multi renderer tick.
+		bool m_bFeedbackRecorded = false;
+	};
+}
@@ -10,6 +10,7 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <cstring>
 
 namespace saba
 {
@@ -114,6 +115,71 @@ namespace saba
 		bool	m_badFlag;
 	};
 
+	// Same read interface as File but read from memory (mapped file), so per field read no fread call.
+	class BufferReader
+	{
+	public:
+		using Offset = int64_t;
+
+		BufferReader(const void* data, size_t size)
+			: m_data((const uint8_t*)data)
+			, m_size(size)
+		{
+		}
+
+		Offset GetSize() const { return (Offset)m_size; }
+		Offset Tell() const { return (Offset)m_pos; }
+		bool IsBad() const { return m_badFlag; }
+		bool IsEOF() const { return m_pos >= m_size; }
+
+		bool Seek(Offset offset)
+		{
+			if (offset < 0 || (size_t)offset > m_size)
+			{
+				m_badFlag = true;
+				return false;
+			}
+			m_pos = (size_t)offset;
+			return true;
+		}
+
+		template <typename T>
+		bool Read(T* buffer, size_t count = 1)
+		{
+			const size_t readSize = sizeof(T) * count;
+			if (buffer == nullptr || m_badFlag || readSize > m_size - m_pos)
+			{
+				m_badFlag = true;
+				return false;
+			}
+			if (readSize > 0)
+			{
+				memcpy(buffer, m_data + m_pos, readSize);
+			}
+			m_pos += readSize;
+			return true;
+		}
+
+		// Pointer to next bytes without copy, nullptr when out of range.
+		const uint8_t* Skip(size_t size)
+		{
+			if (m_badFlag || size > m_size - m_pos)
+			{
+				m_badFlag = true;
+				return nullptr;
+			}
+			const uint8_t* ptr = m_data + m_pos;
+			m_pos += size;
+			return ptr;
+		}
+
+	private:
+		const uint8_t*	m_data = nullptr;
+		size_t			m_size = 0;
+		size_t			m_pos = 0;
+		bool			m_badFlag = false;
+	};
+
 	class TextFileReader
 	{
 	public:
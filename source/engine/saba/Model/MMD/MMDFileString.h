@@ -61,6 +61,12 @@ namespace saba
 		return file.Read(str->m_buffer, Size);
 	}
 
+	template <size_t Size>
+	bool Read(MMDFileString<Size>* str, BufferReader& file)
+	{
+		return file.Read(str->m_buffer, Size);
+	}
+
 	template<size_t Size>
 	inline std::string MMDFileString<Size>::ToUtf8String() const
 	{
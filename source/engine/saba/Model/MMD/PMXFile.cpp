@@ -9,6 +9,9 @@
 #include <Saba/Base/File.h>
 #include <Saba/Base/UnicodeUtil.h>
 
+#include <util/mapped_file.h>
+#include <utf8/cpp17.h>
+
 #include <vector>
 
 namespace saba
@@ -17,18 +20,18 @@ namespace saba
 	{
 
 		template <typename T>
-		bool Read(T* val, File& file)
+		bool Read(T* val, BufferReader& file)
 		{
 			return file.Read(val);
 		}
 
 		template <typename T>
-		bool Read(T* valArray, size_t size, File& file)
+		bool Read(T* valArray, size_t size, BufferReader& file)
 		{
 			return file.Read(valArray, size);
 		}
 
-		bool ReadString(PMXFile* pmx, std::string* val, File& file)
+		bool ReadString(PMXFile* pmx, std::string* val, BufferReader& file)
 		{
 			uint32_t bufSize;
 			if (!Read(&bufSize, file))
@@ -64,7 +67,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadIndex(int32_t* index, uint8_t indexSize, File& file)
+		bool ReadIndex(int32_t* index, uint8_t indexSize, BufferReader& file)
 		{
 			switch (indexSize)
 			{
@@ -109,7 +112,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadHeader(PMXFile* pmxFile, File& file)
+		bool ReadHeader(PMXFile* pmxFile, BufferReader& file)
 		{
 			auto& header = pmxFile->m_header;
 
@@ -131,7 +134,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadInfo(PMXFile* pmx, File& file)
+		bool ReadInfo(PMXFile* pmx, BufferReader& file)
 		{
 			auto& info = pmx->m_info;
 
@@ -143,7 +146,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadVertex(PMXFile* pmx, File& file)
+		bool ReadVertex(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t vertexCount;
 			if (!Read(&vertexCount, file))
@@ -213,7 +216,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadFace(PMXFile* pmx, File& file)
+		bool ReadFace(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t faceCount = 0;
 			if (!Read(&faceCount, file))
@@ -269,7 +272,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadTexture(PMXFile* pmx, File& file)
+		bool ReadTexture(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t texCount = 0;
 			if (!Read(&texCount, file))
@@ -287,7 +290,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadMaterial(PMXFile* pmx, File& file)
+		bool ReadMaterial(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t matCount = 0;
 			if (!Read(&matCount, file))
@@ -340,7 +343,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadBone(PMXFile* pmx, File& file)
+		bool ReadBone(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t boneCount;
 			if (!Read(&boneCount, file))
@@ -423,7 +426,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadMorph(PMXFile* pmx, File& file)
+		bool ReadMorph(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t morphCount;
 			if (!Read(&morphCount, file))
@@ -537,7 +540,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadDisplayFrame(PMXFile* pmx, File& file)
+		bool ReadDisplayFrame(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t displayFrameCount;
 			if (!Read(&displayFrameCount, file))
@@ -580,7 +583,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadRigidbody(PMXFile* pmx, File& file)
+		bool ReadRigidbody(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t rbCount;
 			if (!Read(&rbCount, file))
@@ -617,7 +620,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadJoint(PMXFile* pmx, File& file)
+		bool ReadJoint(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t jointCount;
 			if (!Read(&jointCount, file))
@@ -651,7 +654,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadSoftbody(PMXFile* pmx, File& file)
+		bool ReadSoftbody(PMXFile* pmx, BufferReader& file)
 		{
 			int32_t sbCount;
 			if (!Read(&sbCount, file))
@@ -740,7 +743,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadPMXFile(PMXFile * pmxFile, File& file)
+		bool ReadPMXFile(PMXFile * pmxFile, BufferReader& file)
 		{
 			if (!ReadHeader(pmxFile, file))
 			{
@@ -823,13 +826,15 @@ namespace saba
 
 	bool ReadPMXFile(PMXFile * pmxFile, const char* filename)
 	{
-		File file;
-		if (!file.Open(filename))
+		// Map whole file and parse from memory, per field fread is too slow for heavy model.
+		engine::MappedFile mappedFile;
+		if (!mappedFile.open(std::filesystem::path(utf8::utf8to16(filename))))
 		{
 			SABA_INFO("PMX File Open Fail. {}", filename);
 			return false;
 		}
 
+		BufferReader file(mappedFile.getData(), mappedFile.getSize());
 		if (!ReadPMXFile(pmxFile, file))
 		{
 			SABA_INFO("PMX File Read Fail. {}", filename);
@@ -106,6 +106,11 @@ namespace saba
 	struct PMXTexture
 	{
 		std::string m_textureName;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_textureName);
+		}
 	};
 
 	/*
@@ -175,6 +180,16 @@ namespace saba
 		std::string	m_memo;
 
 		int32_t	m_numFaceVertices;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_name, m_englishName);
+			archive(m_diffuse, m_specular, m_specularPower, m_ambient);
+			archive(m_drawMode, m_edgeColor, m_edgeSize);
+			archive(m_textureIndex, m_sphereTextureIndex, m_sphereMode);
+			archive(m_toonMode, m_toonTextureIndex);
+			archive(m_memo, m_numFaceVertices);
+		}
 	};
 
 	/*
@@ -222,6 +237,11 @@ namespace saba
 		//m_enableLimitが1のときのみ
 		glm::vec3	m_limitMin;	//ラジアンで表現
 		glm::vec3	m_limitMax;	//ラジアンで表現
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_ikBoneIndex, m_enableLimit, m_limitMin, m_limitMax);
+		}
 	};
 
 	struct PMXBone
@@ -258,6 +278,16 @@ namespace saba
 		float	m_ikLimit;	//ラジアンで表現
 
 		std::vector<PMXIKLink>	m_ikLinks;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_name, m_englishName);
+			archive(m_position, m_parentBoneIndex, m_deformDepth, m_boneFlag);
+			archive(m_positionOffset, m_linkBoneIndex);
+			archive(m_appendBoneIndex, m_appendWeight);
+			archive(m_fixedAxis, m_localXAxis, m_localZAxis, m_keyValue);
+			archive(m_ikTargetBoneIndex, m_ikIterationCount, m_ikLimit, m_ikLinks);
+		}
 	};
 
 
@@ -301,12 +331,16 @@ namespace saba
 		{
 			int32_t		m_vertexIndex;
 			glm::vec3	m_position;
+
+			template<class Archive> void serialize(Archive& archive) { archive(m_vertexIndex, m_position); }
 		};
 
 		struct UVMorph
 		{
 			int32_t		m_vertexIndex;
 			glm::vec4	m_uv;
+
+			template<class Archive> void serialize(Archive& archive) { archive(m_vertexIndex, m_uv); }
 		};
 
 		struct BoneMorph
@@ -314,6 +348,8 @@ namespace saba
 			int32_t		m_boneIndex;
 			glm::vec3	m_position;
 			glm::quat	m_quaternion;
+
+			template<class Archive> void serialize(Archive& archive) { archive(m_boneIndex, m_position, m_quaternion); }
 		};
 
 		struct MaterialMorph
@@ -335,18 +371,28 @@ namespace saba
 			glm::vec4	m_textureFactor;
 			glm::vec4	m_sphereTextureFactor;
 			glm::vec4	m_toonTextureFactor;
+
+			template<class Archive> void serialize(Archive& archive)
+			{
+				archive(m_materialIndex, m_opType, m_diffuse, m_specular, m_specularPower, m_ambient);
+				archive(m_edgeColor, m_edgeSize, m_textureFactor, m_sphereTextureFactor, m_toonTextureFactor);
+			}
 		};
 
 		struct GroupMorph
 		{
 			int32_t	m_morphIndex;
 			float	m_weight;
+
+			template<class Archive> void serialize(Archive& archive) { archive(m_morphIndex, m_weight); }
 		};
 
 		struct FlipMorph
 		{
 			int32_t	m_morphIndex;
 			float	m_weight;
+
+			template<class Archive> void serialize(Archive& archive) { archive(m_morphIndex, m_weight); }
 		};
 
 		struct ImpulseMorph
@@ -355,6 +401,8 @@ namespace saba
 			uint8_t		m_localFlag;	//0:OFF 1:ON
 			glm::vec3	m_translateVelocity;
 			glm::vec3	m_rotateTorque;
+
+			template<class Archive> void serialize(Archive& archive) { archive(m_rigidbodyIndex, m_localFlag, m_translateVelocity, m_rotateTorque); }
 		};
 
 		std::vector<PositionMorph>	m_positionMorph;
@@ -364,6 +412,12 @@ namespace saba
 		std::vector<GroupMorph>		m_groupMorph;
 		std::vector<FlipMorph>		m_flipMorph;
 		std::vector<ImpulseMorph>	m_impulseMorph;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_name, m_englishName, m_controlPanel, m_morphType);
+			archive(m_positionMorph, m_uvMorph, m_boneMorph, m_materialMorph, m_groupMorph, m_flipMorph, m_impulseMorph);
+		}
 	};
 
 	struct PMXDispalyFrame
@@ -437,6 +491,14 @@ namespace saba
 			DynamicAndBoneMerge
 		};
 		Operation	m_op;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_name, m_englishName);
+			archive(m_boneIndex, m_group, m_collisionGroup, m_shape, m_shapeSize);
+			archive(m_translate, m_rotate);
+			archive(m_mass, m_translateDimmer, m_rotateDimmer, m_repulsion, m_friction, m_op);
+		}
 	};
 
 	struct PMXJoint
@@ -475,6 +537,14 @@ namespace saba
 
 		glm::vec3	m_springTranslateFactor;
 		glm::vec3	m_springRotateFactor;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(m_name, m_englishName);
+			archive(m_type, m_rigidbodyAIndex, m_rigidbodyBIndex, m_translate, m_rotate);
+			archive(m_translateLowerLimit, m_translateUpperLimit, m_rotateLowerLimit, m_rotateUpperLimit);
+			archive(m_springTranslateFactor, m_springRotateFactor);
+		}
 	};
 
 	struct PMXSoftbody
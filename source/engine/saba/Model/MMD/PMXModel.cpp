@@ -7,6 +7,7 @@
 #include "PMXModel.h"
 
 #include "PMXFile.h"
+#include "PMXSkinning.h"
 #include "MMDPhysics.h"
 
 #include <Saba/Base/Path.h>
@@ -27,11 +28,14 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <util/threadpool.h>
 
 namespace saba
 {
 	PMXModel::PMXModel()
-		: m_parallelUpdateCount(0)
+		: m_morphVersion(0)
+		, m_parallelUpdateCount(0)
+		, m_skinning(std::make_unique<PMXSkinning>())
 	{
 	}
 
@@ -138,6 +142,20 @@ namespace saba
 		}
 
 		EndMorphMaterial();
+
+		// Track morph weights change, vertex morph result only depends on weights.
+		bool morphChanged = (m_morphWeights.size() != morphs.size());
+		m_morphWeights.resize(morphs.size());
+		for (size_t i = 0; i < morphs.size(); i++)
+		{
+			const float weight = morphs[i]->GetWeight();
+			morphChanged |= (m_morphWeights[i] != weight);
+			m_morphWeights[i] = weight;
+		}
+		if (morphChanged)
+		{
+			m_morphVersion++;
+		}
 	}
 
 	void PMXModel::UpdateNodeAnimation(bool afterPhysicsAnim)
@@ -280,6 +298,25 @@ namespace saba
 	}
 
 	void PMXModel::Update()
+	{
+		UpdateBoneTransforms();
+
+		PMXSkinning::Frame frame;
+		frame.m_transforms = m_transforms.data();
+		frame.m_boneRotations = m_boneRotations.data();
+		frame.m_positions = m_positions.data();
+		frame.m_normals = m_normals.data();
+		frame.m_uvs = m_uvs.data();
+		frame.m_morphPositions = m_morphPositions.data();
+		frame.m_morphUVs = m_morphUVs.data();
+		frame.m_updatePositions = m_updatePositions.data();
+		frame.m_updateNormals = m_updateNormals.data();
+		frame.m_updateUVs = m_updateUVs.data();
+
+		m_skinning->Update(frame, m_transforms.size());
+	}
+
+	void PMXModel::UpdateBoneTransforms()
 	{
 		auto& nodes = (*m_nodeMan.GetNodes());
 
@@ -289,41 +326,29 @@ namespace saba
 			m_transforms[i] = nodes[i]->GetGlobalTransform() * nodes[i]->GetInverseInitTransform();
 		}
 
-		if (m_parallelUpdateCount != m_updateRanges.size())
-		{
-			SetupParallelUpdate();
-		}
-
-		size_t futureCount = m_parallelUpdateFutures.size();
-		for (size_t i = 0; i < futureCount; i++)
+		// SDEF bone rotations, compute once per bone instead of per vertex.
+		if (m_skinning->NeedBoneRotations())
 		{
-			size_t rangeIndex = i + 1;
-			if (m_updateRanges[rangeIndex].m_vertexCount != 0)
+			m_boneRotations.resize(nodes.size());
+			for (size_t i = 0; i < nodes.size(); i++)
 			{
-				m_parallelUpdateFutures[i] = std::async(
-					std::launch::async,
-					[this, rangeIndex]() { this->Update(this->m_updateRanges[rangeIndex]); }
-				);
+				m_boneRotations[i] = glm::quat_cast(nodes[i]->GetGlobalTransform());
 			}
 		}
+	}
 
-		Update(m_updateRanges[0]);
-
-		for (size_t i = 0; i < futureCount; i++)
+	void PMXModel::SetParallelUpdateHint(uint32_t parallelCount)
+	{
+		if (m_parallelUpdateCount != parallelCount)
 		{
-			size_t rangeIndex = i + 1;
-			if (m_updateRanges[rangeIndex].m_vertexCount != 0)
+			m_parallelUpdateCount = parallelCount;
+			if (!m_positions.empty())
 			{
-				m_parallelUpdateFutures[i].wait();
+				SetupParallelUpdate();
 			}
 		}
 	}
 
-	void PMXModel::SetParallelUpdateHint(uint32_t parallelCount)
-	{
-		m_parallelUpdateCount = parallelCount;
-	}
-
 
 
 	bool PMXModel::Load(const std::string& filepath, const std::string& mmdDataDir)
@@ -336,16 +361,25 @@ namespace saba
 			return false;
 		}
 
-		std::string dirPath = PathUtil::GetDirectoryName(filepath);
+		CookedVertices vertices;
+		if (!CookVertices(pmx, vertices))
+		{
+			return false;
+		}
+
+		return Load(pmx, std::move(vertices), filepath, mmdDataDir);
+	}
 
+	bool PMXModel::CookVertices(const PMXFile& pmx, CookedVertices& out)
+	{
 		size_t vertexCount = pmx.m_vertices.size();
-		m_positions.reserve(vertexCount);
-		m_normals.reserve(vertexCount);
+		out.m_positions.reserve(vertexCount);
+		out.m_normals.reserve(vertexCount);
 
-		m_uvs.reserve(vertexCount);
-		m_vertexBoneInfos.reserve(vertexCount);
-		m_bboxMax = glm::vec3(-std::numeric_limits<float>::max());
-		m_bboxMin = glm::vec3(std::numeric_limits<float>::max());
+		out.m_uvs.reserve(vertexCount);
+		out.m_vertexBoneInfos.reserve(vertexCount);
+		out.m_bboxMax = glm::vec3(-std::numeric_limits<float>::max());
+		out.m_bboxMin = glm::vec3(std::numeric_limits<float>::max());
 
 		bool warnSDEF = false;
 		bool infoQDEF = false;
@@ -354,9 +388,9 @@ namespace saba
 			glm::vec3 pos = v.m_position * glm::vec3(1, 1, -1);
 			glm::vec3 nor = v.m_normal * glm::vec3(1, 1, -1);
 			glm::vec2 uv = glm::vec2(v.m_uv.x, 1.0f - v.m_uv.y);
-			m_positions.push_back(pos);
-			m_normals.push_back(nor);
-			m_uvs.push_back(uv);
+			out.m_positions.push_back(pos);
+			out.m_normals.push_back(nor);
+			out.m_uvs.push_back(uv);
 			VertexBoneInfo vtxBoneInfo;
 			if (PMXVertexWeight::SDEF != v.m_weightType)
 			{
@@ -426,21 +460,16 @@ namespace saba
 				SABA_ERROR("Unknown PMX Vertex Weight Type: {}", (int)v.m_weightType);
 				break;
 			}
-			m_vertexBoneInfos.push_back(vtxBoneInfo);
+			out.m_vertexBoneInfos.push_back(vtxBoneInfo);
 
-			m_bboxMax = glm::max(m_bboxMax, pos);
-			m_bboxMin = glm::min(m_bboxMin, pos);
+			out.m_bboxMax = glm::max(out.m_bboxMax, pos);
+			out.m_bboxMin = glm::min(out.m_bboxMin, pos);
 		}
-		m_morphPositions.resize(m_positions.size());
-		m_morphUVs.resize(m_positions.size());
-		m_updatePositions.resize(m_positions.size());
-		m_updateNormals.resize(m_normals.size());
-		m_updateUVs.resize(m_uvs.size());
 
 		std::unordered_map<glm::vec3, glm::dvec3, engine::KeyFuncsVec3, engine::KeyFuncsVec3> positionNormalMap;
 		for (size_t i = 0; i < vertexCount; i++)
 		{
-			positionNormalMap[m_positions[i]] += m_normals[i];
+			positionNormalMap[out.m_positions[i]] += out.m_normals[i];
 		}
 
 		for (auto& pair : positionNormalMap)
@@ -448,39 +477,65 @@ namespace saba
 			pair.second = glm::normalize(pair.second);
 		}
 
-		m_smoothNormals.resize(vertexCount);
+		out.m_smoothNormals.resize(vertexCount);
 		for (size_t i = 0; i < vertexCount; i++)
 		{
-			m_smoothNormals[i] += positionNormalMap[m_positions[i]];
+			out.m_smoothNormals[i] += positionNormalMap[out.m_positions[i]];
 		}
 
-		m_indexElementSize = 4;// pmx.m_header.m_vertexIndexSize;
-		m_indexCount = pmx.m_faces.size() * 3;
-		m_indices.resize(m_indexCount * m_indexElementSize); // @qiutang: we always use uint32 index
-
-		switch (m_indexElementSize)
-		{
-		case 1:
-		case 2:
-		case 4:
+		// @qiutang: we always use uint32 index
+		out.m_indices.resize(pmx.m_faces.size() * 3);
 		{
 			int idx = 0;
-			uint32_t* indices = (uint32_t*)m_indices.data();
 			for (const auto& face : pmx.m_faces)
 			{
 				for (int i = 0; i < 3; i++)
 				{
-					indices[idx] = face.m_vertices[3 - i - 1];
+					out.m_indices[idx] = face.m_vertices[3 - i - 1];
 					idx++;
 				}
 			}
-			break;
 		}
-		default:
-			SABA_ERROR("Unsupported Index Size: [{}]", m_indexElementSize);
+
+		return true;
+	}
+
+	bool PMXModel::Load(const PMXFile& pmx, CookedVertices&& vertices, const std::string& filepath, const std::string& mmdDataDir)
+	{
+		Destroy();
+
+		std::string dirPath = PathUtil::GetDirectoryName(filepath);
+
+		m_positions = std::move(vertices.m_positions);
+		m_normals = std::move(vertices.m_normals);
+		m_smoothNormals = std::move(vertices.m_smoothNormals);
+		m_uvs = std::move(vertices.m_uvs);
+		m_vertexBoneInfos = std::move(vertices.m_vertexBoneInfos);
+		m_bboxMin = vertices.m_bboxMin;
+		m_bboxMax = vertices.m_bboxMax;
+
+		const size_t vertexCount = m_positions.size();
+		if (m_normals.size() != vertexCount || m_smoothNormals.size() != vertexCount ||
+			m_uvs.size() != vertexCount || m_vertexBoneInfos.size() != vertexCount)
+		{
+			SABA_ERROR("Cooked vertex stream size mismatch.");
 			return false;
 		}
 
+		m_morphPositions.resize(vertexCount);
+		m_morphUVs.resize(vertexCount);
+		m_updatePositions.resize(vertexCount);
+		m_updateNormals.resize(vertexCount);
+		m_updateUVs.resize(vertexCount);
+
+		m_indexElementSize = sizeof(uint32_t);
+		m_indexCount = vertices.m_indices.size();
+		m_indices.resize(m_indexCount * m_indexElementSize);
+		if (m_indexCount > 0)
+		{
+			memcpy(m_indices.data(), vertices.m_indices.data(), m_indices.size());
+		}
+
 		std::vector<std::string> texturePaths;
 		texturePaths.reserve(pmx.m_textures.size());
 		for (const auto& pmxTex : pmx.m_textures)
@@ -913,14 +968,17 @@ namespace saba
 
 		m_nodeMan.GetNodes()->clear();
 
-		m_updateRanges.clear();
+		m_boneRotations.clear();
+		m_morphWeights.clear();
+		m_skinning->Clear();
 	}
 
 	void PMXModel::SetupParallelUpdate()
 	{
+		// Skinning jobs run on engine threadpool, default one job per worker.
 		if (m_parallelUpdateCount == 0)
 		{
-			m_parallelUpdateCount = std::thread::hardware_concurrency();
+			m_parallelUpdateCount = engine::ThreadPool::getDefault()->getThreadCount();
 		}
 		size_t maxParallelCount = std::max(size_t(16), size_t(std::thread::hardware_concurrency()));
 		if (m_parallelUpdateCount > maxParallelCount)
@@ -931,179 +989,10 @@ namespace saba
 
 		SABA_INFO("Select PMX Parallel Update Count : {}", m_parallelUpdateCount);
 
-		m_updateRanges.resize(m_parallelUpdateCount);
-		m_parallelUpdateFutures.resize(m_parallelUpdateCount - 1);
-
 		const size_t vertexCount = m_positions.size();
-		const size_t LowerVertexCount = 1000;
-		if (vertexCount < m_updateRanges.size() * LowerVertexCount)
-		{
-			size_t numRanges = (vertexCount + LowerVertexCount - 1) / LowerVertexCount;
-			for (size_t rangeIdx = 0; rangeIdx < m_updateRanges.size(); rangeIdx++)
-			{
-				auto& range = m_updateRanges[rangeIdx];
-				if (rangeIdx < numRanges)
-				{
-					range.m_vertexOffset = rangeIdx * LowerVertexCount;
-					range.m_vertexCount = std::min(LowerVertexCount, vertexCount - range.m_vertexOffset);
-				}
-				else
-				{
-					range.m_vertexOffset = 0;
-					range.m_vertexCount = 0;
-				}
-			}
-		}
-		else
-		{
-			size_t numVertexCount = vertexCount / m_updateRanges.size();
-			size_t offset = 0;
-			for (size_t rangeIdx = 0; rangeIdx < m_updateRanges.size(); rangeIdx++)
-			{
-				auto& range = m_updateRanges[rangeIdx];
-				range.m_vertexOffset = offset;
-				range.m_vertexCount = numVertexCount;
-				if (rangeIdx == 0)
-				{
-					range.m_vertexCount += vertexCount % m_updateRanges.size();
-				}
-				offset = range.m_vertexOffset + range.m_vertexCount;
-			}
-		}
-	}
-
-	void PMXModel::Update(const UpdateRange & range)
-	{
-		const auto* position = m_positions.data() + range.m_vertexOffset;
-		const auto* normal = m_normals.data() + range.m_vertexOffset;
-		const auto* uv = m_uvs.data() + range.m_vertexOffset;
-		const auto* morphPos = m_morphPositions.data() + range.m_vertexOffset;
-		const auto* morphUV = m_morphUVs.data() + range.m_vertexOffset;
-		const auto* vtxInfo = m_vertexBoneInfos.data() + range.m_vertexOffset;
-		const auto* transforms = m_transforms.data();
-		auto* updatePosition = m_updatePositions.data() + range.m_vertexOffset;
-		auto* updateNormal = m_updateNormals.data() + range.m_vertexOffset;
-		auto* updateUV = m_updateUVs.data() + range.m_vertexOffset;
-
-		for (size_t i = 0; i < range.m_vertexCount; i++)
-		{
-			glm::mat4 m;
-			switch (vtxInfo->m_skinningType)
-			{
-			case PMXModel::SkinningType::Weight1:
-			{
-				const auto i0 = vtxInfo->m_boneIndex[0];
-				const auto& m0 = transforms[i0];
-				m = m0;
-				break;
-			}
-			case PMXModel::SkinningType::Weight2:
-			{
-				const auto i0 = vtxInfo->m_boneIndex[0];
-				const auto i1 = vtxInfo->m_boneIndex[1];
-				const auto w0 = vtxInfo->m_boneWeight[0];
-				const auto w1 = vtxInfo->m_boneWeight[1];
-				const auto& m0 = transforms[i0];
-				const auto& m1 = transforms[i1];
-				m = m0 * w0 + m1 * w1;
-				break;
-			}
-			case PMXModel::SkinningType::Weight4:
-			{
-				const auto i0 = vtxInfo->m_boneIndex[0];
-				const auto i1 = vtxInfo->m_boneIndex[1];
-				const auto i2 = vtxInfo->m_boneIndex[2];
-				const auto i3 = vtxInfo->m_boneIndex[3];
-				const auto w0 = vtxInfo->m_boneWeight[0];
-				const auto w1 = vtxInfo->m_boneWeight[1];
-				const auto w2 = vtxInfo->m_boneWeight[2];
-				const auto w3 = vtxInfo->m_boneWeight[3];
-				const auto& m0 = transforms[i0];
-				const auto& m1 = transforms[i1];
-				const auto& m2 = transforms[i2];
-				const auto& m3 = transforms[i3];
-				m = m0 * w0 + m1 * w1 + m2 * w2 + m3 * w3;
-				break;
-			}
-			case PMXModel::SkinningType::SDEF:
-			{
-				// https://github.com/powroupi/blender_mmd_tools/blob/dev_test/mmd_tools/core/sdef.py
-
-				auto& nodes = (*m_nodeMan.GetNodes());
-				const auto i0 = vtxInfo->m_sdef.m_boneIndex[0];
-				const auto i1 = vtxInfo->m_sdef.m_boneIndex[1];
-				const auto w0 = vtxInfo->m_sdef.m_boneWeight;
-				const auto w1 = 1.0f - w0;
-				const auto center = vtxInfo->m_sdef.m_sdefC;
-				const auto cr0 = vtxInfo->m_sdef.m_sdefR0;
-				const auto cr1 = vtxInfo->m_sdef.m_sdefR1;
-				const auto q0 = glm::quat_cast(nodes[i0]->GetGlobalTransform());
-				const auto q1 = glm::quat_cast(nodes[i1]->GetGlobalTransform());
-				const auto m0 = transforms[i0];
-				const auto m1 = transforms[i1];
-
-				const auto pos = *position + *morphPos;
-				const auto rot_mat = glm::mat3_cast(glm::slerp(q0, q1, w1));
-
-				*updatePosition = glm::mat3(rot_mat) * (pos - center) + glm::vec3(m0 * glm::vec4(cr0, 1)) * w0 + glm::vec3(m1 * glm::vec4(cr1, 1)) * w1;
-				*updateNormal = rot_mat * *normal;
-
-				break;
-			}
-			case PMXModel::SkinningType::DualQuaternion:
-			{
-				//
-				// Skinning with Dual Quaternions
-				// https://www.cs.utah.edu/~ladislav/dq/index.html
-				//
-				glm::dualquat dq[4];
-				float w[4] = { 0 };
-				for (int bi = 0; bi < 4; bi++)
-				{
-					auto boneID = vtxInfo->m_boneIndex[bi];
-					if (boneID != -1)
-					{ 
-						dq[bi] = glm::dualquat_cast(glm::mat3x4(glm::transpose(transforms[boneID])));
-						dq[bi] = glm::normalize(dq[bi]);
-						w[bi] = vtxInfo->m_boneWeight[bi];
-					}
-					else
-					{
-						w[bi] = 0;
-					}
-				}
-				if (glm::dot(dq[0].real, dq[1].real) < 0) { w[1] *= -1.0f; }
-				if (glm::dot(dq[0].real, dq[2].real) < 0) { w[2] *= -1.0f; }
-				if (glm::dot(dq[0].real, dq[3].real) < 0) { w[3] *= -1.0f; }
-				auto blendDQ = w[0] * dq[0]
-					+ w[1] * dq[1]
-					+ w[2] * dq[2]
-					+ w[3] * dq[3];
-				blendDQ = glm::normalize(blendDQ);
-				m = glm::transpose(glm::mat3x4_cast(blendDQ));
-				break;
-			}
-			default:
-				break;
-			}
+		const size_t jobVertexCount = (vertexCount + m_parallelUpdateCount - 1) / m_parallelUpdateCount;
 
-			if (PMXModel::SkinningType::SDEF != vtxInfo->m_skinningType)
-			{
-				*updatePosition = glm::vec3(m * glm::vec4(*position + *morphPos, 1));
-				*updateNormal = glm::normalize(glm::mat3(m) * *normal);
-			}
-			*updateUV = *uv + glm::vec2((*morphUV).x, (*morphUV).y);
-
-			vtxInfo++;
-			position++;
-			normal++;
-			uv++;
-			updatePosition++;
-			updateNormal++;
-			updateUV++;
-			morphPos++;
-			morphUV++;
-		}
+		m_skinning->Setup(m_vertexBoneInfos.data(), vertexCount, jobVertexCount);
 	}
 
 	void PMXModel::Morph(PMXMorph* morph, float weight)
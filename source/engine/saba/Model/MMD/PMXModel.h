@@ -17,10 +17,12 @@
 #include <vector>
 #include <string>
 #include <algorithm>
-#include <future>
+#include <memory>
 
 namespace saba
 {
+	class PMXSkinning;
+
 	class PMXNode : public MMDNode
 	{
 	public:
@@ -121,12 +123,34 @@ namespace saba
 		void Update() override;
 		void SetParallelUpdateHint(uint32_t parallelCount) override;
 
+		// Only update skinning bone transforms without vertex skinning, used when skinning on GPU.
+		void UpdateBoneTransforms();
+
 		bool Load(const std::string& filepath, const std::string& mmdDataDir);
 		void Destroy();
 
+		struct CookedVertices;
+
+		// Load from parsed pmx and cooked vertices, pmx vertices and faces no used so can be empty.
+		bool Load(const PMXFile& pmx, CookedVertices&& vertices, const std::string& filepath, const std::string& mmdDataDir);
+
+		// Convert pmx vertices to runtime streams once, result can store in cooked file.
+		static bool CookVertices(const PMXFile& pmx, CookedVertices& out);
+
 		const glm::vec3& GetBBoxMin() const { return m_bboxMin; }
 		const glm::vec3& GetBBoxMax() const { return m_bboxMax; }
 
+		// Skinning inputs, valid after UpdateBoneTransforms or Update.
+		size_t GetBoneCount() const { return m_transforms.size(); }
+		const glm::mat4* GetBoneTransforms() const { return m_transforms.data(); }
+		// Empty when no SDEF vertices exist.
+		const glm::quat* GetBoneRotations() const { return m_boneRotations.empty() ? nullptr : m_boneRotations.data(); }
+		const glm::vec3* GetMorphPositions() const { return m_morphPositions.data(); }
+		const glm::vec4* GetMorphUVs() const { return m_morphUVs.data(); }
+
+		// Increase when morph weights changed, so vertex morph data only need re-upload when version changed.
+		uint32_t GetMorphVersion() const { return m_morphVersion; }
+
 	public:
 		enum class SkinningType
 		{
@@ -158,6 +182,22 @@ namespace saba
 			};
 		};
 
+		const VertexBoneInfo* GetVertexBoneInfos() const { return m_vertexBoneInfos.data(); }
+
+		// SoA runtime vertex streams, already convert to engine space.
+		struct CookedVertices
+		{
+			std::vector<glm::vec3>		m_positions;
+			std::vector<glm::vec3>		m_normals;
+			std::vector<glm::vec3>		m_smoothNormals;
+			std::vector<glm::vec2>		m_uvs;
+			std::vector<VertexBoneInfo>	m_vertexBoneInfos;
+			std::vector<uint32_t>		m_indices;
+
+			glm::vec3	m_bboxMin;
+			glm::vec3	m_bboxMax;
+		};
+
 	private:
 		struct PositionMorph
 		{
@@ -240,15 +280,8 @@ namespace saba
 			size_t		m_dataIndex;
 		};
 
-		struct UpdateRange
-		{
-			size_t	m_vertexOffset;
-			size_t	m_vertexCount;
-		};
-
 	private:
 		void SetupParallelUpdate();
-		void Update(const UpdateRange& range);
 
 		void Morph(PMXMorph* morph, float weight);
 
@@ -272,6 +305,7 @@ namespace saba
 		std::vector<glm::vec3>	m_updateNormals;
 		std::vector<glm::vec2>	m_updateUVs;
 		std::vector<glm::mat4>	m_transforms;
+		std::vector<glm::quat>	m_boneRotations;
 
 		std::vector<char>	m_indices;
 		size_t				m_indexCount;
@@ -286,6 +320,8 @@ namespace saba
 		// PositionMorph用
 		std::vector<glm::vec3>	m_morphPositions;
 		std::vector<glm::vec4>	m_morphUVs;
+		std::vector<float>		m_morphWeights;
+		uint32_t				m_morphVersion;
 
 		// マテリアルMorph用
 		std::vector<MMDMaterial>	m_initMaterials;
@@ -304,9 +340,8 @@ namespace saba
 		MMDMorphManagerT<PMXMorph>	m_morphMan;
 		MMDPhysicsManager			m_physicsMan;
 
-		uint32_t							m_parallelUpdateCount;
-		std::vector<UpdateRange>			m_updateRanges;
-		std::vector<std::future<void>>		m_parallelUpdateFutures;
+		uint32_t						m_parallelUpdateCount;
+		std::unique_ptr<PMXSkinning>	m_skinning;
 	};
 }
 
@@ -0,0 +1,516 @@
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include "PMXSkinning.h"
+
+#include <util/threadpool.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtx/dual_quaternion.hpp>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+	#define SABA_SKINNING_SSE 1
+	#include <immintrin.h>
+#else
+	#define SABA_SKINNING_SSE 0
+#endif
+
+// AVX2 kernels need gather, only enable when compiler target support it (/arch:AVX2 or -mavx2).
+#if SABA_SKINNING_SSE && defined(__AVX2__)
+	#define SABA_SKINNING_AVX2 1
+#else
+	#define SABA_SKINNING_AVX2 0
+#endif
+
+namespace saba
+{
+	namespace
+	{
+		// AVX2 kernel blend 8 vertices per loop, job size align to it so only batch tail fallback.
+		constexpr size_t kKernelWidth = 8;
+
+		// Job smaller than this cost more on schedule than skinning itself.
+		constexpr size_t kMinJobVertexCount = 1024;
+
+		inline glm::vec3 LoadRestPosition(const PMXSkinning::Frame& frame, uint32_t vi)
+		{
+			return frame.m_positions[vi] + frame.m_morphPositions[vi];
+		}
+
+#if SABA_SKINNING_SSE
+		// Blend matrix columns, keep in register.
+		struct BlendMatrix
+		{
+			__m128 c0;
+			__m128 c1;
+			__m128 c2;
+			__m128 c3;
+		};
+
+		inline void BlendLoad(BlendMatrix& m, const glm::mat4& src)
+		{
+			const float* p = &src[0][0];
+			m.c0 = _mm_loadu_ps(p + 0);
+			m.c1 = _mm_loadu_ps(p + 4);
+			m.c2 = _mm_loadu_ps(p + 8);
+			m.c3 = _mm_loadu_ps(p + 12);
+		}
+
+		inline void BlendInit(BlendMatrix& m, const glm::mat4& src, float w)
+		{
+			const float* p = &src[0][0];
+			const __m128 vw = _mm_set1_ps(w);
+			m.c0 = _mm_mul_ps(_mm_loadu_ps(p + 0), vw);
+			m.c1 = _mm_mul_ps(_mm_loadu_ps(p + 4), vw);
+			m.c2 = _mm_mul_ps(_mm_loadu_ps(p + 8), vw);
+			m.c3 = _mm_mul_ps(_mm_loadu_ps(p + 12), vw);
+		}
+
+		inline void BlendAdd(BlendMatrix& m, const glm::mat4& src, float w)
+		{
+			const float* p = &src[0][0];
+			const __m128 vw = _mm_set1_ps(w);
+			m.c0 = _mm_add_ps(m.c0, _mm_mul_ps(_mm_loadu_ps(p + 0), vw));
+			m.c1 = _mm_add_ps(m.c1, _mm_mul_ps(_mm_loadu_ps(p + 4), vw));
+			m.c2 = _mm_add_ps(m.c2, _mm_mul_ps(_mm_loadu_ps(p + 8), vw));
+			m.c3 = _mm_add_ps(m.c3, _mm_mul_ps(_mm_loadu_ps(p + 12), vw));
+		}
+
+		inline __m128 TransformPoint(const BlendMatrix& m, const glm::vec3& p)
+		{
+			return _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(m.c0, _mm_set1_ps(p.x)), _mm_mul_ps(m.c1, _mm_set1_ps(p.y))),
+				_mm_add_ps(_mm_mul_ps(m.c2, _mm_set1_ps(p.z)), m.c3));
+		}
+
+		inline __m128 TransformVector(const BlendMatrix& m, const glm::vec3& v)
+		{
+			return _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(m.c0, _mm_set1_ps(v.x)), _mm_mul_ps(m.c1, _mm_set1_ps(v.y))),
+				_mm_mul_ps(m.c2, _mm_set1_ps(v.z)));
+		}
+
+		inline glm::vec3 StoreVec3(__m128 v)
+		{
+			alignas(16) float result[4];
+			_mm_store_ps(result, v);
+			return glm::vec3(result[0], result[1], result[2]);
+		}
+
+		inline __m128 Normalize3(__m128 v)
+		{
+			// Mask w lane, then sum xyz squares to all lanes.
+			const __m128 xyz = _mm_and_ps(v, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+			__m128 sq = _mm_mul_ps(xyz, xyz);
+			sq = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+			sq = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_div_ps(xyz, _mm_sqrt_ps(sq));
+		}
+
+		inline void StoreSkinned(const BlendMatrix& m, const glm::vec3& pos, const glm::vec3& nor, glm::vec3& outPos, glm::vec3& outNor)
+		{
+			outPos = StoreVec3(TransformPoint(m, pos));
+			outNor = StoreVec3(Normalize3(TransformVector(m, nor)));
+		}
+
+		inline float Dot4(__m128 a, __m128 b)
+		{
+			__m128 v = _mm_mul_ps(a, b);
+			v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+			v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_cvtss_f32(v);
+		}
+#endif
+
+		inline void StoreSkinned(const glm::mat4& m, const glm::vec3& pos, const glm::vec3& nor, glm::vec3& outPos, glm::vec3& outNor)
+		{
+#if SABA_SKINNING_SSE
+			BlendMatrix blend;
+			BlendLoad(blend, m);
+			StoreSkinned(blend, pos, nor, outPos, outNor);
+#else
+			outPos = glm::vec3(m * glm::vec4(pos, 1));
+			outNor = glm::normalize(glm::mat3(m) * nor);
+#endif
+		}
+
+		inline void PushBone(std::vector<int32_t>& indices, std::vector<float>& weights, int32_t boneIndex, float boneWeight)
+		{
+			// Unused bone slot store -1 index in pmx, remap to bone 0 with zero weight so kernels no need branch.
+			if (boneIndex < 0)
+			{
+				indices.push_back(0);
+				weights.push_back(0.0f);
+			}
+			else
+			{
+				indices.push_back(boneIndex);
+				weights.push_back(boneWeight);
+			}
+		}
+	}
+
+	void PMXSkinning::Clear()
+	{
+		for (auto& batch : m_batches)
+		{
+			batch = Batch{ };
+		}
+		m_jobs.clear();
+		m_jobVertexCount = 0;
+
+		m_boneDQReal.clear();
+		m_boneDQDual.clear();
+	}
+
+	void PMXSkinning::Setup(const VertexBoneInfo* vtxInfos, size_t vertexCount, size_t jobVertexCount)
+	{
+		Clear();
+
+		// Sort vertices by skinning type, keep vertex order inside batch for memory locality.
+		for (uint32_t vi = 0; vi < uint32_t(vertexCount); vi++)
+		{
+			const auto& info = vtxInfos[vi];
+			auto& batch = m_batches[size_t(info.m_skinningType)];
+
+			batch.m_vertexIndices.push_back(vi);
+			switch (info.m_skinningType)
+			{
+			case SkinningType::Weight1:
+			{
+				PushBone(batch.m_boneIndices[0], batch.m_boneWeights[0], info.m_boneIndex[0], 1.0f);
+				break;
+			}
+			case SkinningType::Weight2:
+			{
+				for (int bi = 0; bi < 2; bi++)
+				{
+					PushBone(batch.m_boneIndices[bi], batch.m_boneWeights[bi], info.m_boneIndex[bi], info.m_boneWeight[bi]);
+				}
+				break;
+			}
+			case SkinningType::Weight4:
+			case SkinningType::DualQuaternion:
+			{
+				for (int bi = 0; bi < 4; bi++)
+				{
+					PushBone(batch.m_boneIndices[bi], batch.m_boneWeights[bi], info.m_boneIndex[bi], info.m_boneWeight[bi]);
+				}
+				break;
+			}
+			case SkinningType::SDEF:
+			{
+				PushBone(batch.m_boneIndices[0], batch.m_boneWeights[0], info.m_sdef.m_boneIndex[0], info.m_sdef.m_boneWeight);
+				PushBone(batch.m_boneIndices[1], batch.m_boneWeights[1], info.m_sdef.m_boneIndex[1], 1.0f - info.m_sdef.m_boneWeight);
+
+				batch.m_sdefC.push_back(info.m_sdef.m_sdefC);
+				batch.m_sdefR0.push_back(info.m_sdef.m_sdefR0);
+				batch.m_sdefR1.push_back(info.m_sdef.m_sdefR1);
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		// Split batches into stable jobs, they keep same until next setup.
+		m_jobVertexCount = std::max(jobVertexCount, kMinJobVertexCount);
+		m_jobVertexCount = (m_jobVertexCount + kKernelWidth - 1) / kKernelWidth * kKernelWidth;
+
+		for (size_t typeIndex = 0; typeIndex < kSkinningTypeCount; typeIndex++)
+		{
+			const uint32_t batchSize = uint32_t(m_batches[typeIndex].m_vertexIndices.size());
+			for (uint32_t begin = 0; begin < batchSize; begin += uint32_t(m_jobVertexCount))
+			{
+				Job job;
+				job.m_skinningType = SkinningType(typeIndex);
+				job.m_begin = begin;
+				job.m_end = std::min(batchSize, begin + uint32_t(m_jobVertexCount));
+
+				m_jobs.push_back(job);
+			}
+		}
+	}
+
+	void PMXSkinning::Update(const Frame& frame, size_t boneCount)
+	{
+		if (!m_batches[size_t(SkinningType::DualQuaternion)].m_vertexIndices.empty())
+		{
+			UpdateBoneDualQuats(frame, boneCount);
+		}
+
+		if (m_jobs.size() <= 1)
+		{
+			for (const auto& job : m_jobs)
+			{
+				RunJob(job, frame);
+			}
+			return;
+		}
+
+		const auto loop = [this, &frame](const size_t loopStart, const size_t loopEnd)
+		{
+			for (size_t i = loopStart; i < loopEnd; ++i)
+			{
+				RunJob(m_jobs[i], frame);
+			}
+		};
+		engine::ThreadPool::getDefault()->parallelFor(0, m_jobs.size(), loop, 1);
+	}
+
+	void PMXSkinning::UpdateBoneDualQuats(const Frame& frame, size_t boneCount)
+	{
+		m_boneDQReal.resize(boneCount);
+		m_boneDQDual.resize(boneCount);
+
+		for (size_t i = 0; i < boneCount; i++)
+		{
+			auto dq = glm::dualquat_cast(glm::mat3x4(glm::transpose(frame.m_transforms[i])));
+			dq = glm::normalize(dq);
+
+			m_boneDQReal[i] = dq.real;
+			m_boneDQDual[i] = dq.dual;
+		}
+	}
+
+	void PMXSkinning::RunJob(const Job& job, const Frame& frame) const
+	{
+		const auto& batch = m_batches[size_t(job.m_skinningType)];
+		switch (job.m_skinningType)
+		{
+		case SkinningType::Weight1:
+			SkinningBDEF<1>(batch, job.m_begin, job.m_end, frame);
+			break;
+		case SkinningType::Weight2:
+			SkinningBDEF<2>(batch, job.m_begin, job.m_end, frame);
+			break;
+		case SkinningType::Weight4:
+			SkinningBDEF<4>(batch, job.m_begin, job.m_end, frame);
+			break;
+		case SkinningType::SDEF:
+			SkinningSDEF(batch, job.m_begin, job.m_end, frame);
+			break;
+		case SkinningType::DualQuaternion:
+			SkinningQDEF(batch, job.m_begin, job.m_end, frame);
+			break;
+		default:
+			break;
+		}
+
+		// UV morph.
+		for (uint32_t k = job.m_begin; k < job.m_end; k++)
+		{
+			const uint32_t vi = batch.m_vertexIndices[k];
+			frame.m_updateUVs[vi] = frame.m_uvs[vi] + glm::vec2(frame.m_morphUVs[vi].x, frame.m_morphUVs[vi].y);
+		}
+	}
+
+	template<int kBoneCount>
+	void PMXSkinning::SkinningBDEF(const Batch& batch, uint32_t begin, uint32_t end, const Frame& frame) const
+	{
+		const uint32_t* vertexIndices = batch.m_vertexIndices.data();
+		const glm::mat4* transforms = frame.m_transforms;
+
+		uint32_t k = begin;
+
+#if SABA_SKINNING_AVX2
+		// 8 vertices per loop in SoA, gather blend bone matrices by lane.
+		if constexpr (kBoneCount > 1)
+		{
+			const float* transformData = &transforms[0][0][0];
+			const float* positionData = &frame.m_positions[0].x;
+			const float* morphPositionData = &frame.m_morphPositions[0].x;
+			const float* normalData = &frame.m_normals[0].x;
+
+			for (; k + kKernelWidth <= end; k += kKernelWidth)
+			{
+				const __m256i vi = _mm256_loadu_si256((const __m256i*)(vertexIndices + k));
+				const __m256i vi3 = _mm256_add_epi32(_mm256_slli_epi32(vi, 1), vi);
+				const __m256i vi3y = _mm256_add_epi32(vi3, _mm256_set1_epi32(1));
+				const __m256i vi3z = _mm256_add_epi32(vi3, _mm256_set1_epi32(2));
+
+				const __m256 px = _mm256_add_ps(_mm256_i32gather_ps(positionData, vi3, 4), _mm256_i32gather_ps(morphPositionData, vi3, 4));
+				const __m256 py = _mm256_add_ps(_mm256_i32gather_ps(positionData, vi3y, 4), _mm256_i32gather_ps(morphPositionData, vi3y, 4));
+				const __m256 pz = _mm256_add_ps(_mm256_i32gather_ps(positionData, vi3z, 4), _mm256_i32gather_ps(morphPositionData, vi3z, 4));
+				const __m256 nx = _mm256_i32gather_ps(normalData, vi3, 4);
+				const __m256 ny = _mm256_i32gather_ps(normalData, vi3y, 4);
+				const __m256 nz = _mm256_i32gather_ps(normalData, vi3z, 4);
+
+				// Affine 3x4 part of blend matrix, m[column * 3 + row].
+				__m256 m[12];
+				for (int s = 0; s < kBoneCount; s++)
+				{
+					const __m256i bi = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i*)(batch.m_boneIndices[s].data() + k)), 4);
+					const __m256 w = _mm256_loadu_ps(batch.m_boneWeights[s].data() + k);
+
+					for (int c = 0; c < 4; c++)
+					{
+						for (int r = 0; r < 3; r++)
+						{
+							const __m256 e = _mm256_i32gather_ps(transformData, _mm256_add_epi32(bi, _mm256_set1_epi32(c * 4 + r)), 4);
+							m[c * 3 + r] = (s == 0) ? _mm256_mul_ps(e, w) : _mm256_add_ps(m[c * 3 + r], _mm256_mul_ps(e, w));
+						}
+					}
+				}
+
+				alignas(32) float result[6][kKernelWidth];
+				for (int r = 0; r < 3; r++)
+				{
+					const __m256 pos = _mm256_add_ps(
+						_mm256_add_ps(_mm256_mul_ps(m[0 + r], px), _mm256_mul_ps(m[3 + r], py)),
+						_mm256_add_ps(_mm256_mul_ps(m[6 + r], pz), m[9 + r]));
+					_mm256_store_ps(result[r], pos);
+				}
+
+				__m256 nor[3];
+				for (int r = 0; r < 3; r++)
+				{
+					nor[r] = _mm256_add_ps(
+						_mm256_add_ps(_mm256_mul_ps(m[0 + r], nx), _mm256_mul_ps(m[3 + r], ny)),
+						_mm256_mul_ps(m[6 + r], nz));
+				}
+				const __m256 len = _mm256_sqrt_ps(_mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(nor[0], nor[0]), _mm256_mul_ps(nor[1], nor[1])),
+					_mm256_mul_ps(nor[2], nor[2])));
+				for (int r = 0; r < 3; r++)
+				{
+					_mm256_store_ps(result[3 + r], _mm256_div_ps(nor[r], len));
+				}
+
+				for (size_t lane = 0; lane < kKernelWidth; lane++)
+				{
+					const uint32_t index = vertexIndices[k + lane];
+					frame.m_updatePositions[index] = glm::vec3(result[0][lane], result[1][lane], result[2][lane]);
+					frame.m_updateNormals[index] = glm::vec3(result[3][lane], result[4][lane], result[5][lane]);
+				}
+			}
+		}
+#endif
+
+		// Per vertex path, also handle AVX2 tail.
+		for (; k < end; k++)
+		{
+			const uint32_t vi = vertexIndices[k];
+			const glm::vec3 pos = LoadRestPosition(frame, vi);
+
+#if SABA_SKINNING_SSE
+			BlendMatrix m;
+			if constexpr (kBoneCount == 1)
+			{
+				BlendLoad(m, transforms[batch.m_boneIndices[0][k]]);
+			}
+			else
+			{
+				BlendInit(m, transforms[batch.m_boneIndices[0][k]], batch.m_boneWeights[0][k]);
+				for (int s = 1; s < kBoneCount; s++)
+				{
+					BlendAdd(m, transforms[batch.m_boneIndices[s][k]], batch.m_boneWeights[s][k]);
+				}
+			}
+#else
+			glm::mat4 m = transforms[batch.m_boneIndices[0][k]];
+			if constexpr (kBoneCount > 1)
+			{
+				m *= batch.m_boneWeights[0][k];
+				for (int s = 1; s < kBoneCount; s++)
+				{
+					m += transforms[batch.m_boneIndices[s][k]] * batch.m_boneWeights[s][k];
+				}
+			}
+#endif
+			StoreSkinned(m, pos, frame.m_normals[vi], frame.m_updatePositions[vi], frame.m_updateNormals[vi]);
+		}
+	}
+
+	void PMXSkinning::SkinningSDEF(const Batch& batch, uint32_t begin, uint32_t end, const Frame& frame) const
+	{
+		// https://github.com/powroupi/blender_mmd_tools/blob/dev_test/mmd_tools/core/sdef.py
+		const glm::mat4* transforms = frame.m_transforms;
+		for (uint32_t k = begin; k < end; k++)
+		{
+			const uint32_t vi = batch.m_vertexIndices[k];
+			const auto i0 = batch.m_boneIndices[0][k];
+			const auto i1 = batch.m_boneIndices[1][k];
+			const auto w0 = batch.m_boneWeights[0][k];
+			const auto w1 = batch.m_boneWeights[1][k];
+			const auto& center = batch.m_sdefC[k];
+			const auto& cr0 = batch.m_sdefR0[k];
+			const auto& cr1 = batch.m_sdefR1[k];
+
+			const auto pos = LoadRestPosition(frame, vi);
+			const auto rotMat = glm::mat3_cast(glm::slerp(frame.m_boneRotations[i0], frame.m_boneRotations[i1], w1));
+
+#if SABA_SKINNING_SSE
+			BlendMatrix m0;
+			BlendMatrix m1;
+			BlendLoad(m0, transforms[i0]);
+			BlendLoad(m1, transforms[i1]);
+
+			const __m128 blendCenter = _mm_add_ps(
+				_mm_mul_ps(TransformPoint(m0, cr0), _mm_set1_ps(w0)),
+				_mm_mul_ps(TransformPoint(m1, cr1), _mm_set1_ps(w1)));
+
+			frame.m_updatePositions[vi] = rotMat * (pos - center) + StoreVec3(blendCenter);
+#else
+			frame.m_updatePositions[vi] = rotMat * (pos - center)
+				+ glm::vec3(transforms[i0] * glm::vec4(cr0, 1)) * w0
+				+ glm::vec3(transforms[i1] * glm::vec4(cr1, 1)) * w1;
+#endif
+			frame.m_updateNormals[vi] = rotMat * frame.m_normals[vi];
+		}
+	}
+
+	void PMXSkinning::SkinningQDEF(const Batch& batch, uint32_t begin, uint32_t end, const Frame& frame) const
+	{
+		//
+		// Skinning with Dual Quaternions
+		// https://www.cs.utah.edu/~ladislav/dq/index.html
+		//
+		for (uint32_t k = begin; k < end; k++)
+		{
+			const uint32_t vi = batch.m_vertexIndices[k];
+
+			glm::dualquat blendDQ;
+#if SABA_SKINNING_SSE
+			const int32_t i0 = batch.m_boneIndices[0][k];
+			const __m128 real0 = _mm_loadu_ps(&m_boneDQReal[i0].x);
+
+			__m128 w = _mm_set1_ps(batch.m_boneWeights[0][k]);
+			__m128 real = _mm_mul_ps(real0, w);
+			__m128 dual = _mm_mul_ps(_mm_loadu_ps(&m_boneDQDual[i0].x), w);
+			for (int s = 1; s < 4; s++)
+			{
+				const int32_t bi = batch.m_boneIndices[s][k];
+				const __m128 reali = _mm_loadu_ps(&m_boneDQReal[bi].x);
+
+				// Flip to same hemisphere as first bone.
+				const float wi = batch.m_boneWeights[s][k];
+				w = _mm_set1_ps(Dot4(real0, reali) < 0.0f ? -wi : wi);
+
+				real = _mm_add_ps(real, _mm_mul_ps(reali, w));
+				dual = _mm_add_ps(dual, _mm_mul_ps(_mm_loadu_ps(&m_boneDQDual[bi].x), w));
+			}
+			_mm_storeu_ps(&blendDQ.real.x, real);
+			_mm_storeu_ps(&blendDQ.dual.x, dual);
+#else
+			const int32_t i0 = batch.m_boneIndices[0][k];
+			const float w0 = batch.m_boneWeights[0][k];
+			blendDQ = glm::dualquat(m_boneDQReal[i0] * w0, m_boneDQDual[i0] * w0);
+			for (int s = 1; s < 4; s++)
+			{
+				const int32_t bi = batch.m_boneIndices[s][k];
+				float wi = batch.m_boneWeights[s][k];
+				if (glm::dot(m_boneDQReal[i0], m_boneDQReal[bi]) < 0) { wi *= -1.0f; }
+
+				blendDQ.real += m_boneDQReal[bi] * wi;
+				blendDQ.dual += m_boneDQDual[bi] * wi;
+			}
+#endif
+			blendDQ = glm::normalize(blendDQ);
+
+			const glm::mat4 m = glm::transpose(glm::mat3x4_cast(blendDQ));
+			StoreSkinned(m, LoadRestPosition(frame, vi), frame.m_normals[vi], frame.m_updatePositions[vi], frame.m_updateNormals[vi]);
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#ifndef SABA_MODEL_MMD_PMXSKINNING_H_
+#define SABA_MODEL_MMD_PMXSKINNING_H_
+
+#include "PMXModel.h"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace saba
+{
+	// CPU skinning backend of PMXModel.
+	// Vertices are sorted by skinning type into SoA batches once when model load, and every batch is
+	// split into stable jobs which blend with SSE/AVX2 kernels on the engine threadpool every frame.
+	class PMXSkinning
+	{
+	public:
+		using SkinningType = PMXModel::SkinningType;
+		using VertexBoneInfo = PMXModel::VertexBoneInfo;
+
+		// Per frame skinning input and output, all vertex arrays index by original vertex index.
+		struct Frame
+		{
+			const glm::mat4*	m_transforms;
+			const glm::quat*	m_boneRotations; // Only required when exist SDEF vertices.
+
+			const glm::vec3*	m_positions;
+			const glm::vec3*	m_normals;
+			const glm::vec2*	m_uvs;
+			const glm::vec3*	m_morphPositions;
+			const glm::vec4*	m_morphUVs;
+
+			glm::vec3*	m_updatePositions;
+			glm::vec3*	m_updateNormals;
+			glm::vec2*	m_updateUVs;
+		};
+
+		// Build SoA batches and stable jobs, jobVertexCount will align to kernel width.
+		void Setup(const VertexBoneInfo* vtxInfos, size_t vertexCount, size_t jobVertexCount);
+		void Clear();
+
+		// Skinning all vertices, parallel on engine threadpool when exist more than one job.
+		void Update(const Frame& frame, size_t boneCount);
+
+		// Bone global rotations only used by SDEF, skip compute when no SDEF vertices.
+		bool NeedBoneRotations() const { return !m_batches[size_t(SkinningType::SDEF)].m_vertexIndices.empty(); }
+
+		size_t GetJobCount() const { return m_jobs.size(); }
+		size_t GetJobVertexCount() const { return m_jobVertexCount; }
+
+	private:
+		static constexpr size_t kSkinningTypeCount = size_t(SkinningType::DualQuaternion) + 1;
+
+		// SoA data of one skinning type, only the bone slots the type used are filled.
+		struct Batch
+		{
+			std::vector<uint32_t>	m_vertexIndices;
+			std::vector<int32_t>	m_boneIndices[4];
+			std::vector<float>		m_boneWeights[4];
+
+			// SDEF only.
+			std::vector<glm::vec3>	m_sdefC;
+			std::vector<glm::vec3>	m_sdefR0;
+			std::vector<glm::vec3>	m_sdefR1;
+		};
+
+		// One job is a [m_begin, m_end) range inside one batch.
+		struct Job
+		{
+			SkinningType	m_skinningType;
+			uint32_t		m_begin;
+			uint32_t		m_end;
+		};
+
+		void RunJob(const Job& job, const Frame& frame) const;
+
+		// BDEF1, BDEF2 and BDEF4 share one kernel, only the blend bone count diff.
+		template<int kBoneCount>
+		void SkinningBDEF(const Batch& batch, uint32_t begin, uint32_t end, const Frame& frame) const;
+		void SkinningSDEF(const Batch& batch, uint32_t begin, uint32_t end, const Frame& frame) const;
+		void SkinningQDEF(const Batch& batch, uint32_t begin, uint32_t end, const Frame& frame) const;
+
+		void UpdateBoneDualQuats(const Frame& frame, size_t boneCount);
+
+	private:
+		Batch				m_batches[kSkinningTypeCount];
+		std::vector<Job>	m_jobs;
+		size_t				m_jobVertexCount = 0;
+
+		// QDEF bone dual quaternions in SoA, update once per frame instead of per vertex.
+		std::vector<glm::quat>	m_boneDQReal;
+		std::vector<glm::quat>	m_boneDQDual;
+	};
+}
+
+#endif // !SABA_MODEL_MMD_PMXSKINNING_H_
@@ -123,18 +123,36 @@ namespace saba
 			return;
 		}
 
-		auto boundIt = FindBoundKey(m_keys, int32_t(t), m_startKeyIndex);
 		glm::vec3 vt;
 		glm::quat q;
+		Sample(t, &vt, &q);
+
+		if (weight == 1.0f)
+		{
+			m_node->SetAnimationRotate(q);
+			m_node->SetAnimationTranslate(vt);
+		}
+		else
+		{
+			auto baseQ = m_node->GetBaseAnimationRotate();
+			auto baseT = m_node->GetBaseAnimationTranslate();
+			m_node->SetAnimationRotate(glm::slerp(baseQ, q, weight));
+			m_node->SetAnimationTranslate(glm::mix(baseT, vt, weight));
+		}
+	}
+
+	void VMDNodeController::Sample(float t, glm::vec3* translate, glm::quat* rotate)
+	{
+		auto boundIt = FindBoundKey(m_keys, int32_t(t), m_startKeyIndex);
 		if (boundIt == std::end(m_keys))
 		{
-			vt = m_keys[m_keys.size() - 1].m_translate;
-			q = m_keys[m_keys.size() - 1].m_rotate;
+			*translate = m_keys[m_keys.size() - 1].m_translate;
+			*rotate = m_keys[m_keys.size() - 1].m_rotate;
 		}
 		else
 		{
-			vt = (*boundIt).m_translate;
-			q = (*boundIt).m_rotate;
+			*translate = (*boundIt).m_translate;
+			*rotate = (*boundIt).m_rotate;
 			if (boundIt != std::begin(m_keys))
 			{
 				const auto& key0 = *(boundIt - 1);
@@ -151,25 +169,12 @@ namespace saba
 				float tz_y = key0.m_tzBezier.EvalY(tz_x);
 				float rot_y = key0.m_rotBezier.EvalY(rot_x);
 
-				vt = glm::mix(key0.m_translate, key1.m_translate, glm::vec3(tx_y, ty_y, tz_y));
-				q = glm::slerp(key0.m_rotate, key1.m_rotate, rot_y);
+				*translate = glm::mix(key0.m_translate, key1.m_translate, glm::vec3(tx_y, ty_y, tz_y));
+				*rotate = glm::slerp(key0.m_rotate, key1.m_rotate, rot_y);
 
 				m_startKeyIndex = std::distance(m_keys.cbegin(), boundIt);
 			}
 		}
-
-		if (weight == 1.0f)
-		{
-			m_node->SetAnimationRotate(q);
-			m_node->SetAnimationTranslate(vt);
-		}
-		else
-		{
-			auto baseQ = m_node->GetBaseAnimationRotate();
-			auto baseT = m_node->GetBaseAnimationTranslate();
-			m_node->SetAnimationRotate(glm::slerp(baseQ, q, weight));
-			m_node->SetAnimationTranslate(glm::mix(baseT, vt, weight));
-		}
 	}
 
 	void VMDNodeController::SortKeys()
@@ -192,6 +197,14 @@ namespace saba
 	}
 
 	bool VMDAnimation::Add(const VMDFile & vmd)
+	{
+		VMDCookedFile cooked;
+		CookVMDFile(vmd, &cooked);
+
+		return Add(cooked);
+	}
+
+	bool VMDAnimation::Add(const VMDCookedFile & vmd)
 	{
 		// Node Controller
 		std::map<std::string, NodeControllerPtr> nodeCtrlMap;
@@ -203,7 +216,7 @@ namespace saba
 		m_nodeControllers.clear();
 		for (const auto& motion : vmd.m_motions)
 		{
-			std::string nodeName = motion.m_boneName.ToUtf8String();
+			const std::string& nodeName = vmd.m_names[motion.m_nameIndex];
 			auto findIt = nodeCtrlMap.find(nodeName);
 			VMDNodeController* nodeCtrl = nullptr;
 			if (findIt == std::end(nodeCtrlMap))
@@ -250,37 +263,34 @@ namespace saba
 		m_ikControllers.clear();
 		for (const auto& ik : vmd.m_iks)
 		{
-			for (const auto& ikInfo : ik.m_ikInfos)
+			const std::string& ikName = vmd.m_names[ik.m_nameIndex];
+			auto findIt = ikCtrlMap.find(ikName);
+			VMDIKController* ikCtrl = nullptr;
+			if (findIt == std::end(ikCtrlMap))
 			{
-				std::string ikName = ikInfo.m_name.ToUtf8String();
-				auto findIt = ikCtrlMap.find(ikName);
-				VMDIKController* ikCtrl = nullptr;
-				if (findIt == std::end(ikCtrlMap))
-				{
-					auto* ikSolver = m_model->GetIKManager()->GetMMDIKSolver(ikName);
-					if (ikSolver != nullptr)
-					{
-						auto val = std::make_pair(
-							ikName,
-							std::make_unique<VMDIKController>()
-						);
-						ikCtrl = val.second.get();
-						ikCtrl->SetIKSolver(ikSolver);
-						ikCtrlMap.emplace(std::move(val));
-					}
-				}
-				else
+				auto* ikSolver = m_model->GetIKManager()->GetMMDIKSolver(ikName);
+				if (ikSolver != nullptr)
 				{
-					ikCtrl = (*findIt).second.get();
+					auto val = std::make_pair(
+						ikName,
+						std::make_unique<VMDIKController>()
+					);
+					ikCtrl = val.second.get();
+					ikCtrl->SetIKSolver(ikSolver);
+					ikCtrlMap.emplace(std::move(val));
 				}
+			}
+			else
+			{
+				ikCtrl = (*findIt).second.get();
+			}
 
-				if (ikCtrl != nullptr)
-				{
-					VMDIKAnimationKey key;
-					key.m_time = int32_t(ik.m_frame);
-					key.m_enable = ikInfo.m_enable != 0;
-					ikCtrl->AddKey(key);
-				}
+			if (ikCtrl != nullptr)
+			{
+				VMDIKAnimationKey key;
+				key.m_time = int32_t(ik.m_frame);
+				key.m_enable = ik.m_enable != 0;
+				ikCtrl->AddKey(key);
 			}
 		}
 		m_ikControllers.reserve(ikCtrlMap.size());
@@ -301,7 +311,7 @@ namespace saba
 		m_morphControllers.clear();
 		for (const auto& morph : vmd.m_morphs)
 		{
-			std::string morphName = morph.m_blendShapeName.ToUtf8String();
+			const std::string& morphName = vmd.m_names[morph.m_nameIndex];
 			auto findIt = morphCtrlMap.find(morphName);
 			VMDMorphController* morphCtrl = nullptr;
 			if (findIt == std::end(morphCtrlMap))
@@ -344,12 +354,27 @@ namespace saba
 		return true;
 	}
 
+	bool VMDAnimation::Add(std::shared_ptr<const VMDBakedTracks> tracks)
+	{
+		auto baked = std::make_unique<VMDBakedAnimation>();
+		if (!baked->Create(m_model.get(), std::move(tracks)))
+		{
+			return false;
+		}
+		m_bakedAnimations.push_back(std::move(baked));
+
+		m_maxKeyTime = CalculateMaxKeyTime();
+
+		return true;
+	}
+
 	void VMDAnimation::Destroy()
 	{
 		m_model.reset();
 		m_nodeControllers.clear();
 		m_ikControllers.clear();
 		m_morphControllers.clear();
+		m_bakedAnimations.clear();
 		m_maxKeyTime = 0;
 	}
 
@@ -369,6 +394,11 @@ namespace saba
 		{
 			morphCtrl->Evaluate(t, weight);
 		}
+
+		for (auto& baked : m_bakedAnimations)
+		{
+			baked->Evaluate(t, weight);
+		}
 	}
 
 	void VMDAnimation::SyncPhysics(float t, int frameCount)
@@ -430,10 +460,15 @@ namespace saba
 			}
 		}
 
+		for (const auto& baked : m_bakedAnimations)
+		{
+			maxTime = std::max(maxTime, baked->GetMaxKeyTime());
+		}
+
 		return maxTime;
 	}
 
-	void VMDNodeAnimationKey::Set(const VMDMotion & motion)
+	void VMDNodeAnimationKey::Set(const VMDCookedMotion & motion)
 	{
 		m_time = int32_t(motion.m_frame);
 
@@ -473,6 +508,27 @@ namespace saba
 			return;
 		}
 
+		const bool enable = Sample(t);
+
+		if (weight == 1.0f)
+		{
+			m_ikSolver->Enable(enable);
+		}
+		else
+		{
+			if (weight < 1.0f)
+			{
+				m_ikSolver->Enable(m_ikSolver->GetBaseAnimationEnabled());
+			}
+			else
+			{
+				m_ikSolver->Enable(enable);
+			}
+		}
+	}
+
+	bool VMDIKController::Sample(float t)
+	{
 		auto boundIt = FindBoundKey(m_keys, int32_t(t), m_startKeyIndex);
 		bool enable = true;
 		if (boundIt == std::end(m_keys))
@@ -491,21 +547,7 @@ namespace saba
 			}
 		}
 
-		if (weight == 1.0f)
-		{
-			m_ikSolver->Enable(enable);
-		}
-		else
-		{
-			if (weight < 1.0f)
-			{
-				m_ikSolver->Enable(m_ikSolver->GetBaseAnimationEnabled());
-			}
-			else
-			{
-				m_ikSolver->Enable(enable);
-			}
-		}
+		return enable;
 	}
 
 	void VMDIKController::SortKeys()
@@ -540,6 +582,20 @@ namespace saba
 			return;
 		}
 
+		const float weight = Sample(t);
+
+		if (animWeight == 1.0f)
+		{
+			m_morph->SetWeight(weight);
+		}
+		else
+		{
+			m_morph->SetWeight(glm::mix(m_morph->GetBaseAnimationWeight(), weight, animWeight));
+		}
+	}
+
+	float VMDMorphController::Sample(float t)
+	{
 		float weight;
 		auto boundIt = FindBoundKey(m_keys, int32_t(t), m_startKeyIndex);
 		if (boundIt == std::end(m_keys))
@@ -562,14 +618,7 @@ namespace saba
 			}
 		}
 
-		if (animWeight == 1.0f)
-		{
-			m_morph->SetWeight(weight);
-		}
-		else
-		{
-			m_morph->SetWeight(glm::mix(m_morph->GetBaseAnimationWeight(), weight, animWeight));
-		}
+		return weight;
 	}
 
 	void VMDMorphController::SortKeys()
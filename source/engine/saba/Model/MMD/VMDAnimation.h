@@ -9,6 +9,7 @@
 #include "MMDModel.h"
 #include "MMDNode.h"
 #include "VMDFile.h"
+#include "VMDBakedAnimation.h"
 #include "MMDIkSolver.h"
 
 #include <vector>
@@ -34,7 +35,7 @@ namespace saba
 
 	struct VMDNodeAnimationKey
 	{
-		void Set(const VMDMotion& motion);
+		void Set(const VMDCookedMotion& motion);
 
 		int32_t		m_time;
 		glm::vec3	m_translate;
@@ -67,6 +68,9 @@ namespace saba
 
 		void SetNode(MMDNode* node);
 		void Evaluate(float t, float weight = 1.0f);
+
+		// Interpolate keys at time t without touch node, keys must not empty.
+		void Sample(float t, glm::vec3* translate, glm::quat* rotate);
 		
 		void AddKey(const KeyType& key)
 		{
@@ -93,6 +97,9 @@ namespace saba
 		void SetBlendKeyShape(MMDMorph* morph);
 		void Evaluate(float t, float weight = 1.0f);
 
+		// Interpolate keys at time t without touch morph, keys must not empty.
+		float Sample(float t);
+
 		void AddKey(const KeyType& key)
 		{
 			m_keys.push_back(key);
@@ -118,6 +125,9 @@ namespace saba
 		void SetIKSolver(MMDIkSolver* ikSolver);
 		void Evaluate(float t, float weight = 1.0f);
 
+		// Key enable state at time t, keys must not empty.
+		bool Sample(float t);
+
 		void AddKey(const KeyType& key)
 		{
 			m_keys.push_back(key);
@@ -140,6 +150,9 @@ namespace saba
 
 		bool Create(std::shared_ptr<MMDModel> model);
 		bool Add(const VMDFile& vmd);
+		bool Add(const VMDCookedFile& vmd);
+		// Baked tracks evaluate as one layer, names must not overlap with other added vmd.
+		bool Add(std::shared_ptr<const VMDBakedTracks> tracks);
 		void Destroy();
 
 		void Evaluate(float t, float weight = 1.0f);
@@ -155,11 +168,13 @@ namespace saba
 		using NodeControllerPtr = std::unique_ptr<VMDNodeController>;
 		using IKControllerPtr = std::unique_ptr<VMDIKController>;
 		using MorphControllerPtr = std::unique_ptr<VMDMorphController>;
+		using BakedAnimationPtr = std::unique_ptr<VMDBakedAnimation>;
 
 		std::shared_ptr<MMDModel>			m_model;
 		std::vector<NodeControllerPtr>		m_nodeControllers;
 		std::vector<IKControllerPtr>		m_ikControllers;
 		std::vector<MorphControllerPtr>		m_morphControllers;
+		std::vector<BakedAnimationPtr>		m_bakedAnimations;
 		uint32_t	m_maxKeyTime;
 	};
 
@@ -0,0 +1,523 @@
+#include "VMDBakedAnimation.h"
+#include "VMDAnimation.h"
+#include "MMDNode.h"
+#include "MMDMorph.h"
+#include "MMDIkSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+	#define SABA_VMD_BAKED_SSE 1
+	#include <immintrin.h>
+#else
+	#define SABA_VMD_BAKED_SSE 0
+#endif
+
+namespace saba
+{
+	namespace
+	{
+		constexpr float kUnorm16Max = 65535.0f;
+		constexpr float kSnorm16Max = 32767.0f;
+
+		uint16_t QuantizeUnorm16(float v, float minValue, float extent)
+		{
+			if (extent <= 0.0f)
+			{
+				return 0;
+			}
+			const float n = std::clamp((v - minValue) / extent, 0.0f, 1.0f);
+			return uint16_t(std::lround(n * kUnorm16Max));
+		}
+
+		int16_t QuantizeSnorm16(float v)
+		{
+			return int16_t(std::lround(std::clamp(v, -1.0f, 1.0f) * kSnorm16Max));
+		}
+
+		// out[i] = min[i] + scale[i] * lerp(a[i], b[i], alpha)
+		void LerpUnorm16(const uint16_t* a, const uint16_t* b, const float* minValue, const float* scale, float alpha, float* out, size_t count)
+		{
+			size_t i = 0;
+#if SABA_VMD_BAKED_SSE
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 va = _mm_set1_ps(alpha);
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m128i ia = _mm_loadu_si128((const __m128i*)(a + i));
+				const __m128i ib = _mm_loadu_si128((const __m128i*)(b + i));
+
+				const __m128 a0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(ia, zero));
+				const __m128 a1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(ia, zero));
+				const __m128 b0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(ib, zero));
+				const __m128 b1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(ib, zero));
+
+				const __m128 l0 = _mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(b0, a0), va));
+				const __m128 l1 = _mm_add_ps(a1, _mm_mul_ps(_mm_sub_ps(b1, a1), va));
+
+				_mm_storeu_ps(out + i + 0, _mm_add_ps(_mm_loadu_ps(minValue + i + 0), _mm_mul_ps(_mm_loadu_ps(scale + i + 0), l0)));
+				_mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_loadu_ps(minValue + i + 4), _mm_mul_ps(_mm_loadu_ps(scale + i + 4), l1)));
+			}
+#endif
+			for (; i < count; i++)
+			{
+				const float l = float(a[i]) + (float(b[i]) - float(a[i])) * alpha;
+				out[i] = minValue[i] + scale[i] * l;
+			}
+		}
+
+#if SABA_VMD_BAKED_SSE
+		inline __m128 Normalize4(__m128 v)
+		{
+			__m128 sq = _mm_mul_ps(v, v);
+			sq = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+			sq = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_div_ps(v, _mm_sqrt_ps(sq));
+		}
+#endif
+
+		// Normalized lerp of snorm16 xyzw quaternions, snorm scale cancel by normalize.
+		void NlerpSnorm16(const int16_t* a, const int16_t* b, float alpha, float* out, size_t quatCount)
+		{
+			size_t i = 0;
+#if SABA_VMD_BAKED_SSE
+			const __m128 va = _mm_set1_ps(alpha);
+			for (; i + 2 <= quatCount; i += 2)
+			{
+				const __m128i ia = _mm_loadu_si128((const __m128i*)(a + i * 4));
+				const __m128i ib = _mm_loadu_si128((const __m128i*)(b + i * 4));
+
+				// Sign extend int16 to int32.
+				const __m128 a0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(ia, ia), 16));
+				const __m128 a1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(ia, ia), 16));
+				const __m128 b0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(ib, ib), 16));
+				const __m128 b1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(ib, ib), 16));
+
+				_mm_storeu_ps(out + i * 4 + 0, Normalize4(_mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(b0, a0), va))));
+				_mm_storeu_ps(out + i * 4 + 4, Normalize4(_mm_add_ps(a1, _mm_mul_ps(_mm_sub_ps(b1, a1), va))));
+			}
+#endif
+			for (; i < quatCount; i++)
+			{
+				float q[4];
+				float lenSq = 0.0f;
+				for (size_t c = 0; c < 4; c++)
+				{
+					const float qa = float(a[i * 4 + c]);
+					q[c] = qa + (float(b[i * 4 + c]) - qa) * alpha;
+					lenSq += q[c] * q[c];
+				}
+
+				const float invLen = 1.0f / std::sqrt(lenSq);
+				for (size_t c = 0; c < 4; c++)
+				{
+					out[i * 4 + c] = q[c] * invLen;
+				}
+			}
+		}
+
+		// Split tracks to animated and constant, return track order animated first.
+		template<typename IsConstFunc>
+		std::vector<size_t> SortTracksAnimatedFirst(size_t trackCount, IsConstFunc&& isConst, uint32_t* outAnimatedCount)
+		{
+			std::vector<size_t> order;
+			order.reserve(trackCount);
+			for (size_t i = 0; i < trackCount; i++)
+			{
+				if (!isConst(i)) { order.push_back(i); }
+			}
+			*outAnimatedCount = uint32_t(order.size());
+			for (size_t i = 0; i < trackCount; i++)
+			{
+				if (isConst(i)) { order.push_back(i); }
+			}
+			return order;
+		}
+	} // namespace
+
+	bool VMDBakedTracks::IsValid() const
+	{
+		const size_t nodeCount = m_nodeNames.size();
+		const size_t morphCount = m_morphNames.size();
+		const size_t animNodes = m_animatedNodeCount;
+		const size_t animMorphs = m_animatedMorphCount;
+		const size_t samples = m_sampleCount;
+
+		return
+			m_samplesPerFrame > 0 && samples > 0 &&
+			animNodes <= nodeCount && animMorphs <= morphCount &&
+			m_translateMin.size() == animNodes * 3 &&
+			m_translateExtent.size() == animNodes * 3 &&
+			m_translates.size() == samples * animNodes * 3 &&
+			m_rotates.size() == samples * animNodes * 4 &&
+			m_constTranslates.size() == (nodeCount - animNodes) * 3 &&
+			m_constRotates.size() == (nodeCount - animNodes) * 4 &&
+			m_morphMin.size() == animMorphs &&
+			m_morphExtent.size() == animMorphs &&
+			m_morphWeights.size() == samples * animMorphs &&
+			m_constMorphWeights.size() == morphCount - animMorphs &&
+			m_ikEnables.size() == samples * m_ikNames.size();
+	}
+
+	void BakeVMDTracks(const VMDCookedFile& vmd, uint32_t samplesPerFrame, VMDBakedTracks* out)
+	{
+		*out = VMDBakedTracks();
+		samplesPerFrame = std::max(samplesPerFrame, 1u);
+
+		// Group keys by name into unbound controllers, so sample use exactly same interpolation as runtime.
+		std::map<uint32_t, VMDNodeController> nodeCtrls;
+		std::map<uint32_t, VMDMorphController> morphCtrls;
+		std::map<uint32_t, VMDIKController> ikCtrls;
+
+		int32_t maxKeyTime = 0;
+		for (const auto& motion : vmd.m_motions)
+		{
+			VMDNodeAnimationKey key;
+			key.Set(motion);
+			nodeCtrls[motion.m_nameIndex].AddKey(key);
+			maxKeyTime = std::max(maxKeyTime, key.m_time);
+		}
+		for (const auto& morph : vmd.m_morphs)
+		{
+			VMDMorphAnimationKey key;
+			key.m_time = int32_t(morph.m_frame);
+			key.m_weight = morph.m_weight;
+			morphCtrls[morph.m_nameIndex].AddKey(key);
+			maxKeyTime = std::max(maxKeyTime, key.m_time);
+		}
+		for (const auto& ik : vmd.m_iks)
+		{
+			VMDIKAnimationKey key;
+			key.m_time = int32_t(ik.m_frame);
+			key.m_enable = ik.m_enable != 0;
+			ikCtrls[ik.m_nameIndex].AddKey(key);
+			maxKeyTime = std::max(maxKeyTime, key.m_time);
+		}
+
+		const size_t sampleCount = size_t(maxKeyTime) * samplesPerFrame + 1;
+		out->m_samplesPerFrame = samplesPerFrame;
+		out->m_sampleCount = uint32_t(sampleCount);
+		out->m_maxKeyTime = maxKeyTime;
+
+		auto sampleTime = [&](size_t s) { return float(s) / float(samplesPerFrame); };
+
+		// Node tracks.
+		{
+			std::vector<uint32_t> nameIndices;
+			std::vector<std::vector<glm::vec3>> translates;
+			std::vector<std::vector<glm::quat>> rotates;
+			for (auto& [nameIndex, ctrl] : nodeCtrls)
+			{
+				ctrl.SortKeys();
+
+				auto& trackT = translates.emplace_back(sampleCount);
+				auto& trackR = rotates.emplace_back(sampleCount);
+				for (size_t s = 0; s < sampleCount; s++)
+				{
+					ctrl.Sample(sampleTime(s), &trackT[s], &trackR[s]);
+
+					// Keep neighbor samples in same hemisphere, so runtime nlerp take short path.
+					if (s > 0 && glm::dot(trackR[s - 1], trackR[s]) < 0.0f)
+					{
+						trackR[s] = -trackR[s];
+					}
+				}
+				nameIndices.push_back(nameIndex);
+			}
+
+			auto isConst = [&](size_t i)
+			{
+				for (size_t s = 1; s < sampleCount; s++)
+				{
+					if (translates[i][s] != translates[i][0] || rotates[i][s] != rotates[i][0]) { return false; }
+				}
+				return true;
+			};
+			const auto order = SortTracksAnimatedFirst(nameIndices.size(), isConst, &out->m_animatedNodeCount);
+
+			const size_t animCount = out->m_animatedNodeCount;
+			out->m_translateMin.resize(animCount * 3);
+			out->m_translateExtent.resize(animCount * 3);
+			out->m_translates.resize(sampleCount * animCount * 3);
+			out->m_rotates.resize(sampleCount * animCount * 4);
+			for (size_t k = 0; k < order.size(); k++)
+			{
+				const size_t track = order[k];
+				out->m_nodeNames.push_back(vmd.m_names[nameIndices[track]]);
+
+				const auto& trackT = translates[track];
+				const auto& trackR = rotates[track];
+				if (k >= animCount)
+				{
+					out->m_constTranslates.insert(out->m_constTranslates.end(), { trackT[0].x, trackT[0].y, trackT[0].z });
+					out->m_constRotates.insert(out->m_constRotates.end(), { trackR[0].x, trackR[0].y, trackR[0].z, trackR[0].w });
+					continue;
+				}
+
+				for (size_t c = 0; c < 3; c++)
+				{
+					float minValue = trackT[0][c];
+					float maxValue = trackT[0][c];
+					for (const auto& t : trackT)
+					{
+						minValue = std::min(minValue, t[c]);
+						maxValue = std::max(maxValue, t[c]);
+					}
+					out->m_translateMin[k * 3 + c] = minValue;
+					out->m_translateExtent[k * 3 + c] = maxValue - minValue;
+				}
+
+				for (size_t s = 0; s < sampleCount; s++)
+				{
+					uint16_t* dstT = &out->m_translates[(s * animCount + k) * 3];
+					for (size_t c = 0; c < 3; c++)
+					{
+						dstT[c] = QuantizeUnorm16(trackT[s][c], out->m_translateMin[k * 3 + c], out->m_translateExtent[k * 3 + c]);
+					}
+
+					int16_t* dstR = &out->m_rotates[(s * animCount + k) * 4];
+					dstR[0] = QuantizeSnorm16(trackR[s].x);
+					dstR[1] = QuantizeSnorm16(trackR[s].y);
+					dstR[2] = QuantizeSnorm16(trackR[s].z);
+					dstR[3] = QuantizeSnorm16(trackR[s].w);
+				}
+			}
+		}
+
+		// Morph tracks.
+		{
+			std::vector<uint32_t> nameIndices;
+			std::vector<std::vector<float>> weights;
+			for (auto& [nameIndex, ctrl] : morphCtrls)
+			{
+				ctrl.SortKeys();
+
+				auto& track = weights.emplace_back(sampleCount);
+				for (size_t s = 0; s < sampleCount; s++)
+				{
+					track[s] = ctrl.Sample(sampleTime(s));
+				}
+				nameIndices.push_back(nameIndex);
+			}
+
+			auto isConst = [&](size_t i)
+			{
+				return std::all_of(weights[i].begin(), weights[i].end(), [&](float w) { return w == weights[i][0]; });
+			};
+			const auto order = SortTracksAnimatedFirst(nameIndices.size(), isConst, &out->m_animatedMorphCount);
+
+			const size_t animCount = out->m_animatedMorphCount;
+			out->m_morphMin.resize(animCount);
+			out->m_morphExtent.resize(animCount);
+			out->m_morphWeights.resize(sampleCount * animCount);
+			for (size_t k = 0; k < order.size(); k++)
+			{
+				const size_t track = order[k];
+				out->m_morphNames.push_back(vmd.m_names[nameIndices[track]]);
+
+				const auto& weight = weights[track];
+				if (k >= animCount)
+				{
+					out->m_constMorphWeights.push_back(weight[0]);
+					continue;
+				}
+
+				const auto [minIt, maxIt] = std::minmax_element(weight.begin(), weight.end());
+				out->m_morphMin[k] = *minIt;
+				out->m_morphExtent[k] = *maxIt - *minIt;
+				for (size_t s = 0; s < sampleCount; s++)
+				{
+					out->m_morphWeights[s * animCount + k] = QuantizeUnorm16(weight[s], out->m_morphMin[k], out->m_morphExtent[k]);
+				}
+			}
+		}
+
+		// Ik tracks.
+		{
+			const size_t ikCount = ikCtrls.size();
+			out->m_ikEnables.resize(sampleCount * ikCount);
+
+			size_t k = 0;
+			for (auto& [nameIndex, ctrl] : ikCtrls)
+			{
+				ctrl.SortKeys();
+				out->m_ikNames.push_back(vmd.m_names[nameIndex]);
+				for (size_t s = 0; s < sampleCount; s++)
+				{
+					out->m_ikEnables[s * ikCount + k] = ctrl.Sample(sampleTime(s)) ? 1 : 0;
+				}
+				k++;
+			}
+		}
+	}
+
+	bool VMDBakedAnimation::Create(MMDModel* model, std::shared_ptr<const VMDBakedTracks> tracks)
+	{
+		if (model == nullptr || tracks == nullptr || !tracks->IsValid())
+		{
+			return false;
+		}
+		m_tracks = std::move(tracks);
+
+		m_nodes.clear();
+		for (const auto& name : m_tracks->m_nodeNames)
+		{
+			m_nodes.push_back(model->GetNodeManager()->GetMMDNode(name));
+		}
+
+		m_morphs.clear();
+		for (const auto& name : m_tracks->m_morphNames)
+		{
+			m_morphs.push_back(model->GetMorphManager()->GetMorph(name));
+		}
+
+		m_ikSolvers.clear();
+		for (const auto& name : m_tracks->m_ikNames)
+		{
+			m_ikSolvers.push_back(model->GetIKManager()->GetMMDIKSolver(name));
+		}
+
+		m_translateScale.resize(m_tracks->m_translateExtent.size());
+		for (size_t i = 0; i < m_translateScale.size(); i++)
+		{
+			m_translateScale[i] = m_tracks->m_translateExtent[i] / kUnorm16Max;
+		}
+
+		m_morphScale.resize(m_tracks->m_morphExtent.size());
+		for (size_t i = 0; i < m_morphScale.size(); i++)
+		{
+			m_morphScale[i] = m_tracks->m_morphExtent[i] / kUnorm16Max;
+		}
+
+		m_translates.resize(m_tracks->GetAnimatedNodeCount() * 3);
+		m_rotates.resize(m_tracks->GetAnimatedNodeCount() * 4);
+		m_morphWeights.resize(m_tracks->GetAnimatedMorphCount());
+
+		return true;
+	}
+
+	void VMDBakedAnimation::Evaluate(float t, float weight)
+	{
+		if (m_tracks == nullptr)
+		{
+			return;
+		}
+
+		const auto& tracks = *m_tracks;
+
+		// Clamp to track range same as controller hold first and last key.
+		const size_t lastSample = tracks.m_sampleCount - 1;
+		const float f = std::clamp(t * float(tracks.m_samplesPerFrame), 0.0f, float(lastSample));
+		const size_t s0 = std::min(size_t(f), lastSample);
+		const size_t s1 = std::min(s0 + 1, lastSample);
+		const float alpha = f - float(s0);
+
+		// Dequantize and blend two sample rows of all animated tracks.
+		const size_t animNodes = tracks.GetAnimatedNodeCount();
+		if (animNodes > 0)
+		{
+			LerpUnorm16(
+				&tracks.m_translates[s0 * animNodes * 3],
+				&tracks.m_translates[s1 * animNodes * 3],
+				tracks.m_translateMin.data(),
+				m_translateScale.data(),
+				alpha,
+				m_translates.data(),
+				animNodes * 3);
+
+			NlerpSnorm16(
+				&tracks.m_rotates[s0 * animNodes * 4],
+				&tracks.m_rotates[s1 * animNodes * 4],
+				alpha,
+				m_rotates.data(),
+				animNodes);
+		}
+
+		const size_t animMorphs = tracks.GetAnimatedMorphCount();
+		if (animMorphs > 0)
+		{
+			LerpUnorm16(
+				&tracks.m_morphWeights[s0 * animMorphs],
+				&tracks.m_morphWeights[s1 * animMorphs],
+				tracks.m_morphMin.data(),
+				m_morphScale.data(),
+				alpha,
+				m_morphWeights.data(),
+				animMorphs);
+		}
+
+		for (size_t i = 0; i < m_nodes.size(); i++)
+		{
+			if (m_nodes[i] == nullptr)
+			{
+				continue;
+			}
+
+			if (i < animNodes)
+			{
+				ApplyNode(m_nodes[i], &m_translates[i * 3], &m_rotates[i * 4], weight);
+			}
+			else
+			{
+				const size_t c = i - animNodes;
+				ApplyNode(m_nodes[i], &tracks.m_constTranslates[c * 3], &tracks.m_constRotates[c * 4], weight);
+			}
+		}
+
+		for (size_t i = 0; i < m_morphs.size(); i++)
+		{
+			if (m_morphs[i] == nullptr)
+			{
+				continue;
+			}
+
+			const float value = (i < animMorphs) ? m_morphWeights[i] : tracks.m_constMorphWeights[i - animMorphs];
+			ApplyMorph(m_morphs[i], value, weight);
+		}
+
+		// Ik step key use floor sample, same as controller use int frame.
+		const size_t ikCount = tracks.GetIkCount();
+		for (size_t i = 0; i < ikCount; i++)
+		{
+			auto* ikSolver = m_ikSolvers[i];
+			if (ikSolver == nullptr)
+			{
+				continue;
+			}
+
+			const bool enable = tracks.m_ikEnables[s0 * ikCount + i] != 0;
+			ikSolver->Enable(weight < 1.0f ? ikSolver->GetBaseAnimationEnabled() : enable);
+		}
+	}
+
+	void VMDBakedAnimation::ApplyNode(MMDNode* node, const float* translate, const float* rotate, float weight) const
+	{
+		const glm::vec3 vt(translate[0], translate[1], translate[2]);
+		const glm::quat q(rotate[3], rotate[0], rotate[1], rotate[2]);
+
+		if (weight == 1.0f)
+		{
+			node->SetAnimationRotate(q);
+			node->SetAnimationTranslate(vt);
+		}
+		else
+		{
+			node->SetAnimationRotate(glm::slerp(node->GetBaseAnimationRotate(), q, weight));
+			node->SetAnimationTranslate(glm::mix(node->GetBaseAnimationTranslate(), vt, weight));
+		}
+	}
+
+	void VMDBakedAnimation::ApplyMorph(MMDMorph* morph, float value, float weight) const
+	{
+		if (weight == 1.0f)
+		{
+			morph->SetWeight(value);
+		}
+		else
+		{
+			morph->SetWeight(glm::mix(morph->GetBaseAnimationWeight(), value, weight));
+		}
+	}
+}
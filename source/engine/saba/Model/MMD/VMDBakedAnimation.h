@@ -0,0 +1,112 @@
+#ifndef SABA_MODEL_MMD_VMDBAKEDANIMATION_H_
+#define SABA_MODEL_MMD_VMDBAKEDANIMATION_H_
+
+#include "MMDModel.h"
+#include "VMDFile.h"
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+namespace saba
+{
+	class MMDNode;
+	class MMDMorph;
+	class MMDIkSolver;
+
+	// Fixed rate resampled curves of one vmd, model independent so can bake once and cache in asset.
+	// Samples store sample major (all tracks of one sample contiguous), so evaluate only stream two rows.
+	// Tracks with only one value split out as constant, most bones of a dance motion never move.
+	struct VMDBakedTracks
+	{
+		// Vmd frame is 1/30 second, sample time is sampleIndex / m_samplesPerFrame.
+		uint32_t	m_samplesPerFrame = 0;
+
+		// Samples per animated track, last sample is at max key time.
+		uint32_t	m_sampleCount = 0;
+		int32_t		m_maxKeyTime = 0;
+
+		// First m_animatedNodeCount names are animated tracks, others are constant tracks.
+		std::vector<std::string>	m_nodeNames;
+		uint32_t					m_animatedNodeCount = 0;
+
+		// Translate quantize to unorm16 in per component range, 3 components per animated node.
+		std::vector<float>		m_translateMin;
+		std::vector<float>		m_translateExtent;
+		std::vector<uint16_t>	m_translates;
+
+		// Rotate quantize to snorm16 xyzw, neighbor samples keep same hemisphere so nlerp is safe.
+		std::vector<int16_t>	m_rotates;
+
+		// Constant node tracks, float xyz and xyzw.
+		std::vector<float>		m_constTranslates;
+		std::vector<float>		m_constRotates;
+
+		// First m_animatedMorphCount names are animated tracks, others are constant tracks.
+		std::vector<std::string>	m_morphNames;
+		uint32_t					m_animatedMorphCount = 0;
+
+		// Morph weight quantize to unorm16 in per track range.
+		std::vector<float>		m_morphMin;
+		std::vector<float>		m_morphExtent;
+		std::vector<uint16_t>	m_morphWeights;
+		std::vector<float>		m_constMorphWeights;
+
+		// Ik enable is step key, no interpolation and no quantize.
+		std::vector<std::string>	m_ikNames;
+		std::vector<uint8_t>		m_ikEnables;
+
+		size_t GetAnimatedNodeCount() const { return m_animatedNodeCount; }
+		size_t GetConstNodeCount() const { return m_nodeNames.size() - m_animatedNodeCount; }
+		size_t GetAnimatedMorphCount() const { return m_animatedMorphCount; }
+		size_t GetConstMorphCount() const { return m_morphNames.size() - m_animatedMorphCount; }
+		size_t GetIkCount() const { return m_ikNames.size(); }
+
+		// Array sizes match counts, call after load from untrusted file.
+		bool IsValid() const;
+	};
+
+	// Resample keys of cooked vmd with same interpolation as VMDAnimation controllers.
+	void BakeVMDTracks(const VMDCookedFile& vmd, uint32_t samplesPerFrame, VMDBakedTracks* out);
+
+	// Bind baked tracks to model, evaluate dequantize and blend all tracks with SIMD in one array pass.
+	class VMDBakedAnimation
+	{
+	public:
+		bool Create(MMDModel* model, std::shared_ptr<const VMDBakedTracks> tracks);
+
+		void Evaluate(float t, float weight = 1.0f);
+
+		int32_t GetMaxKeyTime() const { return m_tracks ? m_tracks->m_maxKeyTime : 0; }
+
+		const std::vector<std::string>& GetNodeNames() const { return m_tracks->m_nodeNames; }
+		const std::vector<std::string>& GetMorphNames() const { return m_tracks->m_morphNames; }
+		const std::vector<std::string>& GetIkNames() const { return m_tracks->m_ikNames; }
+
+	private:
+		void ApplyNode(MMDNode* node, const float* translate, const float* rotate, float weight) const;
+		void ApplyMorph(MMDMorph* morph, float value, float weight) const;
+
+	private:
+		std::shared_ptr<const VMDBakedTracks> m_tracks;
+
+		// Bind result per track, nullptr when model no exist the name.
+		std::vector<MMDNode*>		m_nodes;
+		std::vector<MMDMorph*>		m_morphs;
+		std::vector<MMDIkSolver*>	m_ikSolvers;
+
+		// Dequantize scale = extent / 65535, precompute when bind.
+		std::vector<float>	m_translateScale;
+		std::vector<float>	m_morphScale;
+
+		// Evaluate scratch.
+		std::vector<float>	m_translates;
+		std::vector<float>	m_rotates;
+		std::vector<float>	m_morphWeights;
+	};
+}
+
+#endif // !SABA_MODEL_MMD_VMDBAKEDANIMATION_H_
@@ -110,10 +110,20 @@ namespace saba
 
 	bool VMDCameraAnimation::Create(const VMDFile& vmd)
 	{
-		if (!vmd.m_cameras.empty())
+		return Create(vmd.m_cameras);
+	}
+
+	bool VMDCameraAnimation::Create(const VMDCookedFile& vmd)
+	{
+		return Create(vmd.m_cameras);
+	}
+
+	bool VMDCameraAnimation::Create(const std::vector<VMDCamera>& cameras)
+	{
+		if (!cameras.empty())
 		{
 			m_cameraController = std::make_unique<VMDCameraController>();
-			for (const auto& cam : vmd.m_cameras)
+			for (const auto& cam : cameras)
 			{
 				VMDCameraAnimationKey key;
 				key.m_time = int32_t(cam.m_frame);
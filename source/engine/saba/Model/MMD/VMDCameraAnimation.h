@@ -58,6 +58,8 @@ namespace saba
 		VMDCameraAnimation();
 
 		bool Create(const VMDFile& vmd);
+		bool Create(const VMDCookedFile& vmd);
+		bool Create(const std::vector<VMDCamera>& cameras);
 		void Destroy();
 
 		void Evaluate(float t);
@@ -8,17 +8,20 @@
 #include <Saba/Base/Log.h>
 #include <Saba/Base/File.h>
 
+#include <util/mapped_file.h>
+#include <utf8/cpp17.h>
+
 namespace saba
 {
 	namespace
 	{
 		template <typename T>
-		bool Read(T* val, File& file)
+		bool Read(T* val, BufferReader& file)
 		{
 			return file.Read(val);
 		}
 
-		bool ReadHeader(VMDFile* vmd, File& file)
+		bool ReadHeader(VMDFile* vmd, BufferReader& file)
 		{
 			Read(&vmd->m_header.m_header, file);
 			Read(&vmd->m_header.m_modelName, file);
@@ -34,7 +37,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadMotion(VMDFile* vmd, File& file)
+		bool ReadMotion(VMDFile* vmd, BufferReader& file)
 		{
 			uint32_t motionCount = 0;
 			if (!Read(&motionCount, file))
@@ -55,7 +58,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadBlednShape(VMDFile* vmd, File& file)
+		bool ReadBlednShape(VMDFile* vmd, BufferReader& file)
 		{
 			uint32_t blendShapeCount = 0;
 			if (!Read(&blendShapeCount, file))
@@ -74,7 +77,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadCamera(VMDFile* vmd, File& file)
+		bool ReadCamera(VMDFile* vmd, BufferReader& file)
 		{
 			uint32_t cameraCount = 0;
 			if (!Read(&cameraCount, file))
@@ -97,7 +100,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadLight(VMDFile* vmd, File& file)
+		bool ReadLight(VMDFile* vmd, BufferReader& file)
 		{
 			uint32_t lightCount = 0;
 			if (!Read(&lightCount, file))
@@ -116,7 +119,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadShadow(VMDFile* vmd, File& file)
+		bool ReadShadow(VMDFile* vmd, BufferReader& file)
 		{
 			uint32_t shadowCount = 0;
 			if (!Read(&shadowCount, file))
@@ -135,7 +138,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadIK(VMDFile* vmd, File& file)
+		bool ReadIK(VMDFile* vmd, BufferReader& file)
 		{
 			uint32_t ikCount = 0;
 			if (!Read(&ikCount, file))
@@ -164,7 +167,7 @@ namespace saba
 			return !file.IsBad();
 		}
 
-		bool ReadVMDFile(VMDFile* vmd, File& file)
+		bool ReadVMDFile(VMDFile* vmd, BufferReader& file)
 		{
 			if (!ReadHeader(vmd, file))
 			{
@@ -229,14 +232,70 @@ namespace saba
 
 	bool ReadVMDFile(VMDFile * vmd, const char * filename)
 	{
-		File file;
-		if (!file.Open(filename))
+		engine::MappedFile mappedFile;
+		if (!mappedFile.open(std::filesystem::path(utf8::utf8to16(filename))))
 		{
 			SABA_WARN("VMD File Open Fail. {}", filename);
 			return false;
 		}
 
+		BufferReader file(mappedFile.getData(), mappedFile.getSize());
 		return ReadVMDFile(vmd, file);
 	}
 
+	void CookVMDFile(const VMDFile& vmd, VMDCookedFile* cooked)
+	{
+		*cooked = {};
+
+		// Same sjis name repeat in every key, only convert first time.
+		std::unordered_map<std::string, uint32_t> nameIndexMap;
+		auto requireNameIndex = [&](const char* sjisName)
+		{
+			auto [it, inserted] = nameIndexMap.try_emplace(sjisName, (uint32_t)cooked->m_names.size());
+			if (inserted)
+			{
+				std::u16string u16Str = ConvertSjisToU16String(sjisName);
+				std::string u8Str;
+				ConvU16ToU8(u16Str, u8Str);
+				cooked->m_names.push_back(std::move(u8Str));
+			}
+			return it->second;
+		};
+
+		cooked->m_motions.reserve(vmd.m_motions.size());
+		for (const auto& motion : vmd.m_motions)
+		{
+			VMDCookedMotion cookedMotion;
+			cookedMotion.m_nameIndex = requireNameIndex(motion.m_boneName.ToCString());
+			cookedMotion.m_frame = motion.m_frame;
+			cookedMotion.m_translate = motion.m_translate;
+			cookedMotion.m_quaternion = motion.m_quaternion;
+			cookedMotion.m_interpolation = motion.m_interpolation;
+			cooked->m_motions.push_back(cookedMotion);
+		}
+
+		cooked->m_morphs.reserve(vmd.m_morphs.size());
+		for (const auto& morph : vmd.m_morphs)
+		{
+			VMDCookedMorph cookedMorph;
+			cookedMorph.m_nameIndex = requireNameIndex(morph.m_blendShapeName.ToCString());
+			cookedMorph.m_frame = morph.m_frame;
+			cookedMorph.m_weight = morph.m_weight;
+			cooked->m_morphs.push_back(cookedMorph);
+		}
+
+		for (const auto& ik : vmd.m_iks)
+		{
+			for (const auto& ikInfo : ik.m_ikInfos)
+			{
+				VMDCookedIk cookedIk;
+				cookedIk.m_nameIndex = requireNameIndex(ikInfo.m_name.ToCString());
+				cookedIk.m_frame = ik.m_frame;
+				cookedIk.m_enable = ikInfo.m_enable;
+				cooked->m_iks.push_back(cookedIk);
+			}
+		}
+
+		cooked->m_cameras = vmd.m_cameras;
+	}
 }
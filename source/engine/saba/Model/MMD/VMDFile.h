@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <vector>
 #include <array>
+#include <unordered_map>
 
 #include <glm/vec3.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -93,6 +94,41 @@ namespace saba
 	};
 
 	bool ReadVMDFile(VMDFile* vmd, const char* filename);
+
+	// Cooked vmd, sjis names convert to utf8 name table once, keys refer name by index.
+	struct VMDCookedMotion
+	{
+		uint32_t		m_nameIndex;
+		uint32_t		m_frame;
+		glm::vec3		m_translate;
+		glm::quat		m_quaternion;
+		std::array<uint8_t, 64>	m_interpolation;
+	};
+
+	struct VMDCookedMorph
+	{
+		uint32_t	m_nameIndex;
+		uint32_t	m_frame;
+		float		m_weight;
+	};
+
+	struct VMDCookedIk
+	{
+		uint32_t	m_nameIndex;
+		uint32_t	m_frame;
+		uint8_t		m_enable;
+	};
+
+	struct VMDCookedFile
+	{
+		std::vector<std::string>		m_names;
+		std::vector<VMDCookedMotion>	m_motions;
+		std::vector<VMDCookedMorph>		m_morphs;
+		std::vector<VMDCookedIk>		m_iks;
+		std::vector<VMDCamera>			m_cameras;
+	};
+
+	void CookVMDFile(const VMDFile& vmd, VMDCookedFile* cooked);
 }
 
 #endif // !SABA_MODEL_MMD_VMDFILE_H_
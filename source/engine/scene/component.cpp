@@ -23,4 +23,15 @@ namespace engine
 	{
 		m_node.lock()->getScene()->setDirty(true);
 	}
+
+	void Component::markRenderDirty()
+	{
+		if (auto node = m_node.lock())
+		{
+			if (auto scene = node->getScene())
+			{
+				scene->markRenderDirty(node->getId());
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -36,6 +36,9 @@ namespace engine
 		// Mark dirty.
 		void markDirty();
 
+		// Mark owner node's render proxy dirty, render scene will update it.
+		void markRenderDirty();
+
 	protected:
 		ARCHIVE_DECLARE;
 		
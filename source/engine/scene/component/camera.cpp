@@ -12,9 +12,9 @@ namespace engine
 			if (vmdAsset->m_bCamera)
 			{
 				auto vmdPath = vmdAsset->getVMDFilePath().string();
-				saba::VMDFile vmdFile;
+				saba::VMDCookedFile vmdFile;
 
-				if (!saba::ReadVMDFile(&vmdFile, vmdPath.c_str()))
+				if (!vmdAsset->loadVMD(vmdFile))
 				{
 					LOG_ERROR("Failed to read VMD file {0}.", vmdPath);
 					return;
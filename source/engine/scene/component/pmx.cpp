@@ -11,6 +11,38 @@
 
 namespace engine
 {
+	static AutoCVarBool cVarPMXComputeSkinning(
+		"r.PMX.ComputeSkinning",
+		"Enable pmx skinning in compute shader, cpu skinning only run when cpu positions requested.",
+		"PMX",
+		false,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarBool cVarPMXBakedVMD(
+		"r.PMX.BakedVMD",
+		"Evaluate vmd from baked fixed rate tracks instead of key search and bezier solve, vmd share track with other vmd still use keys.",
+		"PMX",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarPMXBakedVMDSamplesPerFrame(
+		"r.PMX.BakedVMDSamplesPerFrame",
+		"Baked vmd samples per vmd frame (1/30 second), change will re-bake when vmd rebuild.",
+		"PMX",
+		2,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarBool cVarPMXAnimationJob(
+		"r.PMX.AnimationJob",
+		"Update pmx vmd animation and physics step on threadpool, all pmx simulate parallel when render collect static mesh.",
+		"PMX",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
 	PMXComponent::~PMXComponent()
 	{
 		clearAudio();
@@ -73,6 +105,8 @@ namespace engine
 
 	void PMXComponent::tick(const RuntimeModuleTickData& tickData)
 	{
+		CPU_PROFILER_SCOPE("PMXComponent::tick");
+
 		if (!m_proxy && (!m_pmxUUID.empty()))
 		{
 			m_proxy = std::make_unique<PMXMeshProxy>(m_pmxUUID, m_vmdUUIDs);
@@ -96,6 +130,16 @@ namespace engine
 		}
 	}
 
+	void PMXComponent::kickAnimationJob(const RuntimeModuleTickData& tickData)
+	{
+		if (!cVarPMXAnimationJob.get() || !m_proxy || !m_proxy->isInit() || m_node.expired())
+		{
+			return;
+		}
+
+		m_proxy->kickAnimationJob(tickData.gameTime, tickData.deltaTime);
+	}
+
 	bool PMXComponent::setPMX(const UUID& in)
 	{
 		if (m_pmxUUID != in)
@@ -260,6 +304,8 @@ namespace engine
 		}
 
 
+		std::vector<std::shared_ptr<AssetVMD>> vmdAssets;
+		std::vector<saba::VMDCookedFile> vmdFiles;
 		for (const auto& vmdUUID : vmdUUIDs)
 		{
 			auto vmdAsset = std::dynamic_pointer_cast<AssetVMD>(getAssetSystem()->getAsset(vmdUUID));
@@ -269,8 +315,8 @@ namespace engine
 			}
 
 			auto vmdPath = vmdAsset->getVMDFilePath().string();
-			saba::VMDFile vmdFile;
-			if (!saba::ReadVMDFile(&vmdFile, vmdPath.c_str()))
+			saba::VMDCookedFile vmdFile;
+			if (!vmdAsset->loadVMD(vmdFile))
 			{
 				LOG_ERROR("Failed to read VMD file {0}.", vmdPath);
 				return false;
@@ -282,7 +328,40 @@ namespace engine
 				continue;
 			}
 
-			if (!m_vmd->Add(vmdFile))
+			vmdAssets.push_back(vmdAsset);
+			vmdFiles.push_back(std::move(vmdFile));
+		}
+
+		// Baked tracks evaluate as independent layer, vmd share any track with others must merge keys in controllers.
+		std::unordered_map<std::string, uint32_t> trackRefCount;
+		for (const auto& vmdFile : vmdFiles)
+		{
+			for (const auto& name : vmdFile.m_names)
+			{
+				trackRefCount[name]++;
+			}
+		}
+
+		const bool bBakedVMD = cVarPMXBakedVMD.get();
+		const uint32_t samplesPerFrame = (uint32_t)std::max(1, cVarPMXBakedVMDSamplesPerFrame.get());
+		for (size_t i = 0; i < vmdFiles.size(); i++)
+		{
+			auto vmdPath = vmdAssets[i]->getVMDFilePath().string();
+
+			const bool bIndependent = std::all_of(vmdFiles[i].m_names.begin(), vmdFiles[i].m_names.end(),
+				[&](const std::string& name) { return trackRefCount[name] == 1; });
+
+			if (bBakedVMD && bIndependent)
+			{
+				auto tracks = std::make_shared<saba::VMDBakedTracks>();
+				if (vmdAssets[i]->loadBakedVMD(samplesPerFrame, *tracks) && m_vmd->Add(std::move(tracks)))
+				{
+					continue;
+				}
+				LOG_WARN("Failed to use baked VMD {0}, fallback to keys.", vmdPath);
+			}
+
+			if (!m_vmd->Add(vmdFiles[i]))
 			{
 				LOG_ERROR("Failed to add VMDAnimation {0}.", vmdPath);
 				continue;
@@ -309,7 +388,7 @@ namespace engine
 				return;
 			}
 
-			if (!pmxModel->Load(pmxPath, "image/mmd"))
+			if (!pmxAsset->loadModel(*pmxModel))
 			{
 				LOG_ERROR("Failed to load pmx file {0}.", pmxPath);
 				return;
@@ -342,7 +421,8 @@ namespace engine
 			auto vbMemSizePositionLast = uint32_t(sizeof(glm::vec3) * pmxModel->GetVertexCount());
 
 
-			m_positionBuffer = std::make_unique<VulkanBuffer>(getContext(), pmxPath, bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, bufferFlagVMA, vbMemSizePosition);
+			// Position also copy source of prev frame positions when compute skinning.
+			m_positionBuffer = std::make_unique<VulkanBuffer>(getContext(), pmxPath, bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, bufferFlagVMA, vbMemSizePosition);
 			m_normalBuffer = std::make_unique<VulkanBuffer>(getContext(), pmxPath, bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, bufferFlagVMA, vbMemSizeNormal);
 			m_uvBuffer = std::make_unique<VulkanBuffer>(getContext(), pmxPath, bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, bufferFlagVMA, vbMemSizeUv);
 			m_positionPrevFrameBuffer = std::make_unique<VulkanBuffer>(getContext(), pmxPath, bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, bufferFlagVMA, vbMemSizePositionLast);
@@ -402,8 +482,132 @@ namespace engine
 		});
 	}
 
+	bool PMXMeshProxy::shouldComputeSkinning() const
+	{
+		return cVarPMXComputeSkinning.get();
+	}
+
+	const glm::vec3* PMXMeshProxy::getCPUPositions() const
+	{
+		if (m_bComputeSkinning && !m_bCPUPositionsRequested)
+		{
+			return nullptr;
+		}
+		return m_mmdModel->GetUpdatePositions();
+	}
+
+	void PMXMeshProxy::prepareComputeSkinning(VkCommandBuffer cmd)
+	{
+		if (m_bComputeSkinningPrepared)
+		{
+			return;
+		}
+
+		auto pmxModel = std::static_pointer_cast<saba::PMXModel>(m_mmdModel);
+		const auto vertexCount = pmxModel->GetVertexCount();
+		const std::string name = m_pmxAsset->getPMXFilePath().string();
+
+		// Pack rest pose and bone weights, only upload once.
+		std::vector<PMXSkinningGpuVertex> vertices(vertexCount);
+		{
+			const auto* positions = pmxModel->GetPositions();
+			const auto* normals = pmxModel->GetNormals();
+			const auto* uvs = pmxModel->GetUVs();
+			const auto* boneInfos = pmxModel->GetVertexBoneInfos();
+
+			for (size_t i = 0; i < vertexCount; i++)
+			{
+				const auto& info = boneInfos[i];
+				auto& vertex = vertices[i];
+
+				vertex.position = math::vec4(positions[i], uvs[i].x);
+				vertex.normal = math::vec4(normals[i], uvs[i].y);
+				vertex.boneIndices = math::ivec4(0);
+				vertex.boneWeights = math::vec4(0.0f);
+				vertex.sdefC = math::vec4(0.0f, 0.0f, 0.0f, float(info.m_skinningType));
+				vertex.sdefR0 = math::vec4(0.0f);
+				vertex.sdefR1 = math::vec4(0.0f);
+
+				if (info.m_skinningType == saba::PMXModel::SkinningType::SDEF)
+				{
+					m_bSkinningSDEF = true;
+
+					vertex.boneIndices = math::ivec4(info.m_sdef.m_boneIndex[0], info.m_sdef.m_boneIndex[1], 0, 0);
+					vertex.boneWeights = math::vec4(info.m_sdef.m_boneWeight, 1.0f - info.m_sdef.m_boneWeight, 0.0f, 0.0f);
+					vertex.sdefC = math::vec4(info.m_sdef.m_sdefC, vertex.sdefC.w);
+					vertex.sdefR0 = math::vec4(info.m_sdef.m_sdefR0, 0.0f);
+					vertex.sdefR1 = math::vec4(info.m_sdef.m_sdefR1, 0.0f);
+					continue;
+				}
+
+				m_bSkinningQDEF |= (info.m_skinningType == saba::PMXModel::SkinningType::DualQuaternion);
+
+				int32_t boneCount = 4;
+				switch (info.m_skinningType)
+				{
+				case saba::PMXModel::SkinningType::Weight1: boneCount = 1; break;
+				case saba::PMXModel::SkinningType::Weight2: boneCount = 2; break;
+				default: break;
+				}
+
+				for (int32_t j = 0; j < boneCount; j++)
+				{
+					// Unused bone slot store -1 index, keep bone 0 with zero weight.
+					if (info.m_boneIndex[j] >= 0)
+					{
+						vertex.boneIndices[j] = info.m_boneIndex[j];
+						vertex.boneWeights[j] = (boneCount == 1) ? 1.0f : info.m_boneWeight[j];
+					}
+				}
+			}
+		}
+
+		const auto usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		const auto vertexSize = uint32_t(sizeof(PMXSkinningGpuVertex) * vertexCount);
+		const auto boneSize = uint32_t(sizeof(PMXSkinningGpuBone) * std::max(pmxModel->GetBoneCount(), size_t(1)));
+		const auto morphPositionSize = uint32_t(sizeof(glm::vec3) * vertexCount);
+		const auto morphUVSize = uint32_t(sizeof(glm::vec4) * vertexCount);
+
+		m_skinningVertexBuffer = std::make_unique<VulkanBuffer>(getContext(), name, usage, VmaAllocationCreateFlags{}, vertexSize);
+		m_skinningBoneBuffer = std::make_unique<VulkanBuffer>(getContext(), name, usage, VmaAllocationCreateFlags{}, boneSize);
+		m_morphPositionBuffer = std::make_unique<VulkanBuffer>(getContext(), name, usage, VmaAllocationCreateFlags{}, morphPositionSize);
+		m_morphUVBuffer = std::make_unique<VulkanBuffer>(getContext(), name, usage, VmaAllocationCreateFlags{}, morphUVSize);
+
+		m_stageSkinningVertex = std::make_unique<VulkanBuffer>(getContext(), name, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanBuffer::getStageCopyForUploadBufferFlags(), vertexSize);
+		m_stageSkinningBone = std::make_unique<VulkanBuffer>(getContext(), name, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanBuffer::getStageCopyForUploadBufferFlags(), boneSize);
+		m_stageMorphPosition = std::make_unique<VulkanBuffer>(getContext(), name, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanBuffer::getStageCopyForUploadBufferFlags(), morphPositionSize);
+		m_stageMorphUV = std::make_unique<VulkanBuffer>(getContext(), name, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanBuffer::getStageCopyForUploadBufferFlags(), morphUVSize);
+
+		// Record upload in frame command, cvar may toggle at runtime so never submit immediately here.
+		m_stageSkinningVertex->copyAndUpload(cmd, vertices.data(), m_skinningVertexBuffer.get());
+
+		// Smooth normal is rest pose data, compute skinning path never update it per frame.
+		{
+			const auto smoothNormals = pmxModel->getUpdateSmoothNormals();
+			m_stageSmoothNormal->copyAndUpload(cmd, smoothNormals.data(), m_smoothNormalBuffer.get());
+		}
+
+		{
+			std::array<VkBufferMemoryBarrier2, 2> uploadBarriers
+			{
+				RHIBufferBarrier(m_skinningVertexBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT),
+				RHIBufferBarrier(m_smoothNormalBuffer->getVkBuffer(),
+					VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+					VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT),
+			};
+			RHIPipelineBarrier(cmd, 0, (uint32_t)uploadBarriers.size(), uploadBarriers.data(), 0, nullptr);
+		}
+
+		m_skinningBones.resize(pmxModel->GetBoneCount());
+		m_uploadedMorphVersion = ~0;
+		m_bComputeSkinningPrepared = true;
+	}
+
 	PMXMeshProxy::~PMXMeshProxy()
 	{
+		waitAnimationJob();
 		getContext()->waitDeviceIdle();
 
 		if (m_indicesBindless != ~0)
@@ -38,6 +38,39 @@ namespace engine
 		float pad1;
 	};
 
+	// Per submesh data of gpu driven pmx draw, persistent in render scene, see shader/pmx/pmx_common.glsl.
+	struct PMXGpuSubmesh
+	{
+		PMXGpuParams params;
+
+		// Index range inside model index buffer, vertex fetch by index so also draw vertex range.
+		uint32_t indexStart;
+		uint32_t indexCount;
+		uint32_t bTranslucent;
+		uint32_t pad0;
+	};
+
+	// Static per vertex input of pmx compute skinning, see shader/pmx/pmx_skinning.glsl.
+	struct PMXSkinningGpuVertex
+	{
+		math::vec4 position; // .w is uv.x
+		math::vec4 normal;   // .w is uv.y
+		math::ivec4 boneIndices;
+		math::vec4 boneWeights;
+		math::vec4 sdefC;    // .w is skinning type.
+		math::vec4 sdefR0;
+		math::vec4 sdefR1;
+	};
+
+	// Per frame per bone input of pmx compute skinning.
+	struct PMXSkinningGpuBone
+	{
+		math::mat4 transform;
+		math::vec4 rotation;
+		math::vec4 dqReal;
+		math::vec4 dqDual;
+	};
+
 	struct PMXInitTrait
 	{
 		std::string pmxPath;
@@ -56,15 +89,13 @@ namespace engine
 		bool isInit() const { return m_bInit; }
 
 
-		void onRenderCollect(
-			class RendererInterface* renderer,
-			VkCommandBuffer cmd,
-			VkPipelineLayout pipelinelayout,
-			const glm::mat4& modelMatrix,
-			const glm::mat4& modelMatrixPrev,
-			bool bTranslucentPass,
+		// Collect visible submeshes for gpu culling and indirect draw.
+		void collectSubmeshes(
+			std::vector<PMXGpuSubmesh>& collector,
 			uint32_t sceneNodeId,
-			bool bSelected);
+			bool bSelected,
+			const glm::mat4& modelMatrix,
+			const glm::mat4& modelMatrixPrev);
 
 		void collectObjectInfos(std::vector<GPUStaticMeshPerObjectData>& collector, std::vector<VkAccelerationStructureInstanceKHR>& asInstances, uint32_t sceneNodeId,
 			bool bSelected,
@@ -72,13 +103,29 @@ namespace engine
 			const glm::mat4& modelMatrixPrev);
 
 		void updateAnimation(float vmdFrameTime, float physicElapsed);
+
+		// Run updateAnimation (vmd evaluate and bullet step) on threadpool, model must not touch until wait.
+		void kickAnimationJob(float vmdFrameTime, float physicElapsed);
+
+		// Return false when no job kicked this frame.
+		bool waitAnimationJob();
+
 		void updateVertex(VkCommandBuffer cmd);
 		void updateBLAS(VkCommandBuffer cmd);
 
 		bool rebuildVMD(const std::vector<UUID>& vmdUUID);
 
-		
-		
+		// When skinning on GPU, CPU skinning only run when someone request skinned positions, eg. physics or picking.
+		void setCPUPositionsRequested(bool bRequested) { m_bCPUPositionsRequested = bRequested; }
+
+		// Return nullptr when CPU skinned positions is not valid this frame.
+		const glm::vec3* getCPUPositions() const;
+
+	private:
+		bool shouldComputeSkinning() const;
+		void prepareComputeSkinning(VkCommandBuffer cmd);
+		void updateVertexGPU(VkCommandBuffer cmd);
+
 	private:
 		bool m_bInit = false;
 		
@@ -104,10 +151,34 @@ namespace engine
 		uint32_t m_smoothNormalBindless = ~0;
 		uint32_t m_uvBindless = ~0;
 
+		// Compute skinning resources, lazy create when r.PMX.ComputeSkinning enable.
+		bool m_bComputeSkinningPrepared = false;
+		bool m_bComputeSkinning = false;
+		bool m_bCPUPositionsRequested = false;
+		bool m_bSkinningHistoryValid = false;
+		bool m_bSkinningSDEF = false;
+		bool m_bSkinningQDEF = false;
+		uint32_t m_uploadedMorphVersion = ~0;
+
+		std::unique_ptr<VulkanBuffer> m_skinningVertexBuffer = nullptr;
+		std::unique_ptr<VulkanBuffer> m_skinningBoneBuffer = nullptr;
+		std::unique_ptr<VulkanBuffer> m_morphPositionBuffer = nullptr;
+		std::unique_ptr<VulkanBuffer> m_morphUVBuffer = nullptr;
+
+		std::unique_ptr<VulkanBuffer> m_stageSkinningVertex = nullptr;
+		std::unique_ptr<VulkanBuffer> m_stageSkinningBone = nullptr;
+		std::unique_ptr<VulkanBuffer> m_stageMorphPosition = nullptr;
+		std::unique_ptr<VulkanBuffer> m_stageMorphUV = nullptr;
+
+		std::vector<PMXSkinningGpuBone> m_skinningBones;
+
 		std::shared_ptr<saba::MMDModel>	m_mmdModel = nullptr;
 		std::unique_ptr<saba::VMDAnimation> m_vmd  = nullptr;
 		std::shared_ptr<class AssetPMX> m_pmxAsset = nullptr;
 
+		// Only valid between kickAnimationJob and waitAnimationJob.
+		TaskHandle m_animationJob;
+
 		BLASBuilder m_blasBuilder;
 	};
 
@@ -141,22 +212,26 @@ namespace engine
 		void removeVmd(size_t i);
 		void clearVmd();
 
-
-		void onRenderCollect(
-			class RendererInterface* renderer,
-			VkCommandBuffer cmd,
-			VkPipelineLayout pipelinelayout,
-			bool bTranslucentPass);
+		// Kick animation and physics of this frame to threadpool when r.PMX.AnimationJob enable,
+		// onRenderTick wait it before skinning.
+		void kickAnimationJob(const RuntimeModuleTickData& tickData);
 
 		void onRenderTick(const RuntimeModuleTickData& tickData, VkCommandBuffer cmd, 
 			std::vector<GPUStaticMeshPerObjectData>& collector, 
+			std::vector<PMXGpuSubmesh>& pmxCollector,
 			std::vector<VkAccelerationStructureInstanceKHR>& asInstances);
 
 		const UUID& getSongUUID() const { return m_singSong; }
 		bool setSong(const UUID& in);
 
+		// Keep CPU skinned positions valid even when skinning on GPU.
+		bool isCPUPositionsRequested() const { return m_bCPUPositionsRequested; }
+		void setCPUPositionsRequested(bool bRequested) { m_bCPUPositionsRequested = bRequested; }
+		const glm::vec3* getCPUPositions() const { return m_proxy ? m_proxy->getCPUPositions() : nullptr; }
+
 	private:
 		std::unique_ptr<PMXMeshProxy> m_proxy = nullptr;
+		bool m_bCPUPositionsRequested = false;
 
 		bool m_bAudioPrepared = false;
 		bool m_bAudioVolumetric = false;
@@ -40,64 +40,55 @@ namespace engine
 		as.instanceShaderBindingTableRecordOffset = 0;
 	}
 
-	void StaticMeshComponent::renderObjectCollect(std::vector<GPUStaticMeshPerObjectData>& collector, std::vector<VkAccelerationStructureInstanceKHR>& asInstances)
+	void StaticMeshComponent::renderObjectCollect(const uint32_t* slots, GPUStaticMeshPerObjectData* objects, VkAccelerationStructureInstanceKHR* asInstances)
 	{
-		const size_t objectOffsetId = collector.size();
-
 		math::mat4 modelMatrix = getNode()->getTransform()->getWorldMatrix();
 		math::mat4 modelMatrixPrev = getNode()->getTransform()->getPrevWorldMatrix();
 
 		const bool bSelected = Editor::get()->getSceneNodeSelections().isSelected(SceneNodeSelctor(getNode()));
 
-		auto updateObject = [&](GPUStaticMeshPerObjectData& object)
-		{
-			object.modelMatrix = modelMatrix;
-			object.modelMatrixPrev = modelMatrixPrev;
-			object.bSelected = bSelected;
-		};
-
 		VkAccelerationStructureInstanceKHR instanceTamplate{};
 		{
 			math::mat4 temp = math::transpose(modelMatrix);
 			memcpy(&instanceTamplate.transform, &temp, sizeof(VkTransformMatrixKHR));
 		}
 
-		// Update transform and custom index.
-		auto updateRayInstance = [&](VkAccelerationStructureInstanceKHR& object, size_t i)
+		auto updateObject = [&](size_t i)
 		{
-			object.transform = instanceTamplate.transform;
-			object.instanceCustomIndex = objectOffsetId + i;
+			auto& object = objects[slots[i]];
+			object = m_perobjectCache.cachePerObjectData[i];
+			object.modelMatrix = modelMatrix;
+			object.modelMatrixPrev = modelMatrixPrev;
+			object.bSelected = bSelected;
+
+			// Update transform and custom index.
+			if (asInstances)
+			{
+				auto& instance = asInstances[slots[i]];
+				instance = m_perobjectCache.cachePerObjectAs[i];
+				instance.transform = instanceTamplate.transform;
+				instance.instanceCustomIndex = slots[i];
+			}
 		};
 
-		size_t baseInstanceOffset = asInstances.size();
 		if (m_perobjectCache.cachePerObjectData.size() > kMinSubMeshNumStartParallel)
 		{
-			const auto loop = [&, this](const size_t loopStart, const size_t loopEnd)
+			const auto loop = [&](const size_t loopStart, const size_t loopEnd)
 			{
 				for (size_t i = loopStart; i < loopEnd; ++i)
 				{
-					updateObject(m_perobjectCache.cachePerObjectData[i]);
-					updateRayInstance(m_perobjectCache.cachePerObjectAs[i], i);
+					updateObject(i);
 				}
 			};
-			ThreadPool::getDefault()->parallelizeLoop(0, m_perobjectCache.cachePerObjectData.size(), loop).wait();
+			ThreadPool::getDefault()->parallelFor(0, m_perobjectCache.cachePerObjectData.size(), loop);
 		}
 		else
 		{
 			for (size_t i = 0; i < m_perobjectCache.cachePerObjectData.size(); i++)
 			{
-				updateObject(m_perobjectCache.cachePerObjectData[i]);
-				updateRayInstance(m_perobjectCache.cachePerObjectAs[i], i);
+				updateObject(i);
 			}
 		}
-
-		collector.insert(collector.end(), m_perobjectCache.cachePerObjectData.begin(), m_perobjectCache.cachePerObjectData.end());
-
-		if (getContext()->getGraphicsCardState().bSupportRaytrace)
-		{
-			asInstances.insert(asInstances.end(), m_perobjectCache.cachePerObjectAs.begin(), m_perobjectCache.cachePerObjectAs.end());
-		}
-
 	}
 
 	bool StaticMeshComponent::setMesh(const UUID& in, const std::string& staticMeshAssetRelativeRoot, bool bEngineAsset)
@@ -136,6 +127,7 @@ namespace engine
 		m_cacheStaticMeshAsset = {};
 		m_perobjectCache.clear();
 		m_cachePerObjectMaterials.clear();
+		markRenderDirty();
 	}
 
 	void StaticMeshComponent::updateObjectCollectInfo(const RuntimeModuleTickData* tickData)
@@ -205,6 +197,25 @@ namespace engine
 					cacheObject.positionsArrayId = gpuAsset->getPositionBindless();
 					cacheObject.indexStartPosition = submesh.indicesStart;
 					cacheObject.indexCount = submesh.indicesCount;
+
+					// Asset import before meshlet build no meshlets, cull as whole submesh.
+					const auto& meshletRanges = meshAsset->getMeshletRanges();
+					if (gpuAsset->getMeshletsBindless() != ~0 && i < meshletRanges.size())
+					{
+						cacheObject.meshletsArrayId = gpuAsset->getMeshletsBindless();
+						cacheObject.meshletStart = meshletRanges[i].meshletStart;
+						cacheObject.meshletCount = meshletRanges[i].meshletCount;
+					}
+
+					// LOD0 is whole submesh, simplified LODs follow.
+					cacheObject.lodCount = 1 + (uint32_t)math::min(submesh.lods.size(), size_t(kStaticMeshMaxLODCount - 1));
+					cacheObject.lodIndicesStart[0] = submesh.indicesStart;
+					cacheObject.lodIndicesCount[0] = submesh.indicesCount;
+					for (uint32_t lod = 1; lod < cacheObject.lodCount; lod++)
+					{
+						cacheObject.lodIndicesStart[lod] = submesh.lods[lod - 1].indicesStart;
+						cacheObject.lodIndicesCount[lod] = submesh.lods[lod - 1].indicesCount;
+					}
 					cacheObject.sphereBounds = math::vec4(submesh.bounds.origin, submesh.bounds.radius);
 					cacheObject.extents = submesh.bounds.extents;
 					cacheObject.objectId = getNode()->getId();
@@ -257,6 +268,7 @@ namespace engine
 				// Default mesh, use fallback.
 				object.indexStartPosition = 0;
 				object.indexCount = (uint32_t)gpuAsset->getIndicesCount();
+				object.lodIndicesCount[0] = object.indexCount;
 				const auto& renderBounds = getContext()->getEngineMeshRenderBounds(gpuAsset->getAssetUUID());
 				object.sphereBounds = math::vec4(renderBounds.origin, renderBounds.radius);
 				object.extents = renderBounds.extents;
@@ -273,6 +285,9 @@ namespace engine
 						std::dynamic_pointer_cast<GPUStaticMeshAsset>(getContext()->getEngineAsset(gpuAsset->getAssetUUID()))->getOrBuilddBLAS().getBlasDeviceAddress(0));
 				}
 			}
+
+			// Submesh objects rebuild, render scene need refresh slots.
+			markRenderDirty();
 		}
 
 		// We handle once mesh replace event.
@@ -293,9 +308,20 @@ namespace engine
 			material->getAndTryBuildGPU();
 		}
 
+		// Material gpu data change when texture async load finish, only mark dirty when really change.
+		std::atomic<bool> bMaterialChange = false;
+		auto updateMaterial = [&](GPUStaticMeshPerObjectData& object, const GPUMaterialStandardPBR& material)
+		{
+			if (memcmp(&object.material, &material, sizeof(material)) != 0)
+			{
+				object.material = material;
+				bMaterialChange = true;
+			}
+		};
+
 		if (m_perobjectCache.cachePerObjectData.size() > kMinSubMeshNumStartParallel)
 		{
-			const auto loop = [this](const size_t loopStart, const size_t loopEnd)
+			const auto loop = [&, this](const size_t loopStart, const size_t loopEnd)
 			{
 				for (size_t i = loopStart; i < loopEnd; ++i)
 				{
@@ -303,10 +329,10 @@ namespace engine
 					const auto& id = m_perobjectCache.cacheMaterialId[i];
 					const auto& material = m_cachePerObjectMaterials.at(id).asset;
 
-					object.material = material->getGPUOnly();
+					updateMaterial(object, material->getGPUOnly());
 				}
 			};
-			ThreadPool::getDefault()->parallelizeLoop(0, m_perobjectCache.cachePerObjectData.size(), loop).wait();
+			ThreadPool::getDefault()->parallelFor(0, m_perobjectCache.cachePerObjectData.size(), loop);
 		}
 		else
 		{
@@ -318,10 +344,15 @@ namespace engine
 				if (!id.empty())
 				{
 					const auto& material = m_cachePerObjectMaterials.at(id).asset;
-					object.material = material->getGPUOnly();
+					updateMaterial(object, material->getGPUOnly());
 				}
 			}
 		}
+
+		if (bMaterialChange)
+		{
+			markRenderDirty();
+		}
 	}
 
 	void StaticMeshComponent::loadAssetByUUID()
@@ -28,8 +28,9 @@ namespace engine
 
 		virtual void tick(const RuntimeModuleTickData& tickData) override;
 
-		// Return is move this frame, which toggle tlas rebuild.
-		void renderObjectCollect(std::vector<GPUStaticMeshPerObjectData>& collector, std::vector<VkAccelerationStructureInstanceKHR>& asInstances);
+		// Fill submesh render objects into persistent object slots, slots size must equal submesh count.
+		// asInstances can be nullptr when no raytrace.
+		void renderObjectCollect(const uint32_t* slots, GPUStaticMeshPerObjectData* objects, VkAccelerationStructureInstanceKHR* asInstances);
 
 		bool setMesh(const UUID& in, const std::string& staticMeshAssetRelativeRoot, bool bEngineAsset);
 
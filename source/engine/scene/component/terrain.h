@@ -46,7 +46,11 @@ namespace engine
 		const TerrainSetting& getSetting() { return m_setting; }
 		bool changeSetting(const TerrainSetting& in);
 
-		void render(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, class GBufferTextures* inGBuffers, class RenderScene* scene, class RendererInterface* renderer);
+		// Update and batch leb on gpu, return false when terrain no ready to draw.
+		bool prepareRender(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, class GBufferTextures* inGBuffers, class RenderScene* scene, class RendererInterface* renderer);
+
+		// Draw inside terrain gbuffer render scope, may call on worker thread with secondary command buffer.
+		void renderLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, class GBufferTextures* inGBuffers);
 
 		void renderSDSMDepth(
 			VkCommandBuffer cmd, 
@@ -82,7 +86,6 @@ namespace engine
 		void reductionLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, class GBufferTextures* inGBuffers, class RenderScene* scene, class RendererInterface* renderer);
 
 		void batchLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, class GBufferTextures* inGBuffers, class RenderScene* scene, class RendererInterface* renderer);
-		void renderLeb(VkCommandBuffer cmd, BufferParameterHandle perFrameGPU, class GBufferTextures* inGBuffers, class RenderScene* scene, class RendererInterface* renderer);
 
 		struct
 		{
@@ -1,23 +1,25 @@
 #include "transform.h"
 #include "../scene_node.h"
+#include "../scene_graph.h"
 
 namespace engine
 {
-	void Transform::tick(const RuntimeModuleTickData& tickData)
-	{
-		m_prevWorldMatrix = m_worldMatrix;
-		updateWorldTransform();
-	}
-
 	void Transform::invalidateWorldMatrix()
 	{
+		// Already in scene dirty list.
+		if (m_bUpdateFlag)
+		{
+			return;
+		}
 		m_bUpdateFlag = true;
 
-		// also notify all children their transform dirty.
-		auto& children = getNode()->getChildren();
-		for (auto& child : children)
+		// Scene transform hierarchy update self and all children.
+		if (auto node = getNode())
 		{
-			child->getTransform()->invalidateWorldMatrix();
+			if (auto scene = node->getScene())
+			{
+				scene->markTransformDirty(node->getId());
+			}
 		}
 	}
 
@@ -66,23 +68,4 @@ namespace engine
 			math::toMat4(glm::quat(m_rotation)) *
 			math::scale(glm::mat4(1.0f), m_scale);
 	}
-
-
-	void Transform::updateWorldTransform()
-	{
-		if (m_bUpdateFlag)
-		{
-			m_worldMatrix = computeLocalMatrix();
-			auto parent = getNode()->getParent();
-
-			// recursive multiply all parent's world matrix.
-			if (parent)
-			{
-				auto transform = parent->getComponent<Transform>();
-				m_worldMatrix = transform->getWorldMatrix() * m_worldMatrix;
-			}
-
-			m_bUpdateFlag = !m_bUpdateFlag;
-		}
-	}
 }
\ No newline at end of file
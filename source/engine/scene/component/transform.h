@@ -8,14 +8,12 @@ namespace engine
 
 	class Transform : public Component
 	{
+		friend class TransformHierarchy;
 	public:
 		Transform() = default;
 		Transform(std::shared_ptr<SceneNode> sceneNode) : Component(sceneNode) { }
 
 		virtual ~Transform() = default;
-		
-		// Interface override.
-		virtual void tick(const RuntimeModuleTickData& tickData) override;
 
 		// Getter.
 		math::vec3& getTranslation() { return m_translation; }
@@ -25,7 +23,7 @@ namespace engine
 		math::vec3& getScale() { return m_scale; }
 		const math::vec3& getScale() const { return m_scale; }
 
-		// Mark world matrix dirty, also change child's dirty state.
+		// Mark world matrix dirty, children world matrix update by scene transform hierarchy.
 		void invalidateWorldMatrix();
 
 		// setter.
@@ -40,8 +38,6 @@ namespace engine
 		// Get last tick world matrix result.
 		const math::mat4& getPrevWorldMatrix() const { return m_prevWorldMatrix; }
 
-		void updateWorldTransform();
-
 	protected:
 		// Compute local matrix.
 		math::mat4 computeLocalMatrix() const;
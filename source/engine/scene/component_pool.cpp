@@ -0,0 +1,79 @@
+#include "component_pool.h"
+
+namespace engine
+{
+	size_t requireComponentTypeIndex()
+	{
+		static std::atomic<size_t> counter = 0;
+		return counter.fetch_add(1);
+	}
+
+	uint32_t* ComponentPoolBase::findSparse(size_t nodeId) const
+	{
+		const size_t page = nodeId / kPageSize;
+		if (page >= m_sparsePages.size() || !m_sparsePages[page])
+		{
+			return nullptr;
+		}
+		return &m_sparsePages[page][nodeId % kPageSize];
+	}
+
+	uint32_t ComponentPoolBase::findIndex(size_t nodeId) const
+	{
+		const uint32_t* sparse = findSparse(nodeId);
+		return sparse ? *sparse : kInvalidIndex;
+	}
+
+	uint32_t ComponentPoolBase::insertIndex(size_t nodeId)
+	{
+		const size_t page = nodeId / kPageSize;
+		if (page >= m_sparsePages.size())
+		{
+			m_sparsePages.resize(page + 1);
+		}
+
+		if (!m_sparsePages[page])
+		{
+			m_sparsePages[page] = std::make_unique<uint32_t[]>(kPageSize);
+			std::fill_n(m_sparsePages[page].get(), kPageSize, kInvalidIndex);
+		}
+
+		uint32_t& sparse = m_sparsePages[page][nodeId % kPageSize];
+		CHECK(sparse == kInvalidIndex);
+
+		sparse = (uint32_t)m_nodeIds.size();
+		m_nodeIds.push_back(nodeId);
+		return sparse;
+	}
+
+	bool ComponentPoolBase::remove(size_t nodeId)
+	{
+		uint32_t* sparse = findSparse(nodeId);
+		if (sparse == nullptr || *sparse == kInvalidIndex)
+		{
+			return false;
+		}
+
+		const uint32_t index = *sparse;
+		*sparse = kInvalidIndex;
+
+		// Move last element to the hole, keep dense array tight.
+		const size_t lastNodeId = m_nodeIds.back();
+		if (index + 1 != m_nodeIds.size())
+		{
+			m_nodeIds[index] = lastNodeId;
+			*findSparse(lastNodeId) = index;
+		}
+		m_nodeIds.pop_back();
+
+		swapAndPop(index);
+		return true;
+	}
+
+	void ComponentPoolBase::clear()
+	{
+		m_sparsePages.clear();
+		m_nodeIds.clear();
+		clearDense();
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "component.h"
+
+namespace engine
+{
+	// Dense index per component type, resolve once per type, no typeid string hash when lookup pool.
+	extern size_t requireComponentTypeIndex();
+
+	template<typename T>
+	struct ComponentTypeIndex
+	{
+		static_assert(std::is_base_of_v<Component, T>, "T must derive from Component.");
+		inline static const size_t value = requireComponentTypeIndex();
+	};
+
+	// Sparse set keyed by scene node id, node id is the stable handle of component in pool.
+	// Dense arrays are tight packed so loop never touch dead entries.
+	class ComponentPoolBase : NonCopyable
+	{
+	public:
+		static constexpr uint32_t kInvalidIndex = ~0U;
+
+		explicit ComponentPoolBase(const char* typeName) : m_typeName(typeName) { }
+		virtual ~ComponentPoolBase() = default;
+
+		const char* getTypeName() const { return m_typeName; }
+
+		size_t size() const { return m_nodeIds.size(); }
+		bool empty() const { return m_nodeIds.empty(); }
+
+		bool contains(size_t nodeId) const { return findIndex(nodeId) != kInvalidIndex; }
+
+		// Return dense index of node, kInvalidIndex if no exist.
+		uint32_t findIndex(size_t nodeId) const;
+
+		// Node id of dense index.
+		size_t getNodeId(uint32_t index) const { return m_nodeIds[index]; }
+
+		virtual std::shared_ptr<Component> getComponent(uint32_t index) const = 0;
+
+		// Remove node's component from pool, return false if no exist.
+		bool remove(size_t nodeId);
+
+		void clear();
+
+	protected:
+		// Insert node id and return new dense index, node id must no exist.
+		uint32_t insertIndex(size_t nodeId);
+
+		// Move last dense element to index and pop back.
+		virtual void swapAndPop(uint32_t index) = 0;
+		virtual void clearDense() = 0;
+
+	private:
+		static constexpr size_t kPageSize = 1024;
+
+		uint32_t* findSparse(size_t nodeId) const;
+
+	private:
+		const char* m_typeName;
+
+		// Sparse pages map node id to dense index, page allocate on demand.
+		std::vector<std::unique_ptr<uint32_t[]>> m_sparsePages;
+
+		// Dense node ids.
+		std::vector<size_t> m_nodeIds;
+	};
+
+	template<typename T>
+	class ComponentPool final : public ComponentPoolBase
+	{
+	public:
+		ComponentPool() : ComponentPoolBase(typeid(T).name()) { }
+
+		void insert(size_t nodeId, std::shared_ptr<T> component)
+		{
+			const uint32_t index = insertIndex(nodeId);
+			CHECK(index == m_components.size());
+			m_components.push_back(std::move(component));
+		}
+
+		const std::shared_ptr<T>& get(uint32_t index) const { return m_components[index]; }
+
+		virtual std::shared_ptr<Component> getComponent(uint32_t index) const override
+		{
+			return m_components[index];
+		}
+
+		// Loop until func return true. func can accept const std::shared_ptr<T>& or T&.
+		// Don't add or remove component of type T inside func.
+		template<typename F>
+		void loop(F&& func) const
+		{
+			for (const auto& component : m_components)
+			{
+				bool bBreak;
+				if constexpr (std::is_invocable_v<F, const std::shared_ptr<T>&>)
+				{
+					bBreak = func(component);
+				}
+				else
+				{
+					bBreak = func(*component);
+				}
+
+				if (bBreak)
+				{
+					return;
+				}
+			}
+		}
+
+	protected:
+		virtual void swapAndPop(uint32_t index) override
+		{
+			if (index + 1 != m_components.size())
+			{
+				m_components[index] = std::move(m_components.back());
+			}
+			m_components.pop_back();
+		}
+
+		virtual void clearDense() override
+		{
+			m_components.clear();
+		}
+
+	private:
+		std::vector<std::shared_ptr<T>> m_components;
+	};
+}
@@ -115,6 +115,8 @@ ASSET_ARCHIVE_IMPL_INHERIT(Scene, AssetInterface)
     ARCHIVE_NVP_DEFAULT(m_currentId);
     ARCHIVE_NVP_DEFAULT(m_root);
     ARCHIVE_NVP_DEFAULT(m_initName);
+    // Legacy component cache, runtime use component pools now, keep field for archive layout.
+    std::unordered_map<std::string, std::vector<std::weak_ptr<Component>>> m_cacheSceneComponents{ };
     ARCHIVE_NVP_DEFAULT(m_cacheSceneComponents);
     ARCHIVE_NVP_DEFAULT(m_nodeCount);
     ARCHIVE_NVP_DEFAULT(m_cacheSceneNodeMaps);
@@ -27,6 +27,14 @@ namespace engine
 		CHECK(!m_cacheSceneNodeMaps[node->getId()].lock());
 		m_cacheSceneNodeMaps[node->getId()] = node;
 
+		markTransformTopologyDirty();
+
+		// Transform add when node create, sync to pool if exist.
+		if (auto* pool = findPool<Transform>())
+		{
+			pool->insert(node->getId(), node->getTransform());
+		}
+
 		return node;
 	}
 
@@ -54,18 +62,72 @@ namespace engine
 		return true;
 	}
 
-	void Scene::shrinkCacheComponent(const char* id)
+	std::vector<std::pair<size_t, std::shared_ptr<Component>>> Scene::collectNodeComponents(const char* type) const
 	{
-		auto& cacheWeakPtr = m_cacheSceneComponents[id];
+		std::vector<std::pair<size_t, std::shared_ptr<Component>>> result;
+		for (const auto& [id, weakNode] : m_cacheSceneNodeMaps)
+		{
+			if (auto node = weakNode.lock())
+			{
+				if (auto component = node->getComponent(type))
+				{
+					result.push_back({ id, component });
+				}
+			}
+		}
+
+		// Keep create order stable.
+		std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		return result;
+	}
 
-		cacheWeakPtr.erase(std::remove_if(cacheWeakPtr.begin(), cacheWeakPtr.end(),
-			[](const std::weak_ptr<Component>& p)
+	void Scene::removeNodeComponents(size_t nodeId)
+	{
+		markRenderDirty(nodeId);
+
+		for (auto& pool : m_componentPools)
+		{
+			if (pool)
 			{
-				return p.lock().get() == nullptr;
-			}),
-			cacheWeakPtr.end()
-		);
-		m_cacheSceneComponentsShrinkAlready[id] = true;
+				pool->remove(nodeId);
+			}
+		}
+	}
+
+	bool Scene::hasComponent(const char* id) const
+	{
+		for (const auto& pool : m_componentPools)
+		{
+			if (pool && strcmp(pool->getTypeName(), id) == 0)
+			{
+				return !pool->empty();
+			}
+		}
+
+		// No pool create yet, slow path.
+		return !collectNodeComponents(id).empty();
+	}
+
+	bool Scene::removeComponent(std::shared_ptr<SceneNode> node, const char* type)
+	{
+		if (node->hasComponent(type))
+		{
+			setDirty();
+
+			for (auto& pool : m_componentPools)
+			{
+				if (pool && strcmp(pool->getTypeName(), type) == 0)
+				{
+					pool->remove(node->getId());
+				}
+			}
+
+			node->removeComponent(type);
+			markRenderDirty(node->getId());
+			return true;
+		}
+
+		return false;
 	}
 
 	bool Scene::setName(const std::string& name)
@@ -75,11 +137,16 @@ namespace engine
 
 	void Scene::tick(const RuntimeModuleTickData& tickData)
 	{
+		CPU_PROFILER_SCOPE("Scene::tick");
+
 		// All node tick.
 		loopNodeTopToDown([tickData](std::shared_ptr<SceneNode> node)
 		{
 			node->tick(tickData);
 		}, m_root);
+
+		// Transform change by component tick apply in this frame.
+		flushSceneNodeTransform();
 	}
 
 	void Scene::onGameBegin()
@@ -126,6 +193,15 @@ namespace engine
 	{
 		cereal::BinaryInputArchive archive(s);
 		archive(*this);
+
+		// Nodes all replaced, pools rebuild lazily.
+		m_componentPools.clear();
+		markTransformTopologyDirty();
+		{
+			std::lock_guard lock(m_renderDirtyMutex);
+			m_renderDirtyNodes.clear();
+			m_bRenderDirtyAll = true;
+		}
 		setDirty();
 	}
 
@@ -135,11 +211,13 @@ namespace engine
 			[&](std::shared_ptr<SceneNode> nodeLoop) 
 			{
 				m_cacheSceneNodeMaps.erase(nodeLoop->getId());
+				removeNodeComponents(nodeLoop->getId());
 			},
 			node);
 
 		// Loop delete nodes.
 		node->selfDelete();
+		markTransformTopologyDirty();
 	}
 
 	std::shared_ptr<SceneNode> Scene::createNode(const std::string& name, std::shared_ptr<SceneNode> parent)
@@ -270,13 +348,10 @@ namespace engine
 		return false;
 	}
 
-	// Sync scene node tree's transform form top to down to get current result.
+	// Sync dirty transform's world matrix form top to down to get current result.
 	void Scene::flushSceneNodeTransform()
 	{
-		loopNodeTopToDown([](std::shared_ptr<SceneNode> node)
-		{
-			node->getTransform()->updateWorldTransform();
-		},m_root);
+		m_transformHierarchy.update(*this);
 	}
 
 	bool Scene::existNode(size_t id)
@@ -289,4 +364,39 @@ namespace engine
 		m_cacheSceneNodeMaps.erase(id);
 		return false;
 	}
+
+	void Scene::markRenderDirty(size_t nodeId)
+	{
+		std::lock_guard lock(m_renderDirtyMutex);
+		if (!m_bRenderDirtyAll)
+		{
+			m_renderDirtyNodes.push_back(nodeId);
+		}
+	}
+
+	void Scene::markRenderDirty(const std::vector<size_t>& nodeIds)
+	{
+		std::lock_guard lock(m_renderDirtyMutex);
+		if (!m_bRenderDirtyAll)
+		{
+			m_renderDirtyNodes.insert(m_renderDirtyNodes.end(), nodeIds.begin(), nodeIds.end());
+		}
+	}
+
+	bool Scene::consumeRenderDirty(std::vector<size_t>& outNodes)
+	{
+		std::lock_guard lock(m_renderDirtyMutex);
+
+		const bool bDirtyAll = m_bRenderDirtyAll;
+		m_bRenderDirtyAll = false;
+
+		outNodes.clear();
+		if (!bDirtyAll)
+		{
+			outNodes.swap(m_renderDirtyNodes);
+		}
+		m_renderDirtyNodes.clear();
+
+		return bDirtyAll;
+	}
 }
\ No newline at end of file
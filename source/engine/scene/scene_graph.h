@@ -2,7 +2,9 @@
 
 #include <util/util.h>
 #include "component.h"
+#include "component_pool.h"
 #include "scene_node.h"
+#include "transform_hierarchy.h"
 #include <asset/asset_common.h>
 namespace engine
 {
@@ -50,18 +52,8 @@ namespace engine
 		// Get root node.
 		std::shared_ptr<SceneNode> getRootNode() { return m_root; }
 
-		// Get components.
-		const std::vector<std::weak_ptr<Component>>& getComponents(const char* id) const
-		{
-			return m_cacheSceneComponents.at(id);
-		}
-
 		// Check exist component or not.
-		bool hasComponent(const char* id) const
-		{
-			auto component = m_cacheSceneComponents.find(id);
-			return (component != m_cacheSceneComponents.end() && !component->second.empty());
-		}
+		bool hasComponent(const char* id) const;
 
 		// Change scene name.
 		bool setName(const std::string& name);
@@ -90,39 +82,34 @@ namespace engine
 		// find all same name nodes, this is a slow function.
 		std::vector<std::shared_ptr<SceneNode>> findNodes(const std::string& name);
 
-		// update whole graph's transform.
+		// update dirty transform's world matrix, level by level parallel.
 		void flushSceneNodeTransform();
 
+		// Node local transform change.
+		void markTransformDirty(size_t nodeId) { m_transformHierarchy.markDirty(nodeId); }
+
+		// Node add, remove or parent change.
+		void markTransformTopologyDirty() { m_transformHierarchy.markTopologyDirty(); }
+
 		bool existNode(size_t id);
 		std::shared_ptr<SceneNode> getNodeById(size_t id) const { return m_cacheSceneNodeMaps.at(id).lock(); }
 
+		// Mark node's render proxy dirty, when transform update or component add/remove.
+		void markRenderDirty(size_t nodeId);
+		void markRenderDirty(const std::vector<size_t>& nodeIds);
+
+		// Move out dirty nodes since last call, return true if whole scene render proxy need rebuild.
+		bool consumeRenderDirty(std::vector<size_t>& outNodes);
+
 	public:
-		// Loop scene's components.
-		template<typename T>
-		void loopComponents(std::function<bool(std::shared_ptr<T>)>&& func)
-		{
-			static_assert(std::is_base_of_v<Component, T>, "T must derive from Component.");
-			if (hasComponent<T>() && !m_cacheSceneComponentsShrinkAlready[typeid(T).name()])
-			{
-				shrinkCacheComponent(typeid(T).name());
-			}
+		// Component accessors create pool lazily even when const, so only call them on main thread.
+		// Jobs (transform hierarchy update, pmx animation) must work on data collected before kick.
 
-			if (hasComponent<T>())
-			{
-				for (std::weak_ptr<T>& p : getComponents<T>())
-				{
-					if (auto pShared = p.lock())
-					{
-						if (pShared->getNode()->hasComponent<T>())
-						{
-							if (func(pShared))
-							{
-								return;
-							}
-						}
-					}
-				}
-			}
+		// Loop scene's components until func return true, func accept const std::shared_ptr<T>& or T&.
+		template<typename T, typename F>
+		void loopComponents(F&& func)
+		{
+			getOrCreatePool<T>().loop(std::forward<F>(func));
 		}
 
 		template<typename T>
@@ -132,8 +119,12 @@ namespace engine
 
 			if (component && !node->hasComponent<T>())
 			{
+				// Create pool before set component, otherwise lazy collect will insert it twice.
+				auto& pool = getOrCreatePool<T>();
+
 				node->setComponent(component);
-				m_cacheSceneComponents[typeid(T).name()].push_back(component);
+				pool.insert(node->getId(), component);
+				markRenderDirty(node->getId());
 				m_bDirty = true;
 			}
 		}
@@ -141,50 +132,40 @@ namespace engine
 		template <typename T>
 		bool hasComponent() const
 		{
-			static_assert(std::is_base_of_v<Component, T>, "T must derive from Component.");
-			return hasComponent(typeid(T).name());
+			return !getOrCreatePool<T>().empty();
 		}
 
 		template<typename T>
 		bool removeComponent(std::shared_ptr<SceneNode> node)
 		{
 			static_assert(std::is_base_of_v<Component, T>, "T must derive from Component.");
-			return removeComponent(typeid(T).name());
+			return removeComponent(node, typeid(T).name());
 		}
 
-		bool removeComponent(std::shared_ptr<SceneNode> node, const char* type)
-		{
-			if (node->hasComponent(type))
-			{
-				setDirty();
-				node->removeComponent(type);
-				m_cacheSceneComponentsShrinkAlready[type] = false;
-				return true;
-			}
-
-			return false;
-		}
+		bool removeComponent(std::shared_ptr<SceneNode> node, const char* type);
 
 		template <class T>
 		std::vector<std::weak_ptr<T>> getComponents() const
 		{
-			static_assert(std::is_base_of_v<Component, T>, "T must derive from Component.");
+			const auto& pool = getOrCreatePool<T>();
 
-			std::vector<std::weak_ptr<T>> result;
-			auto id = typeid(T).name();
-			if (hasComponent(id))
+			std::vector<std::weak_ptr<T>> result(pool.size());
+			for (uint32_t i = 0; i < pool.size(); i++)
 			{
-				const auto& sceneComponents = getComponents(id);
-
-				result.resize(sceneComponents.size());
-				std::transform(sceneComponents.begin(), sceneComponents.end(), result.begin(),
-					[](const std::weak_ptr<Component>& component) -> std::weak_ptr<T>
-					{
-						return std::static_pointer_cast<T>(component.lock());
-					});
+				result[i] = pool.get(i);
 			}
 			return result;
 		}
+
+		// Get component by node id, node id is the stable handle of component.
+		template <class T>
+		std::shared_ptr<T> getComponent(size_t nodeId) const
+		{
+			const auto& pool = getOrCreatePool<T>();
+			const uint32_t index = pool.findIndex(nodeId);
+			return index == ComponentPoolBase::kInvalidIndex ? nullptr : pool.get(index);
+		}
+
 	protected:
 		virtual bool saveActionImpl() override;
 
@@ -197,8 +178,47 @@ namespace engine
 		// get scene manager.
 		SceneManager* getManager();
 
-		// shrink cache component.
-		void shrinkCacheComponent(const char* id);
+		template<typename T>
+		ComponentPool<T>* findPool() const
+		{
+			const size_t index = ComponentTypeIndex<T>::value;
+			if (index < m_componentPools.size() && m_componentPools[index])
+			{
+				return static_cast<ComponentPool<T>*>(m_componentPools[index].get());
+			}
+			return nullptr;
+		}
+
+		// Pool create lazily, collect exist components from nodes when create, main thread only.
+		template<typename T>
+		ComponentPool<T>& getOrCreatePool() const
+		{
+			if (auto* pool = findPool<T>())
+			{
+				return *pool;
+			}
+
+			auto pool = std::make_unique<ComponentPool<T>>();
+			for (const auto& [id, component] : collectNodeComponents(typeid(T).name()))
+			{
+				pool->insert(id, std::dynamic_pointer_cast<T>(component));
+			}
+
+			const size_t index = ComponentTypeIndex<T>::value;
+			if (index >= m_componentPools.size())
+			{
+				m_componentPools.resize(index + 1);
+			}
+			m_componentPools[index] = std::move(pool);
+
+			return static_cast<ComponentPool<T>&>(*m_componentPools[index]);
+		}
+
+		// Collect all node's component of type, sort by node id.
+		std::vector<std::pair<size_t, std::shared_ptr<Component>>> collectNodeComponents(const char* type) const;
+
+		// Remove node's components from all pools, call when node delete.
+		void removeNodeComponents(size_t nodeId);
 
 	public:
 		// Root node id.
@@ -208,9 +228,17 @@ namespace engine
 		// Cache scene manager.
 		SceneManager* m_manager = nullptr;
 
-		// Is cache scene component dirty already. see m_cacheSceneComponents below.
-		// When some sence node remove component, need to call scene update cache in next tick.
-		std::unordered_map<std::string, bool> m_cacheSceneComponentsShrinkAlready = {};
+		// Dense component pools indexed by ComponentTypeIndex, no include transform until first use.
+		// Mutable for lazy create inside const accessors, no lock so main thread only.
+		mutable std::vector<std::unique_ptr<ComponentPoolBase>> m_componentPools;
+
+		// Render dirty nodes, transform may update in parallel so guard with mutex.
+		std::mutex m_renderDirtyMutex;
+		std::vector<size_t> m_renderDirtyNodes;
+		bool m_bRenderDirtyAll = true;
+
+		// Flatten transform tree for world matrix update.
+		TransformHierarchy m_transformHierarchy;
 
 	private:
 		ARCHIVE_DECLARE;
@@ -224,9 +252,6 @@ namespace engine
 		// Init name.
 		std::string m_initName;
 
-		// Cache scene components, no include transform.
-		std::unordered_map<std::string, std::vector<std::weak_ptr<Component>>> m_cacheSceneComponents;
-
 		// Cache scene node maps.
 		std::unordered_map<size_t, std::weak_ptr<SceneNode>> m_cacheSceneNodeMaps;
 
@@ -9,6 +9,8 @@ namespace engine
         if (auto scene = m_scene.lock())
         {
             scene->m_nodeCount--;
+            scene->removeNodeComponents(m_id);
+            scene->markTransformTopologyDirty();
         }
     }
 
@@ -203,6 +205,12 @@ namespace engine
 
     void SceneNode::updateDepth()
     {
+        // Depth change, flatten transform hierarchy need rebuild.
+        if (auto scene = m_scene.lock())
+        {
+            scene->markTransformTopologyDirty();
+        }
+
         if (auto parent = m_parent.lock())
         {
             m_depth = parent->m_depth + 1;
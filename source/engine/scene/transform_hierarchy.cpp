@@ -0,0 +1,258 @@
+#include "transform_hierarchy.h"
+#include "scene_graph.h"
+#include "scene_node.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <xmmintrin.h>
+	#define TRANSFORM_HIERARCHY_SSE 1
+#else
+	#define TRANSFORM_HIERARCHY_SSE 0
+#endif
+
+namespace engine
+{
+	// Level dirty entries count to start parallel update.
+	constexpr size_t kMinTransformNumStartParallel = 256;
+
+	// Same as translate * toMat4(quat(rotation)) * scale, but no full matrix multiply.
+	static inline math::mat4 composeLocalMatrix(const math::vec3& translation, const math::vec3& rotation, const math::vec3& scale)
+	{
+		const math::mat3 r = math::mat3_cast(math::quat(rotation));
+
+		math::mat4 result;
+		result[0] = math::vec4(r[0] * scale.x, 0.0f);
+		result[1] = math::vec4(r[1] * scale.y, 0.0f);
+		result[2] = math::vec4(r[2] * scale.z, 0.0f);
+		result[3] = math::vec4(translation, 1.0f);
+		return result;
+	}
+
+	// result = a * b, column major.
+	static inline void mulMatrix(const math::mat4& a, const math::mat4& b, math::mat4& result)
+	{
+	#if TRANSFORM_HIERARCHY_SSE
+		const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+		const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+		const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+		const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+		for (int i = 0; i < 4; i++)
+		{
+			__m128 column = _mm_mul_ps(a0, _mm_set1_ps(b[i][0]));
+			column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(b[i][1])));
+			column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(b[i][2])));
+			column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(b[i][3])));
+			_mm_storeu_ps(&result[i][0], column);
+		}
+	#else
+		result = a * b;
+	#endif
+	}
+
+	void TransformHierarchy::markDirty(size_t nodeId)
+	{
+		std::lock_guard lock(m_dirtyMutex);
+		m_dirtyNodes.push_back(nodeId);
+	}
+
+	void TransformHierarchy::rebuild(std::shared_ptr<SceneNode> root)
+	{
+		m_bTopologyDirty = false;
+
+		m_nodeIndices.clear();
+		m_nodeIds.clear();
+		m_transforms.clear();
+		m_parents.clear();
+		m_levels.clear();
+		m_firstChildren.clear();
+		m_childCounts.clear();
+		m_levelDirty.clear();
+		m_prevUpdated.clear();
+		{
+			std::lock_guard lock(m_dirtyMutex);
+			m_dirtyNodes.clear();
+		}
+
+		if (!root)
+		{
+			return;
+		}
+
+		// Breadth first, children of one node push continuous.
+		std::vector<std::shared_ptr<SceneNode>> nodes = { root };
+		m_parents.push_back(kInvalidIndex);
+		m_levels.push_back(0);
+
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			const auto node = nodes[i];
+			const auto& children = node->getChildren();
+
+			m_firstChildren.push_back((uint32_t)nodes.size());
+			m_childCounts.push_back((uint32_t)children.size());
+
+			for (const auto& child : children)
+			{
+				nodes.push_back(child);
+				m_parents.push_back((uint32_t)i);
+				m_levels.push_back(m_levels[i] + 1);
+			}
+		}
+
+		const size_t count = nodes.size();
+		m_nodeIds.resize(count);
+		m_transforms.resize(count);
+		m_translations.resize(count);
+		m_rotations.resize(count);
+		m_scales.resize(count);
+		m_worldMatrices.resize(count);
+		m_bQueued.assign(count, 1);
+		m_levelDirty.resize(m_levels.back() + 1);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			m_nodeIds[i] = nodes[i]->getId();
+			m_transforms[i] = nodes[i]->getTransform().get();
+			m_nodeIndices[m_nodeIds[i]] = i;
+
+			// Last frame world matrix still keep in component.
+			m_transforms[i]->m_prevWorldMatrix = m_transforms[i]->m_worldMatrix;
+
+			// All entries update after rebuild.
+			gatherLocal(i);
+			m_levelDirty[m_levels[i]].push_back(i);
+		}
+	}
+
+	void TransformHierarchy::gatherLocal(uint32_t index)
+	{
+		const Transform* transform = m_transforms[index];
+
+		m_translations[index] = transform->m_translation;
+		m_rotations[index] = transform->m_rotation;
+		m_scales[index] = transform->m_scale;
+	}
+
+	void TransformHierarchy::updateEntries(const std::vector<uint32_t>& entries)
+	{
+		auto updateEntry = [this](uint32_t index)
+		{
+			const math::mat4 localMatrix = composeLocalMatrix(m_translations[index], m_rotations[index], m_scales[index]);
+
+			const uint32_t parent = m_parents[index];
+			if (parent == kInvalidIndex)
+			{
+				m_worldMatrices[index] = localMatrix;
+			}
+			else
+			{
+				mulMatrix(m_worldMatrices[parent], localMatrix, m_worldMatrices[index]);
+			}
+
+			// Write back to component.
+			Transform* transform = m_transforms[index];
+			transform->m_worldMatrix = m_worldMatrices[index];
+			transform->m_bUpdateFlag = false;
+		};
+
+		if (entries.size() > kMinTransformNumStartParallel)
+		{
+			ThreadPool::getDefault()->parallelFor(size_t(0), entries.size(), [&](const size_t start, const size_t end)
+			{
+				for (size_t i = start; i < end; i++)
+				{
+					updateEntry(entries[i]);
+				}
+			}, 64);
+		}
+		else
+		{
+			for (const uint32_t index : entries)
+			{
+				updateEntry(index);
+			}
+		}
+	}
+
+	void TransformHierarchy::update(Scene& scene)
+	{
+		CPU_PROFILER_SCOPE("TransformHierarchy::update");
+
+		m_updatedNodes.clear();
+
+		if (m_bTopologyDirty)
+		{
+			rebuild(scene.getRootNode());
+		}
+		else
+		{
+			// Prev-frame world matrix only change on entries update last frame.
+			for (const uint32_t index : m_prevUpdated)
+			{
+				m_transforms[index]->m_prevWorldMatrix = m_worldMatrices[index];
+			}
+		}
+		m_prevUpdated.clear();
+
+		// Dirty nodes as seed of their level.
+		std::vector<size_t> dirtyNodes;
+		{
+			std::lock_guard lock(m_dirtyMutex);
+			dirtyNodes.swap(m_dirtyNodes);
+		}
+
+		for (const size_t nodeId : dirtyNodes)
+		{
+			auto iter = m_nodeIndices.find(nodeId);
+			if (iter == m_nodeIndices.end())
+			{
+				continue;
+			}
+
+			const uint32_t index = iter->second;
+			gatherLocal(index);
+
+			if (!m_bQueued[index])
+			{
+				m_bQueued[index] = 1;
+				m_levelDirty[m_levels[index]].push_back(index);
+			}
+		}
+
+		// Top to down, clean subtree never visit.
+		for (uint32_t level = 0; level < m_levelDirty.size(); level++)
+		{
+			auto& entries = m_levelDirty[level];
+			if (entries.empty())
+			{
+				continue;
+			}
+
+			updateEntries(entries);
+
+			for (const uint32_t index : entries)
+			{
+				m_bQueued[index] = 0;
+				m_prevUpdated.push_back(index);
+				m_updatedNodes.push_back(m_nodeIds[index]);
+
+				// Children world matrix relate to parent, dirty too.
+				const uint32_t childEnd = m_firstChildren[index] + m_childCounts[index];
+				for (uint32_t child = m_firstChildren[index]; child < childEnd; child++)
+				{
+					if (!m_bQueued[child])
+					{
+						m_bQueued[child] = 1;
+						m_levelDirty[level + 1].push_back(child);
+					}
+				}
+			}
+			entries.clear();
+		}
+
+		if (!m_updatedNodes.empty())
+		{
+			scene.markRenderDirty(m_updatedNodes);
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <util/util.h>
+
+namespace engine
+{
+	class Scene;
+	class SceneNode;
+	class Transform;
+
+	// Flatten scene node transform tree, breadth first order so entries sort by depth,
+	// and children of one node always continuous.
+	// World matrix update level by level, each level is one parallel batch, only dirty subtrees visit.
+	class TransformHierarchy : NonCopyable
+	{
+	public:
+		static constexpr uint32_t kInvalidIndex = ~0U;
+
+		// Node add, remove or parent change, rebuild whole hierarchy when next update.
+		void markTopologyDirty() { m_bTopologyDirty = true; }
+
+		// Node local transform change, node and its children update when next update.
+		void markDirty(size_t nodeId);
+
+		// Update dirty world matrix and write back to transform components.
+		void update(Scene& scene);
+
+		// Node ids of world matrix update in last update.
+		const std::vector<size_t>& getUpdatedNodes() const { return m_updatedNodes; }
+
+		size_t size() const { return m_nodeIds.size(); }
+		uint32_t getLevelCount() const { return (uint32_t)m_levelDirty.size(); }
+
+	private:
+		void rebuild(std::shared_ptr<SceneNode> root);
+
+		// Load local TRS from transform component.
+		void gatherLocal(uint32_t index);
+
+		// Compute world matrix of entries, entries must in same level.
+		void updateEntries(const std::vector<uint32_t>& entries);
+
+	private:
+		bool m_bTopologyDirty = true;
+
+		// Node id to entry index.
+		std::unordered_map<size_t, uint32_t> m_nodeIndices;
+
+		// SOA entries.
+		std::vector<size_t> m_nodeIds;
+		std::vector<Transform*> m_transforms;
+		std::vector<uint32_t> m_parents;
+		std::vector<uint32_t> m_levels;
+		std::vector<uint32_t> m_firstChildren;
+		std::vector<uint32_t> m_childCounts;
+		std::vector<math::vec3> m_translations;
+		std::vector<math::vec3> m_rotations;
+		std::vector<math::vec3> m_scales;
+		std::vector<math::mat4> m_worldMatrices;
+
+		// Entry already in dirty list.
+		std::vector<uint8_t> m_bQueued;
+
+		// Dirty entries of each level.
+		std::vector<std::vector<uint32_t>> m_levelDirty;
+
+		// Entries update last frame, their prev-frame world matrix need refresh.
+		std::vector<uint32_t> m_prevUpdated;
+		std::vector<size_t> m_updatedNodes;
+
+		// Node mark dirty may come from other thread.
+		std::mutex m_dirtyMutex;
+		std::vector<size_t> m_dirtyNodes;
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace engine
 {
     // CPU cache line size, set 64 bytes here.
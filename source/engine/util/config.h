@@ -39,5 +39,12 @@ namespace engine
 
 		// Config folder config.
 		std::string configFolder = "config";
+
+		// Profiler capture frames when start up, zero is no capture.
+		uint32_t profileCaptureFrames = 0;
+		std::string profileCapturePath = "log/profile.json";
+
+		// Quit application after start up profiler capture finish, used by ci.
+		bool bExitAfterProfileCapture = false;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "engine.h"
 #include "framework.h"
+#include "profiler.h"
 #include <util/openal.h>
 
 namespace engine
@@ -58,7 +59,12 @@ namespace engine
 
         initSoundEngine();
 
-
+        Profiler::get()->setThreadName("Main");
+        if (framework->getConfig().profileCaptureFrames > 0)
+        {
+            const auto& config = framework->getConfig();
+            Profiler::get()->beginCapture(config.profileCaptureFrames, config.profileCapturePath);
+        }
 
         // Engine timer init, use 5 frame to smooth fps and dt, use 5.0 as min fps to compute smooth time.
         m_timer.init(5.0, 5.0);
@@ -93,6 +99,8 @@ namespace engine
 
         // float engineDtRequire = 1.0f / cVarEngineTickFps.get();
 
+        Profiler::get()->beginFrame();
+
         if (m_runtimeModules.size() > 0)
         {
             // Update engine timer.
@@ -122,10 +130,21 @@ namespace engine
 
             for (const auto& runtimeModule : m_runtimeModules)
             {
+                // Type name is static string, safe to use as profiler name.
+                ScopeCPUProfiler moduleScope(typeid(*runtimeModule).name());
                 bContinue &= runtimeModule->tick(tickData);
             }
         }
 
+        Profiler::get()->endFrame();
+
+        // Start up capture finish, quit when require.
+        if (m_framework->getConfig().bExitAfterProfileCapture && Profiler::get()->isCaptureFinished())
+        {
+            LOG_INFO("Profiler capture finish, exit application.");
+            bContinue = false;
+        }
+
         return bContinue;
     }
 
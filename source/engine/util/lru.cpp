@@ -0,0 +1,352 @@
+#include "lru.h"
+
+namespace engine
+{
+	static AutoCVarInt32 cVarLRUHits("r.LRU.Stat.Hits", "LRU asset cache hit count, clamp to int max.", "LRU", 0, CVarFlags::ReadOnly);
+	static AutoCVarInt32 cVarLRUMisses("r.LRU.Stat.Misses", "LRU asset cache miss count, clamp to int max.", "LRU", 0, CVarFlags::ReadOnly);
+	static AutoCVarInt32 cVarLRUEvictedMB("r.LRU.Stat.EvictedMB", "LRU asset cache total evicted size (MB).", "LRU", 0, CVarFlags::ReadOnly);
+	static AutoCVarInt32 cVarLRUFallbackUses("r.LRU.Stat.FallbackUses", "Fallback asset use count when asset still loading, clamp to int max.", "LRU", 0, CVarFlags::ReadOnly);
+	static AutoCVarInt32 cVarLRUUsedMB("r.LRU.Stat.UsedMB", "LRU asset cache owner used size (MB).", "LRU", 0, CVarFlags::ReadOnly);
+
+	static AutoCVarBool cVarLRUBackgroundEviction(
+		"r.LRU.BackgroundEviction",
+		"Evict lru asset cache on threadpool task, otherwise evict in main thread tick.",
+		"LRU",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarDumpLRUStatistics("cmd.dumpLRUStatistics", "Print lru asset cache statistics.");
+
+	static inline int32_t clampToInt32(uint64_t value)
+	{
+		return int32_t(std::min<uint64_t>(value, uint64_t(std::numeric_limits<int32_t>::max())));
+	}
+
+	LRUAssetCache::LRUAssetCache(size_t capacity, size_t elasticity)
+		: m_capacity(capacity * 1024 * 1024)
+		, m_elasticity(elasticity * 1024 * 1024)
+	{
+
+	}
+
+	LRUAssetCache::~LRUAssetCache()
+	{
+		clear();
+	}
+
+	void LRUAssetCache::touch(Entry& entry) const
+	{
+		const uint64_t stamp = m_clock.load(std::memory_order_relaxed);
+		if (entry.accessStamp.load(std::memory_order_relaxed) != stamp)
+		{
+			entry.accessStamp.store(stamp, std::memory_order_relaxed);
+		}
+	}
+
+	bool LRUAssetCache::contain(const KeyType& key)
+	{
+		auto& shard = getShard(key);
+		std::shared_lock lock(shard.mutex);
+
+		// First search from lru owner map.
+		if (auto iter = shard.ownerMap.find(key); iter != shard.ownerMap.end())
+		{
+			touch(*iter->second);
+			shard.hits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Then if lru owner map no exist, search from lru weak map, expired one erase when sweep.
+		if (auto iter = shard.weakMap.find(key); iter != shard.weakMap.end() && !iter->second.expired())
+		{
+			shard.hits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		shard.misses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	std::shared_ptr<LRUAssetCache::ValueType> LRUAssetCache::tryGet(const KeyType& key)
+	{
+		auto& shard = getShard(key);
+		std::shared_lock lock(shard.mutex);
+
+		if (auto iter = shard.ownerMap.find(key); iter != shard.ownerMap.end())
+		{
+			touch(*iter->second);
+			return iter->second->value;
+		}
+
+		// May still valid in weak ptr cache, try get.
+		if (auto iter = shard.weakMap.find(key); iter != shard.weakMap.end())
+		{
+			return iter->second.lock();
+		}
+
+		// No valid instance, return nullptr and need reload.
+		return nullptr;
+	}
+
+	void LRUAssetCache::insert(const KeyType& key, std::shared_ptr<ValueType> value)
+	{
+		const size_t size = value->getSize();
+		const ELRUAssetType type = value->getLRUType();
+
+		// Replaced asset release after unlock.
+		std::shared_ptr<ValueType> replaced = nullptr;
+		{
+			auto& shard = getShard(key);
+			std::unique_lock lock(shard.mutex);
+
+			// Cache weak ptr value.
+			shard.weakMap[key] = value;
+
+			auto& entry = shard.ownerMap[key];
+			if (entry)
+			{
+				// LRU asset can insert repeatly, remove old size.
+				m_usedSize.fetch_sub(entry->size, std::memory_order_relaxed);
+				m_typeUsedSize[size_t(entry->type)].fetch_sub(entry->size, std::memory_order_relaxed);
+
+				replaced = std::move(entry->value);
+			}
+			else
+			{
+				entry = std::make_unique<Entry>();
+			}
+
+			entry->value = std::move(value);
+			entry->size = size;
+			entry->type = type;
+			entry->accessStamp.store(m_clock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+			// Account inside shard lock, so evict never sub size which not add yet.
+			m_usedSize.fetch_add(size, std::memory_order_relaxed);
+			m_typeUsedSize[size_t(type)].fetch_add(size, std::memory_order_relaxed);
+		}
+	}
+
+	void LRUAssetCache::refreshSize(const KeyType& key)
+	{
+		auto& shard = getShard(key);
+		std::unique_lock lock(shard.mutex);
+
+		auto iter = shard.ownerMap.find(key);
+		if (iter == shard.ownerMap.end())
+		{
+			return;
+		}
+
+		auto& entry = *iter->second;
+		const size_t size = entry.value->getSize();
+
+		m_usedSize.fetch_sub(entry.size, std::memory_order_relaxed);
+		m_typeUsedSize[size_t(entry.type)].fetch_sub(entry.size, std::memory_order_relaxed);
+
+		entry.size = size;
+		m_usedSize.fetch_add(size, std::memory_order_relaxed);
+		m_typeUsedSize[size_t(entry.type)].fetch_add(size, std::memory_order_relaxed);
+	}
+
+	size_t LRUAssetCache::evict(size_t targetSize, std::vector<std::shared_ptr<ValueType>>& outReleases)
+	{
+		CPU_PROFILER_SCOPE("LRUAssetCache::evict");
+
+		struct Candidate
+		{
+			uint64_t stamp;
+			KeyType key;
+			uint32_t shardIndex;
+		};
+
+		// Snapshot stamps shard by shard, hit in other shards no blocked.
+		std::vector<Candidate> candidates;
+		for (uint32_t i = 0; i < kShardCount; i++)
+		{
+			auto& shard = m_shards[i];
+			std::shared_lock lock(shard.mutex);
+
+			for (const auto& [key, entry] : shard.ownerMap)
+			{
+				candidates.push_back({ entry->accessStamp.load(std::memory_order_relaxed), key, i });
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.stamp < b.stamp; });
+
+		size_t reduceSize = 0;
+		for (const auto& candidate : candidates)
+		{
+			if (m_usedSize.load(std::memory_order_relaxed) <= targetSize)
+			{
+				break;
+			}
+
+			auto& shard = m_shards[candidate.shardIndex];
+			std::unique_lock lock(shard.mutex);
+
+			// Skip when erased or touched after snapshot.
+			auto iter = shard.ownerMap.find(candidate.key);
+			if (iter == shard.ownerMap.end() || iter->second->accessStamp.load(std::memory_order_relaxed) != candidate.stamp)
+			{
+				continue;
+			}
+
+			const size_t size = iter->second->size;
+			m_usedSize.fetch_sub(size, std::memory_order_relaxed);
+			m_typeUsedSize[size_t(iter->second->type)].fetch_sub(size, std::memory_order_relaxed);
+
+			outReleases.push_back(std::move(iter->second->value));
+			shard.ownerMap.erase(iter);
+
+			reduceSize += size;
+		}
+
+		m_evictedBytes.fetch_add(reduceSize, std::memory_order_relaxed);
+		m_evictedCount.fetch_add(outReleases.size(), std::memory_order_relaxed);
+
+		return reduceSize;
+	}
+
+	void LRUAssetCache::sweepWeakPtrs()
+	{
+		for (auto& shard : m_shards)
+		{
+			std::unique_lock lock(shard.mutex);
+			std::erase_if(shard.weakMap, [](const auto& pair) { return pair.second.expired(); });
+		}
+	}
+
+	void LRUAssetCache::releasePendingAssets()
+	{
+		std::vector<std::shared_ptr<ValueType>> releases;
+		{
+			std::lock_guard lock(m_pendingReleaseMutex);
+			releases.swap(m_pendingReleases);
+		}
+
+		// Asset destruct here.
+		releases.clear();
+	}
+
+	size_t LRUAssetCache::prune()
+	{
+		if (m_capacity == 0 || m_usedSize.load(std::memory_order_relaxed) < getMaxAllowedSize())
+		{
+			return 0;
+		}
+
+		std::vector<std::shared_ptr<ValueType>> releases;
+		const size_t reduceSize = evict(m_capacity, releases);
+		sweepWeakPtrs();
+
+		return reduceSize;
+	}
+
+	void LRUAssetCache::tick()
+	{
+		// Release assets evicted by last background task.
+		if (m_evictTask.isFinished())
+		{
+			m_evictTask = { };
+			releasePendingAssets();
+		}
+
+		m_clock.fetch_add(1, std::memory_order_relaxed);
+
+		const bool bOversize = m_capacity > 0 && m_usedSize.load(std::memory_order_relaxed) > getMaxAllowedSize();
+		if (bOversize && !m_evictTask.isValid())
+		{
+			if (cVarLRUBackgroundEviction.get())
+			{
+				auto* pool = ThreadPool::getDefault();
+				m_evictTask = pool->createTask([this]()
+				{
+					std::vector<std::shared_ptr<ValueType>> releases;
+					evict(m_capacity, releases);
+					sweepWeakPtrs();
+
+					std::lock_guard lock(m_pendingReleaseMutex);
+					m_pendingReleases.insert(m_pendingReleases.end(),
+						std::make_move_iterator(releases.begin()), std::make_move_iterator(releases.end()));
+				});
+				pool->run(m_evictTask);
+			}
+			else
+			{
+				prune();
+			}
+		}
+
+		const auto stats = getStatistics();
+		cVarLRUHits.set(clampToInt32(stats.hits));
+		cVarLRUMisses.set(clampToInt32(stats.misses));
+		cVarLRUEvictedMB.set(clampToInt32(stats.evictedBytes / (1024 * 1024)));
+		cVarLRUFallbackUses.set(clampToInt32(stats.fallbackUses));
+		cVarLRUUsedMB.set(clampToInt32(stats.usedSize / (1024 * 1024)));
+
+		CVarCmdHandle(cVarDumpLRUStatistics, [&]()
+		{
+			LOG_INFO("LRU cache: used {0} MB (texture {1} MB, static mesh {2} MB, other {3} MB), capacity {4} MB, elasticity {5} MB.",
+				stats.usedSize / (1024 * 1024),
+				stats.typeUsedSize[size_t(ELRUAssetType::Texture)] / (1024 * 1024),
+				stats.typeUsedSize[size_t(ELRUAssetType::StaticMesh)] / (1024 * 1024),
+				stats.typeUsedSize[size_t(ELRUAssetType::Other)] / (1024 * 1024),
+				m_capacity / (1024 * 1024), m_elasticity / (1024 * 1024));
+			LOG_INFO("LRU cache: {0} hits, {1} misses, evicted {2} assets ({3} MB), fallback used {4} times.",
+				stats.hits, stats.misses, stats.evictedCount, stats.evictedBytes / (1024 * 1024), stats.fallbackUses);
+		});
+	}
+
+	LRUAssetCache::Statistics LRUAssetCache::getStatistics() const
+	{
+		Statistics stats { };
+		for (const auto& shard : m_shards)
+		{
+			stats.hits += shard.hits.load(std::memory_order_relaxed);
+			stats.misses += shard.misses.load(std::memory_order_relaxed);
+		}
+
+		stats.evictedBytes = m_evictedBytes.load(std::memory_order_relaxed);
+		stats.evictedCount = m_evictedCount.load(std::memory_order_relaxed);
+		stats.fallbackUses = LRUAssetInterface::getFallbackUseCount();
+
+		stats.usedSize = m_usedSize.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < stats.typeUsedSize.size(); i++)
+		{
+			stats.typeUsedSize[i] = m_typeUsedSize[i].load(std::memory_order_relaxed);
+		}
+
+		return stats;
+	}
+
+	void LRUAssetCache::clear()
+	{
+		if (m_evictTask.isValid())
+		{
+			ThreadPool::getDefault()->wait(m_evictTask);
+			m_evictTask = { };
+		}
+		releasePendingAssets();
+
+		for (auto& shard : m_shards)
+		{
+			std::unordered_map<KeyType, std::unique_ptr<Entry>> ownerMap;
+			{
+				std::unique_lock lock(shard.mutex);
+
+				// Remove size inside shard lock same as evict, insert on other thread keep its size.
+				for (const auto& [key, entry] : shard.ownerMap)
+				{
+					m_usedSize.fetch_sub(entry->size, std::memory_order_relaxed);
+					m_typeUsedSize[size_t(entry->type)].fetch_sub(entry->size, std::memory_order_relaxed);
+				}
+
+				ownerMap.swap(shard.ownerMap);
+				shard.weakMap.clear();
+			}
+		}
+	}
+}
@@ -1,8 +1,20 @@
 #pragma once
 #include <util/util.h>
 
+#include <shared_mutex>
+
 namespace engine
 {
+	// Asset type for per type lru size accounting.
+	enum class ELRUAssetType : uint8_t
+	{
+		Texture,
+		StaticMesh,
+		Other,
+
+		Max,
+	};
+
 	// LRU asset interface.
 	class LRUAssetInterface : NonCopyable
 	{
@@ -26,6 +38,9 @@ namespace engine
 		// This asset memory size.
 		virtual size_t getSize() const = 0;
 
+		// This asset type, only used for lru statistics.
+		virtual ELRUAssetType getLRUType() const { return ELRUAssetType::Other; }
+
 		template<typename T>
 		T* getReadyAsset()
 		{
@@ -34,193 +49,127 @@ namespace engine
 			if (isAssetLoading())
 			{
 				CHECK(m_fallback && "Loading asset must exist one fallback.");
+				s_fallbackUseCount.fetch_add(1, std::memory_order_relaxed);
 				return dynamic_cast<T*>(m_fallback);
 			}
 			return dynamic_cast<T*>(this);
 		}
 
+		// Total times fallback asset used because asset still loading.
+		static uint64_t getFallbackUseCount() { return s_fallbackUseCount.load(std::memory_order_relaxed); }
+
 	protected:
 		// The asset is under async loading.
 		std::atomic<bool> m_bAsyncLoading = true;
 
 		// Fallback asset when the asset is still loading.
 		LRUAssetInterface* m_fallback = nullptr;
+
+	private:
+		inline static std::atomic<uint64_t> s_fallbackUseCount = 0;
 	};
 
+	// Sharded lru asset cache, hit only take one shard shared lock and store an atomic access stamp.
+	// Access stamp is frame index, eviction sort stamps and evict oldest on background task,
+	// evicted assets hold until next main thread tick, gpu asset must release in main thread.
 	class LRUAssetCache : NonCopyable
 	{
 	public:
 		using ValueType = LRUAssetInterface;
 		using KeyType = UUID;
 
-		// Init lru asset cache with capacity and elasticity in MB unit.
-		explicit LRUAssetCache(size_t capacity, size_t elasticity)
-			: m_capacity(capacity * 1024 * 1024)
-			, m_elasticity(elasticity * 1024 * 1024)
+		struct Statistics
 		{
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictedBytes = 0;
+			uint64_t evictedCount = 0;
+			uint64_t fallbackUses = 0;
 
-		}
-
-		~LRUAssetCache()
-		{
+			size_t usedSize = 0;
+			std::array<size_t, size_t(ELRUAssetType::Max)> typeUsedSize { };
+		};
 
-		}
+		// Init lru asset cache with capacity and elasticity in MB unit.
+		explicit LRUAssetCache(size_t capacity, size_t elasticity);
+		~LRUAssetCache();
 
 		size_t getCapacity() const { return m_capacity; }
 		size_t getElasticity() const { return m_elasticity; }
 		size_t getMaxAllowedSize() const { return m_capacity + m_elasticity; }
 
 		// Current LRU owner shared_ptr map cache used size, no included asset owner by other actor.
-		size_t getOwnerUsedSize() const { return m_usedSize.load(); }
-
-		// Is contain current asset key.
-		bool contain(const KeyType& key)
-		{
-			// Need lock when search from weak ptr map.
-			std::lock_guard<std::mutex> lockGuard(m_lock);
-
-			// First search from lru owner map.
-			if (m_lruMap.contains(key))
-			{
-				return true;
-			}
+		size_t getOwnerUsedSize() const { return m_usedSize.load(std::memory_order_relaxed); }
+		size_t getOwnerUsedSize(ELRUAssetType type) const { return m_typeUsedSize[size_t(type)].load(std::memory_order_relaxed); }
 
-			// Then if lru owner map no exist, search from lru weak map.
-			if (m_cacheWeakPtrMap.contains(key))
-			{
-				if (auto lockPtr = m_cacheWeakPtrMap[key].lock())
-				{
-					return true;
-				}
-				else
-				{
-					// Erase unvalid waek ptr.
-					m_cacheWeakPtrMap.erase(key);
-
-					// Non valid pointer.
-					return false;
-				}
-			}
+		// Is contain current asset key, also count hit or miss.
+		bool contain(const KeyType& key);
 
-			return false;
-		}
+		// Clear all lru cache, wait background eviction finish.
+		void clear();
 
-		// Clear all lru cache.
-		void clear()
-		{
-			std::lock_guard<std::mutex> lockGuard(m_lock);
-			
-			// Make used size as zero.
-			m_usedSize = 0;
-
-			// LRU cache clear.
-			m_lruMap.clear();
-			m_lruList.clear();
-			m_cacheWeakPtrMap.clear();
-		}
+		// Insert one asset, oversize no prune here, next tick kick background eviction.
+		void insert(const KeyType& key, std::shared_ptr<ValueType> value);
 
-		// Insert one 
-		void insert(const KeyType& key, std::shared_ptr<ValueType> value)
-		{
-			std::lock_guard<std::mutex> lockGuard(m_lock);
+		// Try to get value, will return nullptr if no exist.
+		std::shared_ptr<ValueType> tryGet(const KeyType& key);
 
-			// Cache weak ptr value.
-			m_cacheWeakPtrMap[key] = value;
-			m_usedSize += value->getSize();
+		// Asset size change after insert (e.g. texture streaming mips), update size accounting if still owned.
+		void refreshSize(const KeyType& key);
 
-			// LRU asset can insert repeatly.
-			const auto iter = m_lruMap.find(key);
-			if (iter != m_lruMap.end())
-			{
-				// Key exist, update map value, and update list.
-				m_usedSize -= iter->second->second->getSize();
-				iter->second->second = value;
+		// Call once per frame in main thread, release evicted assets and kick eviction if oversize.
+		void tick();
 
-				m_lruList.splice(m_lruList.begin(), m_lruList, iter->second);
-				return;
-			}
+		// Evict in calling thread until used size under capacity, return evicted size, main thread only.
+		size_t prune();
 
-			// Key no exist, emplace to list front, and update map key-value.
-			m_lruList.emplace_front(key, std::move(value));
-			m_lruMap[key] = m_lruList.begin();
+		Statistics getStatistics() const;
 
-			// May oversize, need reduce.
-			prune();
-		}
+	protected:
+		static_assert(std::is_base_of_v<LRUAssetInterface, ValueType>, "Value type must derived from LRUAssetInterface");
 
-		// Try to get value, will return nullptr if no exist.
-		std::shared_ptr<ValueType> tryGet(const KeyType& inKey)
+		struct Entry
 		{
-			std::lock_guard<std::mutex> lockGuard(m_lock);
+			std::shared_ptr<ValueType> value;
 
-			// Else found in lru map.
-			const auto iter = m_lruMap.find(inKey);
-			if (iter == m_lruMap.end())
-			{
-				// May still valid in weak ptr cache, try get.
-				std::weak_ptr<ValueType> weakPtr = m_cacheWeakPtrMap[inKey];
-				if (auto sharePtr = weakPtr.lock())
-				{
-					return sharePtr;
-				}
-				else
-				{
-					// Unvalid weak ptr, remove.
-					m_cacheWeakPtrMap.erase(inKey);
-				}
-
-				// No valid instance, return nullptr and need reload.
-				return nullptr;
-			}
+			// Size and type cache when insert, eviction task no call virtual function of asset.
+			size_t size;
+			ELRUAssetType type;
 
-			// Still exist in lru map, set as first guy.
-			m_lruList.splice(m_lruList.begin(), m_lruList, iter->second);
-			return iter->second->second;
-		}
+			// Frame index of last access.
+			std::atomic<uint64_t> accessStamp;
+		};
 
-		// Prune lru map.
-		size_t prune(std::function<void(std::shared_ptr<ValueType>)>&& reduceFunction = nullptr)
+		struct alignas(CPU_CACHELINE_SIZE) Shard
 		{
-			size_t maxAllowed = m_capacity + m_elasticity;
-			if (m_capacity == 0 || m_usedSize < maxAllowed)
-			{
-				return 0;
-			}
+			mutable std::shared_mutex mutex;
 
-			// Loop until release enough resource.
-			size_t reduceSize = 0;
-			while (m_usedSize > m_capacity)
-			{
-				size_t eleSize = m_lruList.back().second->getSize();
+			std::unordered_map<KeyType, std::unique_ptr<Entry>> ownerMap;
+			std::unordered_map<KeyType, std::weak_ptr<ValueType>> weakMap;
 
-				// Do a callback if valid.
-				if (reduceFunction)
-				{
-					reduceFunction(m_lruList.back().second);
-				}
+			std::atomic<uint64_t> hits = 0;
+			std::atomic<uint64_t> misses = 0;
+		};
 
-				// Erase last one.
-				m_lruMap.erase(m_lruList.back().first);
-				m_lruList.pop_back();
+		static constexpr size_t kShardBits = 4;
+		static constexpr size_t kShardCount = size_t(1) << kShardBits;
 
-				// Update size.
-				m_usedSize -= eleSize;
-				reduceSize += eleSize;
-			}
+		// Shard pick high hash bits, map bucket inside shard use low bits.
+		Shard& getShard(const KeyType& key) { return m_shards[std::hash<KeyType>{}(key) >> (sizeof(size_t) * 8 - kShardBits)]; }
 
-			return reduceSize;
-		}
+		// Only store when stamp change, hit in same frame no dirty entry cache line.
+		void touch(Entry& entry) const;
 
-	protected:
-		static_assert(std::is_base_of_v<LRUAssetInterface, ValueType>, "Value type must derived from LRUAssetInterface");
+		// Evict oldest entries until used size under target size, evicted assets move to outReleases.
+		size_t evict(size_t targetSize, std::vector<std::shared_ptr<ValueType>>& outReleases);
 
-		using LRUList = std::list<std::pair<KeyType, std::shared_ptr<ValueType>>>;
-		using LRUListNode = LRUList::iterator;
+		// Erase expired weak ptr.
+		void sweepWeakPtrs();
 
-		// LRU data struct.
-		LRUList m_lruList;
-		std::unordered_map<KeyType, LRUListNode> m_lruMap;
-		std::unordered_map<KeyType, std::weak_ptr<ValueType>> m_cacheWeakPtrMap;
+		void releasePendingAssets();
+
+	protected:
+		std::array<Shard, kShardCount> m_shards;
 
 		// LRU cache desire capacity.
 		size_t m_capacity;
@@ -228,10 +177,21 @@ namespace engine
 		// Some elasticity space to enable LRU cache no always prune.
 		size_t m_elasticity;
 
-		// Shared_ptr(m_lruMap) used size.
+		// Owner map used size, total and per type.
 		std::atomic<size_t> m_usedSize = 0;
+		std::array<std::atomic<size_t>, size_t(ELRUAssetType::Max)> m_typeUsedSize { };
+
+		// Frame clock of access stamp.
+		std::atomic<uint64_t> m_clock = 1;
+
+		std::atomic<uint64_t> m_evictedBytes = 0;
+		std::atomic<uint64_t> m_evictedCount = 0;
+
+		// Background eviction task, only edit in main thread.
+		TaskHandle m_evictTask;
 
-		// Lock mutex for map edit.
-		std::mutex m_lock;
+		// Assets evicted by background task, wait main thread tick release.
+		std::mutex m_pendingReleaseMutex;
+		std::vector<std::shared_ptr<ValueType>> m_pendingReleases;
 	};
-}
\ No newline at end of file
+}
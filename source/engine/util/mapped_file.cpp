@@ -0,0 +1,138 @@
+#include "mapped_file.h"
+#include "macro.h"
+
+#include <utf8/cpp17.h>
+
+#if _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace engine
+{
+#if _WIN32
+	bool MappedFile::open(const std::filesystem::path& path)
+	{
+		close();
+
+		HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			LOG_ERROR("Open file {} for mapping failed.", utf8::utf16to8(path.u16string()));
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			LOG_ERROR("Create file mapping for {} failed.", utf8::utf16to8(path.u16string()));
+			CloseHandle(file);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			LOG_ERROR("Map view of file {} failed.", utf8::utf16to8(path.u16string()));
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		m_file = file;
+		m_mapping = mapping;
+		m_data = (const uint8_t*)view;
+		m_size = (size_t)fileSize.QuadPart;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping)
+		{
+			CloseHandle((HANDLE)m_mapping);
+		}
+		if (m_file)
+		{
+			CloseHandle((HANDLE)m_file);
+		}
+
+		m_data = nullptr;
+		m_size = 0;
+		m_mapping = nullptr;
+		m_file = nullptr;
+	}
+#else
+	bool MappedFile::open(const std::filesystem::path& path)
+	{
+		close();
+
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			LOG_ERROR("Open file {} for mapping failed.", utf8::utf16to8(path.u16string()));
+			return false;
+		}
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view == MAP_FAILED)
+		{
+			LOG_ERROR("Map file {} failed.", utf8::utf16to8(path.u16string()));
+			::close(file);
+			return false;
+		}
+
+		// Mostly stream through once when load asset.
+		madvise(view, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+
+		m_file = file;
+		m_data = (const uint8_t*)view;
+		m_size = (size_t)fileStat.st_size;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+		{
+			munmap((void*)m_data, m_size);
+		}
+		if (m_file >= 0)
+		{
+			::close(m_file);
+		}
+
+		m_data = nullptr;
+		m_size = 0;
+		m_file = -1;
+	}
+#endif
+}
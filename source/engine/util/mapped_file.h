@@ -0,0 +1,37 @@
+#pragma once
+
+#include "noncopyable.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+
+namespace engine
+{
+	// Read only memory mapped file, os page cache back the memory so no heap copy when read.
+	class MappedFile : NonCopyable
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile() { close(); }
+
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		bool isOpen() const { return m_data != nullptr; }
+
+		const uint8_t* getData() const { return m_data; }
+		size_t getSize() const { return m_size; }
+
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+
+#if _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#else
+		int m_file = -1;
+#endif
+	};
+}
@@ -2,6 +2,8 @@
 #include "math.h"
 #include "uuid.h"
 
+#include <vector>
+
 namespace engine
 {
     struct StaticMeshRenderBounds
@@ -19,6 +21,21 @@ namespace engine
 		}
 	};
 
+	// LOD0 and simplified LODs.
+	constexpr uint32_t kStaticMeshMaxLODCount = 4;
+
+	// Simplified LOD index range, store after all LOD0 indices in mesh index buffer.
+	struct StaticMeshLOD
+	{
+		uint32_t indicesStart = 0;
+		uint32_t indicesCount = 0;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(indicesStart, indicesCount);
+		}
+	};
+
 	struct StaticMeshSubMesh
 	{
 		uint32_t indicesStart = 0;
@@ -28,12 +45,45 @@ namespace engine
 		UUID material = {};
 		StaticMeshRenderBounds bounds = {};
 
+		// LOD1 and coarser, LOD0 is [indicesStart, indicesStart + indicesCount).
+		// Serialize by AssetStaticMesh with version check, keep old asset meta loadable.
+		std::vector<StaticMeshLOD> lods = {};
+
 		template<class Archive> void serialize(Archive& archive)
 		{
 			archive(indicesStart, indicesCount, material, bounds);
 		}
 	};
 
+	// Triangle cluster of submesh, indices of meshlet store continuous in mesh index buffer.
+	// Keep same layout with shared_struct.glsl, upload to gpu directly.
+	struct StaticMeshMeshlet
+	{
+		// Mesh local space bounding sphere, .xyz is center, .w is radius.
+		math::vec4 sphereBounds;
+
+		// Normal cone, .xyz is axis, .w is cutoff, cutoff >= 1.0 means no cone culling.
+		math::vec4 cone;
+
+		uint32_t indicesStart;
+		uint32_t indicesCount;
+		uint32_t pad0;
+		uint32_t pad1;
+	};
+	static_assert(sizeof(StaticMeshMeshlet) % (4 * sizeof(float)) == 0);
+
+	// Meshlets range of one submesh.
+	struct StaticMeshMeshletRange
+	{
+		uint32_t meshletStart = 0;
+		uint32_t meshletCount = 0;
+
+		template<class Archive> void serialize(Archive& archive)
+		{
+			archive(meshletStart, meshletCount);
+		}
+	};
+
     // Standard index type in this engine.
     using VertexIndexType = uint32_t;
 
@@ -0,0 +1,408 @@
+#include "mesh_simplify.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace engine
+{
+	namespace
+	{
+		// Border edge plane weight, keep open border shape.
+		constexpr double kBorderWeight = 10.0;
+
+		// Reject collapse which rotate triangle normal over ~75 degree.
+		constexpr float kFlipDotThreshold = 0.25f;
+
+		enum class EVertexKind : uint8_t
+		{
+			Manifold, // Can collapse to any neighbor.
+			Border,   // Only collapse along border edge.
+			Locked,   // Seam or complex vertex, never move.
+		};
+
+		// Symmetric quadric, error is weighted mean squared distance to planes.
+		struct Quadric
+		{
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+			double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+			double c = 0.0;
+			double w = 0.0;
+
+			static Quadric fromPlane(const math::dvec3& n, double d, double weight)
+			{
+				Quadric q;
+				q.a00 = weight * n.x * n.x; q.a01 = weight * n.x * n.y; q.a02 = weight * n.x * n.z;
+				q.a11 = weight * n.y * n.y; q.a12 = weight * n.y * n.z; q.a22 = weight * n.z * n.z;
+				q.b0 = weight * n.x * d; q.b1 = weight * n.y * d; q.b2 = weight * n.z * d;
+				q.c = weight * d * d;
+				q.w = weight;
+				return q;
+			}
+
+			void add(const Quadric& o)
+			{
+				a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+				b0 += o.b0; b1 += o.b1; b2 += o.b2;
+				c += o.c;
+				w += o.w;
+			}
+
+			double error(const math::vec3& pos) const
+			{
+				const double x = pos.x, y = pos.y, z = pos.z;
+
+				const double r =
+					a00 * x * x + a11 * y * y + a22 * z * z +
+					2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+					2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+				return std::abs(r) / std::max(w, 1e-12);
+			}
+		};
+
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			double error;
+		};
+
+		inline uint64_t edgeKey(uint32_t a, uint32_t b)
+		{
+			return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+		}
+	}
+
+	size_t simplifyMesh(
+		std::vector<VertexIndexType>& outIndices,
+		const VertexIndexType* indices,
+		size_t indexCount,
+		const std::vector<VertexPosition>& positions,
+		size_t targetIndexCount,
+		float targetError)
+	{
+		outIndices.assign(indices, indices + (indexCount - indexCount % 3));
+		if (outIndices.size() <= targetIndexCount)
+		{
+			return outIndices.size();
+		}
+
+		// Remap to local vertices, input usually only part of mesh vertices.
+		std::unordered_map<VertexIndexType, uint32_t> globalToLocal;
+		std::vector<VertexIndexType> localToGlobal;
+		std::vector<uint32_t> triangles(outIndices.size());
+		for (size_t i = 0; i < outIndices.size(); i++)
+		{
+			auto [iter, bInsert] = globalToLocal.try_emplace(outIndices[i], uint32_t(localToGlobal.size()));
+			if (bInsert)
+			{
+				localToGlobal.push_back(outIndices[i]);
+			}
+			triangles[i] = iter->second;
+		}
+
+		const uint32_t vertexCount = uint32_t(localToGlobal.size());
+		auto getPos = [&](uint32_t v) -> const math::vec3& { return positions[localToGlobal[v]]; };
+
+		// Error limit relative to bounds size.
+		double errorLimit;
+		{
+			math::vec3 minPos = getPos(0);
+			math::vec3 maxPos = getPos(0);
+			for (uint32_t v = 1; v < vertexCount; v++)
+			{
+				minPos = math::min(minPos, getPos(v));
+				maxPos = math::max(maxPos, getPos(v));
+			}
+			const math::vec3 extent = maxPos - minPos;
+			const double scale = double(targetError) * double(std::max(extent.x, std::max(extent.y, extent.z)));
+			errorLimit = scale * scale;
+		}
+
+		std::vector<EVertexKind> kinds(vertexCount, EVertexKind::Manifold);
+
+		// Lock seam vertices, different vertex with same position.
+		{
+			std::unordered_map<math::vec3, uint32_t> positionMap;
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				auto [iter, bInsert] = positionMap.try_emplace(getPos(v), v);
+				if (!bInsert)
+				{
+					kinds[v] = EVertexKind::Locked;
+					kinds[iter->second] = EVertexKind::Locked;
+				}
+			}
+		}
+
+		// Edge use count, border edge only use by one triangle, non-manifold edge lock its vertices.
+		std::unordered_map<uint64_t, uint32_t> edgeCounts;
+		for (size_t i = 0; i < triangles.size(); i += 3)
+		{
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				edgeCounts[edgeKey(triangles[i + k], triangles[i + (k + 1) % 3])]++;
+			}
+		}
+
+		std::vector<uint32_t> borderEdgeCounts(vertexCount, 0);
+		for (const auto& [key, count] : edgeCounts)
+		{
+			const uint32_t a = uint32_t(key >> 32);
+			const uint32_t b = uint32_t(key & 0xFFFFFFFF);
+			if (count == 1)
+			{
+				borderEdgeCounts[a]++;
+				borderEdgeCounts[b]++;
+			}
+			else if (count > 2)
+			{
+				kinds[a] = EVertexKind::Locked;
+				kinds[b] = EVertexKind::Locked;
+			}
+		}
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			if (kinds[v] == EVertexKind::Manifold && borderEdgeCounts[v] > 0)
+			{
+				// Border vertex with more than two border edges is complex, lock it.
+				kinds[v] = (borderEdgeCounts[v] == 2) ? EVertexKind::Border : EVertexKind::Locked;
+			}
+		}
+
+		// Plane quadrics, area weighted, border edge add perpendicular plane.
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < triangles.size(); i += 3)
+		{
+			const math::dvec3 p0 = getPos(triangles[i + 0]);
+			const math::dvec3 p1 = getPos(triangles[i + 1]);
+			const math::dvec3 p2 = getPos(triangles[i + 2]);
+
+			math::dvec3 n = math::cross(p1 - p0, p2 - p0);
+			const double area = math::length(n);
+			if (area < 1e-20)
+			{
+				continue;
+			}
+			n /= area;
+
+			const Quadric q = Quadric::fromPlane(n, -math::dot(n, p0), area * 0.5);
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				quadrics[triangles[i + k]].add(q);
+			}
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				const uint32_t a = triangles[i + k];
+				const uint32_t b = triangles[i + (k + 1) % 3];
+				if (edgeCounts[edgeKey(a, b)] != 1)
+				{
+					continue;
+				}
+
+				const math::dvec3 pa = getPos(a);
+				const math::dvec3 edge = math::dvec3(getPos(b)) - pa;
+				const double edgeLength = math::length(edge);
+				if (edgeLength < 1e-20)
+				{
+					continue;
+				}
+
+				const math::dvec3 borderN = math::normalize(math::cross(edge, n));
+				const Quadric borderQ = Quadric::fromPlane(borderN, -math::dot(borderN, pa), edgeLength * edgeLength * kBorderWeight);
+				quadrics[a].add(borderQ);
+				quadrics[b].add(borderQ);
+			}
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacencyTriangles;
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint8_t> touched(vertexCount);
+		std::vector<Collapse> collapses;
+
+		// Each pass collapse a batch of independent edges, order by error.
+		while (triangles.size() > targetIndexCount)
+		{
+			const uint32_t triangleCount = uint32_t(triangles.size() / 3);
+
+			// Vertex to triangle adjacency.
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (uint32_t v : triangles)
+			{
+				adjacencyOffsets[v + 1]++;
+			}
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+			}
+			adjacencyTriangles.resize(triangles.size());
+			{
+				std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (uint32_t i = 0; i < uint32_t(triangles.size()); i++)
+				{
+					adjacencyTriangles[fillOffsets[triangles[i]]++] = i / 3;
+				}
+			}
+
+			auto triangleContain = [&](uint32_t t, uint32_t v)
+			{
+				return triangles[t * 3 + 0] == v || triangles[t * 3 + 1] == v || triangles[t * 3 + 2] == v;
+			};
+
+			// Triangles count share edge (u, v).
+			auto edgeTriangleCount = [&](uint32_t u, uint32_t v)
+			{
+				uint32_t count = 0;
+				for (uint32_t a = adjacencyOffsets[u]; a < adjacencyOffsets[u + 1]; a++)
+				{
+					count += triangleContain(adjacencyTriangles[a], v) ? 1 : 0;
+				}
+				return count;
+			};
+
+			auto canCollapse = [&](uint32_t u, uint32_t v)
+			{
+				switch (kinds[u])
+				{
+				case EVertexKind::Manifold: return true;
+				case EVertexKind::Border:   return kinds[v] != EVertexKind::Manifold && edgeTriangleCount(u, v) == 1;
+				default: return false;
+				}
+			};
+
+			// Collect collapse candidates, shared edge push twice but second one skip when apply.
+			collapses.clear();
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t u = triangles[t * 3 + k];
+					const uint32_t v = triangles[t * 3 + (k + 1) % 3];
+
+					for (const auto [from, to] : { std::pair{ u, v }, std::pair{ v, u } })
+					{
+						if (!canCollapse(from, to))
+						{
+							continue;
+						}
+
+						Quadric q = quadrics[from];
+						q.add(quadrics[to]);
+
+						const double error = q.error(getPos(to));
+						if (error <= errorLimit)
+						{
+							collapses.push_back({ from, to, error });
+						}
+					}
+				}
+			}
+
+			if (collapses.empty())
+			{
+				break;
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+			// Collapse u to v move all triangles of u, check no triangle flip.
+			auto isFlip = [&](uint32_t u, uint32_t v)
+			{
+				const math::vec3& newPos = getPos(v);
+				for (uint32_t a = adjacencyOffsets[u]; a < adjacencyOffsets[u + 1]; a++)
+				{
+					const uint32_t t = adjacencyTriangles[a];
+					if (triangleContain(t, v))
+					{
+						continue;
+					}
+
+					math::vec3 p[3];
+					math::vec3 q[3];
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						p[k] = getPos(triangles[t * 3 + k]);
+						q[k] = triangles[t * 3 + k] == u ? newPos : p[k];
+					}
+
+					const math::vec3 n0 = math::cross(p[1] - p[0], p[2] - p[0]);
+					const math::vec3 n1 = math::cross(q[1] - q[0], q[2] - q[0]);
+					if (math::dot(n0, n1) < kFlipDotThreshold * math::length(n0) * math::length(n1))
+					{
+						return true;
+					}
+				}
+				return false;
+			};
+
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				remap[v] = v;
+			}
+			std::fill(touched.begin(), touched.end(), 0);
+
+			// Each edge collapse remove one (border) or two triangles.
+			const size_t removeTriangleBudget = (triangles.size() - targetIndexCount) / 3;
+			size_t removeTriangles = 0;
+			size_t collapseCount = 0;
+
+			for (const auto& collapse : collapses)
+			{
+				const uint32_t u = collapse.from;
+				const uint32_t v = collapse.to;
+				if (touched[u] || touched[v] || isFlip(u, v))
+				{
+					continue;
+				}
+
+				remap[u] = v;
+				quadrics[v].add(quadrics[u]);
+				collapseCount++;
+				removeTriangles += edgeTriangleCount(u, v);
+
+				// Triangles around u change, lock their vertices in this pass keep flip check valid.
+				for (uint32_t a = adjacencyOffsets[u]; a < adjacencyOffsets[u + 1]; a++)
+				{
+					const uint32_t t = adjacencyTriangles[a];
+					touched[triangles[t * 3 + 0]] = 1;
+					touched[triangles[t * 3 + 1]] = 1;
+					touched[triangles[t * 3 + 2]] = 1;
+				}
+
+				if (removeTriangles >= removeTriangleBudget)
+				{
+					break;
+				}
+			}
+
+			if (collapseCount == 0)
+			{
+				break;
+			}
+
+			// Apply remap and drop degenerate triangles.
+			size_t writePos = 0;
+			for (size_t i = 0; i < triangles.size(); i += 3)
+			{
+				const uint32_t a = remap[triangles[i + 0]];
+				const uint32_t b = remap[triangles[i + 1]];
+				const uint32_t c = remap[triangles[i + 2]];
+				if (a != b && b != c && a != c)
+				{
+					triangles[writePos++] = a;
+					triangles[writePos++] = b;
+					triangles[writePos++] = c;
+				}
+			}
+			triangles.resize(writePos);
+		}
+
+		outIndices.resize(triangles.size());
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			outIndices[i] = localToGlobal[triangles[i]];
+		}
+		return outIndices.size();
+	}
+}
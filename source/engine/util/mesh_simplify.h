@@ -0,0 +1,19 @@
+#pragma once
+
+#include "mesh_misc.h"
+#include <vector>
+
+namespace engine
+{
+	// Quadric error metric edge collapse simplify, output indices only reference source vertices, no new vertex.
+	// Vertex share same position with other vertex (uv or normal seam) keep locked, avoid crack on seam.
+	// Target error is max collapse distance relative to input triangles bounds size.
+	// Stop when reach target index count or no valid collapse under target error, return output index count.
+	size_t simplifyMesh(
+		std::vector<VertexIndexType>& outIndices,
+		const VertexIndexType* indices,
+		size_t indexCount,
+		const std::vector<VertexPosition>& positions,
+		size_t targetIndexCount,
+		float targetError);
+}
@@ -0,0 +1,303 @@
+#include "profiler.h"
+#include "macro.h"
+#include "cvars.h"
+#include "framework.h"
+
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <string_view>
+
+namespace engine
+{
+	static AutoCVarBool cVarProfilerEnable(
+		"r.profiler.enable",
+		"Enable cpu and gpu scope profiler.",
+		"Profiler",
+		true,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarProfilerCaptureFrames(
+		"r.profiler.captureFrames",
+		"Frame count of one profiler capture.",
+		"Profiler",
+		60,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarCmd cVarProfilerCapture("cmd.profiler.capture", "Capture profiler frames and export chrome trace json to log folder.");
+
+	static const auto kProfilerStartTime = std::chrono::steady_clock::now();
+
+	Profiler* Profiler::get()
+	{
+		static Profiler profiler;
+		return &profiler;
+	}
+
+	uint64_t Profiler::nowNs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kProfilerStartTime).count();
+	}
+
+	Profiler::Profiler()
+	{
+		m_gpuBuffer = createThreadBuffer("GPU");
+	}
+
+	Profiler::ThreadBuffer* Profiler::createThreadBuffer(const std::string& name)
+	{
+		std::lock_guard lock(m_threadMutex);
+
+		auto buffer = std::make_unique<ThreadBuffer>();
+		buffer->threadIndex = (uint32_t)m_threadBuffers.size();
+		buffer->name = name.empty() ? ("Thread " + std::to_string(buffer->threadIndex)) : name;
+
+		m_threadBuffers.push_back(std::move(buffer));
+		return m_threadBuffers.back().get();
+	}
+
+	Profiler::ThreadBuffer* Profiler::requireThreadBuffer()
+	{
+		thread_local ThreadBuffer* tlsBuffer = nullptr;
+		if (tlsBuffer == nullptr)
+		{
+			tlsBuffer = createThreadBuffer({});
+		}
+		return tlsBuffer;
+	}
+
+	void Profiler::setThreadName(const std::string& name)
+	{
+		ThreadBuffer* buffer = requireThreadBuffer();
+
+		std::lock_guard lock(m_threadMutex);
+		buffer->name = name;
+	}
+
+	void Profiler::pushEvent(ThreadBuffer& buffer, const Event& event)
+	{
+		const uint32_t writePos = buffer.writePos.load(std::memory_order_relaxed);
+		if (writePos - buffer.readPos.load(std::memory_order_acquire) >= ThreadBuffer::kCapacity)
+		{
+			// Main thread no drain yet, drop event rather than block owner thread.
+			buffer.dropCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.events[writePos & (ThreadBuffer::kCapacity - 1)] = event;
+		buffer.writePos.store(writePos + 1, std::memory_order_release);
+	}
+
+	void Profiler::pushCPUEvent(const char* name, uint64_t beginNs, uint64_t endNs)
+	{
+		pushEvent(*requireThreadBuffer(), { name, beginNs, endNs });
+	}
+
+	void Profiler::pushGPUEvent(const std::string& name, uint64_t beginNs, uint64_t endNs)
+	{
+		const char* internName = m_internNames.insert(name).first->c_str();
+		pushEvent(*m_gpuBuffer, { internName, beginNs, endNs });
+	}
+
+	void Profiler::beginFrame()
+	{
+		m_bEnable = cVarProfilerEnable.get() || isCapturing();
+
+		m_frameIndex++;
+		m_frameBeginNs = nowNs();
+	}
+
+	uint32_t Profiler::drainEvents()
+	{
+		std::vector<ThreadBuffer*> buffers;
+		{
+			std::lock_guard lock(m_threadMutex);
+			for (const auto& buffer : m_threadBuffers)
+			{
+				buffers.push_back(buffer.get());
+			}
+		}
+
+		uint32_t dropCount = 0;
+		std::unordered_map<std::string_view, uint32_t> statIndices;
+		for (ThreadBuffer* buffer : buffers)
+		{
+			statIndices.clear();
+
+			const uint32_t writePos = buffer->writePos.load(std::memory_order_acquire);
+			const uint32_t readPos = buffer->readPos.load(std::memory_order_relaxed);
+			for (uint32_t i = readPos; i != writePos; i++)
+			{
+				const Event& event = buffer->events[i & (ThreadBuffer::kCapacity - 1)];
+
+				auto [iter, bInserted] = statIndices.try_emplace(event.name, (uint32_t)m_frameStats.size());
+				if (bInserted)
+				{
+					m_frameStats.push_back({ event.name, buffer->threadIndex, 0, 0.0 });
+				}
+
+				auto& stat = m_frameStats[iter->second];
+				stat.count++;
+				stat.totalMs += double(event.endNs - event.beginNs) * 1e-6;
+
+				if (isCapturing())
+				{
+					m_captureEvents.push_back({ event, buffer->threadIndex });
+				}
+			}
+			buffer->readPos.store(writePos, std::memory_order_release);
+
+			dropCount += buffer->dropCount.exchange(0, std::memory_order_relaxed);
+		}
+
+		return dropCount;
+	}
+
+	void Profiler::endFrame()
+	{
+		const uint64_t frameEndNs = nowNs();
+		if (isEnable())
+		{
+			pushCPUEvent("Frame", m_frameBeginNs, frameEndNs);
+		}
+		m_lastFrameMs = double(frameEndNs - m_frameBeginNs) * 1e-6;
+
+		m_frameStats.clear();
+		if (const uint32_t dropCount = drainEvents(); dropCount > 0)
+		{
+			LOG_WARN("Profiler drop {0} events in frame {1}, thread ring full.", dropCount, m_frameIndex);
+		}
+
+		std::sort(m_frameStats.begin(), m_frameStats.end(), [](const EventStat& a, const EventStat& b)
+		{
+			return a.threadIndex != b.threadIndex ? a.threadIndex < b.threadIndex : a.totalMs > b.totalMs;
+		});
+		m_lastFrameStats.swap(m_frameStats);
+
+		if (m_captureFramesLeft > 0)
+		{
+			m_captureFramesLeft--;
+			if (m_captureFramesLeft == 0)
+			{
+				if (exportChromeTrace(m_capturePath))
+				{
+					LOG_INFO("Profiler capture export to {0}.", m_capturePath.string());
+				}
+				m_captureEvents.clear();
+				m_captureEvents.shrink_to_fit();
+				m_bCaptureFinished = true;
+			}
+		}
+
+		CVarCmdHandle(cVarProfilerCapture, [&]()
+		{
+			const auto path = std::filesystem::path(Framework::get()->getConfig().logFolder) / ("profile_" + std::to_string(m_frameIndex) + ".json");
+			beginCapture((uint32_t)std::max(1, cVarProfilerCaptureFrames.get()), path);
+		});
+	}
+
+	void Profiler::beginCapture(uint32_t frameCount, const std::filesystem::path& path)
+	{
+		if (isCapturing())
+		{
+			LOG_WARN("Profiler capture already in progress, skip new capture.");
+			return;
+		}
+
+		m_captureFramesLeft = frameCount;
+		m_capturePath = path;
+		m_captureEvents.clear();
+		m_bEnable = true;
+
+		LOG_INFO("Profiler begin capture {0} frames.", frameCount);
+	}
+
+	static void writeJsonString(std::ofstream& os, std::string_view str)
+	{
+		os << '"';
+		for (const char c : str)
+		{
+			switch (c)
+			{
+			case '"':  os << "\\\""; break;
+			case '\\': os << "\\\\"; break;
+			case '\n': os << "\\n";  break;
+			case '\t': os << "\\t";  break;
+			default:
+				if ((unsigned char)c < 0x20)
+				{
+					os << ' ';
+				}
+				else
+				{
+					os << c;
+				}
+			}
+		}
+		os << '"';
+	}
+
+	bool Profiler::exportChromeTrace(const std::filesystem::path& path) const
+	{
+		if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+		{
+			std::filesystem::create_directories(path.parent_path());
+		}
+
+		std::ofstream os(path, std::ios::trunc);
+		if (!os.is_open())
+		{
+			LOG_ERROR("Profiler fail to open {0} for chrome trace export.", path.string());
+			return false;
+		}
+
+		// Chrome trace use microseconds.
+		os.setf(std::ios::fixed);
+		os.precision(3);
+
+		os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		bool bFirst = true;
+		auto beginEntry = [&]()
+		{
+			if (!bFirst)
+			{
+				os << ",\n";
+			}
+			bFirst = false;
+		};
+
+		{
+			std::lock_guard lock(m_threadMutex);
+			for (const auto& buffer : m_threadBuffers)
+			{
+				beginEntry();
+				os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex << ",\"args\":{\"name\":";
+				writeJsonString(os, buffer->name);
+				os << "}}";
+
+				beginEntry();
+				os << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex << ",\"args\":{\"sort_index\":" << buffer->threadIndex << "}}";
+			}
+		}
+
+		for (const auto& captureEvent : m_captureEvents)
+		{
+			const Event& event = captureEvent.event;
+
+			beginEntry();
+			os << "{\"name\":";
+			writeJsonString(os, event.name);
+			os << ",\"cat\":\"" << (captureEvent.threadIndex == m_gpuBuffer->threadIndex ? "gpu" : "cpu") << "\""
+			   << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << captureEvent.threadIndex
+			   << ",\"ts\":" << double(event.beginNs) * 1e-3
+			   << ",\"dur\":" << double(event.endNs - event.beginNs) * 1e-3 << "}";
+		}
+
+		os << "\n]}\n";
+		return os.good();
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "noncopyable.h"
+#include "cacheline.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <filesystem>
+
+namespace engine
+{
+	// Scoped cpu profiler, each thread write own lock free ring, main thread drain them when frame end.
+	// GPU timestamps push to same timeline, so one capture can export cpu and gpu into one chrome trace.
+	class Profiler : NonCopyable
+	{
+	public:
+		struct Event
+		{
+			// Name must keep alive whole app life, string literal or interned name.
+			const char* name;
+			uint64_t beginNs;
+			uint64_t endNs;
+		};
+
+		// Event aggregate by name of one frame.
+		struct EventStat
+		{
+			const char* name;
+			uint32_t threadIndex;
+			uint32_t count;
+			double totalMs;
+		};
+
+		static Profiler* get();
+
+		// Nanoseconds since profiler create, all cpu and gpu events use this timeline.
+		static uint64_t nowNs();
+
+		bool isEnable() const { return m_bEnable.load(std::memory_order_relaxed); }
+
+		// Set name of current thread show in trace.
+		void setThreadName(const std::string& name);
+
+		// Push one event of current thread, lock free, drop when ring full.
+		void pushCPUEvent(const char* name, uint64_t beginNs, uint64_t endNs);
+
+		// Push gpu event which already convert to cpu timeline, only call on main thread.
+		void pushGPUEvent(const std::string& name, uint64_t beginNs, uint64_t endNs);
+
+		// Main thread call once per frame.
+		void beginFrame();
+		void endFrame();
+
+		// Aggregate stats of last frame, sort by thread then total time.
+		const std::vector<EventStat>& getLastFrameStats() const { return m_lastFrameStats; }
+		double getLastFrameMs() const { return m_lastFrameMs; }
+
+		// Capture next frames, export chrome trace json to path when finish.
+		void beginCapture(uint32_t frameCount, const std::filesystem::path& path);
+		bool isCapturing() const { return m_captureFramesLeft > 0; }
+
+		// Capture finish and export at least once.
+		bool isCaptureFinished() const { return m_bCaptureFinished; }
+
+		bool exportChromeTrace(const std::filesystem::path& path) const;
+
+		// Thread index of current thread in stats and trace.
+		uint32_t getCurrentThreadIndex() { return requireThreadBuffer()->threadIndex; }
+
+	private:
+		Profiler();
+
+		struct ThreadBuffer
+		{
+			static constexpr uint32_t kCapacity = 1U << 14;
+
+			std::unique_ptr<Event[]> events = std::make_unique<Event[]>(kCapacity);
+
+			// Owner thread write, main thread read.
+			alignas(CPU_CACHELINE_SIZE) std::atomic<uint32_t> writePos = 0;
+			alignas(CPU_CACHELINE_SIZE) std::atomic<uint32_t> readPos = 0;
+			std::atomic<uint32_t> dropCount = 0;
+
+			uint32_t threadIndex = 0;
+			std::string name;
+		};
+
+		struct CaptureEvent
+		{
+			Event event;
+			uint32_t threadIndex;
+		};
+
+		ThreadBuffer* requireThreadBuffer();
+		ThreadBuffer* createThreadBuffer(const std::string& name);
+
+		static void pushEvent(ThreadBuffer& buffer, const Event& event);
+
+		// Drain all thread rings, return drop count.
+		uint32_t drainEvents();
+
+	private:
+		std::atomic<bool> m_bEnable = true;
+		uint64_t m_frameIndex = 0;
+		uint64_t m_frameBeginNs = 0;
+
+		// Thread buffers never release, thread local pointer keep valid.
+		mutable std::mutex m_threadMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+		ThreadBuffer* m_gpuBuffer = nullptr;
+
+		// GPU label interned to stable pointer.
+		std::unordered_set<std::string> m_internNames;
+
+		// Frame aggregation.
+		std::vector<EventStat> m_frameStats;
+		std::vector<EventStat> m_lastFrameStats;
+		double m_lastFrameMs = 0.0;
+
+		// Capture state.
+		uint32_t m_captureFramesLeft = 0;
+		bool m_bCaptureFinished = false;
+		std::filesystem::path m_capturePath;
+		std::vector<CaptureEvent> m_captureEvents;
+	};
+
+	class ScopeCPUProfiler : NonCopyable
+	{
+	public:
+		explicit ScopeCPUProfiler(const char* name)
+		{
+			if (Profiler::get()->isEnable())
+			{
+				m_name = name;
+				m_beginNs = Profiler::nowNs();
+			}
+		}
+
+		~ScopeCPUProfiler()
+		{
+			if (m_name)
+			{
+				Profiler::get()->pushCPUEvent(m_name, m_beginNs, Profiler::nowNs());
+			}
+		}
+
+	private:
+		const char* m_name = nullptr;
+		uint64_t m_beginNs = 0;
+	};
+}
+
+#define CPU_PROFILER_SCOPE_CONCAT_IMPL(a, b) a##b
+#define CPU_PROFILER_SCOPE_CONCAT(a, b) CPU_PROFILER_SCOPE_CONCAT_IMPL(a, b)
+
+// Profile current scope, name must be string literal.
+#define CPU_PROFILER_SCOPE(name) ::engine::ScopeCPUProfiler CPU_PROFILER_SCOPE_CONCAT(__cpuProfilerScope, __LINE__)(name)
@@ -333,6 +333,10 @@ namespace engine
         float displayWidth;
         float displayHeight;
 
+        math::uvec4 textureStreaming; // .x is texture streaming feedback buffer bindless index, ~0 is disable.
+
+        math::vec4 staticMeshLOD; // .x is lod screen size scale, .y is force lod when >= 0.
+
         GPUSkyInfo sky;
     };
     static_assert(sizeof(GPUPerFrameData) % (4 * sizeof(float)) == 0);
@@ -411,7 +415,15 @@ namespace engine
         uint32_t positionsPrevArrayId;
         uint32_t objectType = uint32_t(EStaticMeshType::StaticMesh); // == 0 is static mesh, == 1 is pmx static mesh.
         uint32_t smoothNormalArrayId;
-        uint32_t pad1;
+        uint32_t meshletsArrayId;  // Meshlets buffer in bindless buffer id.
+
+        uint32_t meshletStart = 0; // Submesh meshlets range, count zero means draw whole submesh without cluster culling.
+        uint32_t meshletCount = 0;
+        uint32_t lodCount = 1; // Valid lod count, meshlets only used when select LOD0.
+        uint32_t pad0;
+
+        math::uvec4 lodIndicesStart = math::uvec4(0); // LOD0 ~ LOD3 index range.
+        math::uvec4 lodIndicesCount = math::uvec4(0);
     };
     static_assert(sizeof(GPUStaticMeshPerObjectData) % (4 * sizeof(float)) == 0);
 
@@ -0,0 +1,314 @@
+#include "texture_compress.h"
+
+#include <stb/stb_dxt.h>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace engine
+{
+	void compressBlockBC1(uint8_t* dest, const uint8_t* srcRGBA)
+	{
+		stb_compress_dxt_block(dest, srcRGBA, 0, STB_DXT_HIGHQUAL);
+	}
+
+	void compressBlockBC4(uint8_t* dest, const uint8_t* srcR)
+	{
+		stb_compress_bc4_block(dest, srcR);
+	}
+
+	void compressBlockBC5(uint8_t* dest, const uint8_t* srcRG)
+	{
+		stb_compress_bc5_block(dest, srcRG);
+	}
+
+	namespace
+	{
+		// BC7 4 bit index interpolate weights.
+		constexpr int kBC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// Mode 6 endpoint: 7 bit per channel and one p bit, expand to 8 bit as (q << 1) | p.
+		struct BC7Mode6Endpoints
+		{
+			int q[2][4];
+			int p[2];
+		};
+
+		struct BC7Mode6Result
+		{
+			BC7Mode6Endpoints endpoints;
+			uint8_t indices[16];
+			uint32_t error = ~0U;
+		};
+
+		inline void quantizeEndpoint(const float in[4], int pbit, int outQ[4])
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				const int q = int(std::floor((in[c] - float(pbit)) * 0.5f + 0.5f));
+				outQ[c] = std::clamp(q, 0, 127);
+			}
+		}
+
+		// Select best index per pixel for quantized endpoints, return block squared error.
+		uint32_t selectIndices(const uint8_t* pixels, const BC7Mode6Endpoints& ep, uint8_t indices[16])
+		{
+			int palette[16][4];
+			for (int c = 0; c < 4; c++)
+			{
+				const int v0 = (ep.q[0][c] << 1) | ep.p[0];
+				const int v1 = (ep.q[1][c] << 1) | ep.p[1];
+				for (int i = 0; i < 16; i++)
+				{
+					palette[i][c] = ((64 - kBC7Weights4[i]) * v0 + kBC7Weights4[i] * v1 + 32) >> 6;
+				}
+			}
+
+			uint32_t totalError = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				const uint8_t* px = pixels + i * 4;
+
+				uint32_t bestError = ~0U;
+				uint8_t bestIndex = 0;
+				for (int j = 0; j < 16; j++)
+				{
+					const int dr = palette[j][0] - px[0];
+					const int dg = palette[j][1] - px[1];
+					const int db = palette[j][2] - px[2];
+					const int da = palette[j][3] - px[3];
+
+					const uint32_t error = uint32_t(dr * dr + dg * dg + db * db + da * da);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = uint8_t(j);
+					}
+				}
+
+				indices[i] = bestIndex;
+				totalError += bestError;
+			}
+			return totalError;
+		}
+
+		// Try all four p bit combination of float endpoints, keep the best in result.
+		void tryEndpoints(const uint8_t* pixels, const float e0[4], const float e1[4], BC7Mode6Result& result)
+		{
+			for (int pbits = 0; pbits < 4; pbits++)
+			{
+				BC7Mode6Endpoints ep;
+				ep.p[0] = pbits & 1;
+				ep.p[1] = pbits >> 1;
+				quantizeEndpoint(e0, ep.p[0], ep.q[0]);
+				quantizeEndpoint(e1, ep.p[1], ep.q[1]);
+
+				uint8_t indices[16];
+				const uint32_t error = selectIndices(pixels, ep, indices);
+				if (error < result.error)
+				{
+					result.error = error;
+					result.endpoints = ep;
+					memcpy(result.indices, indices, sizeof(indices));
+				}
+			}
+		}
+
+		// Least squares fit endpoints for fixed indices, return false when singular.
+		bool refineEndpoints(const uint8_t* pixels, const uint8_t indices[16], float e0[4], float e1[4])
+		{
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			float ax[4] = { }, bx[4] = { };
+			for (int i = 0; i < 16; i++)
+			{
+				const float w = float(kBC7Weights4[indices[i]]) / 64.0f;
+				const float a = 1.0f - w;
+
+				aa += a * a;
+				ab += a * w;
+				bb += w * w;
+				for (int c = 0; c < 4; c++)
+				{
+					ax[c] += a * float(pixels[i * 4 + c]);
+					bx[c] += w * float(pixels[i * 4 + c]);
+				}
+			}
+
+			const float det = aa * bb - ab * ab;
+			if (std::abs(det) < 1e-6f)
+			{
+				return false;
+			}
+
+			const float invDet = 1.0f / det;
+			for (int c = 0; c < 4; c++)
+			{
+				e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) * invDet, 0.0f, 255.0f);
+				e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) * invDet, 0.0f, 255.0f);
+			}
+			return true;
+		}
+
+		class BC7BitWriter
+		{
+		public:
+			explicit BC7BitWriter(uint8_t* dest) : m_dest(dest) { memset(m_dest, 0, 16); }
+
+			void write(uint32_t value, uint32_t count)
+			{
+				for (uint32_t i = 0; i < count; i++, m_pos++)
+				{
+					if ((value >> i) & 1U)
+					{
+						m_dest[m_pos >> 3] |= uint8_t(1U << (m_pos & 7));
+					}
+				}
+			}
+
+		private:
+			uint8_t* m_dest;
+			uint32_t m_pos = 0;
+		};
+	}
+
+	void compressBlockBC7(uint8_t* dest, const uint8_t* srcRGBA)
+	{
+		// Principal axis of block colors in rgba space.
+		float mean[4] = { };
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				mean[c] += float(srcRGBA[i * 4 + c]);
+			}
+		}
+		for (int c = 0; c < 4; c++)
+		{
+			mean[c] /= 16.0f;
+		}
+
+		float cov[4][4] = { };
+		for (int i = 0; i < 16; i++)
+		{
+			float d[4];
+			for (int c = 0; c < 4; c++)
+			{
+				d[c] = float(srcRGBA[i * 4 + c]) - mean[c];
+			}
+
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					cov[r][c] += d[r] * d[c];
+				}
+			}
+		}
+
+		// Power iteration, start from the max variance channel.
+		float axis[4] = { };
+		{
+			int maxChannel = 0;
+			for (int c = 1; c < 4; c++)
+			{
+				if (cov[c][c] > cov[maxChannel][maxChannel]) { maxChannel = c; }
+			}
+			axis[maxChannel] = 1.0f;
+
+			for (int iter = 0; iter < 8; iter++)
+			{
+				float next[4] = { };
+				for (int r = 0; r < 4; r++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						next[r] += cov[r][c] * axis[c];
+					}
+				}
+
+				const float len = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+				if (len < 1e-6f)
+				{
+					break;
+				}
+
+				for (int c = 0; c < 4; c++)
+				{
+					axis[c] = next[c] / len;
+				}
+			}
+		}
+
+		float minT = 0.0f;
+		float maxT = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < 4; c++)
+			{
+				t += (float(srcRGBA[i * 4 + c]) - mean[c]) * axis[c];
+			}
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		float e0[4];
+		float e1[4];
+		for (int c = 0; c < 4; c++)
+		{
+			e0[c] = std::clamp(mean[c] + minT * axis[c], 0.0f, 255.0f);
+			e1[c] = std::clamp(mean[c] + maxT * axis[c], 0.0f, 255.0f);
+		}
+
+		BC7Mode6Result result { };
+		tryEndpoints(srcRGBA, e0, e1, result);
+
+		// Refine endpoints with fixed indices, stop when no improve.
+		for (int iter = 0; iter < 2 && result.error > 0; iter++)
+		{
+			const uint32_t lastError = result.error;
+			if (!refineEndpoints(srcRGBA, result.indices, e0, e1))
+			{
+				break;
+			}
+
+			tryEndpoints(srcRGBA, e0, e1, result);
+			if (result.error >= lastError)
+			{
+				break;
+			}
+		}
+
+		// Anchor index msb must be zero, swap endpoints when break it.
+		BC7Mode6Endpoints& ep = result.endpoints;
+		if (result.indices[0] & 0x8)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				std::swap(ep.q[0][c], ep.q[1][c]);
+			}
+			std::swap(ep.p[0], ep.p[1]);
+
+			for (int i = 0; i < 16; i++)
+			{
+				result.indices[i] = uint8_t(15 - result.indices[i]);
+			}
+		}
+
+		BC7BitWriter writer(dest);
+		writer.write(1U << 6, 7); // Mode 6.
+		for (int c = 0; c < 4; c++)
+		{
+			writer.write(uint32_t(ep.q[0][c]), 7);
+			writer.write(uint32_t(ep.q[1][c]), 7);
+		}
+		writer.write(uint32_t(ep.p[0]), 1);
+		writer.write(uint32_t(ep.p[1]), 1);
+
+		writer.write(result.indices[0], 3);
+		for (int i = 1; i < 16; i++)
+		{
+			writer.write(result.indices[i], 4);
+		}
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine
+{
+	// 4x4 block compression helpers, all input block pixels store in row major order.
+	// BC1/BC4/BC5 wrap stb_dxt, BC7 use a single subset mode 6 encoder.
+
+	// 8 bytes output, rgba input with 4 bytes per pixel, alpha ignored.
+	void compressBlockBC1(uint8_t* dest, const uint8_t* srcRGBA);
+
+	// 8 bytes output, input 1 byte per pixel.
+	void compressBlockBC4(uint8_t* dest, const uint8_t* srcR);
+
+	// 16 bytes output, input 2 bytes per pixel.
+	void compressBlockBC5(uint8_t* dest, const uint8_t* srcRG);
+
+	// 16 bytes output, rgba input with 4 bytes per pixel.
+	void compressBlockBC7(uint8_t* dest, const uint8_t* srcRGBA);
+}
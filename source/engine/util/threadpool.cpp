@@ -1,10 +1,416 @@
 #include "threadpool.h"
+#include "profiler.h"
 
 namespace engine
 {
+	// Worker identity of current thread.
+	static thread_local const ThreadPool* tlsWorkerPool = nullptr;
+	static thread_local uint32_t tlsWorkerIndex = ~0U;
+
+	// Task memory cache per thread, avoid global allocator lock when task submit frequently.
+	struct ThreadPoolTaskCache
+	{
+		static constexpr size_t kMaxCacheNum = 1024;
+		std::vector<void*> freeTasks;
+
+		~ThreadPoolTaskCache()
+		{
+			for (void* ptr : freeTasks)
+			{
+				::operator delete(ptr, std::align_val_t(alignof(ThreadPoolTask)));
+			}
+		}
+	};
+	static thread_local ThreadPoolTaskCache tlsTaskCache;
+
+	static inline uint32_t xorshift32(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	void TaskHandle::release()
+	{
+		if (m_task)
+		{
+			ThreadPool::releaseTask(m_task);
+			m_task = nullptr;
+		}
+	}
+
+	bool ThreadPool::WorkerQueue::push(ThreadPoolTask* task)
+	{
+		const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_top.load(std::memory_order_acquire);
+		if (bottom - top >= kCapacity)
+		{
+			return false;
+		}
+
+		m_tasks[bottom & kMask].store(task, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	ThreadPoolTask* ThreadPool::WorkerQueue::pop()
+	{
+		const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// Empty queue.
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		ThreadPoolTask* task = m_tasks[bottom & kMask].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			// Last task, race with stealers.
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				task = nullptr;
+			}
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return task;
+	}
+
+	ThreadPoolTask* ThreadPool::WorkerQueue::steal()
+	{
+		int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom)
+		{
+			return nullptr;
+		}
+
+		ThreadPoolTask* task = m_tasks[top & kMask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			// Lost race with owner or other stealers.
+			return nullptr;
+		}
+		return task;
+	}
+
+	ThreadPoolTask* ThreadPool::allocateTask()
+	{
+		void* ptr = nullptr;
+		if (!tlsTaskCache.freeTasks.empty())
+		{
+			ptr = tlsTaskCache.freeTasks.back();
+			tlsTaskCache.freeTasks.pop_back();
+		}
+		else
+		{
+			ptr = ::operator new(sizeof(ThreadPoolTask), std::align_val_t(alignof(ThreadPoolTask)));
+		}
+		return new (ptr) ThreadPoolTask();
+	}
+
+	void ThreadPool::releaseTask(ThreadPoolTask* task)
+	{
+		if (task->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		task->~ThreadPoolTask();
+		if (tlsTaskCache.freeTasks.size() < ThreadPoolTaskCache::kMaxCacheNum)
+		{
+			tlsTaskCache.freeTasks.push_back(task);
+		}
+		else
+		{
+			::operator delete(task, std::align_val_t(alignof(ThreadPoolTask)));
+		}
+	}
+
+	ThreadPool::WorkerQueue* ThreadPool::getLocalQueue() const
+	{
+		return (tlsWorkerPool == this) ? m_workerQueues[tlsWorkerIndex].get() : nullptr;
+	}
+
+	void ThreadPool::schedule(ThreadPoolTask* task)
+	{
+		++m_tasksQueueTotalNum;
+
+		WorkerQueue* localQueue = getLocalQueue();
+		if (!localQueue || !localQueue->push(task))
+		{
+			const std::scoped_lock lock(m_injectQueueMutex);
+			m_injectQueue.push_back(task);
+			++m_injectQueueNum;
+		}
+
+		m_wakeSignal.fetch_add(1);
+		if (m_sleepingNum.load() > 0)
+		{
+			m_wakeSignal.notify_one();
+		}
+	}
+
+	ThreadPoolTask* ThreadPool::findTask(uint32_t& randomState)
+	{
+		// Local queue first, lifo is cache friendly.
+		WorkerQueue* localQueue = getLocalQueue();
+		if (localQueue)
+		{
+			if (ThreadPoolTask* task = localQueue->pop())
+			{
+				return task;
+			}
+		}
+
+		// Then outside thread push tasks.
+		if (m_injectQueueNum.load(std::memory_order_relaxed) > 0)
+		{
+			const std::scoped_lock lock(m_injectQueueMutex);
+			if (!m_injectQueue.empty())
+			{
+				ThreadPoolTask* task = m_injectQueue.front();
+				m_injectQueue.pop_front();
+				--m_injectQueueNum;
+				return task;
+			}
+		}
+
+		// Finally steal from random victim.
+		const uint32_t start = xorshift32(randomState) % m_threadCount;
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			WorkerQueue* victim = m_workerQueues[(start + i) % m_threadCount].get();
+			if (victim == localQueue)
+			{
+				continue;
+			}
+
+			if (ThreadPoolTask* task = victim->steal())
+			{
+				return task;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool ThreadPool::hasQueuedTask() const
+	{
+		return getTasksQueuedNum() > 0;
+	}
+
+	void ThreadPool::execute(ThreadPoolTask* task)
+	{
+		++m_tasksRunningNum;
+		{
+			task->invoke(task);
+			task->destroy(task);
+		}
+		--m_tasksRunningNum;
+
+		finish(task);
+
+		--m_tasksQueueTotalNum;
+		if (m_bWaiting)
+		{
+			const std::scoped_lock lock(m_taskDoneMutex);
+			m_cvTaskDone.notify_all();
+		}
+	}
+
+	void ThreadPool::finish(ThreadPoolTask* task)
+	{
+		if (task->unfinishedCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		ThreadPoolTask* parent = task->parent;
+
+		// Release scheduler reference.
+		releaseTask(task);
+
+		if (parent)
+		{
+			finish(parent);
+
+			// Release reference hold by child.
+			releaseTask(parent);
+		}
+	}
+
+	void ThreadPool::helpUntil(const TaskHandle& handle)
+	{
+		uint32_t randomState = uint32_t(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1U;
+		while (!handle.isFinished())
+		{
+			ThreadPoolTask* task = m_bPaused ? nullptr : findTask(randomState);
+			if (task)
+			{
+				execute(task);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void ThreadPool::worker(uint32_t workerIndex)
+	{
+		tlsWorkerPool = this;
+		tlsWorkerIndex = workerIndex;
+
+		Profiler::get()->setThreadName("Worker " + std::to_string(workerIndex));
+
+		// Spin some time before sleep, task usually come in burst.
+		constexpr uint32_t kSpinCount = 64;
+
+		uint32_t randomState = workerIndex * 7919U + 1U;
+		while (m_bRuning)
+		{
+			ThreadPoolTask* task = m_bPaused ? nullptr : findTask(randomState);
+			if (task)
+			{
+				execute(task);
+				continue;
+			}
+
+			bool bFound = false;
+			for (uint32_t i = 0; i < kSpinCount; i++)
+			{
+				std::this_thread::yield();
+				if (!m_bPaused && hasQueuedTask())
+				{
+					bFound = true;
+					break;
+				}
+			}
+
+			if (bFound)
+			{
+				continue;
+			}
+
+			// Load signal before check, so new task push after check can wake us.
+			const uint32_t signal = m_wakeSignal.load();
+			++m_sleepingNum;
+			if (m_bRuning && (m_bPaused || !hasQueuedTask()))
+			{
+				m_wakeSignal.wait(signal);
+			}
+			--m_sleepingNum;
+		}
+
+		tlsWorkerPool = nullptr;
+		tlsWorkerIndex = ~0U;
+	}
+
+	void ThreadPool::createThread()
+	{
+		m_bRuning = true;
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			m_threads[i] = std::thread(&ThreadPool::worker, this, i);
+		}
+	}
+
+	void ThreadPool::destroyThreads()
+	{
+		m_bRuning = false;
+		m_wakeSignal.fetch_add(1);
+		m_wakeSignal.notify_all();
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			m_threads[i].join();
+		}
+	}
+
+	void ThreadPool::setPause(bool bState)
+	{
+		m_bPaused = bState;
+		if (!bState)
+		{
+			m_wakeSignal.fetch_add(1);
+			m_wakeSignal.notify_all();
+		}
+	}
+
+	void ThreadPool::waitForTasks()
+	{
+		m_bWaiting = true;
+
+		std::unique_lock<std::mutex> tasksLock(m_taskDoneMutex);
+		m_cvTaskDone.wait(tasksLock, [this]
+		{
+			return (m_tasksQueueTotalNum == (m_bPaused ? getTasksQueuedNum() : 0));
+		});
+		m_bWaiting = false;
+	}
+
+	void ThreadPool::reset(bool bLeftOneFreeCore)
+	{
+		const bool wasPaused = m_bPaused;
+
+		m_bPaused = true;
+		waitForTasks();
+		destroyThreads();
+
+		// Paused tasks still in worker queues, move them to inject queue before worker queues rebuild.
+		{
+			const std::scoped_lock lock(m_injectQueueMutex);
+			for (uint32_t i = 0; i < m_threadCount; i++)
+			{
+				while (ThreadPoolTask* task = m_workerQueues[i]->steal())
+				{
+					m_injectQueue.push_back(task);
+					++m_injectQueueNum;
+				}
+			}
+		}
+
+		m_threadCount = getThreadCount(bLeftOneFreeCore);
+		m_threads = std::make_unique<std::thread[]>(m_threadCount);
+		m_workerQueues = std::make_unique<std::unique_ptr<WorkerQueue>[]>(m_threadCount);
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			m_workerQueues[i] = std::make_unique<WorkerQueue>();
+		}
+
+		m_bPaused = wasPaused;
+		createThread();
+	}
+
+	ThreadPool::ThreadPool(bool bLeftOneFreeCore)
+	{
+		m_threadCount = getThreadCount(bLeftOneFreeCore);
+		m_threads = std::make_unique<std::thread[]>(m_threadCount);
+		m_workerQueues = std::make_unique<std::unique_ptr<WorkerQueue>[]>(m_threadCount);
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			m_workerQueues[i] = std::make_unique<WorkerQueue>();
+		}
+		createThread();
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		waitForTasks();
+		destroyThreads();
+	}
+
 	ThreadPool* ThreadPool::getDefault()
 	{
 		static ThreadPool threadpool(true);
 		return &threadpool;
 	}
-}
\ No newline at end of file
+}
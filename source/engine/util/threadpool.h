@@ -1,13 +1,17 @@
 #pragma once
 
 #include "noncopyable.h"
+#include "cacheline.h"
 
 #include <vector>
+#include <deque>
 #include <future>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
+#include <atomic>
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <algorithm>
 #include <chrono>
@@ -64,80 +68,153 @@ namespace engine
 		}
 	};
 
-	class ThreadPool : NonCopyable
+	// Scheduler task, functor store inline when small enough, so most task no need extra heap allocation.
+	// Task finish when its own functor and all child tasks finish, then it will finish its parent.
+	struct alignas(CPU_CACHELINE_SIZE) ThreadPoolTask
 	{
-	private:
-		// Set this value to true to pause all task in this threadpool.
-		// Set this value to false to enable all task in this threadpool.
-		std::atomic<bool> m_bPaused = false;
+		using FuncType = void(*)(ThreadPoolTask*);
 
-		std::atomic<bool> m_bRuning = false;
-		std::atomic<bool> m_bWaiting = false;
+		static constexpr size_t kHeaderSize = sizeof(FuncType) * 2 + sizeof(ThreadPoolTask*) + sizeof(std::atomic<int32_t>) * 2;
+		static constexpr size_t kStorageSize = CPU_CACHELINE_SIZE * 2 - kHeaderSize;
 
-		std::condition_variable m_cvTaskAvailable;
-		std::condition_variable m_cvTaskDone;
+		FuncType invoke = nullptr;
+		FuncType destroy = nullptr;
+		ThreadPoolTask* parent = nullptr;
 
-		std::atomic<size_t> m_tasksQueueTotalNum = 0;
-		mutable std::mutex m_taskQueueMutex;
-		std::queue<std::function<void()>> m_tasksQueue;
+		// Self plus unfinished children.
+		std::atomic<int32_t> unfinishedCount = 1;
 
-		uint32_t m_threadCount = 0;
-		std::unique_ptr<std::thread[]> m_threads = nullptr;
+		// Hold by scheduler, task handles and children.
+		std::atomic<int32_t> refCount = 1;
 
-	private:
-		void worker()
+		alignas(std::max_align_t) std::byte storage[kStorageSize];
+
+		template<typename F>
+		void setFunctor(F&& func)
 		{
-			while (m_bRuning)
+			using Functor = std::decay_t<F>;
+			if constexpr (sizeof(Functor) <= kStorageSize && alignof(Functor) <= alignof(std::max_align_t))
+			{
+				new (storage) Functor(std::forward<F>(func));
+				invoke = [](ThreadPoolTask* task) { (*std::launder(reinterpret_cast<Functor*>(task->storage)))(); };
+				destroy = [](ThreadPoolTask* task) { std::launder(reinterpret_cast<Functor*>(task->storage))->~Functor(); };
+			}
+			else
 			{
-				std::function<void()> task;
+				// Large functor fallback to heap.
+				*reinterpret_cast<Functor**>(storage) = new Functor(std::forward<F>(func));
+				invoke = [](ThreadPoolTask* task) { (**reinterpret_cast<Functor**>(task->storage))(); };
+				destroy = [](ThreadPoolTask* task) { delete *reinterpret_cast<Functor**>(task->storage); };
+			}
+		}
+	};
+	static_assert(sizeof(ThreadPoolTask) == CPU_CACHELINE_SIZE * 2);
 
-				std::unique_lock<std::mutex> lockTasksQueue(m_taskQueueMutex);
-				m_cvTaskAvailable.wait(lockTasksQueue, [&]
-				{
-					// When task queue no empty, keep moving.
-					return !m_tasksQueue.empty() || !m_bRuning;
-				});
+	// Reference of one task, keep task memory valid until handle release.
+	class TaskHandle
+	{
+	public:
+		TaskHandle() = default;
+		~TaskHandle() { release(); }
 
-				if (m_bRuning && !m_bPaused)
-				{
-					task = std::move(m_tasksQueue.front());
-					m_tasksQueue.pop();
-
-					// Unlock so other thread can find task from queue.
-					lockTasksQueue.unlock();
-					task();
-
-					lockTasksQueue.lock();
-
-					// When task finish, we need lock again to minus queue num.
-					// Alway invoke new guy when waiting.
-					--m_tasksQueueTotalNum;
-					if (m_bWaiting)
-					{
-						m_cvTaskDone.notify_one();
-					}
-				}
+		TaskHandle(const TaskHandle& rhs) : m_task(rhs.m_task) { if (m_task) { m_task->refCount.fetch_add(1, std::memory_order_relaxed); } }
+		TaskHandle(TaskHandle&& rhs) noexcept : m_task(rhs.m_task) { rhs.m_task = nullptr; }
+
+		TaskHandle& operator=(const TaskHandle& rhs)
+		{
+			if (this != &rhs)
+			{
+				release();
+				m_task = rhs.m_task;
+				if (m_task) { m_task->refCount.fetch_add(1, std::memory_order_relaxed); }
 			}
+			return *this;
 		}
 
-		void createThread()
+		TaskHandle& operator=(TaskHandle&& rhs) noexcept
 		{
-			m_bRuning = true;
-			for (uint32_t i = 0; i < m_threadCount; i++)
+			if (this != &rhs)
 			{
-				m_threads[i] = std::thread(&ThreadPool::worker, this);
+				release();
+				m_task = rhs.m_task;
+				rhs.m_task = nullptr;
 			}
+			return *this;
 		}
 
-		void destroyThreads()
+		bool isValid() const { return m_task != nullptr; }
+		bool isFinished() const { return !m_task || m_task->unfinishedCount.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class ThreadPool;
+
+		explicit TaskHandle(ThreadPoolTask* task) : m_task(task) { }
+		void release();
+
+		ThreadPoolTask* m_task = nullptr;
+	};
+
+	// Work stealing threadpool.
+	// Every worker own one lock free deque, push and pop at bottom by owner, other workers steal from top.
+	// Task push from outside thread goes to one shared inject queue.
+	class ThreadPool : NonCopyable
+	{
+	private:
+		friend class TaskHandle;
+
+		// Chase-Lev deque with fixed capacity, owner push fail when full and caller fallback to inject queue.
+		class WorkerQueue
 		{
-			m_bRuning = false;
-			m_cvTaskAvailable.notify_all();
-			for (uint32_t i = 0; i < m_threadCount; i++)
+		public:
+			static constexpr int64_t kCapacity = 4096;
+			static constexpr int64_t kMask = kCapacity - 1;
+
+			bool push(ThreadPoolTask* task);
+			ThreadPoolTask* pop();
+			ThreadPoolTask* steal();
+
+			bool empty() const
 			{
-				m_threads[i].join();
+				return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
 			}
-		}
+
+		private:
+			alignas(CPU_CACHELINE_SIZE) std::atomic<int64_t> m_top = 0;
+			alignas(CPU_CACHELINE_SIZE) std::atomic<int64_t> m_bottom = 0;
+			alignas(CPU_CACHELINE_SIZE) std::atomic<ThreadPoolTask*> m_tasks[kCapacity];
+		};
+
+		// Set this value to true to pause all task in this threadpool.
+		// Set this value to false to enable all task in this threadpool.
+		std::atomic<bool> m_bPaused = false;
+
+		std::atomic<bool> m_bRuning = false;
+		std::atomic<bool> m_bWaiting = false;
+
+		// Worker sleep on this value when no task found, bump when new task push.
+		std::atomic<uint32_t> m_wakeSignal = 0;
+		std::atomic<uint32_t> m_sleepingNum = 0;
+
+		std::mutex m_taskDoneMutex;
+		std::condition_variable m_cvTaskDone;
+
+		// Scheduled but not execute finish task num, and executing task num.
+		std::atomic<size_t> m_tasksQueueTotalNum = 0;
+		std::atomic<size_t> m_tasksRunningNum = 0;
+
+		mutable std::mutex m_injectQueueMutex;
+		std::deque<ThreadPoolTask*> m_injectQueue;
+		std::atomic<size_t> m_injectQueueNum = 0;
+
+		uint32_t m_threadCount = 0;
+		std::unique_ptr<std::thread[]> m_threads = nullptr;
+		std::unique_ptr<std::unique_ptr<WorkerQueue>[]> m_workerQueues = nullptr;
+
+	private:
+		void worker(uint32_t workerIndex);
+
+		void createThread();
+		void destroyThreads();
 
 		inline uint32_t getThreadCount(bool bLeftOneFreeCore)
 		{
@@ -153,12 +230,40 @@ namespace engine
 			return result;
 		}
 
-	public:
-		void setPause(bool bState)
+		// Current thread worker queue, nullptr if current thread is not worker of this pool.
+		WorkerQueue* getLocalQueue() const;
+
+		static ThreadPoolTask* allocateTask();
+		static void releaseTask(ThreadPoolTask* task);
+
+		void schedule(ThreadPoolTask* task);
+		ThreadPoolTask* findTask(uint32_t& randomState);
+		bool hasQueuedTask() const;
+		void execute(ThreadPoolTask* task);
+		void finish(ThreadPoolTask* task);
+
+		// Execute other tasks until handle finish.
+		void helpUntil(const TaskHandle& handle);
+
+		template<typename F>
+		ThreadPoolTask* createTaskImpl(ThreadPoolTask* parent, F&& func)
 		{
-			m_bPaused = bState;
+			ThreadPoolTask* task = allocateTask();
+			task->setFunctor(std::forward<F>(func));
+
+			if (parent)
+			{
+				// Child hold parent until finish.
+				parent->unfinishedCount.fetch_add(1, std::memory_order_relaxed);
+				parent->refCount.fetch_add(1, std::memory_order_relaxed);
+				task->parent = parent;
+			}
+			return task;
 		}
 
+	public:
+		void setPause(bool bState);
+
 		bool getPauseState() const
 		{
 			return m_bPaused;
@@ -166,14 +271,12 @@ namespace engine
 
 		[[nodiscard]] size_t getTasksQueuedNum() const
 		{
-			const std::scoped_lock tasksLock(m_taskQueueMutex);
-			return m_tasksQueue.size();
+			return m_tasksQueueTotalNum - m_tasksRunningNum;
 		}
 
 		[[nodiscard]] size_t getTasksRunningNum() const
 		{
-			const std::scoped_lock tasks_lock(m_taskQueueMutex);
-			return m_tasksQueueTotalNum - m_tasksQueue.size();
+			return m_tasksRunningNum;
 		}
 
 		[[nodiscard]] size_t getTasksTotal() const
@@ -187,34 +290,49 @@ namespace engine
 		}
 
 		// Wait for all task finish, if when pause, wait for all processing task finish.
-		void waitForTasks()
+		void waitForTasks();
+
+		// Create task but not schedule, add children before run it.
+		template<typename F>
+		[[nodiscard]] TaskHandle createTask(F&& func)
 		{
-			m_bWaiting = true;
+			ThreadPoolTask* task = createTaskImpl(nullptr, std::forward<F>(func));
+			task->refCount.fetch_add(1, std::memory_order_relaxed);
+			return TaskHandle(task);
+		}
 
-			std::unique_lock<std::mutex> tasksLock(m_taskQueueMutex);
-			m_cvTaskDone.wait(tasksLock, [this]
-			{
-				return (m_tasksQueueTotalNum == (m_bPaused ? m_tasksQueue.size() : 0));
-			});
-			m_bWaiting = false;
+		// Create child task, parent only finish after all children finish.
+		template<typename F>
+		[[nodiscard]] TaskHandle createChildTask(const TaskHandle& parent, F&& func)
+		{
+			ThreadPoolTask* task = createTaskImpl(parent.m_task, std::forward<F>(func));
+			task->refCount.fetch_add(1, std::memory_order_relaxed);
+			return TaskHandle(task);
+		}
+
+		// Schedule task, one task only can run once.
+		void run(const TaskHandle& handle)
+		{
+			schedule(handle.m_task);
+		}
+
+		// Wait task and its children finish, calling thread execute other tasks when waiting.
+		void wait(const TaskHandle& handle)
+		{
+			helpUntil(handle);
 		}
 
 		template <typename F, typename... A>
 		void pushTask(const F& task, const A&... args)
 		{
+			if constexpr (sizeof...(args) == 0)
 			{
-				const std::scoped_lock tasksLock(m_taskQueueMutex);
-				if constexpr (sizeof...(args) == 0)
-				{
-					m_tasksQueue.push(std::function<void()>(task));
-				}
-				else
-				{
-					m_tasksQueue.push(std::function<void()>([task, args...]{ task(args...); }));
-				}
+				schedule(createTaskImpl(nullptr, task));
+			}
+			else
+			{
+				schedule(createTaskImpl(nullptr, [task, args...]{ task(args...); }));
 			}
-			++m_tasksQueueTotalNum;
-			m_cvTaskAvailable.notify_one();
 		}
 
 		template <typename F, typename... A, typename R = std::invoke_result_t<std::decay_t<F>, std::decay_t<A>...>>
@@ -237,20 +355,7 @@ namespace engine
 			return taskPromise->get_future();
 		}
 
-		void reset(bool bLeftOneFreeCore = true)
-		{
-			const bool wasPaused = m_bPaused;
-
-			m_bPaused = true;
-			waitForTasks();
-			destroyThreads();
-
-			m_threadCount = getThreadCount(bLeftOneFreeCore);
-			m_threads = std::make_unique<std::thread[]>(m_threadCount);
-
-			m_bPaused = wasPaused;
-			createThread();
-		}
+		void reset(bool bLeftOneFreeCore = true);
 
 		template <typename F, typename T1, typename T2, typename T = std::common_type_t<T1, T2>, typename R = std::invoke_result_t<std::decay_t<F>, T, T>>
 		[[nodiscard]] FutureCollection<R> parallelizeLoop(const T1& firstIndex, const T2& indexAfterLast, const F& loop, size_t numBlocks = 0)
@@ -291,21 +396,55 @@ namespace engine
 			return fc;
 		}
 
-	public:
-		explicit ThreadPool(bool bLeftOneFreeCore = true)
+		// Blocking parallel loop, loop(start, end) invoke on chunks of [firstIndex, indexAfterLast).
+		// Chunk size auto select from worker count when grainSize is zero, calling thread also execute chunks.
+		template <typename F, typename T1, typename T2, typename T = std::common_type_t<T1, T2>>
+		void parallelFor(const T1& firstIndex, const T2& indexAfterLast, const F& loop, size_t grainSize = 0)
 		{
-			m_threadCount = getThreadCount(bLeftOneFreeCore);
-			m_threads = std::make_unique<std::thread[]>(m_threadCount);
-			createThread();
-		}
+			T firstIndexT = static_cast<T>(firstIndex);
+			T indexAfterLastT = static_cast<T>(indexAfterLast);
+			if (indexAfterLastT < firstIndexT)
+			{
+				std::swap(indexAfterLastT, firstIndexT);
+			}
 
-		~ThreadPool()
-		{
-			waitForTasks();
-			destroyThreads();
+			const size_t totalSize = static_cast<size_t>(indexAfterLastT - firstIndexT);
+			if (totalSize == 0)
+			{
+				return;
+			}
+
+			// Some more chunks than workers, so stealing can balance uneven chunk cost.
+			constexpr size_t kChunksPerWorker = 4;
+			const size_t maxChunkCount = size_t(m_threadCount + 1) * kChunksPerWorker;
+
+			size_t chunkSize = std::max(grainSize, (totalSize + maxChunkCount - 1) / maxChunkCount);
+			chunkSize = std::max(chunkSize, size_t(1));
+
+			if (chunkSize >= totalSize)
+			{
+				loop(firstIndexT, indexAfterLastT);
+				return;
+			}
+
+			TaskHandle root = createTask([]{});
+			for (size_t start = 0; start < totalSize; start += chunkSize)
+			{
+				const T chunkStart = static_cast<T>(start) + firstIndexT;
+				const T chunkEnd = static_cast<T>(std::min(start + chunkSize, totalSize)) + firstIndexT;
+
+				// Loop is alive until wait return, capture by reference.
+				schedule(createTaskImpl(root.m_task, [&loop, chunkStart, chunkEnd]{ loop(chunkStart, chunkEnd); }));
+			}
+			run(root);
+			wait(root);
 		}
 
+	public:
+		explicit ThreadPool(bool bLeftOneFreeCore = true);
+		~ThreadPool();
+
 		// Get defautl threadpool which left one core for main thread.
 		static ThreadPool* getDefault();
 	};
-}
\ No newline at end of file
+}
@@ -14,6 +14,7 @@
 #include "window_data.h"
 #include "threadpool.h"
 #include "timer.h"
+#include "profiler.h"
 #include "keycode.h"
 #include "config.h"
 #include "mesh_misc.h"
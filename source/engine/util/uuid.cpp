@@ -8,9 +8,123 @@
 
 namespace engine
 {
+	static constexpr size_t kUUIDStringSize = 36;
+
+	static inline int hexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	static inline bool isDashPosition(size_t i)
+	{
+		return i == 8 || i == 13 || i == 18 || i == 23;
+	}
+
+	static inline uint64_t mix64(uint64_t x)
+	{
+		x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ull;
+		x ^= x >> 27; x *= 0x94D049BB133111EBull;
+		x ^= x >> 31;
+		return x;
+	}
+
+	std::string UUID::toString() const
+	{
+		if (empty())
+		{
+			return {};
+		}
+
+		static constexpr char kHex[] = "0123456789abcdef";
+
+		std::string result(kUUIDStringSize, '-');
+		int bit = 128;
+		for (size_t i = 0; i < kUUIDStringSize; i++)
+		{
+			if (isDashPosition(i))
+			{
+				continue;
+			}
+
+			bit -= 4;
+			const uint64_t part = bit >= 64 ? (hi >> (bit - 64)) : (lo >> bit);
+			result[i] = kHex[part & 0xF];
+		}
+		return result;
+	}
+
+	UUID UUID::fromString(std::string_view str)
+	{
+		if (str.empty())
+		{
+			return {};
+		}
+
+		if (str.size() == kUUIDStringSize)
+		{
+			UUID result { };
+			bool bValid = true;
+			for (size_t i = 0; i < kUUIDStringSize && bValid; i++)
+			{
+				if (isDashPosition(i))
+				{
+					bValid = (str[i] == '-');
+					continue;
+				}
+
+				const int value = hexValue(str[i]);
+				bValid = (value >= 0);
+
+				result.hi = (result.hi << 4) | (result.lo >> 60);
+				result.lo = (result.lo << 4) | uint64_t(value);
+			}
+
+			if (bValid)
+			{
+				return result;
+			}
+		}
+
+		// Old archive store path or builtin name as uuid.
+		return fromName(str);
+	}
+
+	UUID UUID::fromName(std::string_view name)
+	{
+		// Two lane fnv-1a with different basis, then mix.
+		uint64_t h0 = 0xCBF29CE484222325ull;
+		uint64_t h1 = 0x84222325CBF29CE4ull;
+		for (const char c : name)
+		{
+			h0 = (h0 ^ uint8_t(c)) * 0x100000001B3ull;
+			h1 = (h1 ^ uint8_t(c)) * 0x100000001B3ull;
+		}
+
+		UUID result { mix64(h0), mix64(h1 ^ name.size()) };
+
+		// Avoid collide with empty uuid.
+		if (result.empty())
+		{
+			result.lo = 1;
+		}
+		return result;
+	}
+
 	UUID buildUUID()
 	{
-		return uuids::to_string(uuids::uuid_system_generator{}());
+		const auto id = uuids::uuid_system_generator{}();
+		const auto bytes = id.as_bytes();
+
+		UUID result { };
+		for (size_t i = 0; i < 8; i++)
+		{
+			result.hi = (result.hi << 8) | uint64_t(bytes[i]);
+			result.lo = (result.lo << 8) | uint64_t(bytes[i + 8]);
+		}
+		return result;
 	}
 
 	UUID64u buildRuntimeUUID64u()
@@ -21,4 +135,4 @@ namespace engine
 
 		return uniformDistribution(engine);
 	}
-}
\ No newline at end of file
+}
@@ -1,16 +1,63 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <compare>
+#include <functional>
+#include <type_traits>
 
 namespace engine
 {
-	// Standard string uuid.
-	// String uuid maybe slow than uint128, but current speed is enough.
-	using UUID = std::string;
+	// 128 bit binary uuid, trivially copyable, zero is empty.
+	// Text form only used when serialize, so lookup never alloc or hash string.
+	struct UUID
+	{
+		uint64_t hi = 0;
+		uint64_t lo = 0;
+
+		bool empty() const { return (hi | lo) == 0; }
+
+		auto operator<=>(const UUID&) const = default;
+		bool operator==(const UUID&) const = default;
+
+		// Canonical 8-4-4-4-12 lower hex string, empty uuid return empty string.
+		std::string toString() const;
+
+		// Parse canonical string, other non-empty string (old path or name key) fallback to fromName.
+		static UUID fromString(std::string_view str);
+
+		// Deterministic uuid hash from name, used by path or builtin name key.
+		static UUID fromName(std::string_view name);
+
+		// Cereal minimal serialization, keep string layout of old archive.
+		template<class Archive>
+		std::string save_minimal(const Archive&) const
+		{
+			return toString();
+		}
+
+		template<class Archive>
+		void load_minimal(const Archive&, const std::string& str)
+		{
+			*this = fromString(str);
+		}
+	};
+	static_assert(std::is_trivially_copyable_v<UUID> && sizeof(UUID) == 16);
+
 	[[nodiscard]] extern UUID buildUUID();
 
 	// Random device guid, faster than UUID.
 	using UUID64u = uint64_t;
 	[[nodiscard]] extern UUID64u buildRuntimeUUID64u();
-}
\ No newline at end of file
+}
+
+template<>
+struct std::hash<engine::UUID>
+{
+	size_t operator()(const engine::UUID& uuid) const noexcept
+	{
+		// Random or name hashed bits, one multiply mix is enough.
+		return size_t(uuid.lo ^ (uuid.hi * 0x9E3779B97F4A7C15ull));
+	}
+};
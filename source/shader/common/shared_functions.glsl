@@ -981,4 +981,40 @@ float uintDepthUnpack(uint uintDepth)
     return uintBitsToFloat(uintDepth);
 }
 
+// Select static mesh lod by main camera projected bounds sphere size, shadow also use main camera keep same lod.
+// LOD i used when screen size under sqrt(LOD i index count / LOD0 index count) * scale, keep similar triangle density.
+uint selectStaticMeshLOD(in StaticMeshPerObjectData objectData, in PerFrameData frameData)
+{
+    if (objectData.lodCount <= 1)
+    {
+        return 0;
+    }
+
+    if (frameData.staticMeshLOD.y >= 0.0)
+    {
+        return min(uint(frameData.staticMeshLOD.y), objectData.lodCount - 1);
+    }
+
+    const mat3 modelMat3 = mat3(objectData.modelMatrix);
+    const float maxScale = max(length(modelMat3[0]), max(length(modelMat3[1]), length(modelMat3[2])));
+
+    const vec3 worldCenter = (objectData.modelMatrix * vec4(objectData.sphereBounds.xyz, 1.0)).xyz;
+    const float radius = objectData.sphereBounds.w * maxScale;
+    const float dist = max(distance(worldCenter, frameData.camWorldPos.xyz), 1e-4f);
+
+    // Projected radius relative to half screen height.
+    const float screenSize = radius * abs(frameData.camProjNoJitter[1][1]) / dist;
+
+    uint lod = 0;
+    for (uint i = 1; i < objectData.lodCount; i++)
+    {
+        const float indexRatio = float(objectData.lodIndicesCount[i]) / float(max(objectData.lodIndicesCount[0], 1));
+        if (screenSize < sqrt(indexRatio) * frameData.staticMeshLOD.x)
+        {
+            lod = i;
+        }
+    }
+    return lod;
+}
+
 #endif
\ No newline at end of file
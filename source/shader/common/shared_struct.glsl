@@ -198,6 +198,10 @@ struct PerFrameData
     float displayWidth;
     float displayHeight;
 
+    uvec4 textureStreaming; // .x is texture streaming feedback buffer bindless index, ~0 is disable.
+
+    vec4 staticMeshLOD; // .x is lod screen size scale, .y is force lod when >= 0.
+
     SkyInfo sky;
 };
 
@@ -276,6 +280,9 @@ StaticMeshVertex buildVertex(in const StaticMeshVertexRaw raw)
 #define SMT_StaticMesh    0
 #define SMT_PMXStaticMesh 1
 
+// Max workgroup count of static mesh cluster culling dispatch, spec min limit.
+#define kMaxClusterCullGroupCount 65535
+
 struct StaticMeshPerObjectData
 {
     // Material for static mesh.
@@ -305,6 +312,26 @@ struct StaticMeshPerObjectData
     uint positionsPrevArrayId;
     uint objectType; // == 0 is static mesh, == 1 is pmx static mesh.
     uint smoothNormalArrayId;
+    uint meshletsArrayId;  // Meshlets buffer in bindless buffer id.
+
+    uint meshletStart; // Submesh meshlets range, count zero means draw whole submesh without cluster culling.
+    uint meshletCount;
+    uint lodCount; // Valid lod count, meshlets only used when select LOD0.
+    uint pad0;
+
+    uvec4 lodIndicesStart; // LOD0 ~ LOD3 index range.
+    uvec4 lodIndicesCount;
+};
+
+// See StaticMeshMeshlet in mesh_misc.h
+struct StaticMeshMeshlet
+{
+    vec4 sphereBounds; // Mesh local space, .xyz is center, .w is radius.
+    vec4 cone; // .xyz is axis, .w is cutoff, cutoff >= 1.0 means no cone culling.
+
+    uint indicesStart;
+    uint indicesCount;
+    uint pad0;
     uint pad1;
 };
 
@@ -0,0 +1,36 @@
+#ifndef SHARED_TEXTURE_STREAMING_GLSL
+#define SHARED_TEXTURE_STREAMING_GLSL
+
+#ifndef TEXTURE_STREAMING_FEEDBACK_SET
+#error "Must define TEXTURE_STREAMING_FEEDBACK_SET before include this file!"
+#endif
+
+// Alias of bindless ssbo set, feedback buffer index store in frameData.textureStreaming.x.
+layout(set = TEXTURE_STREAMING_FEEDBACK_SET, binding = 0) buffer BindlessSSBOTextureFeedback { uint data[]; } textureFeedbackArray[];
+
+// Keep same with texture_streaming.cpp, store floor(lod) + offset so negative lod still valid.
+#define kTextureStreamingLodOffset 16
+
+// Atomic min sampled mip of bindless texture, only 1/16 pixels write each frame to reduce atomic contention.
+void textureStreamingFeedback(texture2D inTexture, sampler inSampler, uint texId, vec2 uv)
+{
+    // Uniform branch, whole draw skip or not.
+    const uint feedbackId = frameData.textureStreaming.x;
+    if (feedbackId == ~0u)
+    {
+        return;
+    }
+
+    // Query lod before pixel mask, implicit derivatives undefined after quad divergent return.
+    // .x is lod relative to base level without clamp.
+    float lod = textureQueryLod(sampler2D(inTexture, inSampler), uv).x + frameData.basicTextureLODBias;
+
+    uvec2 pixelPos = uvec2(gl_FragCoord.xy) & 3u;
+    if (pixelPos.x + pixelPos.y * 4u == frameData.frameIndex.z)
+    {
+        uint lodFeedback = uint(clamp(int(floor(lod)) + kTextureStreamingLodOffset, 0, 31));
+        atomicMin(textureFeedbackArray[feedbackId].data[texId], lodFeedback);
+    }
+}
+
+#endif
@@ -22,6 +22,7 @@ layout (set = 0, binding = 11)  uniform texture2D inShadowMaskRT;
 layout (set = 0, binding = 12, rgba16f)  uniform image2D ssssDiffuseSceneColor;
 layout (set = 0, binding = 13)  uniform texture2D inSkinSSSLut;
 layout (set = 0, binding = 13)  uniform texture2D inSkinSSSLutShadow;
+layout (set = 0, binding = 15)  uniform texture2D inGTAO; // White when GTAO disable.
 #define SHARED_SAMPLER_SET 1
 #include "../common/shared_sampler.glsl"
 
@@ -154,7 +155,7 @@ void main()
 
 
 
-    float ao = min(bentNormalAo.a, inGbufferSValue.b);
+    float ao = min(min(bentNormalAo.a, texture(sampler2D(inGTAO, linearClampEdgeSampler), uv).r), inGbufferSValue.b);
     if(isInShadingModelRange(shadingModel, kShadingModelEye) || isInShadingModelRange(shadingModel, kShadingModelSSSS))
     {
         ao = saturate((ao + 0.25) * 2.0);
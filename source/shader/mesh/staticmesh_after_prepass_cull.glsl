@@ -10,6 +10,8 @@ layout (set = 0, binding = 1) readonly buffer SSBOPerObject { StaticMeshPerObjec
 layout (set = 0, binding = 2) buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
 layout (set = 0, binding = 3) buffer SSBODrawCount{ uint drawCount; };
 layout (set = 0, binding = 4) uniform texture2D inHzbFurthest;
+layout (set = 0, binding = 5) buffer SSBOClusterCullObjects { uint clusterCullObjects[]; };
+layout (set = 0, binding = 6) buffer SSBOClusterCullArgs { uvec4 clusterCullArgs; }; // .xyz is dispatch indirect, .w is object count.
 
 layout (push_constant) uniform PushConsts 
 {
@@ -107,14 +109,27 @@ void main()
         }
     }
 
+    const uint lod = selectStaticMeshLOD(objectData, frameData);
+
+    // Object with meshlets continue cluster culling when use LOD0, one workgroup per object.
+    if(objectData.meshletCount > 0 && lod == 0)
+    {
+        uint slot = atomicAdd(clusterCullArgs.w, 1);
+        clusterCullObjects[slot] = idx;
+
+        // Dispatch group count limit, cluster cull loop objects when exceed.
+        atomicMax(clusterCullArgs.x, min(slot + 1, kMaxClusterCullGroupCount));
+        return;
+    }
+
     // Build draw command if visible.
     {
         uint drawId = atomicAdd(drawCount, 1);
         drawCommands[drawId].objectId = idx;
 
         // We fetech vertex by index, so vertex count is index count.
-        drawCommands[drawId].vertexCount = objectData.indexCount;
-        drawCommands[drawId].firstVertex = objectData.indexStartPosition;
+        drawCommands[drawId].vertexCount = (lod == 0) ? objectData.indexCount : objectData.lodIndicesCount[lod];
+        drawCommands[drawId].firstVertex = (lod == 0) ? objectData.indexStartPosition : objectData.lodIndicesStart[lod];
 
         // We fetch vertex in vertex shader, so instancing is unused when rendering.
         drawCommands[drawId].instanceCount = 1;
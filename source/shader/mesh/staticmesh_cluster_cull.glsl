@@ -0,0 +1,144 @@
+#version 460
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_samplerless_texture_functions : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+// Meshlet level culling of objects pass object culling, one workgroup per object.
+// Prepass only frustum and cone culling, gbuffer define CLUSTER_HZB_CULL also test hzb of prepass depth.
+
+#include "../common/shared_struct.glsl"
+#include "../common/shared_functions.glsl"
+
+layout (set = 0, binding = 0) uniform UniformFrameData{ PerFrameData frameData; };
+layout (set = 0, binding = 1) readonly buffer SSBOPerObject { StaticMeshPerObjectData objectDatas[]; };
+layout (set = 0, binding = 2) buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
+layout (set = 0, binding = 3) buffer SSBODrawCount{ uint drawCount; };
+layout (set = 0, binding = 4) readonly buffer SSBOClusterCullObjects { uint clusterCullObjects[]; };
+layout (set = 0, binding = 5) readonly buffer SSBOClusterCullArgs { uvec4 clusterCullArgs; };
+#ifdef CLUSTER_HZB_CULL
+layout (set = 0, binding = 6) uniform texture2D inHzbFurthest;
+#endif
+
+layout (set = 1, binding = 0) readonly buffer BindlessSSBOMeshlets { StaticMeshMeshlet data[]; } meshletsArray[];
+
+layout (push_constant) uniform PushConsts
+{
+    uint bConeCull;
+    uint hzbMipCount;
+    vec2 hzbSrcSize;
+};
+
+bool frustumCull(vec3 center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (dot(center, frameData.frustumPlanes[i].xyz) + frameData.frustumPlanes[i].w + radius < 0.0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whole cluster backface when camera inside the cone of sphere bounds.
+bool coneCull(vec3 center, float radius, vec3 axis, float cutoff)
+{
+    const vec3 v = center - frameData.camWorldPos.xyz;
+    return dot(v, axis) >= cutoff * length(v) + radius;
+}
+
+#ifdef CLUSTER_HZB_CULL
+bool hzbCull(vec3 center, float radius)
+{
+    const mat4 vp = frameData.camViewProj;
+
+    const vec3 uvZ0 = projectPos(center + radius * vec3( 1.0,  1.0,  1.0), vp);
+    const vec3 uvZ1 = projectPos(center + radius * vec3(-1.0,  1.0,  1.0), vp);
+    const vec3 uvZ2 = projectPos(center + radius * vec3( 1.0, -1.0,  1.0), vp);
+    const vec3 uvZ3 = projectPos(center + radius * vec3( 1.0,  1.0, -1.0), vp);
+    const vec3 uvZ4 = projectPos(center + radius * vec3(-1.0, -1.0,  1.0), vp);
+    const vec3 uvZ5 = projectPos(center + radius * vec3( 1.0, -1.0, -1.0), vp);
+    const vec3 uvZ6 = projectPos(center + radius * vec3(-1.0,  1.0, -1.0), vp);
+    const vec3 uvZ7 = projectPos(center + radius * vec3(-1.0, -1.0, -1.0), vp);
+
+    vec3 maxUvz = max(max(max(max(max(max(max(uvZ0, uvZ1), uvZ2), uvZ3), uvZ4), uvZ5), uvZ6), uvZ7);
+    vec3 minUvz = min(min(min(min(min(min(min(uvZ0, uvZ1), uvZ2), uvZ3), uvZ4), uvZ5), uvZ6), uvZ7);
+
+    // Cross near plane, keep visible.
+    if(maxUvz.z >= 1.0f || minUvz.z <= 0.0f)
+    {
+        return false;
+    }
+
+    const vec2 bounds = maxUvz.xy - minUvz.xy;
+
+    const float edge = max(1.0, max(bounds.x, bounds.y) * max(hzbSrcSize.x, hzbSrcSize.y));
+    int mipLevel = int(min(ceil(log2(edge)), hzbMipCount - 1));
+
+    const vec2 mipSize = vec2(textureSize(inHzbFurthest, mipLevel));
+    const ivec2 samplePosMax = ivec2(saturate(maxUvz.xy) * mipSize);
+    const ivec2 samplePosMin = ivec2(saturate(minUvz.xy) * mipSize);
+
+    vec4 occ = vec4(
+        texelFetch(inHzbFurthest, samplePosMax.xy, mipLevel).x,
+        texelFetch(inHzbFurthest, samplePosMin.xy, mipLevel).x,
+        texelFetch(inHzbFurthest, ivec2(samplePosMax.x, samplePosMin.y), mipLevel).x,
+        texelFetch(inHzbFurthest, ivec2(samplePosMin.x, samplePosMax.y), mipLevel).x);
+
+    float occDepth = min(occ.w, min(occ.z, min(occ.x, occ.y)));
+    return occDepth > maxUvz.z;
+}
+#endif
+
+layout(local_size_x = 64) in;
+void main()
+{
+    // Group count clamp to kMaxClusterCullGroupCount, loop objects when exceed.
+    for (uint slot = gl_WorkGroupID.x; slot < clusterCullArgs.w; slot += gl_NumWorkGroups.x)
+    {
+        const uint objectId = clusterCullObjects[slot];
+        const StaticMeshPerObjectData objectData = objectDatas[objectId];
+
+        const mat3 modelMat3 = mat3(objectData.modelMatrix);
+        const vec3 axisScale = vec3(length(modelMat3[0]), length(modelMat3[1]), length(modelMat3[2]));
+        const float maxScale = max(axisScale.x, max(axisScale.y, axisScale.z));
+
+        // Cone no valid under non-uniform scale.
+        const bool bObjectConeCull = (bConeCull != 0) && (maxScale - min(axisScale.x, min(axisScale.y, axisScale.z)) < 1e-3f * maxScale);
+
+        for (uint i = gl_LocalInvocationID.x; i < objectData.meshletCount; i += gl_WorkGroupSize.x)
+        {
+            const StaticMeshMeshlet meshlet = meshletsArray[nonuniformEXT(objectData.meshletsArrayId)].data[objectData.meshletStart + i];
+
+            const vec3 center = (objectData.modelMatrix * vec4(meshlet.sphereBounds.xyz, 1.0)).xyz;
+            const float radius = meshlet.sphereBounds.w * maxScale;
+
+            if (frustumCull(center, radius))
+            {
+                continue;
+            }
+
+            if (bObjectConeCull && meshlet.cone.w < 1.0 && coneCull(center, radius, normalize(modelMat3 * meshlet.cone.xyz), meshlet.cone.w))
+            {
+                continue;
+            }
+
+        #ifdef CLUSTER_HZB_CULL
+            if (hzbCull(center, radius))
+            {
+                continue;
+            }
+        #endif
+
+            uint drawId = atomicAdd(drawCount, 1);
+            drawCommands[drawId].objectId = objectId;
+
+            // Meshlet indices continuous in index buffer.
+            drawCommands[drawId].vertexCount = meshlet.indicesCount;
+            drawCommands[drawId].firstVertex = meshlet.indicesStart;
+
+            drawCommands[drawId].instanceCount = 1;
+            drawCommands[drawId].firstInstance = 0;
+        }
+    }
+}
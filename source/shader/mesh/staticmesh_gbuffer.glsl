@@ -121,8 +121,12 @@ void main()
 
 #ifdef PIXEL_SHADER ////////////// pixel shader start 
 
+#define TEXTURE_STREAMING_FEEDBACK_SET 2
+#include "../common/shared_texture_streaming.glsl"
+
 vec4 tex(uint texId,uint samplerId,vec2 uv)
 {
+    textureStreamingFeedback(texture2DBindlessArray[nonuniformEXT(texId)], samplerArray[nonuniformEXT(samplerId)], texId, uv);
     return texture(sampler2D(texture2DBindlessArray[nonuniformEXT(texId)], samplerArray[nonuniformEXT(samplerId)]), uv, frameData.basicTextureLODBias);
 }
 
@@ -5,4 +5,8 @@
 %~dp0/../glslc.exe -fshader-stage=frag --target-env=vulkan1.3 -DPIXEL_SHADER  %~dp0/pmx_outline_depth.glsl -O -o %~dp0/../../../install/shader/pmx_outline_depth.frag.spv
 
 %~dp0/../glslc.exe -fshader-stage=vert --target-env=vulkan1.3 -DVERTEX_SHADER %~dp0/pmx_translucency.glsl -O -o %~dp0/../../../install/shader/pmx_translucency.vert.spv
-%~dp0/../glslc.exe -fshader-stage=frag --target-env=vulkan1.3 -DPIXEL_SHADER  %~dp0/pmx_translucency.glsl -O -o %~dp0/../../../install/shader/pmx_translucency.frag.spv
\ No newline at end of file
+%~dp0/../glslc.exe -fshader-stage=frag --target-env=vulkan1.3 -DPIXEL_SHADER  %~dp0/pmx_translucency.glsl -O -o %~dp0/../../../install/shader/pmx_translucency.frag.spv
+
+%~dp0/../glslc.exe -fshader-stage=comp --target-env=vulkan1.3 %~dp0/pmx_skinning.glsl -O -o %~dp0/../../../install/shader/pmx_skinning.comp.spv
+%~dp0/../glslc.exe -fshader-stage=comp --target-env=vulkan1.3 %~dp0/pmx_bounds.glsl -O -o %~dp0/../../../install/shader/pmx_bounds.comp.spv
+%~dp0/../glslc.exe -fshader-stage=comp --target-env=vulkan1.3 %~dp0/pmx_cull.glsl -O -o %~dp0/../../../install/shader/pmx_cull.comp.spv
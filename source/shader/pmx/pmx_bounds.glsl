@@ -0,0 +1,69 @@
+#version 460
+#extension GL_EXT_nonuniform_qualifier : enable
+#extension GL_GOOGLE_include_directive : enable
+
+#include "pmx_common.glsl"
+
+// Compute local bounds of pmx submeshes from skinned positions, one row of workgroups per submesh.
+
+layout (set = 0, binding = 0) readonly buffer SSBOPMXSubmeshes { PMXSubmesh pmxSubmeshes[]; };
+layout (set = 0, binding = 1) buffer SSBOPMXSubmeshBounds { uint boundsData[]; };
+
+layout (set = 1, binding = 0) readonly buffer BindlessSSBOVertices { float data[]; } verticesArray[];
+layout (set = 2, binding = 0) readonly buffer BindlessSSBOIndices { uint data[]; } indicesArray[];
+
+shared uint sharedBounds[6];
+
+layout(local_size_x = 64) in;
+void main()
+{
+    const uint submeshId = gl_WorkGroupID.y;
+    const uint indexStart = pmxSubmeshes[submeshId].indexStart;
+    const uint indexCount = pmxSubmeshes[submeshId].indexCount;
+    const uint indicesId  = pmxSubmeshes[submeshId].params.indicesArrayId;
+    const uint positionId = pmxSubmeshes[submeshId].params.positionsArrayId;
+
+    if(gl_LocalInvocationIndex < 6)
+    {
+        sharedBounds[gl_LocalInvocationIndex] = 0xFFFFFFFFu;
+    }
+    barrier();
+
+    vec3 minPos = vec3( kMaxHalfFloat);
+    vec3 maxPos = vec3(-kMaxHalfFloat);
+    bool bValid = false;
+
+    // Workgroups of same submesh loop whole index range.
+    const uint stride = gl_NumWorkGroups.x * gl_WorkGroupSize.x;
+    for(uint i = gl_GlobalInvocationID.x; i < indexCount; i += stride)
+    {
+        const uint vertexId = indicesArray[nonuniformEXT(indicesId)].data[indexStart + i];
+
+        vec3 position;
+        position.x = verticesArray[nonuniformEXT(positionId)].data[vertexId * 3 + 0];
+        position.y = verticesArray[nonuniformEXT(positionId)].data[vertexId * 3 + 1];
+        position.z = verticesArray[nonuniformEXT(positionId)].data[vertexId * 3 + 2];
+
+        minPos = min(minPos, position);
+        maxPos = max(maxPos, position);
+        bValid = true;
+    }
+
+    if(bValid)
+    {
+        atomicMin(sharedBounds[0], floatToOrderedUint(minPos.x));
+        atomicMin(sharedBounds[1], floatToOrderedUint(minPos.y));
+        atomicMin(sharedBounds[2], floatToOrderedUint(minPos.z));
+        atomicMin(sharedBounds[3], ~floatToOrderedUint(maxPos.x));
+        atomicMin(sharedBounds[4], ~floatToOrderedUint(maxPos.y));
+        atomicMin(sharedBounds[5], ~floatToOrderedUint(maxPos.z));
+    }
+    barrier();
+
+    // Only one global atomic per workgroup and component.
+    if(gl_LocalInvocationIndex < 6 && sharedBounds[gl_LocalInvocationIndex] != 0xFFFFFFFFu)
+    {
+        const uint offset = submeshId * kPMXSubmeshBoundsStride + ((gl_LocalInvocationIndex < 3) ? gl_LocalInvocationIndex : (gl_LocalInvocationIndex + 1));
+        atomicMin(boundsData[offset], sharedBounds[gl_LocalInvocationIndex]);
+    }
+}
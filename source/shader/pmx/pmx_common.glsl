@@ -32,6 +32,33 @@ struct UniformPMX
     float pad1;
 };
 
+// Per submesh data of gpu driven draw, see PMXGpuSubmesh in engine/scene/component/pmx.h.
+struct PMXSubmesh
+{
+    UniformPMX params;
+
+    uint indexStart;
+    uint indexCount;
+    uint bTranslucent;
+    uint pad0;
+};
+
+// Submesh local bounds store as 8 uint, [0, 3) is min, [4, 7) is inverted max, all atomicMin.
+// Clear to 0xFFFFFFFF, submesh still 0xFFFFFFFF after bounds pass is empty.
+const uint kPMXSubmeshBoundsStride = 8;
+
+// Map float to uint which keep order, so can use uint atomic.
+uint floatToOrderedUint(float v)
+{
+    const uint u = floatBitsToUint(v);
+    return ((u & 0x80000000u) != 0) ? ~u : (u | 0x80000000u);
+}
+
+float orderedUintToFloat(uint u)
+{
+    return uintBitsToFloat(((u & 0x80000000u) != 0) ? (u & 0x7FFFFFFFu) : ~u);
+}
+
 struct AngularInfoPMX
 {
     vec3 n;
@@ -95,10 +122,18 @@ AngularInfoPMX getAngularInfoPMX(vec3 pointToLight, vec3 normal, vec3 view)
     layout (set = 4, binding = 0) readonly buffer BindlessSSBOVertices { float data[]; } verticesArray[];
     layout (set = 5, binding = 0) readonly buffer BindlessSSBOIndices { uint data[]; } indicesArray[];
 
-    layout (set = 6, binding = 0) uniform UniformPMXParam { UniformPMX pmxParam; };
-    
+    // Submesh data fetch by indirect draw command, pixel shader get submesh id from vertex shader.
+    layout (set = 0, binding = 3) readonly buffer SSBOPMXSubmeshes { PMXSubmesh pmxSubmeshes[]; };
+    layout (set = 0, binding = 4) readonly buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
 
+    #ifdef VERTEX_SHADER
+        layout (location = 15) out flat uint outPMXSubmeshId;
+        #define pmxSubmeshId drawCommands[gl_DrawID].objectId
+    #else
+        layout (location = 15) in flat uint pmxSubmeshId;
+    #endif
 
+    #define pmxParam pmxSubmeshes[pmxSubmeshId].params
 #endif
 
 #endif
\ No newline at end of file
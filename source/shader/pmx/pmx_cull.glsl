@@ -0,0 +1,160 @@
+#version 460
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_samplerless_texture_functions : enable
+
+#include "pmx_common.glsl"
+
+layout (set = 0, binding = 0) uniform UniformFrameData{ PerFrameData frameData; };
+layout (set = 0, binding = 1) readonly buffer SSBOPMXSubmeshes { PMXSubmesh pmxSubmeshes[]; };
+layout (set = 0, binding = 2) readonly buffer SSBOPMXSubmeshBounds { uint boundsData[]; };
+layout (set = 0, binding = 3) buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
+layout (set = 0, binding = 4) buffer SSBODrawCount{ uint drawCount; };
+layout (set = 0, binding = 5) uniform texture2D inHzbFurthest;
+
+layout (push_constant) uniform PushConsts 
+{
+    uint cullCount; 
+
+    // Draw translucent submeshes or opaque submeshes.
+    uint bTranslucent;
+
+    // Hzb not ready when pmx gbuffer, only frustum culling.
+    uint bHzbCull;
+    uint hzbMipCount;
+    vec2 hzbSrcSize;
+};
+
+bool isSubmeshVisible(uint idx, in const PMXSubmesh submesh)
+{
+    if((submesh.bTranslucent != 0) != (bTranslucent != 0))
+    {
+        return false;
+    }
+
+    // Empty submesh no bounds.
+    const uint boundsOffset = idx * kPMXSubmeshBoundsStride;
+    if(boundsData[boundsOffset] == 0xFFFFFFFFu)
+    {
+        return false;
+    }
+
+    const vec3 minPos = vec3(
+        orderedUintToFloat(boundsData[boundsOffset + 0]), 
+        orderedUintToFloat(boundsData[boundsOffset + 1]), 
+        orderedUintToFloat(boundsData[boundsOffset + 2]));
+    const vec3 maxPos = vec3(
+        orderedUintToFloat(~boundsData[boundsOffset + 4]), 
+        orderedUintToFloat(~boundsData[boundsOffset + 5]), 
+        orderedUintToFloat(~boundsData[boundsOffset + 6]));
+
+    const mat4 modelMatrix = submesh.params.modelMatrix;
+    const mat4 mvp = frameData.camViewProj * modelMatrix;
+
+    const vec3 localPos = (maxPos + minPos) * 0.5;
+    const vec3 exten = (maxPos - minPos) * 0.5;
+	const vec4 worldPos = modelMatrix * vec4(localPos, 1.0f);
+
+    // local to world normal matrix.
+	mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
+	mat3 world2Local = inverse(normalMatrix);
+
+	// frustum culling test.
+	for (int i = 0; i < 6; i++) 
+	{
+        vec3 worldSpaceN = frameData.frustumPlanes[i].xyz;
+        float castDistance = dot(worldPos.xyz, worldSpaceN);
+
+		vec3 localNormal = world2Local * worldSpaceN;
+		float absDiff = dot(abs(localNormal), exten);
+		if (castDistance + absDiff + frameData.frustumPlanes[i].w < 0.0)
+		{
+            return false;
+		}
+	}
+
+    // Hzb culling test, same as static mesh culling.
+    if(bHzbCull != 0)
+    {
+        const vec3 uvZ0 = projectPos(localPos + exten * vec3( 1.0,  1.0,  1.0), mvp);
+        const vec3 uvZ1 = projectPos(localPos + exten * vec3(-1.0,  1.0,  1.0), mvp);
+        const vec3 uvZ2 = projectPos(localPos + exten * vec3( 1.0, -1.0,  1.0), mvp);
+        const vec3 uvZ3 = projectPos(localPos + exten * vec3( 1.0,  1.0, -1.0), mvp);
+        const vec3 uvZ4 = projectPos(localPos + exten * vec3(-1.0, -1.0,  1.0), mvp);
+        const vec3 uvZ5 = projectPos(localPos + exten * vec3( 1.0, -1.0, -1.0), mvp);
+        const vec3 uvZ6 = projectPos(localPos + exten * vec3(-1.0,  1.0, -1.0), mvp);
+        const vec3 uvZ7 = projectPos(localPos + exten * vec3(-1.0, -1.0, -1.0), mvp);
+
+        vec3 maxUvz = max(max(max(max(max(max(max(uvZ0, uvZ1), uvZ2), uvZ3), uvZ4), uvZ5), uvZ6), uvZ7);
+        vec3 minUvz = min(min(min(min(min(min(min(uvZ0, uvZ1), uvZ2), uvZ3), uvZ4), uvZ5), uvZ6), uvZ7);
+
+        if(maxUvz.z < 1.0f && minUvz.z > 0.0f)
+        {
+            const vec2 bounds = maxUvz.xy - minUvz.xy;
+
+            const float edge = max(1.0, max(bounds.x, bounds.y) * max(hzbSrcSize.x, hzbSrcSize.y));
+            int mipLevel = int(min(ceil(log2(edge)), hzbMipCount - 1));
+
+            const vec2 mipSize = vec2(textureSize(inHzbFurthest, mipLevel));
+            const ivec2 samplePosMax = ivec2(saturate(maxUvz.xy) * mipSize);
+            const ivec2 samplePosMin = ivec2(saturate(minUvz.xy) * mipSize);
+
+            vec4 occ = vec4(
+                texelFetch(inHzbFurthest, samplePosMax.xy, mipLevel).x, 
+                texelFetch(inHzbFurthest, samplePosMin.xy, mipLevel).x, 
+                texelFetch(inHzbFurthest, ivec2(samplePosMax.x, samplePosMin.y), mipLevel).x, 
+                texelFetch(inHzbFurthest, ivec2(samplePosMin.x, samplePosMax.y), mipLevel).x);
+
+            float occDepth = min(occ.w, min(occ.z, min(occ.x, occ.y)));
+            if(occDepth > maxUvz.z)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+layout(local_size_x = 64) in;
+void main()
+{
+    uint idx = gl_GlobalInvocationID.x;
+    if(idx >= cullCount)
+    {
+        return;
+    }
+
+    const PMXSubmesh submesh = pmxSubmeshes[idx];
+    const bool bVisible = isSubmeshVisible(idx, submesh);
+
+    // Translucent blend depend on submesh draw order, every submesh own fixed slot, invisible one draw zero instance.
+    if(bTranslucent != 0)
+    {
+        if(idx == 0)
+        {
+            drawCount = cullCount;
+        }
+
+        drawCommands[idx].objectId = idx;
+        drawCommands[idx].vertexCount = submesh.indexCount;
+        drawCommands[idx].firstVertex = submesh.indexStart;
+        drawCommands[idx].instanceCount = bVisible ? 1 : 0;
+        drawCommands[idx].firstInstance = 0;
+        return;
+    }
+
+    // Build draw command if visible.
+    if(bVisible)
+    {
+        uint drawId = atomicAdd(drawCount, 1);
+        drawCommands[drawId].objectId = idx;
+
+        // We fetech vertex by index, so vertex count is index count.
+        drawCommands[drawId].vertexCount = submesh.indexCount;
+        drawCommands[drawId].firstVertex = submesh.indexStart;
+
+        // We fetch vertex in vertex shader, so instancing is unused when rendering.
+        drawCommands[drawId].instanceCount = 1;
+        drawCommands[drawId].firstInstance = 0; 
+    }
+}
@@ -21,6 +21,8 @@ layout (location = 0) out VS2PS vsOut;
 
 void main()
 {
+    outPMXSubmeshId = pmxSubmeshId;
+
     const uint indicesId  = pmxParam.indicesArrayId;
     const uint positionId = pmxParam.positionsArrayId;
     const uint positionsPrevId = pmxParam.positionsPrevArrayId;
@@ -80,8 +82,13 @@ void main()
 
 #ifdef PIXEL_SHADER ////////////// pixel shader start 
 
+#define TEXTURE_STREAMING_FEEDBACK_SET 5
+#include "../common/shared_texture_streaming.glsl"
+
 vec4 tex(uint texId, vec2 uv)
 {
+    textureStreamingFeedback(texture2DBindlessArray[nonuniformEXT(texId)], linearRepeatMipFilterSampler, texId, uv);
+
     // PMX file use linear repeat to sample texture.
     return texture(sampler2D(texture2DBindlessArray[nonuniformEXT(texId)], linearRepeatMipFilterSampler), uv, frameData.basicTextureLODBias);
 }
@@ -23,6 +23,8 @@ layout (location = 0) out VS2PS vsOut;
 
 void main()
 {
+    outPMXSubmeshId = pmxSubmeshId;
+
     const uint indicesId  = pmxParam.indicesArrayId;
     const uint positionId = pmxParam.positionsArrayId;
     const uint positionsPrevId = pmxParam.positionsPrevArrayId;
@@ -0,0 +1,176 @@
+#version 460
+#extension GL_GOOGLE_include_directive : enable
+
+// PMX compute skinning, same math as saba PMXSkinning CPU path.
+// Write skinned position, normal and uv into the vertex buffers which pmx shaders fetch by bindless id.
+
+#define kSkinningTypeWeight1 0
+#define kSkinningTypeWeight2 1
+#define kSkinningTypeWeight4 2
+#define kSkinningTypeSDEF    3
+#define kSkinningTypeQDEF    4
+
+struct PMXSkinningVertex
+{
+    vec4 position;     // .w is uv.x
+    vec4 normal;       // .w is uv.y
+    ivec4 boneIndices; // Unused bone slot remap to bone 0 with zero weight.
+    vec4 boneWeights;
+    vec4 sdefC;        // .w is skinning type.
+    vec4 sdefR0;
+    vec4 sdefR1;
+};
+
+struct PMXSkinningBone
+{
+    mat4 transform;
+    vec4 rotation; // Global rotation quaternion, only valid when exist SDEF vertices.
+    vec4 dqReal;   // Dual quaternion, only valid when exist QDEF vertices.
+    vec4 dqDual;
+};
+
+layout (set = 0, binding = 0) readonly buffer SSBOSkinningVertices { PMXSkinningVertex vertices[]; };
+layout (set = 0, binding = 1) readonly buffer SSBOSkinningBones { PMXSkinningBone bones[]; };
+layout (set = 0, binding = 2) readonly buffer SSBOMorphPositions { float morphPositions[]; };
+layout (set = 0, binding = 3) readonly buffer SSBOMorphUVs { vec4 morphUVs[]; };
+layout (set = 0, binding = 4) writeonly buffer SSBOOutPositions { float outPositions[]; };
+layout (set = 0, binding = 5) writeonly buffer SSBOOutNormals { float outNormals[]; };
+layout (set = 0, binding = 6) writeonly buffer SSBOOutUVs { float outUVs[]; };
+
+layout (push_constant) uniform PushConsts
+{
+    uint vertexCount;
+};
+
+mat3 quatToMat3(vec4 q)
+{
+    const float xx = q.x * q.x; const float yy = q.y * q.y; const float zz = q.z * q.z;
+    const float xz = q.x * q.z; const float xy = q.x * q.y; const float yz = q.y * q.z;
+    const float wx = q.w * q.x; const float wy = q.w * q.y; const float wz = q.w * q.z;
+
+    return mat3(
+        1.0 - 2.0 * (yy + zz),       2.0 * (xy + wz),       2.0 * (xz - wy),
+              2.0 * (xy - wz), 1.0 - 2.0 * (xx + zz),       2.0 * (yz + wx),
+              2.0 * (xz + wy),       2.0 * (yz - wx), 1.0 - 2.0 * (xx + yy));
+}
+
+// Same as glm::slerp, use shortest path.
+vec4 quatSlerp(vec4 x, vec4 y, float a)
+{
+    float cosTheta = dot(x, y);
+    if (cosTheta < 0.0)
+    {
+        y = -y;
+        cosTheta = -cosTheta;
+    }
+
+    if (cosTheta > 1.0 - 1e-6)
+    {
+        return mix(x, y, a);
+    }
+
+    const float angle = acos(cosTheta);
+    return (sin((1.0 - a) * angle) * x + sin(a * angle) * y) / sin(angle);
+}
+
+vec3 quatRotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+layout(local_size_x = 64) in;
+void main()
+{
+    const uint vid = gl_GlobalInvocationID.x;
+    if (vid >= vertexCount)
+    {
+        return;
+    }
+
+    const PMXSkinningVertex vertex = vertices[vid];
+    const uint skinningType = uint(vertex.sdefC.w);
+
+    const vec3 morphPosition = vec3(morphPositions[vid * 3 + 0], morphPositions[vid * 3 + 1], morphPositions[vid * 3 + 2]);
+    const vec3 position = vertex.position.xyz + morphPosition;
+
+    vec3 skinnedPosition;
+    vec3 skinnedNormal;
+    if (skinningType == kSkinningTypeSDEF)
+    {
+        // https://github.com/powroupi/blender_mmd_tools/blob/dev_test/mmd_tools/core/sdef.py
+        const int i0 = vertex.boneIndices.x;
+        const int i1 = vertex.boneIndices.y;
+        const float w0 = vertex.boneWeights.x;
+        const float w1 = vertex.boneWeights.y;
+
+        const mat3 rotMat = quatToMat3(quatSlerp(bones[i0].rotation, bones[i1].rotation, w1));
+
+        skinnedPosition = rotMat * (position - vertex.sdefC.xyz)
+            + (bones[i0].transform * vec4(vertex.sdefR0.xyz, 1.0)).xyz * w0
+            + (bones[i1].transform * vec4(vertex.sdefR1.xyz, 1.0)).xyz * w1;
+        skinnedNormal = rotMat * vertex.normal.xyz;
+    }
+    else if (skinningType == kSkinningTypeQDEF)
+    {
+        // Skinning with Dual Quaternions
+        // https://www.cs.utah.edu/~ladislav/dq/index.html
+        const vec4 real0 = bones[vertex.boneIndices.x].dqReal;
+
+        vec4 real = vec4(0.0);
+        vec4 dual = vec4(0.0);
+        for (int i = 0; i < 4; i++)
+        {
+            const int boneId = vertex.boneIndices[i];
+            const vec4 realI = bones[boneId].dqReal;
+
+            // Flip to same hemisphere as first bone.
+            const float w = dot(real0, realI) < 0.0 ? -vertex.boneWeights[i] : vertex.boneWeights[i];
+
+            real += realI * w;
+            dual += bones[boneId].dqDual * w;
+        }
+
+        const float invLen = 1.0 / length(real);
+        real *= invLen;
+        dual *= invLen;
+
+        const vec3 translation = 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+        skinnedPosition = quatRotate(real, position) + translation;
+        skinnedNormal = quatRotate(real, vertex.normal.xyz);
+    }
+    else if (skinningType == kSkinningTypeWeight1)
+    {
+        // Same as cpu path, single bone use full weight, bone -1 remap to bone 0.
+        const mat4 m = bones[vertex.boneIndices.x].transform;
+
+        skinnedPosition = (m * vec4(position, 1.0)).xyz;
+        skinnedNormal = mat3(m) * vertex.normal.xyz;
+    }
+    else
+    {
+        // BDEF2 and BDEF4 share blend matrix path, unused weights are zero.
+        const mat4 m =
+            bones[vertex.boneIndices.x].transform * vertex.boneWeights.x +
+            bones[vertex.boneIndices.y].transform * vertex.boneWeights.y +
+            bones[vertex.boneIndices.z].transform * vertex.boneWeights.z +
+            bones[vertex.boneIndices.w].transform * vertex.boneWeights.w;
+
+        skinnedPosition = (m * vec4(position, 1.0)).xyz;
+        skinnedNormal = mat3(m) * vertex.normal.xyz;
+    }
+    skinnedNormal = normalize(skinnedNormal);
+
+    const vec2 uv = vec2(vertex.position.w, vertex.normal.w) + morphUVs[vid].xy;
+
+    outPositions[vid * 3 + 0] = skinnedPosition.x;
+    outPositions[vid * 3 + 1] = skinnedPosition.y;
+    outPositions[vid * 3 + 2] = skinnedPosition.z;
+
+    outNormals[vid * 3 + 0] = skinnedNormal.x;
+    outNormals[vid * 3 + 1] = skinnedNormal.y;
+    outNormals[vid * 3 + 2] = skinnedNormal.z;
+
+    outUVs[vid * 2 + 0] = uv.x;
+    outUVs[vid * 2 + 1] = uv.y;
+}
@@ -0,0 +1,67 @@
+# Compile shader spirv into install/shader with the same glslc commands as compile_all.bat,
+# so prebuilt spirv always match glsl source when build engine.
+find_program(FLOWER_GLSLC glslc HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+
+# Any glsl change rebuild all spirv, include files have no depend info in scripts.
+file(GLOB_RECURSE flower_SHADER_SOURCES CONFIGURE_DEPENDS "${CMAKE_CURRENT_LIST_DIR}/*.glsl")
+set_property(GLOBAL PROPERTY FLOWER_SHADER_OUTPUTS "")
+
+function(flower_add_shader_script script)
+    get_filename_component(scriptDir "${script}" DIRECTORY)
+    file(STRINGS "${script}" lines)
+
+    foreach(line ${lines})
+        string(STRIP "${line}" line)
+        string(REPLACE "%~dp0" "${scriptDir}" line "${line}")
+
+        if (line MATCHES "^call[ \t]+(.+)$")
+            get_filename_component(subScript "${CMAKE_MATCH_1}" ABSOLUTE)
+            flower_add_shader_script("${subScript}")
+        elseif (line MATCHES "glslc\\.exe[ \t]+(.+)$")
+            separate_arguments(args UNIX_COMMAND "${CMAKE_MATCH_1}")
+
+            list(FIND args "-o" outputIndex)
+            math(EXPR outputIndex "${outputIndex} + 1")
+            list(GET args ${outputIndex} output)
+            get_filename_component(output "${output}" ABSOLUTE)
+            get_filename_component(outputName "${output}" NAME)
+
+            if (FLOWER_GLSLC)
+                add_custom_command(
+                    OUTPUT "${output}"
+                    COMMAND "${FLOWER_GLSLC}" ${args}
+                    DEPENDS ${flower_SHADER_SOURCES} "${script}"
+                    COMMENT "Compiling shader ${outputName}"
+                    VERBATIM)
+            endif()
+
+            set_property(GLOBAL APPEND PROPERTY FLOWER_SHADER_OUTPUTS "${output}")
+        endif()
+    endforeach()
+endfunction()
+
+flower_add_shader_script("${CMAKE_CURRENT_LIST_DIR}/compile_all.bat")
+
+get_property(flower_SHADER_OUTPUTS GLOBAL PROPERTY FLOWER_SHADER_OUTPUTS)
+
+# Without glslc only can use prebuilt spirv, keep configure and list spirv miss so new shader is easy to find.
+if (NOT FLOWER_GLSLC)
+    set(missingOutputs "")
+    foreach(output ${flower_SHADER_OUTPUTS})
+        if (NOT EXISTS "${output}")
+            get_filename_component(outputName "${output}" NAME)
+            list(APPEND missingOutputs "${outputName}")
+        endif()
+    endforeach()
+
+    if (missingOutputs)
+        list(JOIN missingOutputs ", " missingOutputs)
+        message(WARNING "glslc not found and prebuilt spirv miss: ${missingOutputs}. Install vulkan sdk or run compile_all.bat.")
+    else()
+        message(WARNING "glslc not found, install/shader spirv will not rebuild from glsl source.")
+    endif()
+    return()
+endif()
+
+add_custom_target(flower_shaders ALL DEPENDS ${flower_SHADER_OUTPUTS})
+set_target_properties(flower_shaders PROPERTIES FOLDER "shader")
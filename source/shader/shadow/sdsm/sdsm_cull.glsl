@@ -38,13 +38,16 @@ void visibileCulling(uint idx, uint cascadeId)
         }
     }
     
+    // Same lod as main view.
+    const uint lod = selectStaticMeshLOD(objectData, frameData);
+
     // Build draw command if visible.
     uint drawId = atomicAdd(drawCount[cascadeId], 1) + cascadeId * cullCountPercascade;
     indirectCommands[drawId].objectId = idx;
 
     // We fetech vertex by index, so vertex count is index count.
-    indirectCommands[drawId].vertexCount = objectData.indexCount;
-    indirectCommands[drawId].firstVertex = objectData.indexStartPosition;
+    indirectCommands[drawId].vertexCount = (lod == 0) ? objectData.indexCount : objectData.lodIndicesCount[lod];
+    indirectCommands[drawId].firstVertex = (lod == 0) ? objectData.indexStartPosition : objectData.lodIndicesStart[lod];
 
     // We fetch vertex in vertex shader, so instancing is unused when rendering.
     indirectCommands[drawId].instanceCount = 1;
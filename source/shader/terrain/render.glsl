@@ -46,6 +46,9 @@ void main()
 
 #ifdef PIXEL_SHADER
 
+#define TEXTURE_STREAMING_FEEDBACK_SET 4
+#include "../common/shared_texture_streaming.glsl"
+
 layout(location = 0) in VS2PS vsIn;
 
 layout(location = 0) out vec4 outHDRSceneColor; // Scene hdr color: r16g16b16a16. .rgb store emissive color.
@@ -59,6 +62,7 @@ void main()
 {
     float filterSize = 1.0f / float(textureSize(inHeightmap, 0).x);
 
+    textureStreamingFeedback(texture2DBindlessArray[nonuniformEXT(dynamicData.maskTexId)], linearClampEdgeMipFilterSampler, dynamicData.maskTexId, vsIn.uv);
     vec4 terrainMask = texture(sampler2D(texture2DBindlessArray[nonuniformEXT(dynamicData.maskTexId)], linearClampEdgeMipFilterSampler), vsIn.uv, frameData.basicTextureLODBias);
 
     float sx0 = textureLod(sampler2D(inHeightmap, linearClampEdgeSampler), vsIn.uv - vec2(filterSize, 0.0), 0.0).r;